@@ -29,8 +29,194 @@
 #include <cctype>
 #include <locale>
 #include <algorithm>
+#include <new>
+#include <cstring>
+#include <mutex>
+#include <atomic>
+#include <stdexcept>
+#include <unordered_map>
 #include "jkmpdefaultlib.h"
 
+namespace {
+    /** \brief runs the type inference pass (JKMathParser::jkmpNode::specializeTypes()) on \a child and replaces it by the (possibly new) result node */
+    inline void jkmpSpecializeChild(JKMathParser::jkmpNode*& child, JKMathParser::jkmpNode* parent) {
+        if (child) {
+            child=child->specializeTypes();
+            child->setParent(parent);
+        }
+    }
+
+    /** \brief returns the simple 1-parameter C implementation of the function \a fd (see jkmpFunctionDescriptor::simpleFuncPointer), or \c NULL if there is none */
+    inline JKMathParser::jkmpEvaluateFuncSimple1Param jkmpSimple1ParamFunction(const JKMathParser::jkmpFunctionDescriptor* fd) {
+        if (!fd || (fd->type!=JKMathParser::functionC && fd->type!=JKMathParser::functionCRefReturn)) return NULL;
+        JKMP::map<int, void*>::const_iterator it=fd->simpleFuncPointer.find(1);
+        if (it==fd->simpleFuncPointer.end() || !it->second) return NULL;
+        return (JKMathParser::jkmpEvaluateFuncSimple1Param)it->second;
+    }
+
+    /** \brief returns the vectorized 1-parameter implementation of the function \a fd (see JKMathParser::setVectorFunction()), or \c NULL if there is none */
+    inline JKMathParser::jkmpEvaluateFuncVector1Param jkmpVector1ParamFunction(const JKMathParser::jkmpFunctionDescriptor* fd) {
+        if (!fd) return NULL;
+        return (JKMathParser::jkmpEvaluateFuncVector1Param)fd->simpleFuncPointer.value(201, NULL);
+    }
+
+    /** \brief implementation of JKMathParser::analyseTree(), \a functionBodies contains the bodies of user-defined functions that were already analysed (stops recursions) */
+    void jkmpAnalyseTree(JKMathParser::jkmpNode* node, JKMathParser::jkmpTreeInfo& info, std::set<const JKMathParser::jkmpNode*>& functionBodies) {
+        if (!node) return;
+        if (dynamic_cast<JKMathParser::jkmpFunctionAssignNode*>(node)) {
+            // the body of a function definition is not evaluated here
+            info.definesFunctions=true;
+            return;
+        }
+        JKMP::vector<JKMathParser::jkmpNode*> children;
+        node->getChildren(children);
+        if (JKMathParser::jkmpVariableNode* vn=dynamic_cast<JKMathParser::jkmpVariableNode*>(node)) {
+            info.readVariables.insert(vn->getName());
+        } else if (JKMathParser::jkmpVariableVectorAccessNode* vn=dynamic_cast<JKMathParser::jkmpVariableVectorAccessNode*>(node)) {
+            info.readVariables.insert(vn->getName());
+        } else if (JKMathParser::jkmpVariableAssignNode* an=dynamic_cast<JKMathParser::jkmpVariableAssignNode*>(node)) {
+            info.assignedVariables.insert(an->getName());
+            // assigning single elements also depends on the rest of the vector
+            if (dynamic_cast<JKMathParser::jkmpVectorElementAssignNode*>(node)) info.readVariables.insert(an->getName());
+        } else if (JKMathParser::jkmpFunctionNode* fn=dynamic_cast<JKMathParser::jkmpFunctionNode*>(node)) {
+            const JKMathParser::jkmpFunctionDescriptor* fd=fn->resolveFunction();
+            if (!fd || fd->type==JKMathParser::functionFromNode || fd->type==JKMathParser::functionInvalid) {
+                info.callsUnknownFunctions=true;
+            } else if (fd->type==JKMathParser::functionC || fd->type==JKMathParser::functionCRefReturn) {
+                // only the simple implementations have no access to the parser (and its random number generator, errors, variables ...)
+                if (!fd->simpleFuncPointer.value(int(children.size()), NULL)) info.callsImpureFunctions=true;
+                if (fn->getParser() && fn->getParser()->functionHasSideEffects(fd->name)) info.hasSideEffects=true;
+            } else if (fd->type==JKMathParser::functionNode && fd->functionNode && functionBodies.insert(fd->functionNode).second) {
+                // the parameters are local variables of the function
+                JKMathParser::jkmpTreeInfo body;
+                jkmpAnalyseTree(fd->functionNode, body, functionBodies);
+                for (size_t i=0; i<fd->parameterNames.size(); i++) {
+                    body.readVariables.erase(fd->parameterNames[i]);
+                    body.assignedVariables.erase(fd->parameterNames[i]);
+                }
+                info.readVariables.insert(body.readVariables.begin(), body.readVariables.end());
+                info.assignedVariables.insert(body.assignedVariables.begin(), body.assignedVariables.end());
+                info.definesFunctions=info.definesFunctions||body.definesFunctions;
+                info.callsUnknownFunctions=info.callsUnknownFunctions||body.callsUnknownFunctions;
+                info.callsImpureFunctions=info.callsImpureFunctions||body.callsImpureFunctions;
+                info.hasSideEffects=info.hasSideEffects||body.hasSideEffects;
+            }
+        } else if (JKMathParser::jkmpVectorOperationNode* on=dynamic_cast<JKMathParser::jkmpVectorOperationNode*>(node)) {
+            // the loop variable is local to the expression of the loop
+            JKMathParser::jkmpTreeInfo loop;
+            jkmpAnalyseTree(on->getExpression(), loop, functionBodies);
+            loop.readVariables.erase(on->getVariableName());
+            loop.assignedVariables.erase(on->getVariableName());
+            info.readVariables.insert(loop.readVariables.begin(), loop.readVariables.end());
+            info.assignedVariables.insert(loop.assignedVariables.begin(), loop.assignedVariables.end());
+            info.definesFunctions=info.definesFunctions||loop.definesFunctions;
+            info.callsUnknownFunctions=info.callsUnknownFunctions||loop.callsUnknownFunctions;
+            info.callsImpureFunctions=info.callsImpureFunctions||loop.callsImpureFunctions;
+            info.hasSideEffects=info.hasSideEffects||loop.hasSideEffects;
+            for (size_t i=0; i<children.size(); i++) {
+                if (children[i]!=on->getExpression()) jkmpAnalyseTree(children[i], info, functionBodies);
+            }
+            return;
+        }
+        for (size_t i=0; i<children.size(); i++) {
+            jkmpAnalyseTree(children[i], info, functionBodies);
+        }
+    }
+
+    /** \brief number of iterations that are evaluated as one chunk by jkmpVectorOperationNode::evaluateByteCodeLoopParallel() */
+    const int64_t jkmpParallelLoopChunk=256;
+
+    /** \brief sums (or multiplies, if \a prod is \c true) the \a n values in \a data pairwise, i.e. the order of the operations only depends on \a n.
+     *         Non-finite values are skipped, as in the serial \c sum(...) and \c prod(...) */
+    double jkmpPairwiseReduce(const double* data, int64_t n, bool prod) {
+        if (n<=8) {
+            double r=prod?1.0:0.0;
+            for (int64_t i=0; i<n; i++) {
+                if (!JKMP_FloatIsOK(data[i])) continue;
+                if (prod) r*=data[i];
+                else r+=data[i];
+            }
+            return r;
+        }
+        const int64_t half=n/2;
+        if (prod) return jkmpPairwiseReduce(data, half, prod)*jkmpPairwiseReduce(data+half, n-half, prod);
+        return jkmpPairwiseReduce(data, half, prod)+jkmpPairwiseReduce(data+half, n-half, prod);
+    }
+
+    /** \brief runs jkmpNode::inferType() on all nodes of the subtree \a node (children first) */
+    void jkmpInferTypesRecursive(JKMathParser::jkmpNode* node) {
+        JKMP::vector<JKMathParser::jkmpNode*> children;
+        node->getChildren(children);
+        for (size_t i=0; i<children.size(); i++) {
+            jkmpInferTypesRecursive(children[i]);
+        }
+        node->inferType();
+    }
+
+    /** \brief returns \c true, if all nodes of the subtree \a node are inferred to evaluate to numbers. Booleans are allowed, if \a allowBool is
+     *         \c true, which is the case for the decisions of a jkmpCasesNode (and their subtrees). The decisions have to be inferred as
+     *         booleans, as the bytecode accepts any number as a decision, while the evaluation of the tree reports an error. */
+    bool jkmpIsNumberTree(JKMathParser::jkmpNode* node, bool allowBool=false) {
+        const int t=node->getInferredType();
+        if (t!=jkmpDouble && !(allowBool && t==jkmpBool)) return false;
+        JKMathParser::jkmpCasesNode* cases=dynamic_cast<JKMathParser::jkmpCasesNode*>(node);
+        if (cases) {
+            for (size_t i=0; i<cases->getCaseCount(); i++) {
+                JKMathParser::jkmpNode* decision=cases->getDecision(i);
+                if (!decision || decision->getInferredType()!=jkmpBool || !jkmpIsNumberTree(decision, true)) return false;
+                if (!cases->getValue(i) || !jkmpIsNumberTree(cases->getValue(i), allowBool)) return false;
+            }
+            return cases->getElse() && jkmpIsNumberTree(cases->getElse(), allowBool);
+        }
+        const bool childAllowBool=(t==jkmpBool);
+        JKMP::vector<JKMathParser::jkmpNode*> children;
+        node->getChildren(children);
+        for (size_t i=0; i<children.size(); i++) {
+            if (!jkmpIsNumberTree(children[i], childAllowBool)) return false;
+        }
+        return true;
+    }
+
+    /** \brief returns \c true, if the subtree \a node does not depend on the variables \a variant, has no side effects and is worth caching
+     *         in a loop, see jkmpVectorOperationNode::hoistLoopInvariants() */
+    bool jkmpIsLoopInvariant(JKMathParser::jkmpNode* node, const std::set<JKMP::string>& variant) {
+        JKMP::vector<JKMathParser::jkmpNode*> children;
+        node->getChildren(children);
+        // constants and variables are read as fast as a cached value
+        if (children.empty()) return false;
+        JKMathParser::jkmpTreeInfo info;
+        JKMathParser::analyseTree(node, info);
+        if (info.definesFunctions || info.callsUnknownFunctions || info.hasSideEffects || !info.assignedVariables.empty()) return false;
+        for (std::set<JKMP::string>::const_iterator it=info.readVariables.begin(); it!=info.readVariables.end(); ++it) {
+            if (variant.find(*it)!=variant.end()) return false;
+        }
+        return true;
+    }
+
+    /** \brief enters a new block of variables and functions in the parser and leaves it again when destroyed, also on early returns */
+    class jkmpBlockScope {
+        public:
+            explicit jkmpBlockScope(JKMathParser* parser): parser(parser) { parser->enterBlock(); }
+            ~jkmpBlockScope() { parser->leaveBlock(); }
+        private:
+            JKMathParser* parser;
+    };
+
+    /** \brief evaluates the function \a fd, which works on the parameter nodes, with the \a n already evaluated parameters \a params. They are
+     *         passed as jkmpConstantNode objects, so they are not evaluated again (used by JKMathParser::evaluateFlatProgram() ) */
+    void jkmpEvaluateFromValues(const JKMathParser::jkmpFunctionDescriptor* fd, jkmpResult& r, const jkmpResult* params, size_t n, JKMathParser* parser) {
+        JKMP::vector<JKMathParser::jkmpNode*> nodes;
+        nodes.reserve(n);
+        for (size_t i=0; i<n; i++) {
+            nodes.push_back(new JKMathParser::jkmpConstantNode(params[i], parser, NULL));
+        }
+        fd->evaluate(r, nodes, parser);
+        for (size_t i=0; i<nodes.size(); i++) {
+            JKMathParser::jkmpNode::deleteTree(nodes[i]);
+        }
+    }
+}
+
 
 
 
@@ -107,13 +293,95 @@ jkmpResult JKMathParser::getInvalidResult()
     return jkmpResult::invalidResult();
 }
 
+namespace {
+    /** \brief process-wide, append-only table of interned identifiers, see JKMathParser::internSymbol()
+     *
+     *  The names are stored in chunks of \c ChunkSize items, which are never moved or freed. Other threads only know a symbol after
+     *  internSymbol() has returned it, i.e. after its name was stored, so symbolName() reads the names without a lock. Only internSymbol()
+     *  locks the mutex.
+     */
+    struct jkmpSymbolTable {
+        enum { ChunkBits=10, ChunkSize=1<<ChunkBits, MaxChunks=1<<16 };
+        std::mutex mutex;
+        std::unordered_map<JKMP::stringType, JKMathParser::jkmpSymbol> ids;
+        /** \brief number of interned names (guarded by \c mutex) */
+        size_t count;
+        /** \brief the chunks of names, the name of symbol \c s is item <code>s%ChunkSize</code> of chunk <code>s/ChunkSize</code> */
+        std::atomic<JKMP::string*> chunks[MaxChunks];
+
+        jkmpSymbolTable(): count(0) {
+            for (size_t i=0; i<MaxChunks; i++) chunks[i].store(NULL, std::memory_order_relaxed);
+        }
+
+        static jkmpSymbolTable& instance() {
+            static jkmpSymbolTable table;
+            return table;
+        }
+    };
+}
+
+JKMathParser::jkmpSymbol JKMathParser::internSymbol(const JKMP::string &name)
+{
+    jkmpSymbolTable& t=jkmpSymbolTable::instance();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    auto it=t.ids.find(name);
+    if (it!=t.ids.end()) return it->second;
+    const size_t chunk=t.count>>jkmpSymbolTable::ChunkBits;
+    if (chunk>=jkmpSymbolTable::MaxChunks) throw std::length_error("JKMathParser: too many different identifiers");
+    JKMP::string* names=t.chunks[chunk].load(std::memory_order_relaxed);
+    if (!names) {
+        names=new JKMP::string[jkmpSymbolTable::ChunkSize];
+        t.chunks[chunk].store(names, std::memory_order_release);
+    }
+    names[t.count&(jkmpSymbolTable::ChunkSize-1)]=name;
+    const jkmpSymbol sym=static_cast<jkmpSymbol>(t.count);
+    t.count++;
+    t.ids.insert(std::make_pair(JKMP::stringType(name), sym));
+    return sym;
+}
+
+const JKMP::string &JKMathParser::symbolName(JKMathParser::jkmpSymbol symbol)
+{
+    const jkmpSymbolTable& t=jkmpSymbolTable::instance();
+    return t.chunks[symbol>>jkmpSymbolTable::ChunkBits].load(std::memory_order_acquire)[symbol&(jkmpSymbolTable::ChunkSize-1)];
+}
+
 void JKMathParser::jkmpError(JKMP::string st)
 {
     //std::cerr<<"##ERROR: "<<st;
-    lastError.push_back(st);
+#ifdef JKMATHPARSER_NO_ERROR_MESSAGES
+    lastError.push_back(jkmpErrorRecord(jkmpErrorMessage));
+#else
+    lastError.push_back(jkmpErrorRecord(st));
+#endif
     errors++;
 }
 
+JKMathParser::jkmpErrorRecord::jkmpErrorRecord(JKMathParser::jkmpErrorCode code, JKMathParser::jkmpSymbol symbol):
+    code(code), symbol(symbol)
+{
+}
+
+JKMathParser::jkmpErrorRecord::jkmpErrorRecord(const JKMP::string &message):
+    code(jkmpErrorMessage), symbol(0), message(message)
+{
+}
+
+JKMP::string JKMathParser::jkmpErrorRecord::format() const
+{
+#ifdef JKMATHPARSER_NO_ERROR_MESSAGES
+    return JKMP::string("error #%1").arg(static_cast<int>(code));
+#else
+    switch(code) {
+        case jkmpErrorVariableNotFound: return JKMP::_("the variable '%1' does not exist").arg(symbolName(symbol));
+        case jkmpErrorFunctionNotFound: return JKMP::_("the function '%1' does not exist").arg(symbolName(symbol));
+        case jkmpErrorLeaveToplevelBlock: return JKMP::_("cannot leave toplevel block!");
+        case jkmpErrorMessage: break;
+    }
+    return message;
+#endif
+}
+
 JKMP::string JKMathParser::tokentostring(JKMathParser::jkmpTokenType token) {
     switch(token) {
         case END: return "END";
@@ -171,6 +439,18 @@ JKMP::string JKMathParser::currenttokentostring() {
 
 // class constructor
 JKMathParser::JKMathParser() {
+    flatStackInUse=false;
+    flatFunctionProgramsGeneration=0;
+    parallelLoops=false;
+    threadCount=0;
+    parallelVectorThreshold=JKMATHPARSER_PARALLELVECTOR_THRESHOLD;
+    summationMode=jkmpPairwiseSummation;
+    memoizeFunctions=false;
+    memoizationCacheSize=10000;
+    m_regExpCache=std::make_shared<jkmpRegExpCache>(JKMATHPARSER_REGEXPCACHE_SIZE);
+    fastRegExp=true;
+    typeSpecialization=true;
+    m_fftPlanCache=std::make_shared<jkmpFFTPlanCache>(JKMATHPARSER_FFTPLANCACHE_SIZE);
     //qDebug()<<"constructing JKMathParser";
     environment.setParent(this);
     //qDebug()<<"constructing JKMathParser: adding functions";
@@ -207,6 +487,110 @@ bool JKMathParser::hasErrorOccured() const
     return errors>0;
 }
 
+void JKMathParser::setThreadCount(int threads)
+{
+    if (threads<0) threads=0;
+    if (threads!=threadCount) m_threadPool.reset();
+    threadCount=threads;
+}
+
+int JKMathParser::getThreadCount() const
+{
+    if (threadCount<=0) return JKMP::threadPool::idealThreadCount();
+    return threadCount;
+}
+
+JKMP::threadPool *JKMathParser::getThreadPool()
+{
+    if (!m_threadPool) m_threadPool=std::make_shared<JKMP::threadPool>(getThreadCount());
+    return m_threadPool.get();
+}
+
+JKMP::threadPool *jkmpParallelVectorPool(JKMathParser *p, size_t count)
+{
+    if (!p || p->getParallelVectorThreshold()==0 || count<p->getParallelVectorThreshold() || p->getThreadCount()<=1) return NULL;
+    return p->getThreadPool();
+}
+
+void JKMathParser::setFunctionHasSideEffects(const JKMP::string &name, bool sideEffects)
+{
+    if (sideEffects) sideEffectFunctions.insert(name);
+    else sideEffectFunctions.erase(name);
+}
+
+bool JKMathParser::functionHasSideEffects(const JKMP::string &name) const
+{
+    return sideEffectFunctions.find(name)!=sideEffectFunctions.end();
+}
+
+JKMathParser::jkmpFunctionMemoStatistics JKMathParser::getFunctionMemoStatistics(const JKMP::string &name) const
+{
+    const jkmpFunctionDescriptor* fd=environment.getFunctionDescriptor(internSymbol(name));
+    if (fd && fd->memo) {
+        JKMathParser::jkmpFunctionMemoStatistics s=fd->memo->statistics;
+        s.entries=fd->memo->cache.size();
+        return s;
+    }
+    return JKMathParser::jkmpFunctionMemoStatistics();
+}
+
+std::shared_ptr<const std::regex> JKMathParser::getRegExp(const JKMP::string &pattern, bool caseSensitive, bool minimal)
+{
+    return m_regExpCache->get(pattern, caseSensitive, minimal).regExp;
+}
+
+JKMathParser::jkmpCompiledRegExp JKMathParser::getCompiledRegExp(const JKMP::string &pattern, bool caseSensitive, bool minimal)
+{
+    jkmpCompiledRegExp rx=m_regExpCache->get(pattern, caseSensitive, minimal);
+    if (!fastRegExp) rx.automaton.reset();
+    return rx;
+}
+
+void JKMathParser::setRegExpCacheSize(size_t entries)
+{
+    m_regExpCache->setCapacity(entries);
+}
+
+size_t JKMathParser::getRegExpCacheSize() const
+{
+    return m_regExpCache->getCapacity();
+}
+
+JKMathParser::jkmpRegExpCacheStatistics JKMathParser::getRegExpCacheStatistics() const
+{
+    return m_regExpCache->getStatistics();
+}
+
+void JKMathParser::clearRegExpCache()
+{
+    m_regExpCache->clear();
+}
+
+std::shared_ptr<const JKMP::fftPlan> JKMathParser::getFFTPlan(size_t n)
+{
+    return m_fftPlanCache->get(n);
+}
+
+void JKMathParser::setFFTPlanCacheSize(size_t entries)
+{
+    m_fftPlanCache->setCapacity(entries);
+}
+
+size_t JKMathParser::getFFTPlanCacheSize() const
+{
+    return m_fftPlanCache->getCapacity();
+}
+
+JKMathParser::jkmpFFTPlanCacheStatistics JKMathParser::getFFTPlanCacheStatistics() const
+{
+    return m_fftPlanCache->getStatistics();
+}
+
+void JKMathParser::clearFFTPlanCache()
+{
+    m_fftPlanCache->clear();
+}
+
 
 
 
@@ -309,7 +693,7 @@ void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvalu
     f.function=function;
     f.name=name;
     f.type=JKMathParser::functionC;
-    environment.setFunction(name, f);
+    environment.setFunction(internSymbol(name), f);
 }
 
 void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvaluateFuncRefReturn function)
@@ -318,7 +702,7 @@ void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvalu
     f.functionRR=function;
     f.name=name;
     f.type=JKMathParser::functionCRefReturn;
-    environment.setFunction(name, f);
+    environment.setFunction(internSymbol(name), f);
 }
 
 void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvaluateFunc function, JKMathParser::jkmpEvaluateFuncSimple0Param f0, JKMathParser::jkmpEvaluateFuncSimple1Param f1, JKMathParser::jkmpEvaluateFuncSimple2Param f2, JKMathParser::jkmpEvaluateFuncSimple3Param f3)
@@ -331,7 +715,7 @@ void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvalu
     if (f1) f.simpleFuncPointer[1]=(void*)f1;
     if (f2) f.simpleFuncPointer[2]=(void*)f2;
     if (f3) f.simpleFuncPointer[3]=(void*)f3;
-    environment.setFunction(name, f);
+    environment.setFunction(internSymbol(name), f);
 }
 
 void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvaluateFunc function, JKMathParser::jkmpEvaluateFuncSimple0ParamMP f0, JKMathParser::jkmpEvaluateFuncSimple1ParamMP f1, JKMathParser::jkmpEvaluateFuncSimple2ParamMP f2, JKMathParser::jkmpEvaluateFuncSimple3ParamMP f3)
@@ -344,7 +728,7 @@ void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvalu
     if (f1) f.simpleFuncPointer[101]=(void*)f1;
     if (f2) f.simpleFuncPointer[102]=(void*)f2;
     if (f3) f.simpleFuncPointer[103]=(void*)f3;
-    environment.setFunction(name, f);
+    environment.setFunction(internSymbol(name), f);
 }
 
 void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvaluateFuncRefReturn function, JKMathParser::jkmpEvaluateFuncSimple0Param f0, JKMathParser::jkmpEvaluateFuncSimple1Param f1, JKMathParser::jkmpEvaluateFuncSimple2Param f2, JKMathParser::jkmpEvaluateFuncSimple3Param f3)
@@ -357,7 +741,7 @@ void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvalu
     if (f1) f.simpleFuncPointer[1]=(void*)f1;
     if (f2) f.simpleFuncPointer[2]=(void*)f2;
     if (f3) f.simpleFuncPointer[3]=(void*)f3;
-    environment.setFunction(name, f);
+    environment.setFunction(internSymbol(name), f);
 }
 
 void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvaluateFuncRefReturn function, JKMathParser::jkmpEvaluateFuncSimple0ParamMP f0, JKMathParser::jkmpEvaluateFuncSimple1ParamMP f1, JKMathParser::jkmpEvaluateFuncSimple2ParamMP f2, JKMathParser::jkmpEvaluateFuncSimple3ParamMP f3)
@@ -370,7 +754,19 @@ void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvalu
     if (f1) f.simpleFuncPointer[101]=(void*)f1;
     if (f2) f.simpleFuncPointer[102]=(void*)f2;
     if (f3) f.simpleFuncPointer[103]=(void*)f3;
-    environment.setFunction(name, f);
+    environment.setFunction(internSymbol(name), f);
+}
+
+void JKMathParser::setVectorFunction(const JKMP::string &name, JKMathParser::jkmpEvaluateFuncVector1Param function)
+{
+    const jkmpSymbol sym=internSymbol(name);
+    jkmpFunctionDescriptor f;
+    if (environment.getFunctionDef(sym, f) && (f.type==JKMathParser::functionC || f.type==JKMathParser::functionCRefReturn) && f.simpleFuncPointer.value(1, NULL)) {
+        f.simpleFuncPointer[201]=(void*)function;
+        environment.setFunction(sym, f);
+    } else {
+        JKMATHPARSER_ERROR(this, JKMP::_("setVectorFunction(): %1 is not a C-function with a simple 1-parameter implementation").arg(name));
+    }
 }
 
 void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvaluateFromNodesFuncRefReturn function)
@@ -379,7 +775,7 @@ void JKMathParser::addFunction(const JKMP::string &name, JKMathParser::jkmpEvalu
     f.functionFN=function;
     f.name=name;
     f.type=JKMathParser::functionFromNode;
-    environment.setFunction(name, f);
+    environment.setFunction(internSymbol(name), f);
 
 }
 
@@ -544,7 +940,7 @@ JKMathParser::jkmpTokenType JKMathParser::getToken(){
 			}
 			// the parser has found an unknown token. an exception will be thrown
 			//std::cout<<StringValue<<",   "<<ch<<std::endl;
-            jkmpError(JKMP::_("get_next_token: unknown token currentCharacter='%1', currentString='%2'").arg(JKMP::charToStr(ch)).arg(StringValue));
+            JKMATHPARSER_ERROR(this, JKMP::_("get_next_token: unknown token currentCharacter='%1', currentString='%2'").arg(JKMP::charToStr(ch)).arg(StringValue));
             break;
 	}
     return END;
@@ -574,6 +970,7 @@ void JKMathParser::eatSinglelineComment()
 
 
 JKMathParser::jkmpNode* JKMathParser::parse(JKMP::stringType prog){
+    jkmpNodeArenaScope arenaScope;
     progStr=prog;
     program=new std::istringstream(progStr);
     JKMathParser::jkmpNode* res=NULL;
@@ -594,11 +991,13 @@ JKMathParser::jkmpNode* JKMathParser::parse(JKMP::stringType prog){
         //qDebug()<<"returning single item";
         res=resList->popLast(false);
         delete resList;
-        return res;
     } else {
         //qDebug()<<"returning list";
-        return resList;
+        res=resList;
     }
+    // specialize while the arena of this parse is still active
+    if (typeSpecialization) res=res->specializeTypes();
+    return res;
 }
 
 jkmpResult JKMathParser::evaluate(JKMP::stringType prog) {
@@ -802,7 +1201,7 @@ JKMathParser::jkmpNode *JKMathParser::primaryOp(bool get)
                         getToken();
                     } else {
                         if (res) delete res;
-                        jkmpError(JKMP::_("parsing primary_op: ']' expected, but '%1' found").arg(currenttokentostring()));
+                        JKMATHPARSER_ERROR(this, JKMP::_("parsing primary_op: ']' expected, but '%1' found").arg(currenttokentostring()));
                         return new jkmpInvalidNode(this, NULL);
                     }
 
@@ -815,7 +1214,7 @@ JKMathParser::jkmpNode *JKMathParser::primaryOp(bool get)
                         getToken();
                     } else {
                         if (res) delete res;
-                        jkmpError(JKMP::_("parsing primary_op: 'NAME' expected in EXPR.NAME (struct access) construct, but '%1' found").arg(currenttokentostring()));
+                        JKMATHPARSER_ERROR(this, JKMP::_("parsing primary_op: 'NAME' expected in EXPR.NAME (struct access) construct, but '%1' found").arg(currenttokentostring()));
                         return new jkmpInvalidNode(this, NULL);
                     }
 
@@ -859,7 +1258,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                 } else if (CurrentToken == LBRACKET) { // vector element access found
                     JKMathParser::jkmpNode* parameter=logicalExpression(true);
                     if ( CurrentToken != RBRACKET ) {
-                        jkmpError(JKMP::_("parsing primary: ']' expected after '[...', but '%1' found").arg(currenttokentostring()));
+                        JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: ']' expected after '[...', but '%1' found").arg(currenttokentostring()));
                         return NULL;
                     }
                     getToken();
@@ -878,14 +1277,14 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                         JKMathParser::jkmpNode* parameter=logicalExpression(params.size()>0);
                         params.push_back(parameter);
                         if ((CurrentToken!=RPARENTHESE)&&(CurrentToken!=COMMA)&&(CurrentToken!=END)) {
-                            jkmpError(JKMP::_("parsing primary: ')' or ',' expected after '(...', but '%1' found").arg(currenttokentostring()));
+                            JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: ')' or ',' expected after '(...', but '%1' found").arg(currenttokentostring()));
                             return NULL;
                         }
 
                     }
 
                     if ( CurrentToken != RPARENTHESE ) {
-                        jkmpError(JKMP::_("parsing primary: ')' expected after '(...', but '%1' found").arg(currenttokentostring()));
+                        JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: ')' expected after '(...', but '%1' found").arg(currenttokentostring()));
                         return NULL;
                     }
                     getToken();
@@ -896,7 +1295,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                     if (lvarname=="if") {
 #endif
                         if (params.size()!=3) {
-                            jkmpError(JKMP::_("parsing primary: 'if(decision, trueValue, falseValue)' expects 3 arguments, but '%1' found").arg(params.size()));
+                            JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: 'if(decision, trueValue, falseValue)' expects 3 arguments, but '%1' found").arg(params.size()));
                             return NULL;
                         }
                         jkmpCasesNode* cn=new jkmpCasesNode(this, NULL);
@@ -909,7 +1308,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                     } else if (lvarname=="cases") {
 #endif
                         if (params.size()<3 || (params.size()%2==0)) {
-                            jkmpError(JKMP::_("parsing primary: 'cases(decision1, trueValue1, decision2, trueValue2, ..., elseValue)' expects 3, 5, 7 ... arguments, but '%1' found").arg(params.size()));
+                            JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: 'cases(decision1, trueValue1, decision2, trueValue2, ..., elseValue)' expects 3, 5, 7 ... arguments, but '%1' found").arg(params.size()));
                             return NULL;
                         }
                         jkmpCasesNode* cn=new jkmpCasesNode(this, NULL);
@@ -923,7 +1322,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                             if (lvarname!="for"&&lvarname!="savefor"&&lvarname!="defaultfor") {
                                 res=new jkmpFunctionNode(varname, params, this, NULL);
                             } else {
-                                jkmpError(JKMP::_("parsing primary: '%2(NAME, start[, delta], end, expression)' expects 3-5 arguments, but '%1' found").arg(params.size()).arg(lvarname));
+                                JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: '%2(NAME, start[, delta], end, expression)' expects 3-5 arguments, but '%1' found").arg(params.size()).arg(lvarname));
                                 return NULL;
                             }
                         } else if (params.size()==3){
@@ -933,12 +1332,12 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                                 if (vn) {
                                     iName=vn->getName();
                                 } else {
-                                    jkmpError(JKMP::_("parsing primary: '%1(NAME, ..., expression)' expects a variable name as first argument").arg(lvarname));
+                                    JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: '%1(NAME, ..., expression)' expects a variable name as first argument").arg(lvarname));
                                     return NULL;
                                 }
                                 res=new jkmpVectorOperationNode(lvarname, iName, params[1], params[2], this, NULL);
                             } else {
-                                jkmpError(JKMP::_("parsing primary: '%1(NAME, ..., expression, defaultValue)' expects at least 4 arguments").arg(lvarname));
+                                JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: '%1(NAME, ..., expression, defaultValue)' expects at least 4 arguments").arg(lvarname));
                                 return NULL;
                             }
                         } else if (params.size()==4){
@@ -951,7 +1350,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                             if (vn) {
                                 iName=vn->getName();
                             } else {
-                                jkmpError(JKMP::_("parsing primary: '%1(NAME, ..., expression)' expects a variable name as first argument").arg(lvarname));
+                                JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: '%1(NAME, ..., expression)' expects a variable name as first argument").arg(lvarname));
                                 return NULL;
                             }
                             if (lvarname=="defaultfor"){
@@ -971,7 +1370,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                             if (vn) {
                                 iName=vn->getName();
                             } else {
-                                jkmpError(JKMP::_("parsing primary: '%1(NAME, ..., expression)' expects a variable name as first argument").arg(lvarname));
+                                JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: '%1(NAME, ..., expression)' expects a variable name as first argument").arg(lvarname));
                                 return NULL;
                             }
                             if (lvarname=="defaultfor"){
@@ -985,17 +1384,17 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                             if (vn) {
                                 iName=vn->getName();
                             } else {
-                                jkmpError(JKMP::_("parsing primary: '%1(NAME, ..., expression)' expects a variable name as first argument").arg(lvarname));
+                                JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: '%1(NAME, ..., expression)' expects a variable name as first argument").arg(lvarname));
                                 return NULL;
                             }
                             if (lvarname=="defaultfor"){
                                 res=new jkmpVectorOperationNode(lvarname, iName, params[1], params[3], params[2], params[4], this, NULL, params[5]);
                             } else {
-                                jkmpError(JKMP::_("parsing primary: '%1(NAME, ..., expression)' expects at most 5 arguments").arg(lvarname));
+                                JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: '%1(NAME, ..., expression)' expects at most 5 arguments").arg(lvarname));
                                 return NULL;
                             }
                         } else {
-                            jkmpError(JKMP::_("parsing primary: '%2(NAME, start[, delta], end, expression)' expects 4 or 5 arguments and 'sum|prod|for(NAME, value_list, expression)' expects 3 arguments, but '%1' found").arg(params.size()).arg(lvarname));
+                            JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: '%2(NAME, start[, delta], end, expression)' expects 4 or 5 arguments and 'sum|prod|for(NAME, value_list, expression)' expects 3 arguments, but '%1' found").arg(params.size()).arg(lvarname));
                             return NULL;
                         }
                     } else if (CurrentToken==ASSIGN) { // function assignment
@@ -1014,7 +1413,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                         if (allParamsAreNames) {
                             res=new jkmpFunctionAssignNode(varname, pnames, logicalExpression(true)/* primary(true)*/, this, NULL);
                         } else {
-                            jkmpError(JKMP::_("parsing primary: malformed function assignmentfound, expected this form: FNAME(P1, P2, ...)=expression").arg(currenttokentostring()));
+                            JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: malformed function assignmentfound, expected this form: FNAME(P1, P2, ...)=expression").arg(currenttokentostring()));
                             return NULL;
                         }
                     } else {
@@ -1053,7 +1452,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
         case LPARENTHESE: { // found primary: ( expression )
             JKMathParser::jkmpNode* expr=logicalExpression(true);
             if (CurrentToken != RPARENTHESE) {
-                jkmpError(JKMP::_("parsing primary: ')' expected, but '%1' found").arg(currenttokentostring()));
+                JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: ')' expected, but '%1' found").arg(currenttokentostring()));
                 return NULL;
             }
 			getToken(); // swallow ")"
@@ -1088,7 +1487,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                         vl->setIsMatrix(true);
                     }
                     if ((CurrentToken!=RBRACKET)&&(CurrentToken!=COMMA)&&(CurrentToken!=PRINT)) {
-                        jkmpError(JKMP::_("parsing primary (vector construction node '[a,b;c,...]'): ']', ';' or ',' expected, but '%1' found after %2 elements").arg(currenttokentostring()).arg(vl->getCount()));
+                        JKMATHPARSER_ERROR(this, JKMP::_("parsing primary (vector construction node '[a,b;c,...]'): ']', ';' or ',' expected, but '%1' found after %2 elements").arg(currenttokentostring()).arg(vl->getCount()));
                         return new jkmpInvalidNode(this, NULL);
                     }
                     //qDebug()<<"adding to [...]: "<<vl->getCount()<<". element CurrentToke="<<currenttokentostring();
@@ -1096,7 +1495,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
 
 
                 if ( CurrentToken != RBRACKET ) {
-                    jkmpError(JKMP::_("parsing primary (vector construction node '[a,b,...]'): ']' expected, but '%1' found").arg(currenttokentostring()));
+                    JKMATHPARSER_ERROR(this, JKMP::_("parsing primary (vector construction node '[a,b,...]'): ']' expected, but '%1' found").arg(currenttokentostring()));
                     return new jkmpInvalidNode(this, NULL);
                 }
                 getToken();
@@ -1112,7 +1511,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
                     JKMathParser::jkmpNode* parameter=logicalExpression(vl->getCount()>0);
                     vl->add(parameter);
                     if ((CurrentToken!=RBRACE)&&(CurrentToken!=COMMA)) {
-                        jkmpError(JKMP::_("parsing primary (list construction node '{a,b,...}'): '}' or ',' expected, but '%1' found after %2 elements").arg(currenttokentostring()).arg(vl->getCount()));
+                        JKMATHPARSER_ERROR(this, JKMP::_("parsing primary (list construction node '{a,b,...}'): '}' or ',' expected, but '%1' found after %2 elements").arg(currenttokentostring()).arg(vl->getCount()));
                         return new jkmpInvalidNode(this, NULL);
                     }
                     //qDebug()<<"adding to [...]: "<<vl->getCount()<<". element CurrentToke="<<currenttokentostring();
@@ -1120,7 +1519,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
 
 
                 if ( CurrentToken != RBRACE ) {
-                    jkmpError(JKMP::_("parsing primary (list construction node '{a,b,...}'): '}' expected, but '%1' found").arg(currenttokentostring()));
+                    JKMATHPARSER_ERROR(this, JKMP::_("parsing primary (list construction node '{a,b,...}'): '}' expected, but '%1' found").arg(currenttokentostring()));
                     return new jkmpInvalidNode(this, NULL);
                 }
                 getToken();
@@ -1128,7 +1527,7 @@ JKMathParser::jkmpNode* JKMathParser::primary(bool get){
 
             } break;
         default:
-            jkmpError(JKMP::_("parsing primary: primary expected, but '%1' found").arg(currenttokentostring()));
+            JKMATHPARSER_ERROR(this, JKMP::_("parsing primary: primary expected, but '%1' found").arg(currenttokentostring()));
             if (res) delete res;
             return new jkmpInvalidNode(this, NULL);
 
@@ -1333,7 +1732,7 @@ double JKMathParser::readHex() {
                     break;
                 default:
                     if (std::isdigit(c, std::locale("C")) || std::isalpha(c, std::locale("C"))) {
-                        jkmpError(JKMP::_("read_hex: found unexpected character '%1'").arg(JKMP::string(c)));
+                        JKMATHPARSER_ERROR(this, JKMP::_("read_hex: found unexpected character '%1'").arg(JKMP::string(c)));
                         return 0;
                     }
                     putbackStream(program, c);
@@ -1378,7 +1777,7 @@ double JKMathParser::readOct() {
                     break;
                 case '8':
                 case '9':
-                    jkmpError(JKMP::_("read_oct: found unexpected digit '%1'").arg(JKMP::string(c)));
+                    JKMATHPARSER_ERROR(this, JKMP::_("read_oct: found unexpected digit '%1'").arg(JKMP::string(c)));
                     return 0;
                     break;
 
@@ -1427,7 +1826,7 @@ double JKMathParser::readBin() {
               case '7':
               case '8':
               case '9':
-                  jkmpError(JKMP::_("read_binary: found unexpected digit '%1'").arg(JKMP::string(c)));
+                  JKMATHPARSER_ERROR(this, JKMP::_("read_binary: found unexpected digit '%1'").arg(JKMP::string(c)));
                   break;
             default:
               putbackStream(program, c);
@@ -1519,7 +1918,7 @@ JKMathParser::jkmpUnaryNode::jkmpUnaryNode(JKMP::charType op, JKMathParser::jkmp
 
 JKMathParser::jkmpUnaryNode::~jkmpUnaryNode()
 {
-    if (child) delete child;
+    if (child) deleteTree(child);
 }
 
 
@@ -1527,7 +1926,11 @@ void JKMathParser::jkmpUnaryNode::evaluate(jkmpResult &res)
 {
     //jkmpResult c;
     child->evaluate(res);
+    evaluateOperation(res);
+}
 
+void JKMathParser::jkmpUnaryNode::evaluateOperation(jkmpResult &res)
+{
     switch(operation) {
       case '!':
             if (res.type==jkmpBool) {
@@ -1536,7 +1939,7 @@ void JKMathParser::jkmpUnaryNode::evaluate(jkmpResult &res)
             } else if (res.type==jkmpBoolVector) {
                 for (size_t i=0; i<res.boolVec.size(); i++) res.boolVec[i]=!res.boolVec[i];
                 return ;
-             } else parser->jkmpError(JKMP::_("'!' only defined for bool (argument type was %1)").arg(res.typeName()));
+             } else JKMATHPARSER_ERROR(parser, JKMP::_("'!' only defined for bool (argument type was %1)").arg(res.typeName()));
            break;
         case '-':
             if (res.type==jkmpDouble) {
@@ -1546,7 +1949,7 @@ void JKMathParser::jkmpUnaryNode::evaluate(jkmpResult &res)
                 //res.setDoubleVec(res.numVec.size());
                 for (size_t i=0; i<res.numVec.size(); i++) res.numVec[i]=-res.numVec[i];
                 return ;
-             } else parser->jkmpError(JKMP::_("'-' only defined for numbers (argument type was %1)").arg(res.typeName()));
+             } else JKMATHPARSER_ERROR(parser, JKMP::_("'-' only defined for numbers (argument type was %1)").arg(res.typeName()));
              break;
         case '~':
              if (res.isInteger()) {
@@ -1555,9 +1958,9 @@ void JKMathParser::jkmpUnaryNode::evaluate(jkmpResult &res)
              } else if (res.type==jkmpDoubleVector) {
                  for (size_t i=0; i<res.numVec.size(); i++) res.numVec[i]=double(~int32_t(res.numVec[i]));
                  return ;
-             } else parser->jkmpError(JKMP::_("'~' only defined for integer numbers (argument type was %1)").arg(res.typeName()));
+             } else JKMATHPARSER_ERROR(parser, JKMP::_("'~' only defined for integer numbers (argument type was %1)").arg(res.typeName()));
              break;
-       default: parser->jkmpError(JKMP::_("unknown unary operation '%1'").arg(operation));
+       default: JKMATHPARSER_ERROR(parser, JKMP::_("unknown unary operation '%1'").arg(operation));
     }
     res.setInvalid();
 }
@@ -1568,6 +1971,56 @@ JKMathParser::jkmpNode *JKMathParser::jkmpUnaryNode::copy(JKMathParser::jkmpNode
     return n;
 }
 
+int JKMathParser::jkmpUnaryNode::inferType()
+{
+    inferredType=0;
+    if (!child) return inferredType;
+    const int t=child->getInferredType();
+    // '~' fails for numbers that are not integers, so its type is only known at runtime
+    if (operation=='!' && (t==jkmpBool || t==jkmpBoolVector)) inferredType=t;
+    else if (operation=='-' && (t==jkmpDouble || t==jkmpDoubleVector)) inferredType=t;
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpUnaryNode::specializeTypes()
+{
+    jkmpSpecializeChild(child, this);
+    inferType();
+    return jkmpFusedVectorNode::fuse(this);
+}
+
+void JKMathParser::jkmpUnaryNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (child) slots.push_back(&child);
+}
+
+bool JKMathParser::jkmpUnaryNode::isElementwiseOperation()
+{
+    return child && operation=='-';
+}
+
+void JKMathParser::jkmpUnaryNode::createFusedVectorProgram(JKMathParser::FusedVectorProgram &program)
+{
+    if (!isElementwiseOperation()) {
+        jkmpNode::createFusedVectorProgram(program);
+        return;
+    }
+    program.depth++;
+    child->createFusedVectorProgram(program);
+    program.depth--;
+    program.add(JKMathParser::FusedVectorInstruction(JKMathParser::fusedNegate, this, operation), 0);
+}
+
+void JKMathParser::jkmpUnaryNode::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    if (!child) {
+        jkmpNode::createFlatProgram(program);
+        return;
+    }
+    child->createFlatProgram(program);
+    program.add(JKMathParser::FlatInstruction(JKMathParser::flatUnary, this, operation), 0);
+}
+
 bool JKMathParser::jkmpUnaryNode::createByteCode(JKMathParser::ByteCodeProgram &program, JKMathParser::ByteCodeEnvironment *environment)
 {
     bool ok=true;
@@ -1588,7 +2041,7 @@ bool JKMathParser::jkmpUnaryNode::createByteCode(JKMathParser::ByteCodeProgram &
 
 
         default:
-            parser->jkmpError(JKMP::_("unknown unary operation"));
+            JKMATHPARSER_ERROR(parser, JKMP::_("unknown unary operation"));
             ok=false;
             break;
 
@@ -1626,8 +2079,8 @@ JKMathParser::jkmpBinaryArithmeticNode::jkmpBinaryArithmeticNode(JKMP::charType
 
 JKMathParser::jkmpBinaryArithmeticNode::~jkmpBinaryArithmeticNode()
 {
-    if (left) delete left;
-    if (right) delete right;
+    if (left) deleteTree(left);
+    if (right) deleteTree(right);
 }
 
 
@@ -1638,7 +2091,11 @@ void JKMathParser::jkmpBinaryArithmeticNode::evaluate(jkmpResult& res){
   jkmpResult r;
   if (right) right->evaluate(r);
   //jkmpResult res;
+  evaluateOperation(res, l, r);
+}
 
+void JKMathParser::jkmpBinaryArithmeticNode::evaluateOperation(jkmpResult &res, const jkmpResult &l, const jkmpResult &r)
+{
   switch(operation) {
       case '+':
             jkmpResult::add(res, l, r, getParser());
@@ -1666,7 +2123,7 @@ void JKMathParser::jkmpBinaryArithmeticNode::evaluate(jkmpResult& res){
           break;
 
       default:
-          parser->jkmpError(JKMP::_("unknown arithmetic operation"));
+          JKMATHPARSER_ERROR(parser, JKMP::_("unknown arithmetic operation"));
           res.setInvalid();
           break;
 
@@ -1679,6 +2136,81 @@ JKMathParser::jkmpNode *JKMathParser::jkmpBinaryArithmeticNode::copy(JKMathParse
     return n;
 }
 
+int JKMathParser::jkmpBinaryArithmeticNode::inferType()
+{
+    inferredType=0;
+    if (left && right) {
+        const int lt=left->getInferredType();
+        const int rt=right->getInferredType();
+        if (lt==jkmpDouble && rt==jkmpDouble) inferredType=jkmpDouble;
+        else if ((lt==jkmpDoubleVector && (rt==jkmpDouble || rt==jkmpDoubleVector)) || (lt==jkmpDouble && rt==jkmpDoubleVector)) inferredType=jkmpDoubleVector;
+    }
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpBinaryArithmeticNode::specializeTypes()
+{
+    jkmpSpecializeChild(left, this);
+    jkmpSpecializeChild(right, this);
+    inferType();
+    if (!left || !right) return this;
+    if (operation!='+' && operation!='-' && operation!='*' && operation!='/' && operation!='^') return jkmpFusedVectorNode::fuse(this);
+
+    const int lt=left->getInferredType();
+    const int rt=right->getInferredType();
+    JKMathParser::jkmpNode* n=NULL;
+    if (lt==jkmpDouble && rt==jkmpDouble) {
+        n=new JKMathParser::jkmpBinaryArithmeticDoubleNode(operation, left, right, getParser(), getParent());
+    } else if ((lt==jkmpDoubleVector && rt==jkmpDouble) || (lt==jkmpDouble && rt==jkmpDoubleVector)) {
+        n=new JKMathParser::jkmpBinaryArithmeticVectorScalarNode(operation, left, right, getParser(), getParent());
+    } else if (lt==jkmpDoubleVector && rt==jkmpDoubleVector) {
+        n=new JKMathParser::jkmpBinaryArithmeticVectorVectorNode(operation, left, right, getParser(), getParent());
+    }
+    if (!n) return jkmpFusedVectorNode::fuse(this);
+    n->inferType();
+    // the children now belong to n
+    left=NULL;
+    right=NULL;
+    delete this;
+    return jkmpFusedVectorNode::fuse(n);
+}
+
+void JKMathParser::jkmpBinaryArithmeticNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (left) slots.push_back(&left);
+    if (right) slots.push_back(&right);
+}
+
+bool JKMathParser::jkmpBinaryArithmeticNode::isElementwiseOperation()
+{
+    return left && right && (operation=='+' || operation=='-' || operation=='*' || operation=='/' || operation=='^');
+}
+
+void JKMathParser::jkmpBinaryArithmeticNode::createFusedVectorProgram(JKMathParser::FusedVectorProgram &program)
+{
+    if (!isElementwiseOperation()) {
+        jkmpNode::createFusedVectorProgram(program);
+        return;
+    }
+    program.depth++;
+    left->createFusedVectorProgram(program);
+    right->createFusedVectorProgram(program);
+    program.depth--;
+    program.add(JKMathParser::FusedVectorInstruction(JKMathParser::fusedBinaryArithmetic, this, operation), -1);
+}
+
+void JKMathParser::jkmpBinaryArithmeticNode::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    if (!left || !right) {
+        jkmpNode::createFlatProgram(program);
+        return;
+    }
+    program.add(JKMathParser::FlatInstruction(JKMathParser::flatReserve), 1);
+    left->createFlatProgram(program);
+    right->createFlatProgram(program);
+    program.add(JKMathParser::FlatInstruction(JKMathParser::flatBinaryArithmetic, this, operation), -2);
+}
+
 bool JKMathParser::jkmpBinaryArithmeticNode::createByteCode(JKMathParser::ByteCodeProgram &program, ByteCodeEnvironment *environment)
 {
     bool ok=true;
@@ -1714,7 +2246,7 @@ bool JKMathParser::jkmpBinaryArithmeticNode::createByteCode(JKMathParser::ByteCo
             break;
 
         default:
-            parser->jkmpError(JKMP::_("unknown arithmetic operation"));
+            JKMATHPARSER_ERROR(parser, JKMP::_("unknown arithmetic operation"));
             ok=false;
             break;
 
@@ -1732,85 +2264,684 @@ JKMP::string JKMathParser::jkmpBinaryArithmeticNode::printTree(int level) const
     return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("BinaryArithmeticNode %2\n%1\n%3").arg(left->printTree(level+1)).arg(JKMP::string(operation)).arg(right->printTree(level+1));
 }
 
+namespace {
+    /** \brief element-wise operations for the type-specialized arithmetic nodes */
+    struct jkmpAddOp { static inline double apply(double a, double b) { return a+b; } };
+    struct jkmpSubOp { static inline double apply(double a, double b) { return a-b; } };
+    struct jkmpMulOp { static inline double apply(double a, double b) { return a*b; } };
+    struct jkmpDivOp { static inline double apply(double a, double b) { return a/b; } };
+    struct jkmpPowOp { static inline double apply(double a, double b) { return pow(a,b); } };
 
+    template <class OP>
+    inline void jkmpApplyVectorScalar(double* out, const double* a, double b, size_t n) {
+        for (size_t i=0; i<n; i++) out[i]=OP::apply(a[i], b);
+    }
 
+    template <class OP>
+    inline void jkmpApplyScalarVector(double* out, double a, const double* b, size_t n) {
+        for (size_t i=0; i<n; i++) out[i]=OP::apply(a, b[i]);
+    }
 
+    template <class OP>
+    inline void jkmpApplyVectorVector(double* out, const double* a, const double* b, size_t n) {
+        for (size_t i=0; i<n; i++) out[i]=OP::apply(a[i], b[i]);
+    }
 
+    /** \brief turns \a res into a vector of numbers with \a n (uninitialized) entries and returns a pointer to its data */
+    inline double* jkmpPrepareDoubleVectorResult(jkmpResult& res, size_t n) {
+        if (res.type!=jkmpDoubleVector) {
+            res.setInvalid();
+            res.type=jkmpDoubleVector;
+        }
+        res.isValid=true;
+        res.matrix_columns=1;
+        res.numVec.resize(n);
+        return res.numVec.data();
+    }
+}
 
-
-JKMathParser::jkmpCompareNode::jkmpCompareNode(JKMP::charType op, JKMathParser::jkmpNode* l, JKMathParser::jkmpNode* r, JKMathParser* p, JKMathParser::jkmpNode* par):
-    jkmpNode(p, par)
+JKMathParser::jkmpBinaryArithmeticDoubleNode::jkmpBinaryArithmeticDoubleNode(JKMP::charType op, JKMathParser::jkmpNode *l, JKMathParser::jkmpNode *r, JKMathParser *p, JKMathParser::jkmpNode *par):
+    jkmpBinaryArithmeticNode(op, l, r, p, par)
 {
-  left=l;
-  right=r;
-  if (left) left->setParent(this);
-  if (right) right->setParent(this);
-  setParser(p);
-  setParent(par);
-  operation=op;
 }
 
-JKMathParser::jkmpCompareNode::~jkmpCompareNode()
+void JKMathParser::jkmpBinaryArithmeticDoubleNode::evaluateOperation(jkmpResult &res, const jkmpResult &l, const jkmpResult &r)
 {
-    if (left) delete left;
-    if (right) delete right;
+    if (l.type!=jkmpDouble || r.type!=jkmpDouble) {
+        jkmpBinaryArithmeticNode::evaluateOperation(res, l, r);
+        return;
+    }
+    double v=0;
+    switch(operation) {
+        case '+': v=l.num+r.num; break;
+        case '-': v=l.num-r.num; break;
+        case '*': v=l.num*r.num; break;
+        case '/': v=l.num/r.num; break;
+        case '^': v=pow(l.num,r.num); break;
+        default:
+            jkmpBinaryArithmeticNode::evaluateOperation(res, l, r);
+            return;
+    }
+    if (res.type==jkmpDouble) {
+        res.num=v;
+        res.isValid=true;
+    } else {
+        res.setDouble(v);
+    }
 }
 
-
-void JKMathParser::jkmpCompareNode::evaluate(jkmpResult &res)
+JKMathParser::jkmpNode *JKMathParser::jkmpBinaryArithmeticDoubleNode::copy(JKMathParser::jkmpNode *par)
 {
-    jkmpResult l;
-    if (left) left->evaluate(l);
-    jkmpResult r;
-    if (right) right->evaluate(r);
-
-  /*if (l.type!=r.type) {
-      parser->jkmpError(JKMP::_("you can't compare different datatypes"));
-      res.setInvalid();
-      return;
-  }*/
-
-  res.type=jkmpBool;
-  switch(operation) {
-        case jkmpCOMPequal:
-            jkmpResult::compareequal(res, l, r, getParser());
-            break;
-        case jkmpCOMPnequal:
-              jkmpResult::comparenotequal(res, l, r, getParser());
-              break;
-        case jkmpCOMPgreater:
-              jkmpResult::comparegreater(res, l, r, getParser());
-              break;
-
-        case jkmpCOMPlesser:
-              jkmpResult::comparesmaller(res, l, r, getParser());
-              break;
-
-        case jkmpCOMPgreaterequal:
-              jkmpResult::comparegreaterequal(res, l, r, getParser());
-              break;
+    JKMathParser::jkmpBinaryArithmeticDoubleNode *n= new JKMathParser::jkmpBinaryArithmeticDoubleNode(operation, left->copy(), right->copy(), getParser(), par);
+    n->inferredType=inferredType;
+    return n;
+}
 
-        case jkmpCOMPlesserequal:
-              jkmpResult::comparesmallerequal(res, l, r, getParser());
-              break;
+JKMP::string JKMathParser::jkmpBinaryArithmeticDoubleNode::printTree(int level) const
+{
+    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("BinaryArithmeticNode[double] %2\n%1\n%3").arg(left->printTree(level+1)).arg(JKMP::string(operation)).arg(right->printTree(level+1));
+}
 
+JKMathParser::jkmpBinaryArithmeticVectorScalarNode::jkmpBinaryArithmeticVectorScalarNode(JKMP::charType op, JKMathParser::jkmpNode *l, JKMathParser::jkmpNode *r, JKMathParser *p, JKMathParser::jkmpNode *par):
+    jkmpBinaryArithmeticNode(op, l, r, p, par)
+{
+}
 
-        default:
-              parser->jkmpError(JKMP::_("compare operation between %1 and %2 not possible").arg(l.toTypeString()).arg(r.toTypeString()));
-              res.setInvalid();
-              break;
+void JKMathParser::jkmpBinaryArithmeticVectorScalarNode::evaluateOperation(jkmpResult &res, const jkmpResult &l, const jkmpResult &r)
+{
+    if (l.type==jkmpDoubleVector && r.type==jkmpDouble) {
+        const size_t n=l.numVec.size();
+        const double b=r.num;
+        if (&res==&l) {
+            jkmpBinaryArithmeticNode::evaluateOperation(res, l, r);
+            return;
+        }
+        double* out=jkmpPrepareDoubleVectorResult(res, n);
+        const double* a=l.numVec.data();
+        switch(operation) {
+            case '+': jkmpApplyVectorScalar<jkmpAddOp>(out, a, b, n); break;
+            case '-': jkmpApplyVectorScalar<jkmpSubOp>(out, a, b, n); break;
+            case '*': jkmpApplyVectorScalar<jkmpMulOp>(out, a, b, n); break;
+            case '/': jkmpApplyVectorScalar<jkmpDivOp>(out, a, b, n); break;
+            case '^': jkmpApplyVectorScalar<jkmpPowOp>(out, a, b, n); break;
+            default: jkmpBinaryArithmeticNode::evaluateOperation(res, l, r); break;
+        }
+    } else if (l.type==jkmpDouble && r.type==jkmpDoubleVector) {
+        const size_t n=r.numVec.size();
+        const double a=l.num;
+        if (&res==&r) {
+            jkmpBinaryArithmeticNode::evaluateOperation(res, l, r);
+            return;
+        }
+        double* out=jkmpPrepareDoubleVectorResult(res, n);
+        const double* b=r.numVec.data();
+        switch(operation) {
+            case '+': jkmpApplyScalarVector<jkmpAddOp>(out, a, b, n); break;
+            case '-': jkmpApplyScalarVector<jkmpSubOp>(out, a, b, n); break;
+            case '*': jkmpApplyScalarVector<jkmpMulOp>(out, a, b, n); break;
+            case '/': jkmpApplyScalarVector<jkmpDivOp>(out, a, b, n); break;
+            case '^': jkmpApplyScalarVector<jkmpPowOp>(out, a, b, n); break;
+            default: jkmpBinaryArithmeticNode::evaluateOperation(res, l, r); break;
+        }
+    } else {
+        jkmpBinaryArithmeticNode::evaluateOperation(res, l, r);
     }
 }
 
-JKMathParser::jkmpNode *JKMathParser::jkmpCompareNode::copy(JKMathParser::jkmpNode *par)
+JKMathParser::jkmpNode *JKMathParser::jkmpBinaryArithmeticVectorScalarNode::copy(JKMathParser::jkmpNode *par)
 {
-    JKMathParser::jkmpNode *n= new JKMathParser::jkmpCompareNode(operation, left->copy(), right->copy(), getParser(), par);
+    JKMathParser::jkmpBinaryArithmeticVectorScalarNode *n= new JKMathParser::jkmpBinaryArithmeticVectorScalarNode(operation, left->copy(), right->copy(), getParser(), par);
+    n->inferredType=inferredType;
     return n;
 }
 
-bool JKMathParser::jkmpCompareNode::createByteCode(JKMathParser::ByteCodeProgram &program, JKMathParser::ByteCodeEnvironment *environment)
+JKMP::string JKMathParser::jkmpBinaryArithmeticVectorScalarNode::printTree(int level) const
 {
-    bool ok=true;
+    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("BinaryArithmeticNode[vector,scalar] %2\n%1\n%3").arg(left->printTree(level+1)).arg(JKMP::string(operation)).arg(right->printTree(level+1));
+}
+
+JKMathParser::jkmpBinaryArithmeticVectorVectorNode::jkmpBinaryArithmeticVectorVectorNode(JKMP::charType op, JKMathParser::jkmpNode *l, JKMathParser::jkmpNode *r, JKMathParser *p, JKMathParser::jkmpNode *par):
+    jkmpBinaryArithmeticNode(op, l, r, p, par)
+{
+}
+
+void JKMathParser::jkmpBinaryArithmeticVectorVectorNode::evaluateOperation(jkmpResult &res, const jkmpResult &l, const jkmpResult &r)
+{
+    // different lengths are reported by the generic implementation
+    if (l.type!=jkmpDoubleVector || r.type!=jkmpDoubleVector || l.numVec.size()!=r.numVec.size() || &res==&l || &res==&r) {
+        jkmpBinaryArithmeticNode::evaluateOperation(res, l, r);
+        return;
+    }
+    const size_t n=l.numVec.size();
+    double* out=jkmpPrepareDoubleVectorResult(res, n);
+    const double* a=l.numVec.data();
+    const double* b=r.numVec.data();
+    switch(operation) {
+        case '+': jkmpApplyVectorVector<jkmpAddOp>(out, a, b, n); break;
+        case '-': jkmpApplyVectorVector<jkmpSubOp>(out, a, b, n); break;
+        case '*': jkmpApplyVectorVector<jkmpMulOp>(out, a, b, n); break;
+        case '/': jkmpApplyVectorVector<jkmpDivOp>(out, a, b, n); break;
+        case '^': jkmpApplyVectorVector<jkmpPowOp>(out, a, b, n); break;
+        default: jkmpBinaryArithmeticNode::evaluateOperation(res, l, r); break;
+    }
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpBinaryArithmeticVectorVectorNode::copy(JKMathParser::jkmpNode *par)
+{
+    JKMathParser::jkmpBinaryArithmeticVectorVectorNode *n= new JKMathParser::jkmpBinaryArithmeticVectorVectorNode(operation, left->copy(), right->copy(), getParser(), par);
+    n->inferredType=inferredType;
+    return n;
+}
+
+JKMP::string JKMathParser::jkmpBinaryArithmeticVectorVectorNode::printTree(int level) const
+{
+    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("BinaryArithmeticNode[vector,vector] %2\n%1\n%3").arg(left->printTree(level+1)).arg(JKMP::string(operation)).arg(right->printTree(level+1));
+}
+
+namespace {
+    /** \brief comparisons for jkmpFusedVectorNode */
+    struct jkmpEqualOp { static inline bool apply(double a, double b) { return a==b; } };
+    struct jkmpNotEqualOp { static inline bool apply(double a, double b) { return a!=b; } };
+    struct jkmpLesserOp { static inline bool apply(double a, double b) { return a<b; } };
+    struct jkmpGreaterOp { static inline bool apply(double a, double b) { return a>b; } };
+    struct jkmpLesserEqualOp { static inline bool apply(double a, double b) { return a<=b; } };
+    struct jkmpGreaterEqualOp { static inline bool apply(double a, double b) { return a>=b; } };
+
+    /** \brief a value on the stack of jkmpFusedVectorNode: a block of \c data, or the number \c value if \c data is \c NULL */
+    struct jkmpFusedSlot {
+        const double* data;
+        double value;
+    };
+
+    template <class OP>
+    inline void jkmpApplyFusedBlock(double* out, const jkmpFusedSlot& a, const jkmpFusedSlot& b, size_t n) {
+        if (a.data && b.data) jkmpApplyVectorVector<OP>(out, a.data, b.data, n);
+        else if (a.data) jkmpApplyVectorScalar<OP>(out, a.data, b.value, n);
+        else jkmpApplyScalarVector<OP>(out, a.value, b.data, n);
+    }
+
+    template <class OP>
+    inline void jkmpCompareFusedBlock(JKMP::vector<bool>& out, size_t offset, const jkmpFusedSlot& a, const jkmpFusedSlot& b, size_t n) {
+        if (a.data && b.data) {
+            for (size_t i=0; i<n; i++) out[offset+i]=OP::apply(a.data[i], b.data[i]);
+        } else if (a.data) {
+            for (size_t i=0; i<n; i++) out[offset+i]=OP::apply(a.data[i], b.value);
+        } else if (b.data) {
+            for (size_t i=0; i<n; i++) out[offset+i]=OP::apply(a.value, b.data[i]);
+        } else {
+            for (size_t i=0; i<n; i++) out[offset+i]=OP::apply(a.value, b.value);
+        }
+    }
+
+    inline double jkmpApplyFusedScalar(int operation, double a, double b) {
+        switch(operation) {
+            case '+': return a+b;
+            case '-': return a-b;
+            case '*': return a*b;
+            case '/': return a/b;
+            case '^': return pow(a,b);
+        }
+        return 0;
+    }
+}
+
+JKMathParser::jkmpFusedVectorNode::jkmpFusedVectorNode(JKMathParser::jkmpNode *original, JKMathParser *p, JKMathParser::jkmpNode *par):
+    jkmpNode(p, par)
+{
+    this->original=original;
+    buffersInUse=false;
+    if (original) {
+        original->setParent(this);
+        original->createFusedVectorProgram(program);
+        inferredType=original->getInferredType();
+    }
+    for (size_t i=0; i<program.operands.size(); i++) {
+        rangeOperands.push_back(dynamic_cast<JKMathParser::jkmpVectorConstructionNode*>(program.operands[i]));
+    }
+}
+
+JKMathParser::jkmpFusedVectorNode::~jkmpFusedVectorNode()
+{
+    if (original) deleteTree(original);
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpFusedVectorNode::fuse(JKMathParser::jkmpNode *node, bool checkParent)
+{
+    if (!node || !node->isElementwiseOperation()) return node;
+    JKMathParser::jkmpNode* par=node->getParent();
+    if (checkParent && par && par->isElementwiseOperation()) return node;
+
+    JKMathParser::FusedVectorProgram prog;
+    node->createFusedVectorProgram(prog);
+    if (prog.operationCount()<2) return node;
+    bool hasVector=false;
+    for (size_t i=0; i<prog.operands.size(); i++) {
+        if (prog.operands[i]->getInferredType()==jkmpDoubleVector) hasVector=true;
+    }
+    if (!hasVector) return node;
+    return new JKMathParser::jkmpFusedVectorNode(node, node->getParser(), par);
+}
+
+void JKMathParser::jkmpFusedVectorNode::evaluate(jkmpResult &result)
+{
+    if (buffersInUse) {
+        // recursive call of this node (e.g. from within a user-defined function): don't touch the buffers of the outer call
+        JKMP::vector<jkmpResult> values;
+        JKMP::vector<jkmpRange> ranges;
+        JKMP::vector<double> scratchBuffer;
+        evaluateProgram(result, values, ranges, scratchBuffer);
+    } else {
+        buffersInUse=true;
+        evaluateProgram(result, operandValues, operandRanges, scratch);
+        buffersInUse=false;
+    }
+}
+
+void JKMathParser::jkmpFusedVectorNode::evaluateProgram(jkmpResult &result, JKMP::vector<jkmpResult> &values, JKMP::vector<jkmpRange> &ranges, JKMP::vector<double> &scratchBuffer)
+{
+    values.resize(program.operands.size());
+    ranges.resize(program.operands.size());
+    for (size_t i=0; i<program.operands.size(); i++) {
+        if (rangeOperands[i]) {
+            // ranges start:delta:end are only materialised, if the blocked evaluation is not possible
+            if (rangeOperands[i]->evaluateRange(ranges[i])) values[i].setVoid();
+            else values[i].setInvalid();
+        } else {
+            program.operands[i]->evaluate(values[i]);
+        }
+    }
+    if (!evaluateBlocked(result, values, ranges, scratchBuffer)) {
+        for (size_t i=0; i<values.size(); i++) {
+            if (rangeOperands[i] && values[i].isValid) {
+                values[i].setDoubleVec();
+                ranges[i].toVector(values[i].numVec);
+            }
+        }
+        evaluateGeneric(result, values);
+    }
+}
+
+bool JKMathParser::jkmpFusedVectorNode::evaluateBlocked(jkmpResult &result, const JKMP::vector<jkmpResult> &values, const JKMP::vector<jkmpRange> &ranges, JKMP::vector<double> &scratchBuffer)
+{
+    const size_t ni=program.instructions.size();
+    if (ni==0) return false;
+
+    // all operands have to be numbers or vectors of numbers (or ranges) of the same length
+    size_t N=0;
+    bool hasVector=false;
+    size_t rangeCount=0;
+    for (size_t i=0; i<values.size(); i++) {
+        const jkmpResult& v=values[i];
+        if (!v.isValid) return false;
+        size_t n=0;
+        if (v.type==jkmpDoubleVector) {
+            n=v.numVec.size();
+        } else if (v.type==jkmpVoid && rangeOperands[i]) {
+            n=ranges[i].size();
+            rangeCount++;
+        } else if (v.type==jkmpDouble) {
+            continue;
+        } else {
+            return false;
+        }
+        if (!hasVector) {
+            N=n;
+            hasVector=true;
+        } else if (n!=N) {
+            return false;
+        }
+    }
+    if (!hasVector) return false;
+
+    // functions may have been redefined since the node was created
+    JKMP::vector<JKMathParser::jkmpEvaluateFuncSimple1Param> functions(ni, NULL);
+    JKMP::vector<JKMathParser::jkmpEvaluateFuncVector1Param> vectorFunctions(ni, NULL);
+    for (size_t k=0; k<ni; k++) {
+        if (program.instructions[k].opcode==JKMathParser::fusedFunction) {
+            const JKMathParser::jkmpFunctionDescriptor* fd=static_cast<JKMathParser::jkmpFunctionNode*>(program.instructions[k].node)->resolveFunction();
+            functions[k]=jkmpSimple1ParamFunction(fd);
+            if (!functions[k]) return false;
+            vectorFunctions[k]=jkmpVector1ParamFunction(fd);
+        }
+    }
+
+    const bool compareResult=(program.instructions[ni-1].opcode==JKMathParser::fusedCompare);
+    double* out=NULL;
+    if (compareResult) {
+        result.setBoolVec(static_cast<int>(N));
+    } else {
+        out=jkmpPrepareDoubleVectorResult(result, N);
+    }
+
+    const size_t B=JKMATHPARSER_FUSEDVECTOR_BLOCKSIZE;
+    // the stack slots use the first stackSize blocks of the scratch buffer, range operands are generated into the blocks after them
+    scratchBuffer.resize((program.stackSize+rangeCount)*B);
+    JKMP::vector<jkmpFusedSlot> slots(program.stackSize);
+    JKMP::vector<double> rangeValues;
+    JKMP::vector<size_t> rangeBlocks;
+    if (rangeCount>0) {
+        rangeValues.resize(values.size(), 0.0);
+        rangeBlocks.resize(values.size(), 0);
+    }
+    rangeCount=0;
+    for (size_t i=0; i<values.size(); i++) {
+        if (values[i].type==jkmpVoid) {
+            rangeValues[i]=ranges[i].start;
+            rangeBlocks[i]=program.stackSize+rangeCount;
+            rangeCount++;
+        }
+    }
+    for (size_t offset=0; offset<N; offset+=B) {
+        const size_t m=std::min(B, N-offset);
+        int sp=0;
+        for (size_t k=0; k<ni; k++) {
+            const JKMathParser::FusedVectorInstruction& inst=program.instructions[k];
+            // the last operation writes directly into the output vector, all others into the scratch block of their result slot
+            const bool toOutput=(k+1==ni && out);
+            switch(inst.opcode) {
+                case JKMathParser::fusedOperand: {
+                        const jkmpResult& v=values[inst.intpar];
+                        if (v.type==jkmpDoubleVector) {
+                            slots[sp].data=v.numVec.data()+offset;
+                        } else if (v.type==jkmpVoid) {
+                            double* dest=scratchBuffer.data()+rangeBlocks[inst.intpar]*B;
+                            rangeValues[inst.intpar]=ranges[inst.intpar].generate(dest, m, rangeValues[inst.intpar]);
+                            slots[sp].data=dest;
+                        } else {
+                            slots[sp].data=NULL;
+                            slots[sp].value=v.num;
+                        }
+                        sp++;
+                    } break;
+                case JKMathParser::fusedNegate: {
+                        jkmpFusedSlot& a=slots[sp-1];
+                        if (a.data) {
+                            double* dest=toOutput?(out+offset):(scratchBuffer.data()+(sp-1)*B);
+                            for (size_t i=0; i<m; i++) dest[i]=-a.data[i];
+                            a.data=dest;
+                        } else {
+                            a.value=-a.value;
+                        }
+                    } break;
+                case JKMathParser::fusedFunction: {
+                        jkmpFusedSlot& a=slots[sp-1];
+                        const JKMathParser::jkmpEvaluateFuncSimple1Param f=functions[k];
+                        if (a.data) {
+                            double* dest=toOutput?(out+offset):(scratchBuffer.data()+(sp-1)*B);
+                            if (vectorFunctions[k]) vectorFunctions[k](dest, a.data, m);
+                            else for (size_t i=0; i<m; i++) dest[i]=f(a.data[i]);
+                            a.data=dest;
+                        } else {
+                            a.value=f(a.value);
+                        }
+                    } break;
+                case JKMathParser::fusedBinaryArithmetic: {
+                        const jkmpFusedSlot b=slots[sp-1];
+                        jkmpFusedSlot& a=slots[sp-2];
+                        sp--;
+                        if (!a.data && !b.data) {
+                            a.value=jkmpApplyFusedScalar(inst.intpar, a.value, b.value);
+                        } else {
+                            double* dest=toOutput?(out+offset):(scratchBuffer.data()+(sp-1)*B);
+                            switch(inst.intpar) {
+                                case '+': jkmpApplyFusedBlock<jkmpAddOp>(dest, a, b, m); break;
+                                case '-': jkmpApplyFusedBlock<jkmpSubOp>(dest, a, b, m); break;
+                                case '*': jkmpApplyFusedBlock<jkmpMulOp>(dest, a, b, m); break;
+                                case '/': jkmpApplyFusedBlock<jkmpDivOp>(dest, a, b, m); break;
+                                case '^': jkmpApplyFusedBlock<jkmpPowOp>(dest, a, b, m); break;
+                            }
+                            a.data=dest;
+                        }
+                    } break;
+                case JKMathParser::fusedCompare: {
+                        const jkmpFusedSlot& b=slots[sp-1];
+                        const jkmpFusedSlot& a=slots[sp-2];
+                        switch(inst.intpar) {
+                            case jkmpCOMPequal: jkmpCompareFusedBlock<jkmpEqualOp>(result.boolVec, offset, a, b, m); break;
+                            case jkmpCOMPnequal: jkmpCompareFusedBlock<jkmpNotEqualOp>(result.boolVec, offset, a, b, m); break;
+                            case jkmpCOMPlesser: jkmpCompareFusedBlock<jkmpLesserOp>(result.boolVec, offset, a, b, m); break;
+                            case jkmpCOMPgreater: jkmpCompareFusedBlock<jkmpGreaterOp>(result.boolVec, offset, a, b, m); break;
+                            case jkmpCOMPlesserequal: jkmpCompareFusedBlock<jkmpLesserEqualOp>(result.boolVec, offset, a, b, m); break;
+                            case jkmpCOMPgreaterequal: jkmpCompareFusedBlock<jkmpGreaterEqualOp>(result.boolVec, offset, a, b, m); break;
+                        }
+                        sp--;
+                    } break;
+            }
+        }
+        if (out) {
+            // the result of the last operation may still be in an operand (e.g. for "x*1" with x being the only vector)
+            const jkmpFusedSlot& r=slots[0];
+            if (r.data && r.data!=out+offset) {
+                for (size_t i=0; i<m; i++) out[offset+i]=r.data[i];
+            } else if (!r.data) {
+                for (size_t i=0; i<m; i++) out[offset+i]=r.value;
+            }
+        }
+    }
+    return true;
+}
+
+void JKMathParser::jkmpFusedVectorNode::evaluateGeneric(jkmpResult &result, JKMP::vector<jkmpResult> &values)
+{
+    JKMP::vector<jkmpResult> stack(program.stackSize);
+    jkmpResult tmp;
+    int sp=0;
+    for (size_t k=0; k<program.instructions.size(); k++) {
+        const JKMathParser::FusedVectorInstruction& inst=program.instructions[k];
+        switch(inst.opcode) {
+            case JKMathParser::fusedOperand:
+                std::swap(stack[sp], values[inst.intpar]);
+                sp++;
+                break;
+            case JKMathParser::fusedNegate:
+                static_cast<JKMathParser::jkmpUnaryNode*>(inst.node)->evaluateOperation(stack[sp-1]);
+                break;
+            case JKMathParser::fusedBinaryArithmetic:
+                static_cast<JKMathParser::jkmpBinaryArithmeticNode*>(inst.node)->evaluateOperation(tmp, stack[sp-2], stack[sp-1]);
+                std::swap(stack[sp-2], tmp);
+                sp--;
+                break;
+            case JKMathParser::fusedCompare:
+                static_cast<JKMathParser::jkmpCompareNode*>(inst.node)->evaluateOperation(tmp, stack[sp-2], stack[sp-1]);
+                std::swap(stack[sp-2], tmp);
+                sp--;
+                break;
+            case JKMathParser::fusedFunction: {
+                    JKMathParser::jkmpFunctionNode* fn=static_cast<JKMathParser::jkmpFunctionNode*>(inst.node);
+                    const JKMathParser::jkmpFunctionDescriptor* fd=fn->resolveFunction();
+                    if (fd) {
+                        JKMP::vector<jkmpResult> params;
+                        params.push_back(stack[sp-1]);
+                        fd->evaluate(tmp, params, getParser());
+                        std::swap(stack[sp-1], tmp);
+                    } else {
+                        getParser()->jkmpError(jkmpErrorFunctionNotFound, fn->getSymbol());
+                        stack[sp-1].setInvalid();
+                    }
+                } break;
+        }
+    }
+    if (sp>0) std::swap(result, stack[0]);
+    else result.setInvalid();
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpFusedVectorNode::copy(JKMathParser::jkmpNode *par)
+{
+    if (original) return new JKMathParser::jkmpFusedVectorNode(original->copy(), getParser(), par);
+    else return new JKMathParser::jkmpFusedVectorNode(NULL, getParser(), par);
+}
+
+bool JKMathParser::jkmpFusedVectorNode::createByteCode(JKMathParser::ByteCodeProgram &byteCode, JKMathParser::ByteCodeEnvironment *environment)
+{
+    return original && original->createByteCode(byteCode, environment);
+}
+
+int JKMathParser::jkmpFusedVectorNode::inferType()
+{
+    inferredType=0;
+    if (original) inferredType=original->getInferredType();
+    return inferredType;
+}
+
+void JKMathParser::jkmpFusedVectorNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (original) slots.push_back(&original);
+}
+
+JKMP::string JKMathParser::jkmpFusedVectorNode::print() const
+{
+    if (original) return original->print();
+    return JKMP::string();
+}
+
+JKMP::string JKMathParser::jkmpFusedVectorNode::printTree(int level) const
+{
+    JKMP::string res=JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("FusedVectorNode (%1 operations, %2 operands)").arg(program.operationCount()).arg(program.operands.size());
+    if (original) res+=JKMP::string("\n")+original->printTree(level+1);
+    return res;
+}
+
+
+
+
+
+
+
+JKMathParser::jkmpCompareNode::jkmpCompareNode(JKMP::charType op, JKMathParser::jkmpNode* l, JKMathParser::jkmpNode* r, JKMathParser* p, JKMathParser::jkmpNode* par):
+    jkmpNode(p, par)
+{
+  left=l;
+  right=r;
+  if (left) left->setParent(this);
+  if (right) right->setParent(this);
+  setParser(p);
+  setParent(par);
+  operation=op;
+}
+
+JKMathParser::jkmpCompareNode::~jkmpCompareNode()
+{
+    if (left) deleteTree(left);
+    if (right) deleteTree(right);
+}
+
+
+void JKMathParser::jkmpCompareNode::evaluate(jkmpResult &res)
+{
+    jkmpResult l;
+    if (left) left->evaluate(l);
+    jkmpResult r;
+    if (right) right->evaluate(r);
+    evaluateOperation(res, l, r);
+}
+
+void JKMathParser::jkmpCompareNode::evaluateOperation(jkmpResult &res, const jkmpResult &l, const jkmpResult &r)
+{
+  /*if (l.type!=r.type) {
+      JKMATHPARSER_ERROR(parser, JKMP::_("you can't compare different datatypes"));
+      res.setInvalid();
+      return;
+  }*/
+
+  res.type=jkmpBool;
+  switch(operation) {
+        case jkmpCOMPequal:
+            jkmpResult::compareequal(res, l, r, getParser());
+            break;
+        case jkmpCOMPnequal:
+              jkmpResult::comparenotequal(res, l, r, getParser());
+              break;
+        case jkmpCOMPgreater:
+              jkmpResult::comparegreater(res, l, r, getParser());
+              break;
+
+        case jkmpCOMPlesser:
+              jkmpResult::comparesmaller(res, l, r, getParser());
+              break;
+
+        case jkmpCOMPgreaterequal:
+              jkmpResult::comparegreaterequal(res, l, r, getParser());
+              break;
+
+        case jkmpCOMPlesserequal:
+              jkmpResult::comparesmallerequal(res, l, r, getParser());
+              break;
+
+
+        default:
+              JKMATHPARSER_ERROR(parser, JKMP::_("compare operation between %1 and %2 not possible").arg(l.toTypeString()).arg(r.toTypeString()));
+              res.setInvalid();
+              break;
+    }
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpCompareNode::copy(JKMathParser::jkmpNode *par)
+{
+    JKMathParser::jkmpNode *n= new JKMathParser::jkmpCompareNode(operation, left->copy(), right->copy(), getParser(), par);
+    return n;
+}
+
+int JKMathParser::jkmpCompareNode::inferType()
+{
+    inferredType=0;
+    if (left && right) {
+        const int lt=left->getInferredType();
+        const int rt=right->getInferredType();
+        if (lt!=0 && lt==rt && (lt==jkmpDouble || lt==jkmpString || lt==jkmpBool)) inferredType=jkmpBool;
+        else if ((lt==jkmpDoubleVector && (rt==jkmpDouble || rt==jkmpDoubleVector)) || (lt==jkmpDouble && rt==jkmpDoubleVector)) inferredType=jkmpBoolVector;
+    }
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpCompareNode::specializeTypes()
+{
+    jkmpSpecializeChild(left, this);
+    jkmpSpecializeChild(right, this);
+    inferType();
+    // comparisons are only fused as the root of a subtree, so they don't wait for an element-wise parent
+    return jkmpFusedVectorNode::fuse(this, false);
+}
+
+void JKMathParser::jkmpCompareNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (left) slots.push_back(&left);
+    if (right) slots.push_back(&right);
+}
+
+bool JKMathParser::jkmpCompareNode::isElementwiseOperation()
+{
+    return left && right;
+}
+
+void JKMathParser::jkmpCompareNode::createFusedVectorProgram(JKMathParser::FusedVectorProgram &program)
+{
+    // the boolean result can not be processed further, so comparisons are only fused as root of the subtree
+    if (!isElementwiseOperation() || program.depth>0) {
+        jkmpNode::createFusedVectorProgram(program);
+        return;
+    }
+    program.depth++;
+    left->createFusedVectorProgram(program);
+    right->createFusedVectorProgram(program);
+    program.depth--;
+    program.add(JKMathParser::FusedVectorInstruction(JKMathParser::fusedCompare, this, operation), -1);
+}
+
+void JKMathParser::jkmpCompareNode::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    if (!left || !right) {
+        jkmpNode::createFlatProgram(program);
+        return;
+    }
+    program.add(JKMathParser::FlatInstruction(JKMathParser::flatReserve), 1);
+    left->createFlatProgram(program);
+    right->createFlatProgram(program);
+    program.add(JKMathParser::FlatInstruction(JKMathParser::flatCompare, this, operation), -2);
+}
+
+bool JKMathParser::jkmpCompareNode::createByteCode(JKMathParser::ByteCodeProgram &program, JKMathParser::ByteCodeEnvironment *environment)
+{
+    bool ok=true;
     if (right) ok=ok&&right->createByteCode(program, environment);
     if (left) ok=ok&&left->createByteCode(program, environment);
 
@@ -1840,7 +2971,7 @@ bool JKMathParser::jkmpCompareNode::createByteCode(JKMathParser::ByteCodeProgram
             break;
 
         default:
-            parser->jkmpError(JKMP::_("unknown compare operation"));
+            JKMATHPARSER_ERROR(parser, JKMP::_("unknown compare operation"));
             ok=false;
             break;
 
@@ -1907,8 +3038,8 @@ JKMathParser::jkmpBinaryBoolNode::jkmpBinaryBoolNode(JKMP::charType op, JKMathPa
 
 JKMathParser::jkmpBinaryBoolNode::~jkmpBinaryBoolNode()
 {
-    if (left) delete left;
-    if (right) delete right;
+    if (left) deleteTree(left);
+    if (right) deleteTree(right);
 }
 
 
@@ -1918,10 +3049,14 @@ void JKMathParser::jkmpBinaryBoolNode::evaluate(jkmpResult &res)
     if (left) left->evaluate(l);
     jkmpResult r;
     if (right) right->evaluate(r);
+    evaluateOperation(res, l, r);
+}
 
+void JKMathParser::jkmpBinaryBoolNode::evaluateOperation(jkmpResult &res, const jkmpResult &l, const jkmpResult &r)
+{
   /*if ((l.type!=jkmpBool)||(r.type!=jkmpBool)) {
       res.setInvalid();
-      parser->jkmpError(JKMP::_("logical operations only for bool"));
+      JKMATHPARSER_ERROR(parser, JKMP::_("logical operations only for bool"));
   } else {*/
       switch(operation) {
           case jkmpLOPand:
@@ -1941,7 +3076,7 @@ void JKMathParser::jkmpBinaryBoolNode::evaluate(jkmpResult &res)
               break;
 
 
-          default: parser->jkmpError(JKMP::_("unknown error"));
+          default: JKMATHPARSER_ERROR(parser, JKMP::_("unknown error"));
               res.setInvalid();
               break;
       }
@@ -1954,6 +3089,39 @@ JKMathParser::jkmpNode *JKMathParser::jkmpBinaryBoolNode::copy(JKMathParser::jkm
     return n;
 }
 
+int JKMathParser::jkmpBinaryBoolNode::inferType()
+{
+    inferredType=0;
+    if (left && right && left->getInferredType()==jkmpBool && right->getInferredType()==jkmpBool) inferredType=jkmpBool;
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpBinaryBoolNode::specializeTypes()
+{
+    jkmpSpecializeChild(left, this);
+    jkmpSpecializeChild(right, this);
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpBinaryBoolNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (left) slots.push_back(&left);
+    if (right) slots.push_back(&right);
+}
+
+void JKMathParser::jkmpBinaryBoolNode::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    if (!left || !right) {
+        jkmpNode::createFlatProgram(program);
+        return;
+    }
+    program.add(JKMathParser::FlatInstruction(JKMathParser::flatReserve), 1);
+    left->createFlatProgram(program);
+    right->createFlatProgram(program);
+    program.add(JKMathParser::FlatInstruction(JKMathParser::flatBinaryBool, this, operation), -2);
+}
+
 bool JKMathParser::jkmpBinaryBoolNode::createByteCode(JKMathParser::ByteCodeProgram &program, JKMathParser::ByteCodeEnvironment *environment)
 {
     bool ok=true;
@@ -1982,7 +3150,7 @@ bool JKMathParser::jkmpBinaryBoolNode::createByteCode(JKMathParser::ByteCodeProg
             break;
 
         default:
-            parser->jkmpError(JKMP::_("unknown logic operation"));
+            JKMATHPARSER_ERROR(parser, JKMP::_("unknown logic operation"));
             ok=false;
             break;
 
@@ -2031,41 +3199,52 @@ JKMP::string JKMathParser::jkmpBinaryBoolNode::opAsString() const
 JKMathParser::jkmpVariableNode::jkmpVariableNode(JKMP::string name, JKMathParser* p, JKMathParser::jkmpNode* par):
     jkmpNode(p, par)
  {
-  var=name;
+  varSymbol=internSymbol(name);
   setParser(p);
   setParent(par);
 };
 
 jkmpResult JKMathParser::jkmpVariableNode::evaluate() {
-    return getParser()->getVariable(var);
+    return getParser()->environment.getVariable(varSymbol);
 }
 
 void JKMathParser::jkmpVariableNode::evaluate(jkmpResult &result)
 {
-    result=getParser()->getVariable(var);
+    getParser()->environment.getVariable(result, varSymbol);
 }
 
 JKMathParser::jkmpNode *JKMathParser::jkmpVariableNode::copy(JKMathParser::jkmpNode *par)
 {
-    return new JKMathParser::jkmpVariableNode(var, getParser(), par);
+    return new JKMathParser::jkmpVariableNode(getName(), getParser(), par);
+}
+
+int JKMathParser::jkmpVariableNode::inferType()
+{
+    // the type of the variable at the time of the analysis: specialized nodes check the actual types of their operands
+    JKMathParser::jkmpVariable def;
+    inferredType=0;
+    // loop variables etc. don't exist yet, so check first to not report an error
+    if (getParser() && getParser()->environment.variableExists(varSymbol) && getParser()->environment.getVariableDef(varSymbol, def)) inferredType=def.getType();
+    return inferredType;
 }
 
 bool JKMathParser::jkmpVariableNode::createByteCode(JKMathParser::ByteCodeProgram &program, JKMathParser::ByteCodeEnvironment* environment)
 {
     JKMathParser::jkmpVariable def;
+    const JKMP::string& var=getName();
 
     if (environment->heapVariables.contains(var) && environment->heapVariables[var].size()>0) {
         if (environment->heapVariables[var].back()>=0) {
             program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcHeapRead, environment->heapVariables[var].back()));
             return true;
         } else {
-            getParser()->jkmpError(JKMP::_("heap-adress-error, tried to access heap item %1").arg(environment->heapVariables[var].back()));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("heap-adress-error, tried to access heap item %1").arg(environment->heapVariables[var].back()));
             return false;
         }
-    } else if (getParser()->environment.getVariableDef(var, def)) {
-        int level=getParser()->environment.getVariableLevel(var);
+    } else if (getParser()->environment.getVariableDef(varSymbol, def)) {
+        int level=getParser()->environment.getVariableLevel(varSymbol);
         if (level>0) {
-            getParser()->jkmpError(JKMP::_("only top-level variables allowed in byte-coded expressionen (variable '%1', level %2)").arg(var).arg(level));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("only top-level variables allowed in byte-coded expressionen (variable '%1', level %2)").arg(var).arg(level));
             return false;
         }
         if (def.getType()==jkmpDouble) {
@@ -2074,15 +3253,15 @@ bool JKMathParser::jkmpVariableNode::createByteCode(JKMathParser::ByteCodeProgra
                 program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcVarRead, varP));
                 return true;
             } else {
-                getParser()->jkmpError(JKMP::_("variable '%1' points to NULL").arg(var));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("variable '%1' points to NULL").arg(var));
                 return false;
             }
         } else {
-            getParser()->jkmpError(JKMP::_("only number-valued variables allowed in byte-coded expressions (variable '%1')").arg(var));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("only number-valued variables allowed in byte-coded expressions (variable '%1')").arg(var));
             return false;
         }
     } else {
-        getParser()->jkmpError(JKMP::_("variable '%1' not found").arg(var));
+        JKMATHPARSER_ERROR(getParser(), JKMP::_("variable '%1' not found").arg(var));
         return false;
     }
 
@@ -2090,13 +3269,13 @@ bool JKMathParser::jkmpVariableNode::createByteCode(JKMathParser::ByteCodeProgra
 
 JKMP::string JKMathParser::jkmpVariableNode::print() const
 {
-    return var;
+    return getName();
 
 }
 
 JKMP::string JKMathParser::jkmpVariableNode::printTree(int level) const
 {
-    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("VariableNode '%1'").arg(var);
+    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("VariableNode '%1'").arg(getName());
 }
 
 
@@ -2151,7 +3330,7 @@ void JKMathParser::jkmpNodeList::evaluate(jkmpResult &res)
           //qDebug()<<"eval nodelist(), item"<<i+1<<"/"<<n<<":  "<<res.toTypeString();
        }
        return ;
-    } else parser->jkmpError(JKMP::_("NodeList empty"));
+    } else JKMATHPARSER_ERROR(parser, JKMP::_("NodeList empty"));
     res.setInvalid();
 }
 
@@ -2170,7 +3349,7 @@ void JKMathParser::jkmpNodeList::evaluate(JKMP::vector<jkmpResult> &result)
           //qDebug()<<"eval nodelist(), item"<<i+1<<"/"<<n<<":  "<<res.toTypeString();
        }
        return ;
-    } else parser->jkmpError(JKMP::_("NodeList empty"));
+    } else JKMATHPARSER_ERROR(parser, JKMP::_("NodeList empty"));
     result.clear();
 
 }
@@ -2189,6 +3368,42 @@ JKMathParser::jkmpNode *JKMathParser::jkmpNodeList::copy(JKMathParser::jkmpNode
     return n;
 }
 
+int JKMathParser::jkmpNodeList::inferType()
+{
+    inferredType=0;
+    if (list.size()>0 && list[list.size()-1]) inferredType=list[list.size()-1]->getInferredType();
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpNodeList::specializeTypes()
+{
+    for (size_t i=0; i<list.size(); i++) {
+        jkmpSpecializeChild(list[i], this);
+    }
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpNodeList::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    for (size_t i=0; i<list.size(); i++) {
+        if (list[i]) slots.push_back(&list[i]);
+    }
+}
+
+void JKMathParser::jkmpNodeList::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    if (list.size()<=0) {
+        jkmpNode::createFlatProgram(program);
+        return;
+    }
+    for (size_t i=0; i<list.size(); i++) {
+        if (i>0) program.add(JKMathParser::FlatInstruction(JKMathParser::flatPop), -1);
+        if (list[i]) list[i]->createFlatProgram(program);
+        else program.add(JKMathParser::FlatInstruction(JKMathParser::flatPushInvalid), 1);
+    }
+}
+
 bool JKMathParser::jkmpNodeList::createByteCode(JKMathParser::ByteCodeProgram &program, JKMathParser::ByteCodeEnvironment *environment)
 {
     bool ok=true;
@@ -2232,7 +3447,7 @@ JKMathParser::jkmpNodeList::jkmpNodeList(JKMathParser *p, JKMathParser::jkmpNode
 JKMathParser::jkmpNodeList::~jkmpNodeList() {
 
     if (list.size()>0) for (size_t i=0; i<list.size(); i++) {
-        if (list[i]) delete list[i];
+        if (list[i]) deleteTree(list[i]);
     }
     list.clear();
 }
@@ -2240,7 +3455,7 @@ JKMathParser::jkmpNodeList::~jkmpNodeList() {
 
 JKMathParser::jkmpVariableAssignNode::~jkmpVariableAssignNode()
 {
-    if (child) delete child;
+    if (child) deleteTree(child);
 }
 
 JKMathParser::jkmpVariableAssignNode::jkmpVariableAssignNode(JKMP::string var, JKMathParser::jkmpNode* c, JKMathParser* p, JKMathParser::jkmpNode* par):
@@ -2250,7 +3465,7 @@ JKMathParser::jkmpVariableAssignNode::jkmpVariableAssignNode(JKMP::string var, J
   if (child) child->setParent(this);
   setParser(p);
   setParent(par);
-  variable=var;
+  variableSymbol=internSymbol(var);
 //  std::cout<<"assign: "<<var<<std::endl;
 }
 
@@ -2259,18 +3474,50 @@ JKMathParser::jkmpVariableAssignNode::jkmpVariableAssignNode(JKMP::string var, J
 void JKMathParser::jkmpVariableAssignNode::evaluate(jkmpResult &result)
 {
     if (child) child->evaluate(result);
-    getParser()->setVariable(variable, result);
+    getParser()->environment.setVariable(variableSymbol, result);
 }
 
 JKMathParser::jkmpNode *JKMathParser::jkmpVariableAssignNode::copy(JKMathParser::jkmpNode *par)
 {
-    if (child) return new JKMathParser::jkmpVariableAssignNode(variable, child->copy(NULL), getParser(), par);
-    else return new JKMathParser::jkmpVariableAssignNode(variable, NULL, getParser(), par);
+    if (child) return new JKMathParser::jkmpVariableAssignNode(getName(), child->copy(NULL), getParser(), par);
+    else return new JKMathParser::jkmpVariableAssignNode(getName(), NULL, getParser(), par);
+}
+
+int JKMathParser::jkmpVariableAssignNode::inferType()
+{
+    inferredType=0;
+    if (child) inferredType=child->getInferredType();
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpVariableAssignNode::specializeTypes()
+{
+    jkmpSpecializeChild(child, this);
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpVariableAssignNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (child) slots.push_back(&child);
+}
+
+void JKMathParser::jkmpVariableAssignNode::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    if (!child) {
+        jkmpNode::createFlatProgram(program);
+        return;
+    }
+    child->createFlatProgram(program);
+    JKMathParser::FlatInstruction inst(JKMathParser::flatAssignVariable, this);
+    inst.strpar=getName();
+    program.add(inst, 0);
 }
 
 bool JKMathParser::jkmpVariableAssignNode::createByteCode(JKMathParser::ByteCodeProgram &program, JKMathParser::ByteCodeEnvironment *environment)
 {
     JKMathParser::jkmpVariable def;
+    const JKMP::string& variable=getName();
 
     bool ok=child->createByteCode(program, environment);
 
@@ -2281,13 +3528,13 @@ bool JKMathParser::jkmpVariableAssignNode::createByteCode(JKMathParser::ByteCode
                 program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcHeapRead, environment->heapVariables[variable].back()));
                 return true;
             } else {
-                getParser()->jkmpError(JKMP::_("heap-adress-error, tried to access heap item %1").arg(environment->heapVariables[variable].back()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("heap-adress-error, tried to access heap item %1").arg(environment->heapVariables[variable].back()));
                 return false;
             }
-        } else if (getParser()->environment.getVariableDef(variable, def)) {
-            int level=getParser()->environment.getVariableLevel(variable);
+        } else if (getParser()->environment.getVariableDef(variableSymbol, def)) {
+            int level=getParser()->environment.getVariableLevel(variableSymbol);
             if (level>0) {
-                getParser()->jkmpError(JKMP::_("only top-level variables allowed in byte-coded expressionen (variable '%1', level %2)").arg(variable).arg(level));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("only top-level variables allowed in byte-coded expressionen (variable '%1', level %2)").arg(variable).arg(level));
                 return false;
             }
             double* varP=NULL;
@@ -2298,15 +3545,15 @@ bool JKMathParser::jkmpVariableAssignNode::createByteCode(JKMathParser::ByteCode
                     program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcVarRead, varP));
                     return true;
                 } else {
-                    getParser()->jkmpError(JKMP::_("variable '%1' points to NULL").arg(variable));
+                    JKMATHPARSER_ERROR(getParser(), JKMP::_("variable '%1' points to NULL").arg(variable));
                     return false;
                 }
             } else {
-                getParser()->jkmpError(JKMP::_("only number-values variables allowed in byte-coded expressions (variable '%1')").arg(variable));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("only number-values variables allowed in byte-coded expressions (variable '%1')").arg(variable));
                 return false;
             }
         } else {
-            /*getParser()->jkmpError(JKMP::_("variable '%1' not found").arg(var));
+            /*JKMATHPARSER_ERROR(getParser(), JKMP::_("variable '%1' not found").arg(var));
             return false;*/
             int varIdx=environment->pushVar(variable);
             program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcHeapWrite, varIdx));
@@ -2319,20 +3566,23 @@ bool JKMathParser::jkmpVariableAssignNode::createByteCode(JKMathParser::ByteCode
 
 JKMP::string JKMathParser::jkmpVariableAssignNode::print() const
 {
-    return JKMP::string("%1 = %2").arg(variable).arg(child->print());
+    return JKMP::string("%1 = %2").arg(getName()).arg(child->print());
 
 }
 
 JKMP::string JKMathParser::jkmpVariableAssignNode::printTree(int level) const
 {
-    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("VariableAssigneNode '%2'\n%1").arg(child->printTree(level+1)).arg(variable);
+    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("VariableAssigneNode '%2'\n%1").arg(child->printTree(level+1)).arg(getName());
 }
 
 JKMathParser::jkmpFunctionNode::jkmpFunctionNode(JKMP::string name, JKMP::vector<jkmpNode *> params, JKMathParser *p, jkmpNode *par):
     jkmpNode(p, par)
  {
   child=params;
-  fun=name;
+  funSymbol=internSymbol(name);
+  cachedFunction=NULL;
+  cachedGeneration=0;
+  paramBufferInUse=false;
   setParser(p);
   setParent(par);
   if (child.size()>0) {
@@ -2342,13 +3592,32 @@ JKMathParser::jkmpFunctionNode::jkmpFunctionNode(JKMP::string name, JKMP::vector
   }
 }
 
+const JKMathParser::jkmpFunctionDescriptor *JKMathParser::jkmpFunctionNode::resolveFunction()
+{
+    const uint64_t gen=parser->environment.getFunctionGeneration();
+    if (!cachedFunction || cachedGeneration!=gen) {
+        cachedFunction=parser->environment.getFunctionDescriptor(funSymbol);
+        cachedGeneration=gen;
+    }
+    return cachedFunction;
+}
+
 void JKMathParser::jkmpFunctionNode::evaluate(jkmpResult &result)
 {
-    /*JKMP::vector<jkmpResult> data(child.size(), JKMathParser::getInvalidResult());
-    for (int i=0; i<child.size(); i++) {
-        if (child[i]) child[i]->evaluate(data[i]);
-    }*/
-    result=parser->evaluateFunction(fun, child);
+    const JKMathParser::jkmpFunctionDescriptor* fd=resolveFunction();
+    if (!fd) {
+        parser->jkmpError(jkmpErrorFunctionNotFound, funSymbol);
+        result.setInvalid();
+        return;
+    }
+    if (paramBufferInUse) {
+        // recursive call of this node (e.g. from within a user-defined function): don't touch the buffer of the outer call
+        fd->evaluate(result, child, parser);
+    } else {
+        paramBufferInUse=true;
+        fd->evaluate(result, child, parser, &paramBuffer);
+        paramBufferInUse=false;
+    }
 }
 
 JKMathParser::jkmpNode *JKMathParser::jkmpFunctionNode::copy(JKMathParser::jkmpNode *par)
@@ -2360,11 +3629,87 @@ JKMathParser::jkmpNode *JKMathParser::jkmpFunctionNode::copy(JKMathParser::jkmpN
         }
     }
 
-    return new JKMathParser::jkmpFunctionNode(fun, params, getParser(), par);
+    return new JKMathParser::jkmpFunctionNode(getName(), params, getParser(), par);
+}
+
+int JKMathParser::jkmpFunctionNode::inferType()
+{
+    inferredType=0;
+    const JKMathParser::jkmpFunctionDescriptor* fd=resolveFunction();
+    if (!fd || (fd->type!=JKMathParser::functionC && fd->type!=JKMathParser::functionCRefReturn)) return inferredType;
+    const int params=child.size();
+    if (!fd->simpleFuncPointer.value(params, NULL) && !fd->simpleFuncPointer.value(100+params, NULL)) return inferredType;
+    for (size_t i=0; i<child.size(); i++) {
+        if (!child[i] || child[i]->getInferredType()!=jkmpDouble) return inferredType;
+    }
+    inferredType=jkmpDouble;
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpFunctionNode::specializeTypes()
+{
+    for (size_t i=0; i<child.size(); i++) {
+        jkmpSpecializeChild(child[i], this);
+    }
+    inferType();
+    return jkmpFusedVectorNode::fuse(this);
+}
+
+void JKMathParser::jkmpFunctionNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    for (size_t i=0; i<child.size(); i++) {
+        if (child[i]) slots.push_back(&child[i]);
+    }
+}
+
+bool JKMathParser::jkmpFunctionNode::isElementwiseOperation()
+{
+    return child.size()==1 && child[0] && jkmpSimple1ParamFunction(resolveFunction());
+}
+
+void JKMathParser::jkmpFunctionNode::createFusedVectorProgram(JKMathParser::FusedVectorProgram &program)
+{
+    if (!isElementwiseOperation()) {
+        jkmpNode::createFusedVectorProgram(program);
+        return;
+    }
+    program.depth++;
+    child[0]->createFusedVectorProgram(program);
+    program.depth--;
+    program.add(JKMathParser::FusedVectorInstruction(JKMathParser::fusedFunction, this), 0);
+}
+
+void JKMathParser::jkmpFunctionNode::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    for (size_t i=0; i<child.size(); i++) {
+        if (!child[i]) {
+            jkmpNode::createFlatProgram(program);
+            return;
+        }
+    }
+    const int n=child.size();
+    const jkmpFunctionDescriptor* fd=resolveFunction();
+    if (fd && (fd->type==JKMathParser::functionC || fd->type==JKMathParser::functionCRefReturn)) {
+        program.add(JKMathParser::FlatInstruction(JKMathParser::flatReserve), 1);
+        for (size_t i=0; i<child.size(); i++) {
+            child[i]->createFlatProgram(program);
+        }
+        program.add(JKMathParser::FlatInstruction(JKMathParser::flatCallC, this, n), -n);
+    } else if (!fd || fd->type==JKMathParser::functionNode) {
+        // functions that are not (yet) defined are assumed to be user-defined (e.g. "f(x)=x^2; f(2)")
+        for (size_t i=0; i<child.size(); i++) {
+            child[i]->createFlatProgram(program);
+        }
+        program.add(JKMathParser::FlatInstruction(JKMathParser::flatCallUser, this, n), 1-n);
+    } else {
+        // functions that work on the parameter nodes (jkmpEvaluateFromNodesFuncRefReturn) are evaluated recursively
+        jkmpNode::createFlatProgram(program);
+    }
 }
 
 bool JKMathParser::jkmpFunctionNode::createByteCode(JKMathParser::ByteCodeProgram &program, ByteCodeEnvironment *environment)
 {
+    const JKMP::string& fun=getName();
     bool ok=true;
     int params=0;
     for (int i=child.size()-1; i>=0; i--) {
@@ -2377,7 +3722,7 @@ bool JKMathParser::jkmpFunctionNode::createByteCode(JKMathParser::ByteCodeProgra
         JKMathParser::jkmpFunctionDescriptor def;
         if (environment->functionDefs.contains(fun) && environment->functionDefs[fun].second) {
             if (environment->inFunctionCalls.find(fun)!=environment->inFunctionCalls.end()) {
-                getParser()->jkmpError(JKMP::_("no recursive function calls allowed in byte-code (function '%1')").arg(fun));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("no recursive function calls allowed in byte-code (function '%1')").arg(fun));
                 return false;
             } else if (environment->functionDefs[fun].first.size()==params) {
                 for (int i=0; i<params; i++) {
@@ -2393,32 +3738,33 @@ bool JKMathParser::jkmpFunctionNode::createByteCode(JKMathParser::ByteCodeProgra
                 }
                 return ok;
             } else {
-                getParser()->jkmpError(JKMP::_("function '%1' defined with wrong number of parameters (required: %2, in definition: %3)").arg(fun).arg(params).arg(environment->functionDefs[fun].first.size()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("function '%1' defined with wrong number of parameters (required: %2, in definition: %3)").arg(fun).arg(params).arg(environment->functionDefs[fun].first.size()));
                 return false;
             }
-        } else if (getParser()->environment.getFunctionDef(fun, def)) {
-            int level=getParser()->environment.getFunctionLevel(fun);
+        } else if (getParser()->environment.getFunctionDef(funSymbol, def)) {
+            int level=getParser()->environment.getFunctionLevel(funSymbol);
             if (level>0) {
-                getParser()->jkmpError(JKMP::_("only top-level functions allowed in byte-coded expressionen (function '%1', level %2)").arg(fun).arg(level));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("only top-level functions allowed in byte-coded expressionen (function '%1', level %2)").arg(fun).arg(level));
                 return false;
             }
-            jkmpFunctiontype ft=getParser()->environment.getFunctionType(fun);
+            jkmpFunctiontype ft=getParser()->environment.getFunctionType(funSymbol);
             if (ft==functionFromNode || ft==functionInvalid) {
-                getParser()->jkmpError(JKMP::_("only simple functions allowed in byte-coded expressionen (function '%1')").arg(fun));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("only simple functions allowed in byte-coded expressionen (function '%1')").arg(fun));
                 return false;
             }
-            if ((!def.simpleFuncPointer.contains(params) && !def.simpleFuncPointer.contains(100+params)) || (!def.simpleFuncPointer[params] && !def.simpleFuncPointer[100+params])) {
+            // value() does not insert NULL entries, which would be called as simple functions
+            void* fp=def.simpleFuncPointer.value(params, NULL);
+            void* fpMP=def.simpleFuncPointer.value(100+params, NULL);
+            if (!fp && !fpMP) {
                 program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcCallResultFunction, fun, params));
                 //getParser()->jkmpError(JKMP::_("no implementation of function '%1(...)' with %2 parameters found").arg(fun).arg(params));
                 return true;
             }
-            if (def.simpleFuncPointer.contains(params)) {
-                void* fp=def.simpleFuncPointer[params];
+            if (fp) {
                 program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcCallCFunction, fp, params));
                 return true;
             } else {
-                void* fp=def.simpleFuncPointer[params+100];
-                program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcCallCMPFunction, fp, params));
+                program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcCallCMPFunction, fpMP, params));
                 return true;
             }
         }
@@ -2432,7 +3778,7 @@ JKMP::string JKMathParser::jkmpFunctionNode::print() const
     for (size_t i=0; i<child.size(); i++) {
         sl<<child[i]->print();
     }
-    return JKMP::string("%1(%2)").arg(fun).arg(sl.join(", "));
+    return JKMP::string("%1(%2)").arg(getName()).arg(sl.join(", "));
 }
 
 JKMP::string JKMathParser::jkmpFunctionNode::printTree(int level) const
@@ -2443,8 +3789,8 @@ JKMP::string JKMathParser::jkmpFunctionNode::printTree(int level) const
             sl<<child[i]->printTree(level+1);
         }
     }
-    if (child.size()>0) return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("FunctionNode '%1(...)'\n%2").arg(fun).arg(sl.join("\n"));
-    else return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("FunctionNode '%1()'").arg(fun);
+    if (child.size()>0) return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("FunctionNode '%1(...)'\n%2").arg(getName()).arg(sl.join("\n"));
+    else return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("FunctionNode '%1()'").arg(getName());
 }
 
 
@@ -2452,7 +3798,7 @@ JKMathParser::jkmpFunctionNode::~jkmpFunctionNode() {
 
     if (child.size()>0) {
       for (size_t i=0; i<child.size(); i++) {
-        if (child[i]) delete child[i];
+        if (child[i]) deleteTree(child[i]);
       }
       child.clear();
     }
@@ -2596,7 +3942,7 @@ JKMathParser::jkmpVariable::jkmpVariable(JKMP::stringVector *ref)
     matrix_columns=NULL;
 }
 
-JKMathParser::jkmpVariable::jkmpVariable(JKMP::map<JKMP::string, jkmpResult> *ref)
+JKMathParser::jkmpVariable::jkmpVariable(JKMP::flatmap<JKMP::string,jkmpResult> *ref)
 {
     type=jkmpStruct;     /*!< \brief type of the variable */
     internal=false;           /*!< \brief this is an internal variable */
@@ -2611,7 +3957,7 @@ JKMathParser::jkmpVariable::jkmpVariable(JKMP::map<JKMP::string, jkmpResult> *re
     matrix_columns=NULL;
 }
 
-JKMathParser::jkmpVariable::jkmpVariable(JKMP::vector<jkmpResult> *ref)
+JKMathParser::jkmpVariable::jkmpVariable(JKMP::sharedvector<jkmpResult> *ref)
 {
     type=jkmpList;     /*!< \brief type of the variable */
     internal=false;           /*!< \brief this is an internal variable */
@@ -2722,8 +4068,8 @@ void JKMathParser::jkmpVariable::set(const jkmpResult &result)
             case jkmpBoolMatrix:  if (!boolVec || !matrix_columns){ if (boolVec) delete boolVec; if (matrix_columns) delete matrix_columns; boolVec=new JKMP::vector<bool>; matrix_columns=new int; internal=true; } *boolVec=result.boolVec; *matrix_columns=result.matrix_columns;   break;
             case jkmpString:  if (!str) {str=new JKMP::string; internal=true; } *str=result.str; break;
             case jkmpBool:  if (!boolean) {boolean=new bool; internal=true; } *boolean=result.boolean; break;
-            case jkmpStruct:  if (!structData) {structData=new JKMP::map<JKMP::string, jkmpResult>; internal=true; } *structData=result.structData; break;
-            case jkmpList:  if (!listData) {listData=new JKMP::vector<jkmpResult>; internal=true; } *listData=result.listData; break;
+            case jkmpStruct:  if (!structData) {structData=new JKMP::flatmap<JKMP::string,jkmpResult>; internal=true; } *structData=result.structData; break;
+            case jkmpList:  if (!listData) {listData=new JKMP::sharedvector<jkmpResult>; internal=true; } *listData=result.listData; break;
             case jkmpVoid: break;
         }
     } else {
@@ -2739,8 +4085,8 @@ void JKMathParser::jkmpVariable::set(const jkmpResult &result)
             case jkmpBoolMatrix: boolVec=new JKMP::vector<bool>; matrix_columns=new int; *matrix_columns=result.matrix_columns; *boolVec=result.boolVec; break;
             case jkmpString: str=new JKMP::string; *str=result.str; break;
             case jkmpBool: boolean=new bool; *boolean=result.boolean; break;
-            case jkmpStruct: structData=new JKMP::map<JKMP::string, jkmpResult>; *structData=result.structData; break;
-            case jkmpList: listData=new JKMP::vector<jkmpResult>; *listData=result.listData; break;
+            case jkmpStruct: structData=new JKMP::flatmap<JKMP::string,jkmpResult>; *structData=result.structData; break;
+            case jkmpList: listData=new JKMP::sharedvector<jkmpResult>; *listData=result.listData; break;
             case jkmpVoid: break;
         }
     }
@@ -2752,7 +4098,11 @@ void JKMathParser::jkmpVariable::set(const jkmpResult &result)
 
 JKMP::stringVector JKMathParser::getLastErrors() const
 {
-    return lastError;
+    JKMP::stringVector res;
+    for (size_t i=0; i<lastError.size(); i++) {
+        res.push_back(lastError[i].format());
+    }
+    return res;
 }
 
 int JKMathParser::getLastErrorCount()
@@ -2770,13 +4120,13 @@ void JKMathParser::resetErrors()
 JKMP::string JKMathParser::getLastError() const
 {
     if (lastError.is_empty()) return JKMP::string();
-    return lastError.back();
+    return lastError.back().format();
 }
 
 JKMP::string JKMathParser::getFirstError() const
 {
     if (lastError.is_empty()) return JKMP::string();
-    return lastError.front();
+    return lastError.front().format();
 }
 
 JKMathParser::jkmpFunctionDescriptor::jkmpFunctionDescriptor()
@@ -2807,7 +4157,7 @@ void JKMathParser::jkmpFunctionDescriptor::evaluate(jkmpResult &r, const JKMP::v
     } else if (type==JKMathParser::functionNode) {
         if (parameterNames.size()!=parameters.size()) {
             r.setInvalid();
-            parent->jkmpError(JKMP::_("function '%1' takes %2 parameters, but %3 parameters were given").arg(name).arg(parameterNames.size()).arg(parameters.size()));
+            JKMATHPARSER_ERROR(parent, JKMP::_("function '%1' takes %2 parameters, but %3 parameters were given").arg(name).arg(parameterNames.size()).arg(parameters.size()));
         } else {
             if (parent && parameterNames.size()>0) {
                 parent->enterBlock();
@@ -2817,11 +4167,11 @@ void JKMathParser::jkmpFunctionDescriptor::evaluate(jkmpResult &r, const JKMP::v
                     //qDebug()<<"  adding "<<parameterNames[i]<<"="<<parameters[i].toString()<<"  levels="<<parent->getVariableLevels(parameterNames[i]);
                 }
                 //qDebug()<<"  eval";
-                functionNode->evaluate(r);
+                evaluateFunctionNode(r, parameters, parent);
                 //qDebug()<<"leaving block "<<parent->getBlockLevel();
                 parent->leaveBlock();
             } else {
-                functionNode->evaluate(r);
+                evaluateFunctionNode(r, parameters, parent);
             }
         }
     } else {
@@ -2831,63 +4181,317 @@ void JKMathParser::jkmpFunctionDescriptor::evaluate(jkmpResult &r, const JKMP::v
 
 }
 
-void JKMathParser::jkmpFunctionDescriptor::evaluate(jkmpResult &r,  JKMP::vector<jkmpNode *> parameters, JKMathParser *parent) const
+void JKMathParser::jkmpFunctionDescriptor::evaluate(jkmpResult &r, const JKMP::vector<jkmpNode *>& parameters, JKMathParser *parent, JKMP::vector<jkmpResult>* paramBuffer) const
 {
 
     r.setInvalid();
     if (type==JKMathParser::functionFromNode) {
-        functionFN(r, parameters.data(), parameters.size(), parent);
+        functionFN(r, const_cast<jkmpNode**>(parameters.data()), parameters.size(), parent);
     } else if (type==JKMathParser::functionNode) {
         if (parameterNames.size()!=parameters.size()) {
             r.setInvalid();
-            parent->jkmpError(JKMP::_("function '%1' takes %2 parameters, but %3 parameters were given").arg(name).arg(parameterNames.size()).arg(parameters.size()));
+            JKMATHPARSER_ERROR(parent, JKMP::_("function '%1' takes %2 parameters, but %3 parameters were given").arg(name).arg(parameterNames.size()).arg(parameters.size()));
         } else {
             if (parent && parameters.size()>0) {
                 parent->enterBlock();
                 //qDebug()<<"enter block "<<parent->getBlockLevel();
+                JKMP::vector<jkmpResult> values;
+                values.resize(parameters.size());
                 for (size_t i=0; i<parameters.size(); i++) {
-                    jkmpResult ri;
-                    parameters[i]->evaluate(ri);
-                    parent->addVariable(parameterNames[i], ri);
-                    //qDebug()<<"  adding "<<parameterNames[i]<<"="<<ri.toString()<<"  levels="<<parent->getVariableLevels(parameterNames[i]);
+                    parameters[i]->evaluate(values[i]);
+                    parent->addVariable(parameterNames[i], values[i]);
+                    //qDebug()<<"  adding "<<parameterNames[i]<<"="<<values[i].toString()<<"  levels="<<parent->getVariableLevels(parameterNames[i]);
                 }
                 //qDebug()<<"  eval";
-                functionNode->evaluate(r);
+                evaluateFunctionNode(r, values, parent);
                 //qDebug()<<"leaving block "<<parent->getBlockLevel();
                 parent->leaveBlock();
             } else {
-                functionNode->evaluate(r);
+                evaluateFunctionNode(r, JKMP::vector<jkmpResult>(), parent);
             }
         }
-    } else if (type==JKMathParser::functionC) {
-        JKMP::vector<jkmpResult> ps;
+    } else if (type==JKMathParser::functionC || type==JKMathParser::functionCRefReturn) {
+        JKMP::vector<jkmpResult> localps;
+        JKMP::vector<jkmpResult>& ps=(paramBuffer)?(*paramBuffer):localps;
         ps.resize(parameters.size());
         for (size_t i=0; i<parameters.size(); i++) {
             parameters[i]->evaluate(ps[i]);
         }
-        r=function(ps.data(), ps.size(), parent);
-    } else if (type==JKMathParser::functionCRefReturn) {
-        JKMP::vector<jkmpResult> ps;
-        ps.resize(parameters.size());
-        for (size_t i=0; i<parameters.size(); i++) {
-            parameters[i]->evaluate(ps[i]);
-        }
-        functionRR(r, ps.data(), ps.size(), parent);
+        if (type==JKMathParser::functionC) r=function(ps.data(), ps.size(), parent);
+        else functionRR(r, ps.data(), ps.size(), parent);
+        // only the capacity of the buffer is kept, so it does not hold on to the (possibly large) parameters until the next call
+        ps.clear();
     } else {
         r.setInvalid();
     }
 
 }
 
-JKMP::string JKMathParser::jkmpFunctionDescriptor::toDefString() const
+JKMP::string JKMathParser::jkmpFunctionDescriptor::toDefString() const
+{
+    JKMP::string res="";
+    if (type==JKMathParser::functionNode) res=JKMP::string("%1(%2): node").arg(name).arg(parameterNames.join(", "));
+    else if (type==JKMathParser::functionC) res=JKMP::string("%1(?): C function (copy-return)").arg(name);
+    else if (type==JKMathParser::functionCRefReturn) res=JKMP::string("%1(?): C function (return-by-reference)").arg(name);
+    else if (type==JKMathParser::functionFromNode) res=JKMP::string("%1(?): C function of nodes (return-by-reference)").arg(name);
+    else if (type==JKMathParser::functionInvalid) res=JKMP::string("%1(?): invalid function").arg(name);
+    return res;
+}
+
+
+bool JKMathParser::jkmpFunctionDescriptor::getMemoKey(std::vector<uint64_t> &key, const JKMP::vector<jkmpResult> &parameters, JKMathParser *parent) const
+{
+    if (!memo || !parent || !parent->getMemoizeFunctions() || type!=JKMathParser::functionNode || !functionNode) return false;
+    jkmpFunctionMemo& m=*memo;
+    const uint64_t generation=parent->environment.getFunctionGeneration();
+    if (!m.analysed || m.generation!=generation) {
+        // the function, or a function that it calls, may have been redefined
+        JKMathParser::jkmpTreeInfo info;
+        analyseTree(functionNode, info);
+        for (size_t i=0; i<parameterNames.size(); i++) {
+            info.readVariables.erase(parameterNames[i]);
+            info.assignedVariables.erase(parameterNames[i]);
+        }
+        m.invalidate();
+        m.analysed=true;
+        m.generation=generation;
+        m.statistics.pure=(!info.definesFunctions && !info.callsUnknownFunctions && !info.hasSideEffects && info.assignedVariables.empty());
+        m.globals.clear();
+        for (auto it=info.readVariables.begin(); it!=info.readVariables.end(); ++it) {
+            m.globals.push_back(internSymbol(*it));
+        }
+        m.globalValues.clear();
+    }
+    if (!m.statistics.pure) return false;
+
+    key.resize(parameters.size());
+    for (size_t i=0; i<parameters.size(); i++) {
+        if (!parameters[i].isValid || parameters[i].type!=jkmpDouble) return false;
+        memcpy(&key[i], &parameters[i].num, sizeof(double));
+    }
+    // the cached results are only valid for the current values of the global variables
+    std::vector<uint64_t> values(m.globals.size(), 0);
+    jkmpResult v;
+    for (size_t i=0; i<m.globals.size(); i++) {
+        if (!parent->environment.variableExists(m.globals[i])) return false;
+        parent->environment.getVariable(v, m.globals[i]);
+        if (!v.isValid || v.type!=jkmpDouble) return false;
+        memcpy(&values[i], &v.num, sizeof(double));
+    }
+    if (values!=m.globalValues) {
+        m.invalidate();
+        m.globalValues=values;
+    }
+    return true;
+}
+
+void JKMathParser::jkmpFunctionDescriptor::evaluateFunctionNode(jkmpResult &r, const JKMP::vector<jkmpResult> &parameters, JKMathParser *parent) const
+{
+    std::vector<uint64_t> key;
+    if (!getMemoKey(key, parameters, parent)) {
+        functionNode->evaluate(r);
+        return;
+    }
+    jkmpFunctionMemo& m=*memo;
+    auto it=m.cache.find(key);
+    if (it!=m.cache.end()) {
+        m.statistics.hits++;
+        r=it->second;
+        return;
+    }
+    m.statistics.misses++;
+    const int errorCount=parent->errors;
+    functionNode->evaluate(r);
+    // calls that report errors are evaluated again, so the errors are reported again
+    if (r.isValid && parent->errors==errorCount) {
+        // recursive calls may have filled the cache in the meantime
+        if (m.cache.size()>=parent->getMemoizationCacheSize()) m.invalidate();
+        if (parent->getMemoizationCacheSize()>0) m.cache[key]=r;
+    }
+}
+
+JKMathParser::jkmpFunctionMemoStatistics::jkmpFunctionMemoStatistics()
+{
+    hits=0;
+    misses=0;
+    invalidations=0;
+    entries=0;
+    pure=false;
+}
+
+JKMathParser::jkmpCacheStatistics::jkmpCacheStatistics()
+{
+    hits=0;
+    misses=0;
+    evictions=0;
+    entries=0;
+}
+
+JKMathParser::jkmpRegExpCache::jkmpRegExpCache(size_t capacity):
+    capacity(capacity)
+{
+}
+
+JKMathParser::jkmpCompiledRegExp JKMathParser::jkmpRegExpCache::get(const JKMP::string &pattern, bool caseSensitive, bool minimal)
+{
+    const Key key(pattern, (caseSensitive?1:0)|(minimal?2:0));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it=index.find(key);
+        if (it!=index.end()) {
+            statistics.hits++;
+            entries.splice(entries.begin(), entries, it->second);
+            return it->second->compiled;
+        }
+        statistics.misses++;
+    }
+    // compile without holding the lock, std::regex_error is passed on to the caller
+    std::regex::flag_type flags=std::regex::ECMAScript;
+    if (!caseSensitive) flags=flags|std::regex::icase;
+    jkmpCompiledRegExp rx;
+    rx.regExp=std::make_shared<const std::regex>(pattern, flags);
+    std::shared_ptr<JKMP::regExpAutomaton> automaton=std::make_shared<JKMP::regExpAutomaton>();
+    if (automaton->compile(pattern, caseSensitive)) rx.automaton=automaton;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (capacity==0) return rx;
+    auto it=index.find(key);
+    if (it!=index.end()) {
+        // another thread compiled the same pattern in the meantime
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->compiled;
+    }
+    Entry e;
+    e.key=key;
+    e.compiled=rx;
+    entries.push_front(e);
+    index[key]=entries.begin();
+    shrink();
+    return rx;
+}
+
+void JKMathParser::jkmpRegExpCache::setCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->capacity=capacity;
+    shrink();
+}
+
+size_t JKMathParser::jkmpRegExpCache::getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity;
+}
+
+JKMathParser::jkmpRegExpCacheStatistics JKMathParser::jkmpRegExpCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    jkmpRegExpCacheStatistics s=statistics;
+    s.entries=index.size();
+    return s;
+}
+
+void JKMathParser::jkmpRegExpCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    statistics=jkmpRegExpCacheStatistics();
+}
+
+void JKMathParser::jkmpRegExpCache::shrink()
+{
+    while (index.size()>capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+        statistics.evictions++;
+    }
+}
+
+JKMathParser::jkmpFFTPlanCache::jkmpFFTPlanCache(size_t capacity):
+    capacity(capacity)
+{
+}
+
+std::shared_ptr<const JKMP::fftPlan> JKMathParser::jkmpFFTPlanCache::get(size_t n)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it=index.find(n);
+        if (it!=index.end()) {
+            statistics.hits++;
+            entries.splice(entries.begin(), entries, it->second);
+            return *(it->second);
+        }
+        statistics.misses++;
+    }
+    // set up the plan without holding the lock
+    std::shared_ptr<const JKMP::fftPlan> plan=std::make_shared<const JKMP::fftPlan>(n);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (capacity==0) return plan;
+    auto it=index.find(n);
+    if (it!=index.end()) {
+        // another thread set up the same plan in the meantime
+        entries.splice(entries.begin(), entries, it->second);
+        return *(it->second);
+    }
+    entries.push_front(plan);
+    index[n]=entries.begin();
+    shrink();
+    return plan;
+}
+
+void JKMathParser::jkmpFFTPlanCache::setCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->capacity=capacity;
+    shrink();
+}
+
+size_t JKMathParser::jkmpFFTPlanCache::getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity;
+}
+
+JKMathParser::jkmpFFTPlanCacheStatistics JKMathParser::jkmpFFTPlanCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    jkmpFFTPlanCacheStatistics s=statistics;
+    s.entries=index.size();
+    return s;
+}
+
+void JKMathParser::jkmpFFTPlanCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    statistics=jkmpFFTPlanCacheStatistics();
+}
+
+void JKMathParser::jkmpFFTPlanCache::shrink()
+{
+    while (index.size()>capacity) {
+        index.erase(entries.back()->size());
+        entries.pop_back();
+        statistics.evictions++;
+    }
+}
+
+JKMathParser::jkmpFunctionMemo::jkmpFunctionMemo()
+{
+    analysed=false;
+    generation=0;
+}
+
+void JKMathParser::jkmpFunctionMemo::invalidate()
 {
-    JKMP::string res="";
-    if (type==JKMathParser::functionNode) res=JKMP::string("%1(%2): node").arg(name).arg(parameterNames.join(", "));
-    else if (type==JKMathParser::functionC) res=JKMP::string("%1(?): C function (copy-return)").arg(name);
-    else if (type==JKMathParser::functionCRefReturn) res=JKMP::string("%1(?): C function (return-by-reference)").arg(name);
-    else if (type==JKMathParser::functionFromNode) res=JKMP::string("%1(?): C function of nodes (return-by-reference)").arg(name);
-    else if (type==JKMathParser::functionInvalid) res=JKMP::string("%1(?): invalid function").arg(name);
-    return res;
+    if (!cache.empty()) {
+        cache.clear();
+        statistics.invalidations++;
+    }
 }
 
 
@@ -2895,6 +4499,7 @@ JKMathParser::executionEnvironment::executionEnvironment(JKMathParser *parent)
 {
     //qDebug()<<"executionEnvironment constructed parent="<<parent;
     currentLevel=0;
+    functionGeneration=1;
     this->parent=parent;
 }
 
@@ -2919,7 +4524,7 @@ void JKMathParser::executionEnvironment::clear()
 
 
 
-void JKMathParser::executionEnvironment::addVariable(const JKMP::string &name, const JKMathParser::jkmpVariable &variable)
+void JKMathParser::executionEnvironment::addVariable(jkmpSymbol name, const JKMathParser::jkmpVariable &variable)
 {
     //qDebug()<<"addVariable("<<name<<")";
     if (variables.contains(name) && variables[name].size()>0) {
@@ -2940,7 +4545,7 @@ void JKMathParser::executionEnvironment::addVariable(const JKMP::string &name, c
     //if (name=="x") //qDebug()<<"**ADDED_VARIABLE "<<currentLevel<<": var:"<<name<<"   levels="<<variables[name].size();
 }
 
-int JKMathParser::executionEnvironment::getVariableLevels(const JKMP::string &name) const
+int JKMathParser::executionEnvironment::getVariableLevels(jkmpSymbol name) const
 {
     if (variables.contains(name)) {
         return variables[name].size();
@@ -2949,7 +4554,7 @@ int JKMathParser::executionEnvironment::getVariableLevels(const JKMP::string &na
     }
 }
 
-void JKMathParser::executionEnvironment::setVariableDouble(const JKMP::string &name, double result)
+void JKMathParser::executionEnvironment::setVariableDouble(jkmpSymbol name, double result)
 {
     //qDebug()<<"executionEnvironment::setVariableDouble("<<name<<result<<")";
     jkmpResult r;
@@ -2957,35 +4562,35 @@ void JKMathParser::executionEnvironment::setVariableDouble(const JKMP::string &n
     setVariable(name, r);
 }
 
-void JKMathParser::executionEnvironment::setVariableDoubleVec(const JKMP::string &name, const JKMP::vector<double> &result)
+void JKMathParser::executionEnvironment::setVariableDoubleVec(jkmpSymbol name, const JKMP::vector<double> &result)
 {
     jkmpResult r;
     r.setDoubleVec(result);
     setVariable(name, r);
 }
 
-void JKMathParser::executionEnvironment::setVariableStringVec(const JKMP::string &name, const JKMP::stringVector &result)
+void JKMathParser::executionEnvironment::setVariableStringVec(jkmpSymbol name, const JKMP::stringVector &result)
 {
     jkmpResult r;
     r.setStringVec(result);
     setVariable(name, r);
 }
 
-void JKMathParser::executionEnvironment::setVariableBoolVec(const JKMP::string &name, const JKMP::vector<bool> &result)
+void JKMathParser::executionEnvironment::setVariableBoolVec(jkmpSymbol name, const JKMP::vector<bool> &result)
 {
     jkmpResult r;
     r.setBoolVec(result);
     setVariable(name, r);
 }
 
-void JKMathParser::executionEnvironment::setVariableString(const JKMP::string &name, const JKMP::string &result)
+void JKMathParser::executionEnvironment::setVariableString(jkmpSymbol name, const JKMP::string &result)
 {
     jkmpResult r;
     r.setString(result);
     setVariable(name, r);
 }
 
-void JKMathParser::executionEnvironment::setVariableBoolean(const JKMP::string &name, bool result)
+void JKMathParser::executionEnvironment::setVariableBoolean(jkmpSymbol name, bool result)
 {
     jkmpResult r;
     r.setBoolean(result);
@@ -2993,7 +4598,7 @@ void JKMathParser::executionEnvironment::setVariableBoolean(const JKMP::string &
 
 }
 
-void JKMathParser::executionEnvironment::addVariableDouble(const JKMP::string &name, double result)
+void JKMathParser::executionEnvironment::addVariableDouble(jkmpSymbol name, double result)
 {
     //qDebug()<<"executionEnvironment::addVariableDouble("<<name<<result<<")";
     jkmpResult r;
@@ -3002,42 +4607,42 @@ void JKMathParser::executionEnvironment::addVariableDouble(const JKMP::string &n
     addVariable(name, r);
 }
 
-void JKMathParser::executionEnvironment::addVariableDoubleVec(const JKMP::string &name, const JKMP::vector<double> &result)
+void JKMathParser::executionEnvironment::addVariableDoubleVec(jkmpSymbol name, const JKMP::vector<double> &result)
 {
     jkmpResult r;
     r.setDoubleVec(result);
     addVariable(name, r);
 }
 
-void JKMathParser::executionEnvironment::addVariableStringVec(const JKMP::string &name, const JKMP::stringVector &result)
+void JKMathParser::executionEnvironment::addVariableStringVec(jkmpSymbol name, const JKMP::stringVector &result)
 {
     jkmpResult r;
     r.setStringVec(result);
     addVariable(name, r);
 }
 
-void JKMathParser::executionEnvironment::addVariableBoolVec(const JKMP::string &name, const JKMP::vector<bool> &result)
+void JKMathParser::executionEnvironment::addVariableBoolVec(jkmpSymbol name, const JKMP::vector<bool> &result)
 {
     jkmpResult r;
     r.setBoolVec(result);
     addVariable(name, r);
 }
 
-void JKMathParser::executionEnvironment::addVariableString(const JKMP::string &name, const JKMP::string &result)
+void JKMathParser::executionEnvironment::addVariableString(jkmpSymbol name, const JKMP::string &result)
 {
     jkmpResult r;
     r.setString(result);
     addVariable(name, r);
 }
 
-void JKMathParser::executionEnvironment::addVariableBoolean(const JKMP::string &name, bool result)
+void JKMathParser::executionEnvironment::addVariableBoolean(jkmpSymbol name, bool result)
 {
     jkmpResult r;
     r.setBoolean(result);
     addVariable(name, r);
 }
 
-void JKMathParser::executionEnvironment::deleteVariable(const JKMP::string &name)
+void JKMathParser::executionEnvironment::deleteVariable(jkmpSymbol name)
 {
     if (variables.contains(name)) {
         for (size_t i=0; i<variables[name].size(); i++) {
@@ -3054,10 +4659,11 @@ JKMP::string JKMathParser::executionEnvironment::printVariables() const
 
     if (variables.size()>0) {
 
-        auto itV=variables.begin();
-        while (itV!=variables.end()) {
+        JKMP::vector<std::pair<JKMP::string, jkmpVariable> > vars=getVariables();
+        auto itV=vars.begin();
+        while (itV!=vars.end()) {
 
-            jkmpVariable v=itV->second.back().second;
+            jkmpVariable v=itV->second;
             res+="'"+itV->first+"'"+"\t\t";
             if (v.isInternal()) res+="intern"; else res+="extern";
             res+="\t"+v.toResult().toTypeString();
@@ -3077,10 +4683,11 @@ JKMP::string JKMathParser::executionEnvironment::printFunctions() const
     if (functions.size()>0) {
 
 
-        for (auto itV=functions.begin(); itV!=functions.end(); ++itV) {
+        JKMP::vector<std::pair<JKMP::string, jkmpFunctionDescriptor> > funcs=getFunctions();
+        for (auto itV=funcs.begin(); itV!=funcs.end(); ++itV) {
             if (res.size()>0) res+="\n";
 
-            res+=itV->second.back().second.toDefString();
+            res+=itV->second.toDefString();
 
         }
     }
@@ -3093,8 +4700,10 @@ JKMP::vector<std::pair<JKMP::string, JKMathParser::jkmpVariable> > JKMathParser:
 
     if (variables.size()>0) {
         for (auto itV=variables.begin(); itV!=variables.end(); ++itV) {
-            res.push_back(std::make_pair(itV->first, itV->second.back().second));
+            res.push_back(std::make_pair(symbolName(itV->first), itV->second.back().second));
         }
+        // the maps are ordered by symbol (i.e. order of first use), so sort by name to keep a stable, alphabetical listing
+        std::sort(res.begin(), res.end(), [](const std::pair<JKMP::string, JKMathParser::jkmpVariable>& a, const std::pair<JKMP::string, JKMathParser::jkmpVariable>& b) { return a.first<b.first; });
     }
     return res;
 }
@@ -3105,14 +4714,17 @@ JKMP::vector<std::pair<JKMP::string, JKMathParser::jkmpFunctionDescriptor> > JKM
 
     if (functions.size()>0) {
         for (auto itV=functions.begin(); itV!=functions.end(); ++itV) {
-            res.push_back(std::make_pair(itV->first, itV->second.back().second));
+            res.push_back(std::make_pair(symbolName(itV->first), itV->second.back().second));
         }
+        // the maps are ordered by symbol (i.e. order of first use), so sort by name to keep a stable, alphabetical listing
+        std::sort(res.begin(), res.end(), [](const std::pair<JKMP::string, JKMathParser::jkmpFunctionDescriptor>& a, const std::pair<JKMP::string, JKMathParser::jkmpFunctionDescriptor>& b) { return a.first<b.first; });
     }
     return res;
 }
 
-void JKMathParser::executionEnvironment::setFunction(const JKMP::string &name, const JKMathParser::jkmpFunctionDescriptor &function)
+void JKMathParser::executionEnvironment::setFunction(jkmpSymbol name, const JKMathParser::jkmpFunctionDescriptor &function)
 {
+    functionGeneration++;
     if (functions.contains(name) && functions[name].size()>0) {
         if (functions[name].back().first==currentLevel) {
             functions[name].back().second.clearMemory();
@@ -3130,13 +4742,14 @@ void JKMathParser::executionEnvironment::setFunction(const JKMP::string &name, c
     }
 }
 
-void JKMathParser::executionEnvironment::addFunction(const JKMP::string &name, const JKMP::stringVector &parameterNames, JKMathParser::jkmpNode *function)
+void JKMathParser::executionEnvironment::addFunction(jkmpSymbol name, const JKMP::stringVector &parameterNames, JKMathParser::jkmpNode *function)
 {
     JKMathParser::jkmpFunctionDescriptor fd;
     fd.type=functionNode;
     fd.parameterNames=parameterNames;
     fd.functionNode=function;
-    fd.name=name;
+    fd.name=symbolName(name);
+    fd.memo=std::make_shared<JKMathParser::jkmpFunctionMemo>();
     setFunction(name, fd);
 }
 
@@ -3147,7 +4760,7 @@ void JKMathParser::executionEnvironment::addFunction(const JKMP::string &name, c
 
 void JKMathParser::executionEnvironment::clearVariables()
 {
-    JKMP::stringVector keys=variables.keys();
+    JKMP::vector<jkmpSymbol> keys=variables.keys();
     for (size_t j=0; j<keys.size(); j++) {
         for (size_t i=0; i<variables[keys[j]].size(); i++) {
             variables[keys[j]].operator[](i).second.clearMemory();
@@ -3159,12 +4772,13 @@ void JKMathParser::executionEnvironment::clearVariables()
 
 void JKMathParser::executionEnvironment::clearFunctions()
 {
+    functionGeneration++;
     functions.clear();
 }
 
 JKMathParser::jkmpFunctionAssignNode::~jkmpFunctionAssignNode()
 {
-    if (child) delete child;
+    if (child) deleteTree(child);
 }
 
 JKMathParser::jkmpFunctionAssignNode::jkmpFunctionAssignNode(JKMP::string function, JKMP::stringVector parameterNames, JKMathParser::jkmpNode *c, JKMathParser *p, JKMathParser::jkmpNode *par):
@@ -3175,26 +4789,44 @@ JKMathParser::jkmpFunctionAssignNode::jkmpFunctionAssignNode(JKMP::string functi
     if (child) child->setParent(this);
     setParser(p);
     setParent(par);
-    this->function=function;
+    functionSymbol=internSymbol(function);
     this->parameterNames=parameterNames;
 }
 
 void JKMathParser::jkmpFunctionAssignNode::evaluate(jkmpResult &res)
 {
-    getParser()->addFunction(function, parameterNames, child->copy(NULL));
+    jkmpNode* body=NULL;
+    {
+        // the stored function body gets its own arena, as it may outlive the tree it was copied from
+        jkmpNodeArenaScope arenaScope;
+        body=child->copy(NULL);
+    }
+    getParser()->environment.addFunction(functionSymbol, parameterNames, body);
     res.setVoid();
 }
 
 JKMathParser::jkmpNode *JKMathParser::jkmpFunctionAssignNode::copy(JKMathParser::jkmpNode *par)
 {
-    if (child) return new JKMathParser::jkmpFunctionAssignNode(function, parameterNames, child->copy(NULL), getParser(), par);
-    else return new JKMathParser::jkmpFunctionAssignNode(function, parameterNames, NULL, getParser(), par);
+    if (child) return new JKMathParser::jkmpFunctionAssignNode(getName(), parameterNames, child->copy(NULL), getParser(), par);
+    else return new JKMathParser::jkmpFunctionAssignNode(getName(), parameterNames, NULL, getParser(), par);
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpFunctionAssignNode::specializeTypes()
+{
+    jkmpSpecializeChild(child, this);
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpFunctionAssignNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (child) slots.push_back(&child);
 }
 
 bool JKMathParser::jkmpFunctionAssignNode::createByteCode(JKMathParser::ByteCodeProgram &/*program*/, JKMathParser::ByteCodeEnvironment *environment)
 {
     if (child) {
-        environment->functionDefs[function]=std::make_pair(parameterNames, child);
+        environment->functionDefs[getName()]=std::make_pair(parameterNames, child);
         return true;
     }
     return false;
@@ -3202,14 +4834,14 @@ bool JKMathParser::jkmpFunctionAssignNode::createByteCode(JKMathParser::ByteCode
 
 JKMP::string JKMathParser::jkmpFunctionAssignNode::print() const
 {
-    if (child) return JKMP::string("%1( %2 ) = %3").arg(function).arg(parameterNames.join(", ")).arg(child->print());
-    else return JKMP::string("%1( %2 ) = %3").arg(function).arg(parameterNames.join(", ")).arg(JKMP::string());
+    if (child) return JKMP::string("%1( %2 ) = %3").arg(getName()).arg(parameterNames.join(", ")).arg(child->print());
+    else return JKMP::string("%1( %2 ) = %3").arg(getName()).arg(parameterNames.join(", ")).arg(JKMP::string());
 }
 
 JKMP::string JKMathParser::jkmpFunctionAssignNode::printTree(int level) const
 {
-    if (child) return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("FunctionAssigneNode '%2(%3)'\n%1").arg(child->printTree(level+1)).arg(function).arg(parameterNames.join(", "));
-    else return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("FunctionAssigneNode '%1(%2)'").arg(function).arg(parameterNames.join(", "));
+    if (child) return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("FunctionAssigneNode '%2(%3)'\n%1").arg(child->printTree(level+1)).arg(getName()).arg(parameterNames.join(", "));
+    else return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("FunctionAssigneNode '%1(%2)'").arg(getName()).arg(parameterNames.join(", "));
 }
 
 jkmpResult JKMathParser::jkmpConstantNode::evaluate()
@@ -3227,6 +4859,12 @@ JKMathParser::jkmpNode *JKMathParser::jkmpConstantNode::copy(JKMathParser::jkmpN
     return new JKMathParser::jkmpConstantNode(data, getParser(), par);
 }
 
+int JKMathParser::jkmpConstantNode::inferType()
+{
+    inferredType=data.type;
+    return inferredType;
+}
+
 bool JKMathParser::jkmpConstantNode::createByteCode(JKMathParser::ByteCodeProgram &program, ByteCodeEnvironment */*environment*/)
 {
     if (data.type==jkmpDouble) {
@@ -3234,7 +4872,7 @@ bool JKMathParser::jkmpConstantNode::createByteCode(JKMathParser::ByteCodeProgra
     } else if (data.type==jkmpBool) {
         program.push_back(JKMathParser::ByteCodeInstruction(bcPush, (data.boolean)?1.0:0.0));
     } else {
-        getParser()->jkmpError(JKMP::_("only numbers and booleans allowed in bytecoded expressions!"));
+        JKMATHPARSER_ERROR(getParser(), JKMP::_("only numbers and booleans allowed in bytecoded expressions!"));
         return false;
     }
     return true;
@@ -3295,7 +4933,7 @@ void JKMathParser::jkmpVectorMatrixConstructionList::evaluate(jkmpResult &res)
                 } else {
                     if (i!=nextSep) {
                         res.setInvalid();
-                        if (getParser()) getParser()->jkmpError(JKMP::_("error in matrix construct [Val1, Val2; Val3, ...]: the given rows do not have the same number of entries (%1 expected in row %2, but %3 found").arg(cols).arg(row).arg(thisrow));
+                        if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("error in matrix construct [Val1, Val2; Val3, ...]: the given rows do not have the same number of entries (%1 expected in row %2, but %3 found").arg(cols).arg(row).arg(thisrow));
                         return;
                     } else {
                         nextSep=nextSep+realitems+1;
@@ -3312,7 +4950,7 @@ void JKMathParser::jkmpVectorMatrixConstructionList::evaluate(jkmpResult &res)
         if (list.size()>0) {
             if (realitems!=rows*cols) {
                 res.setInvalid();
-                if (getParser()) getParser()->jkmpError(JKMP::_("error in matrix construct [Val1, Val2; Val3, ...]: wrong number of values given (%1 expected but %2 given): possibly too many or too few values in last row").arg(rows*cols).arg(realitems));
+                if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("error in matrix construct [Val1, Val2; Val3, ...]: wrong number of values given (%1 expected but %2 given): possibly too many or too few values in last row").arg(rows*cols).arg(realitems));
                 return;
             }
         }
@@ -3337,7 +4975,7 @@ void JKMathParser::jkmpVectorMatrixConstructionList::evaluate(jkmpResult &res)
                             res.numVec.push_back(r.num);
                         } else {
                             res.setInvalid();
-                            if (getParser()) getParser()->jkmpError(JKMP::_("error in matrix construct [Val1, Val2; Val3, ...]: item %1 has the wrong type (not number, but %2!)").arg(ri+1).arg(r.typeName()));
+                            if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("error in matrix construct [Val1, Val2; Val3, ...]: item %1 has the wrong type (not number, but %2!)").arg(ri+1).arg(r.typeName()));
                             break;
                         }
                     } else if (res.type==jkmpBoolMatrix) {
@@ -3345,7 +4983,7 @@ void JKMathParser::jkmpVectorMatrixConstructionList::evaluate(jkmpResult &res)
                             res.boolVec.push_back(r.boolean);
                         } else {
                             res.setInvalid();
-                            if (getParser()) getParser()->jkmpError(JKMP::_("error in matrix construct [Val1, Val2; Val3, ...]: item %1 has the wrong type (not boolean, but %2!)").arg(ri+1).arg(r.typeName()));
+                            if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("error in matrix construct [Val1, Val2; Val3, ...]: item %1 has the wrong type (not boolean, but %2!)").arg(ri+1).arg(r.typeName()));
                             break;
                         }
                     }
@@ -3372,7 +5010,7 @@ void JKMathParser::jkmpVectorMatrixConstructionList::evaluate(jkmpResult &res)
                         res.numVec<<r.numVec;
                     } else {
                         res.setInvalid();
-                        if (getParser()) getParser()->jkmpError(JKMP::_("error in vector construct [Val1, Val2, ...]: item %1 has the wrong type (not number or number vector, but %2!)").arg(i+1).arg(r.typeName()));
+                        if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("error in vector construct [Val1, Val2, ...]: item %1 has the wrong type (not number or number vector, but %2!)").arg(i+1).arg(r.typeName()));
                         break;
                     }
                 } else if (res.type==jkmpStringVector) {
@@ -3382,7 +5020,7 @@ void JKMathParser::jkmpVectorMatrixConstructionList::evaluate(jkmpResult &res)
                         res.strVec<<r.strVec;
                     } else {
                         res.setInvalid();
-                        if (getParser()) getParser()->jkmpError(JKMP::_("error in vector construct [Val1, Val2, ...]: item %1 has the wrong type (not string or string vector, but %2!)").arg(i+1).arg(r.typeName()));
+                        if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("error in vector construct [Val1, Val2, ...]: item %1 has the wrong type (not string or string vector, but %2!)").arg(i+1).arg(r.typeName()));
                         break;
                     }
                 } else if (res.type==jkmpBoolVector) {
@@ -3392,7 +5030,7 @@ void JKMathParser::jkmpVectorMatrixConstructionList::evaluate(jkmpResult &res)
                         res.boolVec<<r.boolVec;
                     } else {
                         res.setInvalid();
-                        if (getParser()) getParser()->jkmpError(JKMP::_("error in vector construct [Val1, Val2, ...]: item %1 has the wrong type (not boolean or boolean vector, but %2!)").arg(i+1).arg(r.typeName()));
+                        if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("error in vector construct [Val1, Val2, ...]: item %1 has the wrong type (not boolean or boolean vector, but %2!)").arg(i+1).arg(r.typeName()));
                         break;
                     }
                 }
@@ -3416,9 +5054,27 @@ JKMathParser::jkmpNode *JKMathParser::jkmpVectorMatrixConstructionList::copy(JKM
 
 }
 
+int JKMathParser::jkmpVectorMatrixConstructionList::inferType()
+{
+    inferredType=0;
+    if (isMatrix()) return inferredType;
+    for (size_t i=0; i<list.size(); i++) {
+        if (!list[i]) return inferredType;
+        const int t=list[i]->getInferredType();
+        if (t!=jkmpDouble && t!=jkmpDoubleVector) return inferredType;
+    }
+    inferredType=jkmpDoubleVector;
+    return inferredType;
+}
+
+void JKMathParser::jkmpVectorMatrixConstructionList::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    jkmpNode::createFlatProgram(program);
+}
+
 bool JKMathParser::jkmpVectorMatrixConstructionList::createByteCode(JKMathParser::ByteCodeProgram &/*program*/, JKMathParser::ByteCodeEnvironment */*environment*/)
 {
-    if (getParser()) getParser()->jkmpError(JKMP::_("no vector constructs in byte-code allowed"));
+    if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("no vector constructs in byte-code allowed"));
     return false;
 }
 
@@ -3454,6 +5110,28 @@ JKMathParser::jkmpNode *JKMathParser::jkmpVectorConstructionNode::copy(JKMathPar
     }
 }
 
+int JKMathParser::jkmpVectorConstructionNode::inferType()
+{
+    inferredType=jkmpDoubleVector;
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpVectorConstructionNode::specializeTypes()
+{
+    jkmpSpecializeChild(start, this);
+    jkmpSpecializeChild(end, this);
+    jkmpSpecializeChild(step, this);
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpVectorConstructionNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (start) slots.push_back(&start);
+    if (step) slots.push_back(&step);
+    if (end) slots.push_back(&end);
+}
+
 JKMP::string JKMathParser::jkmpVectorConstructionNode::print() const
 {
     if (step)  return JKMP::string("(%1):(%3):(%2)").arg(start->print()).arg(end->print()).arg(step->print());
@@ -3467,6 +5145,35 @@ JKMP::string JKMathParser::jkmpVectorConstructionNode::printTree(int level) cons
 
 }
 
+JKMathParser::jkmpRange::jkmpRange(double start, double delta, double end)
+{
+    this->start=start;
+    this->delta=delta;
+    this->end=end;
+}
+
+int64_t JKMathParser::jkmpRange::size() const
+{
+    if (isEmpty()) return 0;
+    const double n=floor((end-start)/delta);
+    // for integer start and delta all elements are exact, so the closed form gives the same count as the iteration
+    if (start==floor(start) && delta==floor(delta) && fabs(start)+fabs(n*delta)<4.0e15) {
+        return static_cast<int64_t>(n)+1;
+    }
+    int64_t cnt=0;
+    for (double t=start; inRange(t); t=t+delta) {
+        cnt++;
+    }
+    return cnt;
+}
+
+void JKMathParser::jkmpRange::toVector(JKMP::vector<double> &vec) const
+{
+    const int64_t n=size();
+    vec.resize(n);
+    if (n>0) generate(vec.data(), n, start);
+}
+
 JKMathParser::jkmpVectorConstructionNode::jkmpVectorConstructionNode(JKMathParser::jkmpNode *start, JKMathParser::jkmpNode *end, JKMathParser::jkmpNode *step, JKMathParser *p, JKMathParser::jkmpNode *par):
     jkmpNode(p, par)
 
@@ -3480,58 +5187,54 @@ JKMathParser::jkmpVectorConstructionNode::jkmpVectorConstructionNode(JKMathParse
 
 JKMathParser::jkmpVectorConstructionNode::~jkmpVectorConstructionNode()
 {
-    if (start) delete start;
-    if (step) delete step;
-    if (end) delete end;
+    if (start) deleteTree(start);
+    if (step) deleteTree(step);
+    if (end) deleteTree(end);
 }
 
 
 
 void JKMathParser::jkmpVectorConstructionNode::evaluate(jkmpResult &res)
 {
-    if (!start) {
-        if (getParser()) getParser()->jkmpError(JKMP::_("error in vector construct 'start[:delta]:end' INTERNAL ERROR: start does not exist"));
+    jkmpRange range;
+    if (!evaluateRange(range)) {
         res.setInvalid();
         return;
     }
+    res.setDoubleVec();
+    range.toVector(res.numVec);
+}
+
+bool JKMathParser::jkmpVectorConstructionNode::evaluateRange(JKMathParser::jkmpRange &range)
+{
+    if (!start) {
+        if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("error in vector construct 'start[:delta]:end' INTERNAL ERROR: start does not exist"));
+        return false;
+    }
     if (!end) {
-        if (getParser()) getParser()->jkmpError(JKMP::_("error in vector construct 'start[:delta]:end' INTERNAL ERROR: end does not exist"));
-        res.setInvalid();
-        return;
+        if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("error in vector construct 'start[:delta]:end' INTERNAL ERROR: end does not exist"));
+        return false;
     }
-     res.setDoubleVec();
      jkmpResult rstart;
      start->evaluate(rstart);
      jkmpResult rend;
      end->evaluate(rend);
      if (rstart.type!=jkmpDouble || rend.type!=jkmpDouble) {
-         if (getParser()) getParser()->jkmpError(JKMP::_("error in vector construct 'start[:delta]:end'' start, delta and end have to be numbers (start=%1, end=%2)").arg(rstart.toTypeString()).arg(rend.toTypeString()));
-         res.setInvalid();
-         return;
+         if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("error in vector construct 'start[:delta]:end'' start, delta and end have to be numbers (start=%1, end=%2)").arg(rstart.toTypeString()).arg(rend.toTypeString()));
+         return false;
      }
-     double s=rstart.num;
-     double e=rend.num;
      double d=1;
      if (step) {
          jkmpResult rstep;
          step->evaluate(rstep);
          if (rstep.type!=jkmpDouble) {
-             if (getParser()) getParser()->jkmpError(JKMP::_("error in vector construct 'start:delta:end'' delta has to be numbers (start=%1, step=%2, end=%3)").arg(rstart.toTypeString()).arg(rstep.toTypeString()).arg(rend.toTypeString()));
-             res.setInvalid();
-             return;
+             if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("error in vector construct 'start:delta:end'' delta has to be numbers (start=%1, step=%2, end=%3)").arg(rstart.toTypeString()).arg(rstep.toTypeString()).arg(rend.toTypeString()));
+             return false;
          }
          d=rstep.num;
      }
-     res.isValid=true;
-     if (d>0) {
-         for (double t=s; t<=e; t=t+d) {
-             res.numVec<<t;
-         }
-     } else if (d<0) {
-         for (double t=s; t>=e; t=t+d) {
-             res.numVec<<t;
-         }
-     }
+     range=jkmpRange(rstart.num, d, rend.num);
+     return true;
 }
 
 JKMathParser::jkmpCasesNode::jkmpCasesNode(JKMathParser *p, JKMathParser::jkmpNode *par):
@@ -3545,10 +5248,10 @@ JKMathParser::jkmpCasesNode::jkmpCasesNode(JKMathParser *p, JKMathParser::jkmpNo
 
 JKMathParser::jkmpCasesNode::~jkmpCasesNode()
 {
-    if (elseNode) delete elseNode;
+    if (elseNode) deleteTree(elseNode);
     for (size_t i=0; i<casesNodes.size(); i++) {
-        if (casesNodes[i].first) delete casesNodes[i].first;
-        if (casesNodes[i].second) delete casesNodes[i].second;
+        if (casesNodes[i].first) deleteTree(casesNodes[i].first);
+        if (casesNodes[i].second) deleteTree(casesNodes[i].second);
     }
     casesNodes.clear();
 }
@@ -3577,7 +5280,7 @@ void JKMathParser::jkmpCasesNode::evaluate(jkmpResult &r)
                 return;
             }
         } else {
-            if (getParser()) getParser()->jkmpError(JKMP::_("decision statement %1 does not have type boolean").arg(i+1));
+            if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("decision statement %1 does not have type boolean").arg(i+1));
             r.setInvalid();
             return;
         }
@@ -3599,6 +5302,68 @@ JKMathParser::jkmpNode *JKMathParser::jkmpCasesNode::copy(JKMathParser::jkmpNode
     return res;
 }
 
+int JKMathParser::jkmpCasesNode::inferType()
+{
+    inferredType=0;
+    if (!elseNode) return inferredType;
+    const int t=elseNode->getInferredType();
+    for (size_t i=0; i<casesNodes.size(); i++) {
+        if (!casesNodes[i].second || casesNodes[i].second->getInferredType()!=t) return inferredType;
+    }
+    inferredType=t;
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpCasesNode::specializeTypes()
+{
+    for (size_t i=0; i<casesNodes.size(); i++) {
+        jkmpSpecializeChild(casesNodes[i].first, this);
+        jkmpSpecializeChild(casesNodes[i].second, this);
+    }
+    jkmpSpecializeChild(elseNode, this);
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpCasesNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    for (size_t i=0; i<casesNodes.size(); i++) {
+        if (casesNodes[i].first) slots.push_back(&casesNodes[i].first);
+        if (casesNodes[i].second) slots.push_back(&casesNodes[i].second);
+    }
+    if (elseNode) slots.push_back(&elseNode);
+}
+
+void JKMathParser::jkmpCasesNode::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    for (size_t i=0; i<casesNodes.size(); i++) {
+        if (!casesNodes[i].first || !casesNodes[i].second) {
+            jkmpNode::createFlatProgram(program);
+            return;
+        }
+    }
+    JKMP::vector<int> decisions, jumpsToEnd;
+    for (size_t i=0; i<casesNodes.size(); i++) {
+        casesNodes[i].first->createFlatProgram(program);
+        JKMathParser::FlatInstruction inst(JKMathParser::flatJumpIfNot, this);
+        inst.strpar=JKMP::_("decision statement %1 does not have type boolean").arg(i+1);
+        decisions.push_back(program.add(inst, -1));
+        casesNodes[i].second->createFlatProgram(program);
+        // the code of the next case starts without the value of this case on the stack
+        jumpsToEnd.push_back(program.add(JKMathParser::FlatInstruction(JKMathParser::flatJump), -1));
+        program.instructions[decisions.back()].intpar=program.nextIndex();
+    }
+    if (elseNode) elseNode->createFlatProgram(program);
+    else program.add(JKMathParser::FlatInstruction(JKMathParser::flatPushInvalid), 1);
+    const int end=program.nextIndex();
+    for (size_t i=0; i<jumpsToEnd.size(); i++) {
+        program.instructions[jumpsToEnd[i]].intpar=end;
+    }
+    for (size_t i=0; i<decisions.size(); i++) {
+        program.instructions[decisions[i]].intpar2=end;
+    }
+}
+
 bool JKMathParser::jkmpCasesNode::createByteCode(JKMathParser::ByteCodeProgram &program, JKMathParser::ByteCodeEnvironment *environment)
 {
     /*
@@ -3688,58 +5453,124 @@ JKMathParser::jkmpVectorOperationNode::jkmpVectorOperationNode(const JKMP::strin
 
 {
     this->operationName=operationName.toLower();
-    this->variableName=variableName;
+    variableSymbol=internSymbol(variableName);
     this->expression=expression;
     this->items=items;
     this->start=NULL;
     this->end=NULL;
     this->delta=NULL;
     this->defaultValue=defaultValue;
+    loopInvariantsValid=false;
+    loopInvariantsGeneration=0;
+    vectorizedExpression=NULL;
+    vectorizedValid=false;
+    vectorizedGeneration=0;
+    activeEvaluations=0;
 }
 
 JKMathParser::jkmpVectorOperationNode::jkmpVectorOperationNode(const JKMP::string &operationName, const JKMP::string &variableName, JKMathParser::jkmpNode *start, JKMathParser::jkmpNode *end, JKMathParser::jkmpNode *delta, JKMathParser::jkmpNode *expression, JKMathParser *p, JKMathParser::jkmpNode *par, JKMathParser::jkmpNode *defaultValue):
     jkmpNode(p, par)
 {
     this->operationName=operationName.toLower();
-    this->variableName=variableName;
+    variableSymbol=internSymbol(variableName);
     this->expression=expression;
     this->defaultValue=defaultValue;
     this->items=NULL;
     this->start=start;
     this->end=end;
     this->delta=delta;
+    loopInvariantsValid=false;
+    loopInvariantsGeneration=0;
+    vectorizedExpression=NULL;
+    vectorizedValid=false;
+    vectorizedGeneration=0;
+    activeEvaluations=0;
 }
 
 JKMathParser::jkmpVectorOperationNode::~jkmpVectorOperationNode()
 {
-    if (defaultValue) delete defaultValue;
-    if (expression) delete expression;
-    if (items) delete items;
-    if (start) delete start;
-    if (end) delete end;
-    if (delta) delete delta;
+    if (defaultValue) deleteTree(defaultValue);
+    if (expression) deleteTree(expression);
+    if (items) deleteTree(items);
+    if (start) deleteTree(start);
+    if (end) deleteTree(end);
+    if (delta) deleteTree(delta);
+    if (vectorizedExpression) deleteTree(vectorizedExpression);
 }
 
 
+class JKMathParser::jkmpVectorOperationNode::jkmpLoopActivation {
+    public:
+        explicit jkmpLoopActivation(jkmpVectorOperationNode* loop): loop(loop) {
+            loop->activeEvaluations++;
+            if (loop->activeEvaluations>1) {
+                save(loop->loopInvariants, savedInvariants);
+                save(loop->vectorizedOperands, savedOperands);
+            }
+            for (size_t i=0; i<loop->loopInvariants.size(); i++) {
+                loop->loopInvariants[i]->invalidate();
+            }
+        }
+        ~jkmpLoopActivation() {
+            if (loop->activeEvaluations>1) {
+                restore(loop->loopInvariants, savedInvariants);
+                restore(loop->vectorizedOperands, savedOperands);
+            }
+            loop->activeEvaluations--;
+        }
+    private:
+        typedef JKMP::vector<std::pair<jkmpResult, bool> > CacheVector;
+        static void save(const JKMP::vector<jkmpLoopInvariantNode*>& nodes, CacheVector& saved) {
+            saved.resize(nodes.size());
+            for (size_t i=0; i<nodes.size(); i++) {
+                nodes[i]->saveCache(saved[i].first, saved[i].second);
+            }
+        }
+        static void restore(const JKMP::vector<jkmpLoopInvariantNode*>& nodes, const CacheVector& saved) {
+            // nodes, which were created by the nested evaluation, were not used by the outer one
+            for (size_t i=0; i<nodes.size(); i++) {
+                if (i<saved.size()) nodes[i]->restoreCache(saved[i].first, saved[i].second);
+                else nodes[i]->invalidate();
+            }
+        }
+        jkmpVectorOperationNode* loop;
+        CacheVector savedInvariants;
+        CacheVector savedOperands;
+};
+
 void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
 {
      r.isValid=false;
+     // loop-invariant subexpressions of the body are evaluated at most once per evaluation of the loop
+     jkmpLoopActivation activation(this);
+     hoistLoopInvariants();
      JKMP::stringVector strVec, itemValsS;
      JKMP::vector<bool> boolVec, itemValsB;
      JKMP::vector<double> numVec, itemVals;
-     JKMP::vector<jkmpResult> itemList, itemListO;
+     JKMP::sharedvector<jkmpResult> itemList;
+     JKMP::vector<jkmpResult> itemListO;
      jkmpResultType resType=jkmpDouble;
      bool evalItems=true;
      bool ok=false;
      bool isString=false;
      bool isBool=false;
      bool isList=false;
+     // start:delta:end (also as ITEMS) is iterated as a jkmpRange, without materialising it into itemVals
+     bool isRange=false;
+     jkmpRange range;
 
-     int cnt=0;
+     int64_t cnt=0;
      if (!ok) {
          if (items) {
              jkmpResult ri;
-             if (evalItems) {
+             jkmpVectorConstructionNode* rangeItems=dynamic_cast<jkmpVectorConstructionNode*>(items);
+             if (rangeItems) {
+                 if (!rangeItems->evaluateRange(range)) {
+                     r.setInvalid();
+                     return;
+                 }
+                 isRange=true;
+             } else if (evalItems) {
                  items->evaluate(ri);
                  if (ri.type==jkmpDouble) {itemVals<<ri.num; cnt=itemVals.size(); }
                  else if (ri.type==jkmpDoubleVector) {itemVals=ri.numVec; cnt=itemVals.size(); }
@@ -3749,7 +5580,7 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
                  else if (ri.type==jkmpBoolVector) {itemValsB=ri.boolVec; isBool=true; cnt=itemValsB.size();}
                  else if (ri.type==jkmpList) {itemList=ri.listData; isList=true; cnt=itemList.size();}
                  else {
-                     if (getParser()) getParser()->jkmpError(JKMP::_("%1(NAME, ITEMS, EXPRESSION) expects a list of numbers, booleans or strings as ITEMS").arg(operationName));
+                     if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("%1(NAME, ITEMS, EXPRESSION) expects a list of numbers, booleans or strings as ITEMS").arg(operationName));
                      r.setInvalid();
                      return;
                  }
@@ -3762,12 +5593,12 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
              double s=rs.num;
              double e=re.num;
              if (rs.type!=jkmpDouble) {
-                 if (getParser()) getParser()->jkmpError(JKMP::_("%1(NAME, START, DELTA, END, EXPRESSION) expects a number for START").arg(operationName));
+                 if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("%1(NAME, START, DELTA, END, EXPRESSION) expects a number for START").arg(operationName));
                  r.setInvalid();
                  return;
              }
              if (re.type!=jkmpDouble) {
-                 if (getParser()) getParser()->jkmpError(JKMP::_("%1(NAME, START, DELTA, END, EXPRESSION) expects a number for END").arg(operationName));
+                 if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("%1(NAME, START, DELTA, END, EXPRESSION) expects a number for END").arg(operationName));
                  r.setInvalid();
                  return;
              }
@@ -3778,26 +5609,18 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
                  if (rd.type==jkmpDouble) {
                      d=rd.num;
                  } else {
-                     if (getParser()) getParser()->jkmpError(JKMP::_("%1(NAME, START, DELTA, END, EXPRESSION) expects a number for DELTA").arg(operationName));
+                     if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("%1(NAME, START, DELTA, END, EXPRESSION) expects a number for DELTA").arg(operationName));
                      r.setInvalid();
                      return;
                  }
 
              }
              //qDebug()<<"for: t="<<s<<"; t<="<<e<<"; t=t+"<<d;
-             if (d>0) {
-                 for (double t=s; t<=e; t=t+d) {
-                     itemVals<<t;
-                 }
-             } else if (d<0) {
-                 for (double t=s; t>=e; t=t+d) {
-                     itemVals<<t;
-                 }
-             }
-             cnt=itemVals.size();
+             range=jkmpRange(s, d, e);
+             isRange=true;
          }
-         if (cnt<=0) {
-             if (operationName=="for"||operationName=="savefor") {
+         if ((isRange && range.isEmpty()) || (!isRange && cnt<=0)) {
+             if (operationName=="for"||operationName=="savefor"||operationName=="cumsum"||operationName=="cumprod") {
                  r.setDoubleVec(JKMP::vector<double>());
                  return;
              } else if (operationName=="defaultfor") {
@@ -3812,20 +5635,42 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
                  return;
              }
          }
+         // loops over numbers with an element-wise body are evaluated as whole-vector operations
+         if (!isBool && !isString && !isList && evaluateVectorized(r, isRange, range, itemVals)) {
+             return;
+         }
          jkmpResult defr;
 
-         getParser()->enterBlock();
+         // in loops over numbers, the loop variable is bound once to loopValue, instead of redefining it in every iteration
+         double loopValue=0;
+         jkmpBlockScope block(getParser());
+         const bool loopVariableBound=(!isBool && !isString && !isList && canBindLoopVariable());
+         if (loopVariableBound) {
+             getParser()->environment.addVariable(variableSymbol, JKMathParser::jkmpVariable(&loopValue));
+             if ((operationName=="sum" || operationName=="prod" || operationName=="for" || operationName=="savefor") && evaluateByteCodeLoop(r, loopValue, isRange, range, itemVals)) {
+                 return;
+             }
+         }
          jkmpResult thisr;
          bool isFilterFor=((operationName=="filterfor") || (operationName=="savefilterfor"));
-         for (int i=0; i<cnt; i++) {
+         // sum and prod of numbers are accumulated directly, so they don't store the results of all iterations
+         const bool isSum=(operationName=="sum");
+         const bool isProd=(operationName=="prod");
+         double sumValue=0;
+         double prodValue=1;
+         double t=range.start;
+         for (int64_t i=0; isRange?range.inRange(t):(i<cnt); i++, t=t+range.delta) {
+             double item=0;
              if (isBool) {
-                 getParser()->addVariable(variableName, jkmpResult(itemValsB[i]));
+                 getParser()->environment.addVariable(variableSymbol, jkmpResult(itemValsB[i]));
              } else if (isString) {
-                 getParser()->addVariable(variableName, jkmpResult(itemValsS[i]));
+                 getParser()->environment.addVariable(variableSymbol, jkmpResult(itemValsS[i]));
              } else if (isList) {
-                 getParser()->addVariable(variableName, jkmpResult(itemList[i]));
+                 getParser()->environment.addVariable(variableSymbol, jkmpResult(itemList[i]));
              } else {
-                 getParser()->addVariable(variableName, jkmpResult(itemVals[i]));
+                 item=isRange?t:itemVals[i];
+                 if (loopVariableBound) loopValue=item;
+                 else getParser()->environment.addVariable(variableSymbol, jkmpResult(item));
              }
              expression->evaluate(thisr);
              if (isFilterFor) {
@@ -3852,12 +5697,12 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
                          } else if (isList) {
                              itemListO.push_back(itemList[i]);
                          } else {
-                             numVec.push_back(itemVals[i]);
+                             numVec.push_back(item);
                          }
                      }
                  } else {
                      if (operationName!="savefilterfor" && operationName!="savefor") {
-                         if (getParser()) getParser()->jkmpError(JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION) has to evaluate to a boolean, but found %2 in iteration %3").arg(operationName).arg(resultTypeToString(thisr.type)).arg(i+1));
+                         if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION) has to evaluate to a boolean, but found %2 in iteration %3").arg(operationName).arg(resultTypeToString(thisr.type)).arg(i+1));
                          r.setInvalid();
                      }
                      return;
@@ -3886,6 +5731,9 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
                              }
                              break;
                      }
+                     // pre-size the output, if every iteration yields one item
+                     if (thisr.type==jkmpDouble && !isSum && !isProd) numVec.reserve(isRange?range.size():cnt);
+                     else if (thisr.type==jkmpBool) boolVec.reserve(isRange?range.size():cnt);
 
                      //resType=thisr.type;
                  } else if (!isList && ((resType==jkmpBoolVector && thisr.type!=jkmpBool && thisr.type!=jkmpBoolVector)
@@ -3895,7 +5743,7 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
                          defr.setInvalid();
                          if (defaultValue) defaultValue->evaluate(defr);
                          if (!defr.isValid) {
-                             if (getParser()) getParser()->jkmpError(JKMP::_("DEFAULT in %1(NAME, ..., EXPRESSION, DEFAULT) evaluated to invalid!").arg(operationName));
+                             if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("DEFAULT in %1(NAME, ..., EXPRESSION, DEFAULT) evaluated to invalid!").arg(operationName));
                              r.setInvalid();
                              return;
                          }
@@ -3904,13 +5752,13 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
                                                      || (resType==jkmpDoubleVector && (defr.type==jkmpDouble || defr.type==jkmpDoubleVector))) {
                              thisr=defr;
                          } else {
-                             if (getParser()) getParser()->jkmpError(JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION, DEFAULT): DEFAULT has to evaluate to a compatible type in every iteration: expected compaitble with %3 (single/vector), but found %2 in iteration %4").arg(operationName).arg(defr.toTypeString()).arg(resultTypeToString(resType)).arg(i+1));
+                             if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION, DEFAULT): DEFAULT has to evaluate to a compatible type in every iteration: expected compaitble with %3 (single/vector), but found %2 in iteration %4").arg(operationName).arg(defr.toTypeString()).arg(resultTypeToString(resType)).arg(i+1));
                              r.setInvalid();
                              return;
                          }
                      } else {
                          if (operationName!="savefor") {
-                             if (getParser()) getParser()->jkmpError(JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION) has to evaluate to a compatible type in every iteration: expected compaitble with %3 (single/vector), but found %2 in iteration %4").arg(operationName).arg(defr.toTypeString()).arg(resultTypeToString(resType)).arg(i+1));
+                             if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION) has to evaluate to a compatible type in every iteration: expected compaitble with %3 (single/vector), but found %2 in iteration %4").arg(operationName).arg(defr.toTypeString()).arg(resultTypeToString(resType)).arg(i+1));
                              r.setInvalid();
                              return;
                          }
@@ -3922,15 +5770,24 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
 
                      switch(resType) {
                          case jkmpDoubleVector:
-                             if (thisr.type==jkmpDouble) numVec<<thisr.num;
-                             else if (thisr.type==jkmpDoubleVector) numVec<<thisr.numVec;
+                             // sum(...) and prod(...) skip non-finite values
+                             if (isSum) {
+                                 if (thisr.type==jkmpDouble) { if (JKMP_FloatIsOK(thisr.num)) sumValue+=thisr.num; }
+                                 else if (thisr.type==jkmpDoubleVector) for (size_t j=0; j<thisr.numVec.size(); j++) { if (JKMP_FloatIsOK(thisr.numVec[j])) sumValue+=thisr.numVec[j]; }
+                             } else if (isProd) {
+                                 if (thisr.type==jkmpDouble) { if (JKMP_FloatIsOK(thisr.num)) prodValue*=thisr.num; }
+                                 else if (thisr.type==jkmpDoubleVector) for (size_t j=0; j<thisr.numVec.size(); j++) { if (JKMP_FloatIsOK(thisr.numVec[j])) prodValue*=thisr.numVec[j]; }
+                             } else {
+                                 if (thisr.type==jkmpDouble) numVec<<thisr.num;
+                                 else if (thisr.type==jkmpDoubleVector) numVec<<thisr.numVec;
+                             }
                              break;
                          case jkmpStringVector:
                              if (operationName=="sum" || operationName=="for" || operationName=="savefor" || operationName=="defaultfor") {
                                  if (thisr.type==jkmpString) strVec<<thisr.str;
                                  else if (thisr.type==jkmpStringVector) strVec<<thisr.strVec;
                              } else  if (operationName!="savefor")  {
-                                 if (getParser()) getParser()->jkmpError(JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION) has to evaluate to number: but found %2 in iteration %3").arg(operationName).arg(resultTypeToString(resType)).arg(i+1));
+                                 if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION) has to evaluate to number: but found %2 in iteration %3").arg(operationName).arg(resultTypeToString(resType)).arg(i+1));
                                  r.setInvalid();
                                  return;
                              }
@@ -3940,14 +5797,14 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
                                  if (thisr.type==jkmpBool) boolVec<<thisr.boolean;
                                  else if (thisr.type==jkmpBoolVector) boolVec<<thisr.boolVec;
                              } else  if (operationName!="savefor")  {
-                                 if (getParser()) getParser()->jkmpError(JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION) has to evaluate to number: but found %2 in iteration %3").arg(operationName).arg(resultTypeToString(resType)).arg(i+1));
+                                 if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION) has to evaluate to number: but found %2 in iteration %3").arg(operationName).arg(resultTypeToString(resType)).arg(i+1));
                                  r.setInvalid();
                                  return;
                              }
                              break;
                          default:
                              if (operationName!="savefor") {
-                                 if (getParser()) getParser()->jkmpError(JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION) has to evaluate to string or number: but found %2 in iteration %3").arg(operationName).arg(resultTypeToString(resType)).arg(i+1));
+                                 if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("EXPRESSION in %1(NAME, ..., EXPRESSION) has to evaluate to string or number: but found %2 in iteration %3").arg(operationName).arg(resultTypeToString(resType)).arg(i+1));
                                  r.setInvalid();
                              }
                              return;
@@ -3955,8 +5812,6 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
                  }
              }
          }
-         getParser()->leaveBlock();
-
          r.isValid=true;
          if (operationName=="for"||operationName=="savefor"||operationName=="filterfor"||operationName=="savefilterfor"||operationName=="defaultfor") {
              if (isList) {
@@ -3970,17 +5825,353 @@ void JKMathParser::jkmpVectorOperationNode::evaluate(jkmpResult &r)
                  } else r.setInvalid();
              }
 
-         } else if (operationName=="sum") {
-             if (resType==jkmpDoubleVector) r.setDouble(statisticsSum(numVec.data(), numVec.size()));
+         } else if (isSum) {
+             if (resType==jkmpDoubleVector) r.setDouble(sumValue);
              else if (resType==jkmpStringVector) r.setString(strVec.join(""));
              else r.setInvalid();
-         } else if (operationName=="prod") {
-             if (resType==jkmpDoubleVector) r.setDouble(statisticsProd(numVec.data(), numVec.size()));
+         } else if (isProd) {
+             if (resType==jkmpDoubleVector) r.setDouble(prodValue);
              else r.setInvalid();
+         } else if (operationName=="cumsum" || operationName=="cumprod") {
+             if (resType==jkmpDoubleVector) {
+                 for (size_t i=1; i<numVec.size(); i++) {
+                     if (operationName=="cumsum") numVec[i]=numVec[i-1]+numVec[i];
+                     else numVec[i]=numVec[i-1]*numVec[i];
+                 }
+                 r.setDoubleVec(numVec);
+             } else {
+                 r.setInvalid();
+             }
          }
      }
 }
 
+bool JKMathParser::jkmpVectorOperationNode::canBindLoopVariable()
+{
+    if (!expression) return false;
+    JKMathParser::jkmpTreeInfo info;
+    analyseTree(expression, info);
+    return !info.callsUnknownFunctions && info.assignedVariables.find(getVariableName())==info.assignedVariables.end();
+}
+
+void JKMathParser::jkmpVectorOperationNode::hoistLoopInvariants()
+{
+    JKMathParser* p=getParser();
+    if (!p || !expression) return;
+    const uint64_t generation=p->environment.getFunctionGeneration();
+    if (loopInvariantsValid && loopInvariantsGeneration==generation) return;
+    loopInvariantsValid=true;
+    loopInvariantsGeneration=generation;
+    for (size_t i=0; i<loopInvariants.size(); i++) {
+        loopInvariants[i]->setEnabled(false);
+    }
+    JKMathParser::jkmpTreeInfo info;
+    analyseTree(expression, info);
+    // functions that are defined in the body may change the meaning of any call between iterations
+    if (info.definesFunctions) return;
+    std::set<JKMP::string> variant=info.assignedVariables;
+    variant.insert(getVariableName());
+    hoistLoopInvariants(&expression, variant);
+}
+
+void JKMathParser::jkmpVectorOperationNode::hoistLoopInvariants(JKMathParser::jkmpNode **slot, const std::set<JKMP::string> &variant)
+{
+    jkmpNode* node=*slot;
+    if (!node) return;
+    // nodes of other loops are treated like any other node (and may be wrapped again)
+    jkmpLoopInvariantNode* own=dynamic_cast<jkmpLoopInvariantNode*>(node);
+    if (own && own->getOwner()!=this) own=NULL;
+    jkmpNode* target=own?own->getChild():node;
+    if (jkmpIsLoopInvariant(target, variant)) {
+        if (own) {
+            own->setEnabled(true);
+        } else {
+            jkmpLoopInvariantNode* inv=new jkmpLoopInvariantNode(node, this, getParser(), node->getParent());
+            *slot=inv;
+            loopInvariants.push_back(inv);
+        }
+        return;
+    }
+    // the operands of fused vector expressions are not evaluated through their slots and bodies of function definitions are not evaluated here
+    if (dynamic_cast<jkmpFusedVectorNode*>(target) || dynamic_cast<jkmpFunctionAssignNode*>(target)) return;
+    JKMP::vector<jkmpNode**> slots;
+    target->getChildSlots(slots);
+    jkmpVectorOperationNode* loop=dynamic_cast<jkmpVectorOperationNode*>(target);
+    for (size_t i=0; i<slots.size(); i++) {
+        if (loop && *slots[i]==loop->getExpression()) {
+            // the loop variable of a nested loop changes between its iterations
+            std::set<JKMP::string> nestedVariant=variant;
+            nestedVariant.insert(loop->getVariableName());
+            hoistLoopInvariants(slots[i], nestedVariant);
+        } else {
+            hoistLoopInvariants(slots[i], variant);
+        }
+    }
+}
+
+bool JKMathParser::jkmpVectorOperationNode::createLoopInvariantsByteCode(JKMathParser::ByteCodeProgram &program, JKMathParser::ByteCodeEnvironment *environment, JKMP::stringVector &names)
+{
+    bool ok=true;
+    for (size_t i=0; ok && i<loopInvariants.size(); i++) {
+        jkmpLoopInvariantNode* inv=loopInvariants[i];
+        if (inv->isEnabled()) {
+            ok=inv->getChild()->createByteCode(program, environment);
+            const JKMP::string name=JKMP::string("__%1__invariant%2").arg(operationName).arg(i);
+            const int slot=environment->pushVar(name);
+            names<<name;
+            program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcHeapWrite, slot));
+            inv->setByteCodeSlot(slot);
+        }
+    }
+    return ok;
+}
+
+void JKMathParser::jkmpVectorOperationNode::releaseLoopInvariantsByteCode(JKMathParser::ByteCodeEnvironment *environment, const JKMP::stringVector &names)
+{
+    for (size_t i=0; i<loopInvariants.size(); i++) {
+        loopInvariants[i]->setByteCodeSlot(-1);
+    }
+    for (int i=int(names.size())-1; i>=0; i--) {
+        environment->popVar(names[i]);
+    }
+}
+
+
+void JKMathParser::jkmpVectorOperationNode::prepareVectorizedExpression()
+{
+    JKMathParser* p=getParser();
+    if (!p || !expression) return;
+    const uint64_t generation=p->environment.getFunctionGeneration();
+    // a running outer evaluation of the loop still uses vectorizedExpression, so it is not replaced in a nested evaluation
+    if (vectorizedValid && (vectorizedGeneration==generation || activeEvaluations>1)) return;
+    vectorizedValid=true;
+    vectorizedGeneration=generation;
+    if (vectorizedExpression) delete vectorizedExpression;
+    vectorizedExpression=NULL;
+    vectorizedOperands.clear();
+    if (operationName!="for" && operationName!="savefor" && operationName!="sum" && operationName!="prod" && operationName!="cumsum" && operationName!="cumprod") return;
+    JKMathParser::jkmpTreeInfo info;
+    analyseTree(expression, info);
+    if (info.definesFunctions || info.callsUnknownFunctions || info.hasSideEffects || !info.assignedVariables.empty()) return;
+
+    // the rewritten body is a copy, so the body itself is still evaluated iteration by iteration, if the operands are not numbers at runtime
+    jkmpNode* body=expression->copy(NULL);
+    bool usesLoopVariable=false;
+    if (!body->isElementwiseOperation() || dynamic_cast<jkmpCompareNode*>(body) || !wrapVectorizedOperands(&body, usesLoopVariable) || !usesLoopVariable) {
+        delete body;
+        vectorizedOperands.clear();
+        return;
+    }
+    vectorizedExpression=new jkmpFusedVectorNode(body, p, this);
+}
+
+bool JKMathParser::jkmpVectorOperationNode::wrapVectorizedOperands(JKMathParser::jkmpNode **slot, bool &usesLoopVariable)
+{
+    jkmpNode* node=*slot;
+    if (!node) return false;
+    // comparisons yield booleans, so they are only element-wise as the root of a fused expression
+    if (node->isElementwiseOperation() && !dynamic_cast<jkmpCompareNode*>(node)) {
+        JKMP::vector<jkmpNode**> slots;
+        node->getChildSlots(slots);
+        for (size_t i=0; i<slots.size(); i++) {
+            if (!wrapVectorizedOperands(slots[i], usesLoopVariable)) return false;
+        }
+        return true;
+    }
+    jkmpVariableNode* var=dynamic_cast<jkmpVariableNode*>(node);
+    if (var && var->getSymbol()==variableSymbol) {
+        usesLoopVariable=true;
+        return true;
+    }
+    std::set<JKMP::string> variant;
+    variant.insert(getVariableName());
+    if (!var && !dynamic_cast<jkmpConstantNode*>(node) && !jkmpIsLoopInvariant(node, variant)) return false;
+    jkmpLoopInvariantNode* inv=new jkmpLoopInvariantNode(node, this, getParser(), node->getParent());
+    *slot=inv;
+    vectorizedOperands.push_back(inv);
+    return true;
+}
+
+bool JKMathParser::jkmpVectorOperationNode::evaluateVectorized(jkmpResult &r, bool isRange, const JKMathParser::jkmpRange &range, const JKMP::vector<double> &itemVals)
+{
+    JKMathParser* p=getParser();
+    const bool isSum=(operationName=="sum");
+    const bool isProd=(operationName=="prod");
+    const bool isCumSum=(operationName=="cumsum");
+    const bool isCumProd=(operationName=="cumprod");
+    // the parallel loop engine is used for the operations it supports
+    if (p->getParallelLoops() && !isCumSum && !isCumProd) return false;
+    prepareVectorizedExpression();
+    if (!vectorizedExpression) return false;
+
+    // the errors of a failed attempt are rolled back, the loop is then evaluated iteration by iteration, which reports them
+    const size_t lastErrorCount=p->lastError.size();
+    const int errorCount=p->errors;
+    jkmpResult v;
+    bool ok=true;
+    for (size_t i=0; ok && i<vectorizedOperands.size(); i++) {
+        vectorizedOperands[i]->invalidate();
+        vectorizedOperands[i]->evaluate(v);
+        // e.g. savefor(i, 1, 3, x*i) concatenates the vectors x*i for a vector x, which is not an element-wise operation
+        ok=(v.isValid && v.type==jkmpDouble);
+    }
+
+    const int64_t count=isRange?range.size():int64_t(itemVals.size());
+    const int64_t B=JKMATHPARSER_VECTORIZEDLOOP_BLOCKSIZE;
+    JKMP::vector<double> items;
+    jkmpBlockScope block(p);
+    p->environment.addVariable(variableSymbol, JKMathParser::jkmpVariable(&items));
+    double value=(isProd || isCumProd)?1.0:0.0;
+    JKMP::vector<double> out;
+    if (ok && !isSum && !isProd) out.reserve(count);
+    double t=range.start;
+    for (int64_t offset=0; ok && offset<count; offset+=B) {
+        const int64_t m=std::min(B, count-offset);
+        items.resize(m);
+        if (isRange) t=range.generate(items.data(), m, t);
+        else for (int64_t i=0; i<m; i++) items[i]=itemVals[offset+i];
+        vectorizedExpression->evaluate(v);
+        ok=(v.isValid && v.type==jkmpDoubleVector && int64_t(v.numVec.size())==m && p->errors==errorCount);
+        // the results are accumulated in the order of the iterations, so they are the same as for the loop
+        for (int64_t i=0; ok && i<m; i++) {
+            if (isSum) {
+                if (JKMP_FloatIsOK(v.numVec[i])) value+=v.numVec[i];
+            } else if (isProd) {
+                if (JKMP_FloatIsOK(v.numVec[i])) value*=v.numVec[i];
+            } else if (isCumSum) {
+                value+=v.numVec[i];
+                out.push_back(value);
+            } else if (isCumProd) {
+                value*=v.numVec[i];
+                out.push_back(value);
+            } else {
+                out.push_back(v.numVec[i]);
+            }
+        }
+    }
+    if (!ok) {
+        p->lastError.resize(lastErrorCount);
+        p->errors=errorCount;
+        return false;
+    }
+    if (isSum || isProd) r.setDouble(value);
+    else r.setDoubleVec(out);
+    return true;
+}
+
+bool JKMathParser::jkmpVectorOperationNode::evaluateByteCodeLoop(jkmpResult &r, double &loopValue, bool isRange, const JKMathParser::jkmpRange &range, const JKMP::vector<double> &itemVals)
+{
+    JKMathParser* p=getParser();
+    // the bytecode only works with numbers, and the addresses of the variables it reads must not change, i.e. there may be no assignments
+    JKMathParser::jkmpTreeInfo info;
+    analyseTree(expression, info);
+    if (info.definesFunctions || !info.assignedVariables.empty()) return false;
+    jkmpInferTypesRecursive(expression);
+    if (!jkmpIsNumberTree(expression)) return false;
+
+    // compile the expression, the loop variable is read from the first heap item. If this fails, the tree is
+    // evaluated instead, so the errors of the compiler are not reported.
+    // the loop-invariant subexpressions are computed into heap items by invariantProgram, before the loop
+    JKMathParser::ByteCodeProgram program, invariantProgram;
+    JKMathParser::ByteCodeEnvironment environment(p);
+    const int loopVar=environment.pushVar(getVariableName());
+    const size_t lastErrorCount=p->lastError.size();
+    const int errorCount=p->errors;
+    JKMP::stringVector invariantNames;
+    bool ok=createLoopInvariantsByteCode(invariantProgram, &environment, invariantNames);
+    ok=ok&&expression->createByteCode(program, &environment);
+    releaseLoopInvariantsByteCode(&environment, invariantNames);
+    p->lastError.resize(lastErrorCount);
+    p->errors=errorCount;
+    if (!ok) return false;
+
+    JKMP::vector<double> resultStack;
+    JKMP::vector<double> heap;
+    heap.resize(ByteCodeInitialHeapSize);
+    resultStack.reserve(128);
+    if (invariantProgram.size()>0) {
+        // evaluateBytecode() expects a result on the stack
+        invariantProgram.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcPush, 0.0));
+        p->evaluateBytecode(invariantProgram, resultStack, heap);
+    }
+
+    if (p->getParallelLoops() && !info.callsImpureFunctions && !info.hasSideEffects) {
+        const int64_t count=isRange?range.size():int64_t(itemVals.size());
+        if (count>=2*jkmpParallelLoopChunk && p->getThreadCount()>1) {
+            evaluateByteCodeLoopParallel(r, program, heap, loopVar, isRange, range, itemVals, count);
+            return true;
+        }
+    }
+
+    const bool isSum=(operationName=="sum");
+    const bool isProd=(operationName=="prod");
+    double sumValue=0;
+    double prodValue=1;
+    if (!isSum && !isProd) {
+        r.setDoubleVec();
+        r.numVec.reserve(isRange?range.size():itemVals.size());
+    }
+    const int64_t cnt=itemVals.size();
+    double t=range.start;
+    for (int64_t i=0; isRange?range.inRange(t):(i<cnt); i++, t=t+range.delta) {
+        // the environment binding (loopValue) is kept in sync for functions that are called by name
+        loopValue=isRange?t:itemVals[i];
+        heap[loopVar]=loopValue;
+        const double v=p->evaluateBytecode(program, resultStack, heap);
+        if (isSum) { if (JKMP_FloatIsOK(v)) sumValue+=v; }
+        else if (isProd) { if (JKMP_FloatIsOK(v)) prodValue*=v; }
+        else r.numVec.push_back(v);
+    }
+    if (isSum) r.setDouble(sumValue);
+    else if (isProd) r.setDouble(prodValue);
+    return true;
+}
+
+void JKMathParser::jkmpVectorOperationNode::evaluateByteCodeLoopParallel(jkmpResult &r, const JKMathParser::ByteCodeProgram &program, const JKMP::vector<double> &initialHeap, int loopVar, bool isRange, const JKMathParser::jkmpRange &range, const JKMP::vector<double> &itemVals, int64_t count)
+{
+    JKMathParser* p=getParser();
+    JKMP::threadPool* pool=p->getThreadPool();
+    const bool isSum=(operationName=="sum");
+    const bool isProd=(operationName=="prod");
+
+    // ranges of integers are indexed directly, other ranges are generated as in the serial loop, so the items are the same
+    JKMP::vector<double> rangeVals;
+    const bool indexRange=isRange && range.start==floor(range.start) && range.delta==floor(range.delta);
+    if (isRange && !indexRange) range.toVector(rangeVals);
+    const double* items=isRange?(indexRange?NULL:rangeVals.data()):itemVals.data();
+
+    // each thread has its own stack, heap (a copy of initialHeap, which contains the loop invariants) and (for sum/prod) buffer for the values of a chunk
+    const int threads=pool->getThreadCount();
+    JKMP::vector<JKMP::vector<double> > stacks, heaps, buffers;
+    stacks.resize(threads);
+    heaps.resize(threads);
+    buffers.resize(threads);
+    JKMP::vector<double> partials;
+    double* out=NULL;
+    if (isSum || isProd) {
+        partials.resize((count+jkmpParallelLoopChunk-1)/jkmpParallelLoopChunk, 0.0);
+    } else {
+        r.setDoubleVec();
+        r.numVec.resize(count, 0.0);
+        out=r.numVec.data();
+    }
+
+    pool->parallelFor(count, jkmpParallelLoopChunk, [&](int64_t start, int64_t end, int thread) {
+        JKMP::vector<double>& heap=heaps[thread];
+        if (heap.empty()) heap=initialHeap;
+        if (!out) buffers[thread].resize(jkmpParallelLoopChunk);
+        double* values=out?(out+start):buffers[thread].data();
+        for (int64_t i=start; i<end; i++) {
+            heap[loopVar]=items?items[i]:(range.start+double(i)*range.delta);
+            values[i-start]=p->evaluateBytecode(program, stacks[thread], heap);
+        }
+        if (!out) partials[start/jkmpParallelLoopChunk]=jkmpPairwiseReduce(values, end-start, isProd);
+    });
+
+    if (isSum) r.setDouble(jkmpPairwiseReduce(partials.data(), partials.size(), false));
+    else if (isProd) r.setDouble(jkmpPairwiseReduce(partials.data(), partials.size(), true));
+}
+
 bool JKMathParser::jkmpVectorOperationNode::createByteCode(JKMathParser::ByteCodeProgram &program, JKMathParser::ByteCodeEnvironment *environment)
 {
     /*
@@ -3988,6 +6179,10 @@ bool JKMathParser::jkmpVectorOperationNode::createByteCode(JKMathParser::ByteCod
   # reserve variable __operationName__stop
   # reserve variable __operationName__delta
   # reserve variable __operationName__runvar
+  #for all loop invariants (see hoistLoopInvariants())
+      EVAL INVARIANT
+      HEAPWRITE __operationName__invariantN
+  #endfor
       PUSH 0
       EVAL END
       HEAPWRITE __operationName__end           # __operationName__stop = END
@@ -4019,6 +6214,10 @@ bool JKMathParser::jkmpVectorOperationNode::createByteCode(JKMathParser::ByteCod
     bool ok=expression&&start&&end;
     if (operationName=="sum" || operationName=="prod") {
         if (ok) {
+            // the loop-invariant subexpressions are computed once, before the loop
+            hoistLoopInvariants();
+            JKMP::stringVector invariantNames;
+            ok=createLoopInvariantsByteCode(program, environment, invariantNames);
             if (operationName=="prod") {
                 program.push_back(JKMathParser::ByteCodeInstruction( JKMathParser::bcPush, 1.0));
             } else {
@@ -4026,7 +6225,7 @@ bool JKMathParser::jkmpVectorOperationNode::createByteCode(JKMathParser::ByteCod
             }
             JKMP::string vnStop=JKMP::string("__%1__stop").arg(operationName);
             JKMP::string vnDelta=JKMP::string("__%1__delta").arg(operationName);
-            JKMP::string vnRun=variableName;//JKMP::string("__%1__runvar").arg(operationName);
+            JKMP::string vnRun=getVariableName();//JKMP::string("__%1__runvar").arg(operationName);
             int stopvar=environment->pushVar(vnStop);
             int deltavar=environment->pushVar(vnDelta);
             int runvar=environment->pushVar(vnRun);
@@ -4065,16 +6264,17 @@ bool JKMathParser::jkmpVectorOperationNode::createByteCode(JKMathParser::ByteCod
             environment->popVar(vnRun);
             environment->popVar(vnDelta);
             environment->popVar(vnStop);
+            releaseLoopInvariantsByteCode(environment, invariantNames);
             int end_adress=program.size();
             program[jmpAdress].intpar=end_adress-jmpAdress;
             program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcNOP));
             return ok;
         } else {
-            if (getParser()) getParser()->jkmpError(JKMP::_("%1(VAR, ITEMS, EXPRESSION) not usable in byte-code").arg(operationName));
+            if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("%1(VAR, ITEMS, EXPRESSION) not usable in byte-code").arg(operationName));
             return false;
         }
     } else {
-        if (getParser()) getParser()->jkmpError(JKMP::_("%1(...) not usable in byte-code").arg(operationName));
+        if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("%1(...) not usable in byte-code").arg(operationName));
         return false;
     }
 
@@ -4083,12 +6283,42 @@ bool JKMathParser::jkmpVectorOperationNode::createByteCode(JKMathParser::ByteCod
 JKMathParser::jkmpNode *JKMathParser::jkmpVectorOperationNode::copy(JKMathParser::jkmpNode *par)
 {
     if (items) {
-        return new jkmpVectorOperationNode(operationName, variableName, items->copy(), expression->copy(), getParser(), par);
+        return new jkmpVectorOperationNode(operationName, getVariableName(), items->copy(), expression->copy(), getParser(), par);
     } else {
         jkmpNode* def=NULL;
         if (defaultValue) def=defaultValue->copy();
-        if (delta) return new jkmpVectorOperationNode(operationName, variableName, start->copy(), end->copy(), delta->copy(), expression->copy(), getParser(), par, def);
-        else return new jkmpVectorOperationNode(operationName, variableName, start->copy(), end->copy(), NULL, expression->copy(), getParser(), par, def);
+        if (delta) return new jkmpVectorOperationNode(operationName, getVariableName(), start->copy(), end->copy(), delta->copy(), expression->copy(), getParser(), par, def);
+        else return new jkmpVectorOperationNode(operationName, getVariableName(), start->copy(), end->copy(), NULL, expression->copy(), getParser(), par, def);
+    }
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpVectorOperationNode::specializeTypes()
+{
+    jkmpSpecializeChild(items, this);
+    jkmpSpecializeChild(start, this);
+    jkmpSpecializeChild(end, this);
+    jkmpSpecializeChild(delta, this);
+    jkmpSpecializeChild(expression, this);
+    jkmpSpecializeChild(defaultValue, this);
+    for (size_t i=0; i<casesNodes.size(); i++) {
+        jkmpSpecializeChild(casesNodes[i].first, this);
+        jkmpSpecializeChild(casesNodes[i].second, this);
+    }
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpVectorOperationNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (items) slots.push_back(&items);
+    if (start) slots.push_back(&start);
+    if (delta) slots.push_back(&delta);
+    if (end) slots.push_back(&end);
+    if (expression) slots.push_back(&expression);
+    if (defaultValue) slots.push_back(&defaultValue);
+    for (size_t i=0; i<casesNodes.size(); i++) {
+        if (casesNodes[i].first) slots.push_back(&casesNodes[i].first);
+        if (casesNodes[i].second) slots.push_back(&casesNodes[i].second);
     }
 }
 
@@ -4107,37 +6337,116 @@ JKMP::string JKMathParser::jkmpVectorOperationNode::print() const
             sl<<end->print();
         }
     }
-    if (defaultValue) {
-        def=JKMP::string(", ")+defaultValue->print();
-    }
-    return JKMP::string("%2(%3, %1, %4%5)").arg(sl.join(", ")).arg(operationName).arg(variableName).arg(expression->print()).arg(def);
+    if (defaultValue) {
+        def=JKMP::string(", ")+defaultValue->print();
+    }
+    return JKMP::string("%2(%3, %1, %4%5)").arg(sl.join(", ")).arg(operationName).arg(getVariableName()).arg(expression->print()).arg(def);
+}
+
+JKMP::string JKMathParser::jkmpVectorOperationNode::printTree(int level) const
+{
+    JKMP::stringVector sl;
+    if (items) sl<<items->printTree(level+1);
+    else {
+        if (delta) {
+            sl<<start->printTree(level+1);
+            sl<<delta->printTree(level+1);
+            sl<<end->printTree(level+1);
+        } else {
+            sl<<start->printTree(level+1);
+            sl<<end->printTree(level+1);
+        }
+        if (defaultValue) {
+            sl<<defaultValue->printTree(level+1);
+        }
+    }
+    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("VectorOperationNode %2, %3%5\n%1\n%4)").arg(sl.join("\n")).arg(operationName).arg(getVariableName()).arg(expression->printTree(level+1)).arg(vectorizedExpression?JKMP::string(" (vectorized)"):JKMP::string());
+
+
+}
+
+
+JKMathParser::jkmpLoopInvariantNode::jkmpLoopInvariantNode(JKMathParser::jkmpNode *c, JKMathParser::jkmpVectorOperationNode *owner, JKMathParser *p, JKMathParser::jkmpNode *par):
+    jkmpNode(p, par)
+{
+    child=c;
+    if (child) {
+        child->setParent(this);
+        inferredType=child->getInferredType();
+    }
+    this->owner=owner;
+    cached=false;
+    enabled=true;
+    byteCodeSlot=-1;
+}
+
+JKMathParser::jkmpLoopInvariantNode::~jkmpLoopInvariantNode()
+{
+    if (child) deleteTree(child);
+}
+
+void JKMathParser::jkmpLoopInvariantNode::evaluate(jkmpResult &result)
+{
+    if (!child) {
+        result.setInvalid();
+    } else if (!enabled) {
+        child->evaluate(result);
+    } else {
+        if (!cached) {
+            child->evaluate(value);
+            cached=true;
+        }
+        result=value;
+    }
 }
 
-JKMP::string JKMathParser::jkmpVectorOperationNode::printTree(int level) const
+bool JKMathParser::jkmpLoopInvariantNode::createByteCode(JKMathParser::ByteCodeProgram &program, JKMathParser::ByteCodeEnvironment *environment)
 {
-    JKMP::stringVector sl;
-    if (items) sl<<items->printTree(level+1);
-    else {
-        if (delta) {
-            sl<<start->printTree(level+1);
-            sl<<delta->printTree(level+1);
-            sl<<end->printTree(level+1);
-        } else {
-            sl<<start->printTree(level+1);
-            sl<<end->printTree(level+1);
-        }
-        if (defaultValue) {
-            sl<<defaultValue->printTree(level+1);
-        }
+    if (enabled && byteCodeSlot>=0) {
+        program.push_back(JKMathParser::ByteCodeInstruction(JKMathParser::bcHeapRead, byteCodeSlot));
+        return true;
     }
-    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("VectorOperationNode %2, %3\n%1\n%4)").arg(sl.join("\n")).arg(operationName).arg(variableName).arg(expression->printTree(level+1));
+    return child && child->createByteCode(program, environment);
+}
+
+int JKMathParser::jkmpLoopInvariantNode::inferType()
+{
+    inferredType=0;
+    if (child) inferredType=child->getInferredType();
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpLoopInvariantNode::specializeTypes()
+{
+    jkmpSpecializeChild(child, this);
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpLoopInvariantNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (child) slots.push_back(&child);
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpLoopInvariantNode::copy(JKMathParser::jkmpNode *par)
+{
+    return child->copy(par);
+}
 
+JKMP::string JKMathParser::jkmpLoopInvariantNode::print() const
+{
+    return child->print();
+}
 
+JKMP::string JKMathParser::jkmpLoopInvariantNode::printTree(int level) const
+{
+    if (!enabled) return child->printTree(level);
+    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("LoopInvariantNode (hoisted out of %2(%3, ...)):\n%1").arg(child->printTree(level+1)).arg(owner->getOperationName()).arg(owner->getVariableName());
 }
 
 JKMathParser::jkmpVectorElementAssignNode::~jkmpVectorElementAssignNode()
 {
-    if (index) delete index;
+    if (index) deleteTree(index);
 }
 
 JKMathParser::jkmpVectorElementAssignNode::jkmpVectorElementAssignNode(JKMP::string var, JKMathParser::jkmpNode *index, JKMathParser::jkmpNode *expression, JKMathParser *p, JKMathParser::jkmpNode *par):
@@ -4154,12 +6463,12 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
      if (child) child->evaluate(exp);
      if (index) index->evaluate(idx);
 
-     getParser()->getVariable(var, variable);
+     getParser()->environment.getVariable(var, variableSymbol);
      //qDebug()<<"got variable "<<variable<<var.toTypeString();
      if (idx.convertsToIntVector()) {
          JKMP::vector<int> ii=idx.asIntVector();
          if (ii.size()==0) {
-             getParser()->jkmpError(JKMP::_("vector element assignment needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
+             JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element assignment needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
              res.setInvalid();
              return;
          }
@@ -4168,17 +6477,17 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
                  for (size_t i=0; i<ii.size(); i++) {
                      if (ii[i]>=0 && ii[i]<var.listData.size()) {
                          var.listData[ii[i]]=exp;
-                         getParser()->setVariable(variable, var);
+                         getParser()->environment.setVariable(variableSymbol, var);
                          res=var;
                      } else {
-                         getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[0]).arg(variable).arg(var.numVec.size()));
+                         JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[0]).arg(getName()).arg(var.numVec.size()));
                          res.setInvalid();
                          return;
                      }
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else {
-                 getParser()->jkmpError(JKMP::_("can only assign x[N elements]=(1 element)"));
+                 JKMATHPARSER_ERROR(getParser(), JKMP::_("can only assign x[N elements]=(1 element)"));
                  res.setInvalid();
                  return;
              }
@@ -4187,14 +6496,14 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
              if (ii.size()==1 && dat.size()==1) {
                  if (ii[0]>=0 && ii[0]<var.numVec.size()) {
                      var.numVec[ii[0]]=dat[0];
-                     getParser()->setVariable(variable, var);
+                     getParser()->environment.setVariable(variableSymbol, var);
                      res.setDouble(dat[0]);
                  } else {
-                     getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[0]).arg(variable).arg(var.numVec.size()));
+                     JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[0]).arg(getName()).arg(var.numVec.size()));
                      res.setInvalid();
                      return;
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else if (ii.size()>1 && dat.size()==1) {
                  res.type=jkmpDoubleVector;
                  res.numVec.clear();
@@ -4204,12 +6513,12 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
                          var.numVec[ii[i]]=t;
                          res.numVec<<t;
                      } else {
-                         getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.numVec.size()));
+                         JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.numVec.size()));
                          res.setInvalid();
                          return;
                      }
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else if (ii.size()>1 && dat.size()==ii.size()) {
                  res.type=jkmpDoubleVector;
                  res.numVec.clear();
@@ -4219,14 +6528,14 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
                          var.numVec[ii[i]]=t;
                          res.numVec<<t;
                      } else {
-                         getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.numVec.size()));
+                         JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.numVec.size()));
                          res.setInvalid();
                          return;
                      }
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else {
-                 getParser()->jkmpError(JKMP::_("can only assign x[N elements]=(1 element), x[N elements]=(N elements), x[1 elements]=(1 elements)"));
+                 JKMATHPARSER_ERROR(getParser(), JKMP::_("can only assign x[N elements]=(1 element), x[N elements]=(N elements), x[1 elements]=(1 elements)"));
                  res.setInvalid();
                  return;
              }
@@ -4236,14 +6545,14 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
              if (ii.size()==1 && dat.size()==1) {
                  if (ii[0]>=0 && ii[0]<var.strVec.size()) {
                      var.strVec[ii[0]]=dat[0];
-                     getParser()->setVariable(variable, var);
+                     getParser()->environment.setVariable(variableSymbol, var);
                      res=jkmpResult(dat[0]);
                  } else {
-                     getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[0]).arg(variable).arg(var.strVec.size()));
+                     JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[0]).arg(getName()).arg(var.strVec.size()));
                      res.setInvalid();
                      return;
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else if (ii.size()>1 && dat.size()==1) {
                  res.type=jkmpStringVector;
                  res.strVec.clear();
@@ -4253,12 +6562,12 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
                          var.strVec[ii[i]]=t;
                          res.strVec<<t;
                      } else {
-                         getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.strVec.size()));
+                         JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.strVec.size()));
                          res.setInvalid();
                          return;
                      }
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else if (ii.size()>1 && dat.size()==ii.size()) {
                  res.type=jkmpStringVector;
                  res.strVec.clear();
@@ -4268,14 +6577,14 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
                          var.strVec[ii[i]]=t;
                          res.strVec<<t;
                      } else {
-                         getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.strVec.size()));
+                         JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.strVec.size()));
                          res.setInvalid();
                          return;
                      }
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else {
-                 getParser()->jkmpError(JKMP::_("can only assign x[N elements]=(1 element), x[N elements]=(N elements), x[1 elements]=(1 elements)"));
+                 JKMATHPARSER_ERROR(getParser(), JKMP::_("can only assign x[N elements]=(1 element), x[N elements]=(N elements), x[1 elements]=(1 elements)"));
                  res.setInvalid();
                  return;
              }
@@ -4284,14 +6593,14 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
              if (ii.size()==1 && dat.size()==1) {
                  if (ii[0]>=0 && ii[0]<var.boolVec.size()) {
                      var.boolVec[ii[0]]=dat[0];
-                     getParser()->setVariable(variable, var);
+                     getParser()->environment.setVariable(variableSymbol, var);
                      res=jkmpResult(dat[0]);
                  } else {
-                     getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[0]).arg(variable).arg(var.boolVec.size()));
+                     JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[0]).arg(getName()).arg(var.boolVec.size()));
                      res.setInvalid();
                      return;
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else if (ii.size()>1 && dat.size()==1) {
                  res.type=jkmpBoolVector;
                  res.boolVec.clear();
@@ -4301,12 +6610,12 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
                          var.boolVec[ii[i]]=t;
                          res.boolVec<<t;
                      } else {
-                         getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.boolVec.size()));
+                         JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.boolVec.size()));
                          res.setInvalid();
                          return;
                      }
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else if (ii.size()>1 && dat.size()==ii.size()) {
                  res.type=jkmpBoolVector;
                  res.boolVec.clear();
@@ -4316,14 +6625,14 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
                          var.boolVec[ii[i]]=t;
                          res.boolVec<<t;
                      } else {
-                         getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.boolVec.size()));
+                         JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.boolVec.size()));
                          res.setInvalid();
                          return;
                      }
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else {
-                 getParser()->jkmpError(JKMP::_("can only assign x[N elements]=(1 element), x[N elements]=(N elements), x[1 elements]=(1 elements)"));
+                 JKMATHPARSER_ERROR(getParser(), JKMP::_("can only assign x[N elements]=(1 element), x[N elements]=(N elements), x[1 elements]=(1 elements)"));
                  res.setInvalid();
                  return;
              }
@@ -4335,14 +6644,14 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
              if (ii.size()==1 && dat.size()==1) {
                  if (ii[0]>=0 && ii[0]<var.str.size()) {
                      var.str[ii[0]]=dat[0];
-                     getParser()->setVariable(variable, var);
+                     getParser()->environment.setVariable(variableSymbol, var);
                      res.setString(JKMP::string(dat[0]));
                  } else {
-                     getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but string %2 has only %3 elements").arg(ii[0]).arg(variable).arg(var.str.size()));
+                     JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but string %2 has only %3 elements").arg(ii[0]).arg(getName()).arg(var.str.size()));
                      res.setInvalid();
                      return;
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else if (ii.size()>1 && dat.size()==1) {
                  res.type=jkmpString;
                  res.str.clear();
@@ -4352,12 +6661,12 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
                          var.str[ii[i]]=t;
                          res.str+=t;
                      } else {
-                         getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but string %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.str.size()));
+                         JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but string %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.str.size()));
                          res.setInvalid();
                          return;
                      }
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else if (ii.size()>1 && dat.size()==ii.size()) {
                  res.type=jkmpString;
                  res.str.clear();
@@ -4367,24 +6676,24 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
                          var.str[ii[i]]=t;
                          res.str+=t;
                      } else {
-                         getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to assign to element %1, but string %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.str.size()));
+                         JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to assign to element %1, but string %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.str.size()));
                          res.setInvalid();
                          return;
                      }
                  }
-                 getParser()->setVariable(variable, var);
+                 getParser()->environment.setVariable(variableSymbol, var);
              } else {
-                 getParser()->jkmpError(JKMP::_("can only assign x[N elements]=(1 element), x[N elements]=(N elements), x[1 elements]=(1 elements)"));
+                 JKMATHPARSER_ERROR(getParser(), JKMP::_("can only assign x[N elements]=(1 element), x[N elements]=(N elements), x[1 elements]=(1 elements)"));
                  res.setInvalid();
                  return;
              }
          } else {
-             getParser()->jkmpError(JKMP::_("vector element assignment needs an expression which evaluates to the same type as the variable (var: %1, expression: %2)").arg(resultTypeToString(var.type)).arg(exp.toTypeString()));
+             JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element assignment needs an expression which evaluates to the same type as the variable (var: %1, expression: %2)").arg(resultTypeToString(var.type)).arg(exp.toTypeString()));
              res.setInvalid();
              return;
          }
      } else {
-         getParser()->jkmpError(JKMP::_("vector element assignment needs number or number vector as index, but index is %1").arg(resultTypeToString(idx.type)));
+         JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element assignment needs number or number vector as index, but index is %1").arg(resultTypeToString(idx.type)));
          res.setInvalid();
          return;
      }
@@ -4393,28 +6702,53 @@ void JKMathParser::jkmpVectorElementAssignNode::evaluate(jkmpResult &res)
 
 JKMathParser::jkmpNode *JKMathParser::jkmpVectorElementAssignNode::copy(JKMathParser::jkmpNode *par)
 {
-    return new JKMathParser::jkmpVectorElementAssignNode(variable, index->copy(NULL), child->copy(NULL), getParser(), par);
+    return new JKMathParser::jkmpVectorElementAssignNode(getName(), index->copy(NULL), child->copy(NULL), getParser(), par);
+}
+
+int JKMathParser::jkmpVectorElementAssignNode::inferType()
+{
+    inferredType=0;
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpVectorElementAssignNode::specializeTypes()
+{
+    jkmpSpecializeChild(child, this);
+    jkmpSpecializeChild(index, this);
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpVectorElementAssignNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (index) slots.push_back(&index);
+    if (child) slots.push_back(&child);
+}
+
+void JKMathParser::jkmpVectorElementAssignNode::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    jkmpNode::createFlatProgram(program);
 }
 
 JKMP::string JKMathParser::jkmpVectorElementAssignNode::print() const
 {
-    return JKMP::string("%1[%3] = %2").arg(variable).arg(child->print()).arg(index->print());
+    return JKMP::string("%1[%3] = %2").arg(getName()).arg(child->print()).arg(index->print());
 }
 
 JKMP::string JKMathParser::jkmpVectorElementAssignNode::printTree(int level) const
 {
-    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("VectorElementAssigneNode '%2'\n%1\n%3").arg(index->printTree(level+1)).arg(variable).arg(child->printTree(level+1));
+    return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("VectorElementAssigneNode '%2'\n%1\n%3").arg(index->printTree(level+1)).arg(getName()).arg(child->printTree(level+1));
 }
 
 JKMathParser::jkmpVariableVectorAccessNode::~jkmpVariableVectorAccessNode()
 {
-    if (index) delete index;
+    if (index) deleteTree(index);
 }
 
 JKMathParser::jkmpVariableVectorAccessNode::jkmpVariableVectorAccessNode(JKMP::string var, JKMathParser::jkmpNode *index, JKMathParser *p, JKMathParser::jkmpNode *par):
     jkmpNode(p, par)
 {
-    variable=var;
+    variableSymbol=internSymbol(var);
     this->index=index;
     if(index) index->setParent(this);
 }
@@ -4426,12 +6760,12 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
     if (index) index->evaluate(idx);
     res.isValid=true;
 
-    var=getParser()->getVariable(variable);
+    var=getParser()->environment.getVariable(variableSymbol);
     if (var.type==jkmpDoubleVector) {
         if (idx.convertsToBoolVector()) {
             JKMP::vector<bool> ii=idx.asBoolVector();
             if (ii.size()!=var.numVec.size()) {
-                getParser()->jkmpError(JKMP::_("vector variable element access by boolean-vectors needs a boolean vector of the same size, as the vector variable, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector variable element access by boolean-vectors needs a boolean vector of the same size, as the vector variable, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
                 res.setInvalid();
                 return;
             }
@@ -4450,7 +6784,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
         } else if (idx.convertsToIntVector()) {
             JKMP::vector<int> ii=idx.asIntVector();
             if (ii.size()==0) {
-                getParser()->jkmpError(JKMP::_("vector variable element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector variable element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
                 res.setInvalid();
                 return;
             }
@@ -4460,7 +6794,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
                 if (ii[i]>=0 && ii[i]<var.numVec.size()) {
                     res.numVec[i]=var.numVec[ii[i]];
                 } else {
-                    getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to access element %1, but vector variable %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.numVec.size()));
+                    JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to access element %1, but vector variable %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.numVec.size()));
                     res.setInvalid();
                     return;
                 }
@@ -4468,7 +6802,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
             if (res.numVec.size()==1) res.setDouble(res.numVec[0]);
 
         } else {
-            getParser()->jkmpError(JKMP::_("vector variable element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("vector variable element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
             res.setInvalid();
             return;
         }
@@ -4476,7 +6810,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
         if (idx.convertsToBoolVector()) {
             JKMP::vector<bool> ii=idx.asBoolVector();
             if (ii.size()!=var.listData.size()) {
-                getParser()->jkmpError(JKMP::_("list element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.listData.size()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("list element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.listData.size()));
                 res.setInvalid();
                 return;
             }
@@ -4496,7 +6830,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
         } else if (idx.convertsToIntVector()) {
             JKMP::vector<int> ii=idx.asIntVector();
             if (ii.size()==0) {
-                getParser()->jkmpError(JKMP::_("list element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("list element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
                 res.setInvalid();
                 return;
             }
@@ -4505,14 +6839,14 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
                 if (ii[i]>=0 && ii[i]<var.listData.size()) {
                     res.listData[i]=var.listData[ii[i]];
                 } else {
-                    getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to access element %1, but list %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.listData.size()));
+                    JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to access element %1, but list %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.listData.size()));
                     res.setInvalid();
                     return;
                 }
             }
             if (res.listData.size()==1) res=res.listData[0];
         } else {
-            getParser()->jkmpError(JKMP::_("list element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("list element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
             res.setInvalid();
             return;
         }
@@ -4520,7 +6854,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
         if (idx.convertsToBoolVector()) {
             JKMP::vector<bool> ii=idx.asBoolVector();
             if (ii.size()!=var.strVec.size()) {
-                getParser()->jkmpError(JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
                 res.setInvalid();
                 return;
             }
@@ -4539,7 +6873,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
         } else if (idx.convertsToIntVector()) {
             JKMP::vector<int> ii=idx.asIntVector();
             if (ii.size()==0) {
-                getParser()->jkmpError(JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
                 res.setInvalid();
                 return;
             }
@@ -4550,14 +6884,14 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
                 if (ii[i]>=0 && ii[i]<var.strVec.size()) {
                     res.strVec<<var.strVec[ii[i]];
                 } else {
-                    getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to access element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.strVec.size()));
+                    JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to access element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.strVec.size()));
                     res.setInvalid();
                     return;
                 }
             }
             if (res.strVec.size()==1) res.setString(res.strVec[0]);
         } else {
-            getParser()->jkmpError(JKMP::_("vector element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
             res.setInvalid();
             return;
 
@@ -4566,7 +6900,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
         if (idx.convertsToBoolVector()) {
             JKMP::vector<bool> ii=idx.asBoolVector();
             if (ii.size()!=var.boolVec.size()) {
-                getParser()->jkmpError(JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
                 res.setInvalid();
                 return;
             }
@@ -4585,7 +6919,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
         } else if (idx.convertsToIntVector()) {
             JKMP::vector<int> ii=idx.asIntVector();
             if (ii.size()==0) {
-                getParser()->jkmpError(JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
                 res.setInvalid();
                 return;
             }
@@ -4595,7 +6929,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
                 if (ii[i]>=0 && ii[i]<var.boolVec.size()) {
                     res.boolVec[i]=var.boolVec[ii[i]];
                 } else {
-                    getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to access element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.boolVec.size()));
+                    JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to access element %1, but vector %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.boolVec.size()));
                     res.setInvalid();
                     return;
                 }
@@ -4603,7 +6937,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
             if (res.boolVec.size()==1) res.setBoolean(res.boolVec[0]);
 
         } else {
-            getParser()->jkmpError(JKMP::_("vector element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
             res.setInvalid();
             return;
         }
@@ -4611,7 +6945,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
         if (idx.convertsToBoolVector()) {
             JKMP::vector<bool> ii=idx.asBoolVector();
             if (ii.size()!=var.str.size()) {
-                getParser()->jkmpError(JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
                 res.setInvalid();
                 return;
             }
@@ -4630,7 +6964,7 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
         } else if (idx.convertsToIntVector()) {
             JKMP::vector<int> ii=idx.asIntVector();
             if (ii.size()==0) {
-                getParser()->jkmpError(JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
                 res.setInvalid();
                 return;
             }
@@ -4640,19 +6974,19 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
                 if (ii[i]>=0 && ii[i]<var.str.size()) {
                     res.str+=var.str[ii[i]];
                 } else {
-                    getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to access element %1, but string %2 has only %3 elements").arg(ii[i]).arg(variable).arg(var.str.size()));
+                    JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to access element %1, but string %2 has only %3 elements").arg(ii[i]).arg(getName()).arg(var.str.size()));
                     res.setInvalid();
                     return;
                 }
             }
 
         } else {
-            getParser()->jkmpError(JKMP::_("string character access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("string character access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
             res.setInvalid();
             return;
         }
     } else {
-        getParser()->jkmpError(JKMP::_("vector element/string character access is only possible if the variable is a number/string/bool vector, or a string, but variable '%1' is of type %2").arg(variable).arg(resultTypeToString(var.type)));
+        JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element/string character access is only possible if the variable is a number/string/bool vector, or a string, but variable '%1' is of type %2").arg(getName()).arg(resultTypeToString(var.type)));
         res.setInvalid();
         return;
     }
@@ -4660,17 +6994,29 @@ void JKMathParser::jkmpVariableVectorAccessNode::evaluate(jkmpResult &res)
 
 JKMathParser::jkmpNode *JKMathParser::jkmpVariableVectorAccessNode::copy(JKMathParser::jkmpNode *par)
 {
-    return new jkmpVariableVectorAccessNode(variable, index->copy(NULL), getParser(), par);
+    return new jkmpVariableVectorAccessNode(getName(), index->copy(NULL), getParser(), par);
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpVariableVectorAccessNode::specializeTypes()
+{
+    jkmpSpecializeChild(index, this);
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpVariableVectorAccessNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (index) slots.push_back(&index);
 }
 
 JKMP::string JKMathParser::jkmpVariableVectorAccessNode::print() const
 {
-    return JKMP::string("%1[%2]").arg(variable).arg(index->print());
+    return JKMP::string("%1[%2]").arg(getName()).arg(index->print());
 }
 
 JKMP::string JKMathParser::jkmpVariableVectorAccessNode::printTree(int level) const
 {
-return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("VariableVectorAccessNode: '%2'\n%1").arg(index->printTree(level+1)).arg(variable);
+return JKMP::string(2*level, JKMP::charType(' '))+JKMP::string("VariableVectorAccessNode: '%2'\n%1").arg(index->printTree(level+1)).arg(getName());
 }
 
 void JKMathParser::jkmpNode::evaluate(jkmpResult &result)
@@ -4702,6 +7048,13 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
     //int heappointer=0;
     heap.resize(ByteCodeInitialHeapSize);
     resultStack.reserve(128);
+    return evaluateBytecode(program, resultStack, heap);
+}
+
+double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &program, JKMP::vector<double> &resultStack, JKMP::vector<double> &heap)
+{
+    resultStack.clear();
+    if (heap.size()<ByteCodeInitialHeapSize) heap.resize(ByteCodeInitialHeapSize);
     bool ok=true;
     JKMathParser::ByteCodeProgram::const_iterator itp=program.begin();
     while (ok && itp<program.end()) {
@@ -4717,7 +7070,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcPop:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.is_empty()) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in POP opcode: stack is empty"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in POP opcode: stack is empty"));
                     ok=false;
                 } else
 #endif
@@ -4731,7 +7084,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcVarWrite:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<1) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in VARWRITE opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in VARWRITE opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4748,12 +7101,15 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcHeapWrite:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<1) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in HEAPWRITE opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in HEAPWRITE opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
-                {
-                    if (itp->intpar>heap.size()) heap.resize(itp->intpar+1);
+                if (itp->intpar<0) {
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in HEAPWRITE opcode: negative heap address"));
+                    ok=false;
+                } else {
+                    if (size_t(itp->intpar)>=heap.size()) heap.resize(size_t(itp->intpar)+1);
                     heap[itp->intpar]=resultStack.pop();
 #ifdef JKMATHPARSER_BYTECODESTACK_DEBUGMESSAGES
                     //qDebug()<<"HEAPWRITE  #"<<itp->intpar+heapoffset<<" <= "<<heap[itp->intpar+heapoffset];
@@ -4766,14 +7122,14 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcCallCFunction:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<itp->intpar) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in CALLCFUNC opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in CALLCFUNC opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
                 {
                     const JKMP::vector<double>::iterator it=resultStack.end();
                     switch (itp->intpar) {
-                        case 0: *(it-1)=((jkmpEvaluateFuncSimple0Param)itp->pntpar)(); break;
+                        case 0: resultStack.push_back(((jkmpEvaluateFuncSimple0Param)itp->pntpar)()); break;
                         case 1: *(it-1)=((jkmpEvaluateFuncSimple1Param)itp->pntpar)(*(it-1)); break;
                         case 2: *(it-2)=((jkmpEvaluateFuncSimple2Param)itp->pntpar)(*(it-1),*(it-2)); resultStack.pop(); break;
                         case 3: *(it-3)=((jkmpEvaluateFuncSimple3Param)itp->pntpar)(*(it-1),*(it-2),*(it-3)); resultStack.pop(); resultStack.pop(); break;
@@ -4783,14 +7139,14 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcCallCMPFunction:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<itp->intpar) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in CALLCMPFUNC opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in CALLCMPFUNC opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
                 {
                     const JKMP::vector<double>::iterator it=resultStack.end();
                     switch (itp->intpar) {
-                        case 0: *(it-1)=((jkmpEvaluateFuncSimple0ParamMP)itp->pntpar)(this); break;
+                        case 0: resultStack.push_back(((jkmpEvaluateFuncSimple0ParamMP)itp->pntpar)(this)); break;
                         case 1: *(it-1)=((jkmpEvaluateFuncSimple1ParamMP)itp->pntpar)(*(it-1), this); break;
                         case 2: *(it-2)=((jkmpEvaluateFuncSimple2ParamMP)itp->pntpar)(*(it-1),*(it-2), this); resultStack.pop(); break;
                         case 3: *(it-3)=((jkmpEvaluateFuncSimple3ParamMP)itp->pntpar)(*(it-1),*(it-2),*(it-3), this); resultStack.pop(); resultStack.pop(); break;
@@ -4800,7 +7156,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
         case bcCallResultFunction:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
             if (resultStack.size()<itp->intpar) {
-                jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in CALLRESULTFUNC opcode: stack is too small"));
+                JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in CALLRESULTFUNC opcode: stack is too small"));
                 ok=false;
             } else
 #endif
@@ -4815,7 +7171,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
                 if (r.type==jkmpDouble) resultStack.push(r.asNumber());
                 else if (r.type==jkmpBool) resultStack.push((r.asBool())?1.0:0.0);
                 else {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: result of function call ('%1'') was not a number!").arg(itp->strpar));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: result of function call ('%1'') was not a number!").arg(itp->strpar));
                     ok=false;
                 }
             } break;
@@ -4823,7 +7179,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcAdd:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in ADD opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in ADD opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4837,7 +7193,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcSub:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in SUB opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in SUB opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4851,7 +7207,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcMul:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in MUL opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in MUL opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4866,7 +7222,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcDiv:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in DIV opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in DIV opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4880,7 +7236,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcMod:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in MOD opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in MOD opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4894,7 +7250,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcPow:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in POW opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in POW opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4909,7 +7265,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcNeg:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<1) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in NEG opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in NEG opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4925,7 +7281,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcBitAnd:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in BITAND opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in BITAND opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4938,7 +7294,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcBitOr:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in BITOR opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in BITOR opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4953,7 +7309,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcBitNot:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<1) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in BITNOT opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in BITNOT opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4969,7 +7325,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcLogicAnd:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in LOGICAND opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in LOGICAND opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4982,7 +7338,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcLogicOr:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in LOGICOR opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in LOGICOR opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -4997,7 +7353,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcLogicXor:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in LOGICOR opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in LOGICOR opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -5013,7 +7369,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcLogicNot:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<1) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in LOGICNOT opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in LOGICNOT opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -5027,7 +7383,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcCmpEqual:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in CMPEQUAL opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in CMPEQUAL opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -5044,7 +7400,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcCmpLesser:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in CMPLESSER opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in CMPLESSER opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -5059,7 +7415,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcCmpLesserEqual:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<2) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in CMPLESSEREQUAL opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in CMPLESSEREQUAL opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -5089,7 +7445,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcJumpCondRel:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<1) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in JMPCONDREL opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in JMPCONDREL opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -5108,7 +7464,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
             case bcBJumpCondRel:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
                 if (resultStack.size()<1) {
-                    jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error in BJMPCONDREL opcode: stack is too small"));
+                    JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error in BJMPCONDREL opcode: stack is too small"));
                     ok=false;
                 } else
 #endif
@@ -5127,7 +7483,7 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
 
             default:
 #ifdef JKMATHPARSER_BYTECODESTACK_ERRORCHECKING
-                jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: unknown opcode %1 encountered").arg(itp->opcode));
+                JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: unknown opcode %1 encountered").arg(itp->opcode));
                 ok=false;
 #endif
                 break;
@@ -5143,11 +7499,11 @@ double JKMathParser::evaluateBytecode(const JKMathParser::ByteCodeProgram &progr
         if (resultStack.size()>0) {
             return resultStack.back();
         } else {
-            jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: no result returned"));
+            JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: no result returned"));
             return NAN;
         }
     } else {
-        jkmpError(JKMP::_("JKMathParser Bytecode Interpreter: error running program"));
+        JKMATHPARSER_ERROR(this, JKMP::_("JKMathParser Bytecode Interpreter: error running program"));
         return NAN;
     }
 }
@@ -5316,6 +7672,480 @@ void JKMathParser::ByteCodeEnvironment::popVar(const JKMP::string &name)
     heapItemPointer--;
 }
 
+JKMathParser::FlatInstruction::FlatInstruction(JKMathParser::FlatOpcodes opcode, JKMathParser::jkmpNode *node, int intpar, int intpar2)
+{
+    this->opcode=opcode;
+    this->node=node;
+    this->intpar=intpar;
+    this->intpar2=intpar2;
+}
+
+JKMathParser::FlatProgram::FlatProgram()
+{
+    stackSize=0;
+    stackDepth=0;
+}
+
+int JKMathParser::FlatProgram::add(const JKMathParser::FlatInstruction &instruction, int stackChange)
+{
+    instructions.push_back(instruction);
+    stackDepth+=stackChange;
+    if (stackDepth>stackSize) stackSize=stackDepth;
+    return static_cast<int>(instructions.size())-1;
+}
+
+void JKMathParser::FlatProgram::clear()
+{
+    instructions.clear();
+    stackSize=0;
+    stackDepth=0;
+}
+
+JKMathParser::FusedVectorInstruction::FusedVectorInstruction(JKMathParser::FusedVectorOpcodes opcode, JKMathParser::jkmpNode *node, int intpar)
+{
+    this->opcode=opcode;
+    this->node=node;
+    this->intpar=intpar;
+}
+
+JKMathParser::FusedVectorProgram::FusedVectorProgram()
+{
+    stackSize=0;
+    stackDepth=0;
+    depth=0;
+}
+
+void JKMathParser::FusedVectorProgram::add(const JKMathParser::FusedVectorInstruction &instruction, int stackChange)
+{
+    instructions.push_back(instruction);
+    stackDepth+=stackChange;
+    if (stackDepth>stackSize) stackSize=stackDepth;
+}
+
+void JKMathParser::FusedVectorProgram::addOperand(JKMathParser::jkmpNode *node)
+{
+    add(JKMathParser::FusedVectorInstruction(JKMathParser::fusedOperand, node, static_cast<int>(operands.size())), 1);
+    operands.push_back(node);
+}
+
+int JKMathParser::FusedVectorProgram::operationCount() const
+{
+    return static_cast<int>(instructions.size()-operands.size());
+}
+
+void JKMathParser::FusedVectorProgram::clear()
+{
+    instructions.clear();
+    operands.clear();
+    stackSize=0;
+    stackDepth=0;
+    depth=0;
+}
+
+std::shared_ptr<JKMathParser::FlatProgram> JKMathParser::getFlatFunctionProgram(const JKMathParser::jkmpFunctionDescriptor *fd)
+{
+    // function bodies are only deleted, when the function generation changes, so the node pointers are valid keys until then
+    if (flatFunctionProgramsGeneration!=environment.getFunctionGeneration()) {
+        flatFunctionPrograms.clear();
+        flatFunctionProgramsGeneration=environment.getFunctionGeneration();
+    }
+    std::map<const jkmpNode*, std::shared_ptr<FlatProgram> >::iterator it=flatFunctionPrograms.find(fd->functionNode);
+    if (it!=flatFunctionPrograms.end()) return it->second;
+    std::shared_ptr<FlatProgram> p=std::make_shared<FlatProgram>();
+    fd->functionNode->createFlatProgram(*p);
+    flatFunctionPrograms[fd->functionNode]=p;
+    return p;
+}
+
+void JKMathParser::evaluateFlatProgram(jkmpResult &result, const JKMathParser::FlatProgram &program)
+{
+    // the slots of flatStack are reused between runs, a nested run (e.g. from a C-function) uses its own stack
+    JKMP::vector<jkmpResult> localStack;
+    const bool useMemberStack=!flatStackInUse;
+    JKMP::vector<jkmpResult>& stack=useMemberStack?flatStack:localStack;
+    if (useMemberStack) flatStackInUse=true;
+
+    JKMP::vector<FlatFrame> frames;
+    const FlatProgram* prog=&program;
+    std::shared_ptr<FlatProgram> progHold;
+    size_t pc=0;
+    size_t sp=0;
+    if (stack.size()<static_cast<size_t>(prog->stackSize+1)) stack.resize(prog->stackSize+1);
+
+    while (true) {
+        if (pc>=prog->instructions.size()) {
+            if (frames.size()<=0) break;
+            // return from a user-defined function, its result is the topmost slot
+            FlatFrame& f=frames.back();
+            if (f.leaveBlock) leaveBlock();
+            prog=f.program;
+            pc=f.pc;
+            progHold=f.hold;
+            frames.pop_back();
+            continue;
+        }
+        const FlatInstruction& inst=prog->instructions[pc];
+        pc++;
+        switch(inst.opcode) {
+            case flatNOP:
+                break;
+            case flatEvalNode:
+                inst.node->evaluate(stack[sp]);
+                sp++;
+                break;
+            case flatReserve:
+                sp++;
+                break;
+            case flatPop:
+                sp--;
+                break;
+            case flatPushInvalid:
+                stack[sp].setInvalid();
+                sp++;
+                break;
+            case flatUnary:
+                static_cast<jkmpUnaryNode*>(inst.node)->evaluateOperation(stack[sp-1]);
+                break;
+            case flatBinaryArithmetic:
+                static_cast<jkmpBinaryArithmeticNode*>(inst.node)->evaluateOperation(stack[sp-3], stack[sp-2], stack[sp-1]);
+                sp-=2;
+                break;
+            case flatCompare:
+                static_cast<jkmpCompareNode*>(inst.node)->evaluateOperation(stack[sp-3], stack[sp-2], stack[sp-1]);
+                sp-=2;
+                break;
+            case flatBinaryBool:
+                static_cast<jkmpBinaryBoolNode*>(inst.node)->evaluateOperation(stack[sp-3], stack[sp-2], stack[sp-1]);
+                sp-=2;
+                break;
+            case flatAssignVariable:
+                environment.setVariable(static_cast<jkmpVariableAssignNode*>(inst.node)->getSymbol(), stack[sp-1]);
+                break;
+            case flatJump:
+                pc=inst.intpar;
+                break;
+            case flatJumpIfNot:
+                if (stack[sp-1].type==jkmpBool) {
+                    sp--;
+                    if (!stack[sp].boolean) pc=inst.intpar;
+                } else {
+                    JKMATHPARSER_ERROR(this, inst.strpar);
+                    stack[sp-1].setInvalid();
+                    pc=inst.intpar2;
+                }
+                break;
+            case flatCallC: {
+                    const size_t n=inst.intpar;
+                    jkmpFunctionNode* fn=static_cast<jkmpFunctionNode*>(inst.node);
+                    const jkmpFunctionDescriptor* fd=fn->resolveFunction();
+                    jkmpResult& r=stack[sp-n-1];
+                    if (fd && fd->type==functionC) {
+                        r=fd->function(stack.data()+sp-n, n, this);
+                    } else if (fd && fd->type==functionCRefReturn) {
+                        fd->functionRR(r, stack.data()+sp-n, n, this);
+                    } else if (fd && fd->type==functionNode) {
+                        // the function was redefined since the program was created
+                        JKMP::vector<jkmpResult> params(stack.begin()+(sp-n), stack.begin()+sp);
+                        fd->evaluate(r, params, this);
+                    } else if (fd) {
+                        jkmpEvaluateFromValues(fd, r, stack.data()+sp-n, n, this);
+                    } else {
+                        jkmpError(jkmpErrorFunctionNotFound, fn->getSymbol());
+                        r.setInvalid();
+                    }
+                    sp-=n;
+                } break;
+            case flatCallUser: {
+                    const size_t n=inst.intpar;
+                    jkmpFunctionNode* fn=static_cast<jkmpFunctionNode*>(inst.node);
+                    const jkmpFunctionDescriptor* fd=fn->resolveFunction();
+                    if (fd && fd->type==functionNode && fd->functionNode && fd->parameterNames.size()==n) {
+                        std::shared_ptr<FlatProgram> body=getFlatFunctionProgram(fd);
+                        FlatFrame f;
+                        f.program=prog;
+                        f.pc=pc;
+                        f.leaveBlock=(n>0);
+                        f.hold=progHold;
+                        frames.push_back(f);
+                        if (n>0) {
+                            enterBlock();
+                            for (size_t i=0; i<n; i++) {
+                                addVariable(fd->parameterNames[i], stack[sp-n+i]);
+                            }
+                        }
+                        sp-=n;
+                        progHold=body;
+                        prog=body.get();
+                        pc=0;
+                        if (stack.size()<sp+prog->stackSize+1) stack.resize(2*(sp+prog->stackSize+1));
+                    } else {
+                        jkmpResult r;
+                        if (fd && fd->type==functionNode) {
+                            JKMATHPARSER_ERROR(this, JKMP::_("function '%1' takes %2 parameters, but %3 parameters were given").arg(fn->getName()).arg(fd->parameterNames.size()).arg(n));
+                            r.setInvalid();
+                        } else if (fd && fd->type==functionC) {
+                            r=fd->function(stack.data()+sp-n, n, this);
+                        } else if (fd && fd->type==functionCRefReturn) {
+                            fd->functionRR(r, stack.data()+sp-n, n, this);
+                        } else if (fd) {
+                            jkmpEvaluateFromValues(fd, r, stack.data()+sp-n, n, this);
+                        } else {
+                            jkmpError(jkmpErrorFunctionNotFound, fn->getSymbol());
+                            r.setInvalid();
+                        }
+                        sp-=n;
+                        stack[sp]=r;
+                        sp++;
+                    }
+                } break;
+        }
+    }
+
+    if (sp>0) result=stack[sp-1];
+    else result.setInvalid();
+    if (useMemberStack) flatStackInUse=false;
+}
+
+jkmpResult JKMathParser::evaluateFlat(JKMathParser::jkmpNode *node)
+{
+    jkmpResult r;
+    if (node) {
+        FlatProgram program;
+        node->createFlatProgram(program);
+        evaluateFlatProgram(r, program);
+    } else {
+        r.setInvalid();
+    }
+    return r;
+}
+
+JKMP::string JKMathParser::printFlatProgram(const JKMathParser::FlatInstruction &inst)
+{
+    JKMP::string res="";
+
+    switch (inst.opcode) {
+        case flatNOP: res+=JKMP::string("NOP"); break;
+        case flatEvalNode: res+=JKMP::string("EVALNODE %1").arg(inst.node?inst.node->print():JKMP::string("?")); break;
+        case flatReserve: res+=JKMP::string("RESERVE"); break;
+        case flatPop: res+=JKMP::string("POP"); break;
+        case flatPushInvalid: res+=JKMP::string("PUSHINVALID"); break;
+        case flatUnary: res+=JKMP::string("UNARY %1").arg(JKMP::string(JKMP::charType(inst.intpar))); break;
+        case flatBinaryArithmetic: res+=JKMP::string("ARITHMETIC %1").arg(JKMP::string(JKMP::charType(inst.intpar))); break;
+        case flatCompare: res+=JKMP::string("COMPARE %1").arg(JKMP::string(JKMP::charType(inst.intpar))); break;
+        case flatBinaryBool: res+=JKMP::string("LOGIC %1").arg(JKMP::string(JKMP::charType(inst.intpar))); break;
+        case flatCallC: res+=JKMP::string("CALLC %1, %2").arg(static_cast<jkmpFunctionNode*>(inst.node)->getName()).arg(inst.intpar); break;
+        case flatCallUser: res+=JKMP::string("CALLUSER %1, %2").arg(static_cast<jkmpFunctionNode*>(inst.node)->getName()).arg(inst.intpar); break;
+        case flatAssignVariable: res+=JKMP::string("ASSIGN %1").arg(inst.strpar); break;
+        case flatJump: res+=JKMP::string("JMP %1").arg(inst.intpar); break;
+        case flatJumpIfNot: res+=JKMP::string("JMPIFNOT %1, %2").arg(inst.intpar).arg(inst.intpar2); break;
+        default:
+            res+=JKMP::string("*** UNKNOWN *** %1").arg(inst.opcode);
+            break;
+    }
+    return res;
+}
+
+JKMP::string JKMathParser::printFlatProgram(const JKMathParser::FlatProgram &program)
+{
+    JKMP::string res="";
+    for (size_t i = 0; i < program.size(); ++i) {
+        res+=JKMP::string("%1: %2\n").arg(JKMP::intToStr(i, 10, JKMP::charType(' '))).arg(printFlatProgram(program.instructions[i]));
+    }
+    return res;
+}
+
+void JKMathParser::jkmpNode::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    program.add(JKMathParser::FlatInstruction(JKMathParser::flatEvalNode, this), 1);
+}
+
+int JKMathParser::jkmpNode::inferType()
+{
+    return inferredType;
+}
+
+JKMathParser::jkmpNode *JKMathParser::jkmpNode::specializeTypes()
+{
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpNode::getChildren(JKMP::vector<JKMathParser::jkmpNode *> &children)
+{
+    JKMP::vector<JKMathParser::jkmpNode**> slots;
+    getChildSlots(slots);
+    for (size_t i=0; i<slots.size(); i++) {
+        if (*slots[i]) children.push_back(*slots[i]);
+    }
+}
+
+void JKMathParser::jkmpNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &/*slots*/)
+{
+}
+
+JKMathParser::jkmpTreeInfo::jkmpTreeInfo()
+{
+    definesFunctions=false;
+    callsUnknownFunctions=false;
+    callsImpureFunctions=false;
+    hasSideEffects=false;
+}
+
+void JKMathParser::analyseTree(JKMathParser::jkmpNode *node, JKMathParser::jkmpTreeInfo &info)
+{
+    std::set<const JKMathParser::jkmpNode*> functionBodies;
+    jkmpAnalyseTree(node, info, functionBodies);
+}
+
+bool JKMathParser::jkmpNode::isElementwiseOperation()
+{
+    return false;
+}
+
+void JKMathParser::jkmpNode::createFusedVectorProgram(JKMathParser::FusedVectorProgram &program)
+{
+    program.addOperand(this);
+}
+
+namespace {
+    /** \brief arena that is currently used for node allocations on this thread */
+    thread_local JKMathParser::jkmpNodeArena* jkmpNodeArena_current=NULL;
+    /** \brief work list of jkmpNode::deleteTree() on this thread (nodes that still have to be deleted) */
+    thread_local std::vector<JKMathParser::jkmpNode*> jkmpNode_teardownPending;
+    /** \brief \c true, while jkmpNode::deleteTree() is working through jkmpNode_teardownPending on this thread */
+    thread_local bool jkmpNode_teardownActive=false;
+
+    /** \brief header in front of every node allocation: points to the owning arena (NULL for heap nodes), padded to keep the node aligned */
+    union jkmpNodeAllocHeader {
+        JKMathParser::jkmpNodeArena* arena;
+        long double align_ld;
+        void* align_p;
+        long long align_ll;
+    };
+}
+
+JKMathParser::jkmpNodeArena::jkmpNodeArena()
+{
+    blockUsed=0;
+    blockSize=0;
+    allocatedBytes=0;
+    refCount.store(0);
+}
+
+JKMathParser::jkmpNodeArena::~jkmpNodeArena()
+{
+    for (size_t i=0; i<blocks.size(); i++) {
+        free(blocks[i]);
+    }
+    blocks.clear();
+}
+
+void *JKMathParser::jkmpNodeArena::allocate(size_t size)
+{
+    const size_t align=sizeof(jkmpNodeAllocHeader);
+    size=(size+align-1)/align*align;
+    if (blocks.size()==0 || blockUsed+size>blockSize) {
+        const size_t bs=std::max<size_t>(BlockSize, size);
+        char* b=static_cast<char*>(malloc(bs));
+        if (!b) throw std::bad_alloc();
+        blocks.push_back(b);
+        blockSize=bs;
+        blockUsed=0;
+    }
+    void* p=blocks.back()+blockUsed;
+    blockUsed+=size;
+    allocatedBytes+=size;
+    refCount.fetch_add(1);
+    return p;
+}
+
+void JKMathParser::jkmpNodeArena::release(size_t count)
+{
+    if (refCount.fetch_sub(count)==count) delete this;
+}
+
+JKMathParser::jkmpNodeArena *JKMathParser::jkmpNodeArena::current()
+{
+    return jkmpNodeArena_current;
+}
+
+JKMathParser::jkmpNodeArenaScope::jkmpNodeArenaScope()
+{
+    arena=new jkmpNodeArena();
+    arena->retain();
+    previous=jkmpNodeArena_current;
+    jkmpNodeArena_current=arena;
+}
+
+JKMathParser::jkmpNodeArenaScope::~jkmpNodeArenaScope()
+{
+    jkmpNodeArena_current=previous;
+    arena->release();
+}
+
+void *JKMathParser::jkmpNode::operator new(size_t size)
+{
+    jkmpNodeArena* arena=jkmpNodeArena_current;
+    jkmpNodeAllocHeader* h;
+    if (arena) {
+        h=static_cast<jkmpNodeAllocHeader*>(arena->allocate(sizeof(jkmpNodeAllocHeader)+size));
+    } else {
+        h=static_cast<jkmpNodeAllocHeader*>(::operator new(sizeof(jkmpNodeAllocHeader)+size));
+    }
+    h->arena=arena;
+    return h+1;
+}
+
+void JKMathParser::jkmpNode::operator delete(void *p)
+{
+    if (!p) return;
+    jkmpNodeAllocHeader* h=static_cast<jkmpNodeAllocHeader*>(p)-1;
+    if (h->arena) {
+        h->arena->release();
+    } else {
+        ::operator delete(h);
+    }
+}
+
+void JKMathParser::jkmpNode::deleteTree(jkmpNode *node)
+{
+    if (!node) return;
+    if (jkmpNode_teardownActive) {
+        // called from a destructor during a teardown: the outermost call deletes the node
+        jkmpNode_teardownPending.push_back(node);
+        return;
+    }
+    jkmpNode_teardownActive=true;
+    std::vector<jkmpNode*>& pending=jkmpNode_teardownPending;
+    JKMP::vector<jkmpNode**> slots;
+    jkmpNodeArena* releaseArena=NULL;
+    size_t releaseCount=0;
+    pending.push_back(node);
+    while (pending.size()>0) {
+        jkmpNode* n=pending.back();
+        pending.pop_back();
+        jkmpNodeAllocHeader* h=reinterpret_cast<jkmpNodeAllocHeader*>(n)-1;
+        if (h->arena && n->isTriviallyOwned()) {
+            slots.clear();
+            n->getChildSlots(slots);
+            for (size_t i=0; i<slots.size(); i++) {
+                if (*(slots[i])) pending.push_back(*(slots[i]));
+            }
+            // skip the destructor and collect the references to the arena
+            if (h->arena!=releaseArena) {
+                if (releaseArena) releaseArena->release(releaseCount);
+                releaseArena=h->arena;
+                releaseCount=0;
+            }
+            releaseCount++;
+        } else {
+            delete n;
+        }
+    }
+    if (releaseArena) releaseArena->release(releaseCount);
+    jkmpNode_teardownActive=false;
+}
+
 jkmpResult JKMathParser::jkmpNode::evaluate()
 {
     jkmpResult res;
@@ -5343,8 +8173,8 @@ JKMP::string JKMathParser::jkmpNode::printTree(int /*level*/) const
 
 JKMathParser::jkmpVectorAccessNode::~jkmpVectorAccessNode()
 {
-    if (index) delete index;
-    if (left) delete left;
+    if (index) deleteTree(index);
+    if (left) deleteTree(left);
 }
 
 JKMathParser::jkmpVectorAccessNode::jkmpVectorAccessNode(JKMathParser::jkmpNode *left, JKMathParser::jkmpNode *index, JKMathParser *p, JKMathParser::jkmpNode *par):
@@ -5358,16 +8188,23 @@ JKMathParser::jkmpVectorAccessNode::jkmpVectorAccessNode(JKMathParser::jkmpNode
 
 void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
 {
-    jkmpResult  idx, var;
+    jkmpResult  idx, value;
     if (index) index->evaluate(idx);
     res.isValid=true;
 
-    if (left) left->evaluate(var);
+    // struct items (e.g. cfg.data[5]) are indexed in place, without copying the item
+    const jkmpStructAccessNode* structAccess=dynamic_cast<const jkmpStructAccessNode*>(left);
+    const jkmpResult* ref=(structAccess)?structAccess->resolveReference():NULL;
+    if (!ref) {
+        if (left) left->evaluate(value);
+        ref=&value;
+    }
+    const jkmpResult& var=*ref;
     if (var.type==jkmpList) {
         if (idx.convertsToBoolVector()) {
             JKMP::vector<bool> ii=idx.asBoolVector();
             if (ii.size()!=var.listData.size()) {
-                getParser()->jkmpError(JKMP::_("list element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.listData.size()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("list element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.listData.size()));
                 res.setInvalid();
                 return;
             }
@@ -5386,7 +8223,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
         } else if (idx.convertsToIntVector()) {
             JKMP::vector<int> ii=idx.asIntVector();
             if (ii.size()==0) {
-                getParser()->jkmpError(JKMP::_("list element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("list element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
                 res.setInvalid();
                 return;
             }
@@ -5395,7 +8232,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
                 if (ii[i]>=0 && ii[i]<var.listData.size()) {
                     res.listData[i]=var.listData[ii[i]];
                 } else {
-                    getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to access element %1, but list has only %2 elements").arg(ii[i]).arg(var.listData.size()));
+                    JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to access element %1, but list has only %2 elements").arg(ii[i]).arg(var.listData.size()));
                     res.setInvalid();
                     return;
                 }
@@ -5403,7 +8240,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
             if (res.listData.size()==1) res=res.listData[0];
 
         } else {
-            getParser()->jkmpError(JKMP::_("list element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("list element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
             res.setInvalid();
             return;
         }
@@ -5411,7 +8248,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
         if (idx.convertsToBoolVector()) {
             JKMP::vector<bool> ii=idx.asBoolVector();
             if (ii.size()!=var.numVec.size()) {
-                getParser()->jkmpError(JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
                 res.setInvalid();
                 return;
             }
@@ -5430,7 +8267,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
         } else if (idx.convertsToIntVector()) {
             JKMP::vector<int> ii=idx.asIntVector();
             if (ii.size()==0) {
-                getParser()->jkmpError(JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
                 res.setInvalid();
                 return;
             }
@@ -5440,7 +8277,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
                 if (ii[i]>=0 && ii[i]<var.numVec.size()) {
                     res.numVec[i]=var.numVec[ii[i]];
                 } else {
-                    getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to access element %1, but vector has only %2 elements").arg(ii[i]).arg(var.numVec.size()));
+                    JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to access element %1, but vector has only %2 elements").arg(ii[i]).arg(var.numVec.size()));
                     res.setInvalid();
                     return;
                 }
@@ -5448,7 +8285,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
             if (res.numVec.size()==1) res.setDouble(res.numVec[0]);
 
         } else {
-            getParser()->jkmpError(JKMP::_("vector element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
             res.setInvalid();
             return;
         }
@@ -5456,7 +8293,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
         if (idx.convertsToBoolVector()) {
             JKMP::vector<bool> ii=idx.asBoolVector();
             if (ii.size()!=var.strVec.size()) {
-                getParser()->jkmpError(JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
                 res.setInvalid();
                 return;
             }
@@ -5475,7 +8312,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
         } else if (idx.convertsToIntVector()) {
             JKMP::vector<int> ii=idx.asIntVector();
             if (ii.size()==0) {
-                getParser()->jkmpError(JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
                 res.setInvalid();
                 return;
             }
@@ -5486,7 +8323,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
                 if (ii[i]>=0 && ii[i]<var.strVec.size()) {
                     res.strVec<<var.strVec[ii[i]];
                 } else {
-                    getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to access element %1, but vector has only %2 elements").arg(ii[i]).arg(var.strVec.size()));
+                    JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to access element %1, but vector has only %2 elements").arg(ii[i]).arg(var.strVec.size()));
                     res.setInvalid();
                     return;
                 }
@@ -5494,7 +8331,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
             if (res.strVec.size()==1) res.setString(res.strVec[0]);
 
         } else {
-            getParser()->jkmpError(JKMP::_("vector element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
             res.setInvalid();
             return;
         }
@@ -5502,7 +8339,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
         if (idx.convertsToBoolVector()) {
             JKMP::vector<bool> ii=idx.asBoolVector();
             if (ii.size()!=var.boolVec.size()) {
-                getParser()->jkmpError(JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
                 res.setInvalid();
                 return;
             }
@@ -5521,7 +8358,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
         } else if (idx.convertsToIntVector()) {
             JKMP::vector<int> ii=idx.asIntVector();
             if (ii.size()==0) {
-                getParser()->jkmpError(JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
                 res.setInvalid();
                 return;
             }
@@ -5531,7 +8368,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
                 if (ii[i]>=0 && ii[i]<var.boolVec.size()) {
                     res.boolVec[i]=var.boolVec[ii[i]];
                 } else {
-                    getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to access element %1, but vector has only %2 elements").arg(ii[i]).arg(var.boolVec.size()));
+                    JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to access element %1, but vector has only %2 elements").arg(ii[i]).arg(var.boolVec.size()));
                     res.setInvalid();
                     return;
                 }
@@ -5539,7 +8376,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
             if (res.boolVec.size()==1) res.setBoolean(res.boolVec[0]);
 
         } else {
-            getParser()->jkmpError(JKMP::_("vector element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
             res.setInvalid();
             return;
         }
@@ -5547,7 +8384,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
         if (idx.convertsToBoolVector()) {
             JKMP::vector<bool> ii=idx.asBoolVector();
             if (ii.size()!=var.str.size()) {
-                getParser()->jkmpError(JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access by boolean-vectors needs a boolean vector of the same size, as the data vector, but: index: %1, data: %2 elements").arg(ii.size()).arg(var.numVec.size()));
                 res.setInvalid();
                 return;
             }
@@ -5566,7 +8403,7 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
         } else if (idx.convertsToIntVector()) {
             JKMP::vector<int> ii=idx.asIntVector();
             if (ii.size()==0) {
-                getParser()->jkmpError(JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element access needs non-empty number vector as index, but index is %1").arg(idx.toTypeString()));
                 res.setInvalid();
                 return;
             }
@@ -5576,19 +8413,19 @@ void JKMathParser::jkmpVectorAccessNode::evaluate(jkmpResult &res)
                 if (ii[i]>=0 && ii[i]<var.str.size()) {
                     res.str+=var.str[ii[i]];
                 } else {
-                    getParser()->jkmpError(JKMP::_("OUT OF RANGE: trying to access element %1, but string has only %2 elements").arg(ii[i]).arg(var.str.size()));
+                    JKMATHPARSER_ERROR(getParser(), JKMP::_("OUT OF RANGE: trying to access element %1, but string has only %2 elements").arg(ii[i]).arg(var.str.size()));
                     res.setInvalid();
                     return;
                 }
             }
 
         } else {
-            getParser()->jkmpError(JKMP::_("string character access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("string character access needs number/number vector or boolean/boolean vector as index, but index is %1").arg(resultTypeToString(idx.type)));
             res.setInvalid();
             return;
         }
     } else {
-        getParser()->jkmpError(JKMP::_("vector element/string character access is only possible if the expression is a number/string/bool vector, or a string, but expression is of type %1").arg(resultTypeToString(var.type)));
+        JKMATHPARSER_ERROR(getParser(), JKMP::_("vector element/string character access is only possible if the expression is a number/string/bool vector, or a string, but expression is of type %1").arg(resultTypeToString(var.type)));
         res.setInvalid();
         return;
     }
@@ -5599,6 +8436,20 @@ JKMathParser::jkmpNode *JKMathParser::jkmpVectorAccessNode::copy(JKMathParser::j
     return new jkmpVectorAccessNode(left->copy(NULL), index->copy(NULL), getParser(), par);
 }
 
+JKMathParser::jkmpNode *JKMathParser::jkmpVectorAccessNode::specializeTypes()
+{
+    jkmpSpecializeChild(left, this);
+    jkmpSpecializeChild(index, this);
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpVectorAccessNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (left) slots.push_back(&left);
+    if (index) slots.push_back(&index);
+}
+
 JKMP::string JKMathParser::jkmpVectorAccessNode::print() const
 {
     return JKMP::string("(%1)[%2]").arg(left->print()).arg(index->print());
@@ -5612,7 +8463,7 @@ JKMP::string JKMathParser::jkmpVectorAccessNode::printTree(int level) const
 
 JKMathParser::jkmpStructAccessNode::~jkmpStructAccessNode()
 {
-    if (left) delete left;
+    if (left) deleteTree(left);
 }
 
 JKMathParser::jkmpStructAccessNode::jkmpStructAccessNode(JKMathParser::jkmpNode *left, const JKMP::string &index, JKMathParser *p, JKMathParser::jkmpNode *par):
@@ -5623,8 +8474,30 @@ JKMathParser::jkmpStructAccessNode::jkmpStructAccessNode(JKMathParser::jkmpNode
     if (left) left->setParent(this);
 }
 
+const jkmpResult *JKMathParser::jkmpStructAccessNode::resolveReference() const
+{
+    const JKMP::flatmap<JKMP::string,jkmpResult>* data=NULL;
+    if (const jkmpVariableNode* v=dynamic_cast<const jkmpVariableNode*>(left)) {
+        const jkmpVariable* def=parser->environment.getVariablePointer(v->getSymbol());
+        if (def && def->getType()==jkmpStruct) data=def->getStructData();
+    } else if (const jkmpStructAccessNode* s=dynamic_cast<const jkmpStructAccessNode*>(left)) {
+        const jkmpResult* r=s->resolveReference();
+        if (r && r->type==jkmpStruct) data=&(r->structData);
+    }
+    if (!data) return NULL;
+    auto it=data->find(index);
+    if (it==data->end()) return NULL;
+    return &(it->second);
+}
+
 void JKMathParser::jkmpStructAccessNode::evaluate(jkmpResult &result)
 {
+    const jkmpResult* ref=resolveReference();
+    if (ref) {
+        result=*ref;
+        return;
+    }
+
     jkmpResult var;
 
     if (left) left->evaluate(var);
@@ -5633,13 +8506,13 @@ void JKMathParser::jkmpStructAccessNode::evaluate(jkmpResult &result)
             result=var.structData[index];
             return;
         } else {
-            getParser()->jkmpError(JKMP::_("struct element access: item '%1' does not exist (available elements: %2).").arg(index).arg(JKMP::stringVector(var.structData.keys()).join(", ")));
+            JKMATHPARSER_ERROR(getParser(), JKMP::_("struct element access: item '%1' does not exist (available elements: %2).").arg(index).arg(JKMP::stringVector(var.structData.keys()).join(", ")));
             result.setInvalid();
             return;
         }
 
     } else {
-        getParser()->jkmpError(JKMP::_("struct element access: left-hand-side expression hast to be a struct, but expression is of type %1").arg(resultTypeToString(var.type)));
+        JKMATHPARSER_ERROR(getParser(), JKMP::_("struct element access: left-hand-side expression hast to be a struct, but expression is of type %1").arg(resultTypeToString(var.type)));
         result.setInvalid();
         return;
     }
@@ -5650,6 +8523,18 @@ JKMathParser::jkmpNode *JKMathParser::jkmpStructAccessNode::copy(JKMathParser::j
     return new jkmpStructAccessNode(left->copy(NULL), index, getParser(), par);
 }
 
+JKMathParser::jkmpNode *JKMathParser::jkmpStructAccessNode::specializeTypes()
+{
+    jkmpSpecializeChild(left, this);
+    inferType();
+    return this;
+}
+
+void JKMathParser::jkmpStructAccessNode::getChildSlots(JKMP::vector<JKMathParser::jkmpNode **> &slots)
+{
+    if (left) slots.push_back(&left);
+}
+
 JKMP::string JKMathParser::jkmpStructAccessNode::print() const
 {
     return JKMP::string("(%1).%2").arg(left->print()).arg(index);
@@ -5669,7 +8554,7 @@ void JKMathParser::jkmpListConstruction::evaluate(jkmpResult &res)
             list[i]->evaluate(res.listData.back());
             if (!res.listData.back().isValid) {
                 res.setInvalid();
-                getParser()->jkmpError(JKMP::_("list construction node: trying to add invalid item (%1. item) to a list").arg(i+1));
+                JKMATHPARSER_ERROR(getParser(), JKMP::_("list construction node: trying to add invalid item (%1. item) to a list").arg(i+1));
                 return;
             }
         }
@@ -5689,9 +8574,20 @@ JKMathParser::jkmpNode *JKMathParser::jkmpListConstruction::copy(JKMathParser::j
     return n;
 }
 
+int JKMathParser::jkmpListConstruction::inferType()
+{
+    inferredType=jkmpList;
+    return inferredType;
+}
+
+void JKMathParser::jkmpListConstruction::createFlatProgram(JKMathParser::FlatProgram &program)
+{
+    jkmpNode::createFlatProgram(program);
+}
+
 bool JKMathParser::jkmpListConstruction::createByteCode(JKMathParser::ByteCodeProgram &/*program*/, JKMathParser::ByteCodeEnvironment */*environment*/)
 {
-    if (getParser()) getParser()->jkmpError(JKMP::_("no list constructs in byte-code allowed"));
+    if (getParser()) JKMATHPARSER_ERROR(getParser(), JKMP::_("no list constructs in byte-code allowed"));
     return false;
 }
 
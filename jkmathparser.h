@@ -39,13 +39,56 @@
 #include <map>
 #include <string>
 #include <set>
+#include <memory>
+#include <unordered_map>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <regex>
 
 #include "jkmptools.h"
 #include "jkmpbase.h"
 #include "jkmpstringtools.h"
+#include "jkmpthreadtools.h"
+#include "jkmpregexptools.h"
+#include "jkmpffttools.h"
 
 #include "extlibs/MersenneTwister.h"
 
+/** \brief number of vector elements that a jkmpFusedVectorNode processes in one block */
+#ifndef JKMATHPARSER_FUSEDVECTOR_BLOCKSIZE
+#  define JKMATHPARSER_FUSEDVECTOR_BLOCKSIZE 256
+#endif
+
+/** \brief number of loop items that a vectorized loop (see jkmpVectorOperationNode) processes as one vector */
+#ifndef JKMATHPARSER_VECTORIZEDLOOP_BLOCKSIZE
+#  define JKMATHPARSER_VECTORIZEDLOOP_BLOCKSIZE 4096
+#endif
+
+/** \brief default of JKMathParser::setRegExpCacheSize() */
+#ifndef JKMATHPARSER_REGEXPCACHE_SIZE
+#  define JKMATHPARSER_REGEXPCACHE_SIZE 64
+#endif
+
+/** \brief default of JKMathParser::setFFTPlanCacheSize() */
+#ifndef JKMATHPARSER_FFTPLANCACHE_SIZE
+#  define JKMATHPARSER_FFTPLANCACHE_SIZE 16
+#endif
+
+/** \brief if defined, the parser does not store or format error messages: errors are still counted and recorded with their
+ *         JKMathParser::jkmpErrorCode, but JKMathParser::getLastErrors() only returns generic texts (e.g. <code>error #1</code>) */
+//#define JKMATHPARSER_NO_ERROR_MESSAGES
+
+/** \brief reports the error message \a ... (an expression that results in a JKMP::string) to the JKMathParser \a parser, see JKMathParser::jkmpError()
+ *
+ *  If JKMATHPARSER_NO_ERROR_MESSAGES is defined, the message expression is not evaluated at all, so reporting an error does not format or allocate a string.
+ */
+#ifdef JKMATHPARSER_NO_ERROR_MESSAGES
+#  define JKMATHPARSER_ERROR(parser, ...) (parser)->jkmpError(JKMathParser::jkmpErrorMessage)
+#else
+#  define JKMATHPARSER_ERROR(parser, ...) (parser)->jkmpError(__VA_ARGS__)
+#endif
+
 
 /**
  * \defgroup jkmpmain main function parser class
@@ -444,10 +487,148 @@ class JKMPLIB_EXPORT JKMathParser
         typedef JKMP::vector<ByteCodeInstruction> ByteCodeProgram;
 
         double evaluateBytecode(const ByteCodeProgram &program);
+        /** \brief evaluates \a program, using \a resultStack and \a heap as working memory, which may be reused between calls (e.g. in loops).
+         *         The caller may initialize heap items (e.g. variables reserved with ByteCodeEnvironment::pushVar() ) before the call. */
+        double evaluateBytecode(const ByteCodeProgram &program, JKMP::vector<double>& resultStack, JKMP::vector<double>& heap);
         static JKMP::string printBytecode(const ByteCodeInstruction& instruction);
         static JKMP::string printBytecode(const ByteCodeProgram& program);
 
         /*@}*/
+
+
+        /*! \defgroup jkmpflatprogram non-recursive evaluation of parse trees
+            \ingroup jkmplib_mathtools_parser
+
+            jkmpNode::evaluate() recurses through the tree and creates temporary jkmpResult objects on every level. As an alternative
+            a tree may be linearised into a FlatProgram (a post-order list of FlatInstruction) with jkmpNode::createFlatProgram(). This
+            program is then run by evaluateFlatProgram() on a stack of jkmpResult slots that are preallocated and reused between runs.
+
+            Unlike the bytecode (see \ref jkmpbytecode), a FlatProgram supports all datatypes. Node types that are not linearised
+            (e.g. loops or vector accesses) are evaluated with their recursive jkmpNode::evaluate() as a single instruction. Calls of
+            user-defined functions (and their recursion) are executed on an explicit frame stack, so deep recursion does not consume
+            C-stack.
+         */
+        /*@{*/
+
+        /** \brief instructions of a FlatProgram */
+        enum FlatOpcodes {
+            flatNOP,
+            flatEvalNode,        /*!< \brief push the result of \c node->evaluate() */
+            flatReserve,         /*!< \brief push an (uninitialized) slot that is used as result of a later instruction */
+            flatPop,             /*!< \brief remove the topmost slot */
+            flatUnary,           /*!< \brief apply unary operation \c intpar to the topmost slot, write the result to the slot below (reserved) and pop */
+            flatBinaryArithmetic,/*!< \brief apply binary arithmetic operation \c intpar to the two topmost slots, write the result to the (reserved) slot below them */
+            flatCompare,         /*!< \brief apply comparison \c intpar to the two topmost slots, write the result to the (reserved) slot below them */
+            flatBinaryBool,      /*!< \brief apply logic operation \c intpar to the two topmost slots, write the result to the (reserved) slot below them */
+            flatCallC,           /*!< \brief call the C-function of the jkmpFunctionNode \c node with the \c intpar topmost slots as parameters, write the result to the (reserved) slot below them */
+            flatCallUser,        /*!< \brief call the user-defined function of the jkmpFunctionNode \c node with the \c intpar topmost slots as parameters */
+            flatAssignVariable,  /*!< \brief assign the topmost slot to the variable \c strpar (the slot stays on the stack) */
+            flatJump,            /*!< \brief continue at instruction \c intpar */
+            flatJumpIfNot,       /*!< \brief pop the topmost (boolean) slot and continue at instruction \c intpar if it is \c false. If it is not boolean, report an error, replace it by an invalid result and continue at \c intpar2 */
+            flatPushInvalid      /*!< \brief push an invalid result */
+        };
+
+        /** \brief a single instruction of a FlatProgram */
+        struct JKMPLIB_EXPORT FlatInstruction {
+            public:
+                FlatInstruction(FlatOpcodes opcode=flatNOP, jkmpNode* node=NULL, int intpar=0, int intpar2=0);
+                FlatOpcodes opcode;
+                jkmpNode* node;
+                int intpar;
+                int intpar2;
+                JKMP::string strpar;
+        };
+
+        /** \brief a linearised (post-order) parse tree, see \ref jkmpflatprogram */
+        struct JKMPLIB_EXPORT FlatProgram {
+            public:
+                FlatProgram();
+                /** \brief the instructions */
+                JKMP::vector<FlatInstruction> instructions;
+                /** \brief maximum number of stack slots used by the program (without the stack of called functions) */
+                int stackSize;
+                /** \brief current stack depth while building the program */
+                int stackDepth;
+
+                /** \brief append an instruction that changes the stack depth by \a stackChange, returns its index */
+                int add(const FlatInstruction& instruction, int stackChange);
+                /** \brief index of the next instruction to be added */
+                inline int nextIndex() const { return static_cast<int>(instructions.size()); }
+                inline size_t size() const { return instructions.size(); }
+                void clear();
+        };
+
+        /** \brief evaluates a FlatProgram, created by jkmpNode::createFlatProgram() */
+        void evaluateFlatProgram(jkmpResult& result, const FlatProgram& program);
+        /** \brief linearises \a node into a FlatProgram and evaluates it */
+        jkmpResult evaluateFlat(jkmpNode* node);
+        static JKMP::string printFlatProgram(const FlatInstruction& instruction);
+        static JKMP::string printFlatProgram(const FlatProgram& program);
+
+        /*@}*/
+
+
+        /*! \defgroup jkmpfusedvector fused evaluation of element-wise vector expressions
+            \ingroup jkmplib_mathtools_parser
+
+            Evaluating an expression like <code>a*b+c*d-e/f</code> over vectors with jkmpNode::evaluate() creates a temporary
+            vector for every single operation. The type inference pass (jkmpNode::specializeTypes(), which parse() runs on every tree, see
+            JKMathParser::setTypeSpecialization() ) therefore replaces maximal
+            subtrees of element-wise operations by a jkmpFusedVectorNode, if they operate on vectors of numbers. Element-wise operations are
+            \c + \c - \c * \c / \c ^ , the unary \c - , comparisons (only as the root of a subtree) and calls of functions that have a simple
+            1-parameter C implementation (e.g. \c sin(x) , see JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC() ).
+            Operands of the form <code>start:delta:end</code> are not materialised, but generated block by block from a jkmpRange.
+
+            The operands of the subtree are evaluated once. Then all operations are executed in a single pass over the vectors,
+            in blocks of JKMATHPARSER_FUSEDVECTOR_BLOCKSIZE elements, and the result is written directly into the output vector.
+            If the operands do not have the expected types at runtime (or differ in length), the operations are applied one after
+            the other with the generic implementations, which also report the errors.
+         */
+        /*@{*/
+
+        /** \brief instructions of a FusedVectorProgram */
+        enum FusedVectorOpcodes {
+            fusedOperand,          /*!< \brief push operand \c intpar */
+            fusedNegate,           /*!< \brief negate the topmost value (the jkmpUnaryNode \c node) */
+            fusedBinaryArithmetic, /*!< \brief apply the arithmetic operation \c intpar (of the jkmpBinaryArithmeticNode \c node) to the two topmost values */
+            fusedCompare,          /*!< \brief apply the comparison \c intpar (of the jkmpCompareNode \c node) to the two topmost values, always the last instruction */
+            fusedFunction          /*!< \brief apply the function of the jkmpFunctionNode \c node to the topmost value */
+        };
+
+        /** \brief a single instruction of a FusedVectorProgram */
+        struct JKMPLIB_EXPORT FusedVectorInstruction {
+            public:
+                FusedVectorInstruction(FusedVectorOpcodes opcode=fusedOperand, jkmpNode* node=NULL, int intpar=0);
+                FusedVectorOpcodes opcode;
+                jkmpNode* node;
+                int intpar;
+        };
+
+        /** \brief the element-wise operations of a jkmpFusedVectorNode (in post-order), see \ref jkmpfusedvector */
+        struct JKMPLIB_EXPORT FusedVectorProgram {
+            public:
+                FusedVectorProgram();
+                /** \brief the instructions */
+                JKMP::vector<FusedVectorInstruction> instructions;
+                /** \brief the operands, these are evaluated with jkmpNode::evaluate() */
+                JKMP::vector<jkmpNode*> operands;
+                /** \brief maximum number of stack slots used by the program */
+                int stackSize;
+                /** \brief current stack depth while building the program */
+                int stackDepth;
+                /** \brief nesting depth of the operation that is currently added (0 for the root of the subtree) */
+                int depth;
+
+                /** \brief append an instruction that changes the stack depth by \a stackChange */
+                void add(const FusedVectorInstruction& instruction, int stackChange);
+                /** \brief add \a node as an operand */
+                void addOperand(jkmpNode* node);
+                /** \brief number of operations (i.e. instructions that are not operands) */
+                int operationCount() const;
+                void clear();
+        };
+
+        /*@}*/
     public:
 
 
@@ -465,6 +646,55 @@ class JKMPLIB_EXPORT JKMathParser
 
         static jkmpResult getInvalidResult();
 
+        /** \brief an interned identifier (name of a variable or function), see internSymbol()
+         *
+         *  The parser interns every identifier once, when the expression is parsed. The nodes and the executionEnvironment are keyed on
+         *  these atoms, so looking up a name during evaluation compares integers instead of strings.
+         */
+        typedef uint32_t jkmpSymbol;
+
+        /** \brief returns the symbol of the identifier \a name, a new symbol is created if \a name was not seen before (thread-safe)
+         *
+         *  The table of symbols is shared by all parsers of the process and only grows: interned names are never released, so programs
+         *  should not intern an unbounded number of different identifiers (e.g. generated names).
+         */
+        static jkmpSymbol internSymbol(const JKMP::string& name);
+        /** \brief returns the identifier that was interned as \a symbol (thread-safe without a lock, the reference stays valid for the lifetime of the program) */
+        static const JKMP::string& symbolName(jkmpSymbol symbol);
+
+
+        /** \brief a lazy arithmetic range <code>start:delta:end</code>, i.e. the numbers \c start, \c start+delta, \c start+delta+delta, ...
+         *         that do not pass \c end
+         *
+         *  Loops (jkmpVectorOperationNode, e.g. <code>sum(i, 1, 1e9, f(i))</code>) and fused element-wise operations (see \ref jkmpfusedvector)
+         *  iterate over the range without allocating memory for its elements. It is only materialised by toVector(), if a real vector is required
+         *  (see jkmpVectorConstructionNode). The elements are generated by repeatedly adding \c delta, as in JKMP::construct_vector_range().
+         */
+        struct JKMPLIB_EXPORT jkmpRange {
+            public:
+                jkmpRange(double start=0, double delta=1, double end=0);
+                double start;
+                double delta;
+                double end;
+
+                /** \brief returns \c true, if \a value (a generated element) does not pass \c end, i.e. the loop condition while iterating over the range */
+                inline bool inRange(double value) const { return (delta>0 && value<=end) || (delta<0 && value>=end); }
+                /** \brief returns \c true, if the range has no elements */
+                inline bool isEmpty() const { return !inRange(start); }
+                /** \brief number of elements of the range */
+                int64_t size() const;
+                /** \brief writes \a n elements into \a data, starting with the element \a value, and returns the element following them */
+                inline double generate(double* data, size_t n, double value) const {
+                    for (size_t i=0; i<n; i++) {
+                        data[i]=value;
+                        value=value+delta;
+                    }
+                    return value;
+                }
+                /** \brief materialises the range into \a vec */
+                void toVector(JKMP::vector<double>& vec) const;
+        };
+
 
         /** \brief This struct is for managing variables. Unlike jkmpResult this struct
           * only contains pointers to the data
@@ -481,8 +711,8 @@ class JKMPLIB_EXPORT JKMathParser
                 jkmpVariable(JKMP::vector<double>* ref, int* columnref);
                 jkmpVariable(JKMP::vector<bool>* ref, int* columnref);
                 jkmpVariable(JKMP::stringVector* ref);
-                jkmpVariable(JKMP::map<JKMP::string,jkmpResult>* ref);
-                jkmpVariable(JKMP::vector<jkmpResult>* ref);
+                jkmpVariable(JKMP::flatmap<JKMP::string,jkmpResult>* ref);
+                jkmpVariable(JKMP::sharedvector<jkmpResult>* ref);
                 ~jkmpVariable();
                 JKMPLIB_EXPORT void clearMemory();
                 JKMPLIB_EXPORT jkmpResult toResult() const;
@@ -496,8 +726,8 @@ class JKMPLIB_EXPORT JKMathParser
                 inline JKMP::vector<double>* getNumVec() const { return numVec; }
                 inline JKMP::vector<bool>* getBoolVec() const { return boolVec; }
                 inline JKMP::stringVector* getStrVec() const { return strVec; }
-                inline JKMP::map<JKMP::string,jkmpResult>* getStructData() const { return structData; }
-                inline JKMP::vector<jkmpResult>* getListData() const { return listData; }
+                inline JKMP::flatmap<JKMP::string,jkmpResult>* getStructData() const { return structData; }
+                inline JKMP::sharedvector<jkmpResult>* getListData() const { return listData; }
                 inline int* getColumns() const { return matrix_columns; }
 
 
@@ -510,8 +740,8 @@ class JKMPLIB_EXPORT JKMathParser
                 JKMP::vector<double>* numVec; /*!< \brief this points to the variable data if \c type==jkmpDoubleVector */
                 JKMP::vector<bool>* boolVec; /*!< \brief this points to the variable data if \c type==jkmpBoolVector */
                 JKMP::stringVector* strVec; /*!< \brief this points to the variable data if \c type==jkmpStringVector */
-                JKMP::map<JKMP::string,jkmpResult>* structData;
-                JKMP::vector<jkmpResult>* listData;
+                JKMP::flatmap<JKMP::string,jkmpResult>* structData;
+                JKMP::sharedvector<jkmpResult>* listData;
                 int* matrix_columns;
         };
 
@@ -528,6 +758,72 @@ class JKMPLIB_EXPORT JKMathParser
          */
         /*@{*/
 
+        /**
+         * \brief bump allocator that owns the memory of all nodes of one parse result (or of one copied function body)
+         *
+         * While a jkmpNodeArenaScope is active on the current thread, every \c new of a jkmpNode is served from the
+         * arena of that scope: nodes are placed back-to-back in a few large blocks (in creation order, which is roughly
+         * evaluation order). Deleting a node does not free memory: the blocks are released together, once the scope has
+         * ended and the last node living in the arena has been deleted. Subtrees are torn down by jkmpNode::deleteTree():
+         * the destructors of nodes that own nothing but their children (see jkmpNode::isTriviallyOwned()) are skipped,
+         * their references to the arena are dropped in bulk.
+         *
+         * Only the thread that owns the active jkmpNodeArenaScope allocates from an arena, but nodes (e.g. copies used by
+         * the parallel vector operations) may be deleted on any thread, so the reference count is atomic.
+         *
+         * Nodes that are created while no scope is active are allocated from the global heap, as before.
+         */
+        class JKMPLIB_EXPORT jkmpNodeArena {
+            public:
+                jkmpNodeArena();
+                ~jkmpNodeArena();
+
+                /** \brief allocate \a size bytes (aligned for any node type) and add a reference to the arena */
+                void* allocate(size_t size);
+                /** \brief add a reference to the arena */
+                inline void retain() { refCount.fetch_add(1); }
+                /** \brief remove \a count references from the arena and delete it, when the last reference is gone */
+                void release(size_t count=1);
+                /** \brief number of bytes, allocated from the arena so far */
+                inline size_t getAllocatedBytes() const { return allocatedBytes; }
+                /** \brief number of memory blocks of the arena */
+                inline size_t getBlockCount() const { return blocks.size(); }
+
+                /** \brief the arena that is currently used by jkmpNode::operator new on this thread (or NULL) */
+                static jkmpNodeArena* current();
+            protected:
+                friend class jkmpNodeArenaScope;
+                /** \brief size of a single memory block */
+                enum { BlockSize=16384 };
+                /** \brief the memory blocks of the arena */
+                std::vector<char*> blocks;
+                /** \brief bump pointer into the current (last) block */
+                size_t blockUsed;
+                /** \brief size of the current (last) block */
+                size_t blockSize;
+                /** \brief number of bytes, allocated so far */
+                size_t allocatedBytes;
+                /** \brief number of live nodes in the arena, plus one while a jkmpNodeArenaScope uses it */
+                std::atomic<size_t> refCount;
+        };
+
+        /**
+         * \brief RAII guard: creates a new jkmpNodeArena and makes it the current arena of this thread,
+         *        until the guard goes out of scope (then the previously active arena is restored).
+         */
+        class JKMPLIB_EXPORT jkmpNodeArenaScope {
+            public:
+                jkmpNodeArenaScope();
+                ~jkmpNodeArenaScope();
+                /** \brief the arena of this scope */
+                inline jkmpNodeArena* getArena() const { return arena; }
+            private:
+                jkmpNodeArena* arena;
+                jkmpNodeArena* previous;
+                jkmpNodeArenaScope(const jkmpNodeArenaScope&);
+                jkmpNodeArenaScope& operator=(const jkmpNodeArenaScope&);
+        };
+
         /**
          * \brief This class is the abstract base class for nodes.
          * All allowed node types must inherit from jkmpNode
@@ -536,11 +832,27 @@ class JKMPLIB_EXPORT JKMathParser
           protected:
             JKMathParser* parser;  /*!< \brief points to the parser object that is used to evaluate this node */
             jkmpNode* parent;      /*!< \brief points to the parent node */
+            int inferredType;      /*!< \brief result type, determined by inferType() (a jkmpResultType), or 0 if unknown */
           public:
-            explicit jkmpNode(JKMathParser* parser, jkmpNode* parent=NULL) { this->parser=parser;  this->parent=parent; }
+            explicit jkmpNode(JKMathParser* parser, jkmpNode* parent=NULL) { this->parser=parser;  this->parent=parent; inferredType=0; }
             /** \brief virtual class destructor */
             virtual ~jkmpNode() {}
 
+            /** \brief allocates nodes from the current jkmpNodeArena (if any) or from the heap */
+            static void* operator new(size_t size);
+            /** \brief releases a node, allocated with jkmpNode::operator new() */
+            static void operator delete(void* p);
+            /** \brief deletes the subtree \a node iteratively (with an explicit work list instead of recursive destructors).
+             *
+             *  Node destructors pass their children to this function. Arena nodes that return \c true from isTriviallyOwned()
+             *  are not destroyed at all: their children are taken from getChildSlots() and their memory is returned to the
+             *  jkmpNodeArena in bulk.
+             */
+            static void deleteTree(jkmpNode* node);
+            /** \brief returns \c true, if this node owns nothing except the children reported by getChildSlots(), so its destructor
+             *         may be skipped by deleteTree(). Subclasses that add members with a non-trivial destructor have to return \c false. */
+            virtual bool isTriviallyOwned() const { return false; }
+
             /** \brief evaluate this node */
             virtual jkmpResult evaluate();
 
@@ -566,6 +878,33 @@ class JKMPLIB_EXPORT JKMathParser
 
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& /*program*/, ByteCodeEnvironment* /*environment*/) { ;return false; }
+            /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram). The default implementation evaluates the node (recursively) in a single instruction. */
+            virtual void createFlatProgram(FlatProgram& program);
+
+            /** \brief infers the result type of this node from the (already inferred) types of its children, stores and returns it (0 if the type can not be determined) */
+            virtual int inferType();
+            /** \brief returns the result type, as determined by the last call to inferType(), or 0 if it is unknown */
+            inline int getInferredType() const { return inferredType; }
+            /** \brief type inference pass: specializes the children of this node (recursively), infers the type of this node and returns
+             *         either this node, or a type-specialized replacement for it. In the latter case this node is deleted, so always continue with the returned node!
+             *
+             *  parse() runs this pass on its result, unless it is disabled with JKMathParser::setTypeSpecialization(). It may be repeated, when
+             *  the types of the variables have changed:
+             *  \code
+             *      jkmpNode* n=parser.parse("x=[1,2,3]; 2*x+1");
+             *      n=n->specializeTypes();
+             *  \endcode
+             */
+            virtual jkmpNode* specializeTypes();
+            /** \brief returns \c true, if this node is an element-wise operation that can be part of a jkmpFusedVectorNode (see \ref jkmpfusedvector) */
+            virtual bool isElementwiseOperation();
+            /** \brief append the element-wise operations of this subtree to \a program (see \ref jkmpfusedvector). The default implementation adds the node as an operand. */
+            virtual void createFusedVectorProgram(FusedVectorProgram& program);
+            /** \brief appends the direct children of this node to \a children (used by analyses of the tree, see analyseTree()) */
+            void getChildren(JKMP::vector<jkmpNode*>& children);
+            /** \brief appends the addresses of the members that hold the direct children of this node to \a slots, so passes over the tree may replace
+             *         children (see getChildren() and jkmpVectorOperationNode::hoistLoopInvariants()). The default implementation adds nothing. */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
 
             /** \brief print the expression */
             virtual JKMP::string print() const;
@@ -573,6 +912,32 @@ class JKMPLIB_EXPORT JKMathParser
             virtual JKMP::string printTree(int level=0) const;
         };
 
+        /** \brief describes how a subtree uses variables and functions, see analyseTree() */
+        struct JKMPLIB_EXPORT jkmpTreeInfo {
+            public:
+                jkmpTreeInfo();
+                /** \brief names of the variables that are read in the subtree */
+                std::set<JKMP::string> readVariables;
+                /** \brief names of the variables that are assigned in the subtree (also single elements) */
+                std::set<JKMP::string> assignedVariables;
+                /** \brief the subtree defines functions */
+                bool definesFunctions;
+                /** \brief the subtree calls functions whose effects can not be analysed (C-functions of nodes, or functions that do not exist yet) */
+                bool callsUnknownFunctions;
+                /** \brief the subtree calls C-functions that have access to the parser (e.g. \c rand() ), i.e. which are not implemented by a simple function of numbers */
+                bool callsImpureFunctions;
+                /** \brief the subtree calls C-functions that have side effects or non-deterministic results (e.g. \c rand() ), see JKMathParser::setFunctionHasSideEffects() */
+                bool hasSideEffects;
+        };
+
+        /** \brief analyses the subtree \a node and adds the results to \a info
+         *
+         *  The bodies of the user-defined functions that are called in the subtree are analysed as well (variables that are
+         *  local to these functions, i.e. their parameters, are not reported). The bodies of functions that are defined in
+         *  the subtree and the loop variables of nested loops are not taken into account, as they don't affect the enclosing block.
+         */
+        static void analyseTree(jkmpNode* node, jkmpTreeInfo& info);
+
 
         /**
          * \brief This class represents a binary arithmetic operation:
@@ -580,7 +945,7 @@ class JKMPLIB_EXPORT JKMathParser
          *  binary and (&), binary or (|)
          */
         class JKMPLIB_EXPORT jkmpBinaryArithmeticNode: public jkmpNode {
-          private:
+          protected:
             jkmpNode* left, *right;
             JKMP::charType operation;
           public:
@@ -598,11 +963,27 @@ class JKMPLIB_EXPORT JKMathParser
 
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
+            /** \brief apply the operation of this node to the (already evaluated) operands \a l and \a r */
+            virtual void evaluateOperation(jkmpResult& result, const jkmpResult& l, const jkmpResult& r);
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment);
+            /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram) */
+            virtual void createFlatProgram(FlatProgram& program);
+            /** \brief infers the result type of this node from the types of its children */
+            virtual int inferType();
+            /** \brief specializes the children and replaces this node by a jkmpBinaryArithmeticDoubleNode, jkmpBinaryArithmeticVectorScalarNode or jkmpBinaryArithmeticVectorVectorNode, if the operand types are known */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
+            /** \brief returns \c true, see jkmpNode::isTriviallyOwned() */
+            virtual bool isTriviallyOwned() const { return true; }
+            /** \brief returns \c true, if this node is an element-wise operation, see jkmpNode::isElementwiseOperation() */
+            virtual bool isElementwiseOperation();
+            /** \brief append the element-wise operations of this subtree to \a program, see jkmpNode::createFusedVectorProgram() */
+            virtual void createFusedVectorProgram(FusedVectorProgram& program);
 
             /** \brief print the expression */
             virtual JKMP::string print() const;
@@ -611,6 +992,123 @@ class JKMPLIB_EXPORT JKMathParser
 
         };
 
+        /**
+         * \brief binary arithmetic operation (+, -, *, /, ^) of two numbers, created by jkmpBinaryArithmeticNode::specializeTypes()
+         *
+         * The operation is evaluated directly, without the type dispatch in jkmpResult::add() ... Operands of other types (e.g. from a variable that
+         * changed its type since the specialization) are passed on to jkmpBinaryArithmeticNode::evaluateOperation().
+         */
+        class JKMPLIB_EXPORT jkmpBinaryArithmeticDoubleNode: public jkmpBinaryArithmeticNode {
+          public:
+            explicit jkmpBinaryArithmeticDoubleNode(JKMP::charType op, jkmpNode* l, jkmpNode* r, JKMathParser* p, jkmpNode* par);
+            /** \brief apply the operation of this node to the (already evaluated) operands \a l and \a r */
+            virtual void evaluateOperation(jkmpResult& result, const jkmpResult& l, const jkmpResult& r);
+            /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
+            virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief print the expression tree */
+            virtual JKMP::string printTree(int level=0) const;
+        };
+
+        /**
+         * \brief binary arithmetic operation (+, -, *, /, ^) of a vector of numbers and a number (in any order), created by jkmpBinaryArithmeticNode::specializeTypes()
+         *
+         * The result is written directly into the output vector. Operands of other types are passed on to jkmpBinaryArithmeticNode::evaluateOperation().
+         */
+        class JKMPLIB_EXPORT jkmpBinaryArithmeticVectorScalarNode: public jkmpBinaryArithmeticNode {
+          public:
+            explicit jkmpBinaryArithmeticVectorScalarNode(JKMP::charType op, jkmpNode* l, jkmpNode* r, JKMathParser* p, jkmpNode* par);
+            /** \brief apply the operation of this node to the (already evaluated) operands \a l and \a r */
+            virtual void evaluateOperation(jkmpResult& result, const jkmpResult& l, const jkmpResult& r);
+            /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
+            virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief print the expression tree */
+            virtual JKMP::string printTree(int level=0) const;
+        };
+
+        /**
+         * \brief element-wise binary arithmetic operation (+, -, *, /, ^) of two vectors of numbers, created by jkmpBinaryArithmeticNode::specializeTypes()
+         *
+         * Only the vector lengths are checked. Operands of other types are passed on to jkmpBinaryArithmeticNode::evaluateOperation().
+         */
+        class JKMPLIB_EXPORT jkmpBinaryArithmeticVectorVectorNode: public jkmpBinaryArithmeticNode {
+          public:
+            explicit jkmpBinaryArithmeticVectorVectorNode(JKMP::charType op, jkmpNode* l, jkmpNode* r, JKMathParser* p, jkmpNode* par);
+            /** \brief apply the operation of this node to the (already evaluated) operands \a l and \a r */
+            virtual void evaluateOperation(jkmpResult& result, const jkmpResult& l, const jkmpResult& r);
+            /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
+            virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief print the expression tree */
+            virtual JKMP::string printTree(int level=0) const;
+        };
+
+        class jkmpVectorConstructionNode; // forward
+
+        /**
+         * \brief evaluates a subtree of element-wise operations over vectors of numbers in a single pass, created by jkmpNode::specializeTypes()
+         *
+         * See \ref jkmpfusedvector for details.
+         */
+        class JKMPLIB_EXPORT jkmpFusedVectorNode: public jkmpNode {
+          protected:
+            /** \brief the (unfused) subtree, the instructions of \c program point into it */
+            jkmpNode* original;
+            /** \brief the element-wise operations of \c original */
+            FusedVectorProgram program;
+            /** \brief for every operand the jkmpVectorConstructionNode, if it is a range <code>start:delta:end</code>, which is evaluated as a jkmpRange, otherwise \c NULL */
+            JKMP::vector<jkmpVectorConstructionNode*> rangeOperands;
+            /** \brief buffer for the evaluated operands, reused between calls (range operands are marked as void here, if they were evaluated into \c operandRanges) */
+            JKMP::vector<jkmpResult> operandValues;
+            /** \brief buffer for the evaluated range operands, reused between calls */
+            JKMP::vector<jkmpRange> operandRanges;
+            /** \brief buffer for blocks of intermediate results, reused between calls */
+            JKMP::vector<double> scratch;
+            /** \brief indicates that \c operandValues and \c scratch are used by a call of evaluate() */
+            bool buffersInUse;
+
+            /** \brief evaluates the operands into \a values (and \a ranges) and executes the program */
+            void evaluateProgram(jkmpResult& result, JKMP::vector<jkmpResult>& values, JKMP::vector<jkmpRange>& ranges, JKMP::vector<double>& scratchBuffer);
+            /** \brief executes the program in blocks over the vectors in \a values and the ranges in \a ranges, returns \c false (without changing \a result), if the operands do not allow that */
+            bool evaluateBlocked(jkmpResult& result, const JKMP::vector<jkmpResult>& values, const JKMP::vector<jkmpRange>& ranges, JKMP::vector<double>& scratchBuffer);
+            /** \brief executes the program operation by operation with the generic implementations */
+            void evaluateGeneric(jkmpResult& result, JKMP::vector<jkmpResult>& values);
+          public:
+            /** \brief constructor for a jkmpFusedVectorNode
+             *  \param original the subtree of element-wise operations, the new node takes ownership
+             *  \param p a pointer to a JKMathParser object
+             *  \param par a pointer to the parent node
+             */
+            explicit jkmpFusedVectorNode(jkmpNode* original, JKMathParser* p, jkmpNode* par);
+
+            /** \brief standard destructor, also destroy the children (recursively) */
+            virtual ~jkmpFusedVectorNode();
+
+            /** \brief returns a jkmpFusedVectorNode for \a node, if \a node is the root of a subtree with at least two element-wise operations, of which
+             *         at least one operand is a vector of numbers. Otherwise \a node itself is returned.
+             *
+             *  If \a checkParent is \c true, \a node is not fused, if its parent is also an element-wise operation (the parent will then fuse the whole subtree).
+             */
+            static jkmpNode* fuse(jkmpNode* node, bool checkParent=true);
+
+            /** \brief returns the element-wise operations of this node */
+            inline const FusedVectorProgram& getProgram() const { return program; }
+
+            /** \brief evaluate this node, return result as call-by-reference (faster!) */
+            virtual void evaluate(jkmpResult& result);
+            /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
+            virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief create bytecode that evaluates the current node */
+            virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment);
+            /** \brief infers the result type of this node, see jkmpNode::inferType() */
+            virtual int inferType();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
+
+            /** \brief print the expression */
+            virtual JKMP::string print() const;
+            /** \brief print the expression tree */
+            virtual JKMP::string printTree(int level=0) const;
+        };
+
         /**
          * \brief This class represents a binary boolean operation: and, or, xor, nor, nand
          */
@@ -633,11 +1131,23 @@ class JKMPLIB_EXPORT JKMathParser
 
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
+            /** \brief apply the operation of this node to the (already evaluated) operands \a l and \a r */
+            void evaluateOperation(jkmpResult& result, const jkmpResult& l, const jkmpResult& r);
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment);
+            /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram) */
+            virtual void createFlatProgram(FlatProgram& program);
+            /** \brief infers the result type of this node from the types of its children */
+            virtual int inferType();
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
+            /** \brief returns \c true, see jkmpNode::isTriviallyOwned() */
+            virtual bool isTriviallyOwned() const { return true; }
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -668,11 +1178,27 @@ class JKMPLIB_EXPORT JKMathParser
 
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
+            /** \brief apply the operation of this node to the (already evaluated) operands \a l and \a r */
+            void evaluateOperation(jkmpResult& result, const jkmpResult& l, const jkmpResult& r);
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment);
+            /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram) */
+            virtual void createFlatProgram(FlatProgram& program);
+            /** \brief infers the result type of this node from the types of its children */
+            virtual int inferType();
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
+            /** \brief returns \c true, see jkmpNode::isTriviallyOwned() */
+            virtual bool isTriviallyOwned() const { return true; }
+            /** \brief returns \c true, if this node is an element-wise operation, see jkmpNode::isElementwiseOperation() */
+            virtual bool isElementwiseOperation();
+            /** \brief append the element-wise operations of this subtree to \a program, see jkmpNode::createFusedVectorProgram() */
+            virtual void createFusedVectorProgram(FusedVectorProgram& program);
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -703,11 +1229,27 @@ class JKMPLIB_EXPORT JKMathParser
 
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
+            /** \brief apply the operation of this node to the (already evaluated) operand \a result (in-place) */
+            void evaluateOperation(jkmpResult& result);
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL);
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment);
+            /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram) */
+            virtual void createFlatProgram(FlatProgram& program);
+            /** \brief infers the result type of this node from the types of its children */
+            virtual int inferType();
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
+            /** \brief returns \c true, see jkmpNode::isTriviallyOwned() */
+            virtual bool isTriviallyOwned() const { return true; }
+            /** \brief returns \c true, if this node is an element-wise operation, see jkmpNode::isElementwiseOperation() */
+            virtual bool isElementwiseOperation();
+            /** \brief append the element-wise operations of this subtree to \a program, see jkmpNode::createFusedVectorProgram() */
+            virtual void createFusedVectorProgram(FusedVectorProgram& program);
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -721,7 +1263,8 @@ class JKMPLIB_EXPORT JKMathParser
         class JKMPLIB_EXPORT jkmpVariableVectorAccessNode: public jkmpNode {
           protected:
             jkmpNode* index;
-            JKMP::string variable;
+            /** \brief interned name of the accessed variable */
+            jkmpSymbol variableSymbol;
           public:
             /** \brief standard destructor, also destroy the children (recursively)  */
             virtual ~jkmpVariableVectorAccessNode() ;
@@ -733,12 +1276,22 @@ class JKMPLIB_EXPORT JKMathParser
              *  \param par a pointer to the parent node
              */
             explicit jkmpVariableVectorAccessNode(JKMP::string var, jkmpNode* index, JKMathParser* p, jkmpNode* par);
+            /** \brief name of the accessed variable */
+            inline const JKMP::string& getName() const { return symbolName(variableSymbol); }
+            /** \brief interned name of the accessed variable */
+            inline jkmpSymbol getSymbol() const { return variableSymbol; }
 
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
+            /** \brief returns \c true, see jkmpNode::isTriviallyOwned() */
+            virtual bool isTriviallyOwned() const { return true; }
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -771,6 +1324,10 @@ class JKMPLIB_EXPORT JKMathParser
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -796,11 +1353,23 @@ class JKMPLIB_EXPORT JKMathParser
              */
             explicit jkmpStructAccessNode(jkmpNode* left, const JKMP::string& index, JKMathParser* p, jkmpNode* par);
 
+            /** \brief resolves the access path <code>variable.item.item...</code> directly in the storage of the variable, without copying the
+             *         struct(s). Returns a pointer to the accessed item, or \c NULL if the left-hand side is no such path or the item does not exist
+             *         (no error is reported in this case, evaluate() reports it).
+             *
+             *  \note The pointer is only valid until the next change of the variables.
+             */
+            const jkmpResult* resolveReference() const;
+
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -814,7 +1383,8 @@ class JKMPLIB_EXPORT JKMathParser
         class JKMPLIB_EXPORT jkmpVariableAssignNode: public jkmpNode {
           protected:
             jkmpNode* child;
-            JKMP::string variable;
+            /** \brief interned name of the variable to assign to */
+            jkmpSymbol variableSymbol;
           public:
             /** \brief standard destructor, also destroy the children (recursively)  */
             virtual ~jkmpVariableAssignNode() ;
@@ -826,6 +1396,10 @@ class JKMPLIB_EXPORT JKMathParser
              *  \param par a pointer to the parent node
              */
             explicit jkmpVariableAssignNode(JKMP::string var, jkmpNode* c, JKMathParser* p, jkmpNode* par);
+            /** \brief name of the assigned variable */
+            inline const JKMP::string& getName() const { return symbolName(variableSymbol); }
+            /** \brief interned name of the assigned variable */
+            inline jkmpSymbol getSymbol() const { return variableSymbol; }
 
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
@@ -834,6 +1408,14 @@ class JKMPLIB_EXPORT JKMathParser
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment);
+            /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram) */
+            virtual void createFlatProgram(FlatProgram& program);
+            /** \brief infers the result type of this node from the types of its children */
+            virtual int inferType();
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -863,6 +1445,14 @@ class JKMPLIB_EXPORT JKMathParser
 
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
+            /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram) */
+            virtual void createFlatProgram(FlatProgram& program);
+            /** \brief infers the result type of this node, see jkmpNode::inferType() */
+            virtual int inferType();
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
@@ -880,7 +1470,8 @@ class JKMPLIB_EXPORT JKMathParser
         class JKMPLIB_EXPORT jkmpFunctionAssignNode: public jkmpNode {
           private:
             jkmpNode* child;
-            JKMP::string function;
+            /** \brief interned name of the function to define */
+            jkmpSymbol functionSymbol;
             JKMP::stringVector parameterNames;
           public:
             /** \brief standard destructor, also destroy the children (recursively)  */
@@ -894,12 +1485,20 @@ class JKMPLIB_EXPORT JKMathParser
              *  \param par a pointer to the parent node
              */
             explicit jkmpFunctionAssignNode(JKMP::string function, JKMP::stringVector parameterNames, jkmpNode* c, JKMathParser* p, jkmpNode* par);
+            /** \brief name of the defined function */
+            inline const JKMP::string& getName() const { return symbolName(functionSymbol); }
+            /** \brief interned name of the defined function */
+            inline jkmpSymbol getSymbol() const { return functionSymbol; }
 
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment);
             /** \brief print the expression */
@@ -932,6 +1531,8 @@ class JKMPLIB_EXPORT JKMathParser
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment);
+            /** \brief infers the result type of this node, see jkmpNode::inferType() */
+            virtual int inferType();
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -944,7 +1545,8 @@ class JKMPLIB_EXPORT JKMathParser
          */
         class JKMPLIB_EXPORT jkmpVariableNode: public jkmpNode {
           private:
-            JKMP::string var;
+            /** \brief interned name of the variable */
+            jkmpSymbol varSymbol;
           public:
             /** \brief constructor for a jkmpVariableNode
              *  \param name name of the variable
@@ -958,12 +1560,18 @@ class JKMPLIB_EXPORT JKMathParser
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
 
-            inline JKMP::string getName() const { return var; }
+            inline const JKMP::string& getName() const { return symbolName(varSymbol); }
+            /** \brief interned name of the variable */
+            inline jkmpSymbol getSymbol() const { return varSymbol; }
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief returns \c true, see jkmpNode::isTriviallyOwned() */
+            virtual bool isTriviallyOwned() const { return true; }
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment *environment);
+            /** \brief infers the result type of this node, see jkmpNode::inferType() */
+            virtual int inferType();
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -991,6 +1599,8 @@ class JKMPLIB_EXPORT JKMathParser
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief returns \c true, see jkmpNode::isTriviallyOwned() */
+            virtual bool isTriviallyOwned() const { return true; }
                 /** \brief print the expression */
                 virtual JKMP::string print() const;
                 /** \brief print the expression tree */
@@ -1013,11 +1623,11 @@ class JKMPLIB_EXPORT JKMathParser
          * All error handling has to be done inside the function definition. Here is a
          * simple example:
          * \code
-         * jkmpResult Abs(jkmpResult* params, unsigned JKMP::charType n){
+         * jkmpResult Abs(const jkmpResult* params, unsigned int n, JKMathParser* p){
          *   jkmpResult r;
          *   r.type=jkmpDouble;
-         *   if (n!=1) jkmpError("abs accepts 1 argument");
-         *   if (params[0].type!=jkmpDouble) jkmpError("abs needs double argument");
+         *   if (n!=1) JKMATHPARSER_ERROR(p, "abs accepts 1 argument");
+         *   if (params[0].type!=jkmpDouble) JKMATHPARSER_ERROR(p, "abs needs double argument");
          *   r.num=fabs(params[0].num);
          *   return r;
          * }
@@ -1032,6 +1642,8 @@ class JKMPLIB_EXPORT JKMathParser
         typedef double (*jkmpEvaluateFuncSimple1ParamMP)(double, JKMathParser*);
         typedef double (*jkmpEvaluateFuncSimple2ParamMP)(double,double, JKMathParser*);
         typedef double (*jkmpEvaluateFuncSimple3ParamMP)(double,double,double, JKMathParser*);
+        /** \brief vectorized variant of a jkmpEvaluateFuncSimple1Param, which applies the function to the \a n items of \a in and writes the results to \a out (e.g. JKMP::vecSin() ), see setVectorFunction() */
+        typedef void (*jkmpEvaluateFuncVector1Param)(double* out, const double* in, size_t n);
 
         /** \brief This is a function prototype like jkmpEvaluateFunc but returns its result with call by reference
          */
@@ -1050,6 +1662,158 @@ class JKMPLIB_EXPORT JKMathParser
             functionInvalid
         };
 
+        /** \brief statistics of the memoization cache of a user-defined function, see JKMathParser::setMemoizeFunctions() */
+        struct JKMPLIB_EXPORT jkmpFunctionMemoStatistics {
+            public:
+                jkmpFunctionMemoStatistics();
+                /** \brief number of calls that were answered from the cache */
+                uint64_t hits;
+                /** \brief number of calls that evaluated the function (and stored the result) */
+                uint64_t misses;
+                /** \brief number of times the cache was cleared, because a function or a global variable that the function reads changed */
+                uint64_t invalidations;
+                /** \brief current number of cached results */
+                size_t entries;
+                /** \brief indicates that the function was proven pure, i.e. its calls can be memoized */
+                bool pure;
+                /** \brief fraction of the memoized calls that were answered from the cache */
+                inline double hitRate() const { return (hits+misses>0)?(double(hits)/double(hits+misses)):0.0; }
+        };
+
+        /** \brief memoization cache of a user-defined function, see JKMathParser::setMemoizeFunctions()
+         *
+         *  The results are keyed on the bit patterns of the (number) arguments. They are valid for the function generation of the
+         *  environment \c generation and the values \c globalValues of the global variables \c globals that the function reads.
+         */
+        struct JKMPLIB_EXPORT jkmpFunctionMemo {
+            public:
+                /** \brief hash of a key of the cache */
+                struct KeyHash {
+                    inline size_t operator()(const std::vector<uint64_t>& key) const {
+                        uint64_t h=14695981039346656037ULL;
+                        for (size_t i=0; i<key.size(); i++) {
+                            h=(h^key[i])*1099511628211ULL;
+                        }
+                        return static_cast<size_t>(h^(h>>32));
+                    }
+                };
+                jkmpFunctionMemo();
+                /** \brief indicates that \c pure and \c globals were determined for the function generation \c generation */
+                bool analysed;
+                /** \brief function generation of the environment, for which the function was analysed */
+                uint64_t generation;
+                /** \brief the global variables that the function reads */
+                JKMP::vector<jkmpSymbol> globals;
+                /** \brief bit patterns of the values of \c globals, for which the cached results are valid */
+                std::vector<uint64_t> globalValues;
+                /** \brief the cached results */
+                std::unordered_map<std::vector<uint64_t>, jkmpResult, KeyHash> cache;
+                /** \brief statistics */
+                jkmpFunctionMemoStatistics statistics;
+
+                /** \brief clears the cached results, counts an invalidation if there were any */
+                void invalidate();
+        };
+
+        /** \brief statistics of the cache of compiled regular expressions (see JKMathParser::getRegExp() ) or of FFT plans (see JKMathParser::getFFTPlan() ) */
+        struct JKMPLIB_EXPORT jkmpCacheStatistics {
+            public:
+                jkmpCacheStatistics();
+                /** \brief number of requests that were answered from the cache */
+                uint64_t hits;
+                /** \brief number of requests that compiled the pattern/set up the plan */
+                uint64_t misses;
+                /** \brief number of entries that were removed, because the cache was full */
+                uint64_t evictions;
+                /** \brief current number of entries */
+                size_t entries;
+                /** \brief fraction of the requests that were answered from the cache */
+                inline double hitRate() const { return (hits+misses>0)?(double(hits)/double(hits+misses)):0.0; }
+        };
+        typedef jkmpCacheStatistics jkmpRegExpCacheStatistics;
+        typedef jkmpCacheStatistics jkmpFFTPlanCacheStatistics;
+
+        /** \brief a regular expression of the cache, see JKMathParser::getCompiledRegExp() */
+        struct JKMPLIB_EXPORT jkmpCompiledRegExp {
+            public:
+                /** \brief the pattern, compiled by std::regex */
+                std::shared_ptr<const std::regex> regExp;
+                /** \brief the pattern, compiled to a linear-time automaton, or \c NULL , if it uses features that JKMP::regExpAutomaton does not support */
+                std::shared_ptr<const JKMP::regExpAutomaton> automaton;
+        };
+
+        /** \brief bounded cache of compiled regular expressions, see JKMathParser::getRegExp()
+         *
+         *  The compiled patterns are keyed on the pattern and the flags (case sensitivity, minimal matching). When the cache is full,
+         *  the least recently used pattern is removed. The cache may be used from several threads at once.
+         */
+        struct JKMPLIB_EXPORT jkmpRegExpCache {
+            public:
+                explicit jkmpRegExpCache(size_t capacity=JKMATHPARSER_REGEXPCACHE_SIZE);
+                /** \brief returns the compiled (ECMAScript) pattern \a pattern, throws std::regex_error for invalid patterns */
+                jkmpCompiledRegExp get(const JKMP::string& pattern, bool caseSensitive, bool minimal);
+                /** \brief sets the maximum number of compiled patterns, \c 0 disables the cache */
+                void setCapacity(size_t capacity);
+                /** \brief returns the maximum number of compiled patterns */
+                size_t getCapacity() const;
+                /** \brief returns the statistics of the cache */
+                jkmpRegExpCacheStatistics getStatistics() const;
+                /** \brief removes all compiled patterns and resets the statistics */
+                void clear();
+            protected:
+                /** \brief key of a compiled pattern: the pattern and the flags */
+                typedef std::pair<JKMP::stringType, int> Key;
+                /** \brief hash of a Key */
+                struct KeyHash {
+                    inline size_t operator()(const Key& key) const {
+                        return std::hash<JKMP::stringType>()(key.first)^(size_t(key.second)*0x9E3779B9u);
+                    }
+                };
+                /** \brief a compiled pattern */
+                struct Entry {
+                    Key key;
+                    jkmpCompiledRegExp compiled;
+                };
+                /** \brief the compiled patterns, the most recently used first */
+                std::list<Entry> entries;
+                /** \brief maps the keys to the items of entries */
+                std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+                size_t capacity;
+                jkmpRegExpCacheStatistics statistics;
+                mutable std::mutex mutex;
+                /** \brief removes the least recently used patterns, until there are at most capacity entries (mutex has to be locked) */
+                void shrink();
+        };
+
+        /** \brief bounded cache of FFT plans, keyed on their length, see JKMathParser::getFFTPlan()
+         *
+         *  When the cache is full, the least recently used plan is removed. The cache may be used from several threads at once.
+         */
+        struct JKMPLIB_EXPORT jkmpFFTPlanCache {
+            public:
+                explicit jkmpFFTPlanCache(size_t capacity=JKMATHPARSER_FFTPLANCACHE_SIZE);
+                /** \brief returns the plan of length \a n */
+                std::shared_ptr<const JKMP::fftPlan> get(size_t n);
+                /** \brief sets the maximum number of plans, \c 0 disables the cache */
+                void setCapacity(size_t capacity);
+                /** \brief returns the maximum number of plans */
+                size_t getCapacity() const;
+                /** \brief returns the statistics of the cache */
+                jkmpFFTPlanCacheStatistics getStatistics() const;
+                /** \brief removes all plans and resets the statistics */
+                void clear();
+            protected:
+                /** \brief the plans, the most recently used first */
+                std::list<std::shared_ptr<const JKMP::fftPlan> > entries;
+                /** \brief maps the lengths to the items of entries */
+                std::unordered_map<size_t, std::list<std::shared_ptr<const JKMP::fftPlan> >::iterator> index;
+                size_t capacity;
+                jkmpFFTPlanCacheStatistics statistics;
+                mutable std::mutex mutex;
+                /** \brief removes the least recently used plans, until there are at most capacity entries (mutex has to be locked) */
+                void shrink();
+        };
+
         /** \brief description of a user registered function */
         struct JKMPLIB_EXPORT jkmpFunctionDescriptor {
             explicit jkmpFunctionDescriptor();
@@ -1062,12 +1826,25 @@ class JKMPLIB_EXPORT JKMathParser
             jkmpFunctiontype type;  /*!< \brief type of the function */
             jkmpNode* functionNode;   /*!< \brief points to the node definig the function */
             JKMP::stringVector parameterNames;  /*!< \brief a list of the function parameters, if the function is defined by a node */
+            std::shared_ptr<jkmpFunctionMemo> memo; /*!< \brief memoization cache of a function that is defined by a node (shared by the copies of the descriptor), see JKMathParser::setMemoizeFunctions() */
 
-            JKMP::map<int, void*> simpleFuncPointer; /*!<  \brief points to the simple implementation of the function, e.g. of type jkmpEvaluateFuncSimple0Param or jkmpEvaluateFuncSimple0ParamMP, the integer-key indexes the function as its number of parameters for a simple call to simpleFuncPointer ... values >100 indicate the use of a MP-variant, i.e. 102 means a call to jkmpEvaluateFuncSimple2ParamMP whereas 1 means a call to  jkmpEvaluateFuncSimple1Param */
+            JKMP::map<int, void*> simpleFuncPointer; /*!<  \brief points to the simple implementation of the function, e.g. of type jkmpEvaluateFuncSimple0Param or jkmpEvaluateFuncSimple0ParamMP, the integer-key indexes the function as its number of parameters for a simple call to simpleFuncPointer ... values >100 indicate the use of a MP-variant, i.e. 102 means a call to jkmpEvaluateFuncSimple2ParamMP whereas 1 means a call to  jkmpEvaluateFuncSimple1Param. The key 201 stores the vectorized variant jkmpEvaluateFuncVector1Param of the 1-parameter function. */
 
             JKMPLIB_EXPORT void evaluate(jkmpResult& res, const JKMP::vector<jkmpResult> &parameters, JKMathParser *parent) const;
-            JKMPLIB_EXPORT void evaluate(jkmpResult& res, JKMP::vector<jkmpNode *> parameters, JKMathParser *parent) const;
+            /** \brief evaluate the function for the given parameter nodes
+             *
+             *  If \a paramBuffer is given, the parameters of C-functions are evaluated into this (reused) buffer, instead of into a temporary vector.
+             *  The buffer is cleared after the call.
+             */
+            JKMPLIB_EXPORT void evaluate(jkmpResult& res, const JKMP::vector<jkmpNode *>& parameters, JKMathParser *parent, JKMP::vector<jkmpResult>* paramBuffer=NULL) const;
             JKMPLIB_EXPORT JKMP::string toDefString() const;
+            /** \brief returns in \a key the key of the memoization cache for a call with the (already evaluated) \a parameters. Returns \c false, if
+             *         memoization is disabled, or if the call can not be memoized (the function is not pure, or the parameters or the global
+             *         variables that the function reads are not numbers). Outdated results are removed from the cache. */
+            JKMPLIB_EXPORT bool getMemoKey(std::vector<uint64_t>& key, const JKMP::vector<jkmpResult>& parameters, JKMathParser* parent) const;
+            /** \brief evaluates the body of a function that is defined by a node, the \a parameters have to be bound already. The result is taken from
+             *         (or stored in) the memoization cache, if possible. */
+            JKMPLIB_EXPORT void evaluateFunctionNode(jkmpResult& r, const JKMP::vector<jkmpResult>& parameters, JKMathParser* parent) const;
         };
 
         /**
@@ -1081,9 +1858,24 @@ class JKMPLIB_EXPORT JKMathParser
          */
         class JKMPLIB_EXPORT jkmpFunctionNode: public jkmpNode {
           private:
-            JKMP::string fun;
+            /** \brief interned name of the function */
+            jkmpSymbol funSymbol;
             JKMP::vector<JKMathParser::jkmpNode*> child;
+            /** \brief the function descriptor, resolved on the last call (valid while \c cachedGeneration matches the function generation of the environment) */
+            const jkmpFunctionDescriptor* cachedFunction;
+            /** \brief function generation of the environment at the time \c cachedFunction was resolved */
+            uint64_t cachedGeneration;
+            /** \brief buffer for the evaluated parameters of C-functions, its capacity is reused between calls (it is empty between calls) */
+            JKMP::vector<jkmpResult> paramBuffer;
+            /** \brief indicates that \c paramBuffer is currently used (i.e. this node is evaluated recursively) */
+            bool paramBufferInUse;
           public:
+            /** \brief returns the descriptor of the function \c fun, reuses \c cachedFunction if the functions of the environment did not change since the last call */
+            const jkmpFunctionDescriptor* resolveFunction();
+            /** \brief name of the function */
+            inline const JKMP::string& getName() const { return symbolName(funSymbol); }
+            /** \brief interned name of the function */
+            inline jkmpSymbol getSymbol() const { return funSymbol; }
             /** \brief constructor for a jkmpFunctionNode
              *  \param name name of the function
              *  \param c a pointer to an array of jkmpNode objects that represent the parameter expressions
@@ -1106,6 +1898,18 @@ class JKMPLIB_EXPORT JKMathParser
 
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment) ;
+            /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram) */
+            virtual void createFlatProgram(FlatProgram& program);
+            /** \brief infers the result type: a number, if the function has a simple C implementation (see jkmpFunctionDescriptor::simpleFuncPointer) and all parameters are numbers */
+            virtual int inferType();
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
+            /** \brief returns \c true, if this node is an element-wise operation, see jkmpNode::isElementwiseOperation() */
+            virtual bool isElementwiseOperation();
+            /** \brief append the element-wise operations of this subtree to \a program, see jkmpNode::createFusedVectorProgram() */
+            virtual void createFusedVectorProgram(FusedVectorProgram& program);
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -1148,6 +1952,14 @@ class JKMPLIB_EXPORT JKMathParser
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment) ;
+            /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram) */
+            virtual void createFlatProgram(FlatProgram& program);
+            /** \brief infers the result type of this node from the types of its children */
+            virtual int inferType();
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -1177,6 +1989,10 @@ class JKMPLIB_EXPORT JKMathParser
                 virtual jkmpNode* copy(jkmpNode* par=NULL) ;
                 /** \brief create bytecode that evaluates the current node */
                 virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment) ;
+                /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram) */
+                virtual void createFlatProgram(FlatProgram& program);
+                /** \brief infers the result type of this node, see jkmpNode::inferType() */
+                virtual int inferType();
                 /** \brief print the expression */
                 virtual JKMP::string print() const;
                 /** \brief print the expression tree */
@@ -1211,6 +2027,10 @@ class JKMPLIB_EXPORT JKMathParser
 
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
+            /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram) */
+            virtual void createFlatProgram(FlatProgram& program);
+            /** \brief infers the result type of this node, see jkmpNode::inferType() */
+            virtual int inferType();
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
@@ -1243,9 +2063,19 @@ class JKMPLIB_EXPORT JKMathParser
 
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
+            /** \brief evaluates \c start, \c end and \c step into \a range, without materialising the vector. Returns \c false (and reports an error), if this is not possible */
+            bool evaluateRange(jkmpRange& range);
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief infers the result type of this node from the types of its children */
+            virtual int inferType();
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
+            /** \brief returns \c true, see jkmpNode::isTriviallyOwned() */
+            virtual bool isTriviallyOwned() const { return true; }
             /** \brief print the expression */
             virtual JKMP::string print() const;
             /** \brief print the expression tree */
@@ -1274,6 +2104,14 @@ class JKMPLIB_EXPORT JKMathParser
 
             void setElse(jkmpNode* elseNode);
             void addCase(jkmpNode* decision, jkmpNode* value);
+            /** \brief number of decision/value pairs */
+            inline size_t getCaseCount() const { return casesNodes.size(); }
+            /** \brief decision of the \a i -th case */
+            inline jkmpNode* getDecision(size_t i) const { return casesNodes[i].first; }
+            /** \brief value of the \a i -th case */
+            inline jkmpNode* getValue(size_t i) const { return casesNodes[i].second; }
+            /** \brief value, if no decision is \c true */
+            inline jkmpNode* getElse() const { return elseNode; }
 
             /** \brief evaluate this node, return result as call-by-reference (faster!) */
             virtual void evaluate(jkmpResult& result);
@@ -1282,6 +2120,14 @@ class JKMPLIB_EXPORT JKMathParser
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment) ;
+            /** \brief append instructions that evaluate the current node to \a program (see \ref jkmpflatprogram) */
+            virtual void createFlatProgram(FlatProgram& program);
+            /** \brief infers the result type of this node from the types of its children */
+            virtual int inferType();
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
 
             /** \brief print the expression */
             virtual JKMP::string print() const;
@@ -1289,13 +2135,79 @@ class JKMPLIB_EXPORT JKMathParser
             virtual JKMP::string printTree(int level=0) const;
         };
 
+        class jkmpVectorOperationNode; // forward
+
+        /**
+         * \brief caches the value of a loop-invariant subexpression in the body of a jkmpVectorOperationNode (see jkmpVectorOperationNode::hoistLoopInvariants())
+         *
+         * While enabled, the child is evaluated on its first use in an evaluation of the loop and the cached value is returned in all
+         * further iterations. So subexpressions in branches that are never taken, or in loops without iterations, are never evaluated.
+         * In bytecode, the value is computed once before the loop into a heap slot (see setByteCodeSlot()). A disabled node simply
+         * evaluates its child.
+         */
+        class JKMPLIB_EXPORT jkmpLoopInvariantNode: public jkmpNode {
+          private:
+            jkmpNode* child;
+            /** \brief the loop that created this node and invalidates the cached value */
+            jkmpVectorOperationNode* owner;
+            jkmpResult value;
+            bool cached;
+            bool enabled;
+            int byteCodeSlot;
+          public:
+            explicit jkmpLoopInvariantNode(jkmpNode* c, jkmpVectorOperationNode* owner, JKMathParser* p, jkmpNode* par);
+            /** \brief standard destructor, also destroy the children (recursively)  */
+            virtual ~jkmpLoopInvariantNode();
+
+            inline jkmpNode* getChild() const { return child; }
+            inline jkmpVectorOperationNode* getOwner() const { return owner; }
+            inline bool isEnabled() const { return enabled; }
+            inline void setEnabled(bool en) { enabled=en; cached=false; }
+            /** \brief drops the cached value, called by the owner, when the loop is evaluated again */
+            inline void invalidate() { cached=false; }
+            /** \brief copies the cached value to \a v and \a c, so it can be restored by restoreCache() after a nested evaluation of the owner */
+            inline void saveCache(jkmpResult& v, bool& c) const { v=value; c=cached; }
+            /** \brief restores a cached value, which was saved by saveCache() */
+            inline void restoreCache(const jkmpResult& v, bool c) { value=v; cached=c; }
+            /** \brief while \a slot>=0, createByteCode() reads the value from this heap item, which is written before the loop */
+            inline void setByteCodeSlot(int slot) { byteCodeSlot=slot; }
+
+            /** \brief evaluate this node, return result as call-by-reference (faster!) */
+            virtual void evaluate(jkmpResult& result);
+            /** \brief create bytecode that evaluates the current node */
+            virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment);
+            /** \brief infers the result type of this node, i.e. the type of the child */
+            virtual int inferType();
+            /** \brief specializes the child of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
+
+            /** \brief returns a copy of the child (the copy is not hoisted). The parent is set to \a par */
+            virtual jkmpNode* copy(jkmpNode* par=NULL) ;
+            /** \brief print the expression */
+            virtual JKMP::string print() const;
+            /** \brief print the expression tree, hoisted subexpressions are marked */
+            virtual JKMP::string printTree(int level=0) const;
+        };
+
         /**
          * \brief This class represents a for, savefor, sum, prod construct
+         *
+         * Subexpressions of the body, which neither depend on the loop variable, nor on variables that are assigned in the body, nor
+         * call functions with side effects, are evaluated only once per evaluation of the loop (loop-invariant code motion, see
+         * hoistLoopInvariants()).
+         *
+         * Loops \c for, \c savefor, \c sum, \c prod, \c cumsum and \c cumprod over numbers, whose body is an element-wise function of the loop
+         * variable (see \ref jkmpfusedvector), are rewritten into whole-vector operations, e.g. <code>savefor(i, x, sin(i)*2+1)</code> is
+         * evaluated like <code>sin(x)*2+1</code>. The items are processed in blocks of JKMATHPARSER_VECTORIZEDLOOP_BLOCKSIZE elements by a
+         * jkmpFusedVectorNode. If the other operands of the body are not numbers at runtime, the loop is evaluated iteration by iteration.
          */
         class JKMPLIB_EXPORT jkmpVectorOperationNode: public jkmpNode {
           private:
             JKMP::string operationName;
-            JKMP::string variableName;
+            /** \brief interned name of the loop variable */
+            jkmpSymbol variableSymbol;
             jkmpNode* items;
             jkmpNode* start;
             jkmpNode* end;
@@ -1303,11 +2215,75 @@ class JKMPLIB_EXPORT JKMathParser
             jkmpNode* expression;
             jkmpNode* defaultValue;
             JKMP::vector<std::pair<jkmpNode*, jkmpNode*> > casesNodes;
+            /** \brief the jkmpLoopInvariantNode objects, which were inserted into the body by hoistLoopInvariants() (they are owned by the tree) */
+            JKMP::vector<jkmpLoopInvariantNode*> loopInvariants;
+            /** \brief indicates that hoistLoopInvariants() has analysed the body */
+            bool loopInvariantsValid;
+            /** \brief function generation of the environment, for which the body was analysed by hoistLoopInvariants() */
+            uint64_t loopInvariantsGeneration;
+            /** \brief the body, rewritten into a jkmpFusedVectorNode over vectors of items by prepareVectorizedExpression(), or \c NULL, if the loop can not be vectorized */
+            jkmpNode* vectorizedExpression;
+            /** \brief the operands of \c vectorizedExpression, which don't depend on the loop variable (they are owned by \c vectorizedExpression) */
+            JKMP::vector<jkmpLoopInvariantNode*> vectorizedOperands;
+            /** \brief indicates that prepareVectorizedExpression() has analysed the body */
+            bool vectorizedValid;
+            /** \brief function generation of the environment, for which the body was analysed by prepareVectorizedExpression() */
+            uint64_t vectorizedGeneration;
+            /** \brief number of evaluations of this loop, which are currently running. This is >1, if a user-defined function, which contains
+             *         the loop, is called (recursively) in the body */
+            int activeEvaluations;
+            /** \brief starts an evaluation of the loop with empty caches in the jkmpLoopInvariantNode objects. The cached values of a running
+             *         (outer) evaluation are saved and restored, when the nested evaluation ends */
+            class jkmpLoopActivation;
+
+            /** \brief wraps loop-invariant subtrees in the slot \a slot in jkmpLoopInvariantNode objects. \a variant are the variables, which may
+             *         change between iterations (the loop variables and the variables that are assigned in the body) */
+            void hoistLoopInvariants(jkmpNode** slot, const std::set<JKMP::string>& variant);
+            /** \brief emits bytecode that computes the enabled loop-invariant subexpressions into new heap items of \a environment and
+             *         makes them read from there (see jkmpLoopInvariantNode::setByteCodeSlot()), \a names receives the names of the heap items */
+            bool createLoopInvariantsByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment, JKMP::stringVector& names);
+            /** \brief releases the heap items of createLoopInvariantsByteCode() */
+            void releaseLoopInvariantsByteCode(ByteCodeEnvironment* environment, const JKMP::stringVector& names);
+
+            /** \brief analyses the body (again, if the set of functions has changed since the last call) and creates \c vectorizedExpression,
+             *         if it is an element-wise function of the loop variable */
+            void prepareVectorizedExpression();
+            /** \brief wraps the operands of the element-wise operations in the slot \a slot, which don't depend on the loop variable, in
+             *         jkmpLoopInvariantNode objects. Returns \c false, if an operand depends on the loop variable in another way than by reading it. */
+            bool wrapVectorizedOperands(jkmpNode** slot, bool& usesLoopVariable);
+            /** \brief evaluates the loop with \c vectorizedExpression on blocks of items. Returns \c false (without changing \a r and
+             *         without reporting errors), if the loop can not be vectorized. */
+            bool evaluateVectorized(jkmpResult& r, bool isRange, const jkmpRange& range, const JKMP::vector<double>& itemVals);
+
+            /** \brief returns \c true, if the loop variable can be bound once to a fixed slot for all iterations, i.e. \c expression does not
+             *         assign it (also not in called user-defined functions) and does not call functions with unknown effects */
+            bool canBindLoopVariable();
+            /** \brief fast loop engine for sum/prod/for/savefor over numbers, which evaluates the (number-valued) \c expression as bytecode. The loop
+             *         variable has to be bound to \a loopValue already. Returns \c false (without changing \a r), if \c expression can not be compiled. */
+            bool evaluateByteCodeLoop(jkmpResult& r, double& loopValue, bool isRange, const jkmpRange& range, const JKMP::vector<double>& itemVals);
+            /** \brief evaluates the \a count iterations of the compiled \a program in parallel on the thread pool of the parser (see evaluateByteCodeLoop()).
+             *
+             *  The results are stored in iteration order. sum/prod are reduced pairwise over fixed chunks of iterations, so the result does
+             *  not depend on the number of threads.
+             */
+            void evaluateByteCodeLoopParallel(jkmpResult& r, const ByteCodeProgram& program, const JKMP::vector<double>& initialHeap, int loopVar, bool isRange, const jkmpRange& range, const JKMP::vector<double>& itemVals, int64_t count);
           public:
             /** \brief constructor for a jkmpVectorOperationNode
              */
             explicit jkmpVectorOperationNode(const JKMP::string& operationName, const JKMP::string& variableName, jkmpNode* items, jkmpNode* expression, JKMathParser* p, jkmpNode* par, jkmpNode* defaultValue=NULL);
             explicit jkmpVectorOperationNode(const JKMP::string& operationName, const JKMP::string& variableName, jkmpNode* start, jkmpNode* end, jkmpNode* delta, jkmpNode* expression, JKMathParser* p, jkmpNode* par, jkmpNode* defaultValue=NULL);
+            /** \brief name of the loop variable */
+            inline const JKMP::string& getVariableName() const { return symbolName(variableSymbol); }
+            /** \brief interned name of the loop variable */
+            inline jkmpSymbol getVariableSymbol() const { return variableSymbol; }
+            /** \brief name of the operation (sum, prod, for, ...) */
+            inline JKMP::string getOperationName() const { return operationName; }
+            /** \brief the expression that is evaluated in every iteration */
+            inline jkmpNode* getExpression() const { return expression; }
+            /** \brief analyses the body (again, if the set of functions has changed since the last call) and caches the subexpressions that
+             *         don't change between iterations in jkmpLoopInvariantNode objects (loop-invariant code motion). This is called by evaluate()
+             *         and createByteCode(), so printTree() shows the hoisted subexpressions after the first evaluation. */
+            void hoistLoopInvariants();
 
             /** \brief standard destructor, also destroy the children (recursively)  */
             virtual ~jkmpVectorOperationNode ();
@@ -1316,6 +2292,10 @@ class JKMPLIB_EXPORT JKMathParser
             virtual void evaluate(jkmpResult& result);
             /** \brief create bytecode that evaluates the current node */
             virtual bool createByteCode(ByteCodeProgram& program, ByteCodeEnvironment* environment) ;
+            /** \brief specializes the children of this node, see jkmpNode::specializeTypes() */
+            virtual jkmpNode* specializeTypes();
+            /** \brief appends the child slots of this node to \a slots, see jkmpNode::getChildSlots() */
+            virtual void getChildSlots(JKMP::vector<jkmpNode**>& slots);
 
             /** \brief returns a copy of the current node (and the subtree). The parent is set to \a par */
             virtual jkmpNode* copy(jkmpNode* par=NULL) ;
@@ -1332,13 +2312,16 @@ class JKMPLIB_EXPORT JKMathParser
         class JKMPLIB_EXPORT executionEnvironment {
             protected:
                 /** \brief map to manage all currently defined variables */
-                JKMP::map<JKMP::string, JKMP::vector<std::pair<int, jkmpVariable> > > variables;
+                JKMP::map<jkmpSymbol, JKMP::vector<std::pair<int, jkmpVariable> > > variables;
 
                 /** \brief map to manage all currently rtegistered functions */
-                JKMP::map<JKMP::string, JKMP::vector<std::pair<int, jkmpFunctionDescriptor> > > functions;
+                JKMP::map<jkmpSymbol, JKMP::vector<std::pair<int, jkmpFunctionDescriptor> > > functions;
 
                 int currentLevel;
 
+                /** \brief incremented whenever the set of registered functions changes, used to invalidate function descriptors cached in jkmpFunctionNode */
+                uint64_t functionGeneration;
+
                 JKMathParser* parent;
             public:
                 executionEnvironment(JKMathParser* parent=NULL);
@@ -1355,7 +2338,7 @@ class JKMPLIB_EXPORT JKMathParser
                 inline void leaveBlock(){
                     if (currentLevel>0) {
                         currentLevel--;
-                        JKMP::stringVector keys=variables.keys();
+                        JKMP::vector<jkmpSymbol> keys=variables.keys();
                         for (size_t i=0; i<keys.size(); i++) {
                             while (!(variables[keys[i]].is_empty())&&variables[keys[i]].back().first>currentLevel) {
                                 variables[keys[i]].back().second.clearMemory();
@@ -1369,6 +2352,7 @@ class JKMPLIB_EXPORT JKMathParser
                         keys=functions.keys();
                         for (size_t i=0; i<keys.size(); i++) {
                             while ((!functions[keys[i]].is_empty()) && functions[keys[i]].back().first>currentLevel) {
+                                functionGeneration++;
                                 functions[keys[i]].back().second.clearMemory();
                                 functions[keys[i]].pop_back
 ();
@@ -1376,7 +2360,7 @@ class JKMPLIB_EXPORT JKMathParser
                             if (functions[keys[i]].is_empty()) functions.erase(keys[i]);
                         }
                     } else {
-                        parent->jkmpError(JKMP::_("cannot leave toplevel block!"));
+                        parent->jkmpError(jkmpErrorLeaveToplevelBlock);
                     }
                  }
 
@@ -1385,18 +2369,33 @@ class JKMPLIB_EXPORT JKMathParser
                 JKMPLIB_EXPORT void clearFunctions();
                 JKMPLIB_EXPORT void clear();
 
-                JKMPLIB_EXPORT void addVariable(const JKMP::string& name, const jkmpVariable& variable);
-                JKMPLIB_EXPORT int getVariableLevels(const JKMP::string& name) const;
-                JKMPLIB_EXPORT void setFunction(const JKMP::string& name, const jkmpFunctionDescriptor& function);
-                JKMPLIB_EXPORT void addFunction(const JKMP::string& name, const JKMP::stringVector& parameterNames, jkmpNode* function);
+                JKMPLIB_EXPORT void addVariable(jkmpSymbol name, const jkmpVariable& variable);
+                JKMPLIB_EXPORT int getVariableLevels(jkmpSymbol name) const;
+                JKMPLIB_EXPORT void setFunction(jkmpSymbol name, const jkmpFunctionDescriptor& function);
+                JKMPLIB_EXPORT void addFunction(jkmpSymbol name, const JKMP::stringVector& parameterNames, jkmpNode* function);
 
                 /** \brief  tests whether a variable exists */
-                inline bool variableExists(const JKMP::string& name){ return (variables.find(name)!=variables.end()); }
+                inline bool variableExists(jkmpSymbol name){ return (variables.find(name)!=variables.end()); }
 
                 /** \brief  tests whether a function exists */
-                inline bool functionExists(const JKMP::string& name){ return !(functions.find(name)==functions.end()); }
+                inline bool functionExists(jkmpSymbol name){ return !(functions.find(name)==functions.end()); }
+
+                /** \brief returns the current function generation, which changes whenever a function is (re)defined or removed */
+                inline uint64_t getFunctionGeneration() const { return functionGeneration; }
+
+                /** \brief returns a pointer to the currently visible descriptor of the function \a name, or \c NULL if it does not exist.
+                 *
+                 *  \note The pointer is only valid as long as getFunctionGeneration() does not change!
+                 */
+                inline const jkmpFunctionDescriptor* getFunctionDescriptor(jkmpSymbol name) const {
+                    auto it=functions.find(name);
+                    if (it!=functions.end() && it->second.size()>0) {
+                        return &(it->second.back().second);
+                    }
+                    return NULL;
+                }
 
-                inline jkmpResult getVariable(const JKMP::string& name) const {
+                inline jkmpResult getVariable(jkmpSymbol name) const {
                     jkmpResult res;
                     res.isValid=false;
                     if (variables.contains(name) && variables[name].size()>0) {
@@ -1405,101 +2404,113 @@ class JKMPLIB_EXPORT JKMathParser
                         //qDebug()<<"getVariable("<<name<<"): "<<res.toTypeString();
                         return res;
                     }
-                    if (parent) parent->jkmpError(JKMP::_("the variable '%1' does not exist").arg(name));
+                    if (parent) parent->jkmpError(jkmpErrorVariableNotFound, name);
                     return res;
                 }
-                inline bool getVariableDef(const JKMP::string& name, jkmpVariable& vardef) const {
+                /** \brief returns a pointer to the currently visible definition of the variable \a name, or \c NULL if it does not exist (no error is reported).
+                 *
+                 *  \note The pointer is only valid until variables are added or removed.
+                 */
+                inline const jkmpVariable* getVariablePointer(jkmpSymbol name) const {
+                    auto it=variables.find(name);
+                    if (it!=variables.end() && it->second.size()>0) {
+                        return &(it->second.back().second);
+                    }
+                    return NULL;
+                }
+                inline bool getVariableDef(jkmpSymbol name, jkmpVariable& vardef) const {
                     if (variables.contains(name) && variables[name].size()>0) {
                         vardef=variables[name].back().second;
                         return true;
                     }
-                    if (parent) parent->jkmpError(JKMP::_("the variable '%1' does not exist").arg(name));
+                    if (parent) parent->jkmpError(jkmpErrorVariableNotFound, name);
                     return false;
                 }
-                inline int getVariableLevel(const JKMP::string& name) const {
+                inline int getVariableLevel(jkmpSymbol name) const {
                     if (variables.contains(name) && variables[name].size()>0) {
                         return variables[name].back().first;
                     }
-                    if (parent) parent->jkmpError(JKMP::_("the variable '%1' does not exist").arg(name));
+                    if (parent) parent->jkmpError(jkmpErrorVariableNotFound, name);
                     return -1;
                 }
 
-                inline jkmpResult evaluateFunction(const JKMP::string& name, const JKMP::vector<jkmpResult> &parameters) const{
+                inline jkmpResult evaluateFunction(jkmpSymbol name, const JKMP::vector<jkmpResult> &parameters) const{
                     jkmpResult res;
                     if (functions.contains(name) && functions[name].size()>0) {
                         functions[name].back().second.evaluate(res, parameters, parent);
                     } else {
-                        if (parent) parent->jkmpError(JKMP::_("the function '%1' does not exist").arg(name));
+                        if (parent) parent->jkmpError(jkmpErrorFunctionNotFound, name);
                         res.setInvalid();
                     }
                     return res;
                 }
 
-                inline void evaluateFunction(jkmpResult& res, const JKMP::string& name, const JKMP::vector<jkmpResult> &parameters) const{
+                inline void evaluateFunction(jkmpResult& res, jkmpSymbol name, const JKMP::vector<jkmpResult> &parameters) const{
                     if (functions.contains(name) && functions[name].size()>0) {
                         functions[name].back().second.evaluate(res, parameters, parent);
                     } else {
-                        if (parent) parent->jkmpError(JKMP::_("the function '%1' does not exist").arg(name));
+                        if (parent) parent->jkmpError(jkmpErrorFunctionNotFound, name);
                         res.setInvalid();
                     }
                 }
 
-                inline jkmpResult evaluateFunction(const JKMP::string& name, JKMP::vector<jkmpNode*> parameters) const{
+                inline jkmpResult evaluateFunction(jkmpSymbol name, const JKMP::vector<jkmpNode*>& parameters) const{
                     jkmpResult res;
                     if (functions.contains(name) && functions[name].size()>0) {
                         functions[name].back().second.evaluate(res, parameters, parent);
                     } else {
-                        if (parent) parent->jkmpError(JKMP::_("the function '%1' does not exist").arg(name));
+                        if (parent) parent->jkmpError(jkmpErrorFunctionNotFound, name);
                         res.setInvalid();
                     }
                     return res;
                 }
 
-                inline void evaluateFunction(jkmpResult& res, const JKMP::string& name, JKMP::vector<jkmpNode*> parameters) const{
+                inline void evaluateFunction(jkmpResult& res, jkmpSymbol name, const JKMP::vector<jkmpNode*>& parameters) const{
                     if (functions.contains(name) && functions[name].size()>0) {
                         functions[name].back().second.evaluate(res, parameters, parent);
                     } else {
-                        if (parent) parent->jkmpError(JKMP::_("the function '%1' does not exist").arg(name));
+                        if (parent) parent->jkmpError(jkmpErrorFunctionNotFound, name);
                         res.setInvalid();
                     }
                 }
 
-                inline bool getFunctionDef(const JKMP::string& name, jkmpFunctionDescriptor& vardef) const {
+                inline bool getFunctionDef(jkmpSymbol name, jkmpFunctionDescriptor& vardef) const {
                     if (functions.contains(name) && functions[name].size()>0) {
                         vardef=functions[name].back().second;
                         return true;
                     }
-                    if (parent) parent->jkmpError(JKMP::_("the function '%1' does not exist").arg(name));
+                    if (parent) parent->jkmpError(jkmpErrorFunctionNotFound, name);
                     return false;
                 }
 
-                inline jkmpFunctiontype getFunctionType(const JKMP::string& name) const {
+                inline jkmpFunctiontype getFunctionType(jkmpSymbol name) const {
                     if (functions.contains(name) && functions[name].size()>0) {
                          return functions[name].back().second.type;
                     }
-                    if (parent) parent->jkmpError(JKMP::_("the function '%1' does not exist").arg(name));
+                    if (parent) parent->jkmpError(jkmpErrorFunctionNotFound, name);
                     return functionInvalid;
                 }
 
-                inline int getFunctionLevel(const JKMP::string& name) const {
+                inline int getFunctionLevel(jkmpSymbol name) const {
                     if (functions.contains(name) && functions[name].size()>0) {
                         return functions[name].back().first;
                     }
-                    if (parent) parent->jkmpError(JKMP::_("the function '%1' does not exist").arg(name));
+                    if (parent) parent->jkmpError(jkmpErrorFunctionNotFound, name);
                     return -1;
                 }
 
-                inline void getVariable(jkmpResult& res, const JKMP::string& name) const{
-                    if (variables.contains(name) && variables[name].size()>0) {
-                        variables[name].back().second.toResult(res);
+                inline void getVariable(jkmpResult& res, jkmpSymbol name) const{
+                    auto it=variables.find(name);
+                    if (it!=variables.end() && it->second.size()>0) {
+                        it->second.back().second.toResult(res);
                     } else {
-                        if (parent) parent->jkmpError(JKMP::_("the variable '%1' does not exist").arg(name));
+                        if (parent) parent->jkmpError(jkmpErrorVariableNotFound, name);
                         res.setInvalid();
                     }
                     //qDebug()<<"getVariable(res, "<<name<<", "<<res.toTypeString()<<")";
                 }
 
-                inline void addVariable(const JKMP::string& name, const jkmpResult& result){
+                inline void addVariable(jkmpSymbol name, const jkmpResult& result){
                     bool add=true;
                     if (variables.contains(name)) {
                         if (variables[name].size()>0) {
@@ -1529,10 +2540,11 @@ class JKMPLIB_EXPORT JKMathParser
 
                 }
 
-                inline void setVariable(const JKMP::string& name, const jkmpResult& result){
+                inline void setVariable(jkmpSymbol name, const jkmpResult& result){
                     //qDebug()<<"setVariable("<<name<<", "<<result.toTypeString()<<")";
-                    if (variables.contains(name) && variables[name].size()>0) {
-                        variables[name].back().second.set(result);
+                    auto it=variables.find(name);
+                    if (it!=variables.end() && it->second.size()>0) {
+                        it->second.back().second.set(result);
                     } else {
                         JKMathParser::jkmpVariable v;
                         v.set(result);
@@ -1543,19 +2555,19 @@ class JKMPLIB_EXPORT JKMathParser
                     //qDebug()<<"setVariable("<<name<<", "<<result.toTypeString()<<")  =>  "<<variables[name].back().second.toResult().toTypeString();
                 }
 
-                JKMPLIB_EXPORT void setVariableDouble(const JKMP::string& name, double result);
-                JKMPLIB_EXPORT void setVariableDoubleVec(const JKMP::string& name, const JKMP::vector<double>& result);
-                JKMPLIB_EXPORT void setVariableStringVec(const JKMP::string& name, const JKMP::stringVector& result);
-                JKMPLIB_EXPORT void setVariableBoolVec(const JKMP::string& name, const JKMP::vector<bool>& result);
-                JKMPLIB_EXPORT void setVariableString(const JKMP::string& name, const JKMP::string& result);
-                JKMPLIB_EXPORT void setVariableBoolean(const JKMP::string& name, bool result);
-                JKMPLIB_EXPORT void addVariableDouble(const JKMP::string& name, double result);
-                JKMPLIB_EXPORT void addVariableDoubleVec(const JKMP::string& name, const JKMP::vector<double>& result);
-                JKMPLIB_EXPORT void addVariableStringVec(const JKMP::string& name, const JKMP::stringVector& result);
-                JKMPLIB_EXPORT void addVariableBoolVec(const JKMP::string& name, const JKMP::vector<bool>& result);
-                JKMPLIB_EXPORT void addVariableString(const JKMP::string& name, const JKMP::string& result);
-                JKMPLIB_EXPORT void addVariableBoolean(const JKMP::string& name, bool result);
-                JKMPLIB_EXPORT void deleteVariable(const JKMP::string& name);
+                JKMPLIB_EXPORT void setVariableDouble(jkmpSymbol name, double result);
+                JKMPLIB_EXPORT void setVariableDoubleVec(jkmpSymbol name, const JKMP::vector<double>& result);
+                JKMPLIB_EXPORT void setVariableStringVec(jkmpSymbol name, const JKMP::stringVector& result);
+                JKMPLIB_EXPORT void setVariableBoolVec(jkmpSymbol name, const JKMP::vector<bool>& result);
+                JKMPLIB_EXPORT void setVariableString(jkmpSymbol name, const JKMP::string& result);
+                JKMPLIB_EXPORT void setVariableBoolean(jkmpSymbol name, bool result);
+                JKMPLIB_EXPORT void addVariableDouble(jkmpSymbol name, double result);
+                JKMPLIB_EXPORT void addVariableDoubleVec(jkmpSymbol name, const JKMP::vector<double>& result);
+                JKMPLIB_EXPORT void addVariableStringVec(jkmpSymbol name, const JKMP::stringVector& result);
+                JKMPLIB_EXPORT void addVariableBoolVec(jkmpSymbol name, const JKMP::vector<bool>& result);
+                JKMPLIB_EXPORT void addVariableString(jkmpSymbol name, const JKMP::string& result);
+                JKMPLIB_EXPORT void addVariableBoolean(jkmpSymbol name, bool result);
+                JKMPLIB_EXPORT void deleteVariable(jkmpSymbol name);
 
                 JKMP::string printVariables() const;
                 JKMP::string printFunctions() const;
@@ -1577,8 +2589,38 @@ class JKMPLIB_EXPORT JKMathParser
 
 
 
-        /** \brief macro that throws an exception or calls an error handler */
+        /** \brief codes of the errors, which are recorded as a jkmpErrorRecord */
+        enum jkmpErrorCode {
+            jkmpErrorMessage=0,           /*!< \brief an error with a preformatted message, see jkmpError(JKMP::string) */
+            jkmpErrorVariableNotFound=1,  /*!< \brief the variable jkmpErrorRecord::symbol does not exist */
+            jkmpErrorFunctionNotFound=2,  /*!< \brief the function jkmpErrorRecord::symbol does not exist */
+            jkmpErrorLeaveToplevelBlock=3 /*!< \brief tried to leave the toplevel block */
+        };
+
+        /** \brief a recorded error. The error message is only formatted when it is requested (e.g. by getLastError()), so reporting
+         *         an error with a code other than jkmpErrorMessage does not format or allocate any strings. The messages of jkmpErrorMessage
+         *         errors are built by the caller, see JKMATHPARSER_ERROR(). */
+        struct JKMPLIB_EXPORT jkmpErrorRecord {
+            jkmpErrorRecord(jkmpErrorCode code=jkmpErrorMessage, jkmpSymbol symbol=0);
+            jkmpErrorRecord(const JKMP::string& message);
+            /** \brief kind of the error */
+            jkmpErrorCode code;
+            /** \brief the variable or function the error refers to (if applicable) */
+            jkmpSymbol symbol;
+            /** \brief the message of a jkmpErrorMessage error */
+            JKMP::string message;
+            /** \brief returns the (localized) error message */
+            JKMP::string format() const;
+        };
+
+        /** \brief records an error with the message \a st. Use JKMATHPARSER_ERROR() to report errors, which does not build the
+         *         message if JKMATHPARSER_NO_ERROR_MESSAGES is defined. */
         void jkmpError(JKMP::string st);
+        /** \brief records an error of the given \a code, which refers to the variable/function \a symbol. The message is formatted lazily. */
+        inline void jkmpError(jkmpErrorCode code, jkmpSymbol symbol=0) {
+            lastError.push_back(jkmpErrorRecord(code, symbol));
+            errors++;
+        }
 
 
         /*@}*/
@@ -1660,7 +2702,8 @@ class JKMPLIB_EXPORT JKMathParser
 
         void* data;
 
-        JKMP::stringVector lastError;
+        /** \brief the errors since the last call to resetErrors() */
+        JKMP::vector<jkmpErrorRecord> lastError;
         int errors;
 
         JKMP::charType peekStream(std::istream* stream);
@@ -1669,6 +2712,49 @@ class JKMPLIB_EXPORT JKMathParser
 
         JKMP::map<JKMP::string, void*> m_generalData;
 
+        /** \brief a frame of a user-defined function call in evaluateFlatProgram() */
+        struct FlatFrame {
+            const FlatProgram* program;
+            size_t pc;
+            bool leaveBlock;
+            std::shared_ptr<FlatProgram> hold;
+        };
+        /** \brief value stack of evaluateFlatProgram(), the slots are reused between runs */
+        JKMP::vector<jkmpResult> flatStack;
+        /** \brief indicates that flatStack is currently used by evaluateFlatProgram() */
+        bool flatStackInUse;
+        /** \brief linearised bodies of user-defined functions, used by evaluateFlatProgram() */
+        std::map<const jkmpNode*, std::shared_ptr<FlatProgram> > flatFunctionPrograms;
+        /** \brief function generation of the environment, for which flatFunctionPrograms is valid */
+        uint64_t flatFunctionProgramsGeneration;
+        /** \brief returns the linearised body of the user-defined function \a fd */
+        std::shared_ptr<FlatProgram> getFlatFunctionProgram(const jkmpFunctionDescriptor* fd);
+
+        /** \brief evaluate the iterations of loops in parallel, see setParallelLoops() */
+        bool parallelLoops;
+        /** \brief number of threads for parallel evaluation, see setThreadCount() */
+        int threadCount;
+        /** \brief minimum number of items of vectors, which are processed in parallel, see setParallelVectorThreshold() */
+        size_t parallelVectorThreshold;
+        /** \brief summation algorithm of the reductions, see setSummationMode() */
+        jkmpSummationMode summationMode;
+        /** \brief thread pool for parallel evaluation, created by getThreadPool() (shared between copies of the parser) */
+        std::shared_ptr<JKMP::threadPool> m_threadPool;
+        /** \brief names of the C-functions with side effects, see setFunctionHasSideEffects() */
+        std::set<JKMP::string> sideEffectFunctions;
+        /** \brief memoize the results of pure user-defined functions, see setMemoizeFunctions() */
+        bool memoizeFunctions;
+        /** \brief maximum number of cached results per function, see setMemoizationCacheSize() */
+        size_t memoizationCacheSize;
+        /** \brief cache of the compiled regular expressions of the \c regexp...() functions, see getRegExp() (shared between copies of the parser) */
+        std::shared_ptr<jkmpRegExpCache> m_regExpCache;
+        /** \brief match regular expressions with JKMP::regExpMatcher, where possible, see setFastRegExp() */
+        bool fastRegExp;
+        /** \brief run the type inference pass on the result of parse(), see setTypeSpecialization() */
+        bool typeSpecialization;
+        /** \brief cache of the FFT plans of the \c fft...() , \c xcorr() and \c autocorr() functions, see getFFTPlan() (shared between copies of the parser) */
+        std::shared_ptr<jkmpFFTPlanCache> m_fftPlanCache;
+
 	public:
         /** \brief class constructor */
         JKMathParser();
@@ -1697,6 +2783,114 @@ class JKMPLIB_EXPORT JKMathParser
 
         MTRand* get_rng() { return &rng; }
 
+        /** \brief enables the parallel evaluation of the iterations of \c for(...), \c savefor(...), \c sum(...) and \c prod(...) (disabled by default)
+         *
+         *  Only loops, whose body can be compiled to bytecode and is pure (no assignments, no function definitions, no functions with access
+         *  to the parser, like \c rand() ) are evaluated in parallel. The results are the same as for a serial evaluation, except that
+         *  \c sum(...) and \c prod(...) are reduced pairwise, which may change the rounding of the last digits (independent of the number of threads).
+         */
+        inline void setParallelLoops(bool enabled) { parallelLoops=enabled; }
+        /** \brief returns whether the iterations of loops are evaluated in parallel, see setParallelLoops() */
+        inline bool getParallelLoops() const { return parallelLoops; }
+        /** \brief element-wise operations on vectors with at least \a items items (arithmetic operators, comparisons and the functions
+         *         defined with the JKMATHPARSER_DEFINE_...NUMERIC_FUNC macros) are split over the thread pool (see jkmpParallelVectorFor() ),
+         *         \c 0 disables this. The default is JKMATHPARSER_PARALLELVECTOR_THRESHOLD.
+         *
+         *  The results are the same as for a serial evaluation.
+         */
+        inline void setParallelVectorThreshold(size_t items) { parallelVectorThreshold=items; }
+        /** \brief returns the minimum number of items of vectors, which are processed in parallel, see setParallelVectorThreshold() */
+        inline size_t getParallelVectorThreshold() const { return parallelVectorThreshold; }
+        /** \brief selects the summation algorithm of \c sum(x) , \c sum2(x) and \c mean(x) (default: jkmpPairwiseSummation ), see jkmpReduceSum()
+         *
+         *  \c var(x) , \c std(x) , \c skewness(x) and \c moment(x,o) always use the single-pass algorithm of JKMP::reduceCentralSums().
+         *  Vectors with at least getParallelVectorThreshold() items are reduced on the thread pool.
+         */
+        inline void setSummationMode(jkmpSummationMode mode) { summationMode=mode; }
+        /** \brief returns the summation algorithm of the reductions, see setSummationMode() */
+        inline jkmpSummationMode getSummationMode() const { return summationMode; }
+        /** \brief sets the number of threads (including the calling thread) for parallel evaluation, \c 0 uses all hardware threads (default) */
+        void setThreadCount(int threads);
+        /** \brief returns the number of threads for parallel evaluation, see setThreadCount() */
+        int getThreadCount() const;
+        /** \brief returns the thread pool of this parser, which is created with getThreadCount() threads on the first call */
+        JKMP::threadPool* getThreadPool();
+
+        /** \brief marks the C-function \a name as having side effects or non-deterministic results (e.g. \c rand() or \c now() )
+         *
+         *  Calls of these functions are never moved, cached or evaluated in parallel by the optimizations of the parser (see jkmpTreeInfo::hasSideEffects).
+         */
+        void setFunctionHasSideEffects(const JKMP::string& name, bool sideEffects=true);
+        /** \brief returns whether the C-function \a name has side effects, see setFunctionHasSideEffects() */
+        bool functionHasSideEffects(const JKMP::string& name) const;
+
+        /** \brief enables the memoization of user-defined functions <code>f(x)=...</code> (disabled by default)
+         *
+         *  Functions that are proven pure (no assignments to global variables, no function definitions, no calls of functions with
+         *  side effects, see setFunctionHasSideEffects()) cache their results for calls with numbers as arguments, e.g. for recursive
+         *  definitions like <code>fib(n)=if(n<2, n, fib(n-1)+fib(n-2))</code>. The cache of a function is cleared, when any function
+         *  is (re)defined, or when one of the global variables that the function reads changes its value. Calls that report errors
+         *  are not cached.
+         */
+        inline void setMemoizeFunctions(bool enabled) { memoizeFunctions=enabled; }
+        /** \brief returns whether the results of pure user-defined functions are memoized, see setMemoizeFunctions() */
+        inline bool getMemoizeFunctions() const { return memoizeFunctions; }
+        /** \brief sets the maximum number of results that are cached per function (default: 10000), a full cache is cleared */
+        inline void setMemoizationCacheSize(size_t entries) { memoizationCacheSize=entries; }
+        /** \brief returns the maximum number of results that are cached per function, see setMemoizationCacheSize() */
+        inline size_t getMemoizationCacheSize() const { return memoizationCacheSize; }
+        /** \brief returns the statistics of the memoization cache of the user-defined function \a name (all zero, if it does not exist) */
+        jkmpFunctionMemoStatistics getFunctionMemoStatistics(const JKMP::string& name) const;
+
+        /** \brief returns the compiled regular expression (ECMAScript syntax) \a pattern from the cache of the parser, which compiles it on the first request
+         *
+         *  This is used by the \c regexp...() functions, so repeated calls with the same pattern do not compile it again.
+         *  Throws std::regex_error for invalid patterns (which are not cached).
+         */
+        std::shared_ptr<const std::regex> getRegExp(const JKMP::string& pattern, bool caseSensitive=true, bool minimal=false);
+        /** \brief like getRegExp(), but also returns the linear-time automaton of the pattern (if it is supported and setFastRegExp() is enabled) */
+        jkmpCompiledRegExp getCompiledRegExp(const JKMP::string& pattern, bool caseSensitive=true, bool minimal=false);
+        /** \brief match the regular expressions of the \c regexp...() functions with the linear-time JKMP::regExpMatcher (enabled by default)
+         *
+         *  Patterns that use features outside the subset of JKMP::regExpAutomaton are always matched by std::regex. The captures of
+         *  \c regexpcap(...) are extracted by std::regex, but only from the strings that the automaton matched.
+         */
+        inline void setFastRegExp(bool enabled) { fastRegExp=enabled; }
+        /** \brief returns whether the \c regexp...() functions use JKMP::regExpMatcher, see setFastRegExp() */
+        inline bool getFastRegExp() const { return fastRegExp; }
+        /** \brief sets the maximum number of compiled regular expressions in the cache (default: JKMATHPARSER_REGEXPCACHE_SIZE), \c 0 disables the cache */
+        void setRegExpCacheSize(size_t entries);
+        /** \brief returns the maximum number of compiled regular expressions in the cache, see setRegExpCacheSize() */
+        size_t getRegExpCacheSize() const;
+        /** \brief returns the statistics of the cache of compiled regular expressions, see getRegExp() */
+        jkmpRegExpCacheStatistics getRegExpCacheStatistics() const;
+        /** \brief removes all compiled regular expressions from the cache and resets its statistics */
+        void clearRegExpCache();
+
+        /** \brief returns the FFT plan of length \a n from the cache of the parser, which sets it up on the first request
+         *
+         *  This is used by the \c fft...() , \c xcorr() and \c autocorr() functions, so repeated transforms of the same length
+         *  do not compute the factorization and twiddle factors again.
+         */
+        std::shared_ptr<const JKMP::fftPlan> getFFTPlan(size_t n);
+        /** \brief sets the maximum number of FFT plans in the cache (default: JKMATHPARSER_FFTPLANCACHE_SIZE), \c 0 disables the cache */
+        void setFFTPlanCacheSize(size_t entries);
+        /** \brief returns the maximum number of FFT plans in the cache, see setFFTPlanCacheSize() */
+        size_t getFFTPlanCacheSize() const;
+        /** \brief returns the statistics of the cache of FFT plans, see getFFTPlan() */
+        jkmpFFTPlanCacheStatistics getFFTPlanCacheStatistics() const;
+        /** \brief removes all FFT plans from the cache and resets its statistics */
+        void clearFFTPlanCache();
+
+        /** \brief run the type inference pass (jkmpNode::specializeTypes() ) on every tree, returned by parse() (enabled by default)
+         *
+         *  The types are inferred from the variables, as they are defined when parse() is called. The specialized nodes check the
+         *  actual types of their operands, so the results are the same if the types change later (or with this option disabled).
+         */
+        inline void setTypeSpecialization(bool enabled) { typeSpecialization=enabled; }
+        /** \brief returns whether parse() runs the type inference pass, see setTypeSpecialization() */
+        inline bool getTypeSpecialization() const { return typeSpecialization; }
+
 
         /** \brief  register a new function
 		 * \param name name of the new function
@@ -1715,20 +2909,27 @@ class JKMPLIB_EXPORT JKMathParser
         void addFunction(const JKMP::string &name, jkmpEvaluateFuncRefReturn function, jkmpEvaluateFuncSimple0Param f0, jkmpEvaluateFuncSimple1Param f1=NULL, jkmpEvaluateFuncSimple2Param f2=NULL, jkmpEvaluateFuncSimple3Param f3=NULL);
         void addFunction(const JKMP::string &name, jkmpEvaluateFuncRefReturn function, jkmpEvaluateFuncSimple0ParamMP f0, jkmpEvaluateFuncSimple1ParamMP f1=NULL, jkmpEvaluateFuncSimple2ParamMP f2=NULL, jkmpEvaluateFuncSimple3ParamMP f3=NULL);
         void addFunction(const JKMP::string &name, jkmpEvaluateFromNodesFuncRefReturn function);
+        /** \brief registers the vectorized variant \a function of the C-function \a name, which has to be registered with a simple 1-parameter implementation already
+         *
+         *  The fused evaluation of vector expressions (see \ref jkmpfusedvector ) calls \a function on whole blocks instead of the simple implementation item by item.
+         *  \a function has to return the same results as the vector branch of the function implementation, e.g. the functions defined with
+         *  JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_VEC() with the same \c VECFUNC .
+         */
+        void setVectorFunction(const JKMP::string &name, jkmpEvaluateFuncVector1Param function);
 
         inline void addFunction(const JKMP::string& name, const JKMP::stringVector& parameterNames, jkmpNode* function){
-            environment.addFunction(name, parameterNames, function);
+            environment.addFunction(internSymbol(name), parameterNames, function);
         }
 
 
         /** \brief set the defining struct of the given variable */
         inline void addVariable(const JKMP::string& name, const jkmpVariable &value) {
-            environment.addVariable(name, value);
+            environment.addVariable(internSymbol(name), value);
         }
 
         /** \brief get number of levels, on which this variable exists */
         inline int getVariableLevels(const JKMP::string& name) const {
-            return environment.getVariableLevels(name);
+            return environment.getVariableLevels(internSymbol(name));
         }
 
 
@@ -1737,7 +2938,7 @@ class JKMPLIB_EXPORT JKMathParser
 		 * \param v initial value of this variable
 		 */
         inline void addVariableDouble(const JKMP::string& name, double v) {
-            environment.addVariableDouble(name, v);
+            environment.addVariableDouble(internSymbol(name), v);
         }
 
         /** \brief  register a new internal variable of type string
@@ -1745,7 +2946,7 @@ class JKMPLIB_EXPORT JKMathParser
 		 * \param v initial value of this variable
 		 */
         inline void addVariableString(const JKMP::string &name, const JKMP::string& v) {
-            environment.addVariableString(name, v);
+            environment.addVariableString(internSymbol(name), v);
         }
 
         /** \brief  register a new internal variable of type boolean
@@ -1753,28 +2954,28 @@ class JKMPLIB_EXPORT JKMathParser
          * \param v initial value of this variable
          */
         inline void addVariableBoolean(const JKMP::string& name, bool v) {
-            environment.addVariableBoolean(name, v);
+            environment.addVariableBoolean(internSymbol(name), v);
         }
         /** \brief  register a new internal variable of type boolean vector
          * \param name name of the new variable
          * \param v initial value of this variable
          */
         inline void addVariableBoolVector(const JKMP::string& name, const JKMP::vector<bool>& v) {
-            environment.addVariableBoolVec(name, v);
+            environment.addVariableBoolVec(internSymbol(name), v);
         }
         /** \brief  register a new internal variable of type boolean vector
          * \param name name of the new variable
          * \param v initial value of this variable
          */
         inline void addVariableDoubleVector(const JKMP::string& name, const JKMP::vector<double>& v) {
-            environment.addVariableDoubleVec(name, v);
+            environment.addVariableDoubleVec(internSymbol(name), v);
         }
         /** \brief  register a new internal variable of type boolean vector
          * \param name name of the new variable
          * \param v initial value of this variable
          */
         inline void addVariableStringVector(const JKMP::string& name, const JKMP::stringVector& v) {
-            environment.addVariableStringVec(name, v);
+            environment.addVariableStringVec(internSymbol(name), v);
         }
 
         /** \brief  register a new internal variable of type boolean
@@ -1782,7 +2983,7 @@ class JKMPLIB_EXPORT JKMathParser
          * \param v initial value of this variable
          */
         inline void addVariable(const JKMP::string &name, const jkmpResult &result) {
-            environment.addVariable(name, result);
+            environment.addVariable(internSymbol(name), result);
         }
 
         /** \brief  register a new internal variable if the given variable does not exist, otherwise set the axisting variable to the given value
@@ -1790,43 +2991,43 @@ class JKMPLIB_EXPORT JKMathParser
          * \param v initial value of this variable
          */
         inline void setVariable(const JKMP::string &name, const jkmpResult &result) {
-            environment.setVariable(name, result);
+            environment.setVariable(internSymbol(name), result);
         }
 
         inline void setVariableDouble(const JKMP::string& name, double result) {
-            environment.setVariableDouble(name, result);
+            environment.setVariableDouble(internSymbol(name), result);
         }
 
         inline void setVariableDoubleVec(const JKMP::string& name, const JKMP::vector<double>& result) {
-            environment.setVariableDoubleVec(name, result);
+            environment.setVariableDoubleVec(internSymbol(name), result);
         }
         inline void setVariableStringVec(const JKMP::string& name, const JKMP::stringVector& result) {
-            environment.setVariableStringVec(name, result);
+            environment.setVariableStringVec(internSymbol(name), result);
         }
         inline void setVariableBoolVec(const JKMP::string& name, const JKMP::vector<bool>& result) {
-            environment.setVariableBoolVec(name, result);
+            environment.setVariableBoolVec(internSymbol(name), result);
         }
         inline void setVariableString(const JKMP::string& name, const JKMP::string& result) {
-            environment.setVariableString(name, result);
+            environment.setVariableString(internSymbol(name), result);
         }
         inline void setVariableBoolean(const JKMP::string& name, bool result) {
-            environment.setVariableBoolean(name, result);
+            environment.setVariableBoolean(internSymbol(name), result);
         }
 
 
         inline void deleteVariable(const JKMP::string& name) {
-            environment.deleteVariable(name);
+            environment.deleteVariable(internSymbol(name));
         }
 
         /** \brief  returns the value of the given variable */
         inline void getVariable(jkmpResult& r, JKMP::string name) {
-            environment.getVariable(r, name);
+            environment.getVariable(r, internSymbol(name));
         }
 
         /** \brief  returns the value of the given variable */
         inline void getVariableOrInvalid(jkmpResult& r, JKMP::string name) {
-            if (environment.variableExists(name)) {
-                environment.getVariable(r, name);
+            if (environment.variableExists(internSymbol(name))) {
+                environment.getVariable(r, internSymbol(name));
             } else {
                 r.setInvalid();
             }
@@ -1839,27 +3040,27 @@ class JKMPLIB_EXPORT JKMathParser
          * \param params array of the input parameters
          */
         inline void evaluateFunction(jkmpResult& r, const JKMP::string &name, const JKMP::vector<jkmpResult>& params) {
-            environment.evaluateFunction(r, name, params);
+            environment.evaluateFunction(r, internSymbol(name), params);
         }
 
         /** \brief  evaluates a registered function
          * \param name name of the (registered function) to be evaluated
          * \param params array of the input parameters
          */
-        inline void evaluateFunction(jkmpResult& r, const JKMP::string &name,  JKMP::vector<jkmpNode*> params) {
-            environment.evaluateFunction(r, name, params);
+        inline void evaluateFunction(jkmpResult& r, const JKMP::string &name, const JKMP::vector<jkmpNode*>& params) {
+            environment.evaluateFunction(r, internSymbol(name), params);
         }
 
 
 
         /** \brief  returns the value of the given variable */
         inline jkmpResult getVariable(JKMP::string name) {
-            return environment.getVariable(name);
+            return environment.getVariable(internSymbol(name));
         }
 
         /** \brief  returns the value of the given variable */
         inline jkmpResult getVariableOrInvalid(JKMP::string name) {
-            if (environment.variableExists(name)) return environment.getVariable(name);
+            if (environment.variableExists(internSymbol(name))) return environment.getVariable(internSymbol(name));
             return jkmpResult::invalidResult();
 
         }
@@ -1871,7 +3072,7 @@ class JKMPLIB_EXPORT JKMathParser
          * \param params array of the input parameters
          */
         inline jkmpResult evaluateFunction(const JKMP::string &name, const JKMP::vector<jkmpResult>& params) {
-            return environment.evaluateFunction(name, params);
+            return environment.evaluateFunction(internSymbol(name), params);
         }
 
 
@@ -1880,17 +3081,17 @@ class JKMPLIB_EXPORT JKMathParser
          * \param name name of the (registered function) to be evaluated
          * \param params array of the input parameters
          */
-        inline jkmpResult evaluateFunction(const JKMP::string &name,  JKMP::vector<jkmpNode*> params) {
-            return environment.evaluateFunction(name, params);
+        inline jkmpResult evaluateFunction(const JKMP::string &name, const JKMP::vector<jkmpNode*>& params) {
+            return environment.evaluateFunction(internSymbol(name), params);
         }
 
 
 
         /** \brief  tests whether a variable exists */
-        inline bool variableExists(const JKMP::string& name){ return environment.variableExists(name); }
+        inline bool variableExists(const JKMP::string& name){ return environment.variableExists(internSymbol(name)); }
 
         /** \brief  tests whether a function exists */
-        inline bool functionExists(const JKMP::string& name){ return environment.functionExists(name); }
+        inline bool functionExists(const JKMP::string& name){ return environment.functionExists(internSymbol(name)); }
 
         inline void enterBlock() {
             environment.enterBlock();
@@ -1920,7 +3121,7 @@ class JKMPLIB_EXPORT JKMathParser
         /** \brief  registers standard functions*/
         void addStandardFunctions();
 
-        /** \brief  parses the given expression*/
+        /** \brief  parses the given expression (and specializes the tree, see setTypeSpecialization() )*/
         jkmpNode* parse(JKMP::stringType prog);
 
         /** \brief evaluate the given expression */
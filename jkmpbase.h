@@ -29,6 +29,11 @@
 #include <type_traits>
 #include <functional>
 #include <map>
+#include <algorithm>
+#include <stdexcept>
+#include <memory>
+#include <cstddef>
+#include <iterator>
 #include "jkmplib_imexport.h"
 
 namespace JKMP {
@@ -225,22 +230,431 @@ namespace JKMP {
     };
 
 
+    /** \brief an associative container with the interface of JKMP::map, which stores its items as a vector of (key, value) pairs,
+     *         sorted by key.
+     *
+     *  Lookups are binary searches over one contiguous block of memory and copying the container copies a single vector, which makes
+     *  this faster and more cache-friendly than JKMP::map for the small maps, that are used e.g. as struct data. Inserting or erasing
+     *  items moves the items behind the insertion point, so it is not suited for large maps that change often.
+     *
+     *  \note Inserting and erasing invalidates iterators and pointers to items (as for std::vector). The keys must not be changed
+     *        through an iterator.
+     */
+    template <class Key, class T>
+    class flatmap {
+        public:
+            typedef std::pair<Key, T> value_type;
+            typedef typename std::vector<value_type>::const_iterator const_iterator;
+            typedef typename std::vector<value_type>::iterator iterator;
+
+            inline flatmap() {}
+            inline flatmap(const flatmap& v): items(v.items) {}
+            /** \brief creates a flatmap with the items of the std::map \a m */
+            inline flatmap(const std::map<Key, T>& m): items(m.begin(), m.end()) {}
+
+            inline flatmap& operator=(const flatmap& v) { items=v.items; return *this; }
+
+            inline iterator begin() { return items.begin(); }
+            inline iterator end() { return items.end(); }
+            inline const_iterator begin() const { return items.begin(); }
+            inline const_iterator end() const { return items.end(); }
+            inline size_t size() const { return items.size(); }
+            inline bool empty() const { return items.empty(); }
+            inline bool is_empty() const { return items.empty(); }
+            inline void clear() { items.clear(); }
+            inline void reserve(size_t n) { items.reserve(n); }
+
+            inline iterator find(const Key& k) {
+                iterator it=lowerBound(k);
+                if (it!=items.end() && !(k<it->first)) return it;
+                return items.end();
+            }
+            inline const_iterator find(const Key& k) const {
+                const_iterator it=lowerBound(k);
+                if (it!=items.end() && !(k<it->first)) return it;
+                return items.end();
+            }
+
+            inline bool contains(const Key& key) const {
+                return find(key)!=end();
+            }
+
+            /** \brief inserts \a item, if its key does not exist yet (as std::map::insert()) */
+            inline std::pair<iterator, bool> insert(const value_type& item) {
+                iterator it=lowerBound(item.first);
+                if (it!=items.end() && !(item.first<it->first)) return std::make_pair(it, false);
+                return std::make_pair(items.insert(it, item), true);
+            }
+
+            inline size_t erase(const Key& k) {
+                iterator it=find(k);
+                if (it==items.end()) return 0;
+                items.erase(it);
+                return 1;
+            }
+
+            inline T& operator[] (const Key& k) {
+                iterator it=lowerBound(k);
+                if (it==items.end() || k<it->first) it=items.insert(it, value_type(k, T()));
+                return it->second;
+            }
+            inline const T& operator[] (const Key& k) const {
+                const_iterator it=find(k);
+                if (it==this->end()) {
+                    throw std::out_of_range("key not found in map");
+                }
+                return it->second;
+            }
+
+            inline T value(const Key& k, const T& defaultV=T()) const  {
+                  const_iterator it=find(k);
+                  if (it==this->end()) {
+                      return defaultV;
+                  }
+                  return it->second;
+            }
+
+            inline JKMP::vector<Key> keys() const {
+                JKMP::vector<Key> k;
+                k.reserve(items.size());
+                for (auto it=items.begin(); it!=items.end(); ++it) {
+                    k.push_back(it->first);
+                }
+                return k;
+            }
+
+            inline bool operator==(const flatmap& other) const { return items==other.items; }
+            inline bool operator!=(const flatmap& other) const { return !(items==other.items); }
+
+        private:
+            inline iterator lowerBound(const Key& k) {
+                return std::lower_bound(items.begin(), items.end(), k, [](const value_type& a, const Key& b) { return a.first<b; });
+            }
+            inline const_iterator lowerBound(const Key& k) const {
+                return std::lower_bound(items.begin(), items.end(), k, [](const value_type& a, const Key& b) { return a.first<b; });
+            }
+
+            std::vector<value_type> items;
+    };
+
+
+    /** \brief a persistent vector with value semantics, whose copies share their data (a bit-partitioned trie with 32-way nodes and a tail
+     *         buffer, as the vectors in Clojure).
+     *
+     *  Copying a sharedvector is O(1), reading an item is O(log32 N) and push_back() is amortized O(1), also if other copies of the vector
+     *  exist: a copy never observes the changes of another copy, as shared nodes are copied before they are changed. Changing an item
+     *  through the non-const operator[] copies at most one node per level. insert(), erase() and push_front() rebuild the vector (O(N)),
+     *  except when they append at the end.
+     *
+     *  Nodes are only changed in place, when no other copy references them, so different copies may be used in different threads.
+     */
+    template <class T>
+    class sharedvector {
+        private:
+            enum { BITS=5, WIDTH=1<<BITS, MASK=WIDTH-1 };
+            struct Node {
+                /** \brief children of an inner node */
+                std::vector<std::shared_ptr<Node> > children;
+                /** \brief items of a leaf */
+                std::vector<T> values;
+            };
+            typedef std::shared_ptr<Node> NodePtr;
+
+        public:
+            typedef T value_type;
+
+            /** \brief a random access iterator over the items of a sharedvector (read-only) */
+            class const_iterator {
+                public:
+                    typedef std::random_access_iterator_tag iterator_category;
+                    typedef T value_type;
+                    typedef ptrdiff_t difference_type;
+                    typedef const T* pointer;
+                    typedef const T& reference;
+
+                    inline const_iterator(): v(NULL), i(0) {}
+                    inline const_iterator(const sharedvector* v, size_t i): v(v), i(i) {}
+                    inline const T& operator*() const { return (*v)[i]; }
+                    inline const T* operator->() const { return &((*v)[i]); }
+                    inline const_iterator& operator++() { i++; return *this; }
+                    inline const_iterator operator++(int) { const_iterator r=*this; i++; return r; }
+                    inline const_iterator& operator--() { i--; return *this; }
+                    inline const_iterator operator--(int) { const_iterator r=*this; i--; return r; }
+                    inline const_iterator& operator+=(difference_type n) { i+=n; return *this; }
+                    inline const_iterator& operator-=(difference_type n) { i-=n; return *this; }
+                    inline const_iterator operator+(difference_type n) const { return const_iterator(v, i+n); }
+                    inline const_iterator operator-(difference_type n) const { return const_iterator(v, i-n); }
+                    inline difference_type operator-(const const_iterator& o) const { return static_cast<difference_type>(i)-static_cast<difference_type>(o.i); }
+                    inline const T& operator[](difference_type n) const { return (*v)[i+n]; }
+                    inline bool operator==(const const_iterator& o) const { return i==o.i; }
+                    inline bool operator!=(const const_iterator& o) const { return i!=o.i; }
+                    inline bool operator<(const const_iterator& o) const { return i<o.i; }
+                    /** \brief index of the item in the vector */
+                    inline size_t index() const { return i; }
+                private:
+                    const sharedvector* v;
+                    size_t i;
+            };
+            typedef const_iterator iterator;
+
+            inline sharedvector(): cnt(0), shift(BITS) {}
+            inline sharedvector(const std::vector<T>& v): cnt(0), shift(BITS) {
+                for (size_t i=0; i<v.size(); i++) push_back(v[i]);
+            }
+
+            inline size_t size() const { return cnt; }
+            inline bool empty() const { return cnt==0; }
+            inline bool is_empty() const { return cnt==0; }
+            inline void clear() { cnt=0; shift=BITS; root.reset(); tail.reset(); }
+            inline void reserve(size_t /*n*/) {}
+
+            inline const_iterator begin() const { return const_iterator(this, 0); }
+            inline const_iterator end() const { return const_iterator(this, cnt); }
+
+            inline const T& operator[](size_t i) const {
+                if (i>=tailOffset()) return (*tail)[i-tailOffset()];
+                const Node* node=root.get();
+                for (unsigned int level=shift; level>0; level-=BITS) {
+                    node=node->children[(i>>level)&MASK].get();
+                }
+                return node->values[i&MASK];
+            }
+            inline const T& at(size_t i) const {
+                if (i>=cnt) throw std::out_of_range("index out of range in sharedvector");
+                return (*this)[i];
+            }
+            /** \brief returns a reference to the item \a i, the nodes on the path to the item are copied first, if they are shared with other copies */
+            inline T& operator[](size_t i) {
+                if (i>=tailOffset()) {
+                    makeTailUnique();
+                    return (*tail)[i-tailOffset()];
+                }
+                if (root.use_count()!=1) root=std::make_shared<Node>(*root);
+                Node* node=root.get();
+                for (unsigned int level=shift; level>0; level-=BITS) {
+                    NodePtr& c=node->children[(i>>level)&MASK];
+                    if (c.use_count()!=1) c=std::make_shared<Node>(*c);
+                    node=c.get();
+                }
+                return node->values[i&MASK];
+            }
+            inline const T& front() const { return (*this)[0]; }
+            inline T& front() { return (*this)[0]; }
+            inline const T& back() const { return (*this)[cnt-1]; }
+            inline T& back() { return (*this)[cnt-1]; }
+
+            inline void push_back(const T& v) {
+                if (cnt-tailOffset()<WIDTH) {
+                    makeTailUnique();
+                    tail->push_back(v);
+                    cnt++;
+                    return;
+                }
+                // the tail is full: move it into the tree
+                NodePtr tailNode=std::make_shared<Node>();
+                if (tail.use_count()==1) tailNode->values.swap(*tail);
+                else tailNode->values=*tail;
+                if (!root) {
+                    root=tailNode;
+                    shift=0;
+                } else if ((cnt>>BITS)>(size_t(1)<<shift)) {
+                    NodePtr newroot=std::make_shared<Node>();
+                    newroot->children.push_back(root);
+                    newroot->children.push_back(newPath(shift, tailNode));
+                    root=newroot;
+                    shift+=BITS;
+                } else {
+                    root=pushTail(shift, root, tailNode);
+                }
+                tail=std::make_shared<std::vector<T> >();
+                tail->reserve(WIDTH);
+                tail->push_back(v);
+                cnt++;
+            }
+            inline void push_front(const T& v) { insert(begin(), v); }
+
+            inline const_iterator insert(const_iterator pos, const T& v) {
+                const size_t idx=pos.index();
+                if (idx>=cnt) {
+                    push_back(v);
+                } else {
+                    std::vector<T> items=toVector();
+                    items.insert(items.begin()+idx, v);
+                    assign(items);
+                }
+                return const_iterator(this, idx);
+            }
+            inline const_iterator erase(const_iterator pos) {
+                const size_t idx=pos.index();
+                if (idx<cnt) {
+                    std::vector<T> items=toVector();
+                    items.erase(items.begin()+idx);
+                    assign(items);
+                }
+                return const_iterator(this, idx);
+            }
+            inline void resize(size_t n, const T& val=T()) {
+                if (n<cnt) {
+                    std::vector<T> items=toVector();
+                    items.resize(n);
+                    assign(items);
+                } else {
+                    while (cnt<n) push_back(val);
+                }
+            }
+
+            inline sharedvector& operator<<(const sharedvector& v) {
+                for (size_t i=0; i<v.size(); i++) push_back(v[i]);
+                return *this;
+            }
+            inline sharedvector& operator<<(const T& v) {
+                push_back(v);
+                return *this;
+            }
+
+            /** \brief returns the items as JKMP::vector */
+            inline JKMP::vector<T> toVector() const {
+                JKMP::vector<T> res;
+                res.reserve(cnt);
+                for (size_t i=0; i<cnt; i++) res.push_back((*this)[i]);
+                return res;
+            }
+
+            inline bool operator==(const sharedvector& other) const {
+                if (cnt!=other.cnt) return false;
+                if (root==other.root && tail==other.tail) return true;
+                for (size_t i=0; i<cnt; i++) {
+                    if (!((*this)[i]==other[i])) return false;
+                }
+                return true;
+            }
+            inline bool operator!=(const sharedvector& other) const { return !operator==(other); }
+
+        private:
+            /** \brief number of items */
+            size_t cnt;
+            /** \brief shift of the index bits for the children of the root node (0 if \c root is a leaf) */
+            unsigned int shift;
+            /** \brief root of the trie, which contains all items before the tail */
+            NodePtr root;
+            /** \brief the last (up to 32) items */
+            std::shared_ptr<std::vector<T> > tail;
+
+            inline size_t tailOffset() const {
+                return (cnt==0)?0:(((cnt-1)>>BITS)<<BITS);
+            }
+            inline void makeTailUnique() {
+                if (!tail) {
+                    tail=std::make_shared<std::vector<T> >();
+                    tail->reserve(WIDTH);
+                } else if (tail.use_count()!=1) {
+                    tail=std::make_shared<std::vector<T> >(*tail);
+                    tail->reserve(WIDTH);
+                }
+            }
+            inline static NodePtr newPath(unsigned int level, const NodePtr& node) {
+                if (level==0) return node;
+                NodePtr ret=std::make_shared<Node>();
+                ret->children.push_back(newPath(level-BITS, node));
+                return ret;
+            }
+            inline NodePtr pushTail(unsigned int level, const NodePtr& parent, const NodePtr& tailNode) {
+                // the (full) tail holds the items cnt-WIDTH..cnt-1, its leaf goes to the path of item cnt-1
+                const size_t subidx=((cnt-1)>>level)&MASK;
+                NodePtr ret=(parent.use_count()==1)?parent:std::make_shared<Node>(*parent);
+                NodePtr insert;
+                if (level==BITS) {
+                    insert=tailNode;
+                } else if (subidx<ret->children.size()) {
+                    insert=pushTail(level-BITS, ret->children[subidx], tailNode);
+                } else {
+                    insert=newPath(level-BITS, tailNode);
+                }
+                if (subidx<ret->children.size()) ret->children[subidx]=insert;
+                else ret->children.push_back(insert);
+                return ret;
+            }
+            inline void assign(const std::vector<T>& items) {
+                clear();
+                for (size_t i=0; i<items.size(); i++) push_back(items[i]);
+            }
+    };
+
+
+
+    /*! \brief finds the distinct items of \a input with a hash table, i.e. in \c O(n) on average
+        \ingroup qf3lib_tools
+
+        Returns the index of the first occurence of every distinct item, in the order of these first occurences. If \a inverse
+        is not \c NULL, it is set to the position of the value of every item of \a input in the returned vector. Items that do not
+        compare equal to themselves (\c NaN ) are all distinct. \a THash is the hash function of the items.
+
+        The hash table uses open addressing with linear probing and only stores positions in the returned vector,
+        so it is compact and cache-friendly. It is kept at most half full.
+     */
+    template <typename TVec, typename THash=std::hash<typename TVec::value_type> >
+    inline std::vector<size_t> uniqueIndex(const TVec& input, std::vector<size_t>* inverse=NULL) {
+        const size_t empty=size_t(-1);
+        const THash hash=THash();
+        std::vector<size_t> first;
+        std::vector<size_t> table(64, empty);
+        size_t mask=table.size()-1;
+        if (inverse) inverse->resize(input.size());
+        for (size_t i=0; i<input.size(); i++) {
+            size_t slot=hash(input[i])&mask;
+            while (table[slot]!=empty && !(input[first[table[slot]]]==input[i])) {
+                slot=(slot+1)&mask;
+            }
+            if (table[slot]==empty) {
+                table[slot]=first.size();
+                first.push_back(i);
+                if (2*first.size()>table.size()) {
+                    // grow and rehash the distinct items
+                    table.assign(2*table.size(), empty);
+                    mask=table.size()-1;
+                    for (size_t k=0; k<first.size(); k++) {
+                        size_t s=hash(input[first[k]])&mask;
+                        while (table[s]!=empty) s=(s+1)&mask;
+                        table[s]=k;
+                    }
+                }
+                if (inverse) (*inverse)[i]=first.size()-1;
+            } else if (inverse) {
+                (*inverse)[i]=table[slot];
+            }
+        }
+        return first;
+    }
+
+    /*! \brief sets \a group to the dense group ids (see uniqueIndex() ) of the first \a n items of \a index and returns the number of groups
+        \ingroup qf3lib_tools
+
+     */
+    template <typename TIDXVec>
+    inline size_t uniqueGroups(const TIDXVec& index, size_t n, std::vector<size_t>& group) {
+        if (n>=index.size()) return uniqueIndex(index, &group).size();
+        TIDXVec head;
+        for (size_t i=0; i<n; i++) head.push_back(index[i]);
+        return uniqueIndex(head, &group).size();
+    }
 
     /*! \brief group the data in \a input according to the labels given in \a index. Then return a vector where the function \a func is applied to every vector of values from \input, which all have the same index in \a index.
         \ingroup qf3lib_tools
 
+        The groups are in the order of the first occurence of their label. For the numeric aggregates of the parser, see JKMP::groupAggregate(),
+        which does not copy the data.
      */
     template <typename TVec, typename TIDXVec, typename TFUNC>
     inline TVec uniqueApplyFunction(const TVec& input, const TIDXVec& index, TFUNC func) {
-        TVec res;
-        JKMP::map<typename TIDXVec::value_type, TVec > dataset;
-        JKMP::vector<typename TIDXVec::value_type> idxl;
-        for (size_t i=0; i<std::min(input.size(), index.size()); i++) {
-            dataset[index[i]].push_back(input[i]);
-            if (!idxl.contains(index[i])) idxl<<index[i];
+        const size_t n=std::min(input.size(), index.size());
+        std::vector<size_t> group;
+        std::vector<TVec> dataset(uniqueGroups(index, n, group));
+        for (size_t i=0; i<n; i++) {
+            dataset[group[i]].push_back(input[i]);
         }
-        for (size_t i=0; i<idxl.size(); i++) {
-            res<<func(dataset[idxl[i]]);
+        TVec res;
+        for (size_t i=0; i<dataset.size(); i++) {
+            res<<func(dataset[i]);
         }
         return res;
     }
@@ -254,15 +668,15 @@ namespace JKMP {
      */
     template <typename TVec, typename TIDXVec, typename TFUNC, typename TFUNCPARAM>
     inline TVec uniqueApplyFunction(const TVec& input, const TIDXVec& index, TFUNC func, TFUNCPARAM funcParam) {
-        TVec res;
-        JKMP::map<typename TIDXVec::value_type, TVec > dataset;
-        JKMP::vector<typename TIDXVec::value_type> idxl;
-        for (size_t i=0; i<std::min(input.size(), index.size()); i++) {
-            dataset[index[i]].push_back(input[i]);
-            if (!idxl.contains(index[i])) idxl<<index[i];
+        const size_t n=std::min(input.size(), index.size());
+        std::vector<size_t> group;
+        std::vector<TVec> dataset(uniqueGroups(index, n, group));
+        for (size_t i=0; i<n; i++) {
+            dataset[group[i]].push_back(input[i]);
         }
-        for (size_t i=0; i<idxl.size(); i++) {
-            res<<func(dataset[idxl[i]], funcParam);
+        TVec res;
+        for (size_t i=0; i<dataset.size(); i++) {
+            res<<func(dataset[i], funcParam);
         }
         return res;
     }
@@ -275,16 +689,16 @@ namespace JKMP {
      */
     template <typename TVec, typename TIDXVec, typename TFUNC>
     inline TVec uniqueApplyFunction2I(const TVec& input, const TVec& inputY, const TIDXVec& index, TFUNC func) {
-        TVec res;
-        JKMP::map<typename TIDXVec::value_type, std::pair<TVec , TVec > > dataset;
-        JKMP::vector<typename TIDXVec::value_type> idxl;
-        for (size_t i=0; i<std::min(input.size(), index.size()); i++) {
-            dataset[index[i]].first.push_back(input[i]);
-            dataset[index[i]].second.push_back(inputY[i]);
-            if (!idxl.contains(index[i])) idxl<<index[i];
+        const size_t n=std::min(input.size(), index.size());
+        std::vector<size_t> group;
+        std::vector<std::pair<TVec, TVec> > dataset(uniqueGroups(index, n, group));
+        for (size_t i=0; i<n; i++) {
+            dataset[group[i]].first.push_back(input[i]);
+            dataset[group[i]].second.push_back(inputY[i]);
         }
-        for (size_t i=0; i<idxl.size(); i++) {
-            res<<func(dataset[idxl[i]].first, dataset[idxl[i]].second);
+        TVec res;
+        for (size_t i=0; i<dataset.size(); i++) {
+            res<<func(dataset[i].first, dataset[i].second);
         }
         return res;
     }
@@ -105,6 +105,18 @@ void JKMathParser_DefaultLib::addDefaultFunctions(JKMathParser* p)
     p->addFunction("vec2mat", JKMathParser_DefaultLib::fVec2Mat);
     p->addFunction("mat2vec", JKMathParser_DefaultLib::fMat2Vec);
     p->addFunction("reshape", JKMathParser_DefaultLib::fReshape);
+    p->addFunction("matmul", JKMathParser_DefaultLib::fMatMul);
+    p->addFunction("transpose", JKMathParser_DefaultLib::fTranspose);
+    p->addFunction("solve", JKMathParser_DefaultLib::fSolve);
+    p->addFunction("inv", JKMathParser_DefaultLib::fInv);
+    p->addFunction("det", JKMathParser_DefaultLib::fDet);
+    p->addFunction("fft", JKMathParser_DefaultLib::fFFT);
+    p->addFunction("ifft", JKMathParser_DefaultLib::fIFFT);
+    p->addFunction("rfft", JKMathParser_DefaultLib::fRFFT);
+    p->addFunction("irfft", JKMathParser_DefaultLib::fIRFFT);
+    p->addFunction("fftconvolve", JKMathParser_DefaultLib::fFFTConvolve);
+    p->addFunction("xcorr", JKMathParser_DefaultLib::fXCorr);
+    p->addFunction("autocorr", JKMathParser_DefaultLib::fAutoCorr);
 
 
     p->addFunction("struct", JKMathParser_DefaultLib::fStruct);
@@ -125,25 +137,31 @@ void JKMathParser_DefaultLib::addDefaultFunctions(JKMathParser* p)
     p->addFunction("atan", JKMathParser_DefaultLib::fATan, NULL, atan);
     p->addFunction("atan2", JKMathParser_DefaultLib::fATan2, NULL, NULL, atan2);
     p->addFunction("sin", JKMathParser_DefaultLib::fSin, NULL, sin);
+    p->setVectorFunction("sin", JKMP::vecSin);
     p->addFunction("cos", JKMathParser_DefaultLib::fCos, NULL, cos);
+    p->setVectorFunction("cos", JKMP::vecCos);
     p->addFunction("tan", JKMathParser_DefaultLib::fTan, NULL, tan);
     p->addFunction("sinh", JKMathParser_DefaultLib::fSinh, NULL, sinh);
     p->addFunction("cosh", JKMathParser_DefaultLib::fCosh, NULL, cosh);
     p->addFunction("tanh", JKMathParser_DefaultLib::fTanh, NULL, tanh);
-    p->addFunction("asinh", JKMathParser_DefaultLib::fASinh, NULL, sinh);
-    p->addFunction("acosh", JKMathParser_DefaultLib::fACosh, NULL, cosh);
-    p->addFunction("atanh", JKMathParser_DefaultLib::fATanh, NULL, tanh);
+    p->setVectorFunction("tanh", JKMP::vecTanh);
+    p->addFunction("asinh", JKMathParser_DefaultLib::fASinh, NULL, asinh);
+    p->addFunction("acosh", JKMathParser_DefaultLib::fACosh, NULL, acosh);
+    p->addFunction("atanh", JKMathParser_DefaultLib::fATanh, NULL, atanh);
     p->addFunction("log", JKMathParser_DefaultLib::fLog, NULL, log);
+    p->setVectorFunction("log", JKMP::vecLog);
     p->addFunction("log2", JKMathParser_DefaultLib::fLog2, NULL, log2);
     p->addFunction("log10", JKMathParser_DefaultLib::fLog10, NULL, log10);
     p->addFunction("exp", JKMathParser_DefaultLib::fExp, NULL, exp);
+    p->setVectorFunction("exp", JKMP::vecExp);
     p->addFunction("sqrt", JKMathParser_DefaultLib::fSqrt, NULL, sqrt);
+    p->setVectorFunction("sqrt", JKMP::vecSqrt);
     p->addFunction("cbrt", JKMathParser_DefaultLib::fCbrt, NULL, cbrt);
     p->addFunction("sqr", JKMathParser_DefaultLib::fSqr, NULL, JKMP::sqrNR);
     p->addFunction("abs", JKMathParser_DefaultLib::fAbs, NULL, fabs);
     p->addFunction("erf", JKMathParser_DefaultLib::fErf, NULL, erf);
     p->addFunction("erfc", JKMathParser_DefaultLib::fErfc, NULL, erfc);
-    p->addFunction("lgamma", JKMathParser_DefaultLib::flGamma, NULL, lgamma);
+    p->addFunction("lgamma", JKMathParser_DefaultLib::flGamma, NULL, JKMP::logGamma);
     p->addFunction("tgamma", JKMathParser_DefaultLib::ftGamma, NULL, tgamma);
     p->addFunction("j0", JKMathParser_DefaultLib::fJ0, NULL, j0);
     p->addFunction("j1", JKMathParser_DefaultLib::fJ1, NULL, j1);
@@ -164,6 +182,15 @@ void JKMathParser_DefaultLib::addDefaultFunctions(JKMathParser* p)
     p->addFunction("randnormvec_seed", JKMathParser_DefaultLib::fRandNormVecSeed);
     p->addFunction("randboolvec_seed", JKMathParser_DefaultLib::fRandBoolVecSeed);
     p->addFunction("srand", JKMathParser_DefaultLib::fSRand, NULL, JKMathParser_DefaultLib::fSRand);
+    p->setFunctionHasSideEffects("rand");
+    p->setFunctionHasSideEffects("randint");
+    p->setFunctionHasSideEffects("randnorm");
+    p->setFunctionHasSideEffects("randbool");
+    p->setFunctionHasSideEffects("randvec");
+    p->setFunctionHasSideEffects("randintvec");
+    p->setFunctionHasSideEffects("randnormvec");
+    p->setFunctionHasSideEffects("randboolvec");
+    p->setFunctionHasSideEffects("srand");
     p->addFunction("ceil", JKMathParser_DefaultLib::fCeil, NULL, ceil);
     p->addFunction("floor", JKMathParser_DefaultLib::fFloor, NULL, floor);
     p->addFunction("trunc", JKMathParser_DefaultLib::fTrunc, NULL, trunc);
@@ -215,9 +242,11 @@ void JKMathParser_DefaultLib::addDefaultFunctions(JKMathParser* p)
     p->addFunction("quantile", JKMathParser_DefaultLib::fQuantile);
     p->addFunction("quantile25", JKMathParser_DefaultLib::fQuantile25);
     p->addFunction("quantile75", JKMathParser_DefaultLib::fQuantile75);
+    p->addFunction("quantiles", JKMathParser_DefaultLib::fQuantiles);
     p->addFunction("remove", JKMathParser_DefaultLib::fRemove);
     p->addFunction("removeall", JKMathParser_DefaultLib::fRemoveAll);
     p->addFunction("shuffle", JKMathParser_DefaultLib::fShuffle);
+    p->setFunctionHasSideEffects("shuffle");
     p->addFunction("reverse", JKMathParser_DefaultLib::fReverse);
     p->addFunction("find", JKMathParser_DefaultLib::fFind);
     p->addFunction("findfirst", JKMathParser_DefaultLib::fFindFirst);
@@ -266,6 +295,9 @@ void JKMathParser_DefaultLib::addDefaultFunctions(JKMathParser* p)
     p->addFunction("isdoublematrix", JKMathParser_DefaultLib::fIsDoubleMatrix);
 
     p->addFunction("unique", JKMathParser_DefaultLib::fUnique);
+    p->addFunction("uniquesorted", JKMathParser_DefaultLib::fUniqueSorted);
+    p->addFunction("uniquecounts", JKMathParser_DefaultLib::fUniqueCounts);
+    p->addFunction("uniqueindices", JKMathParser_DefaultLib::fUniqueIndices);
     p->addFunction("indexedmean", JKMathParser_DefaultLib::fIndexedAvg);
     p->addFunction("indexedvar", JKMathParser_DefaultLib::fIndexedVar);
     p->addFunction("indexedstd", JKMathParser_DefaultLib::fIndexedStd);
@@ -337,6 +369,7 @@ void JKMathParser_DefaultLib::addDefaultFunctions(JKMathParser* p)
 
 /*
     p->addFunction("now", JKMathParser_DefaultLib::fNow);
+    p->setFunctionHasSideEffects("now");
     p->addFunction("datenum", JKMathParser_DefaultLib::fDateNum);
     p->addFunction("datetimenum", JKMathParser_DefaultLib::fDateTimeNum);
     p->addFunction("date2str", JKMathParser_DefaultLib::fDate2Str);
@@ -454,17 +487,17 @@ namespace JKMathParser_DefaultLib {
                         r.strVec[i]=params[1].strVec[i%params[1].strVec.size()];
                     }
                 } else {
-                    p->jkmpError(JKMP::_("repeat(x,value) the argument value is of type '%1', which cannot be replicated into a vector").arg(params[1].typeName()));
+                    JKMATHPARSER_ERROR(p, JKMP::_("repeat(x,value) the argument value is of type '%1', which cannot be replicated into a vector").arg(params[1].typeName()));
                     r.setInvalid();
                     return;
                 }
             } else {
-                p->jkmpError(JKMP::_("repeat(x,value) needs a positive integer as first argument"));
+                JKMATHPARSER_ERROR(p, JKMP::_("repeat(x,value) needs a positive integer as first argument"));
                 r.setInvalid();
                 return;
             }
         } else {
-            p->jkmpError(JKMP::_("repeat(x,value) needs at 2 arguments"));
+            JKMATHPARSER_ERROR(p, JKMP::_("repeat(x,value) needs at 2 arguments"));
             r.setInvalid();
             return;
         }
@@ -481,17 +514,17 @@ namespace JKMathParser_DefaultLib {
                         r.str.push_back(params[1].str);
                     }
                 } else {
-                    p->jkmpError(JKMP::_("repeatstring(x,text) the argument text is of type '%1', but has to be a string").arg(params[1].typeName()));
+                    JKMATHPARSER_ERROR(p, JKMP::_("repeatstring(x,text) the argument text is of type '%1', but has to be a string").arg(params[1].typeName()));
                     r.setInvalid();
                     return;
                 }
             } else {
-                p->jkmpError(JKMP::_("repeatstring(x,text) needs a positive integer as first argument"));
+                JKMATHPARSER_ERROR(p, JKMP::_("repeatstring(x,text) needs a positive integer as first argument"));
                 r.setInvalid();
                 return;
             }
         } else {
-            p->jkmpError(JKMP::_("repeatstring(x,text) needs at 2 arguments"));
+            JKMATHPARSER_ERROR(p, JKMP::_("repeatstring(x,text) needs at 2 arguments"));
             r.setInvalid();
             return;
         }
@@ -518,7 +551,7 @@ namespace JKMathParser_DefaultLib {
         } else if (n==1 && params[0].type==jkmpBoolMatrix) {
             r.setBoolVec(params[0].boolVec);
         } else {
-            p->jkmpError(JKMP::_("mat2vec(x) needs one matrix argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("mat2vec(x) needs one matrix argument"));
             r.setInvalid();
             return;
         }
@@ -528,19 +561,19 @@ namespace JKMathParser_DefaultLib {
         int cols=1;
         if (n>=1 && params[1].isUInt()) cols=params[1].toUInt();
         else if (n>=1) {
-            p->jkmpError(JKMP::_("vec2mat(x, cols) cols has to be an unsigned inetegr!"));
+            JKMATHPARSER_ERROR(p, JKMP::_("vec2mat(x, cols) cols has to be an unsigned inetegr!"));
             r.setInvalid();
             return;
         }
         if (cols<1) {
-            p->jkmpError(JKMP::_("vec2mat(x, cols) cols has to be a positive integer, but was <=0 !"));
+            JKMATHPARSER_ERROR(p, JKMP::_("vec2mat(x, cols) cols has to be a positive integer, but was <=0 !"));
             r.setInvalid();
             return;
         }
         if (n>0 && params[0].type==jkmpDoubleVector) {
             int rows=params[0].numVec.size()/cols;
             if (params[0].numVec.size()!=rows*cols) {
-                p->jkmpError(JKMP::_("vec2mat(x[, cols]) determined a matrix size of %1x%2 = %3 entries, but the vector has %4 elements").arg(rows).arg(cols).arg(rows*cols).arg(params[0].numVec.size()));
+                JKMATHPARSER_ERROR(p, JKMP::_("vec2mat(x[, cols]) determined a matrix size of %1x%2 = %3 entries, but the vector has %4 elements").arg(rows).arg(cols).arg(rows*cols).arg(params[0].numVec.size()));
                 r.setInvalid();
                 return;
             }
@@ -550,7 +583,7 @@ namespace JKMathParser_DefaultLib {
         } else if (n>0 && params[0].type==jkmpBoolVector) {
             int rows=params[0].boolVec.size()/cols;
             if (params[0].boolVec.size()!=rows*cols) {
-                p->jkmpError(JKMP::_("vec2mat(x[, cols]) determined a matrix size of %1x%2 = %3 entries, but the vector has %4 elements").arg(rows).arg(cols).arg(rows*cols).arg(params[0].boolVec.size()));
+                JKMATHPARSER_ERROR(p, JKMP::_("vec2mat(x[, cols]) determined a matrix size of %1x%2 = %3 entries, but the vector has %4 elements").arg(rows).arg(cols).arg(rows*cols).arg(params[0].boolVec.size()));
                 r.setInvalid();
                 return;
             }
@@ -558,7 +591,7 @@ namespace JKMathParser_DefaultLib {
             r.type=jkmpBoolMatrix;
             r.matrix_columns=cols;
         } else {
-            p->jkmpError(JKMP::_("vec2mat(x[, cols]) needs one number or boolean vector argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("vec2mat(x[, cols]) needs one number or boolean vector argument"));
             r.setInvalid();
             return;
         }
@@ -572,7 +605,7 @@ namespace JKMathParser_DefaultLib {
 
             if (n>0 && (params[0].type==jkmpDoubleVector || params[0].type==jkmpDoubleMatrix)) {
                 if (params[0].numVec.size()!=rows*cols) {
-                    p->jkmpError(JKMP::_("reshape(x, rows, cols) requires a matrix of size %1x%2 = %3 entries, but the matrix has %4 elements").arg(rows).arg(cols).arg(rows*cols).arg(params[0].numVec.size()));
+                    JKMATHPARSER_ERROR(p, JKMP::_("reshape(x, rows, cols) requires a matrix of size %1x%2 = %3 entries, but the matrix has %4 elements").arg(rows).arg(cols).arg(rows*cols).arg(params[0].numVec.size()));
                     r.setInvalid();
                     return;
                 }
@@ -581,7 +614,7 @@ namespace JKMathParser_DefaultLib {
                 r.matrix_columns=cols;
             } else if (n>0 &&(params[0].type==jkmpBoolVector || params[0].type==jkmpBoolMatrix)) {
                 if (params[0].boolVec.size()!=rows*cols) {
-                    p->jkmpError(JKMP::_("reshape(x, rows, cols) requires a matrix of size %1x%2 = %3 entries, but the matrix has %4 elements").arg(rows).arg(cols).arg(rows*cols).arg(params[0].boolVec.size()));
+                    JKMATHPARSER_ERROR(p, JKMP::_("reshape(x, rows, cols) requires a matrix of size %1x%2 = %3 entries, but the matrix has %4 elements").arg(rows).arg(cols).arg(rows*cols).arg(params[0].boolVec.size()));
                     r.setInvalid();
                     return;
                 }
@@ -589,16 +622,314 @@ namespace JKMathParser_DefaultLib {
                 r.type=jkmpBoolMatrix;
                 r.matrix_columns=cols;
             } else {
-                p->jkmpError(JKMP::_("reshape(x, rows, cols) unsupported matrix type!"));
+                JKMATHPARSER_ERROR(p, JKMP::_("reshape(x, rows, cols) unsupported matrix type!"));
                 r.setInvalid();
                 return;
             }
         } else {
-            p->jkmpError(JKMP::_("reshape(x, rows, cols) needs exactly three arguments, one matrix and two positive integers!"));
+            JKMATHPARSER_ERROR(p, JKMP::_("reshape(x, rows, cols) needs exactly three arguments, one matrix and two positive integers!"));
             r.setInvalid();
             return;
         }
     }
+    /** \brief returns the rows and columns of the number matrix, vector or number \a m (a vector is a column, if \a vectorIsColumn, else a row) */
+    static bool matrixOperandSize(const jkmpResult& m, bool vectorIsColumn, size_t& rows, size_t& cols) {
+        if (m.type==jkmpDoubleMatrix) {
+            cols=m.matrix_columns;
+            rows=(cols>0)?(m.numVec.size()/cols):0;
+        } else if (m.type==jkmpDoubleVector) {
+            rows=vectorIsColumn?m.numVec.size():1;
+            cols=vectorIsColumn?1:m.numVec.size();
+        } else if (m.type==jkmpDouble) {
+            rows=cols=1;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /** \brief returns a pointer to the items of the number matrix, vector or number \a m */
+    static const double* matrixOperandData(const jkmpResult& m) {
+        return (m.type==jkmpDouble)?(&m.num):m.numVec.data();
+    }
+
+    void fMatMul(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        size_t rowsA=0, colsA=0, rowsB=0, colsB=0;
+        if (n!=2 || !matrixOperandSize(params[0], false, rowsA, colsA) || !matrixOperandSize(params[1], true, rowsB, colsB)) {
+            JKMATHPARSER_ERROR(p, JKMP::_("matmul(A, B) needs two number matrix or vector arguments"));
+            r.setInvalid();
+            return;
+        }
+        if (colsA!=rowsB) {
+            JKMATHPARSER_ERROR(p, JKMP::_("matmul(A, B) needs a %1x%2 matrix B for the %3x%4 matrix A, but B is %5x%6").arg(colsA).arg(colsB).arg(rowsA).arg(colsA).arg(rowsB).arg(colsB));
+            r.setInvalid();
+            return;
+        }
+        JKMP::vector<double> res(rowsA*colsB, 0.0);
+        JKMP::matrixMultiply(matrixOperandData(params[0]), matrixOperandData(params[1]), res.data(), rowsA, colsA, colsB, jkmpParallelVectorPool(p, rowsA*colsA*colsB));
+        if (params[0].type!=jkmpDoubleMatrix && params[1].type!=jkmpDoubleMatrix) {
+            r.setDouble(res.size()>0?res[0]:0.0);
+        } else if (params[0].type!=jkmpDoubleMatrix || params[1].type!=jkmpDoubleMatrix) {
+            r.setDoubleVec(res);
+        } else {
+            r.setDoubleVec(res);
+            r.type=jkmpDoubleMatrix;
+            r.matrix_columns=colsB;
+        }
+    }
+
+    void fTranspose(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        if (n==1 && params[0].type==jkmpDoubleMatrix) {
+            const size_t cols=params[0].matrix_columns;
+            const size_t rows=params[0].numVec.size()/cols;
+            r.setDoubleMatrix(params[0].numVec.size(), rows);
+            JKMP::matrixTranspose(params[0].numVec.data(), r.numVec.data(), rows, cols);
+        } else if (n==1 && params[0].type==jkmpBoolMatrix) {
+            const size_t cols=params[0].matrix_columns;
+            const size_t rows=params[0].boolVec.size()/cols;
+            r.setBoolMatrix(params[0].boolVec.size(), rows);
+            for (size_t i=0; i<rows; i++) {
+                for (size_t j=0; j<cols; j++) {
+                    r.boolVec[j*rows+i]=params[0].boolVec[i*cols+j];
+                }
+            }
+        } else if (n==1 && (params[0].type==jkmpDoubleVector || params[0].type==jkmpBoolVector || params[0].type==jkmpDouble || params[0].type==jkmpBool)) {
+            r=params[0];
+        } else {
+            JKMATHPARSER_ERROR(p, JKMP::_("transpose(A) needs one matrix or vector argument"));
+            r.setInvalid();
+            return;
+        }
+    }
+
+    /** \brief LU-decomposes the square number matrix \a A of the function \a func , reports an error and returns \c false , if \a A is not square */
+    static bool matrixLUOperand(const jkmpResult& A, JKMP::vector<double>& LU, std::vector<size_t>& perm, int& sign, size_t& size, const char* func, JKMathParser *p) {
+        size_t rows=0, cols=0;
+        if (A.type==jkmpDoubleVector || !matrixOperandSize(A, false, rows, cols) || rows!=cols) {
+            JKMATHPARSER_ERROR(p, JKMP::_("%1 needs a square number matrix").arg(JKMP::string(func)));
+            return false;
+        }
+        size=rows;
+        LU=JKMP::vector<double>(matrixOperandData(A), matrixOperandData(A)+size*size);
+        perm.resize(size);
+        sign=JKMP::matrixLU(LU.data(), size, perm.data(), jkmpParallelVectorPool(p, size*size*size));
+        return true;
+    }
+
+    void fSolve(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        JKMP::vector<double> LU;
+        std::vector<size_t> perm;
+        int sign=0;
+        size_t size=0, rowsB=0, colsB=0;
+        if (n!=2 || !matrixOperandSize(params[1], true, rowsB, colsB)) {
+            JKMATHPARSER_ERROR(p, JKMP::_("solve(A, b) needs a square number matrix A and a number vector or matrix b"));
+            r.setInvalid();
+            return;
+        }
+        if (!matrixLUOperand(params[0], LU, perm, sign, size, "solve(A, b)", p)) {
+            r.setInvalid();
+            return;
+        }
+        if (rowsB!=size) {
+            JKMATHPARSER_ERROR(p, JKMP::_("solve(A, b) needs %1 rows in b for the %1x%1 matrix A, but b has %2 rows").arg(size).arg(rowsB));
+            r.setInvalid();
+            return;
+        }
+        if (sign==0) {
+            JKMATHPARSER_ERROR(p, JKMP::_("solve(A, b): the matrix A is singular"));
+            r.setInvalid();
+            return;
+        }
+        JKMP::vector<double> res(rowsB*colsB, 0.0);
+        JKMP::matrixLUSolve(LU.data(), perm.data(), size, matrixOperandData(params[1]), res.data(), colsB, jkmpParallelVectorPool(p, size*size*colsB));
+        if (params[1].type==jkmpDouble) {
+            r.setDouble(res[0]);
+        } else {
+            r.setDoubleVec(res);
+            if (params[1].type==jkmpDoubleMatrix) {
+                r.type=jkmpDoubleMatrix;
+                r.matrix_columns=colsB;
+            }
+        }
+    }
+
+    void fInv(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        JKMP::vector<double> LU;
+        std::vector<size_t> perm;
+        int sign=0;
+        size_t size=0;
+        if (n!=1 || !matrixLUOperand(params[0], LU, perm, sign, size, "inv(A)", p)) {
+            if (n!=1) JKMATHPARSER_ERROR(p, JKMP::_("inv(A) needs one square number matrix argument"));
+            r.setInvalid();
+            return;
+        }
+        if (sign==0) {
+            JKMATHPARSER_ERROR(p, JKMP::_("inv(A): the matrix A is singular"));
+            r.setInvalid();
+            return;
+        }
+        if (params[0].type==jkmpDouble) {
+            r.setDouble(1.0/params[0].num);
+            return;
+        }
+        r.setDoubleMatrix(size*size, size);
+        for (size_t i=0; i<size; i++) r.numVec[i*size+i]=1.0;
+        JKMP::matrixLUSolve(LU.data(), perm.data(), size, r.numVec.data(), r.numVec.data(), size, jkmpParallelVectorPool(p, size*size*size));
+    }
+
+    void fDet(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        JKMP::vector<double> LU;
+        std::vector<size_t> perm;
+        int sign=0;
+        size_t size=0;
+        if (n!=1 || !matrixLUOperand(params[0], LU, perm, sign, size, "det(A)", p)) {
+            if (n!=1) JKMATHPARSER_ERROR(p, JKMP::_("det(A) needs one square number matrix argument"));
+            r.setInvalid();
+            return;
+        }
+        r.setDouble(JKMP::matrixLUDeterminant(LU.data(), size, sign));
+    }
+    /** \brief reads the complex data of the \c fft...() functions: a number vector (real data) or a matrix with two columns (real and imaginary parts) */
+    static bool complexOperand(const jkmpResult& x, std::vector<JKMP::fftPlan::complexType>& data) {
+        if (x.type==jkmpDoubleVector) {
+            data.assign(x.numVec.begin(), x.numVec.end());
+        } else if (x.type==jkmpDouble) {
+            data.assign(1, JKMP::fftPlan::complexType(x.num, 0.0));
+        } else if (x.type==jkmpDoubleMatrix && x.matrix_columns==2) {
+            data.resize(x.numVec.size()/2);
+            for (size_t i=0; i<data.size(); i++) data[i]=JKMP::fftPlan::complexType(x.numVec[2*i], x.numVec[2*i+1]);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /** \brief returns the first \a count items of \a data as a matrix with two columns (real and imaginary parts), scaled by \a factor */
+    static void setComplexResult(jkmpResult& r, const std::vector<JKMP::fftPlan::complexType>& data, size_t count, double factor=1.0) {
+        r.setDoubleMatrix(2*count, 2);
+        for (size_t i=0; i<count; i++) {
+            r.numVec[2*i]=data[i].real()*factor;
+            r.numVec[2*i+1]=data[i].imag()*factor;
+        }
+    }
+
+    static void fftTransform(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p, bool inverse) {
+        std::vector<JKMP::fftPlan::complexType> data;
+        if (n!=1 || !complexOperand(params[0], data)) {
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs one number vector or a matrix with two columns (real and imaginary parts) as argument").arg(JKMP::string(inverse?"ifft":"fft")));
+            r.setInvalid();
+            return;
+        }
+        if (data.size()>0) p->getFFTPlan(data.size())->transform(data.data(), data.data(), inverse);
+        setComplexResult(r, data, data.size(), (inverse && data.size()>0)?(1.0/double(data.size())):1.0);
+    }
+
+    void fFFT(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        fftTransform(r, params, n, p, false);
+    }
+
+    void fIFFT(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        fftTransform(r, params, n, p, true);
+    }
+
+    void fRFFT(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        if (n!=1 || (params[0].type!=jkmpDoubleVector && params[0].type!=jkmpDouble)) {
+            JKMATHPARSER_ERROR(p, JKMP::_("rfft(x) needs one number vector argument"));
+            r.setInvalid();
+            return;
+        }
+        const std::vector<double> x=params[0].asVector();
+        std::vector<JKMP::fftPlan::complexType> X(x.size()/2+1);
+        if (x.size()>0) p->getFFTPlan(x.size())->realForward(x.data(), X.data());
+        setComplexResult(r, X, (x.size()>0)?X.size():0);
+    }
+
+    void fIRFFT(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        std::vector<JKMP::fftPlan::complexType> X;
+        if ((n!=1 && n!=2) || !complexOperand(params[0], X) || X.size()==0 || (n==2 && (!params[1].isUInt() || params[1].toUInt()==0))) {
+            JKMATHPARSER_ERROR(p, JKMP::_("irfft(X[, n]) needs a non-empty number vector or a matrix with two columns (real and imaginary parts) as argument X and a positive integer n"));
+            r.setInvalid();
+            return;
+        }
+        // the default length is the one rfft(x) of an even length returns, missing frequencies are 0
+        const size_t len=(n==2)?params[1].toUInt():(2*(X.size()-1));
+        if (len==0) {
+            r.setDoubleVec(0);
+            return;
+        }
+        X.resize(len/2+1, JKMP::fftPlan::complexType(0.0, 0.0));
+        r.setDoubleVec(len);
+        p->getFFTPlan(len)->realInverse(X.data(), r.numVec.data());
+        for (size_t i=0; i<len; i++) r.numVec[i]/=double(len);
+    }
+
+    /** \brief returns the plan for a convolution of \a nx and \a ny items, \c NULL if JKMP::convolve() computes it directly */
+    static std::shared_ptr<const JKMP::fftPlan> convolutionPlan(JKMathParser *p, size_t nx, size_t ny) {
+        if (nx==0 || ny==0 || std::min(nx, ny)<=JKMP_FFT_DIRECTCONVOLVE) return std::shared_ptr<const JKMP::fftPlan>();
+        return p->getFFTPlan(JKMP::fftPlan::goodSize(nx+ny-1));
+    }
+
+    void fFFTConvolve(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        if (n!=2 || !params[0].convertsToVector() || !params[1].convertsToVector()) {
+            JKMATHPARSER_ERROR(p, JKMP::_("fftconvolve(x, y) needs two number vector arguments"));
+            r.setInvalid();
+            return;
+        }
+        const std::vector<double> x=params[0].asVector();
+        const std::vector<double> y=params[1].asVector();
+        if (x.size()==0 || y.size()==0) {
+            r.setDoubleVec(0);
+            return;
+        }
+        r.setDoubleVec(x.size()+y.size()-1);
+        JKMP::convolve(x.data(), x.size(), y.data(), y.size(), r.numVec.data(), convolutionPlan(p, x.size(), y.size()).get());
+    }
+
+    void fXCorr(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        if (n!=2 || !params[0].convertsToVector() || !params[1].convertsToVector()) {
+            JKMATHPARSER_ERROR(p, JKMP::_("xcorr(x, y) needs two number vector arguments"));
+            r.setInvalid();
+            return;
+        }
+        const std::vector<double> x=params[0].asVector();
+        const std::vector<double> y=params[1].asVector();
+        if (x.size()==0 || y.size()==0) {
+            r.setDoubleVec(0);
+            return;
+        }
+        r.setDoubleVec(x.size()+y.size()-1);
+        JKMP::crossCorrelate(x.data(), x.size(), y.data(), y.size(), r.numVec.data(), convolutionPlan(p, x.size(), y.size()).get());
+    }
+
+    void fAutoCorr(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
+    {
+        if ((n!=1 && n!=2) || !params[0].convertsToVector() || (n==2 && !params[1].isUInt())) {
+            JKMATHPARSER_ERROR(p, JKMP::_("autocorr(x[, maxlag]) needs a number vector argument x and an unsigned integer maxlag"));
+            r.setInvalid();
+            return;
+        }
+        const std::vector<double> x=params[0].asVector();
+        if (x.size()==0) {
+            r.setDoubleVec(0);
+            return;
+        }
+        const size_t maxLag=(n==2)?std::min<size_t>(params[1].toUInt(), x.size()-1):(x.size()-1);
+        std::shared_ptr<const JKMP::fftPlan> plan;
+        if (maxLag>=JKMP_FFT_DIRECTCONVOLVE) plan=p->getFFTPlan(JKMP::fftPlan::goodSize(2*x.size()-1));
+        r.setDoubleVec(maxLag+1);
+        JKMP::autoCorrelate(x.data(), x.size(), r.numVec.data(), maxLag, plan.get());
+    }
     void fPrintExpression(jkmpResult& r,  JKMathParser::jkmpNode** params, unsigned int n, JKMathParser* p){
         if (n==1) {
             r.setString(params[0]->print());
@@ -608,7 +939,7 @@ namespace JKMathParser_DefaultLib {
                 r.strVec<<params[i]->print();
             }
         } else {
-            p->jkmpError(JKMP::_("printexpression(x[,...]) needs at least 1 argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("printexpression(x[,...]) needs at least 1 argument"));
             r.setInvalid();
             return;
         }
@@ -622,7 +953,7 @@ namespace JKMathParser_DefaultLib {
                 r.strVec<<params[i]->printTree();
             }
         } else {
-            p->jkmpError(JKMP::_("printexpressiontree(x[,...]) needs at least 1 argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("printexpressiontree(x[,...]) needs at least 1 argument"));
             r.setInvalid();
             return;
         }
@@ -631,7 +962,7 @@ namespace JKMathParser_DefaultLib {
 
     void fShuffle(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("shuffle"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("shuffle"));
             r.setInvalid();
             return;
         }
@@ -666,7 +997,7 @@ namespace JKMathParser_DefaultLib {
                 std::swap(r.boolVec[i], r.boolVec[j]);
             }
         } else {
-            p->jkmpError(JKMP::_("%1(x) argument has to be a vector of numbers/booleans/strings").arg("shuffle"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a vector of numbers/booleans/strings").arg("shuffle"));
             r.setInvalid();
         }
         return;
@@ -676,7 +1007,7 @@ namespace JKMathParser_DefaultLib {
     void fIsValid(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("isvalid"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("isvalid"));
             r.setInvalid();
             return;
         }
@@ -686,7 +1017,7 @@ namespace JKMathParser_DefaultLib {
     void fIsVoid(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("isvoid"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("isvoid"));
             r.setInvalid();
             return;
         }
@@ -697,7 +1028,7 @@ namespace JKMathParser_DefaultLib {
     void fIsInt(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("isint"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("isint"));
             r.setInvalid();
             return;
         }
@@ -708,7 +1039,7 @@ namespace JKMathParser_DefaultLib {
     void fIsUInt(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("isuint"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("isuint"));
             r.setInvalid();
             return;
         }
@@ -720,7 +1051,7 @@ namespace JKMathParser_DefaultLib {
     void fIsDouble(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("isdouble"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("isdouble"));
             r.setInvalid();
             return;
         }
@@ -731,7 +1062,7 @@ namespace JKMathParser_DefaultLib {
     void fIsString(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("isstring"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("isstring"));
             r.setInvalid();
             return;
         }
@@ -741,7 +1072,7 @@ namespace JKMathParser_DefaultLib {
     void fIsBool(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("isbool"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("isbool"));
             r.setInvalid();
             return;
         }
@@ -751,7 +1082,7 @@ namespace JKMathParser_DefaultLib {
     void fIsVector(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("isvector"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("isvector"));
             r.setInvalid();
             return;
         }
@@ -761,7 +1092,7 @@ namespace JKMathParser_DefaultLib {
     void fIsBoolVector(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("isboolvector"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("isboolvector"));
             r.setInvalid();
             return;
         }
@@ -771,7 +1102,7 @@ namespace JKMathParser_DefaultLib {
     void fIsDoubleVector(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("isdoublevector"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("isdoublevector"));
             r.setInvalid();
             return;
         }
@@ -781,7 +1112,7 @@ namespace JKMathParser_DefaultLib {
     void fIsStringVector(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("isstringbool"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("isstringbool"));
             r.setInvalid();
             return;
         }
@@ -795,7 +1126,7 @@ namespace JKMathParser_DefaultLib {
 
     void fAllTrue(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("alltrue"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("alltrue"));
             r.setInvalid();
             return;
         }
@@ -811,7 +1142,7 @@ namespace JKMathParser_DefaultLib {
         } else if(params[0].type==jkmpBool) {
             r.setBoolVec(params[0].boolean);
          } else {
-            p->jkmpError(JKMP::_("%1(x) argument has to be a vector of booleans").arg("alltrue"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a vector of booleans").arg("alltrue"));
             r.setInvalid();
         }
         return;
@@ -819,7 +1150,7 @@ namespace JKMathParser_DefaultLib {
 
     void fAllFalse(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("allfalse"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("allfalse"));
             r.setInvalid();
             return;
         }
@@ -835,7 +1166,7 @@ namespace JKMathParser_DefaultLib {
         } else if(params[0].type==jkmpBool) {
             r.setBoolVec(!params[0].boolean);
          } else {
-            p->jkmpError(JKMP::_("%1(x) argument has to be a vector of booleans").arg("allfalse"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a vector of booleans").arg("allfalse"));
             r.setInvalid();
         }
         return;
@@ -844,7 +1175,7 @@ namespace JKMathParser_DefaultLib {
 
     void fAnyTrue(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("anytrue"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("anytrue"));
             r.setInvalid();
             return;
         }
@@ -860,7 +1191,7 @@ namespace JKMathParser_DefaultLib {
         } else if(params[0].type==jkmpBool) {
             r.setBoolVec(params[0].boolean);
          } else {
-            p->jkmpError(JKMP::_("%1(x) argument has to be a vector of booleans").arg("anytrue"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a vector of booleans").arg("anytrue"));
             r.setInvalid();
         }
         return;
@@ -868,7 +1199,7 @@ namespace JKMathParser_DefaultLib {
 
     void fAnyFalse(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg("anyfalse"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg("anyfalse"));
             r.setInvalid();
             return;
         }
@@ -884,7 +1215,7 @@ namespace JKMathParser_DefaultLib {
         } else if(params[0].type==jkmpBool) {
             r.setBoolVec(!params[0].boolean);
          } else {
-            p->jkmpError(JKMP::_("%1(x) argument has to be a vector of booleans").arg("anyfalse"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a vector of booleans").arg("anyfalse"));
             r.setInvalid();
         }
         return;
@@ -903,7 +1234,7 @@ namespace JKMathParser_DefaultLib {
         } else if(n==1 && params[0].type==jkmpBoolVector) {
             r.setDouble(params[0].boolVec.count(true));
         } else {
-            p->jkmpError(JKMP::_("%1(x, value) argument 1 has to be a vector of numbers/booleans/strings and argument 2 the according item type number/string/boolean").arg("countoccurences"));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x, value) argument 1 has to be a vector of numbers/booleans/strings and argument 2 the according item type number/string/boolean").arg("countoccurences"));
             r.setInvalid();
         }
     }
@@ -912,7 +1243,7 @@ namespace JKMathParser_DefaultLib {
       jkmpResult r;
       r.type=jkmpDouble;
       //if (n!=1) p->jkmpError(JKMP::_("srand accepts 1 argument"));
-      if (n>=1 && params[0].type!=jkmpDouble) p->jkmpError(JKMP::_("srand needs double argument"));
+      if (n>=1 && params[0].type!=jkmpDouble) JKMATHPARSER_ERROR(p, JKMP::_("srand needs double argument"));
       r.num=0;
       //srand((unsigned int)params[0].num);
       if (n>=1) p->get_rng()->seed(uint32_t(params[0].num));
@@ -924,7 +1255,7 @@ namespace JKMathParser_DefaultLib {
     jkmpResult fRand(const jkmpResult* params, unsigned int  n, JKMathParser* p){
       jkmpResult r;
       r.type=jkmpDouble;
-      if (n>2) p->jkmpError(JKMP::_("rand accepts 0, 1 or 2 arguments"));
+      if (n>2) JKMATHPARSER_ERROR(p, JKMP::_("rand accepts 0, 1 or 2 arguments"));
       //r.num=double(rand())/double(RAND_MAX);
       if (n==0) r.num=p->get_rng()->rand();
       else if (n==2) r.num=p->get_rng()->rand()*(params[1].num-params[0].num)+params[0].num;
@@ -939,9 +1270,9 @@ namespace JKMathParser_DefaultLib {
       r.type=jkmpDouble;
       double mean=0;
       double var=1;
-      if (n>2) p->jkmpError(JKMP::_("randnorm accepts 0,1 or 2 argument"));
-      if (n>0 && (params[0].type!=jkmpDouble)) p->jkmpError(JKMP::_("randnorm needs a double as first argument (if any)"));
-      if (n>1 && (params[1].type!=jkmpDouble)) p->jkmpError(JKMP::_("randnorm needs a double as second argument (if any)"));
+      if (n>2) JKMATHPARSER_ERROR(p, JKMP::_("randnorm accepts 0,1 or 2 argument"));
+      if (n>0 && (params[0].type!=jkmpDouble)) JKMATHPARSER_ERROR(p, JKMP::_("randnorm needs a double as first argument (if any)"));
+      if (n>1 && (params[1].type!=jkmpDouble)) JKMATHPARSER_ERROR(p, JKMP::_("randnorm needs a double as second argument (if any)"));
       if (n==1) {
           var=params[0].num;
       } else if (n>1) {
@@ -956,7 +1287,7 @@ namespace JKMathParser_DefaultLib {
 
     jkmpResult fRandInt(const jkmpResult* params, unsigned int  n, JKMathParser* p){
       jkmpResult r;
-      if (n>2) p->jkmpError(JKMP::_("randint accepts 0, 1 or 2 argument"));
+      if (n>2) JKMATHPARSER_ERROR(p, JKMP::_("randint accepts 0, 1 or 2 argument"));
       r.type=jkmpDouble;
       if (n==0) r.num=p->get_rng()->randInt();
       else if (n==2) r.num=p->get_rng()->randInt((uint32_t)params[1].num-(uint32_t)params[0].num)+(uint32_t)params[0].num;
@@ -971,12 +1302,12 @@ namespace JKMathParser_DefaultLib {
 
     void fRandVec(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
       bool ok=true;
-      if (n>3 || n<=0) { ok=false; p->jkmpError(JKMP::_("randvec accepts 1, 2 or 3 arguments")); }
-      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randvec needs a double as first argument (if any)")); }
-      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randvec needs a double as second argument (if any)")); }
-      if (n>2 && (params[2].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randvec needs a double as third argument (if any)")); }
+      if (n>3 || n<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randvec accepts 1, 2 or 3 arguments")); }
+      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randvec needs a double as first argument (if any)")); }
+      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randvec needs a double as second argument (if any)")); }
+      if (n>2 && (params[2].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randvec needs a double as third argument (if any)")); }
       int items=params[0].toInteger();
-      if (items<=0) { ok=false; p->jkmpError(JKMP::_("randvec's first argument has to be a positive integer number")); }
+      if (items<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randvec's first argument has to be a positive integer number")); }
       if (ok) {
           r.setDoubleVec(items, 0);
 
@@ -1000,12 +1331,12 @@ namespace JKMathParser_DefaultLib {
 
     void fRandIntVec(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
       bool ok=true;
-      if (n>3 || n<=0) { ok=false; p->jkmpError(JKMP::_("randintvec accepts 1, 2 or 3 arguments")); }
-      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randintvec needs a double as first argument (if any)")); }
-      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randintvec needs a double as second argument (if any)")); }
-      if (n>2 && (params[2].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randintvec needs a double as third argument (if any)")); }
+      if (n>3 || n<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randintvec accepts 1, 2 or 3 arguments")); }
+      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randintvec needs a double as first argument (if any)")); }
+      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randintvec needs a double as second argument (if any)")); }
+      if (n>2 && (params[2].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randintvec needs a double as third argument (if any)")); }
       int items=params[0].toInteger();
-      if (items<=0) { ok=false; p->jkmpError(JKMP::_("randintvec's first argument has to be a positive integer number")); }
+      if (items<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randintvec's first argument has to be a positive integer number")); }
       if (ok) {
           r.setDoubleVec(items, 0);
 
@@ -1027,12 +1358,12 @@ namespace JKMathParser_DefaultLib {
     }
     void fRandNormVec(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         bool ok=true;
-      if (n>3 || n<=0) { ok=false; p->jkmpError(JKMP::_("randnormvec accepts 1, 2 or 3 arguments")); }
-      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randnormvec needs a double as first argument (if any)")); }
-      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randnormvec needs a double as second argument (if any)")); }
-      if (n>2 && (params[2].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randnormvec needs a double as third argument (if any)")); }
+      if (n>3 || n<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randnormvec accepts 1, 2 or 3 arguments")); }
+      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randnormvec needs a double as first argument (if any)")); }
+      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randnormvec needs a double as second argument (if any)")); }
+      if (n>2 && (params[2].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randnormvec needs a double as third argument (if any)")); }
       int items=params[0].toInteger();
-      if (items<=0) { ok=false; p->jkmpError(JKMP::_("randnormvec's first argument has to be a positive integer number")); }
+      if (items<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randnormvec's first argument has to be a positive integer number")); }
       if (ok) {
 
           r.setDoubleVec(items, 0);
@@ -1057,14 +1388,14 @@ namespace JKMathParser_DefaultLib {
 
     void fRandBoolVec(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         bool ok=true;
-      if (n>2 || n<=0) { ok=false; p->jkmpError(JKMP::_("randboolvec accepts 1 or 2 arguments")); }
-      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randboolvec needs a double as first argument (if any)")); }
-      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randboolvec needs a double as second argument (if any)")); }
+      if (n>2 || n<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec accepts 1 or 2 arguments")); }
+      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec needs a double as first argument (if any)")); }
+      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec needs a double as second argument (if any)")); }
       int items=params[0].toInteger();
       double pr=0.5;
       if (n>1) pr=params[1].num;
-      if (items<=0) { ok=false; p->jkmpError(JKMP::_("randboolvec's first argument has to be a positive integer number")); }
-      if (pr<0 || pr>1) { ok=false; p->jkmpError(JKMP::_("randboolvec's second argument has to be a number between 0 and 1")); }
+      if (items<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec's first argument has to be a positive integer number")); }
+      if (pr<0 || pr>1) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec's second argument has to be a number between 0 and 1")); }
       if (ok) {
           r.setBoolVec(items, false);
 
@@ -1089,13 +1420,13 @@ namespace JKMathParser_DefaultLib {
 
     void fRandVecSeed(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
       bool ok=true;
-      if (n>4 || n<=1) { ok=false; p->jkmpError(JKMP::_("randvec_seed accepts 2, 3 or 4 arguments")); }
-      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randvec_seed needs a double as first argument (if any)")); }
-      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randvec_seed needs a double as second argument (if any)")); }
-      if (n>2 && (params[2].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randvec_seed needs a double as third argument (if any)")); }
-      if (n>4 && (params[3].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randvec_seed needs a double as fourth argument (if any)")); }
+      if (n>4 || n<=1) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randvec_seed accepts 2, 3 or 4 arguments")); }
+      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randvec_seed needs a double as first argument (if any)")); }
+      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randvec_seed needs a double as second argument (if any)")); }
+      if (n>2 && (params[2].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randvec_seed needs a double as third argument (if any)")); }
+      if (n>4 && (params[3].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randvec_seed needs a double as fourth argument (if any)")); }
       int items=params[0].toInteger();
-      if (items<=0) { ok=false; p->jkmpError(JKMP::_("randvec_seed's first argument has to be a positive integer number")); }
+      if (items<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randvec_seed's first argument has to be a positive integer number")); }
       if (ok) {
           r.setDoubleVec(items, 0);
 
@@ -1123,13 +1454,13 @@ namespace JKMathParser_DefaultLib {
 
     void fRandIntVecSeed(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         bool ok=true;
-        if (n>4 || n<=1) { ok=false; p->jkmpError(JKMP::_("randintvec_seed accepts 2, 3 or 4 arguments")); }
-        if (n>0 && (params[0].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randintvec_seed needs a double as first argument (if any)")); }
-        if (n>1 && (params[1].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randintvec_seed needs a double as second argument (if any)")); }
-        if (n>2 && (params[2].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randintvec_seed needs a double as third argument (if any)")); }
-        if (n>4 && (params[3].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randintvec_seed needs a double as fourth argument (if any)")); }
+        if (n>4 || n<=1) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randintvec_seed accepts 2, 3 or 4 arguments")); }
+        if (n>0 && (params[0].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randintvec_seed needs a double as first argument (if any)")); }
+        if (n>1 && (params[1].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randintvec_seed needs a double as second argument (if any)")); }
+        if (n>2 && (params[2].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randintvec_seed needs a double as third argument (if any)")); }
+        if (n>4 && (params[3].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randintvec_seed needs a double as fourth argument (if any)")); }
         int items=params[0].toInteger();
-        if (items<=0) { ok=false; p->jkmpError(JKMP::_("randintvec_seed's first argument has to be a positive integer number")); }
+        if (items<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randintvec_seed's first argument has to be a positive integer number")); }
         if (ok) {
             r.setDoubleVec(items, 0);
 
@@ -1156,13 +1487,13 @@ namespace JKMathParser_DefaultLib {
 
     void fRandNormVecSeed(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         bool ok=true;
-        if (n>4 || n<=1) { ok=false; p->jkmpError(JKMP::_("randnormvec_seed accepts 2, 3 or 4 arguments")); }
-        if (n>0 && (params[0].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randnormvec_seed needs a double as first argument (if any)")); }
-        if (n>1 && (params[1].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randnormvec_seed needs a double as second argument (if any)")); }
-        if (n>2 && (params[2].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randnormvec_seed needs a double as third argument (if any)")); }
-        if (n>4 && (params[3].type!=jkmpDouble)) { ok=false;  p->jkmpError(JKMP::_("randnormvec_seed needs a double as fourth argument (if any)")); }
+        if (n>4 || n<=1) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randnormvec_seed accepts 2, 3 or 4 arguments")); }
+        if (n>0 && (params[0].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randnormvec_seed needs a double as first argument (if any)")); }
+        if (n>1 && (params[1].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randnormvec_seed needs a double as second argument (if any)")); }
+        if (n>2 && (params[2].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randnormvec_seed needs a double as third argument (if any)")); }
+        if (n>4 && (params[3].type!=jkmpDouble)) { ok=false;  JKMATHPARSER_ERROR(p, JKMP::_("randnormvec_seed needs a double as fourth argument (if any)")); }
         int items=params[0].toInteger();
-        if (items<=0) { ok=false; p->jkmpError(JKMP::_("randnormvec_seed's first argument has to be a positive integer number")); }
+        if (items<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randnormvec_seed's first argument has to be a positive integer number")); }
         if (ok) {
             MTRand rng;
 
@@ -1192,10 +1523,10 @@ namespace JKMathParser_DefaultLib {
 
     void fRandBoolVecSeed(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         bool ok=true;
-      if (n>3 || n<=1) { ok=false; p->jkmpError(JKMP::_("randboolvec_seed accepts 2 or 3 arguments")); }
-      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randboolvec_seed needs a double as first argument (if any)")); }
-      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randboolvec_seed needs a double as second argument (if any)")); }
-      if (n>2 && (params[2].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randboolvec_seed needs a double as third argument (if any)")); }
+      if (n>3 || n<=1) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec_seed accepts 2 or 3 arguments")); }
+      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec_seed needs a double as first argument (if any)")); }
+      if (n>1 && (params[1].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec_seed needs a double as second argument (if any)")); }
+      if (n>2 && (params[2].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec_seed needs a double as third argument (if any)")); }
       int items=params[0].toInteger();
       double pr=0.5;
       double seed=params[1].num;
@@ -1203,8 +1534,8 @@ namespace JKMathParser_DefaultLib {
           pr=params[1].num;
           seed=params[2].num;
       }
-      if (items<=0) { ok=false; p->jkmpError(JKMP::_("randboolvec_seed's first argument has to be a positive integer number")); }
-      if (pr<0 || pr>1) { ok=false; p->jkmpError(JKMP::_("randboolvec_seed's second argument has to be a number between 0 and 1")); }
+      if (items<=0) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec_seed's first argument has to be a positive integer number")); }
+      if (pr<0 || pr>1) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec_seed's second argument has to be a number between 0 and 1")); }
       if (ok) {
           r.setBoolVec(items, false);
           MTRand rng;
@@ -1234,11 +1565,11 @@ namespace JKMathParser_DefaultLib {
 
     void fRandBool(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         bool ok=true;
-      if (n>1) { ok=false; p->jkmpError(JKMP::_("randbool accepts 0 or 1 arguments")); }
-      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false; p->jkmpError(JKMP::_("randboolvec needs a double as first argument (if any)")); }
+      if (n>1) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randbool accepts 0 or 1 arguments")); }
+      if (n>0 && (params[0].type!=jkmpDouble)) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randboolvec needs a double as first argument (if any)")); }
       double pr=0.5;
       if (n>1) pr=params[0].num;
-      if (pr<0 || pr>1) { ok=false; p->jkmpError(JKMP::_("randbool's second argument has to be a number between 0 and 1")); }
+      if (pr<0 || pr>1) { ok=false; JKMATHPARSER_ERROR(p, JKMP::_("randbool's second argument has to be a number between 0 and 1")); }
       if (ok) {
           r.setBoolean(p->get_rng()->rand()<=pr);
       } else {
@@ -1259,7 +1590,7 @@ namespace JKMathParser_DefaultLib {
       } else if (n==2 && params[0].type==jkmpDouble && params[1].type==jkmpDouble) {
           r.num=fmin(params[0].num, params[1].num);
       } else {
-          p->jkmpError(JKMP::_("min(...) takes two number or 1 number vector argument"));
+          JKMATHPARSER_ERROR(p, JKMP::_("min(...) takes two number or 1 number vector argument"));
           r.isValid=false;
           return r;
       }
@@ -1276,7 +1607,7 @@ namespace JKMathParser_DefaultLib {
         } else if (n==2 && params[0].type==jkmpDouble && params[1].type==jkmpDouble) {
             r.num=fmax(params[0].num, params[1].num);
         } else {
-            p->jkmpError(JKMP::_("max(...) takes two number or 1 number vector argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("max(...) takes two number or 1 number vector argument"));
             r.isValid=false;
             return r;
         }
@@ -1286,7 +1617,7 @@ namespace JKMathParser_DefaultLib {
     void fLength(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("length(x) need one argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("length(x) need one argument"));
             r.setInvalid();
             return;
         }
@@ -1298,7 +1629,7 @@ namespace JKMathParser_DefaultLib {
     {
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("dimensions(x) need one argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("dimensions(x) need one argument"));
             r.setInvalid();
             return;
         }
@@ -1308,7 +1639,7 @@ namespace JKMathParser_DefaultLib {
     void fSize(jkmpResult &r, const jkmpResult *params, unsigned int n, JKMathParser *p)
     {
         if (n!=1) {
-            p->jkmpError(JKMP::_("size(x) need one argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("size(x) need one argument"));
             r.setInvalid();
             return;
         }
@@ -1325,7 +1656,7 @@ namespace JKMathParser_DefaultLib {
     {
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("sizecols(x) need one argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("sizecols(x) need one argument"));
             r.setInvalid();
             return;
         }
@@ -1336,7 +1667,7 @@ namespace JKMathParser_DefaultLib {
     {
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("sizerows(x) need one argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("sizerows(x) need one argument"));
             r.setInvalid();
             return;
         }
@@ -1373,7 +1704,7 @@ namespace JKMathParser_DefaultLib {
                 }
             }
         } else {
-            p->jkmpError(JKMP::_("remove(x, idx) need one number vector and one number or number vector argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("remove(x, idx) need one number vector and one number or number vector argument"));
             r.setInvalid();
             return;
         }
@@ -1388,7 +1719,7 @@ namespace JKMathParser_DefaultLib {
             }
             r.setDouble(sum);
         } else {
-            p->jkmpError(JKMP::_("dot(x, y) needs two number vector arguments of equal size"));
+            JKMATHPARSER_ERROR(p, JKMP::_("dot(x, y) needs two number vector arguments of equal size"));
             r.setInvalid();
             return;
         }
@@ -1415,7 +1746,7 @@ namespace JKMathParser_DefaultLib {
                             r.structData[it->first]=it->second;
                         }
                     } else {
-                        p->jkmpError(JKMP::_("concat(x1, x2, ...) can only concatenate maps to  other maps, not to %1 in argument %2").arg(params[i].typeName()).arg(i+1));
+                        JKMATHPARSER_ERROR(p, JKMP::_("concat(x1, x2, ...) can only concatenate maps to  other maps, not to %1 in argument %2").arg(params[i].typeName()).arg(i+1));
                         r.setInvalid();
                         return;
                     }
@@ -1426,7 +1757,7 @@ namespace JKMathParser_DefaultLib {
                     if (params[i].convertsToVector()) {
                         r.numVec<<params[i].asVector();
                     } else {
-                        p->jkmpError(JKMP::_("concat(x1, x2, ...) needs one or more vectors or vectorelements as arguments (all have to have the same type)"));
+                        JKMATHPARSER_ERROR(p, JKMP::_("concat(x1, x2, ...) needs one or more vectors or vectorelements as arguments (all have to have the same type)"));
                         r.setInvalid();
                         return;
                     }
@@ -1437,7 +1768,7 @@ namespace JKMathParser_DefaultLib {
                     if (params[i].convertsToBoolVector()) {
                         r.boolVec<<params[i].asBoolVector();
                     } else {
-                        p->jkmpError(JKMP::_("concat(x1, x2, ...) needs one or more vectors or vectorelements as arguments (all have to have the same type)"));
+                        JKMATHPARSER_ERROR(p, JKMP::_("concat(x1, x2, ...) needs one or more vectors or vectorelements as arguments (all have to have the same type)"));
                         r.setInvalid();
                         return;
                     }
@@ -1448,14 +1779,14 @@ namespace JKMathParser_DefaultLib {
                     if (params[i].convertsToStringVector()) {
                         r.strVec<<params[i].asStrVector();
                     } else {
-                        p->jkmpError(JKMP::_("concat(x1, x2, ...) needs one or more vectors or vectorelements as arguments (all have to have the same type)"));
+                        JKMATHPARSER_ERROR(p, JKMP::_("concat(x1, x2, ...) needs one or more vectors or vectorelements as arguments (all have to have the same type)"));
                         r.setInvalid();
                         return;
                     }
                 }
             }
         } else {
-            p->jkmpError(JKMP::_("concat(x1, x2, ...) needs one or more vectors or vectorelements as arguments (all have to have the same type)"));
+            JKMATHPARSER_ERROR(p, JKMP::_("concat(x1, x2, ...) needs one or more vectors or vectorelements as arguments (all have to have the same type)"));
             r.setInvalid();
             return;
         }
@@ -1494,7 +1825,7 @@ namespace JKMathParser_DefaultLib {
                 }
             }
         } else {
-            p->jkmpError(JKMP::_("removeall(x, value) need one number vector and one number argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("removeall(x, value) need one number vector and one number argument"));
             r.setInvalid();
             return;
         }
@@ -1515,7 +1846,7 @@ namespace JKMathParser_DefaultLib {
                 }
             }
         } else {
-            p->jkmpError(JKMP::_("filterfinite(x) need one number vector argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("filterfinite(x) need one number vector argument"));
             r.setInvalid();
             return;
         }
@@ -1564,7 +1895,7 @@ namespace JKMathParser_DefaultLib {
                 }
             }
         } else {
-            p->jkmpError(JKMP::_("find(x, value=true) needs two arguments: one vector x and a corresponding element value, if only a boolean vector is given, the function uses value=true"));
+            JKMATHPARSER_ERROR(p, JKMP::_("find(x, value=true) needs two arguments: one vector x and a corresponding element value, if only a boolean vector is given, the function uses value=true"));
             r.setInvalid();
             return;
         }
@@ -1666,7 +1997,7 @@ namespace JKMathParser_DefaultLib {
                 r.numVec.push_back(add);
             }
         } else {
-            p->jkmpError(JKMP::_("findfirst(x, value=true) needs two arguments: one vector x and a corresponding element value (or vector), if only a boolean vector is given, the function uses value=true"));
+            JKMATHPARSER_ERROR(p, JKMP::_("findfirst(x, value=true) needs two arguments: one vector x and a corresponding element value (or vector), if only a boolean vector is given, the function uses value=true"));
             r.setInvalid();
             return;
         }
@@ -1692,7 +2023,7 @@ namespace JKMathParser_DefaultLib {
             r.type=jkmpBool;
             r.boolean=dat.contains(params[1].str);
         } else {
-            p->jkmpError(JKMP::_("contains(x, value) needs two arguments: one vector x and a corresponding element value (or vector)"));
+            JKMATHPARSER_ERROR(p, JKMP::_("contains(x, value) needs two arguments: one vector x and a corresponding element value (or vector)"));
             r.setInvalid();
             return;
         }
@@ -1717,7 +2048,7 @@ namespace JKMathParser_DefaultLib {
             r.type=jkmpBool;
             r.boolean=dat.contains(params[1].str, false);
         } else {
-            p->jkmpError(JKMP::_("contains_caseinsensitive(x, value) needs two arguments: one vector x and a corresponding element value (or vector)"));
+            JKMATHPARSER_ERROR(p, JKMP::_("contains_caseinsensitive(x, value) needs two arguments: one vector x and a corresponding element value (or vector)"));
             r.setInvalid();
             return;
         }
@@ -1770,7 +2101,7 @@ namespace JKMathParser_DefaultLib {
                 }
             }
         }  else {
-            p->jkmpError(JKMP::_("containssubstr(x, value) needs two arguments: stringVec/string, string/string or stringvec/string_vec"));
+            JKMATHPARSER_ERROR(p, JKMP::_("containssubstr(x, value) needs two arguments: stringVec/string, string/string or stringvec/string_vec"));
             r.setInvalid();
             return;
         }
@@ -1822,7 +2153,7 @@ namespace JKMathParser_DefaultLib {
                 }
             }
         }  else {
-            p->jkmpError(JKMP::_("containssubstr_caseinsensitive(x, value) needs two arguments: stringVec/string, string/string or stringvec/string_vec"));
+            JKMATHPARSER_ERROR(p, JKMP::_("containssubstr_caseinsensitive(x, value) needs two arguments: stringVec/string, string/string or stringvec/string_vec"));
             r.setInvalid();
             return;
         }
@@ -1832,7 +2163,7 @@ namespace JKMathParser_DefaultLib {
         if (n==2 && params[0].type==jkmpDoubleVector && params[1].type==jkmpBoolVector) {
             const JKMP::vector<double>& dat=params[0].numVec;
             if (dat.size()!=params[1].boolVec.size()) {
-                p->jkmpError(JKMP::_("find(x, criterion) vectors x and criterion have different size"));
+                JKMATHPARSER_ERROR(p, JKMP::_("find(x, criterion) vectors x and criterion have different size"));
                 r.setInvalid();
                 return ;
             }
@@ -1847,7 +2178,7 @@ namespace JKMathParser_DefaultLib {
         } else if (n==2 && params[0].type==jkmpBoolVector && params[1].type==jkmpBoolVector) {
             const JKMP::vector<bool>& dat=params[0].boolVec;
             if (dat.size()!=params[1].boolVec.size()) {
-                p->jkmpError(JKMP::_("find(x, criterion) vectors x and criterion have different size"));
+                JKMATHPARSER_ERROR(p, JKMP::_("find(x, criterion) vectors x and criterion have different size"));
                 r.setInvalid();
                 return ;
             }
@@ -1863,7 +2194,7 @@ namespace JKMathParser_DefaultLib {
         } else if (n==2 && params[0].type==jkmpStringVector && params[1].type==jkmpBoolVector) {
             const JKMP::stringVector& dat=params[0].strVec;
             if (dat.size()!=params[1].boolVec.size()) {
-                p->jkmpError(JKMP::_("find(x, criterion) vectors x and criterion have different size"));
+                JKMATHPARSER_ERROR(p, JKMP::_("find(x, criterion) vectors x and criterion have different size"));
                 r.setInvalid();
                 return ;
             }
@@ -1876,7 +2207,7 @@ namespace JKMathParser_DefaultLib {
                 }
             }
         } else {
-            p->jkmpError(JKMP::_("find(x, criterion) needs two arguments, a vector x and a boolean vector criterion of same length"));
+            JKMATHPARSER_ERROR(p, JKMP::_("find(x, criterion) needs two arguments, a vector x and a boolean vector criterion of same length"));
             r.setInvalid();
             return;
         }
@@ -1899,7 +2230,7 @@ namespace JKMathParser_DefaultLib {
                 r.boolVec[i]=params[0].boolVec[r.boolVec.size()-i-1];
             }
         } else {
-            p->jkmpError(JKMP::_("reverse(x) need one number vector argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("reverse(x) need one number vector argument"));
             r.setInvalid();
             return ;
         }
@@ -1907,11 +2238,28 @@ namespace JKMathParser_DefaultLib {
 
 
 
+    /** \brief returns the distinct items of \a input in the order of their first occurence, see JKMP::uniqueIndex() */
+    template <typename TVec, typename THash>
+    static TVec uniqueItems(const TVec& input, std::vector<size_t>* inverse=NULL) {
+        const std::vector<size_t> first=JKMP::uniqueIndex<TVec, THash>(input, inverse);
+        TVec out;
+        out.reserve(first.size());
+        for (size_t i=0; i<first.size(); i++) {
+            out.push_back(input[first[i]]);
+        }
+        return out;
+    }
+
+    /** \brief orders numbers ascending, with NaN at the end */
+    static inline bool uniqueLessNaNLast(double a, double b) {
+        return (a<b) || (!std::isnan(a) && std::isnan(b));
+    }
+
     void fUnique(jkmpResult &res, const jkmpResult* params, unsigned int  n, JKMathParser* p) {
         res.setInvalid();
 
         if (n!=1) {
-            p->jkmpError("unique(data) needs 1 argument");
+            JKMATHPARSER_ERROR(p, "unique(data) needs 1 argument");
             return ;
         }
         if ((params[0].type==jkmpDouble) || (params[0].type==jkmpString) || (params[0].type==jkmpBool)) {
@@ -1920,446 +2268,248 @@ namespace JKMathParser_DefaultLib {
         }
 
         if (params[0].type==jkmpDoubleVector) {
-            JKMP::vector<double> out;
-            const JKMP::vector<double>& in=params[0].numVec;
-
-            for (size_t i=0; i<in.size(); i++) {
-                if (!out.contains(in[i])) out<<in[i];
-            }
-
-            res.setDoubleVec(out);
+            res.setDoubleVec(uniqueItems<JKMP::vector<double>, std::hash<double> >(params[0].numVec));
             return;
         }
 
         if (params[0].type==jkmpStringVector) {
-            JKMP::stringVector out;
-            const JKMP::stringVector& in=params[0].strVec;
-
-            for (size_t i=0; i<in.size(); i++) {
-                if (!out.contains(in[i])) out<<in[i];
-            }
-
-            res.setStringVec(out);
+            res.setStringVec(uniqueItems<JKMP::stringVector, std::hash<JKMP::stringType> >(params[0].strVec));
             return;
         }
 
         if (params[0].type==jkmpBoolVector) {
-            JKMP::vector<bool> out;
-            const JKMP::vector<bool>& in=params[0].boolVec;
-
-            for (size_t i=0; i<in.size(); i++) {
-                if (!out.contains(in[i])) out<<in[i];
-                if (out.size()>1) break;
-            }
-
-            res.setBoolVec(out);
+            res.setBoolVec(uniqueItems<JKMP::vector<bool>, std::hash<bool> >(params[0].boolVec));
             return;
         }
     }
 
+    void fUniqueSorted(jkmpResult &res, const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        res.setInvalid();
 
+        if (n!=1) {
+            JKMATHPARSER_ERROR(p, "uniquesorted(data) needs 1 argument");
+            return ;
+        }
+        if ((params[0].type==jkmpDouble) || (params[0].type==jkmpString) || (params[0].type==jkmpBool)) {
+            res=params[0];
+            return;
+        }
 
+        // only the distinct items are sorted
+        if (params[0].type==jkmpDoubleVector) {
+            JKMP::vector<double> out=uniqueItems<JKMP::vector<double>, std::hash<double> >(params[0].numVec);
+            std::sort(out.begin(), out.end(), uniqueLessNaNLast);
+            res.setDoubleVec(out);
+            return;
+        }
 
+        if (params[0].type==jkmpStringVector) {
+            JKMP::stringVector out=uniqueItems<JKMP::stringVector, std::hash<JKMP::stringType> >(params[0].strVec);
+            std::sort(out.begin(), out.end());
+            res.setStringVec(out);
+            return;
+        }
 
-
-    jkmpResult fIndexedAvg(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=2) p->jkmpError("indexedmean(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsAverageV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsAverageV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsAverageV<JKMP::vector<double> >));
+        if (params[0].type==jkmpBoolVector) {
+            const JKMP::vector<bool> out=uniqueItems<JKMP::vector<bool>, std::hash<bool> >(params[0].boolVec);
+            res.setBoolVec(out);
+            if (out.size()==2 && out[0]) {
+                res.boolVec[0]=false;
+                res.boolVec[1]=true;
             }
-        } else {
-            p->jkmpError("indexedmean(data, index) needs a number vector as data argument and an equal sized index array of any type");
+            return;
         }
-
-        return res;
     }
 
-    jkmpResult fIndexedVar(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=2) p->jkmpError("indexedvar(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsVarianceV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsVarianceV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsVarianceV<JKMP::vector<double> >));
-            }
+    /** \brief sets \a inverse to the positions of the items of \a param in unique(param), returns \c false for unsupported types */
+    static bool uniqueInverse(const jkmpResult& param, std::vector<size_t>& inverse, size_t& distinct) {
+        if ((param.type==jkmpDouble) || (param.type==jkmpString) || (param.type==jkmpBool)) {
+            inverse.assign(1, 0);
+            distinct=1;
+        } else if (param.type==jkmpDoubleVector) {
+            distinct=JKMP::uniqueIndex<JKMP::vector<double>, std::hash<double> >(param.numVec, &inverse).size();
+        } else if (param.type==jkmpStringVector) {
+            distinct=JKMP::uniqueIndex<JKMP::stringVector, std::hash<JKMP::stringType> >(param.strVec, &inverse).size();
+        } else if (param.type==jkmpBoolVector) {
+            distinct=JKMP::uniqueIndex<JKMP::vector<bool>, std::hash<bool> >(param.boolVec, &inverse).size();
         } else {
-            p->jkmpError("indexedvar(data, index) needs a number vector as data argument and an equal sized index array of any type");
+            return false;
         }
-
-        return res;
+        return true;
     }
 
-
-
-    jkmpResult fIndexedStd(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=2) p->jkmpError("indexedstd(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsStdDevV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsStdDevV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsStdDevV<JKMP::vector<double> >));
-            }
-        } else {
-            p->jkmpError("indexedstd(data, index) needs a number vector as data argument and an equal sized index array of any type");
+    void fUniqueCounts(jkmpResult &res, const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        std::vector<size_t> inverse;
+        size_t distinct=0;
+        if (n!=1 || !uniqueInverse(params[0], inverse, distinct)) {
+            res.setInvalid();
+            JKMATHPARSER_ERROR(p, "uniquecounts(data) needs 1 argument, which is a vector or a single value");
+            return ;
+        }
+        res.setDoubleVec(distinct, 0.0);
+        for (size_t i=0; i<inverse.size(); i++) {
+            res.numVec[inverse[i]]++;
         }
-
-        return res;
     }
 
-    jkmpResult fIndexedSum(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
+    void fUniqueIndices(jkmpResult &res, const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        std::vector<size_t> inverse;
+        size_t distinct=0;
+        if (n!=1 || !uniqueInverse(params[0], inverse, distinct)) {
+            res.setInvalid();
+            JKMATHPARSER_ERROR(p, "uniqueindices(data) needs 1 argument, which is a vector or a single value");
+            return ;
+        }
+        res.setDoubleVec(inverse.size());
+        for (size_t i=0; i<inverse.size(); i++) {
+            res.numVec[i]=double(inverse[i]);
+        }
+    }
 
-        if (n!=2) p->jkmpError("indexedsum(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
 
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsSumV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsSumV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsSumV<JKMP::vector<double> >));
-            }
-        } else {
-            p->jkmpError("indexedsum(data, index) needs a number vector as data argument and an equal sized index array of any type");
-        }
 
-        return res;
-    }
 
-    jkmpResult fIndexedSum2(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
 
-        if (n!=2) p->jkmpError("indexedsum2(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
+    /** \brief data and dense group ids of the arguments of an indexed...() function */
+    struct IndexedGroups {
+        /** \brief the data items */
+        const double* data;
+        /** \brief holds the data, if it is a single number */
+        JKMP::vector<double> buffer;
+        /** \brief group id of every data item, in the order of the first occurence of the index values */
+        std::vector<size_t> group;
+        /** \brief number of groups */
+        size_t groups;
+    };
 
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsSum2V<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsSum2V<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsSum2V<JKMP::vector<double> >));
-            }
+    /** \brief sets \a groups to the data \a data and the group ids of the index \a index of an indexed...() function, returns \c false for invalid arguments */
+    static bool indexedGroups(const jkmpResult& data, const jkmpResult& index, IndexedGroups& groups) {
+        if (((data.type!=jkmpDoubleVector) && (data.type!=jkmpDouble)) || data.size()!=index.size()) return false;
+        if (index.type!=jkmpDouble && index.type!=jkmpDoubleVector && index.type!=jkmpBool && index.type!=jkmpBoolVector && index.type!=jkmpString && index.type!=jkmpStringVector) return false;
+        if (data.type==jkmpDouble) {
+            groups.buffer=data.asVector();
+            groups.data=groups.buffer.data();
         } else {
-            p->jkmpError("indexedsum2(data, index) needs a number vector as data argument and an equal sized index array of any type");
+            groups.data=data.numVec.data();
         }
-
-        return res;
+        return uniqueInverse(index, groups.group, groups.groups);
     }
 
-
-    jkmpResult fIndexedMedian(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=2) p->jkmpError("indexedmedian(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsMedianV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsMedianV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsMedianV<JKMP::vector<double> >));
-            }
+    /** \brief implements an indexed...(data, index) function, which computes the streaming \a aggregate per group */
+    static jkmpResult indexedAggregate(const char* signature, JKMP::GroupAggregate aggregate, const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        IndexedGroups g;
+        if (n!=2) {
+            JKMATHPARSER_ERROR(p, JKMP::_("%1 needs 2 argument").arg(JKMP::string(signature)));
+        } else if (indexedGroups(params[0], params[1], g)) {
+            JKMP::vector<double> res(g.groups, 0.0);
+            JKMP::groupAggregate(g.data, g.group.data(), g.group.size(), g.groups, aggregate, res.data());
+            return jkmpResult(res);
+        } else {
+            JKMATHPARSER_ERROR(p, JKMP::_("%1 needs a number vector as data argument and an equal sized index array of any type").arg(JKMP::string(signature)));
+        }
+        return jkmpResult::invalidResult();
+    }
+
+    /** \brief implements an indexed...(data, index[, parameter]) function, which applies \a func(items, count, parameter) to the items of each group */
+    template <typename TFUNC>
+    static jkmpResult indexedApply(const char* signature, unsigned int nParams, TFUNC func, const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        IndexedGroups g;
+        if (n!=nParams) {
+            JKMATHPARSER_ERROR(p, JKMP::_("%1 needs %2 argument").arg(JKMP::string(signature)).arg(nParams));
+        } else if ((nParams<3 || params[2].type==jkmpDouble) && indexedGroups(params[0], params[1], g)) {
+            const double parameter=(nParams<3)?0.0:params[2].num;
+            JKMP::vector<double> res(g.groups, 0.0);
+            JKMP::groupApply(g.data, g.group.data(), g.group.size(), g.groups, [&func, parameter](const double* items, size_t count) { return func(items, count, parameter); }, res.data());
+            return jkmpResult(res);
         } else {
-            p->jkmpError("indexedmedian(data, index) needs a number vector as data argument and an equal sized index array of any type");
+            JKMATHPARSER_ERROR(p, JKMP::_("%1 needs a number vector as data argument and an equal sized index array of any type").arg(JKMP::string(signature)));
         }
+        return jkmpResult::invalidResult();
+    }
 
-        return res;
+    jkmpResult fIndexedAvg(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        return indexedAggregate("indexedmean(data, index)", JKMP::GroupMean, params, n, p);
     }
 
+    jkmpResult fIndexedVar(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        return indexedAggregate("indexedvar(data, index)", JKMP::GroupVar, params, n, p);
+    }
 
+    jkmpResult fIndexedStd(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        return indexedAggregate("indexedstd(data, index)", JKMP::GroupStd, params, n, p);
+    }
 
-    jkmpResult fIndexedMAD(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
+    jkmpResult fIndexedSum(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        return indexedAggregate("indexedsum(data, index)", JKMP::GroupSum, params, n, p);
+    }
 
-        if (n!=2) p->jkmpError("indexedmad(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
+    jkmpResult fIndexedSum2(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        return indexedAggregate("indexedsum2(data, index)", JKMP::GroupSum2, params, n, p);
+    }
 
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsMADV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsMADV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsMADV<JKMP::vector<double> >));
-            }
-        } else {
-            p->jkmpError("indexedmad(data, index) needs a number vector as data argument and an equal sized index array of any type");
-        }
+    jkmpResult fIndexedMedian(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        return indexedApply("indexedmedian(data, index)", 2, [](const double* d, size_t c, double) { return JKMP::selectMedian(d, c); }, params, n, p);
+    }
 
-        return res;
+    jkmpResult fIndexedMAD(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        return indexedApply("indexedmad(data, index)", 2, [](const double* d, size_t c, double) { return JKMP::selectMAD(d, c); }, params, n, p);
     }
 
     jkmpResult fIndexedNMAD(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=2) p->jkmpError("indexedmad(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsNMADV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsNMADV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsNMADV<JKMP::vector<double> >));
-            }
-        } else {
-            p->jkmpError("indexedmad(data, index) needs a number vector as data argument and an equal sized index array of any type");
-        }
-
-        return res;
+        return indexedApply("indexednmad(data, index)", 2, [](const double* d, size_t c, double) { return JKMP::selectNMAD(d, c); }, params, n, p);
     }
 
-
     jkmpResult fIndexedMin(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=2) p->jkmpError("indexedmin(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsMinV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsMinV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsMinV<JKMP::vector<double> >));
-            }
-        } else {
-            p->jkmpError("indexedmin(data, index) needs a number vector as data argument and an equal sized index array of any type");
-        }
-
-        return res;
+        return indexedAggregate("indexedmin(data, index)", JKMP::GroupMin, params, n, p);
     }
 
     jkmpResult fIndexedMax(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=2) p->jkmpError("indexedmax(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsMaxV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsMaxV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsMaxV<JKMP::vector<double> >));
-            }
-        } else {
-            p->jkmpError("indexedmax(data, index) needs a number vector as data argument and an equal sized index array of any type");
-        }
-
-        return res;
+        return indexedAggregate("indexedmax(data, index)", JKMP::GroupMax, params, n, p);
     }
 
     jkmpResult fIndexedQuantile(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=3) p->jkmpError("indexedquantile(data, index, quantile) needs 3 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size() && params[2].type==jkmpDouble) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsQuantileV<JKMP::vector<double> >, params[2].num));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsQuantileV<JKMP::vector<double> >, params[2].num));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsQuantileV<JKMP::vector<double> >, params[2].num));
-            }
-        } else {
-            p->jkmpError("indexedquantile(data, index, quantile) needs a number vector as data argument and an equal sized index array of any type");
-        }
-
-        return res;
+        return indexedApply("indexedquantile(data, index, quantile)", 3, [](const double* d, size_t c, double q) { return JKMP::selectQuantile(d, c, q); }, params, n, p);
     }
 
-
     jkmpResult fIndexedSkewness(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=2) p->jkmpError("indexedskewness(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsSkewnessV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsSkewnessV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsSkewnessV<JKMP::vector<double> >));
-            }
-        } else {
-            p->jkmpError("indexedskewness(data, index) needs a number vector as data argument and an equal sized index array of any type");
-        }
-
-        return res;
+        return indexedAggregate("indexedskewness(data, index)", JKMP::GroupSkewness, params, n, p);
     }
 
     jkmpResult fIndexedProd(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=2) p->jkmpError("indexedprod(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsProdV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsProdV<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsProdV<JKMP::vector<double> >));
-            }
-        } else {
-            p->jkmpError("indexedprod(data, index) needs a number vector as data argument and an equal sized index array of any type");
-        }
-
-        return res;
+        return indexedAggregate("indexedprod(data, index)", JKMP::GroupProd, params, n, p);
     }
 
     jkmpResult fIndexedCount(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=2) p->jkmpError("indexedcount(data, index) needs 2 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size()) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsCount<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsCount<JKMP::vector<double> >));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsCount<JKMP::vector<double> >));
-            }
-        } else {
-            p->jkmpError("indexedcount(data, index) needs a number vector as data argument and an equal sized index array of any type");
-        }
-
-        return res;
+        return indexedAggregate("indexedcount(data, index)", JKMP::GroupCount, params, n, p);
     }
 
-
     jkmpResult fIndexedMoment(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=3) p->jkmpError("indexedmoment(data, index, order) needs 3 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size() && params[2].type==jkmpDouble) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsCentralMomentV<JKMP::vector<double> >, params[2].toInteger()));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsCentralMomentV<JKMP::vector<double> >, params[2].toInteger()));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsCentralMomentV<JKMP::vector<double> >, params[2].toInteger()));
-            }
-        } else {
-            p->jkmpError("indexedmoment(data, index, order) needs a number vector as data argument and an equal sized index array of any type");
-        }
-
-        return res;
+        return indexedApply("indexedmoment(data, index, order)", 3, [](const double* d, size_t c, double o) { return jkmpStatisticsCentralMoment(NULL, d, c, int(o)); }, params, n, p);
     }
 
     jkmpResult fIndexedNonCentralMoment(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=3) p->jkmpError("indexedncmoment(data, index, order) needs 3 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && params[0].size()==params[1].size() && params[2].type==jkmpDouble) {
-            JKMP::vector<double> d=params[0].asVector();
-
-            if (params[1].type==jkmpDouble || params[1].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asVector(), statisticsMomentV<JKMP::vector<double> >, params[2].toInteger()));
-            }
-            if (params[1].type==jkmpBool || params[1].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asBoolVector(), statisticsMomentV<JKMP::vector<double> >, params[2].toInteger()));
-            }
-            if (params[1].type==jkmpString || params[1].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction(d, params[1].asStrVector(), statisticsMomentV<JKMP::vector<double> >, params[2].toInteger()));
-            }
-        } else {
-            p->jkmpError("indexedncmoment(data, index, order) needs a number vector as data argument and an equal sized index array of any type");
-        }
-
-        return res;
+        return indexedApply("indexedncmoment(data, index, order)", 3, [](const double* d, size_t c, double o) { return statisticsMoment(d, (long long)c, int(o)); }, params, n, p);
     }
 
     jkmpResult fIndexedCorrCoeff(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
-        jkmpResult res=jkmpResult::invalidResult();
-
-        if (n!=3) p->jkmpError("indexedcorrcoeff(dataX, dataY, index) needs 3 argument");
-        else if (((params[0].type==jkmpDoubleVector)||(params[0].type==jkmpDouble)) && ((params[1].type==jkmpDoubleVector)||(params[1].type==jkmpDouble)) && params[0].size()==params[2].size() && params[1].size()==params[2].size()) {
-            JKMP::vector<double> d=params[0].asVector();
-            JKMP::vector<double> dy=params[1].asVector();
-
-            if (params[2].type==jkmpDouble || params[2].type==jkmpDoubleVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction2I(d, dy, params[2].asVector(), statisticsCorrelationCoefficientV<JKMP::vector<double> >));
-            }
-            if (params[2].type==jkmpBool || params[2].type==jkmpBoolVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction2I(d, dy, params[2].asBoolVector(), statisticsCorrelationCoefficientV<JKMP::vector<double> >));
-            }
-            if (params[2].type==jkmpString || params[2].type==jkmpStringVector) {
-                return jkmpResult(JKMP::uniqueApplyFunction2I(d, dy, params[2].asStrVector(), statisticsCorrelationCoefficientV<JKMP::vector<double> >));
-            }
+        IndexedGroups gx, gy;
+        if (n!=3) {
+            JKMATHPARSER_ERROR(p, "indexedcorrcoeff(dataX, dataY, index) needs 3 argument");
+        } else if (indexedGroups(params[0], params[2], gx) && indexedGroups(params[1], params[2], gy)) {
+            // both data vectors are sorted by group in the same way, so the pairs stay aligned
+            std::vector<double> sortedX(gx.group.size()), sortedY(gy.group.size());
+            std::vector<size_t> start(gx.groups+1);
+            JKMP::groupPartition(gx.data, gx.group.data(), gx.group.size(), gx.groups, sortedX.data(), start.data());
+            JKMP::groupPartition(gy.data, gy.group.data(), gy.group.size(), gy.groups, sortedY.data(), start.data());
+            JKMP::vector<double> res(gx.groups, 0.0);
+            for (size_t g=0; g<gx.groups; g++) {
+                res[g]=statisticsCorrelationCoefficient(sortedX.data()+start[g], sortedY.data()+start[g], (long long)(start[g+1]-start[g]));
+            }
+            return jkmpResult(res);
         } else {
-            p->jkmpError(JKMP::_("indexedcorrcoeff(dataX, dataY, index) needs a number vector as data argument and an equal sized index array of any type [len(dataX)=%1, len(dataY)=%2, len(idx)=%3]").arg(params[0].size()).arg(params[1].size()).arg(params[2].size()));
+            JKMATHPARSER_ERROR(p, JKMP::_("indexedcorrcoeff(dataX, dataY, index) needs a number vector as data argument and an equal sized index array of any type [len(dataX)=%1, len(dataY)=%2, len(idx)=%3]").arg(params[0].size()).arg(params[1].size()).arg(params[2].size()));
         }
-
-        return res;
+        return jkmpResult::invalidResult();
     }
 
 
@@ -2368,18 +2518,11 @@ namespace JKMathParser_DefaultLib {
 
 
 
-
-
-
-
-
-
-
     jkmpResult fReturnLast(const jkmpResult* params, unsigned int  n, JKMathParser* p) {
         jkmpResult res=jkmpResult::invalidResult();
 
         if (n<1) {
-            p->jkmpError("returnlast(x1,x2,x3,...) needs at least one argument");
+            JKMATHPARSER_ERROR(p, "returnlast(x1,x2,x3,...) needs at least one argument");
             return res;
         }
         return params[n-1];
@@ -2389,7 +2532,7 @@ namespace JKMathParser_DefaultLib {
         res.setInvalid();
 
         if (n<2) {
-            p->jkmpError("returnnth(n,x1,x2,x3,...) needs at least two arguments");
+            JKMATHPARSER_ERROR(p, "returnnth(n,x1,x2,x3,...) needs at least two arguments");
             res.setInvalid();
             return;
         }
@@ -2397,12 +2540,12 @@ namespace JKMathParser_DefaultLib {
         if (params[0].isInteger()) {
             d=params[0].toInteger();
         } else {
-            p->jkmpError("returnnth(n,x1,x2,x3,...) needs an integer as first argument");
+            JKMATHPARSER_ERROR(p, "returnnth(n,x1,x2,x3,...) needs an integer as first argument");
             res.setInvalid();
             return;
         }
         if (d<0 || d>=(long long)n-1) {
-            p->jkmpError("returnnth(n,x0,x1,x2,...) parameter n has to index one of the elements x0,x1,...");
+            JKMATHPARSER_ERROR(p, "returnnth(n,x0,x1,x2,...) parameter n has to index one of the elements x0,x1,...");
             res.setInvalid();
             return;
         }
@@ -2414,7 +2557,7 @@ namespace JKMathParser_DefaultLib {
         jkmpResult res=jkmpResult::invalidResult();
 
         if (n<1) {
-            p->jkmpError("returnfirst(x1,x2,x3,...) needs at least one argument");
+            JKMATHPARSER_ERROR(p, "returnfirst(x1,x2,x3,...) needs at least one argument");
             return res;
         }
         return params[0];
@@ -2426,7 +2569,7 @@ namespace JKMathParser_DefaultLib {
         if (n==1 && params[0].isUInt())  {
             res.setDoubleVec(params[0].toUInt(), 0.0);
         } else {
-            p->jkmpError("zeros(x) needs one unsigned integer argument");
+            JKMATHPARSER_ERROR(p, "zeros(x) needs one unsigned integer argument");
             res.setInvalid();
             return ;
         }
@@ -2439,7 +2582,7 @@ namespace JKMathParser_DefaultLib {
         if (n==1 && params[0].isUInt())  {
             res.setDoubleVec(params[0].toUInt(), 1.0);
         } else {
-            p->jkmpError("ones(x) needs one unsigned integer argument");
+            JKMATHPARSER_ERROR(p, "ones(x) needs one unsigned integer argument");
             res.setInvalid();
             return ;
         }
@@ -2484,7 +2627,7 @@ namespace JKMathParser_DefaultLib {
                 }
             }
         } else {
-            p->jkmpError("vector(x, value) needs one unsigned integer argument and a non-vector argument");
+            JKMATHPARSER_ERROR(p, "vector(x, value) needs one unsigned integer argument and a non-vector argument");
             res.setInvalid();
             return ;
         }
@@ -2503,7 +2646,7 @@ namespace JKMathParser_DefaultLib {
             if (n==3 && params[2].isUInt()) {
                 items=params[2].toUInt();
             } else if (n==3) {
-                p->jkmpError("linspace(x0, x1[, items]) needs an unsigned integer as third (optional) parameter");
+                JKMATHPARSER_ERROR(p, "linspace(x0, x1[, items]) needs an unsigned integer as third (optional) parameter");
                 res.setInvalid();
                 return;
             }
@@ -2512,7 +2655,7 @@ namespace JKMathParser_DefaultLib {
                 res.numVec[i]=x0+double(i)/double(items-1)*(x1-x0);
             }
         } else {
-            p->jkmpError("linspace(x0, x1[, items]) needs two number parameters x0, x1");
+            JKMATHPARSER_ERROR(p, "linspace(x0, x1[, items]) needs two number parameters x0, x1");
             res.setInvalid();
             return ;
         }
@@ -2531,7 +2674,7 @@ namespace JKMathParser_DefaultLib {
             if (n==3 && params[2].isUInt()) {
                 items=params[2].toUInt();
             } else if (n==3) {
-                p->jkmpError("logspace(a, b[, items]) needs an unsigned integer as third (optional) parameter");
+                JKMATHPARSER_ERROR(p, "logspace(a, b[, items]) needs an unsigned integer as third (optional) parameter");
                 res.setInvalid();
                 return;
             }
@@ -2540,7 +2683,7 @@ namespace JKMathParser_DefaultLib {
                 res.numVec[i]=pow(10.0, x0+double(i)/double(items-1)*(x1-x0));
             }
         } else {
-            p->jkmpError("logspace(a, b[, items]) needs two number parameters x0, x1");
+            JKMATHPARSER_ERROR(p, "logspace(a, b[, items]) needs two number parameters x0, x1");
             res.setInvalid();
             return ;
         }
@@ -2561,7 +2704,7 @@ namespace JKMathParser_DefaultLib {
                 }
             }
         } else {
-            p->jkmpError("meshgrid2d_x(X,Y) needs two number vector parameters");
+            JKMATHPARSER_ERROR(p, "meshgrid2d_x(X,Y) needs two number vector parameters");
             res.setInvalid();
             return ;
         }
@@ -2583,7 +2726,7 @@ namespace JKMathParser_DefaultLib {
                 }
             }
         } else {
-            p->jkmpError("meshgrid2d_y(X,Y) needs two number vector parameters");
+            JKMATHPARSER_ERROR(p, "meshgrid2d_y(X,Y) needs two number vector parameters");
             res.setInvalid();
             return ;
         }
@@ -2593,7 +2736,7 @@ namespace JKMathParser_DefaultLib {
         jkmpResult res=jkmpResult::invalidResult();
 
         if (n!=1) {
-            p->jkmpError("last(x) needs one argument");
+            JKMATHPARSER_ERROR(p, "last(x) needs one argument");
             return res;
         }
         if (params[0].type==jkmpDouble) return jkmpResult(params[0].num);
@@ -2603,7 +2746,7 @@ namespace JKMathParser_DefaultLib {
         if (params[0].type==jkmpString) return jkmpResult(JKMP::string(1,params[0].str.back()));
         if (params[0].type==jkmpStringVector && params[0].size()>0) return jkmpResult(params[0].strVec.back());
 
-        p->jkmpError("last(x): x had no entries or unrecognized type");
+        JKMATHPARSER_ERROR(p, "last(x): x had no entries or unrecognized type");
         return res;
     }
 
@@ -2612,7 +2755,7 @@ namespace JKMathParser_DefaultLib {
         jkmpResult res=jkmpResult::invalidResult();
 
         if (n!=1) {
-            p->jkmpError("first(x) needs one argument");
+            JKMATHPARSER_ERROR(p, "first(x) needs one argument");
             return res;
         }
         if (params[0].type==jkmpDouble) return jkmpResult(params[0].num);
@@ -2622,7 +2765,7 @@ namespace JKMathParser_DefaultLib {
         if (params[0].type==jkmpString) return jkmpResult(JKMP::string(1,params[0].str.front()));
         if (params[0].type==jkmpStringVector && params[0].size()>0) return jkmpResult(params[0].strVec.front());
 
-        p->jkmpError("first(x): x had no entries or unrecognized type");
+        JKMATHPARSER_ERROR(p, "first(x): x had no entries or unrecognized type");
         return res;
     }
 
@@ -2631,19 +2774,19 @@ namespace JKMathParser_DefaultLib {
         jkmpResult res=jkmpResult::invalidResult();
 
         if (n!=2) {
-            p->jkmpError("item(x, idx) needs two argument");
+            JKMATHPARSER_ERROR(p, "item(x, idx) needs two argument");
             return res;
         }
         JKMP::vector<int> idx=params[1].asIntVector();
         bool isNumber=true;
         JKMP::vector<bool> idxb=params[1].asBoolVector();
         if (idx.size()<=0 && idxb.size()<=0) {
-            p->jkmpError("item(x, idx) parameter idx has to be a number, vector of numbers or vector of booleans");
+            JKMATHPARSER_ERROR(p, "item(x, idx) parameter idx has to be a number, vector of numbers or vector of booleans");
             return res;
         } else if (idxb.size()>0) {
             isNumber=false;
             if (idxb.size()!=params[0].size()) {
-                p->jkmpError(JKMP::_("item(x, boolidx) parameter boolidx has to be a vector of booleans with the same length as vector x [length(x)=%2, length(boolidx)=%1]").arg(idxb.size()).arg(params[0].size()));
+                JKMATHPARSER_ERROR(p, JKMP::_("item(x, boolidx) parameter boolidx has to be a vector of booleans with the same length as vector x [length(x)=%2, length(boolidx)=%1]").arg(idxb.size()).arg(params[0].size()));
                 return res;
             }
         }
@@ -2656,7 +2799,7 @@ namespace JKMathParser_DefaultLib {
                     if (i>=0 && i<params[0].str.size()) {
                         r+=params[0].str[idx[i]];
                     } else {
-                        p->jkmpError(JKMP::_("item(x, idx) index i=%1 out of range").arg(idx[i]));
+                        JKMATHPARSER_ERROR(p, JKMP::_("item(x, idx) index i=%1 out of range").arg(idx[i]));
                         return res;
                     }
                 }
@@ -2668,7 +2811,7 @@ namespace JKMathParser_DefaultLib {
                     if (i>=0 && i<params[0].strVec.size()) {
                         r<<params[0].strVec[idx[i]];
                     } else {
-                        p->jkmpError(JKMP::_("item(x, idx) index i=%1 out of range").arg(idx[i]));
+                        JKMATHPARSER_ERROR(p, JKMP::_("item(x, idx) index i=%1 out of range").arg(idx[i]));
                         return res;
                     }
                 }
@@ -2681,7 +2824,7 @@ namespace JKMathParser_DefaultLib {
                     if (i>=0 && i<params[0].boolVec.size()) {
                         r<<params[0].boolVec[idx[i]];
                     } else {
-                        p->jkmpError(JKMP::_("item(x, idx) index i=%1 out of range").arg(idx[i]));
+                        JKMATHPARSER_ERROR(p, JKMP::_("item(x, idx) index i=%1 out of range").arg(idx[i]));
                         return res;
                     }
                 }
@@ -2694,7 +2837,7 @@ namespace JKMathParser_DefaultLib {
                     if (i>=0 && i<params[0].numVec.size()) {
                         r<<params[0].numVec[idx[i]];
                     } else {
-                        p->jkmpError(JKMP::_("item(x, idx) index i=%1 out of range").arg(idx[i]));
+                        JKMATHPARSER_ERROR(p, JKMP::_("item(x, idx) index i=%1 out of range").arg(idx[i]));
                         return res;
                     }
                 }
@@ -2744,7 +2887,7 @@ namespace JKMathParser_DefaultLib {
             }
         }
 
-        p->jkmpError("item(x, idx): x had no entries or unrecognized type");
+        JKMATHPARSER_ERROR(p, "item(x, idx): x had no entries or unrecognized type");
         return res;
     }
 
@@ -2753,7 +2896,7 @@ namespace JKMathParser_DefaultLib {
         jkmpResult res=jkmpResult::invalidResult();
 
         if (n!=2) {
-            p->jkmpError("itemorfirst(x, idx) needs two argument");
+            JKMATHPARSER_ERROR(p, "itemorfirst(x, idx) needs two argument");
             return res;
         }
         JKMP::vector<int> idx=params[1].asIntVector();
@@ -2820,7 +2963,7 @@ namespace JKMathParser_DefaultLib {
 
 
 
-        p->jkmpError("itemorfirst(x, idx): x had no entries or unrecognized type");
+        JKMATHPARSER_ERROR(p, "itemorfirst(x, idx): x had no entries or unrecognized type");
         return res;
     }
     jkmpResult fRunningAverage(const jkmpResult *params, unsigned int n, JKMathParser *p)
@@ -2828,7 +2971,7 @@ namespace JKMathParser_DefaultLib {
         jkmpResult res=jkmpResult::invalidResult();
 
         if (n!=2) {
-            p->jkmpError("runningaverage(x,n) needs two arguments");
+            JKMATHPARSER_ERROR(p, "runningaverage(x,n) needs two arguments");
             return res;
         }
         if (params[0].type==jkmpDoubleVector && params[1].isInteger() && params[1].toInteger()>0) {
@@ -2846,7 +2989,7 @@ namespace JKMathParser_DefaultLib {
             }
             return res;
         } else {
-            p->jkmpError("runningaverage(x,n) requires a number vector as first and an integer number >1 as second argument");
+            JKMATHPARSER_ERROR(p, "runningaverage(x,n) requires a number vector as first and an integer number >1 as second argument");
             return res;
         }
     }
@@ -2856,11 +2999,48 @@ namespace JKMathParser_DefaultLib {
 
 
 
+    /** \brief calls \a func(i, matcher) for the strings <code>[0,count)</code> on the thread pool of \a p (see jkmpParallelVectorFor() ),
+     *         \a matcher is a JKMP::regExpMatcher of \a rx , or \c NULL , if \a rx has no automaton */
+    template <class TFUNC>
+    static void regExpForEach(JKMathParser* p, const JKMathParser::jkmpCompiledRegExp& rx, size_t count, const TFUNC& func) {
+        jkmpParallelVectorFor(p, count, [&rx, &func](size_t start, size_t end) {
+            std::unique_ptr<JKMP::regExpMatcher> matcher;
+            if (rx.automaton) matcher.reset(new JKMP::regExpMatcher(*rx.automaton));
+            for (size_t i=start; i<end; i++) {
+                func(i, matcher.get());
+            }
+        });
+    }
+
+    /** \brief returns capture \a capid of the match of the whole string \a s , or \a defaultStr */
+    static JKMP::string regExpCapture(const JKMathParser::jkmpCompiledRegExp& rx, JKMP::regExpMatcher* matcher, const std::string& s, int capid, const JKMP::string& defaultStr) {
+        // the automaton rejects most strings faster than std::regex, which is only needed for the captures
+        if (matcher && !matcher->match(s)) return defaultStr;
+        std::smatch sm;
+        if (!std::regex_match(s,sm,*rx.regExp)) return defaultStr;
+        return JKMP::string(sm[capid].str());
+    }
+
+    /** \brief returns whether a part of \a s matches */
+    static bool regExpContains(const JKMathParser::jkmpCompiledRegExp& rx, JKMP::regExpMatcher* matcher, const std::string& s) {
+        if (matcher) return matcher->search(s);
+        std::smatch sm;
+        return std::regex_search(s,sm,*rx.regExp);
+    }
+
+    /** \brief returns the position of the first match in \a s , or \c -1 */
+    static double regExpIndexIn(const JKMathParser::jkmpCompiledRegExp& rx, JKMP::regExpMatcher* matcher, const std::string& s) {
+        if (matcher) return double(matcher->searchPosition(s));
+        std::smatch sm;
+        if (std::regex_search(s,sm,*rx.regExp)) return sm.position(0);
+        return -1;
+    }
+
     void fRegExpCapture(jkmpResult& r, const jkmpResult *params, unsigned int n, JKMathParser *p, bool minimal, bool casesens)
     {
         r.setInvalid();
         if (n<2 || n>4) {
-            p->jkmpError(JKMP::_("regexpcap(regexp, strings, cap_id=1, default_string=\"\") needs 2 or 4 arguments"));
+            JKMATHPARSER_ERROR(p, JKMP::_("regexpcap(regexp, strings, cap_id=1, default_string=\"\") needs 2 or 4 arguments"));
             r.setInvalid();
             return;
         }
@@ -2872,7 +3052,7 @@ namespace JKMathParser_DefaultLib {
                     if(params[2].type==jkmpDouble && params[2].toInteger()>=0) {
                         capid=params[2].toInteger();
                     } else {
-                        p->jkmpError(JKMP::_("regexpcap(regexp, strings, cap_id, default_string) argument cap_id has to be a number >=0"));
+                        JKMATHPARSER_ERROR(p, JKMP::_("regexpcap(regexp, strings, cap_id, default_string) argument cap_id has to be a number >=0"));
                         r.setInvalid();
                         return;
                     }
@@ -2881,40 +3061,27 @@ namespace JKMathParser_DefaultLib {
                     if(params[3].type==jkmpString) {
                         defaultStr=params[3].str;
                     } else {
-                        p->jkmpError(JKMP::_("regexpcap(regexp, strings, cap_id, default_string) argument default_string has to be a string"));\
+                        JKMATHPARSER_ERROR(p, JKMP::_("regexpcap(regexp, strings, cap_id, default_string) argument default_string has to be a string"));\
                         r.setInvalid();
                         return;
                     }
                 }
-                std::regex::flag_type flags=std::regex::ECMAScript;
-                if (!casesens) flags=flags|std::regex::icase;
-                std::regex rx(params[0].str, flags);
-                std::smatch sm;
+                const JKMathParser::jkmpCompiledRegExp rx=p->getCompiledRegExp(params[0].str, casesens, minimal);
 
                 if (params[1].type==jkmpStringVector) {
                     r.setStringVec(params[1].strVec);
-                    for (size_t i=0; i<r.strVec.size(); i++) {
-                        if (!std::regex_match(r.strVec[i],sm,rx)) {
-                            r.strVec[i]=defaultStr;
-                        } else {
-                            r.strVec[i]=sm[capid];
-                        }
-                    }
+                    JKMP::stringVector& sv=r.strVec;
+                    regExpForEach(p, rx, sv.size(), [&](size_t i, JKMP::regExpMatcher* m) { sv[i]=regExpCapture(rx, m, sv[i], capid, defaultStr); });
                 } else if (params[1].type==jkmpString) {
-                    r.setString(params[1].str);
-                    if (! std::regex_match (params[1].str,sm,rx)) {
-                        r.str=defaultStr;
-                    } else {
-                        r.str=sm[capid];
-                    }
+                    regExpForEach(p, rx, 1, [&](size_t, JKMP::regExpMatcher* m) { r.setString(regExpCapture(rx, m, params[1].str, capid, defaultStr)); });
                 }
             } else {
-                p->jkmpError(JKMP::_("regexpcap(regexp, strings, cap_id=1, default_string=\"\") argument regexp has to be a string"));
+                JKMATHPARSER_ERROR(p, JKMP::_("regexpcap(regexp, strings, cap_id=1, default_string=\"\") argument regexp has to be a string"));
                 r.setInvalid();
                 return;
             }
         } else {
-            p->jkmpError(JKMP::_("regexpcap(regexp, strings, cap_id, default_string=\"\") argument strings has to be a vector of strings and a string"));
+            JKMATHPARSER_ERROR(p, JKMP::_("regexpcap(regexp, strings, cap_id, default_string=\"\") argument strings has to be a vector of strings and a string"));
             r.setInvalid();
             return;
         }
@@ -2924,32 +3091,28 @@ namespace JKMathParser_DefaultLib {
     void fRegExpContains(jkmpResult& r, const jkmpResult *params, unsigned int n, JKMathParser *p, bool minimal, bool casesens)
     {
         if (n!=2) {\
-            p->jkmpError(JKMP::_("regexpcontains(regexp, strings) needs 2 arguments"));\
+            JKMATHPARSER_ERROR(p, JKMP::_("regexpcontains(regexp, strings) needs 2 arguments"));\
             r.setInvalid();\
             return; \
         }\
         if(params[1].type==jkmpStringVector || params[1].type==jkmpString) {\
             if(params[0].type==jkmpString) {\
-                std::regex::flag_type flags=std::regex::ECMAScript;
-                if (!casesens) flags=flags|std::regex::icase;
-                std::regex rx(params[0].str, flags);
-                std::smatch sm;
+                const JKMathParser::jkmpCompiledRegExp rx=p->getCompiledRegExp(params[0].str, casesens, minimal);
                 if (params[1].type==jkmpStringVector) {
-                    JKMP::vector<bool> bv;
-                    for (size_t i=0; i<params[1].strVec.size(); i++) {
-                        bv.push_back(std::regex_search(params[1].strVec[i],sm,rx));
-                    }
+                    const JKMP::stringVector& sv=params[1].strVec;
+                    JKMP::vector<bool> bv(sv.size(), false);
+                    regExpForEach(p, rx, sv.size(), [&](size_t i, JKMP::regExpMatcher* m) { bv[i]=regExpContains(rx, m, sv[i]); });
                     r.setBoolVec(bv);
                 } else if (params[1].type==jkmpString) {
-                    r.setBoolean(std::regex_search(params[1].str,sm,rx)>=0);
+                    regExpForEach(p, rx, 1, [&](size_t, JKMP::regExpMatcher* m) { r.setBoolean(regExpContains(rx, m, params[1].str)); });
                 }
             } else {
-                p->jkmpError(JKMP::_("regexpcontains(regexp, strings) argument regexp has to be a string"));\
+                JKMATHPARSER_ERROR(p, JKMP::_("regexpcontains(regexp, strings) argument regexp has to be a string"));\
                 r.setInvalid();\
                 return;
             }
         } else {\
-            p->jkmpError(JKMP::_("regexpcontains(regexp, strings) argument strings has to be a vector of strings and a string"));\
+            JKMATHPARSER_ERROR(p, JKMP::_("regexpcontains(regexp, strings) argument strings has to be a vector of strings and a string"));\
             r.setInvalid();\
             return;
         }\
@@ -2959,40 +3122,28 @@ namespace JKMathParser_DefaultLib {
     void fRegExpIndexIn(jkmpResult& r, const jkmpResult *params, unsigned int n, JKMathParser *p, bool minimal, bool casesens)
     {
         if (n!=2) {\
-            p->jkmpError(JKMP::_("regexpindexin(regexp, strings) needs 2 arguments"));\
+            JKMATHPARSER_ERROR(p, JKMP::_("regexpindexin(regexp, strings) needs 2 arguments"));\
             r.setInvalid();\
             return; \
         }\
         if(params[1].type==jkmpStringVector || params[1].type==jkmpString) {\
             if(params[0].type==jkmpString) {\
-                std::regex::flag_type flags=std::regex::ECMAScript;
-                if (!casesens) flags=flags|std::regex::icase;
-                std::regex rx(params[0].str, flags);
-                std::smatch sm;
+                const JKMathParser::jkmpCompiledRegExp rx=p->getCompiledRegExp(params[0].str, casesens, minimal);
                 if (params[1].type==jkmpStringVector) {
-                    JKMP::vector<double> bv;
-                    for (size_t i=0; i<params[1].strVec.size(); i++) {
-                        if (std::regex_search(params[1].strVec[i],sm,rx)) {
-                            bv.push_back(sm.position(0));
-                        } else {
-                            bv.push_back(-1);
-                        }
-                    }
+                    const JKMP::stringVector& sv=params[1].strVec;
+                    JKMP::vector<double> bv(sv.size(), -1.0);
+                    regExpForEach(p, rx, sv.size(), [&](size_t i, JKMP::regExpMatcher* m) { bv[i]=regExpIndexIn(rx, m, sv[i]); });
                     r.setDoubleVec(bv);
                 } else if (params[1].type==jkmpString) {
-                    if (std::regex_search(params[1].str,sm,rx)) {
-                        r.setDouble(sm.position(0));
-                    } else {
-                        r.setDouble(-1);
-                    }
+                    regExpForEach(p, rx, 1, [&](size_t, JKMP::regExpMatcher* m) { r.setDouble(regExpIndexIn(rx, m, params[1].str)); });
                 }
             } else {
-                p->jkmpError(JKMP::_("regexpindexin(regexp, strings) argument regexp has to be a string"));\
+                JKMATHPARSER_ERROR(p, JKMP::_("regexpindexin(regexp, strings) argument regexp has to be a string"));\
                 r.setInvalid();\
                 return;
             }
         } else {\
-            p->jkmpError(JKMP::_("regexpindexin(regexp, strings) argument strings has to be a vector of strings and a string"));\
+            JKMATHPARSER_ERROR(p, JKMP::_("regexpindexin(regexp, strings) argument strings has to be a vector of strings and a string"));\
             r.setInvalid();\
             return;
         }\
@@ -3007,17 +3158,29 @@ namespace JKMathParser_DefaultLib {
             if (params[0].type==jkmpDoubleVector) {
                 res.setDouble(statisticsTrapz(params[0].numVec));
             } else {
-                p->jkmpError("trapz(Y) needs 1 vector of numbers");
+                JKMATHPARSER_ERROR(p, "trapz(Y) needs 1 vector of numbers");
             }
 
         } else if (n==2) {
             if (params[0].type==jkmpDoubleVector && params[1].type==jkmpDoubleVector) {
                 res.setDouble(statisticsTrapzXY(params[0].numVec, params[1].numVec));
             } else {
-                p->jkmpError("trapz(X,Y) needs 2 vectors of numbers");
+                JKMATHPARSER_ERROR(p, "trapz(X,Y) needs 2 vectors of numbers");
             }
         } else {
-            p->jkmpError("trapz(Y)/trapz(X,Y) needs 1 or 2 argument");
+            JKMATHPARSER_ERROR(p, "trapz(Y)/trapz(X,Y) needs 1 or 2 argument");
+        }
+    }
+
+    void fQuantiles(jkmpResult& res, const jkmpResult* params, unsigned int  n, JKMathParser* p) {
+        if (n==2 && params[0].type==jkmpDoubleVector && params[1].type==jkmpDoubleVector) {
+            res.setDoubleVec(params[1].numVec.size());
+            JKMP::selectQuantiles(params[0].numVec.data(), params[0].numVec.size(), params[1].numVec.data(), params[1].numVec.size(), res.numVec.data());
+        } else if (n==2 && params[0].type==jkmpDoubleVector && params[1].type==jkmpDouble) {
+            res.setDouble(JKMP::selectQuantile(params[0].numVec.data(), params[0].numVec.size(), params[1].num));
+        } else {
+            res.setInvalid();
+            JKMATHPARSER_ERROR(p, JKMP::_("quantiles(x, [p1, p2, ...]) needs a vector of numbers x and a vector of probabilities"));
         }
     }
 
@@ -3029,7 +3192,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="datenum";
         r.setInvalid();
         if (n<1||n>2) {
-            p->jkmpError(JKMP::_("%1(date[, formatstring]) needs 1 or 2 arguments").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date[, formatstring]) needs 1 or 2 arguments").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3037,7 +3200,7 @@ namespace JKMathParser_DefaultLib {
             if (n==2 && params[1].type==jkmpString) {
                 format=params[1].str;
             } else if (n==2) {
-                p->jkmpError(JKMP::_("%1(x, formatstring) 2nd argument has to be a string").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x, formatstring) 2nd argument has to be a string").arg(iname));
                 return;
             }
 
@@ -3051,7 +3214,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a string or string vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a string or string vector").arg(iname));
                 return;
             }
             return;
@@ -3063,7 +3226,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="datetimenum";
         r.setInvalid();
         if (n<1||n>2) {
-            p->jkmpError(JKMP::_("%1(date[, formatstring]) needs 1 or 2 arguments").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date[, formatstring]) needs 1 or 2 arguments").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3073,7 +3236,7 @@ namespace JKMathParser_DefaultLib {
                 format=params[1].str;
                 return;
             } else if (n==2) {
-                p->jkmpError(JKMP::_("%1(x, formatstring) 2nd argument has to be a string").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x, formatstring) 2nd argument has to be a string").arg(iname));
                 return;
             }
 
@@ -3088,7 +3251,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a string or string vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a string or string vector").arg(iname));
                 return;
             }
             return;
@@ -3101,7 +3264,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="date2str";
         r.setInvalid();
         if (n<1||n>2) {
-            p->jkmpError(JKMP::_("%1(date[, formatstring]) needs 1 or 2 arguments").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date[, formatstring]) needs 1 or 2 arguments").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3110,7 +3273,7 @@ namespace JKMathParser_DefaultLib {
             if (n==2 && params[1].type==jkmpString) {
                 format=params[1].str;
             } else if (n==2) {
-                p->jkmpError(JKMP::_("%1(x, formatstring) 2nd argument has to be a string").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x, formatstring) 2nd argument has to be a string").arg(iname));
                 return;
             }
 
@@ -3124,7 +3287,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3137,7 +3300,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="date2str";
         r.setInvalid();
         if (n<1||n>2) {
-            p->jkmpError(JKMP::_("%1(date[, formatstring]) needs 1 or 2 arguments").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date[, formatstring]) needs 1 or 2 arguments").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3146,7 +3309,7 @@ namespace JKMathParser_DefaultLib {
             if (n==2 && params[1].type==jkmpString) {
                 format=params[1].str;
             } else if (n==2) {
-                p->jkmpError(JKMP::_("%1(x, formatstring) 2nd argument has to be a string").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x, formatstring) 2nd argument has to be a string").arg(iname));
                 return;
             }
 
@@ -3160,7 +3323,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3172,7 +3335,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="datediff2secs";
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(date) needs 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date) needs 1 argument").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3187,7 +3350,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3199,7 +3362,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="datediff2mins";
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(date) needs 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date) needs 1 argument").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3214,7 +3377,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3226,7 +3389,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="datediff2hours";
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(date) needs 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date) needs 1 argument").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3241,7 +3404,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3253,7 +3416,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="datediff2hours";
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(date) needs 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date) needs 1 argument").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3268,7 +3431,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3281,7 +3444,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="now";
         r.setInvalid();
         if (n!=0) {
-            p->jkmpError(JKMP::_("%1() needs no arguments").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1() needs no arguments").arg(iname));
             return;
         }
         r.setDouble(QDateTime::currentDateTime().toMSecsSinceEpoch());
@@ -3292,7 +3455,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="dateday";
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(date) needs 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date) needs 1 argument").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3307,7 +3470,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3319,7 +3482,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="datemonth";
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(date) needs 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date) needs 1 argument").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3334,7 +3497,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3346,7 +3509,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="dateyear";
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(date) needs 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date) needs 1 argument").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3361,7 +3524,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3373,7 +3536,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="datehour";
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(date) needs 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date) needs 1 argument").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3388,7 +3551,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3399,7 +3562,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="datemin";
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(date) needs 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date) needs 1 argument").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3414,7 +3577,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3427,7 +3590,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="datesec";
         r.setInvalid();
         if (n!=1) {
-            p->jkmpError(JKMP::_("%1(date) needs 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(date) needs 1 argument").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3442,7 +3605,7 @@ namespace JKMathParser_DefaultLib {
                 }
                 return;
             } else {
-                p->jkmpError(JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a double or double vector").arg(iname));
                 return;
             }
             return;
@@ -3456,7 +3619,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="varname";
         r.setInvalid();
         if (n<=0) {
-            p->jkmpError(JKMP::_("%1(...) needs at least 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs at least 1 argument").arg(iname));
             return;
         }
         if (n>=1) {
@@ -3467,7 +3630,7 @@ namespace JKMathParser_DefaultLib {
                     r.strVec[i]=vn->getName();
                 } else {
                     r.setInvalid();
-                    p->jkmpError(JKMP::_("%1(...) needs variable names as input arguments, %2-th argument is of different type (%3)").arg(iname).arg(i+1).arg(typeid(*nodes[i]).name()));
+                    JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs variable names as input arguments, %2-th argument is of different type (%3)").arg(iname).arg(i+1).arg(typeid(*nodes[i]).name()));
                     return;
                 }
             }
@@ -3495,7 +3658,7 @@ namespace JKMathParser_DefaultLib {
         } else if (n==3 && params[0].type==jkmpString && params[1].type==jkmpString && params[2].type==jkmpString) {
             r.str=r.str.replace(params[1].str, params[2].str);
         } else {
-            p->jkmpError(JKMP::_("replace(x, old_value,new_value) needs 3 arguments: one vector x and two corresponding element values, or 3 strings"));
+            JKMATHPARSER_ERROR(p, JKMP::_("replace(x, old_value,new_value) needs 3 arguments: one vector x and two corresponding element values, or 3 strings"));
             r.setInvalid();
             return;
         }
@@ -3509,7 +3672,7 @@ namespace JKMathParser_DefaultLib {
         if (n>=3 && n%2==1 && params[0].type==jkmpDoubleVector && params[1].type==jkmpDouble && params[2].type==jkmpDouble) {
             for (unsigned int j=1; j<n; j+=2) {
                 if (params[j].type!=jkmpDouble || params[j+1].type!=jkmpDouble) {
-                    p->jkmpError(errorm);
+                    JKMATHPARSER_ERROR(p, errorm);
                     r.setInvalid();
                     return;
                 }
@@ -3520,7 +3683,7 @@ namespace JKMathParser_DefaultLib {
         } else if (n>=3 && n%2==1 && params[0].type==jkmpStringVector && params[1].type==jkmpString && params[2].type==jkmpString) {
             for (unsigned int j=1; j<n; j+=2) {
                 if (params[j].type!=jkmpString || params[j+1].type!=jkmpString) {
-                    p->jkmpError(errorm);
+                    JKMATHPARSER_ERROR(p, errorm);
                     r.setInvalid();
                     return;
                 }
@@ -3531,7 +3694,7 @@ namespace JKMathParser_DefaultLib {
         } else if (n>=3 && n%2==1 && params[0].type==jkmpBoolVector && params[1].type==jkmpBool && params[2].type==jkmpBool) {
             for (size_t j=1; j<n; j+=2) {
                 if (params[j].type!=jkmpBool || params[j+1].type!=jkmpBool) {
-                    p->jkmpError(errorm);
+                    JKMATHPARSER_ERROR(p, errorm);
                     r.setInvalid();
                     return;
                 }
@@ -3542,7 +3705,7 @@ namespace JKMathParser_DefaultLib {
         } else if (n>=3 && n%2==1 && params[0].type==jkmpString && params[1].type==jkmpString && params[2].type==jkmpString) {
             for (size_t j=1; j<n; j+=2) {
                 if (params[j].type!=jkmpString || params[j+1].type!=jkmpString) {
-                    p->jkmpError(errorm);
+                    JKMATHPARSER_ERROR(p, errorm);
                     r.setInvalid();
                     return;
                 }
@@ -3550,7 +3713,7 @@ namespace JKMathParser_DefaultLib {
                 r.str=r.str.replace(params[j].str, params[j+1].str);
             }
         } else {
-            p->jkmpError(errorm);
+            JKMATHPARSER_ERROR(p, errorm);
             r.setInvalid();
             return;
         }
@@ -3562,7 +3725,7 @@ namespace JKMathParser_DefaultLib {
         if (n==2 && params[0].type==jkmpString && params[1].type==jkmpString) {
             r.setStringVec(params[0].str.split(params[1].str));
         } else {
-            p->jkmpError(JKMP::_("split(x, param) needs 2 string arguments"));
+            JKMATHPARSER_ERROR(p, JKMP::_("split(x, param) needs 2 string arguments"));
             r.setInvalid();
             return;
         }
@@ -3577,7 +3740,7 @@ namespace JKMathParser_DefaultLib {
                 if (!params[0].strVec[i].is_empty()) r.strVec<<params[0].strVec[i];
             }
         } else {
-            p->jkmpError(JKMP::_("removeemptystrings(x) needs 1 string vector arguments"));
+            JKMATHPARSER_ERROR(p, JKMP::_("removeemptystrings(x) needs 1 string vector arguments"));
             r.setInvalid();
             return;
         }
@@ -3591,7 +3754,7 @@ namespace JKMathParser_DefaultLib {
             if (params[1].type==jkmpString) {
                 sep=params[1].str;
             } else {
-                p->jkmpError(JKMP::_("join(x, separator) needs a string as second argument"));
+                JKMATHPARSER_ERROR(p, JKMP::_("join(x, separator) needs a string as second argument"));
                 r.setInvalid();
                 return;
             }
@@ -3599,7 +3762,7 @@ namespace JKMathParser_DefaultLib {
         if (n>0 && params[0].type==jkmpStringVector) {
             r.setString(params[0].strVec.join(sep));
         } else {
-            p->jkmpError(JKMP::_("join(x, separator) needs a string vector as first argument"));
+            JKMATHPARSER_ERROR(p, JKMP::_("join(x, separator) needs a string vector as first argument"));
             r.setInvalid();
             return;
         }
@@ -3614,7 +3777,7 @@ namespace JKMathParser_DefaultLib {
         res.setInvalid();
 
         if (n<1) {
-            p->jkmpError("returnfirstvalid(x1,x2,x3,...) needs at least one argument");
+            JKMATHPARSER_ERROR(p, "returnfirstvalid(x1,x2,x3,...) needs at least one argument");
             return ;
         }
         for (unsigned int i=0; i<n; i++) {
@@ -3631,7 +3794,7 @@ namespace JKMathParser_DefaultLib {
         res.setInvalid();
 
         if (n<1) {
-            p->jkmpError("returnlastvalid(x1,x2,x3,...) needs at least one argument");
+            JKMATHPARSER_ERROR(p, "returnlastvalid(x1,x2,x3,...) needs at least one argument");
             return ;
         }
         for ( long i=(long)n-1; i>=0; i--) {
@@ -3648,7 +3811,7 @@ namespace JKMathParser_DefaultLib {
         JKMP::string iname="type";
         if (n<=0) {
             r.setInvalid();
-            p->jkmpError(JKMP::_("%1(...) needs at least 1 argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs at least 1 argument").arg(iname));
             return;
         }
         if (n==1) {
@@ -3672,7 +3835,7 @@ namespace JKMathParser_DefaultLib {
             } else if (nodes[i].type==jkmpVoid || !nodes[i].isValid) {
             } else {
                 res.setInvalid();
-                p->jkmpError(JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
                 return;
             }
         }
@@ -3689,7 +3852,7 @@ namespace JKMathParser_DefaultLib {
             } else if (nodes[i].type==jkmpVoid || !nodes[i].isValid) {
             } else {
                 res.setInvalid();
-                p->jkmpError(JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
                 return;
             }
         }
@@ -3706,7 +3869,7 @@ namespace JKMathParser_DefaultLib {
             } else if (nodes[i].type==jkmpVoid || !nodes[i].isValid) {
             } else {
                 res.setInvalid();
-                p->jkmpError(JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
                 return;
             }
         }
@@ -3717,7 +3880,7 @@ namespace JKMathParser_DefaultLib {
         const JKMP::string tname="integer";
         if (n==0) {
             res.setInvalid();
-            p->jkmpError(JKMP::_("%1(...) needs at least one argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs at least one argument").arg(iname));
             return;
         } else if (n==1) {
             int i=0;
@@ -3729,7 +3892,7 @@ namespace JKMathParser_DefaultLib {
                 for (int j=0; j<iv.size(); j++) res.numVec<<iv[j];
             } else {
                 res.setInvalid();
-                p->jkmpError(JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3 in argument %2").arg(iname).arg(1).arg(tname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3 in argument %2").arg(iname).arg(1).arg(tname));
                 return;
             }
         } else {
@@ -3743,7 +3906,7 @@ namespace JKMathParser_DefaultLib {
                     for (int j=0; j<iv.size(); j++) res.numVec<<iv[j];
                 } else {
                     res.setInvalid();
-                    p->jkmpError(JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
+                    JKMATHPARSER_ERROR(p, JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
                     return;
                 }
             }
@@ -3755,7 +3918,7 @@ namespace JKMathParser_DefaultLib {
         const JKMP::string tname="number";
         if (n==0) {
             res.setInvalid();
-            p->jkmpError(JKMP::_("%1(...) needs at least one argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs at least one argument").arg(iname));
             return;
         } else if (n==1) {
             int i=0;
@@ -3765,7 +3928,7 @@ namespace JKMathParser_DefaultLib {
                 res.setDoubleVec(nodes[i].asVector());
             } else {
                 res.setInvalid();
-                p->jkmpError(JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3 in argument %2").arg(iname).arg(1).arg(tname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3 in argument %2").arg(iname).arg(1).arg(tname));
                 return;
             }
         } else {
@@ -3777,7 +3940,7 @@ namespace JKMathParser_DefaultLib {
                     res.numVec<<nodes[i].asVector();
                 } else {
                     res.setInvalid();
-                    p->jkmpError(JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
+                    JKMATHPARSER_ERROR(p, JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
                     return;
                 }
             }
@@ -3789,7 +3952,7 @@ namespace JKMathParser_DefaultLib {
         const JKMP::string tname="boolean";
         if (n==0) {
             res.setInvalid();
-            p->jkmpError(JKMP::_("%1(...) needs at least one argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs at least one argument").arg(iname));
             return;
         } else if (n==1) {
             int i=0;
@@ -3799,7 +3962,7 @@ namespace JKMathParser_DefaultLib {
                 res.setBoolVec(nodes[i].asBoolVector());
             } else {
                 res.setInvalid();
-                p->jkmpError(JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3 in argument %2").arg(iname).arg(1).arg(tname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3 in argument %2").arg(iname).arg(1).arg(tname));
                 return;
             }
         } else {
@@ -3811,7 +3974,7 @@ namespace JKMathParser_DefaultLib {
                     res.boolVec<<nodes[i].asBoolVector();
                 } else {
                     res.setInvalid();
-                    p->jkmpError(JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
+                    JKMATHPARSER_ERROR(p, JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
                     return;
                 }
             }
@@ -3828,7 +3991,7 @@ namespace JKMathParser_DefaultLib {
             } else if (nodes[i].type==jkmpVoid || !nodes[i].isValid) {
             } else {
                 res.setInvalid();
-                p->jkmpError(JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(...) encountered a datatype, which cannot be converted to a %3/%3 vector in argument %2").arg(iname).arg(i+1).arg(tname));
                 return;
             }
         }
@@ -3874,7 +4037,7 @@ namespace JKMathParser_DefaultLib {
             }
         } else {
             res.setInvalid();
-            p->jkmpError(JKMP::_("%1(x,desiredsize,defaultvalue) needs three arguments: one vector, one integer and one argument copatible with x").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x,desiredsize,defaultvalue) needs three arguments: one vector, one integer and one argument copatible with x").arg(iname));
             return;
         }
 
@@ -3920,7 +4083,7 @@ namespace JKMathParser_DefaultLib {
             }
         } else {
             res.setInvalid();
-            p->jkmpError(JKMP::_("%1(x,desiredsize,defaultvalue) needs three arguments: one vector, one integer and one argument copatible with x").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x,desiredsize,defaultvalue) needs three arguments: one vector, one integer and one argument copatible with x").arg(iname));
             return;
         }
     }
@@ -3944,7 +4107,7 @@ namespace JKMathParser_DefaultLib {
                 norm=params[2].boolean;
             } else {
                 res.setInvalid();
-                p->jkmpError(JKMP::_("%1(data[,bins][,normalize]) needs an unsigned integer for bins and a boolean for normalize (both optional)").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(data[,bins][,normalize]) needs an unsigned integer for bins and a boolean for normalize (both optional)").arg(iname));
                 return;
             }
             JKMP::vector<double> temp;
@@ -3953,7 +4116,7 @@ namespace JKMathParser_DefaultLib {
             statisticsHistogram(params[0].numVec.data(), params[0].numVec.size(), temp.data(), res.numVec.data(), bins, norm);
         } else {
             res.setInvalid();
-            p->jkmpError(JKMP::_("%1(data[,bins][,normalize]) needs at least one number vector argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(data[,bins][,normalize]) needs at least one number vector argument").arg(iname));
             return;
         }
     }
@@ -3973,7 +4136,7 @@ namespace JKMathParser_DefaultLib {
                 norm=params[2].boolean;
             } else {
                 res.setInvalid();
-                p->jkmpError(JKMP::_("%1(data[,bins][,normalize]) needs an unsigned integer for bins and a boolean for normalize (both optional)").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(data[,bins][,normalize]) needs an unsigned integer for bins and a boolean for normalize (both optional)").arg(iname));
                 return;
             }
             JKMP::vector<double> temp;
@@ -3982,7 +4145,7 @@ namespace JKMathParser_DefaultLib {
             statisticsHistogram(params[0].numVec.data(), params[0].numVec.size(), res.numVec.data(), temp.data(), bins, norm);
         } else {
             res.setInvalid();
-            p->jkmpError(JKMP::_("%1(data[,bins][,normalize]) needs at least one number vector argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(data[,bins][,normalize]) needs at least one number vector argument").arg(iname));
             return;
         }
 
@@ -4014,7 +4177,7 @@ namespace JKMathParser_DefaultLib {
                 norm=params[4].boolean;
             } else {
                 res.setInvalid();
-                p->jkmpError(JKMP::_("%1(data,min,max[,bins][,normalize]) needs an unsigned integer for bins and a boolean for normalize (both optional)").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(data,min,max[,bins][,normalize]) needs an unsigned integer for bins and a boolean for normalize (both optional)").arg(iname));
                 return;
             }
             JKMP::vector<double> temp;
@@ -4023,7 +4186,7 @@ namespace JKMathParser_DefaultLib {
             statisticsHistogramRanged(params[0].numVec.data(), params[0].numVec.size(), rmin, rmax, temp.data(), res.numVec.data(), bins, norm);
         } else {
             res.setInvalid();
-            p->jkmpError(JKMP::_("%1(data,min,max[,bins][,normalize]) needs at least one number vector argument").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(data,min,max[,bins][,normalize]) needs at least one number vector argument").arg(iname));
             return;
         }
     }
@@ -4047,7 +4210,7 @@ namespace JKMathParser_DefaultLib {
                 norm=params[paramoffset+3].boolean;
             } else {
                 res.setInvalid();
-                p->jkmpError(JKMP::_("%1([data,]min,max[,bins][,normalize]) needs an unsigned integer for bins and a boolean for normalize (both optional)").arg(iname));
+                JKMATHPARSER_ERROR(p, JKMP::_("%1([data,]min,max[,bins][,normalize]) needs an unsigned integer for bins and a boolean for normalize (both optional)").arg(iname));
                 return;
             }
             JKMP::vector<double> temp;
@@ -4058,7 +4221,7 @@ namespace JKMathParser_DefaultLib {
             statisticsHistogramRanged(dummy.data(), dummy.size(), rmin, rmax, res.numVec.data(), temp.data(), bins, norm);
         } else {
             res.setInvalid();
-            p->jkmpError(JKMP::_("%1([data,]min,max[,bins][,normalize]) needs at least two number arguments").arg(iname));
+            JKMATHPARSER_ERROR(p, JKMP::_("%1([data,]min,max[,bins][,normalize]) needs at least two number arguments").arg(iname));
             return;
         }
 
@@ -4082,25 +4245,25 @@ namespace JKMathParser_DefaultLib {
     void fPolyFit(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         r.setDoubleVec();
         if (n!=3) {
-            p->jkmpError("polyfit(X,Y,n) needs 3 arguments");
+            JKMATHPARSER_ERROR(p, "polyfit(X,Y,n) needs 3 arguments");
             r.setInvalid();
             return;
 
         }
         if (!(params[0].convertsToVector() && params[1].convertsToVector())) {
-            p->jkmpError("polyfit(X,Y,n) arguments X and Y have to be of type number vector");
+            JKMATHPARSER_ERROR(p, "polyfit(X,Y,n) arguments X and Y have to be of type number vector");
             r.setInvalid();
             return;
 
         }
         if (params[0].size()!= params[1].size()) {
-            p->jkmpError("polyfit(X,Y,n) arguments X and Y have to have the same length");
+            JKMATHPARSER_ERROR(p, "polyfit(X,Y,n) arguments X and Y have to have the same length");
             r.setInvalid();
             return;
 
         }
         if (!(params[2].isInteger())) {
-            p->jkmpError("polyfit(X,Y,n) argument n has to be a positive integer number");
+            JKMATHPARSER_ERROR(p, "polyfit(X,Y,n) argument n has to be a positive integer number");
             r.setInvalid();
             return;
 
@@ -4111,7 +4274,7 @@ namespace JKMathParser_DefaultLib {
         int32_t np=params[2].toInteger();
 
         if (np<=0) {
-            p->jkmpError("polyfit(X,Y,n) argument n has to be a positive integer number");
+            JKMATHPARSER_ERROR(p, "polyfit(X,Y,n) argument n has to be a positive integer number");
             r.setInvalid();
             return;
 
@@ -4128,19 +4291,19 @@ namespace JKMathParser_DefaultLib {
     void fRegression(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         r.setDoubleVec();
         if (n!=2 && n!=4) {
-            p->jkmpError("regression(X,Y) needs 2 or 4 arguments");
+            JKMATHPARSER_ERROR(p, "regression(X,Y) needs 2 or 4 arguments");
             r.setInvalid();
             return;
 
         }
         if (!(params[0].convertsToVector() && params[1].convertsToVector())) {
-            p->jkmpError("regression(X,Y) arguments X and Y have to be of type number vector");
+            JKMATHPARSER_ERROR(p, "regression(X,Y) arguments X and Y have to be of type number vector");
             r.setInvalid();
             return;
 
         }
         if (params[0].size()!= params[1].size()) {
-            p->jkmpError("regression(X,Y) arguments X and Y have to have the same length");
+            JKMATHPARSER_ERROR(p, "regression(X,Y) arguments X and Y have to have the same length");
             r.setInvalid();
             return;
 
@@ -4151,7 +4314,7 @@ namespace JKMathParser_DefaultLib {
         bool fixB=false;
         if (n==4) {
             if (!(params[2].type==jkmpString && params[3].type==jkmpDouble)) {
-                p->jkmpError(JKMP::_("regression(X,Y,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number, but parameters are %1 and %2").arg(params[2].toTypeString()).arg(params[3].toTypeString()));
+                JKMATHPARSER_ERROR(p, JKMP::_("regression(X,Y,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number, but parameters are %1 and %2").arg(params[2].toTypeString()).arg(params[3].toTypeString()));
                 r.setInvalid();
                 return;
 
@@ -4163,7 +4326,7 @@ namespace JKMathParser_DefaultLib {
                 fixB=true;
                 b=params[3].num;
             } else {
-                p->jkmpError(JKMP::_("regression(X,Y,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number 'a' or 'b', but was %1").arg(params[2].toTypeString()));
+                JKMATHPARSER_ERROR(p, JKMP::_("regression(X,Y,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number 'a' or 'b', but was %1").arg(params[2].toTypeString()));
                 r.setInvalid();
                 return;
 
@@ -4182,19 +4345,19 @@ namespace JKMathParser_DefaultLib {
     void fWeightedRegression(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         r.setDoubleVec();
         if (n!=3 && n!=5) {
-            p->jkmpError("weighted_regression(X,Y,W) needs 3 or 5 arguments");
+            JKMATHPARSER_ERROR(p, "weighted_regression(X,Y,W) needs 3 or 5 arguments");
             r.setInvalid();
             return;
 
         }
         if (!(params[0].convertsToVector() && params[1].convertsToVector() && params[2].convertsToVector())) {
-            p->jkmpError("weighted_regression(X,Y,W) arguments X, Y and W have to be of type number vector");
+            JKMATHPARSER_ERROR(p, "weighted_regression(X,Y,W) arguments X, Y and W have to be of type number vector");
             r.setInvalid();
             return;
 
         }
         if (params[0].size()!= params[1].size() || params[0].size()!= params[2].size() || params[2].size()!= params[2].size()) {
-            p->jkmpError("weighted_regression(X,Y,W) arguments X, Y and W have to have the same length");
+            JKMATHPARSER_ERROR(p, "weighted_regression(X,Y,W) arguments X, Y and W have to have the same length");
             r.setInvalid();
             return;
 
@@ -4205,7 +4368,7 @@ namespace JKMathParser_DefaultLib {
         bool fixB=false;
         if (n==5) {
             if (!(params[3].type==jkmpString && params[4].type==jkmpDouble)) {
-                p->jkmpError("weighted_regression(X,Y,W,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number");
+                JKMATHPARSER_ERROR(p, "weighted_regression(X,Y,W,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number");
                 r.setInvalid();
                 return;
 
@@ -4217,7 +4380,7 @@ namespace JKMathParser_DefaultLib {
                 fixB=true;
                 b=params[4].num;
             } else {
-                p->jkmpError(JKMP::_("weighted_regression(X,Y,W,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number 'a' or 'b', but was %1").arg(params[3].toTypeString()));
+                JKMATHPARSER_ERROR(p, JKMP::_("weighted_regression(X,Y,W,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number 'a' or 'b', but was %1").arg(params[3].toTypeString()));
                 r.setInvalid();
                 return;
 
@@ -4237,19 +4400,19 @@ namespace JKMathParser_DefaultLib {
     void fIRLS(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         r.setDoubleVec();
         if (n<2 && n>6) {
-            p->jkmpError("irls(X,Y) needs between 2 and 6 arguments");
+            JKMATHPARSER_ERROR(p, "irls(X,Y) needs between 2 and 6 arguments");
             r.setInvalid();
             return;
 
         }
         if (!(params[0].convertsToVector() && params[1].convertsToVector())) {
-            p->jkmpError("irls(X,Y) arguments X and Y have to be of type number vector");
+            JKMATHPARSER_ERROR(p, "irls(X,Y) arguments X and Y have to be of type number vector");
             r.setInvalid();
             return;
 
         }
         if (params[0].size()!= params[1].size()) {
-            p->jkmpError("irls(X,Y) arguments X and Y have to have the same length");
+            JKMATHPARSER_ERROR(p, "irls(X,Y) arguments X and Y have to have the same length");
             r.setInvalid();
             return;
 
@@ -4276,7 +4439,7 @@ namespace JKMathParser_DefaultLib {
 
         if ((int64_t)n==fixOffset+2) {
             if (!(params[fixOffset+0].type==jkmpString && params[fixOffset+1].type==jkmpDouble)) {
-                p->jkmpError("irls(X,Y,...,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number");
+                JKMATHPARSER_ERROR(p, "irls(X,Y,...,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number");
                 r.setInvalid();
                 return;
 
@@ -4288,7 +4451,7 @@ namespace JKMathParser_DefaultLib {
                 fixB=true;
                 b=params[fixOffset+1].num;
             } else {
-                p->jkmpError(JKMP::_("irls(X,Y,...,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number 'a' or 'b', but was %1").arg(params[fixOffset+0].toTypeString()));
+                JKMATHPARSER_ERROR(p, JKMP::_("irls(X,Y,...,'fixParameter',fixValue) argument fixParameter has to be a string and fixValue a number 'a' or 'b', but was %1").arg(params[fixOffset+0].toTypeString()));
                 r.setInvalid();
                 return;
 
@@ -4328,19 +4491,19 @@ namespace JKMathParser_DefaultLib {
     void fErrorAdd(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         r.setDoubleVec();
         if (n!=2) {
-            p->jkmpError("erroradd(X,Y) needs 2 arguments");
+            JKMATHPARSER_ERROR(p, "erroradd(X,Y) needs 2 arguments");
             r.setInvalid();
             return;
 
         }
         if (!(params[0].type==jkmpDoubleVector && params[1].type==jkmpDoubleVector)) {
-            p->jkmpError("erroradd(X,Y) arguments X and Y have to be of type number vector");
+            JKMATHPARSER_ERROR(p, "erroradd(X,Y) arguments X and Y have to be of type number vector");
             r.setInvalid();
             return;
 
         }
         if (params[0].size()!=2 || params[1].size()!=2) {
-            p->jkmpError("erroradd(X,Y) arguments X and Y have to have length 2");
+            JKMATHPARSER_ERROR(p, "erroradd(X,Y) arguments X and Y have to have length 2");
             r.setInvalid();
             return;
 
@@ -4360,19 +4523,19 @@ namespace JKMathParser_DefaultLib {
     void fErrorSub(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         r.setDoubleVec();
         if (n!=2) {
-            p->jkmpError("errorsub(X,Y) needs 2 arguments");
+            JKMATHPARSER_ERROR(p, "errorsub(X,Y) needs 2 arguments");
             r.setInvalid();
             return;
 
         }
         if (!(params[0].type==jkmpDoubleVector && params[1].type==jkmpDoubleVector)) {
-            p->jkmpError("errorsub(X,Y) arguments X and Y have to be of type number vector");
+            JKMATHPARSER_ERROR(p, "errorsub(X,Y) arguments X and Y have to be of type number vector");
             r.setInvalid();
             return;
 
         }
         if (params[0].size()!=2 || params[1].size()!=2) {
-            p->jkmpError("errorsub(X,Y) arguments X and Y have to have length 2");
+            JKMATHPARSER_ERROR(p, "errorsub(X,Y) arguments X and Y have to have length 2");
             r.setInvalid();
             return;
 
@@ -4395,19 +4558,19 @@ namespace JKMathParser_DefaultLib {
     void fErrorMul(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         r.setDoubleVec();
         if (n!=2) {
-            p->jkmpError("errormul(X,Y) needs 2 arguments");
+            JKMATHPARSER_ERROR(p, "errormul(X,Y) needs 2 arguments");
             r.setInvalid();
             return;
 
         }
         if (!(params[0].type==jkmpDoubleVector && params[1].type==jkmpDoubleVector)) {
-            p->jkmpError("errormul(X,Y) arguments X and Y have to be of type number vector");
+            JKMATHPARSER_ERROR(p, "errormul(X,Y) arguments X and Y have to be of type number vector");
             r.setInvalid();
             return;
 
         }
         if (params[0].size()!=2 || params[1].size()!=2) {
-            p->jkmpError("errormul(X,Y) arguments X and Y have to have length 2");
+            JKMATHPARSER_ERROR(p, "errormul(X,Y) arguments X and Y have to have length 2");
             r.setInvalid();
             return;
 
@@ -4427,19 +4590,19 @@ namespace JKMathParser_DefaultLib {
     void fErrorDiv(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         r.setDoubleVec();
         if (n!=2) {
-            p->jkmpError("errordiv(X,Y) needs 2 arguments");
+            JKMATHPARSER_ERROR(p, "errordiv(X,Y) needs 2 arguments");
             r.setInvalid();
             return;
 
         }
         if (!(params[0].type==jkmpDoubleVector && params[1].type==jkmpDoubleVector)) {
-            p->jkmpError("errordiv(X,Y) arguments X and Y have to be of type number vector");
+            JKMATHPARSER_ERROR(p, "errordiv(X,Y) arguments X and Y have to be of type number vector");
             r.setInvalid();
             return;
 
         }
         if (params[0].size()!=2 || params[1].size()!=2) {
-            p->jkmpError("errordiv(X,Y) arguments X and Y have to have length 2");
+            JKMATHPARSER_ERROR(p, "errordiv(X,Y) arguments X and Y have to have length 2");
             r.setInvalid();
             return;
 
@@ -4458,17 +4621,17 @@ namespace JKMathParser_DefaultLib {
     void fErrorPow(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p){
         r.setDoubleVec();
         if (n!=2) {
-            p->jkmpError("errorpow(X,Y) needs 2 arguments");
+            JKMATHPARSER_ERROR(p, "errorpow(X,Y) needs 2 arguments");
             r.setInvalid();
             return;
         }
         if (!(params[0].type==jkmpDoubleVector && params[1].type==jkmpDoubleVector)) {
-            p->jkmpError("errorpow(X,Y) arguments X and Y have to be of type number vector");
+            JKMATHPARSER_ERROR(p, "errorpow(X,Y) arguments X and Y have to be of type number vector");
             r.setInvalid();
             return;
         }
         if (params[0].size()!=2 || params[1].size()!=2) {
-            p->jkmpError("errorpow(X,Y) arguments X and Y have to have length 2");
+            JKMATHPARSER_ERROR(p, "errorpow(X,Y) arguments X and Y have to have length 2");
             r.setInvalid();
             return;
         }
@@ -4499,13 +4662,13 @@ namespace JKMathParser_DefaultLib {
                     //qDebug()<<"### "<<i<<": "<<params[i].str<<params[i].toTypeString()<<params[i+1].toTypeString();
                     r.structData[params[i].str]=params[i+1];
                 } else {
-                    p->jkmpError(JKMP::_("struct([struct_in,] name1, value1, ...) requires a string as parameter %2").arg(i+1));
+                    JKMATHPARSER_ERROR(p, JKMP::_("struct([struct_in,] name1, value1, ...) requires a string as parameter %2").arg(i+1));
                     r.setInvalid();
                     return;
                 }
             }
         } else {
-            p->jkmpError("struct([struct_in,] name1, value1, ...) requires an optinal struct as first argument and an even number of name/value pairs");
+            JKMATHPARSER_ERROR(p, "struct([struct_in,] name1, value1, ...) requires an optinal struct as first argument and an even number of name/value pairs");
             r.setInvalid();
             return;
         }
@@ -4516,7 +4679,7 @@ namespace JKMathParser_DefaultLib {
         if (n==1 && params[0].type==jkmpStruct) {
             r.setStringVec(params[0].structData.keys());
         } else {
-            p->jkmpError("structkeys(struct_in) requires one struct argument");
+            JKMATHPARSER_ERROR(p, "structkeys(struct_in) requires one struct argument");
             r.setInvalid();
             return;
         }
@@ -4527,12 +4690,12 @@ namespace JKMathParser_DefaultLib {
             if (params[0].structData.contains(params[1].str)) {
                 r=params[0].structData.value(params[1].str, jkmpResult::invalidResult());
             } else {
-                p->jkmpError(JKMP::_("structget(struct_in, item): the given element '%1' does not exist in struct_in").arg(params[1].str));
+                JKMATHPARSER_ERROR(p, JKMP::_("structget(struct_in, item): the given element '%1' does not exist in struct_in").arg(params[1].str));
                 r.setInvalid();
                 return;
             }
         } else {
-            p->jkmpError("structget(struct_in, item) requires one struct and one string argument");
+            JKMATHPARSER_ERROR(p, "structget(struct_in, item) requires one struct and one string argument");
             r.setInvalid();
             return;
         }
@@ -4542,7 +4705,7 @@ namespace JKMathParser_DefaultLib {
         if (n==2 && params[0].type==jkmpStruct && params[1].type==jkmpString) {
             r=params[0].structData.value(params[1].str, jkmpResult::invalidResult());
         } else {
-            p->jkmpError("structsaveget(struct_in, item) requires one struct and one string argument");
+            JKMATHPARSER_ERROR(p, "structsaveget(struct_in, item) requires one struct and one string argument");
             r.setInvalid();
             return;
         }
@@ -4558,7 +4721,7 @@ namespace JKMathParser_DefaultLib {
                 int ro=params[0].toUInt();
                 r.setDoubleMatrix(ro*ro, ro);
             } else {
-                p->jkmpError("doublematrix(rows_or_cols) requires one unsigned integer argument ");
+                JKMATHPARSER_ERROR(p, "doublematrix(rows_or_cols) requires one unsigned integer argument ");
                 r.setInvalid();
                 return;
             }
@@ -4568,7 +4731,7 @@ namespace JKMathParser_DefaultLib {
                 int co=params[1].toUInt();
                 r.setDoubleMatrix(ro*co, co);
             } else {
-                p->jkmpError("doublematrix(rows,cols) requires two unsigned integer arguments");
+                JKMATHPARSER_ERROR(p, "doublematrix(rows,cols) requires two unsigned integer arguments");
                 r.setInvalid();
                 return;
             }
@@ -4578,7 +4741,7 @@ namespace JKMathParser_DefaultLib {
                 int co=params[1].toUInt();
                 r.setDoubleMatrix(ro*co, co, params[2].num);
             } else {
-                p->jkmpError("doublematrix(rows,cols, value) requires two unsigned integer arguments and one floating-point number");
+                JKMATHPARSER_ERROR(p, "doublematrix(rows,cols, value) requires two unsigned integer arguments and one floating-point number");
                 r.setInvalid();
                 return;
             }
@@ -4594,7 +4757,7 @@ namespace JKMathParser_DefaultLib {
                 int ro=params[0].toUInt();
                 r.setBoolMatrix(ro*ro, ro, false);
             } else {
-                p->jkmpError("boolmatrix(rows_or_cols) requires one unsigned integer argument ");
+                JKMATHPARSER_ERROR(p, "boolmatrix(rows_or_cols) requires one unsigned integer argument ");
                 r.setInvalid();
                 return;
             }
@@ -4604,7 +4767,7 @@ namespace JKMathParser_DefaultLib {
                 int co=params[1].toUInt();
                 r.setBoolMatrix(ro*co, co, false);
             } else {
-                p->jkmpError("boolmatrix(rows,cols) requires two unsigned integer arguments");
+                JKMATHPARSER_ERROR(p, "boolmatrix(rows,cols) requires two unsigned integer arguments");
                 r.setInvalid();
                 return;
             }
@@ -4614,7 +4777,7 @@ namespace JKMathParser_DefaultLib {
                 int co=params[1].toUInt();
                 r.setBoolMatrix(ro*co, co, params[2].boolean);
             } else {
-                p->jkmpError("boolmatrix(rows,cols, value) requires two unsigned integer arguments and one boolean");
+                JKMATHPARSER_ERROR(p, "boolmatrix(rows,cols, value) requires two unsigned integer arguments and one boolean");
                 r.setInvalid();
                 return;
             }
@@ -4642,8 +4805,8 @@ namespace JKMathParser_DefaultLib {
                 r.listData.push_back(params[i]);
             }
         } else {
-            if (n<2) p->jkmpError(JKMP::_("listappend(list_in, item, ...) requires one list and at least one further argument, but only %1 arguments given").arg(n));
-            else if (n>=2) p->jkmpError(JKMP::_("listappend(list_in, item, ...) requires one list and at least one further argument, but arguments of type %1, %2, ... given").arg(params[0].typeName()).arg(params[1].typeName()));
+            if (n<2) JKMATHPARSER_ERROR(p, JKMP::_("listappend(list_in, item, ...) requires one list and at least one further argument, but only %1 arguments given").arg(n));
+            else if (n>=2) JKMATHPARSER_ERROR(p, JKMP::_("listappend(list_in, item, ...) requires one list and at least one further argument, but arguments of type %1, %2, ... given").arg(params[0].typeName()).arg(params[1].typeName()));
             r.setInvalid();
             return;
         }
@@ -4669,14 +4832,14 @@ namespace JKMathParser_DefaultLib {
                         if (l[i]) r.listData[i]=params[0].getListItem(i);
                     }
                 } else {
-                    p->jkmpError(JKMP::_("listget(list_in, boolvec) wrong number of items in boolvec (#%1): requires boolvec to have the same number of entries, as list_in (#%2)").arg(l.size()).arg(r.listData.size()));
+                    JKMATHPARSER_ERROR(p, JKMP::_("listget(list_in, boolvec) wrong number of items in boolvec (#%1): requires boolvec to have the same number of entries, as list_in (#%2)").arg(l.size()).arg(r.listData.size()));
                     r.setInvalid();
                     return;
                 }
             }
         } else {
-            if (n<2) p->jkmpError(JKMP::_("listget(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but only %1 arguments given").arg(n));
-            else if (n>=2) p->jkmpError(JKMP::_("listget(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but arguments of type %1, %2 given").arg(params[0].typeName()).arg(params[1].typeName()));
+            if (n<2) JKMATHPARSER_ERROR(p, JKMP::_("listget(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but only %1 arguments given").arg(n));
+            else if (n>=2) JKMATHPARSER_ERROR(p, JKMP::_("listget(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but arguments of type %1, %2 given").arg(params[0].typeName()).arg(params[1].typeName()));
             r.setInvalid();
             return;
         }
@@ -4703,14 +4866,14 @@ namespace JKMathParser_DefaultLib {
                         else r.listData[i]=params[2];
                     }
                 } else {
-                    p->jkmpError(JKMP::_("listgetsave(list_in, boolvec) wrong number of items in boolvec (#%1): requires boolvec to have the same number of entries, as list_in (#%2)").arg(l.size()).arg(r.listData.size()));
+                    JKMATHPARSER_ERROR(p, JKMP::_("listgetsave(list_in, boolvec) wrong number of items in boolvec (#%1): requires boolvec to have the same number of entries, as list_in (#%2)").arg(l.size()).arg(r.listData.size()));
                     r.setInvalid();
                     return;
                 }
             }
         } else {
-            if (n<3) p->jkmpError(JKMP::_("listget(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but only %1 arguments given").arg(n));
-            else if (n>=3) p->jkmpError(JKMP::_("listget(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but arguments of type %1, %2 given").arg(params[0].typeName()).arg(params[1].typeName()).arg(params[2].typeName()));
+            if (n<3) JKMATHPARSER_ERROR(p, JKMP::_("listget(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but only %1 arguments given").arg(n));
+            else if (n>=3) JKMATHPARSER_ERROR(p, JKMP::_("listget(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but arguments of type %1, %2 given").arg(params[0].typeName()).arg(params[1].typeName()).arg(params[2].typeName()));
             r.setInvalid();
             return;
         }
@@ -4736,12 +4899,12 @@ namespace JKMathParser_DefaultLib {
                     r.listData[i].setString(params[0].boolVec[i]);
                 }
             } else {
-                p->jkmpError(JKMP::_("vec2list(x) requires one vector of double/string/boolean as argument, but the argument x is a %1").arg(params[0].typeName()));
+                JKMATHPARSER_ERROR(p, JKMP::_("vec2list(x) requires one vector of double/string/boolean as argument, but the argument x is a %1").arg(params[0].typeName()));
                 r.setInvalid();
                 return;
             }
         } else {
-            p->jkmpError(JKMP::_("vec2list(x) requires one vector of double/string/boolean as argument, but only %1 arguments given").arg(n));
+            JKMATHPARSER_ERROR(p, JKMP::_("vec2list(x) requires one vector of double/string/boolean as argument, but only %1 arguments given").arg(n));
             r.setInvalid();
             return;
         }
@@ -4751,7 +4914,7 @@ namespace JKMathParser_DefaultLib {
         if (n==1) {
             r.setBoolean(params[0].type==jkmpList);
         } else {
-            p->jkmpError(JKMP::_("islist(x) requires one argument, but %1 arguments given").arg(n));
+            JKMATHPARSER_ERROR(p, JKMP::_("islist(x) requires one argument, but %1 arguments given").arg(n));
             r.setInvalid();
             return;
         }
@@ -4762,7 +4925,7 @@ namespace JKMathParser_DefaultLib {
         if (n==1) {
             r.setBoolean(params[0].type==jkmpStruct);
         } else {
-            p->jkmpError(JKMP::_("isstruct(x) requires one argument, but %1 arguments given").arg(n));
+            JKMATHPARSER_ERROR(p, JKMP::_("isstruct(x) requires one argument, but %1 arguments given").arg(n));
             r.setInvalid();
             return;
         }
@@ -4773,7 +4936,7 @@ namespace JKMathParser_DefaultLib {
         if (n==1) {
             r.setBoolean((params[0].type==jkmpBoolMatrix)||(params[0].type==jkmpDoubleMatrix));
         } else {
-            p->jkmpError(JKMP::_("ismatrix(x) requires one argument, but %1 arguments given").arg(n));
+            JKMATHPARSER_ERROR(p, JKMP::_("ismatrix(x) requires one argument, but %1 arguments given").arg(n));
             r.setInvalid();
             return;
         }
@@ -4784,7 +4947,7 @@ namespace JKMathParser_DefaultLib {
         if (n==1) {
             r.setBoolean(params[0].type==jkmpDoubleMatrix);
         } else {
-            p->jkmpError(JKMP::_("isdoublematrix(x) requires one argument, but %1 arguments given").arg(n));
+            JKMATHPARSER_ERROR(p, JKMP::_("isdoublematrix(x) requires one argument, but %1 arguments given").arg(n));
             r.setInvalid();
             return;
         }
@@ -4795,7 +4958,7 @@ namespace JKMathParser_DefaultLib {
         if (n==1) {
             r.setBoolean(params[0].type==jkmpBoolMatrix);
         } else {
-            p->jkmpError(JKMP::_("isboolmatrix(x) requires one argument, but %1 arguments given").arg(n));
+            JKMATHPARSER_ERROR(p, JKMP::_("isboolmatrix(x) requires one argument, but %1 arguments given").arg(n));
             r.setInvalid();
             return;
         }
@@ -4820,14 +4983,14 @@ namespace JKMathParser_DefaultLib {
                         if (l[i]) r.removeListItem(i);
                     }
                 } else {
-                    p->jkmpError(JKMP::_("listaremove(list_in, boolvec) wrong number of items in boolvec (#%1): requires boolvec to have the same number of entries, as list_in (#%2)").arg(l.size()).arg(r.listData.size()));
+                    JKMATHPARSER_ERROR(p, JKMP::_("listaremove(list_in, boolvec) wrong number of items in boolvec (#%1): requires boolvec to have the same number of entries, as list_in (#%2)").arg(l.size()).arg(r.listData.size()));
                     r.setInvalid();
                     return;
                 }
             }
         } else {
-            if (n<2) p->jkmpError(JKMP::_("listaremove(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but only %1 arguments given").arg(n));
-            else if (n>=2) p->jkmpError(JKMP::_("listaremove(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but arguments of type %1, %2 given").arg(params[0].typeName()).arg(params[1].typeName()));
+            if (n<2) JKMATHPARSER_ERROR(p, JKMP::_("listaremove(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but only %1 arguments given").arg(n));
+            else if (n>=2) JKMATHPARSER_ERROR(p, JKMP::_("listaremove(list_in, items) requires one list and one integer/boolean-vector/integer-vector arguments, but arguments of type %1, %2 given").arg(params[0].typeName()).arg(params[1].typeName()));
             r.setInvalid();
             return;
         }
@@ -4842,8 +5005,8 @@ namespace JKMathParser_DefaultLib {
                 r.listData.insert(r.listData.begin()+(idx+i-2), params[i]);
             }
         } else {
-            if (n<3) p->jkmpError(JKMP::_("listinsert(list_in, index, items) requires one list and one integer/boolean-vector/integer-vector arguments, but only %1 arguments given").arg(n));
-            else if (n>=3) p->jkmpError(JKMP::_("listinsert(list_in, index, items) requires one list and one integer/boolean-vector/integer-vector arguments, but arguments of type %1, %2, %3 given").arg(params[0].typeName()).arg(params[1].typeName()).arg(params[2].typeName()));
+            if (n<3) JKMATHPARSER_ERROR(p, JKMP::_("listinsert(list_in, index, items) requires one list and one integer/boolean-vector/integer-vector arguments, but only %1 arguments given").arg(n));
+            else if (n>=3) JKMATHPARSER_ERROR(p, JKMP::_("listinsert(list_in, index, items) requires one list and one integer/boolean-vector/integer-vector arguments, but arguments of type %1, %2, %3 given").arg(params[0].typeName()).arg(params[1].typeName()).arg(params[2].typeName()));
             r.setInvalid();
             return;
         }
@@ -4853,7 +5016,7 @@ namespace JKMathParser_DefaultLib {
         jkmpResult res=jkmpResult::invalidResult();
 
         if (n!=1) {
-            p->jkmpError("lastinvector(x) needs one argument");
+            JKMATHPARSER_ERROR(p, "lastinvector(x) needs one argument");
             return res;
         }
         if (params[0].type==jkmpDouble) return jkmpResult(params[0].num);
@@ -4863,7 +5026,7 @@ namespace JKMathParser_DefaultLib {
         if (params[0].type==jkmpString) return jkmpResult(params[0].str);
         if (params[0].type==jkmpStringVector && params[0].size()>0) return jkmpResult(params[0].strVec.back());
 
-        p->jkmpError("lastinvector(x): x had no entries or unrecognized type");
+        JKMATHPARSER_ERROR(p, "lastinvector(x): x had no entries or unrecognized type");
         return res;
     }
 
@@ -4872,7 +5035,7 @@ namespace JKMathParser_DefaultLib {
         jkmpResult res=jkmpResult::invalidResult();
 
         if (n!=1) {
-            p->jkmpError("firstinvector(x) needs one argument");
+            JKMATHPARSER_ERROR(p, "firstinvector(x) needs one argument");
             return res;
         }
         if (params[0].type==jkmpDouble) return jkmpResult(params[0].num);
@@ -4882,7 +5045,7 @@ namespace JKMathParser_DefaultLib {
         if (params[0].type==jkmpString) return jkmpResult(params[0].str);
         if (params[0].type==jkmpStringVector && params[0].size()>0) return jkmpResult(params[0].strVec.front());
 
-        p->jkmpError("firstinvector(x): x had no entries or unrecognized type");
+        JKMATHPARSER_ERROR(p, "firstinvector(x): x had no entries or unrecognized type");
         return res;
     }
 
@@ -58,14 +58,14 @@ namespace JKMathParser_DefaultLib {
     JKMATHPARSER_DEFINE_3PARAM1VEC_NUMERIC_FUNC(fBinomialPDF, binomialpdf, JKMP::binomialDist)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC(fSinc, sinc, JKMP::sinc)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC(fTanc, tanc, JKMP::tanc)
-    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fSin, sin)
-    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fCos, cos)
+    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_VEC(fSin, sin, sin, JKMP::vecSin)
+    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_VEC(fCos, cos, cos, JKMP::vecCos)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fTan, tan)
-    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fExp, exp)
-    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fLog, log)
+    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_VEC(fExp, exp, exp, JKMP::vecExp)
+    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_VEC(fLog, log, log, JKMP::vecLog)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fLog10, log10)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fLog2, log2)
-    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fSqrt, sqrt)
+    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_VEC(fSqrt, sqrt, sqrt, JKMP::vecSqrt)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fCbrt, cbrt)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fSqr, JKMP::sqr)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC(fAbs, abs, fabs)
@@ -74,13 +74,13 @@ namespace JKMathParser_DefaultLib {
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fATan, atan)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fSinh, sinh)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fCosh, cosh)
-    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fTanh, tanh)
+    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_VEC(fTanh, tanh, tanh, JKMP::vecTanh)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fASinh, asinh)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fACosh, acosh)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fATanh, atanh)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fErf, erf)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fErfc, erfc)
-    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(flGamma, lgamma)
+    JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC(flGamma, lgamma, JKMP::logGamma)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(ftGamma, tgamma)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fJ0, j0)
     JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(fJ1, j1)
@@ -173,6 +173,18 @@ namespace JKMathParser_DefaultLib {
     void fMat2Vec(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
     void fVec2Mat(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
     void fReshape(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fMatMul(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fTranspose(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fSolve(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fInv(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fDet(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fFFT(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fIFFT(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fRFFT(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fIRFFT(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fFFTConvolve(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fXCorr(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fAutoCorr(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
 
     void fDoubleMatrix(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
     void fBoolMatrix(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
@@ -201,26 +213,27 @@ namespace JKMathParser_DefaultLib {
     void fRepeat(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
     void fRepeatString(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
 
-    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fMean, mean, statisticsAverage)
+    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_PFUNC(fMean, mean, jkmpStatisticsAverage)
 
-    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fSkewness, skewness, statisticsSkewness)
-    JKMATHPARSER_DEFINE_2PARAM1VEC_VECTONUM_CFUNC(fCentralMoment, moment, statisticsCentralMoment)
+    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_PFUNC(fSkewness, skewness, jkmpStatisticsSkewness)
+    JKMATHPARSER_DEFINE_2PARAM1VEC_VECTONUM_PFUNC(fCentralMoment, moment, jkmpStatisticsCentralMoment)
     JKMATHPARSER_DEFINE_2PARAM1VEC_VECTONUM_CFUNC(fNonCentralMoment, ncmoment, statisticsMoment)
     JKMATHPARSER_DEFINE_2PARAM2VEC_VECTONUM_CFUNC_1N(fCorrcoeff, corrcoeff, statisticsCorrelationCoefficient)
     JKMATHPARSER_DEFINE_2PARAM2VEC_VECTONUM_CFUNC_1N(fMandersOverlapCoeff, mandersoverlap, statisticsMandersOverlapCoefficient)
 
     JKMATHPARSER_DEFINE_1PARAM_NUMERICVEC_FUNC(fDiff, diff, statisticsDiff)
-    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fSum, sum, statisticsSum)
+    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_PFUNC(fSum, sum, jkmpStatisticsSum)
     JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fProd, prod, statisticsProd)
-    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fSum2, sum2, statisticsSum2)
-    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fVar, var, statisticsVariance)
-    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fStd, std, statisticsStdDev)
-    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fMedian, median, statisticsMedian)
-    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fMAD, mad, statisticsMAD)
-    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fNMAD, nmad, statisticsNMAD)
-    JKMATHPARSER_DEFINE_2PARAM1VEC_VECTONUM_CFUNC(fQuantile, quantile, statisticsQuantile)
-    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fQuantile25, quantile25, statisticsQuantile25)
-    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fQuantile75, quantile75, statisticsQuantile75)
+    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_PFUNC(fSum2, sum2, jkmpStatisticsSum2)
+    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_PFUNC(fVar, var, jkmpStatisticsVariance)
+    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_PFUNC(fStd, std, jkmpStatisticsStdDev)
+    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fMedian, median, JKMP::selectMedian)
+    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fMAD, mad, JKMP::selectMAD)
+    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fNMAD, nmad, JKMP::selectNMAD)
+    JKMATHPARSER_DEFINE_2PARAM1VEC_VECTONUM_CFUNC(fQuantile, quantile, JKMP::selectQuantile)
+    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fQuantile25, quantile25, JKMP::selectQuantile25)
+    JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(fQuantile75, quantile75, JKMP::selectQuantile75)
+    void fQuantiles(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
 
     JKMATHPARSER_DEFINE_1PARAM_NUMERICVEC_FUNC(fCumSum, cumsum, statisticsCumSum)
     JKMATHPARSER_DEFINE_1PARAM_NUMERICVEC_FUNC(fCumProd, cumprod, statisticsCumProd)
@@ -361,6 +374,9 @@ namespace JKMathParser_DefaultLib {
     void fFilterFinite(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
     void fSelect(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
     void fUnique(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fUniqueSorted(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fUniqueCounts(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
+    void fUniqueIndices(jkmpResult &r, const jkmpResult* params, unsigned int  n, JKMathParser* p);
     jkmpResult fIndexedAvg(const jkmpResult* params, unsigned int  n, JKMathParser* p);
     jkmpResult fIndexedVar(const jkmpResult* params, unsigned int  n, JKMathParser* p);
     jkmpResult fIndexedStd(const jkmpResult* params, unsigned int  n, JKMathParser* p);
@@ -0,0 +1,323 @@
+/*
+    Copyright (c) 2008-2016 Jan W. Krieger (<jan@jkrieger.de>)
+
+
+    This software is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License (LGPL) as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License (LGPL) for more details.
+
+    You should have received a copy of the GNU Lesser General Public License (LGPL)
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "jkmpffttools.h"
+#include <cmath>
+#include <algorithm>
+
+#ifndef M_PI
+#  define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    /** \brief complex product without the NaN/infinity handling of the <code>std::complex</code> operator (which GCC calls as a library function) */
+    inline JKMP::fftPlan::complexType cmul(const JKMP::fftPlan::complexType& a, const JKMP::fftPlan::complexType& b) {
+        return JKMP::fftPlan::complexType(a.real()*b.real()-a.imag()*b.imag(), a.real()*b.imag()+a.imag()*b.real());
+    }
+}
+
+JKMP::fftPlan::fftPlan(size_t n, bool realTransforms):
+    n(n)
+{
+    // exp(-2*pi*i*k/n), the second half from the first, so symmetric twiddles are exactly conjugate
+    twiddles.resize(n);
+    for (size_t k=0; k<n; k++) {
+        if (2*k<=n) twiddles[k]=std::polar(1.0, -2.0*M_PI*double(k)/double(n));
+        else twiddles[k]=std::conj(twiddles[n-k]);
+    }
+
+    // factorize n: first radix-4 stages, then radix 2, then the odd primes
+    size_t rest=n;
+    size_t p=4;
+    bool bluestein=false;
+    while (rest>1) {
+        while (rest%p!=0) {
+            if (p==4) p=2;
+            else if (p==2) p=3;
+            else p+=2;
+            if (p*p>rest) p=rest;
+        }
+        if (p>JKMP_FFT_MAXRADIX) bluestein=true;
+        rest/=p;
+        Stage s;
+        s.radix=p;
+        s.length=rest;
+        stages.push_back(s);
+    }
+
+    if (bluestein) {
+        // X[k] = w[k] * sum_j (x[j]*w[j]) * conj(w[k-j]) with the chirp w[k]=exp(-pi*i*k^2/n), as a circular convolution of power-of-2 length
+        stages.clear();
+        size_t m=1;
+        while (m<2*n-1) m*=2;
+        bluesteinPlan=std::make_shared<const fftPlan>(m, false);
+        bluesteinChirp.resize(n);
+        for (size_t k=0; k<n; k++) {
+            // k^2 mod 2n keeps the argument small, so the chirp is accurate for large k
+            const uint64_t k2=(uint64_t(k)*uint64_t(k))%(2*uint64_t(n));
+            bluesteinChirp[k]=std::polar(1.0, -M_PI*double(k2)/double(n));
+        }
+        std::vector<complexType> b(m, complexType(0.0, 0.0));
+        b[0]=std::conj(bluesteinChirp[0]);
+        for (size_t k=1; k<n; k++) {
+            b[k]=b[m-k]=std::conj(bluesteinChirp[k]);
+        }
+        bluesteinFilter.resize(m);
+        bluesteinPlan->forward(b.data(), bluesteinFilter.data());
+        for (size_t k=0; k<m; k++) bluesteinFilter[k]/=double(m);
+    }
+
+    if (realTransforms && n>=2 && n%2==0) {
+        halfPlan=std::make_shared<const fftPlan>(n/2, false);
+    }
+}
+
+void JKMP::fftPlan::transform(const complexType *in, complexType *out, bool inverse) const
+{
+    if (n==0) return;
+    // the inverse transform is conj(forward(conj(x)))
+    std::vector<complexType> buf;
+    const complexType* src=in;
+    if (inverse || in==out) {
+        buf.assign(in, in+n);
+        if (inverse) {
+            for (size_t k=0; k<n; k++) buf[k]=std::conj(buf[k]);
+        }
+        src=buf.data();
+    }
+    forward(src, out);
+    if (inverse) {
+        for (size_t k=0; k<n; k++) out[k]=std::conj(out[k]);
+    }
+}
+
+void JKMP::fftPlan::realForward(const double *in, complexType *out) const
+{
+    if (n==0) return;
+    const size_t h=n/2;
+    if (!halfPlan) {
+        std::vector<complexType> x(in, in+n), X(n);
+        forward(x.data(), X.data());
+        std::copy(X.begin(), X.begin()+h+1, out);
+        return;
+    }
+    // transform z[k]=x[2k]+i*x[2k+1] of half the length and split it into the transforms E of the even and O of the odd items:
+    // X[k] = E[k] + exp(-2*pi*i*k/n)*O[k]
+    std::vector<complexType> z(h), Z(h);
+    for (size_t k=0; k<h; k++) z[k]=complexType(in[2*k], in[2*k+1]);
+    halfPlan->forward(z.data(), Z.data());
+    for (size_t k=0; k<=h; k++) {
+        const complexType zk=Z[(k<h)?k:0];
+        const complexType zc=std::conj(Z[(k>0)?(h-k):0]);
+        const complexType E=(zk+zc)*0.5;
+        // (zk-zc)/(2i)
+        const complexType O(0.5*(zk.imag()-zc.imag()), -0.5*(zk.real()-zc.real()));
+        out[k]=E+cmul(twiddles[k], O);
+    }
+}
+
+void JKMP::fftPlan::realInverse(const complexType *in, double *out) const
+{
+    if (n==0) return;
+    const size_t h=n/2;
+    if (!halfPlan) {
+        std::vector<complexType> X(n), x(n);
+        for (size_t k=0; k<=h; k++) X[k]=in[k];
+        for (size_t k=h+1; k<n; k++) X[k]=std::conj(in[n-k]);
+        transform(X.data(), x.data(), true);
+        for (size_t k=0; k<n; k++) out[k]=x[k].real();
+        return;
+    }
+    // reverse of realForward(): Z[k] = 2*(E[k] + i*O[k]), transformed back with half the length (again via conj(forward(conj(Z))))
+    std::vector<complexType> Z(h), z(h);
+    for (size_t k=0; k<h; k++) {
+        const complexType xk=in[k];
+        const complexType xc=std::conj(in[h-k]);
+        const complexType o=cmul(xk-xc, std::conj(twiddles[k]));
+        Z[k]=std::conj((xk+xc)+complexType(-o.imag(), o.real()));
+    }
+    halfPlan->forward(Z.data(), z.data());
+    for (size_t k=0; k<h; k++) {
+        out[2*k]=z[k].real();
+        out[2*k+1]=-z[k].imag();
+    }
+}
+
+size_t JKMP::fftPlan::goodSize(size_t n)
+{
+    size_t m=std::max<size_t>(n, 2);
+    if (m%2!=0) m++;
+    for (;; m+=2) {
+        size_t r=m;
+        while (r%2==0) r/=2;
+        while (r%3==0) r/=3;
+        while (r%5==0) r/=5;
+        if (r==1) return m;
+    }
+}
+
+void JKMP::fftPlan::forward(const complexType *in, complexType *out) const
+{
+    if (!bluesteinFilter.empty()) {
+        forwardBluestein(in, out);
+    } else if (stages.empty()) {
+        if (n>0) out[0]=in[0];
+    } else {
+        complexType scratch[JKMP_FFT_MAXRADIX];
+        work(out, in, 1, 0, scratch);
+    }
+}
+
+void JKMP::fftPlan::work(complexType *out, const complexType *in, size_t stride, size_t stage, complexType *scratch) const
+{
+    const size_t p=stages[stage].radix;
+    const size_t m=stages[stage].length;
+    if (m==1) {
+        for (size_t j=0; j<p; j++) out[j]=in[j*stride];
+    } else {
+        for (size_t j=0; j<p; j++) work(out+j*m, in+j*stride, stride*p, stage+1, scratch);
+    }
+
+    // combine the p sub-transforms of length m, the twiddle factor of item u of sub-transform q is exp(-2*pi*i*q*u/(p*m))=twiddles[q*u*stride]
+    const complexType* tw=twiddles.data();
+    switch (p) {
+        case 2:
+            for (size_t u=0; u<m; u++) {
+                const complexType t=cmul(out[u+m], tw[u*stride]);
+                out[u+m]=out[u]-t;
+                out[u]+=t;
+            }
+            break;
+        case 4:
+            for (size_t u=0; u<m; u++) {
+                const complexType a0=out[u];
+                const complexType a1=cmul(out[u+m], tw[u*stride]);
+                const complexType a2=cmul(out[u+2*m], tw[2*u*stride]);
+                const complexType a3=cmul(out[u+3*m], tw[3*u*stride]);
+                const complexType s0=a0+a2, s1=a0-a2, s2=a1+a3, s3=a1-a3;
+                // -i*s3
+                const complexType r3(s3.imag(), -s3.real());
+                out[u]=s0+s2;
+                out[u+m]=s1+r3;
+                out[u+2*m]=s0-s2;
+                out[u+3*m]=s1-r3;
+            }
+            break;
+        case 3: {
+                const double sin60=0.86602540378443864676;
+                for (size_t u=0; u<m; u++) {
+                    const complexType a0=out[u];
+                    const complexType a1=cmul(out[u+m], tw[u*stride]);
+                    const complexType a2=cmul(out[u+2*m], tw[2*u*stride]);
+                    const complexType s=a1+a2, d=a1-a2;
+                    const complexType t=a0-0.5*s;
+                    // -i*sin(60)*d
+                    const complexType r(sin60*d.imag(), -sin60*d.real());
+                    out[u]=a0+s;
+                    out[u+m]=t+r;
+                    out[u+2*m]=t-r;
+                }
+            } break;
+        default:
+            for (size_t u=0; u<m; u++) {
+                for (size_t q=0; q<p; q++) scratch[q]=out[u+q*m];
+                for (size_t q1=0; q1<p; q1++) {
+                    const size_t k=u+q1*m;
+                    size_t idx=0;
+                    complexType acc=scratch[0];
+                    for (size_t q=1; q<p; q++) {
+                        idx+=stride*k;
+                        if (idx>=n) idx-=n;
+                        acc+=cmul(scratch[q], tw[idx]);
+                    }
+                    out[k]=acc;
+                }
+            }
+            break;
+    }
+}
+
+void JKMP::fftPlan::forwardBluestein(const complexType *in, complexType *out) const
+{
+    const size_t m=bluesteinPlan->size();
+    std::vector<complexType> a(m, complexType(0.0, 0.0)), A(m);
+    for (size_t k=0; k<n; k++) a[k]=cmul(in[k], bluesteinChirp[k]);
+    bluesteinPlan->forward(a.data(), A.data());
+    // inverse transform of A*filter via conj(forward(conj(.)))
+    for (size_t k=0; k<m; k++) a[k]=std::conj(cmul(A[k], bluesteinFilter[k]));
+    bluesteinPlan->forward(a.data(), A.data());
+    for (size_t k=0; k<n; k++) out[k]=cmul(bluesteinChirp[k], std::conj(A[k]));
+}
+
+
+void JKMP::convolve(const double *x, size_t nx, const double *y, size_t ny, double *out, const fftPlan *plan)
+{
+    if (nx==0 || ny==0) return;
+    const size_t len=nx+ny-1;
+    if (std::min(nx, ny)<=JKMP_FFT_DIRECTCONVOLVE || !plan) {
+        std::fill(out, out+len, 0.0);
+        for (size_t i=0; i<nx; i++) {
+            for (size_t j=0; j<ny; j++) out[i+j]+=x[i]*y[j];
+        }
+        return;
+    }
+    const size_t N=plan->size();
+    const size_t h=N/2;
+    std::vector<double> buf(N, 0.0);
+    std::vector<fftPlan::complexType> X(h+1), Y(h+1);
+    std::copy(x, x+nx, buf.begin());
+    plan->realForward(buf.data(), X.data());
+    std::fill(buf.begin(), buf.end(), 0.0);
+    std::copy(y, y+ny, buf.begin());
+    plan->realForward(buf.data(), Y.data());
+    for (size_t k=0; k<=h; k++) X[k]=cmul(X[k], Y[k])/double(N);
+    plan->realInverse(X.data(), buf.data());
+    std::copy(buf.begin(), buf.begin()+len, out);
+}
+
+void JKMP::crossCorrelate(const double *x, size_t nx, const double *y, size_t ny, double *out, const fftPlan *plan)
+{
+    // the correlation is the convolution with the reversed y
+    std::vector<double> yr(y, y+ny);
+    std::reverse(yr.begin(), yr.end());
+    convolve(x, nx, yr.data(), ny, out, plan);
+}
+
+void JKMP::autoCorrelate(const double *x, size_t n, double *out, size_t maxLag, const fftPlan *plan)
+{
+    if (n==0) return;
+    maxLag=std::min(maxLag, n-1);
+    if (maxLag<JKMP_FFT_DIRECTCONVOLVE || !plan) {
+        for (size_t k=0; k<=maxLag; k++) {
+            double s=0;
+            for (size_t j=0; j+k<n; j++) s+=x[j+k]*x[j];
+            out[k]=s;
+        }
+        return;
+    }
+    // inverse transform of the power spectrum, zero padded to >=2n-1 items, so the circular correlation equals the linear one
+    const size_t N=plan->size();
+    const size_t h=N/2;
+    std::vector<double> buf(N, 0.0);
+    std::vector<fftPlan::complexType> X(h+1);
+    std::copy(x, x+n, buf.begin());
+    plan->realForward(buf.data(), X.data());
+    for (size_t k=0; k<=h; k++) X[k]=fftPlan::complexType(std::norm(X[k])/double(N), 0.0);
+    plan->realInverse(X.data(), buf.data());
+    std::copy(buf.begin(), buf.begin()+maxLag+1, out);
+}
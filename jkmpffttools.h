@@ -0,0 +1,119 @@
+/*
+    Copyright (c) 2008-2016 Jan W. Krieger (<jan@jkrieger.de>)
+
+
+    This software is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License (LGPL) as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License (LGPL) for more details.
+
+    You should have received a copy of the GNU Lesser General Public License (LGPL)
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file jkmpffttools.h
+ *  \ingroup jkmplib_mathtools_parser
+ */
+#ifndef JKMATHPARSERFFTTOOLS_H
+#define JKMATHPARSERFFTTOOLS_H
+
+#include <stdint.h>
+#include <complex>
+#include <vector>
+#include <memory>
+#include "jkmplib_imexport.h"
+
+/** \brief largest prime factor of a length, which fftPlan transforms with a radix-p butterfly (lengths with larger prime factors use Bluestein's algorithm) */
+#ifndef JKMP_FFT_MAXRADIX
+#  define JKMP_FFT_MAXRADIX 31
+#endif
+
+/** \brief JKMP::convolve() computes the sums directly, if the shorter input has at most this many items (JKMP::autoCorrelate(): if there are at most this many lags) */
+#ifndef JKMP_FFT_DIRECTCONVOLVE
+#  define JKMP_FFT_DIRECTCONVOLVE 32
+#endif
+
+namespace JKMP {
+
+    /** \brief precomputed twiddle factors and factorization of a discrete Fourier transform of a fixed length
+     *
+     *  The transform is a recursive mixed-radix Cooley-Tukey FFT with butterflies for the radices 2, 4 and 3 and a generic butterfly
+     *  for the other prime factors up to JKMP_FFT_MAXRADIX. Lengths with a larger prime factor are computed with Bluestein's algorithm,
+     *  i.e. as a convolution with a power-of-2 FFT, so every length costs O(n log n). A plan of even length also holds a plan of
+     *  half the length, which transforms real data (realForward(), realInverse()) as complex data of half the length.
+     *
+     *  A plan is not changed by the transforms, so it may be used from several threads at once. Plans are expensive to set up
+     *  (twiddle factors), so JKMathParser keeps them in a cache, see JKMathParser::getFFTPlan().
+     */
+    class JKMPLIB_EXPORT fftPlan {
+        public:
+            typedef std::complex<double> complexType;
+
+            /** \brief sets up the plan of length \a n
+             *
+             *  If \a realTransforms is \c false , the plan of half the length is not set up, so realForward() and realInverse() use
+             *  a complex transform of length \a n (this is used for the internal plans, which only transform complex data).
+             */
+            explicit fftPlan(size_t n, bool realTransforms=true);
+            /** \brief length of the transform */
+            inline size_t size() const { return n; }
+
+            /** \brief computes the transform <code>out[k] = sum_j in[j]*exp(-+2*pi*i*j*k/n)</code> (\c - for the forward transform, \c + if \a inverse ),
+             *         without normalization. \a in and \a out have size() items and may be the same array. */
+            void transform(const complexType* in, complexType* out, bool inverse=false) const;
+            /** \brief computes the first <code>size()/2+1</code> items of the forward transform of the real data \a in ( size() items) */
+            void realForward(const double* in, complexType* out) const;
+            /** \brief computes the real inverse transform (without normalization) of the <code>size()/2+1</code> items \a in of a hermitian spectrum */
+            void realInverse(const complexType* in, double* out) const;
+
+            /** \brief returns the smallest even length \c >=n , which has no prime factors larger than 5 (these lengths transform fastest) */
+            static size_t goodSize(size_t n);
+        protected:
+            /** \brief a stage of the transform: the radix and the length of the sub-transforms */
+            struct Stage {
+                size_t radix;
+                size_t length;
+            };
+            size_t n;
+            /** \brief stages of the recursion (empty if bluestein is used) */
+            std::vector<Stage> stages;
+            /** \brief <code>exp(-2*pi*i*k/n)</code> for k=0..n-1 */
+            std::vector<complexType> twiddles;
+            /** \brief plan of half the length, used by realForward() and realInverse() (\c NULL for odd lengths, or if it was not requested) */
+            std::shared_ptr<const fftPlan> halfPlan;
+            /** \brief plan of the power-of-2 length of Bluestein's convolution (\c NULL , if the mixed-radix recursion is used) */
+            std::shared_ptr<const fftPlan> bluesteinPlan;
+            /** \brief the chirp <code>exp(-pi*i*k^2/n)</code> of Bluestein's algorithm */
+            std::vector<complexType> bluesteinChirp;
+            /** \brief transform of the conjugate chirp, divided by the length of bluesteinPlan */
+            std::vector<complexType> bluesteinFilter;
+
+            /** \brief forward transform with the mixed-radix recursion, \a out must not overlap \a in */
+            void forward(const complexType* in, complexType* out) const;
+            /** \brief computes the sub-transform of stage \a stage of the items <code>in[0], in[stride], ...</code> to \a out ( \a scratch has JKMP_FFT_MAXRADIX items) */
+            void work(complexType* out, const complexType* in, size_t stride, size_t stage, complexType* scratch) const;
+            /** \brief forward transform with Bluestein's algorithm, \a out must not overlap \a in */
+            void forwardBluestein(const complexType* in, complexType* out) const;
+    };
+
+    /** \brief computes the full linear convolution <code>out[k] = sum_j x[j]*y[k-j]</code> ( \a nx + \a ny -1 items) of \a x and \a y
+     *
+     *  The convolution is computed with the real FFTs of \a plan , which has to be of even length \c >=nx+ny-1 (see fftPlan::goodSize() ),
+     *  or directly, if one of the inputs has at most JKMP_FFT_DIRECTCONVOLVE items (then \a plan may be \c NULL ). \a out must not overlap the inputs.
+     */
+    JKMPLIB_EXPORT void convolve(const double* x, size_t nx, const double* y, size_t ny, double* out, const fftPlan* plan);
+    /** \brief computes the full cross-correlation <code>out[k+ny-1] = sum_j x[j+k]*y[j]</code> for the lags <code>k=-(ny-1)..nx-1</code> ( \a nx + \a ny -1 items),
+     *         see convolve() for \a plan */
+    JKMPLIB_EXPORT void crossCorrelate(const double* x, size_t nx, const double* y, size_t ny, double* out, const fftPlan* plan);
+    /** \brief computes the autocorrelation <code>out[k] = sum_j x[j+k]*x[j]</code> for the lags <code>k=0..maxLag</code> ( \a maxLag < \a n ),
+     *         \a plan has to be of even length \c >=2*n-1 (or \c NULL , if \a maxLag < JKMP_FFT_DIRECTCONVOLVE , then the sums are computed directly) */
+    JKMPLIB_EXPORT void autoCorrelate(const double* x, size_t n, double* out, size_t maxLag, const fftPlan* plan);
+
+}
+
+#endif // JKMATHPARSERFFTTOOLS_H
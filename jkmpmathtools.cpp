@@ -22,13 +22,29 @@
 #include "jkmpmathtools.h"
 #include <float.h>
 #include <complex>
+#include <algorithm>
+#include <cstring>
 #include "./StatisticsTools/statistics_tools.h"
+#include "jkmpthreadtools.h"
 
 double JKMP::tanc(  double x ) {
     if (x==0) return 1;
     return tan(x)/x;
 }
 
+double JKMP::logGamma( double x )
+{
+#if defined(__GLIBC__) || defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+    int sign=0;
+    return lgamma_r(x, &sign);
+#else
+    // no lgamma_r() available: serialize the calls, so signgam is not written concurrently
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    return lgamma(x);
+#endif
+}
+
 
 double JKMP::sinc(  double x )
 {
@@ -126,3 +142,881 @@ double JKMP::roundWithError(double value, double error, int addSignifcant)  {
     return round(value/f)*f;
 }
 
+
+/* ---------------------------------------------------------------------------------------------
+ * vectorized transcendental kernels
+ *
+ * The kernels are written once with GCC vector extensions on blocks of JKMP_VECMATH_WIDTH doubles
+ * and compiled as target clones for AVX-512F, AVX2 and the x86 baseline (SSE2). The dynamic loader
+ * picks the best clone for the CPU at startup. Lanes outside the fast-path domain of a kernel (NaN,
+ * inf, huge or denormal arguments, ...) are recomputed with the libm function, so the special-case
+ * semantics of the vector functions equal those of libm. The polynomials are the ones from fdlibm
+ * (exp, log, sin, cos) and Cephes (tanh). No FMA contraction is used, so all clones return bit-identical
+ * results.
+ * ------------------------------------------------------------------------------------------- */
+#if defined(__x86_64__) && defined(__ELF__) && !defined(JKMATHPARSER_NO_SIMD) && ((defined(__clang__) && __clang_major__>=14) || (!defined(__clang__) && defined(__GNUC__) && __GNUC__>=6))
+#  define JKMP_VECMATH_SIMD
+#  define JKMP_VECMATH_WIDTH 8
+#endif
+
+#if defined(JKMP_VECMATH_SIMD)
+#include <emmintrin.h>
+
+// the kernel helpers below are always inlined, so the ABI for returning wide vectors does not matter
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace {
+    typedef double jkmpVecD __attribute__((vector_size(JKMP_VECMATH_WIDTH*sizeof(double))));
+    typedef long long jkmpVecL __attribute__((vector_size(JKMP_VECMATH_WIDTH*sizeof(long long))));
+
+    #define JKMP_VECMATH_INLINE static inline __attribute__((always_inline))
+    #define JKMP_VECMATH_CLONES __attribute__((target_clones("avx512f","avx2","default")))
+
+    /* 1.5*2^52: adding and subtracting it rounds to the nearest integer, the low mantissa bits of the sum hold this integer */
+    const double vmRoundMagic=6755399441055744.0;
+
+    JKMP_VECMATH_INLINE jkmpVecD vmSplat(double v) { return jkmpVecD{}+v; }
+    JKMP_VECMATH_INLINE jkmpVecL vmSplatL(long long v) { return jkmpVecL{}+v; }
+    JKMP_VECMATH_INLINE jkmpVecL vmBits(const jkmpVecD& v) { return (jkmpVecL)v; }
+    JKMP_VECMATH_INLINE jkmpVecD vmDouble(const jkmpVecL& v) { return (jkmpVecD)v; }
+    JKMP_VECMATH_INLINE jkmpVecD vmAbs(const jkmpVecD& v) { return vmDouble(vmBits(v)&vmSplatL(0x7fffffffffffffffLL)); }
+    JKMP_VECMATH_INLINE jkmpVecD vmSelect(const jkmpVecL& m, const jkmpVecD& a, const jkmpVecD& b) { return vmDouble((vmBits(a)&m)|(vmBits(b)&~m)); }
+    JKMP_VECMATH_INLINE bool vmAny(const jkmpVecL& m) {
+        long long a=0;
+        for (int l=0; l<JKMP_VECMATH_WIDTH; l++) a|=m[l];
+        return a!=0;
+    }
+    /* round to nearest integer, valid for |x|<2^51, returns the integer as double in \a nd and as int64 */
+    JKMP_VECMATH_INLINE jkmpVecL vmRound(const jkmpVecD& x, jkmpVecD& nd) {
+        const jkmpVecD t=x+vmSplat(vmRoundMagic);
+        nd=t-vmSplat(vmRoundMagic);
+        return vmBits(t)-vmBits(vmSplat(vmRoundMagic));
+    }
+    /* int64 -> double for |n|<2^51 */
+    JKMP_VECMATH_INLINE jkmpVecD vmToDouble(const jkmpVecL& n) {
+        return vmDouble(n+vmBits(vmSplat(vmRoundMagic)))-vmSplat(vmRoundMagic);
+    }
+
+    /* exp(hi-lo) for |hi-lo|<=ln(2)/2 from the fdlibm rational approximation, the argument has to be reduced already */
+    JKMP_VECMATH_INLINE jkmpVecD vmExpReduced(const jkmpVecD& hi, const jkmpVecD& lo) {
+        const jkmpVecD r=hi-lo;
+        const jkmpVecD t=r*r;
+        const jkmpVecD c=r-t*(1.66666666666666019037e-01+t*(-2.77777777770155933842e-03+t*(6.61375632143793436117e-05+t*(-1.65339022054652515390e-06+t*4.13813679705723846039e-08))));
+        return 1.0-((lo-(r*c)/(2.0-c))-hi);
+    }
+
+    /* fast path of exp(x) for |x|<=708, \a bad marks lanes outside this domain */
+    JKMP_VECMATH_INLINE jkmpVecD vmExp(const jkmpVecD& xin, jkmpVecL& bad) {
+        bad=~(vmAbs(xin)<=708.0);
+        const jkmpVecD x=vmSelect(bad, vmSplat(0.0), xin);
+        jkmpVecD nd;
+        const jkmpVecL n=vmRound(x*1.44269504088896338700e+00, nd);
+        return vmExpReduced(x-nd*6.93147180369123816490e-01, nd*1.90821492927058770002e-10)*vmDouble((n+vmSplatL(1023))<<52);
+    }
+
+    /* fast path of log(x) for DBL_MIN<=x<=DBL_MAX */
+    JKMP_VECMATH_INLINE jkmpVecD vmLog(const jkmpVecD& xin, jkmpVecL& bad) {
+        bad=~((xin>=DBL_MIN)&(xin<=DBL_MAX));
+        const jkmpVecD x=vmSelect(bad, vmSplat(1.0), xin);
+        // x=m*2^k with sqrt(2)/2<=m<sqrt(2)
+        const jkmpVecL ix=vmBits(x)+vmSplatL(0x3ff0000000000000LL-0x3fe6a09e667f3bcdLL);
+        const jkmpVecD k=vmToDouble((ix>>52)-vmSplatL(1023));
+        const jkmpVecD f=vmDouble((ix&vmSplatL(0x000fffffffffffffLL))+vmSplatL(0x3fe6a09e667f3bcdLL))-1.0;
+        const jkmpVecD s=f/(2.0+f);
+        const jkmpVecD z=s*s;
+        const jkmpVecD w=z*z;
+        const jkmpVecD t1=w*(3.999999999940941908e-01+w*(2.222219843214978396e-01+w*1.531383769920937332e-01));
+        const jkmpVecD t2=z*(6.666666666666735130e-01+w*(2.857142874366239149e-01+w*(1.818357216161805012e-01+w*1.479819860511658591e-01)));
+        const jkmpVecD R=t2+t1;
+        const jkmpVecD hfsq=0.5*f*f;
+        return k*6.93147180369123816490e-01-((hfsq-(s*(hfsq+R)+k*1.90821492927058770002e-10))-f);
+    }
+
+    /* fast path of sin(x) (\a quadrantOffset==0) or cos(x) (\a quadrantOffset==1) for |x|<=10^6 */
+    JKMP_VECMATH_INLINE jkmpVecD vmSinCos(const jkmpVecD& xin, long long quadrantOffset, jkmpVecL& bad) {
+        bad=~(vmAbs(xin)<=1.0e6);
+        const jkmpVecD x=vmSelect(bad, vmSplat(0.0), xin);
+        // Cody-Waite reduction with pi/2 split into three 33-bit parts and a tail, all products n*pio2_i are exact for |n|<2^20.
+        // The reduced argument is kept as r+y, where y collects the rounding error of the first subtraction (TwoSum) and the tail terms.
+        jkmpVecD nd;
+        const jkmpVecL n=vmRound(x*6.36619772367581382433e-01, nd)+vmSplatL(quadrantOffset);
+        const jkmpVecD a=x-nd*1.57079632673412561417e+00;
+        const jkmpVecD b=nd*6.07710050630396597660e-11;
+        const jkmpVecD r1=a-b;
+        const jkmpVecD bb=a-r1;
+        const jkmpVecD tail=(((a-(r1+bb))-(b-bb))-nd*2.02226624871116645580e-21)-nd*8.47842766036889956997e-32;
+        const jkmpVecD r=r1+tail;
+        const jkmpVecD y=tail-(r-r1);
+        const jkmpVecD z=r*r;
+        // kernel sin on [-pi/4,pi/4]
+        const jkmpVecD v=z*r;
+        const jkmpVecD sr=8.33333333332248946124e-03+z*(-1.98412698298579493134e-04+z*(2.75573137070700676789e-06+z*(-2.50507602534068634195e-08+z*1.58969099521155010221e-10)));
+        const jkmpVecD s=r-((z*(0.5*y-v*sr)-y)-v*-1.66666666666666324348e-01);
+        // kernel cos on [-pi/4,pi/4]
+        const jkmpVecD cr=z*(4.16666666666666019037e-02+z*(-1.38888888888741095749e-03+z*(2.48015872894767294178e-05+z*(-2.75573143513906633035e-07+z*(2.08757232129817482790e-09+z*-1.13596475577881948265e-11)))));
+        const jkmpVecD hz=0.5*z;
+        const jkmpVecD w=1.0-hz;
+        const jkmpVecD c=w+(((1.0-w)-hz)+(z*cr-r*y));
+        // quadrant n&3: sin, cos, -sin, -cos
+        const jkmpVecD res=vmSelect(((n&vmSplatL(1))!=0), c, s);
+        return vmDouble(vmBits(res)^((n&vmSplatL(2))<<62));
+    }
+
+    /* fast path of tanh(x) for finite x */
+    JKMP_VECMATH_INLINE jkmpVecD vmTanh(const jkmpVecD& xin, jkmpVecL& bad) {
+        bad=~(vmAbs(xin)<=DBL_MAX);
+        const jkmpVecD x=vmSelect(bad, vmSplat(0.0), xin);
+        const jkmpVecD xa=vmAbs(x);
+        // |x|<0.625: Cephes rational approximation
+        const jkmpVecD s=x*x;
+        const jkmpVecD small=x+x*s*((-9.64399179425052238628e-01*s-9.92877231001918586564e+01)*s-1.61468768441708447952e+03)/(((s+1.12811678491632931402e+02)*s+2.23548839060100448583e+03)*s+4.84406305325125486048e+03);
+        // |x|>=0.625: 1-2/(exp(2|x|)+1), saturates to 1 for |x|>=20
+        jkmpVecL dummy;
+        const jkmpVecD e=vmExp(2.0*vmSelect(xa<20.0, xa, vmSplat(20.0)), dummy);
+        const jkmpVecD large=vmDouble(vmBits(1.0-2.0/(e+1.0))|(vmBits(x)&vmSplatL(0x8000000000000000LL)));
+        return vmSelect(xa<0.625, small, large);
+    }
+
+    #define JKMP_VECMATH_DEFINE_KERNEL(NAME, KERNELCALL, LIBMFUNC, PADVALUE) \
+    JKMP_VECMATH_CLONES void NAME(double* out, const double* in, size_t n) { \
+        size_t i=0; \
+        for (; i+JKMP_VECMATH_WIDTH<=n; i+=JKMP_VECMATH_WIDTH) { \
+            jkmpVecD x; \
+            __builtin_memcpy(&x, in+i, sizeof(x)); \
+            jkmpVecL bad; \
+            const jkmpVecD y=KERNELCALL; \
+            __builtin_memcpy(out+i, &y, sizeof(y)); \
+            if (vmAny(bad)) { \
+                for (int l=0; l<JKMP_VECMATH_WIDTH; l++) { \
+                    if (bad[l]) out[i+l]=LIBMFUNC(in[i+l]); \
+                } \
+            } \
+        } \
+        if (i<n) { \
+            double buf[JKMP_VECMATH_WIDTH]; \
+            for (int l=0; l<JKMP_VECMATH_WIDTH; l++) buf[l]=(i+l<n)?in[i+l]:PADVALUE; \
+            jkmpVecD x; \
+            __builtin_memcpy(&x, buf, sizeof(x)); \
+            jkmpVecL bad; \
+            const jkmpVecD y=KERNELCALL; \
+            __builtin_memcpy(buf, &y, sizeof(y)); \
+            for (size_t l=0; i+l<n; l++) { \
+                out[i+l]=bad[l]?LIBMFUNC(in[i+l]):buf[l]; \
+            } \
+        } \
+    }
+
+    JKMP_VECMATH_DEFINE_KERNEL(vmApplyExp, vmExp(x, bad), exp, 0.0)
+    JKMP_VECMATH_DEFINE_KERNEL(vmApplyLog, vmLog(x, bad), log, 1.0)
+    JKMP_VECMATH_DEFINE_KERNEL(vmApplySin, vmSinCos(x, 0, bad), sin, 0.0)
+    JKMP_VECMATH_DEFINE_KERNEL(vmApplyCos, vmSinCos(x, 1, bad), cos, 0.0)
+    JKMP_VECMATH_DEFINE_KERNEL(vmApplyTanh, vmTanh(x, bad), tanh, 0.0)
+
+    #undef JKMP_VECMATH_DEFINE_KERNEL
+}
+
+void JKMP::vecExp(double *out, const double *in, size_t n) { vmApplyExp(out, in, n); }
+void JKMP::vecLog(double *out, const double *in, size_t n) { vmApplyLog(out, in, n); }
+void JKMP::vecSin(double *out, const double *in, size_t n) { vmApplySin(out, in, n); }
+void JKMP::vecCos(double *out, const double *in, size_t n) { vmApplyCos(out, in, n); }
+void JKMP::vecTanh(double *out, const double *in, size_t n) { vmApplyTanh(out, in, n); }
+
+void JKMP::vecSqrt(double *out, const double *in, size_t n) {
+    size_t i=0;
+    for (; i+2<=n; i+=2) {
+        _mm_storeu_pd(out+i, _mm_sqrt_pd(_mm_loadu_pd(in+i)));
+    }
+    for (; i<n; i++) out[i]=sqrt(in[i]);
+}
+
+const char* JKMP::vecMathISA() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return "avx512f";
+    if (__builtin_cpu_supports("avx2")) return "avx2";
+    return "sse2";
+}
+
+#else
+
+void JKMP::vecExp(double *out, const double *in, size_t n) { for (size_t i=0; i<n; i++) out[i]=exp(in[i]); }
+void JKMP::vecLog(double *out, const double *in, size_t n) { for (size_t i=0; i<n; i++) out[i]=log(in[i]); }
+void JKMP::vecSin(double *out, const double *in, size_t n) { for (size_t i=0; i<n; i++) out[i]=sin(in[i]); }
+void JKMP::vecCos(double *out, const double *in, size_t n) { for (size_t i=0; i<n; i++) out[i]=cos(in[i]); }
+void JKMP::vecTanh(double *out, const double *in, size_t n) { for (size_t i=0; i<n; i++) out[i]=tanh(in[i]); }
+void JKMP::vecSqrt(double *out, const double *in, size_t n) { for (size_t i=0; i<n; i++) out[i]=sqrt(in[i]); }
+
+const char* JKMP::vecMathISA() {
+    return "scalar";
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------
+ * numerically stable reductions
+ *
+ * Each block of JKMP_REDUCE_BLOCK items is summed with 8 independent accumulators (item i goes to
+ * lane i%8), which GCC/clang map onto SSE2/AVX registers. The lanes are combined in a fixed order,
+ * so the result does not depend on the instruction set. Kahan summation uses the branch-free TwoSum
+ * of Knuth, so it vectorizes as well. Non-finite items (NAN, +/-INF) of the data are skipped, like in
+ * the StatisticsTools functions.
+ * ------------------------------------------------------------------------------------------- */
+namespace {
+    /** \brief pairwise summation ends at pieces of this many items (16 per lane), which are summed directly */
+    const size_t rdPairwiseBase=128;
+
+    inline double rdCombineLanes(const double* acc) {
+        return ((acc[0]+acc[1])+(acc[2]+acc[3]))+((acc[4]+acc[5])+(acc[6]+acc[7]));
+    }
+
+    /** \brief the summand for the item \a x : \a x or its square, or \c 0 if \a SKIP is set and \a x is not finite */
+    template <bool SQUARES, bool SKIP>
+    inline double rdItem(double x) {
+        if (SKIP && !JKMP_FloatIsOK(x)) return 0.0;
+        return (SQUARES?x*x:x);
+    }
+
+    /** \brief number of finite items in \a data */
+    size_t rdCountFinite(const double* data, size_t n) {
+        size_t cnt=0;
+        for (size_t i=0; i<n; i++) {
+            if (JKMP_FloatIsOK(data[i])) cnt++;
+        }
+        return cnt;
+    }
+
+    template <bool SQUARES, bool SKIP>
+    double rdPairwise(const double* data, size_t n) {
+        if (n<=rdPairwiseBase) {
+            double acc[8]={0,0,0,0,0,0,0,0};
+            size_t i=0;
+            for (; i+8<=n; i+=8) {
+                for (int l=0; l<8; l++) acc[l]+=rdItem<SQUARES,SKIP>(data[i+l]);
+            }
+            double r=rdCombineLanes(acc);
+            for (; i<n; i++) r+=rdItem<SQUARES,SKIP>(data[i]);
+            return r;
+        }
+        const size_t half=(n/2+7)/8*8;
+        return rdPairwise<SQUARES,SKIP>(data, half)+rdPairwise<SQUARES,SKIP>(data+half, n-half);
+    }
+
+    /** \brief adds \a x to the sum \a s with the error-free transformation TwoSum, the rounding error is added to \a c */
+    inline void rdTwoSum(double& s, double& c, double x) {
+        const double t=s+x;
+        const double z=t-s;
+        c+=(s-(t-z))+(x-z);
+        s=t;
+    }
+
+    template <bool SQUARES, bool SKIP>
+    double rdKahan(const double* data, size_t n, double* compensation) {
+        double s[8]={0,0,0,0,0,0,0,0};
+        double c[8]={0,0,0,0,0,0,0,0};
+        size_t i=0;
+        for (; i+8<=n; i+=8) {
+            for (int l=0; l<8; l++) rdTwoSum(s[l], c[l], rdItem<SQUARES,SKIP>(data[i+l]));
+        }
+        double rs=0, rc=0;
+        for (int l=0; l<8; l++) {
+            rdTwoSum(rs, rc, s[l]);
+            rc+=c[l];
+        }
+        for (; i<n; i++) rdTwoSum(rs, rc, rdItem<SQUARES,SKIP>(data[i]));
+        *compensation=rc;
+        return rs;
+    }
+
+    /** \brief sums the powers 1..ORDER of the deviations of the finite items in \a data from \a center into \a sums[1..ORDER] */
+    template <int ORDER>
+    void rdCentralSums(const double* data, size_t n, double center, double* sums) {
+        double acc[ORDER+1][8];
+        for (int p=0; p<=ORDER; p++) {
+            for (int l=0; l<8; l++) acc[p][l]=0;
+        }
+        size_t i=0;
+        for (; i+8<=n; i+=8) {
+            for (int l=0; l<8; l++) {
+                const double t=(JKMP_FloatIsOK(data[i+l])?data[i+l]-center:0.0);
+                double q=t;
+                acc[1][l]+=q;
+                for (int p=2; p<=ORDER; p++) {
+                    q*=t;
+                    acc[p][l]+=q;
+                }
+            }
+        }
+        for (int p=1; p<=ORDER; p++) sums[p]=rdCombineLanes(acc[p]);
+        for (; i<n; i++) {
+            const double t=(JKMP_FloatIsOK(data[i])?data[i]-center:0.0);
+            double q=t;
+            sums[1]+=q;
+            for (int p=2; p<=ORDER; p++) {
+                q*=t;
+                sums[p]+=q;
+            }
+        }
+    }
+
+    JKMP::CentralSums rdCentralSumsPartials(const JKMP::CentralSums* partials, size_t n) {
+        if (n==1) return partials[0];
+        JKMP::CentralSums r=rdCentralSumsPartials(partials, n/2);
+        r.merge(rdCentralSumsPartials(partials+n/2, n-n/2));
+        return r;
+    }
+}
+
+double JKMP::reduceSumBlock(const double *data, size_t n, bool kahan, bool squares, double *compensation, size_t *count) {
+    // the block is in the cache after it was summed, so counting its finite items is cheap
+    if (count) *count=rdCountFinite(data, n);
+    if (kahan) {
+        if (squares) return rdKahan<true,true>(data, n, compensation);
+        return rdKahan<false,true>(data, n, compensation);
+    }
+    *compensation=0;
+    if (squares) return rdPairwise<true,true>(data, n);
+    return rdPairwise<false,true>(data, n);
+}
+
+double JKMP::reduceSumPartials(const double *sums, const double *compensations, size_t n, bool kahan) {
+    if (n==0) return 0;
+    if (n==1) return sums[0]+compensations[0];
+    // the partial sums are not skipped: a block sum may overflow to INF
+    double c=0, cc=0;
+    double s=0, sc=0;
+    if (kahan) {
+        s=rdKahan<false,false>(sums, n, &c);
+        sc=rdKahan<false,false>(compensations, n, &cc);
+    } else {
+        s=rdPairwise<false,false>(sums, n);
+        sc=rdPairwise<false,false>(compensations, n);
+    }
+    return s+(c+sc+cc);
+}
+
+double JKMP::reduceSum(const double *data, size_t n, bool kahan, bool squares, size_t *count) {
+    double c=0;
+    if (n<=JKMP_REDUCE_BLOCK) return reduceSumBlock(data, n, kahan, squares, &c, count)+c;
+    const size_t blocks=(n+JKMP_REDUCE_BLOCK-1)/JKMP_REDUCE_BLOCK;
+    std::vector<double> sums(blocks), compensations(blocks);
+    std::vector<size_t> counts(blocks, 0);
+    for (size_t b=0; b<blocks; b++) {
+        sums[b]=reduceSumBlock(data+b*JKMP_REDUCE_BLOCK, std::min<size_t>(JKMP_REDUCE_BLOCK, n-b*JKMP_REDUCE_BLOCK), kahan, squares, &(compensations[b]), count?(&(counts[b])):NULL);
+    }
+    if (count) {
+        *count=0;
+        for (size_t b=0; b<blocks; b++) *count+=counts[b];
+    }
+    return reduceSumPartials(sums.data(), compensations.data(), blocks, kahan);
+}
+
+JKMP::CentralSums::CentralSums(int order):
+    order(order), center(0)
+{
+    for (int p=0; p<=JKMP_CENTRALSUMS_MAXORDER; p++) sums[p]=0;
+}
+
+double JKMP::CentralSums::centralSum(int p) const {
+    if (p==0) return sums[0];
+    CentralSums c=*this;
+    c.setCenter(mean());
+    return c.sums[p];
+}
+
+void JKMP::CentralSums::setCenter(double newCenter) {
+    const double delta=center-newCenter;
+    if (delta!=0) {
+        // sum((x-newCenter)^p) = sum_k binomial(p,k)*delta^(p-k)*sum((x-center)^k)
+        double old[JKMP_CENTRALSUMS_MAXORDER+1];
+        for (int p=0; p<=order; p++) old[p]=sums[p];
+        double binom[JKMP_CENTRALSUMS_MAXORDER+1];
+        binom[0]=1;
+        for (int p=1; p<=order; p++) {
+            binom[p]=1;
+            for (int k=p-1; k>0; k--) binom[k]+=binom[k-1];
+            double s=0, dp=1;
+            for (int k=p; k>=0; k--) {
+                s+=binom[k]*dp*old[k];
+                dp*=delta;
+            }
+            sums[p]=s;
+        }
+    }
+    center=newCenter;
+}
+
+void JKMP::CentralSums::merge(const JKMP::CentralSums &other) {
+    if (other.sums[0]<=0) return;
+    if (sums[0]<=0) {
+        *this=other;
+        return;
+    }
+    const double ma=mean();
+    const double mb=other.mean();
+    const double c=ma+(mb-ma)*(other.sums[0]/(sums[0]+other.sums[0]));
+    CentralSums o=other;
+    o.setCenter(c);
+    setCenter(c);
+    for (int p=0; p<=order; p++) sums[p]+=o.sums[p];
+}
+
+JKMP::CentralSums JKMP::reduceCentralSumsBlock(const double *data, size_t n, int order) {
+    CentralSums r(std::max(1, std::min(order, JKMP_CENTRALSUMS_MAXORDER)));
+    const size_t cnt=rdCountFinite(data, n);
+    if (cnt==0) return r;
+    // the block is in the cache after its mean was computed, so this is a single pass over the memory
+    r.center=rdPairwise<false,true>(data, n)/double(cnt);
+    r.sums[0]=double(cnt);
+    switch (r.order) {
+        case 1: rdCentralSums<1>(data, n, r.center, r.sums); break;
+        case 2: rdCentralSums<2>(data, n, r.center, r.sums); break;
+        case 3: rdCentralSums<3>(data, n, r.center, r.sums); break;
+        case 4: rdCentralSums<4>(data, n, r.center, r.sums); break;
+        case 5: rdCentralSums<5>(data, n, r.center, r.sums); break;
+        case 6: rdCentralSums<6>(data, n, r.center, r.sums); break;
+        case 7: rdCentralSums<7>(data, n, r.center, r.sums); break;
+        default: rdCentralSums<JKMP_CENTRALSUMS_MAXORDER>(data, n, r.center, r.sums); break;
+    }
+    return r;
+}
+
+JKMP::CentralSums JKMP::reduceCentralSumsPartials(const JKMP::CentralSums *partials, size_t n) {
+    if (n==0) return CentralSums();
+    return rdCentralSumsPartials(partials, n);
+}
+
+JKMP::CentralSums JKMP::reduceCentralSums(const double *data, size_t n, int order) {
+    if (n<=JKMP_REDUCE_BLOCK) return reduceCentralSumsBlock(data, n, order);
+    const size_t blocks=(n+JKMP_REDUCE_BLOCK-1)/JKMP_REDUCE_BLOCK;
+    std::vector<CentralSums> partials(blocks);
+    for (size_t b=0; b<blocks; b++) {
+        partials[b]=reduceCentralSumsBlock(data+b*JKMP_REDUCE_BLOCK, std::min<size_t>(JKMP_REDUCE_BLOCK, n-b*JKMP_REDUCE_BLOCK), order);
+    }
+    return reduceCentralSumsPartials(partials.data(), blocks);
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * selection-based medians and quantiles
+ * ------------------------------------------------------------------------------------------- */
+namespace {
+    /** \brief index of the quantile \a q of \a n sorted items */
+    inline size_t slQuantileIndex(size_t n, double q) {
+        const double j=ceil(q*double(n));
+        if (!(j>0)) return 0;
+        if (j>=double(n)) return n-1;
+        return size_t(j);
+    }
+
+    /** \brief partitions \a data (\a n items) so that the items with the sorted, unique indices \a idx (\a nidx of them) are at their sorted positions
+     *
+     *  The middle index is selected first, then the indices below and above it are selected in the two parts of the data on each side of it.
+     */
+    void slSelectIndices(double* data, size_t n, const size_t* idx, size_t nidx, size_t offset) {
+        if (nidx==0) return;
+        const size_t mid=nidx/2;
+        const size_t k=idx[mid]-offset;
+        std::nth_element(data, data+k, data+n);
+        slSelectIndices(data, k, idx, mid, offset);
+        slSelectIndices(data+k+1, n-k-1, idx+mid+1, nidx-mid-1, offset+k+1);
+    }
+
+    /** \brief copies the finite items of \a data (\a n items), the order statistics of NAN are undefined for \c std::nth_element() */
+    std::vector<double> slCopyFinite(const double* data, size_t n) {
+        std::vector<double> d;
+        d.reserve(n);
+        for (size_t i=0; i<n; i++) {
+            if (JKMP_FloatIsOK(data[i])) d.push_back(data[i]);
+        }
+        return d;
+    }
+
+    /** \brief median of \a n items, \a data is reordered */
+    double slMedianInPlace(double* data, size_t n) {
+        if (n==0) return NAN;
+        const size_t h=n/2;
+        std::nth_element(data, data+h, data+n);
+        if (n%2==1) return data[h];
+        // all items below h are <=data[h], so the other middle item is their maximum
+        return (*std::max_element(data, data+h)+data[h])/2.0;
+    }
+}
+
+double JKMP::selectMedian(const double *data, size_t n) {
+    std::vector<double> d=slCopyFinite(data, n);
+    return slMedianInPlace(d.data(), d.size());
+}
+
+double JKMP::selectQuantile(const double *data, size_t n, double q) {
+    if (std::isnan(q)) return NAN;
+    std::vector<double> d=slCopyFinite(data, n);
+    if (d.size()==0) return NAN;
+    const size_t j=slQuantileIndex(d.size(), q);
+    std::nth_element(d.begin(), d.begin()+j, d.end());
+    return d[j];
+}
+
+void JKMP::selectQuantiles(const double *data, size_t n, const double *q, size_t nq, double *out) {
+    std::vector<double> d=slCopyFinite(data, n);
+    const size_t nd=d.size();
+    if (nd==0) {
+        for (size_t i=0; i<nq; i++) out[i]=NAN;
+        return;
+    }
+    std::vector<size_t> idx;
+    idx.reserve(nq);
+    for (size_t i=0; i<nq; i++) {
+        if (!std::isnan(q[i])) idx.push_back(slQuantileIndex(nd, q[i]));
+    }
+    std::sort(idx.begin(), idx.end());
+    idx.erase(std::unique(idx.begin(), idx.end()), idx.end());
+    slSelectIndices(d.data(), nd, idx.data(), idx.size(), 0);
+    for (size_t i=0; i<nq; i++) {
+        out[i]=std::isnan(q[i])?NAN:d[slQuantileIndex(nd, q[i])];
+    }
+}
+
+double JKMP::selectMAD(const double *data, size_t n) {
+    std::vector<double> d=slCopyFinite(data, n);
+    const size_t nd=d.size();
+    if (nd==0) return NAN;
+    const double m=slMedianInPlace(d.data(), nd);
+    for (size_t i=0; i<nd; i++) d[i]=fabs(d[i]-m);
+    return slMedianInPlace(d.data(), nd);
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * group-by aggregation
+ * ------------------------------------------------------------------------------------------- */
+void JKMP::groupAggregate(const double *data, const size_t *group, size_t n, size_t groups, JKMP::GroupAggregate aggregate, double *out) {
+    // non-finite items are skipped, as in the StatisticsTools functions
+    switch (aggregate) {
+        case GroupCount:
+            std::fill(out, out+groups, 0.0);
+            for (size_t i=0; i<n; i++) {
+                if (JKMP_FloatIsOK(data[i])) out[group[i]]+=1.0;
+            }
+            break;
+        case GroupSum:
+        case GroupMean: {
+            std::fill(out, out+groups, 0.0);
+            std::vector<size_t> count(groups, 0);
+            for (size_t i=0; i<n; i++) {
+                if (JKMP_FloatIsOK(data[i])) {
+                    out[group[i]]+=data[i];
+                    count[group[i]]++;
+                }
+            }
+            if (aggregate==GroupMean) {
+                for (size_t g=0; g<groups; g++) out[g]=(count[g]>0)?(out[g]/double(count[g])):0.0;
+            }
+        } break;
+        case GroupSum2:
+            std::fill(out, out+groups, 0.0);
+            for (size_t i=0; i<n; i++) {
+                if (JKMP_FloatIsOK(data[i])) out[group[i]]+=data[i]*data[i];
+            }
+            break;
+        case GroupProd:
+            std::fill(out, out+groups, 1.0);
+            for (size_t i=0; i<n; i++) {
+                if (JKMP_FloatIsOK(data[i])) out[group[i]]*=data[i];
+            }
+            break;
+        case GroupMin:
+        case GroupMax: {
+            // groups without finite items are NAN
+            std::vector<bool> seen(groups, false);
+            std::fill(out, out+groups, NAN);
+            for (size_t i=0; i<n; i++) {
+                if (!JKMP_FloatIsOK(data[i])) continue;
+                const size_t g=group[i];
+                if (!seen[g] || (aggregate==GroupMin && data[i]<out[g]) || (aggregate==GroupMax && data[i]>out[g])) out[g]=data[i];
+                seen[g]=true;
+            }
+        } break;
+        case GroupVar:
+        case GroupStd:
+        case GroupSkewness: {
+            // Welford's update of mean, M2=sum((x-mean)^2) and M3=sum((x-mean)^3) for every item
+            const bool skew=(aggregate==GroupSkewness);
+            std::vector<double> count(groups, 0.0), mean(groups, 0.0), m2(groups, 0.0), m3(skew?groups:0, 0.0);
+            for (size_t i=0; i<n; i++) {
+                if (!JKMP_FloatIsOK(data[i])) continue;
+                const size_t g=group[i];
+                const double c=count[g]+1.0;
+                const double delta=data[i]-mean[g];
+                const double deltaN=delta/c;
+                const double term=delta*deltaN*(c-1.0);
+                if (skew) m3[g]+=term*deltaN*(c-2.0)-3.0*deltaN*m2[g];
+                m2[g]+=term;
+                mean[g]+=deltaN;
+                count[g]=c;
+            }
+            for (size_t g=0; g<groups; g++) {
+                if (count[g]<=1.0) out[g]=0;
+                else if (skew) out[g]=(m3[g]/count[g])/pow(m2[g]/count[g], 1.5);
+                else if (aggregate==GroupVar) out[g]=m2[g]/(count[g]-1.0);
+                else out[g]=sqrt(m2[g]/(count[g]-1.0));
+            }
+        } break;
+    }
+}
+
+void JKMP::groupPartition(const double *data, const size_t *group, size_t n, size_t groups, double *sorted, size_t *start) {
+    std::fill(start, start+groups+1, 0);
+    for (size_t i=0; i<n; i++) start[group[i]+1]++;
+    for (size_t g=0; g<groups; g++) start[g+1]+=start[g];
+    std::vector<size_t> pos(start, start+groups);
+    for (size_t i=0; i<n; i++) {
+        sorted[pos[group[i]]++]=data[i];
+    }
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * dense matrix kernels
+ *
+ * mmBlock() computes a block of C += alpha*A*B, where B has at most JKMP_MATRIX_BLOCK_K rows and
+ * JKMP_MATRIX_BLOCK_M columns. Each 4x8 tile of C is accumulated in registers over the whole block:
+ * one row of 8 items of B is loaded and multiplied with 4 items of A, so the tile needs 8 loads
+ * per 32 multiply-adds. Every item of C sums its products in the same order (row by row of B, then
+ * block by block), whether it is computed in a tile or in the remainder loops, so the result does not
+ * depend on how the rows are split over threads.
+ * ------------------------------------------------------------------------------------------- */
+namespace {
+#if defined(JKMP_VECMATH_SIMD)
+    typedef double mmVec4 __attribute__((vector_size(4*sizeof(double))));
+
+    JKMP_VECMATH_INLINE mmVec4 mmLoad(const double* p) {
+        mmVec4 v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    JKMP_VECMATH_CLONES
+#endif
+    void mmBlock(size_t n, size_t kb, size_t mb, double alpha, const double* A, size_t lda, const double* B, size_t ldb, double* C, size_t ldc) {
+        size_t i=0;
+        for (; i+4<=n; i+=4) {
+            const double* a0=A+i*lda;
+            const double* a1=a0+lda;
+            const double* a2=a1+lda;
+            const double* a3=a2+lda;
+            size_t j=0;
+            for (; j+8<=mb; j+=8) {
+#if defined(JKMP_VECMATH_SIMD)
+                mmVec4 c00={0,0,0,0}, c01=c00, c10=c00, c11=c00, c20=c00, c21=c00, c30=c00, c31=c00;
+                for (size_t x=0; x<kb; x++) {
+                    const double* b=B+x*ldb+j;
+                    const mmVec4 b0=mmLoad(b), b1=mmLoad(b+4);
+                    const double v0=a0[x], v1=a1[x], v2=a2[x], v3=a3[x];
+                    c00+=v0*b0; c01+=v0*b1;
+                    c10+=v1*b0; c11+=v1*b1;
+                    c20+=v2*b0; c21+=v2*b1;
+                    c30+=v3*b0; c31+=v3*b1;
+                }
+                const mmVec4 acc[4][2]={{c00,c01},{c10,c11},{c20,c21},{c30,c31}};
+                for (int r=0; r<4; r++) {
+                    double* c=C+(i+r)*ldc+j;
+                    for (int l=0; l<4; l++) {
+                        c[l]+=alpha*acc[r][0][l];
+                        c[l+4]+=alpha*acc[r][1][l];
+                    }
+                }
+#else
+                double acc[4][8]={{0,0,0,0,0,0,0,0},{0,0,0,0,0,0,0,0},{0,0,0,0,0,0,0,0},{0,0,0,0,0,0,0,0}};
+                for (size_t x=0; x<kb; x++) {
+                    const double* b=B+x*ldb+j;
+                    const double v0=a0[x], v1=a1[x], v2=a2[x], v3=a3[x];
+                    for (int l=0; l<8; l++) {
+                        acc[0][l]+=v0*b[l];
+                        acc[1][l]+=v1*b[l];
+                        acc[2][l]+=v2*b[l];
+                        acc[3][l]+=v3*b[l];
+                    }
+                }
+                for (int r=0; r<4; r++) {
+                    double* c=C+(i+r)*ldc+j;
+                    for (int l=0; l<8; l++) c[l]+=alpha*acc[r][l];
+                }
+#endif
+            }
+            for (; j<mb; j++) {
+                double s0=0, s1=0, s2=0, s3=0;
+                for (size_t x=0; x<kb; x++) {
+                    const double b=B[x*ldb+j];
+                    s0+=a0[x]*b;
+                    s1+=a1[x]*b;
+                    s2+=a2[x]*b;
+                    s3+=a3[x]*b;
+                }
+                C[i*ldc+j]+=alpha*s0;
+                C[(i+1)*ldc+j]+=alpha*s1;
+                C[(i+2)*ldc+j]+=alpha*s2;
+                C[(i+3)*ldc+j]+=alpha*s3;
+            }
+        }
+        for (; i<n; i++) {
+            const double* a=A+i*lda;
+            double* c=C+i*ldc;
+            size_t j=0;
+            for (; j+8<=mb; j+=8) {
+                double acc[8]={0,0,0,0,0,0,0,0};
+                for (size_t x=0; x<kb; x++) {
+                    const double* b=B+x*ldb+j;
+                    const double v=a[x];
+                    for (int l=0; l<8; l++) acc[l]+=v*b[l];
+                }
+                for (int l=0; l<8; l++) c[j+l]+=alpha*acc[l];
+            }
+            for (; j<mb; j++) {
+                double s=0;
+                for (size_t x=0; x<kb; x++) s+=a[x]*B[x*ldb+j];
+                c[j]+=alpha*s;
+            }
+        }
+    }
+
+    /** \brief computes the rows <code>[start,end)</code> of C += alpha*A*B block by block */
+    void mmRows(size_t start, size_t end, size_t k, size_t m, double alpha, const double* A, size_t lda, const double* B, size_t ldb, double* C, size_t ldc) {
+        for (size_t jj=0; jj<m; jj+=JKMP_MATRIX_BLOCK_M) {
+            const size_t mb=std::min<size_t>(JKMP_MATRIX_BLOCK_M, m-jj);
+            for (size_t kk=0; kk<k; kk+=JKMP_MATRIX_BLOCK_K) {
+                const size_t kb=std::min<size_t>(JKMP_MATRIX_BLOCK_K, k-kk);
+                mmBlock(end-start, kb, mb, alpha, A+start*lda+kk, lda, B+kk*ldb+jj, ldb, C+start*ldc+jj, ldc);
+            }
+        }
+    }
+}
+
+void JKMP::matrixMultiplyAdd(size_t n, size_t k, size_t m, double alpha, const double *A, size_t lda, const double *B, size_t ldb, double *C, size_t ldc, JKMP::threadPool *pool) {
+    if (n==0 || m==0 || k==0) return;
+    if (pool && n>JKMP_MATRIX_BLOCK_ROWS) {
+        pool->parallelFor(int64_t(n), JKMP_MATRIX_BLOCK_ROWS, [&](int64_t start, int64_t end, int) {
+            mmRows(size_t(start), size_t(end), k, m, alpha, A, lda, B, ldb, C, ldc);
+        });
+    } else {
+        mmRows(0, n, k, m, alpha, A, lda, B, ldb, C, ldc);
+    }
+}
+
+void JKMP::matrixMultiply(const double *A, const double *B, double *C, size_t n, size_t k, size_t m, JKMP::threadPool *pool) {
+    std::fill(C, C+n*m, 0.0);
+    matrixMultiplyAdd(n, k, m, 1.0, A, k, B, m, C, m, pool);
+}
+
+void JKMP::matrixTranspose(const double *A, double *T, size_t rows, size_t cols) {
+    // tiles of 32x32 items, so both the rows of A and of T are read/written in cache lines
+    const size_t tile=32;
+    for (size_t ii=0; ii<rows; ii+=tile) {
+        const size_t ie=std::min(ii+tile, rows);
+        for (size_t jj=0; jj<cols; jj+=tile) {
+            const size_t je=std::min(jj+tile, cols);
+            for (size_t i=ii; i<ie; i++) {
+                for (size_t j=jj; j<je; j++) {
+                    T[j*rows+i]=A[i*cols+j];
+                }
+            }
+        }
+    }
+}
+
+int JKMP::matrixLU(double *A, size_t n, size_t *perm, JKMP::threadPool *pool) {
+    int sign=1;
+    bool singular=false;
+    for (size_t i=0; i<n; i++) perm[i]=i;
+    for (size_t kb=0; kb<n; kb+=JKMP_MATRIX_BLOCK_ROWS) {
+        const size_t kend=std::min<size_t>(kb+JKMP_MATRIX_BLOCK_ROWS, n);
+        // factorize the panel of columns [kb,kend), the row swaps are applied to whole rows
+        for (size_t j=kb; j<kend; j++) {
+            // a NaN is taken as pivot (and ends the search), so it propagates into the results instead of making the matrix singular
+            size_t piv=j;
+            double pmax=fabs(A[j*n+j]);
+            for (size_t i=j+1; i<n && !std::isnan(pmax); i++) {
+                const double v=fabs(A[i*n+j]);
+                if (v>pmax || std::isnan(v)) {
+                    pmax=v;
+                    piv=i;
+                }
+            }
+            if (pmax==0.0) {
+                singular=true;
+                continue;
+            }
+            if (piv!=j) {
+                std::swap_ranges(A+j*n, A+(j+1)*n, A+piv*n);
+                std::swap(perm[j], perm[piv]);
+                sign=-sign;
+            }
+            const double* rowj=A+j*n;
+            const double d=rowj[j];
+            for (size_t i=j+1; i<n; i++) {
+                double* rowi=A+i*n;
+                const double l=rowi[j]/d;
+                rowi[j]=l;
+                for (size_t c=j+1; c<kend; c++) rowi[c]-=l*rowj[c];
+            }
+        }
+        if (kend<n) {
+            // U12 = L11^-1 * A12
+            for (size_t j=kb; j<kend; j++) {
+                const double* rowj=A+j*n;
+                for (size_t i=j+1; i<kend; i++) {
+                    double* rowi=A+i*n;
+                    const double l=rowi[j];
+                    for (size_t c=kend; c<n; c++) rowi[c]-=l*rowj[c];
+                }
+            }
+            // A22 -= L21 * U12
+            matrixMultiplyAdd(n-kend, kend-kb, n-kend, -1.0, A+kend*n+kb, n, A+kb*n+kend, n, A+kend*n+kend, n, pool);
+        }
+    }
+    return singular?0:sign;
+}
+
+void JKMP::matrixLUSolve(const double *LU, const size_t *perm, size_t n, const double *B, double *X, size_t r, JKMP::threadPool *pool) {
+    if (X==B) {
+        std::vector<double> b(B, B+n*r);
+        matrixLUSolve(LU, perm, n, b.data(), X, r, pool);
+        return;
+    }
+    for (size_t i=0; i<n; i++) {
+        std::copy(B+perm[i]*r, B+(perm[i]+1)*r, X+i*r);
+    }
+    const size_t nb=JKMP_MATRIX_BLOCK_ROWS;
+    // forward substitution with L (unit diagonal), block rows [ib,ie)
+    for (size_t ib=0; ib<n; ib+=nb) {
+        const size_t ie=std::min(ib+nb, n);
+        if (ib>0) matrixMultiplyAdd(ie-ib, ib, r, -1.0, LU+ib*n, n, X, r, X+ib*r, r, pool);
+        for (size_t i=ib; i<ie; i++) {
+            double* xi=X+i*r;
+            for (size_t j=ib; j<i; j++) {
+                const double l=LU[i*n+j];
+                const double* xj=X+j*r;
+                for (size_t c=0; c<r; c++) xi[c]-=l*xj[c];
+            }
+        }
+    }
+    // back substitution with U
+    for (size_t ie=n; ie>0; ) {
+        const size_t ib=(ie>nb)?(ie-nb):0;
+        if (ie<n) matrixMultiplyAdd(ie-ib, n-ie, r, -1.0, LU+ib*n+ie, n, X+ie*r, r, X+ib*r, r, pool);
+        for (size_t i=ie; i>ib; ) {
+            i--;
+            double* xi=X+i*r;
+            for (size_t j=i+1; j<ie; j++) {
+                const double u=LU[i*n+j];
+                const double* xj=X+j*r;
+                for (size_t c=0; c<r; c++) xi[c]-=u*xj[c];
+            }
+            const double d=LU[i*n+i];
+            for (size_t c=0; c<r; c++) xi[c]/=d;
+        }
+        ie=ib;
+    }
+}
+
+double JKMP::matrixLUDeterminant(const double *LU, size_t n, int sign) {
+    if (sign==0) return 0.0;
+    double det=double(sign);
+    for (size_t i=0; i<n; i++) det*=LU[i*n+i];
+    return det;
+}
@@ -74,6 +74,8 @@
 
 namespace JKMP {
 
+    class threadPool;
+
     /*! \brief squares the argument
         \ingroup tools_math_stat
      */
@@ -110,6 +112,11 @@ namespace JKMP {
         \ingroup tools_math_stat
     */
     JKMPLIB_EXPORT double tanc( double x);
+    /** \brief natural logarithm of the absolute value of the gamma function \f$ \ln|\Gamma(x)| \f$, like \c ::lgamma() , but reentrant
+               (\c ::lgamma() writes the sign of \f$ \Gamma(x) \f$ to the global variable \c signgam )
+        \ingroup tools_math_stat
+    */
+    JKMPLIB_EXPORT double logGamma( double x);
 
     /** \brief 1/sqrt(e)-width gaussian function \f$ \mbox{g}(x, \sigma)=\exp\left(-\frac{1}{2}\cdot\frac{x^2}{\sigma^2}\right) \f$ with \f$ g(\sigma,\sigma)=1/\sqrt{e} \f$
         \ingroup tools_math_stat
@@ -596,6 +603,228 @@ namespace JKMP {
         return roundError(error, int(addSignifcant));
     }
 
+    /*! \defgroup tools_math_vecmath vectorized math kernels
+        \ingroup tools_math_stat
+
+        These functions apply a transcendental function item-wise to an array of \a n doubles (\a out may equal \a in).
+        On x86-64 with GCC/clang they are implemented with SIMD polynomial kernels, compiled for AVX-512F, AVX2 and SSE2 and
+        selected at runtime for the CPU at hand (see vecMathISA() ). Everywhere else (or if \c JKMATHPARSER_NO_SIMD is defined)
+        they simply call the libm function for each item.
+
+        Arguments outside the fast-path domain given in the documentation of each function (NaN, inf, denormals, ...) are
+        forwarded to libm, so the special-case results equal those of libm. Inside the domain, the error bound is given in
+        ULP (units in the last place) with respect to the correctly rounded result; it was measured against an extended
+        precision reference over 10^7 random arguments. All ISA variants return bit-identical results.
+     */
+    /*@{*/
+
+    /*! \brief item-wise \c exp(x), fast path for |x|<=708, max. error 1 ULP */
+    JKMPLIB_EXPORT void vecExp(double* out, const double* in, size_t n);
+    /*! \brief item-wise \c log(x), fast path for normal positive x, max. error 1 ULP */
+    JKMPLIB_EXPORT void vecLog(double* out, const double* in, size_t n);
+    /*! \brief item-wise \c sin(x), fast path for |x|<=10^6, max. error 1 ULP */
+    JKMPLIB_EXPORT void vecSin(double* out, const double* in, size_t n);
+    /*! \brief item-wise \c cos(x), fast path for |x|<=10^6, max. error 1 ULP */
+    JKMPLIB_EXPORT void vecCos(double* out, const double* in, size_t n);
+    /*! \brief item-wise \c tanh(x), fast path for finite x, max. error 2 ULP */
+    JKMPLIB_EXPORT void vecTanh(double* out, const double* in, size_t n);
+    /*! \brief item-wise \c sqrt(x), correctly rounded (SSE2 \c sqrtpd ) */
+    JKMPLIB_EXPORT void vecSqrt(double* out, const double* in, size_t n);
+    /*! \brief name of the instruction set used by the vectorized kernels on this CPU (\c "avx512f", \c "avx2", \c "sse2" or \c "scalar" ) */
+    JKMPLIB_EXPORT const char* vecMathISA();
+
+    /*@}*/
+
+    /*! \defgroup tools_math_reduce numerically stable reductions
+        \ingroup tools_math_stat
+
+        These functions compute sums and central moments of arrays of doubles. The data is processed in blocks of
+        JKMP_REDUCE_BLOCK items (which stay in the cache), each with 8 independent accumulators that the compiler maps onto
+        SIMD registers. The partial results of the blocks are then combined pairwise. So the result only depends on the data,
+        not on the CPU, and a caller may compute the blocks in parallel (see jkmpReduceSum() ) without changing the result.
+        Non-finite items (\c NAN , \c +/-INF ) are skipped, i.e. they are neither summed nor counted.
+     */
+    /*@{*/
+
+/** \brief number of items per block of the reductions in \ref tools_math_reduce */
+#define JKMP_REDUCE_BLOCK 4096
+/** \brief maximum order of the sums in JKMP::CentralSums */
+#define JKMP_CENTRALSUMS_MAXORDER 8
+
+    /*! \brief returns the sum of the finite items among the \a n items in \a data (or of their squares, if \a squares is \c true )
+
+        The items are summed pairwise (\a kahan \c ==false ), so the rounding error grows with \c log(n) , or with
+        compensated (Kahan) summation, whose rounding error does not grow with \a n , but which takes about twice as long.
+        If \a count is not \c NULL , the number of finite items is stored there.
+     */
+    JKMPLIB_EXPORT double reduceSum(const double* data, size_t n, bool kahan=false, bool squares=false, size_t* count=NULL);
+    /*! \brief sums one block of \a n items, see reduceSum(). The result is split into the sum and its \a compensation (which is \c 0 for pairwise summation) */
+    JKMPLIB_EXPORT double reduceSumBlock(const double* data, size_t n, bool kahan, bool squares, double* compensation, size_t* count=NULL);
+    /*! \brief combines the sums and \a compensations of \a n blocks, as returned by reduceSumBlock() (non-finite sums are not skipped here) */
+    JKMPLIB_EXPORT double reduceSumPartials(const double* sums, const double* compensations, size_t n, bool kahan);
+
+    /*! \brief number of items, center and sums of the powers of the deviations from the center of a sample
+
+        Two CentralSums are combined with merge(), which is the pairwise update of Chan et al. (generalized to higher
+        orders by P. Pebay), so all central moments up to order are computed in a single, numerically stable pass.
+     */
+    struct JKMPLIB_EXPORT CentralSums {
+        CentralSums(int order=2);
+        /** \brief highest power in sums */
+        int order;
+        /** \brief the deviations are taken from this point (usually the mean of the items) */
+        double center;
+        /** \brief <code>sums[p]</code> is the sum over all (finite) items of <code>(x-center)^p</code>, so \c sums[0] is the number of items */
+        double sums[JKMP_CENTRALSUMS_MAXORDER+1];
+
+        /** \brief number of items */
+        inline double count() const { return sums[0]; }
+        /** \brief mean of the items */
+        inline double mean() const { return center+sums[1]/sums[0]; }
+        /** \brief returns <code>sum((x-mean)^p)</code> , \c p<=order */
+        double centralSum(int p) const;
+        /** \brief returns the central moment <code>sum((x-mean)^p)/count</code> , \c p<=order */
+        inline double centralMoment(int p) const { return centralSum(p)/sums[0]; }
+        /** \brief moves the center to \a newCenter (the sums are recomputed with the binomial theorem) */
+        void setCenter(double newCenter);
+        /** \brief adds the items of \a other (with the same order) */
+        void merge(const CentralSums& other);
+    };
+
+    /*! \brief returns the CentralSums up to \a order (<=JKMP_CENTRALSUMS_MAXORDER) of the \a n items in \a data */
+    JKMPLIB_EXPORT CentralSums reduceCentralSums(const double* data, size_t n, int order);
+    /*! \brief returns the CentralSums of one block, centered at its mean, see reduceCentralSums() */
+    JKMPLIB_EXPORT CentralSums reduceCentralSumsBlock(const double* data, size_t n, int order);
+    /*! \brief combines the CentralSums of \a n blocks pairwise, as returned by reduceCentralSumsBlock() */
+    JKMPLIB_EXPORT CentralSums reduceCentralSumsPartials(const CentralSums* partials, size_t n);
+
+    /*@}*/
+
+    /*! \defgroup tools_math_select selection-based medians and quantiles
+        \ingroup tools_math_stat
+
+        These functions find the required items of the sorted data with \c std::nth_element() (introselect, \c O(n) on average)
+        on a copy of the data, instead of sorting it completely. The quantile of the probability \c q of \a n items is the item
+        with the index \c ceil(q*n) (clipped to <code>[0,n-1]</code>) of the sorted data. The median is the middle item,
+        or the mean of the two middle items for an even \a n . Non-finite items (\c NAN , \c +/-INF ) are dropped while copying,
+        so \a n is the number of finite items. All functions return \c NAN if no finite item is left.
+     */
+    /*@{*/
+
+    /*! \brief median of the \a n items in \a data */
+    JKMPLIB_EXPORT double selectMedian(const double* data, size_t n);
+    /*! \brief quantile of the probability \a q of the \a n items in \a data */
+    JKMPLIB_EXPORT double selectQuantile(const double* data, size_t n, double q);
+    /*! \brief quantiles of the \a nq probabilities \a q of the \a n items in \a data , written to \a out
+     *
+     *  The data is copied and partitioned only once for all probabilities, so this takes \c O(n*log(nq)) .
+     */
+    JKMPLIB_EXPORT void selectQuantiles(const double* data, size_t n, const double* q, size_t nq, double* out);
+    /*! \brief 25% quantile of the \a n items in \a data */
+    inline double selectQuantile25(const double* data, size_t n) {
+        return selectQuantile(data, n, 0.25);
+    }
+    /*! \brief 75% quantile of the \a n items in \a data */
+    inline double selectQuantile75(const double* data, size_t n) {
+        return selectQuantile(data, n, 0.75);
+    }
+    /*! \brief median absolute deviation <code>median(abs(x-median(x)))</code> of the \a n items in \a data */
+    JKMPLIB_EXPORT double selectMAD(const double* data, size_t n);
+    /*! \brief normalized median absolute deviation <code>1.4826*selectMAD()</code>, which estimates the standard deviation of normally distributed data */
+    inline double selectNMAD(const double* data, size_t n) {
+        return 1.4826*selectMAD(data, n);
+    }
+
+    /*@}*/
+
+    /*! \defgroup tools_math_groupby group-by aggregation
+        \ingroup tools_math_stat
+
+        These functions aggregate the \a n items of \a data per group. The group of item \c i is given by the dense group id
+        <code>group[i]</code> in <code>[0,groups-1]</code>, e.g. as returned by JKMP::uniqueIndex() for a vector of arbitrary keys.
+        groupAggregate() computes streaming aggregates in a single pass over the data, without copying it. Other functions are
+        applied with groupApply(), which first sorts the items by group into one buffer (counting sort).
+     */
+    /*@{*/
+
+    /*! \brief aggregates that groupAggregate() computes in a single pass, non-finite items (\c NAN , \c +/-INF ) are skipped */
+    enum GroupAggregate {
+        GroupCount,    /*!< \brief number of (finite) items */
+        GroupSum,      /*!< \brief sum of the items */
+        GroupSum2,     /*!< \brief sum of the squares of the items */
+        GroupProd,     /*!< \brief product of the items */
+        GroupMin,      /*!< \brief minimum of the items (\c NAN for groups without finite items) */
+        GroupMax,      /*!< \brief maximum of the items (\c NAN for groups without finite items) */
+        GroupMean,     /*!< \brief mean of the items (\c 0 for groups without finite items) */
+        GroupVar,      /*!< \brief sample variance of the items (Welford's algorithm, \c 0 for groups with one item) */
+        GroupStd,      /*!< \brief sample standard deviation of the items */
+        GroupSkewness  /*!< \brief skewness <code>m3/m2^1.5</code> of the items (Welford's algorithm, extended to the third moment, \c 0 for groups with one item) */
+    };
+
+    /*! \brief computes the \a aggregate of every group and writes it to \a out (\a groups items) */
+    JKMPLIB_EXPORT void groupAggregate(const double* data, const size_t* group, size_t n, size_t groups, GroupAggregate aggregate, double* out);
+    /*! \brief copies the items of \a data to \a sorted , sorted by group (the order within a group is kept). The items of group \c g are then
+     *         <code>sorted[start[g]...start[g+1]-1]</code>, so \a start has \c groups+1 items */
+    JKMPLIB_EXPORT void groupPartition(const double* data, const size_t* group, size_t n, size_t groups, double* sorted, size_t* start);
+    /*! \brief writes <code>func(items, count)</code> for the items of every group to \a out (\a groups items), see groupPartition() */
+    template <typename TFUNC>
+    inline void groupApply(const double* data, const size_t* group, size_t n, size_t groups, TFUNC func, double* out) {
+        std::vector<double> sorted(n);
+        std::vector<size_t> start(groups+1);
+        groupPartition(data, group, n, groups, sorted.data(), start.data());
+        for (size_t g=0; g<groups; g++) {
+            out[g]=func(sorted.data()+start[g], start[g+1]-start[g]);
+        }
+    }
+
+    /*@}*/
+
+    /*! \defgroup tools_math_linalg dense matrix kernels
+        \ingroup tools_math_stat
+
+        These functions work on dense matrices of doubles, which are stored row by row (like the numbers of a
+        jkmpDoubleMatrix, where item <code>(i,j)</code> of a matrix with \c m columns is <code>data[i*m+j]</code>).
+        The row stride of a matrix may be larger than its number of columns (\a lda , \a ldb , ... , like in BLAS),
+        so the kernels also work on sub-matrices.
+
+        matrixMultiplyAdd() works on blocks of JKMP_MATRIX_BLOCK_K rows of \c B and JKMP_MATRIX_BLOCK_M columns,
+        which stay in the cache, and computes 4x8 items of \c C at once in registers (compiled for AVX-512F, AVX2
+        and SSE2 on x86-64 with GCC/clang, see vecMathISA() ). The LU decomposition is blocked as well, so most of
+        its work is done by matrixMultiplyAdd(). If a thread pool is given, the rows of \c C are split into chunks
+        of JKMP_MATRIX_BLOCK_ROWS rows, which are computed in parallel. The results do not depend on the number of threads.
+     */
+    /*@{*/
+
+/** \brief number of rows of \c B in a block of matrixMultiplyAdd() */
+#define JKMP_MATRIX_BLOCK_K 256
+/** \brief number of columns of \c B in a block of matrixMultiplyAdd() */
+#define JKMP_MATRIX_BLOCK_M 512
+/** \brief number of rows of a chunk that matrixMultiplyAdd() computes on one thread, and number of columns of a panel of matrixLU() */
+#define JKMP_MATRIX_BLOCK_ROWS 64
+
+    /*! \brief computes <code>C += alpha*A*B</code> for the \a n x \a k matrix \a A , the \a k x \a m matrix \a B and the \a n x \a m matrix \a C ,
+     *         whose rows are \a lda , \a ldb and \a ldc items apart. \a C must not overlap \a A or \a B . */
+    JKMPLIB_EXPORT void matrixMultiplyAdd(size_t n, size_t k, size_t m, double alpha, const double* A, size_t lda, const double* B, size_t ldb, double* C, size_t ldc, threadPool* pool=NULL);
+    /*! \brief computes the \a n x \a m matrix <code>C = A*B</code> of the \a n x \a k matrix \a A and the \a k x \a m matrix \a B (all without gaps between the rows) */
+    JKMPLIB_EXPORT void matrixMultiply(const double* A, const double* B, double* C, size_t n, size_t k, size_t m, threadPool* pool=NULL);
+    /*! \brief writes the transpose of the \a rows x \a cols matrix \a A to \a T (\a cols x \a rows , \a T must not overlap \a A ) */
+    JKMPLIB_EXPORT void matrixTranspose(const double* A, double* T, size_t rows, size_t cols);
+    /*! \brief LU decomposition with partial pivoting of the \a n x \a n matrix \a A , in place
+     *
+     *  Afterwards \a A holds \c U on and above the diagonal and \c L (without its unit diagonal) below, so that <code>L*U</code> is the
+     *  matrix \a A with its rows permuted: row \c i of <code>L*U</code> is row <code>perm[i]</code> of the original matrix (\a perm has \a n items).
+     *  Returns the sign (\c +1 or \c -1 ) of the permutation, or \c 0 , if the matrix is singular (a pivot was \c 0 ). Non-finite items
+     *  are not singular, they propagate into \a A (e.g. a NaN pivot makes the determinant NaN).
+     */
+    JKMPLIB_EXPORT int matrixLU(double* A, size_t n, size_t* perm, threadPool* pool=NULL);
+    /*! \brief solves <code>A*X = B</code> for the \a n x \a r matrix \a X , where \a LU and \a perm are the LU decomposition of \a A from matrixLU()
+     *         and \a B is a \a n x \a r matrix (\a X may equal \a B ) */
+    JKMPLIB_EXPORT void matrixLUSolve(const double* LU, const size_t* perm, size_t n, const double* B, double* X, size_t r, threadPool* pool=NULL);
+    /*! \brief determinant of a matrix from its LU decomposition \a LU and the \a sign returned by matrixLU() */
+    JKMPLIB_EXPORT double matrixLUDeterminant(const double* LU, size_t n, int sign);
+
+    /*@}*/
+
 
 }
 #endif // QFMATHTOOLS_H
@@ -0,0 +1,637 @@
+/*
+    Copyright (c) 2008-2016 Jan W. Krieger (<jan@jkrieger.de>)
+
+
+    This software is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License (LGPL) as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License (LGPL) for more details.
+
+    You should have received a copy of the GNU Lesser General Public License (LGPL)
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "jkmpregexptools.h"
+#include <algorithm>
+#include <limits>
+
+struct JKMP::regExpAutomaton::Node {
+    enum Type {
+        Set,     /*!< \brief one byte of \c set */
+        Concat,  /*!< \brief the \c children one after the other */
+        Alt,     /*!< \brief one of the \c children */
+        Repeat,  /*!< \brief \c children[0] , \c min to \c max times ( \c max<0 : unbounded) */
+        Begin,   /*!< \brief start of the text */
+        End      /*!< \brief end of the text */
+    };
+    Node(Type type=Concat): type(type), min(0), max(0) {}
+    Type type;
+    std::bitset<256> set;
+    std::vector<Node> children;
+    int min;
+    int max;
+};
+
+namespace JKMP {
+
+    /** \brief recursive descent parser for the pattern subset of regExpAutomaton */
+    class regExpParser {
+        public:
+            regExpParser(const std::string& pattern, bool caseSensitive):
+                ok(true), p(pattern), pos(0), caseSensitive(caseSensitive), depth(0)
+            {
+            }
+
+            /** \brief parses the whole pattern, check ok afterwards */
+            regExpAutomaton::Node parse() {
+                regExpAutomaton::Node n=parseAlternatives();
+                if (pos<p.size()) ok=false;
+                return n;
+            }
+
+            bool ok;
+        protected:
+            typedef regExpAutomaton::Node Node;
+            const std::string& p;
+            size_t pos;
+            bool caseSensitive;
+            int depth;
+
+            inline bool atEnd() const { return pos>=p.size(); }
+            inline char peek() const { return p[pos]; }
+
+            /** \brief adds the other case of the ASCII letters in \a set , if the pattern ignores the case */
+            void foldCase(std::bitset<256>& set) const {
+                if (caseSensitive) return;
+                for (int c='a'; c<='z'; c++) {
+                    if (set[c] || set[c-'a'+'A']) {
+                        set[c]=true;
+                        set[c-'a'+'A']=true;
+                    }
+                }
+            }
+
+            static void addRange(std::bitset<256>& set, int lo, int hi) {
+                for (int c=lo; c<=hi; c++) set[c]=true;
+            }
+
+            /** \brief sets \a set to the class of \c \\d \c \\w \c \\s (or their negations), returns \c false for other letters */
+            static bool classEscape(char e, std::bitset<256>& set) {
+                set.reset();
+                switch (e) {
+                    case 'd': case 'D':
+                        addRange(set, '0', '9');
+                        break;
+                    case 'w': case 'W':
+                        addRange(set, '0', '9');
+                        addRange(set, 'a', 'z');
+                        addRange(set, 'A', 'Z');
+                        set['_']=true;
+                        break;
+                    case 's': case 'S':
+                        set[' ']=true;
+                        addRange(set, '\t', '\r');
+                        break;
+                    default:
+                        return false;
+                }
+                if (e=='D' || e=='W' || e=='S') set.flip();
+                return true;
+            }
+
+            static int hexDigit(char c) {
+                if (c>='0' && c<='9') return c-'0';
+                if (c>='a' && c<='f') return c-'a'+10;
+                if (c>='A' && c<='F') return c-'A'+10;
+                return -1;
+            }
+
+            /** \brief parses the escaped character after a backslash (not a class escape), returns \c -1 for unsupported escapes */
+            int characterEscape() {
+                if (atEnd()) return -1;
+                const char e=p[pos++];
+                switch (e) {
+                    case 't': return '\t';
+                    case 'n': return '\n';
+                    case 'r': return '\r';
+                    case 'f': return '\f';
+                    case 'v': return '\v';
+                    case '0':
+                        if (!atEnd() && peek()>='0' && peek()<='9') return -1;
+                        return 0;
+                    case 'x': {
+                        if (pos+2>p.size()) return -1;
+                        const int h=hexDigit(p[pos]), l=hexDigit(p[pos+1]);
+                        if (h<0 || l<0) return -1;
+                        pos+=2;
+                        return h*16+l;
+                    }
+                    default:
+                        break;
+                }
+                // identity escapes of characters that are not part of identifiers
+                const unsigned char u=static_cast<unsigned char>(e);
+                if (u<128 && !((e>='a' && e<='z') || (e>='A' && e<='Z') || (e>='0' && e<='9') || e=='_')) return u;
+                return -1;
+            }
+
+            Node parseAlternatives() {
+                Node alt(Node::Alt);
+                alt.children.push_back(parseSequence());
+                while (ok && !atEnd() && peek()=='|') {
+                    pos++;
+                    alt.children.push_back(parseSequence());
+                }
+                if (alt.children.size()==1) return alt.children[0];
+                return alt;
+            }
+
+            Node parseSequence() {
+                Node seq(Node::Concat);
+                while (ok && !atEnd() && peek()!='|' && peek()!=')') {
+                    Node atom=parseAtom();
+                    if (!ok) break;
+                    parseQuantifier(atom);
+                    if (!ok) break;
+                    seq.children.push_back(atom);
+                }
+                if (seq.children.size()==1) return seq.children[0];
+                return seq;
+            }
+
+            /** \brief parses a decimal number of at most 4 digits, returns \c -1 if there is none */
+            int parseNumber() {
+                int n=0, digits=0;
+                while (!atEnd() && peek()>='0' && peek()<='9' && digits<4) {
+                    n=n*10+(peek()-'0');
+                    pos++;
+                    digits++;
+                }
+                if (digits==0 || (!atEnd() && peek()>='0' && peek()<='9')) return -1;
+                return n;
+            }
+
+            void parseQuantifier(Node& atom) {
+                if (atEnd()) return;
+                int min=0, max=0;
+                const char c=peek();
+                if (c=='*') { min=0; max=-1; pos++; }
+                else if (c=='+') { min=1; max=-1; pos++; }
+                else if (c=='?') { min=0; max=1; pos++; }
+                else if (c=='{') {
+                    pos++;
+                    min=parseNumber();
+                    if (min<0 || atEnd()) { ok=false; return; }
+                    max=min;
+                    if (peek()==',') {
+                        pos++;
+                        if (atEnd()) { ok=false; return; }
+                        if (peek()=='}') max=-1;
+                        else {
+                            max=parseNumber();
+                            if (max<min) { ok=false; return; }
+                        }
+                    }
+                    if (atEnd() || peek()!='}') { ok=false; return; }
+                    pos++;
+                } else {
+                    return;
+                }
+                // anchors can not be repeated
+                if (atom.type==Node::Begin || atom.type==Node::End) { ok=false; return; }
+                // non-greedy quantifiers match the same texts
+                if (!atEnd() && peek()=='?') pos++;
+                if (!atEnd() && (peek()=='*' || peek()=='+' || peek()=='?' || peek()=='{')) { ok=false; return; }
+                Node rep(Node::Repeat);
+                rep.min=min;
+                rep.max=max;
+                rep.children.push_back(atom);
+                atom=rep;
+            }
+
+            Node parseAtom() {
+                Node n(Node::Set);
+                const char c=p[pos++];
+                switch (c) {
+                    case '(':
+                        if (depth>=200) { ok=false; return n; }
+                        if (!atEnd() && peek()=='?') {
+                            if (pos+1<p.size() && p[pos+1]==':') pos+=2;
+                            else { ok=false; return n; }
+                        }
+                        depth++;
+                        n=parseAlternatives();
+                        depth--;
+                        if (atEnd() || peek()!=')') { ok=false; return n; }
+                        pos++;
+                        return n;
+                    case '[':
+                        parseBracket(n.set);
+                        return n;
+                    case '.':
+                        n.set.set();
+                        n.set['\n']=false;
+                        n.set['\r']=false;
+                        return n;
+                    case '^':
+                        return Node(Node::Begin);
+                    case '$':
+                        return Node(Node::End);
+                    case '\\': {
+                        if (!atEnd() && classEscape(peek(), n.set)) {
+                            pos++;
+                            return n;
+                        }
+                        const int e=characterEscape();
+                        if (e<0) { ok=false; return n; }
+                        n.set[e]=true;
+                        foldCase(n.set);
+                        return n;
+                    }
+                    case '*': case '+': case '?': case '{': case '}': case ']': case ')':
+                        ok=false;
+                        return n;
+                    default:
+                        n.set[static_cast<unsigned char>(c)]=true;
+                        foldCase(n.set);
+                        return n;
+                }
+            }
+
+            /** \brief parses a single character of a bracket expression, returns \c -1 for unsupported characters */
+            int bracketCharacter() {
+                const char c=p[pos++];
+                if (c=='[') return -1;
+                if (c=='\\') {
+                    if (!atEnd() && peek()=='b') return -1;
+                    return characterEscape();
+                }
+                return static_cast<unsigned char>(c);
+            }
+
+            void parseBracket(std::bitset<256>& set) {
+                set.reset();
+                bool negate=false;
+                if (!atEnd() && peek()=='^') {
+                    negate=true;
+                    pos++;
+                }
+                if (atEnd() || peek()==']') { ok=false; return; }
+                while (ok && !atEnd() && peek()!=']') {
+                    std::bitset<256> cls;
+                    if (peek()=='\\' && pos+1<p.size() && classEscape(p[pos+1], cls)) {
+                        pos+=2;
+                        set|=cls;
+                        if (!atEnd() && peek()=='-' && pos+1<p.size() && p[pos+1]!=']') { ok=false; return; }
+                        continue;
+                    }
+                    const int lo=bracketCharacter();
+                    if (lo<0) { ok=false; return; }
+                    int hi=lo;
+                    if (!atEnd() && peek()=='-' && pos+1<p.size() && p[pos+1]!=']') {
+                        pos++;
+                        hi=bracketCharacter();
+                        if (hi<lo || hi>127) { ok=false; return; }
+                    }
+                    addRange(set, lo, hi);
+                }
+                if (atEnd()) { ok=false; return; }
+                pos++;
+                foldCase(set);
+                if (negate) set.flip();
+            }
+    };
+
+}
+
+JKMP::regExpAutomaton::regExpAutomaton()
+{
+    start=-1;
+    valid=false;
+    std::fill(byteClass, byteClass+256, 0);
+}
+
+bool JKMP::regExpAutomaton::compile(const std::string &pattern, bool caseSensitive)
+{
+    states.clear();
+    charSets.clear();
+    classRepresentative.clear();
+    start=-1;
+    valid=false;
+
+    regExpParser parser(pattern, caseSensitive);
+    const Node root=parser.parse();
+    if (!parser.ok) return false;
+    const int match=addState(StateMatch);
+    start=build(root, match);
+    if (start<0) {
+        states.clear();
+        charSets.clear();
+        return false;
+    }
+
+    // partition the bytes into classes, which all charSets treat the same
+    std::vector<int> cls(256, 0);
+    int classes=1;
+    for (size_t s=0; s<charSets.size(); s++) {
+        std::map<std::pair<int,bool>, int> split;
+        for (int b=0; b<256; b++) {
+            const std::pair<int,bool> key(cls[b], charSets[s][b]);
+            auto it=split.find(key);
+            if (it==split.end()) it=split.insert(std::make_pair(key, int(split.size()))).first;
+            cls[b]=it->second;
+        }
+        classes=int(split.size());
+    }
+    classRepresentative.assign(classes, 0);
+    std::vector<bool> seen(classes, false);
+    for (int b=0; b<256; b++) {
+        byteClass[b]=static_cast<uint8_t>(cls[b]);
+        if (!seen[cls[b]]) {
+            seen[cls[b]]=true;
+            classRepresentative[cls[b]]=static_cast<uint8_t>(b);
+        }
+    }
+    valid=true;
+    return true;
+}
+
+int JKMP::regExpAutomaton::addState(StateType type, int out, int out1, int charSet)
+{
+    State s;
+    s.type=type;
+    s.out=out;
+    s.out1=out1;
+    s.charSet=charSet;
+    states.push_back(s);
+    return int(states.size())-1;
+}
+
+int JKMP::regExpAutomaton::build(const Node &node, int next)
+{
+    if (next<0 || states.size()>JKMP_REGEXP_MAXSTATES) return -1;
+    switch (node.type) {
+        case Node::Set:
+            charSets.push_back(node.set);
+            return addState(StateChar, next, -1, int(charSets.size())-1);
+        case Node::Begin:
+            return addState(StateBegin, next);
+        case Node::End:
+            return addState(StateEnd, next);
+        case Node::Concat:
+            for (size_t i=node.children.size(); i>0; i--) {
+                next=build(node.children[i-1], next);
+                if (next<0) return -1;
+            }
+            return next;
+        case Node::Alt: {
+            int cur=build(node.children.back(), next);
+            for (size_t i=node.children.size()-1; i>0 && cur>=0; i--) {
+                const int e=build(node.children[i-1], next);
+                if (e<0) return -1;
+                cur=addState(StateSplit, e, cur);
+            }
+            return cur;
+        }
+        case Node::Repeat: {
+            const Node& child=node.children[0];
+            int cur=next;
+            if (node.max<0) {
+                const int loop=addState(StateSplit, -1, next);
+                const int e=build(child, loop);
+                if (e<0) return -1;
+                states[loop].out=e;
+                cur=loop;
+            } else {
+                for (int i=node.min; i<node.max; i++) {
+                    const int e=build(child, cur);
+                    if (e<0) return -1;
+                    cur=addState(StateSplit, e, next);
+                }
+            }
+            for (int i=0; i<node.min; i++) {
+                cur=build(child, cur);
+                if (cur<0) return -1;
+            }
+            return cur;
+        }
+    }
+    return -1;
+}
+
+
+
+JKMP::regExpMatcher::DFA::DFA()
+{
+    anchored=true;
+    initial=-1;
+    flushes=0;
+}
+
+JKMP::regExpMatcher::regExpMatcher(const JKMP::regExpAutomaton &automaton):
+    automaton(automaton)
+{
+    classCount=automaton.classRepresentative.size();
+    anchoredDFA.anchored=true;
+    searchDFA.anchored=false;
+    mark.assign(automaton.states.size(), 0);
+    markGeneration=0;
+    std::vector<int> start(1, automaton.start);
+    closure(searchRestart, start, false, false);
+}
+
+void JKMP::regExpMatcher::closure(std::vector<int> &result, const std::vector<int> &set, bool atBegin, bool atEnd)
+{
+    markGeneration++;
+    stack.clear();
+    for (size_t i=0; i<set.size(); i++) stack.push_back(set[i]);
+    while (!stack.empty()) {
+        const int s=stack.back();
+        stack.pop_back();
+        if (s<0 || mark[s]==markGeneration) continue;
+        mark[s]=markGeneration;
+        const regExpAutomaton::State& st=automaton.states[s];
+        switch (st.type) {
+            case regExpAutomaton::StateChar:
+            case regExpAutomaton::StateMatch:
+                result.push_back(s);
+                break;
+            case regExpAutomaton::StateSplit:
+                stack.push_back(st.out1);
+                stack.push_back(st.out);
+                break;
+            case regExpAutomaton::StateBegin:
+                if (atBegin) stack.push_back(st.out);
+                break;
+            case regExpAutomaton::StateEnd:
+                if (atEnd) stack.push_back(st.out);
+                else result.push_back(s);
+                break;
+        }
+    }
+}
+
+int JKMP::regExpMatcher::initialState(JKMP::regExpMatcher::DFA &dfa)
+{
+    if (dfa.initial<0) {
+        std::vector<int> set, start(1, automaton.start);
+        closure(set, start, true, false);
+        dfa.initial=addDFAState(dfa, set, true);
+    }
+    return dfa.initial;
+}
+
+int JKMP::regExpMatcher::addDFAState(JKMP::regExpMatcher::DFA &dfa, std::vector<int> &set, bool initial)
+{
+    std::sort(set.begin(), set.end());
+    set.erase(std::unique(set.begin(), set.end()), set.end());
+    std::vector<int> key;
+    key.reserve(set.size()+1);
+    if (initial) key.push_back(-1);
+    key.insert(key.end(), set.begin(), set.end());
+    auto it=dfa.index.find(key);
+    if (it!=dfa.index.end()) return it->second;
+
+    if (dfa.sets.size()>=JKMP_REGEXP_MAXDFASTATES) {
+        // the cache is full: start again with an empty one
+        dfa.sets.clear();
+        dfa.index.clear();
+        dfa.next.clear();
+        dfa.accepts.clear();
+        dfa.acceptsAtEnd.clear();
+        dfa.initial=-1;
+        dfa.flushes++;
+    }
+    const int id=int(dfa.sets.size());
+    bool accepts=false;
+    std::vector<int> ends;
+    for (size_t i=0; i<set.size(); i++) {
+        const regExpAutomaton::StateType t=automaton.states[set[i]].type;
+        if (t==regExpAutomaton::StateMatch) accepts=true;
+        else if (t==regExpAutomaton::StateEnd) ends.push_back(set[i]);
+    }
+    bool acceptsAtEnd=accepts;
+    if (!acceptsAtEnd && !ends.empty()) {
+        std::vector<int> atEnd;
+        closure(atEnd, ends, initial, true);
+        for (size_t i=0; i<atEnd.size(); i++) {
+            if (automaton.states[atEnd[i]].type==regExpAutomaton::StateMatch) acceptsAtEnd=true;
+        }
+    }
+    dfa.sets.push_back(set);
+    dfa.index[key]=id;
+    dfa.next.resize(dfa.next.size()+classCount, -1);
+    dfa.accepts.push_back(accepts?1:0);
+    dfa.acceptsAtEnd.push_back(acceptsAtEnd?1:0);
+    return id;
+}
+
+int JKMP::regExpMatcher::step(JKMP::regExpMatcher::DFA &dfa, int state, int cls)
+{
+    const int known=dfa.next[size_t(state)*classCount+cls];
+    if (known>=0) return known;
+
+    const uint8_t byte=automaton.classRepresentative[cls];
+    std::vector<int> moved, set;
+    const std::vector<int>& from=dfa.sets[state];
+    for (size_t i=0; i<from.size(); i++) {
+        const regExpAutomaton::State& st=automaton.states[from[i]];
+        if (st.type==regExpAutomaton::StateChar && automaton.charSets[st.charSet][byte]) moved.push_back(st.out);
+    }
+    closure(set, moved, false, false);
+    if (!dfa.anchored) set.insert(set.end(), searchRestart.begin(), searchRestart.end());
+    const uint64_t flushes=dfa.flushes;
+    const int id=addDFAState(dfa, set, false);
+    if (dfa.flushes==flushes) dfa.next[size_t(state)*classCount+cls]=id;
+    return id;
+}
+
+bool JKMP::regExpMatcher::run(JKMP::regExpMatcher::DFA &dfa, const char *text, size_t length)
+{
+    int s=initialState(dfa);
+    const bool search=!dfa.anchored;
+    if (search && dfa.accepts[s]) return true;
+    const unsigned char* t=reinterpret_cast<const unsigned char*>(text);
+    for (size_t i=0; i<length; i++) {
+        const size_t cls=automaton.byteClass[t[i]];
+        int n=dfa.next[size_t(s)*classCount+cls];
+        if (n<0) n=step(dfa, s, int(cls));
+        s=n;
+        if (dfa.sets[s].empty()) return false;
+        if (search && dfa.accepts[s]) return true;
+    }
+    return dfa.acceptsAtEnd[s]!=0;
+}
+
+bool JKMP::regExpMatcher::match(const char *text, size_t length)
+{
+    return run(anchoredDFA, text, length);
+}
+
+bool JKMP::regExpMatcher::search(const char *text, size_t length)
+{
+    return run(searchDFA, text, length);
+}
+
+void JKMP::regExpMatcher::addThread(std::vector<std::pair<int, int64_t> > &list, int state, int64_t start, bool atBegin, bool atEnd, int64_t &best)
+{
+    // threads are added in the order of their start, so the first thread that reaches a state has the leftmost start
+    stack.clear();
+    stack.push_back(state);
+    while (!stack.empty()) {
+        const int s=stack.back();
+        stack.pop_back();
+        if (s<0 || mark[s]==markGeneration) continue;
+        mark[s]=markGeneration;
+        const regExpAutomaton::State& st=automaton.states[s];
+        switch (st.type) {
+            case regExpAutomaton::StateChar:
+                list.push_back(std::make_pair(s, start));
+                break;
+            case regExpAutomaton::StateMatch:
+                best=std::min(best, start);
+                break;
+            case regExpAutomaton::StateSplit:
+                stack.push_back(st.out1);
+                stack.push_back(st.out);
+                break;
+            case regExpAutomaton::StateBegin:
+                if (atBegin) stack.push_back(st.out);
+                break;
+            case regExpAutomaton::StateEnd:
+                if (atEnd) stack.push_back(st.out);
+                break;
+        }
+    }
+}
+
+int64_t JKMP::regExpMatcher::searchPosition(const char *text, size_t length)
+{
+    // the DFA rejects texts without a match quickly, the start of the match is then found by simulating the NFA
+    if (!search(text, length)) return -1;
+    const int64_t none=std::numeric_limits<int64_t>::max();
+    int64_t best=none;
+    const unsigned char* t=reinterpret_cast<const unsigned char*>(text);
+    threads.clear();
+    markGeneration++;
+    for (size_t i=0; i<=length; i++) {
+        if (best==none) addThread(threads, automaton.start, int64_t(i), i==0, i==length, best);
+        if (i==length) break;
+        if (best!=none && (threads.empty() || threads.front().second>=best)) break;
+        nextThreads.clear();
+        markGeneration++;
+        for (size_t j=0; j<threads.size(); j++) {
+            const regExpAutomaton::State& st=automaton.states[threads[j].first];
+            if (threads[j].second<best && automaton.charSets[st.charSet][t[i]]) {
+                addThread(nextThreads, st.out, threads[j].second, false, i+1==length, best);
+            }
+        }
+        threads.swap(nextThreads);
+    }
+    return (best==none)?-1:best;
+}
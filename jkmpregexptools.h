@@ -0,0 +1,172 @@
+/*
+    Copyright (c) 2008-2016 Jan W. Krieger (<jan@jkrieger.de>)
+
+
+    This software is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License (LGPL) as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License (LGPL) for more details.
+
+    You should have received a copy of the GNU Lesser General Public License (LGPL)
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file jkmpregexptools.h
+ *  \ingroup jkmplib_mathtools_parser
+ */
+#ifndef JKMATHPARSERREGEXPTOOLS_H
+#define JKMATHPARSERREGEXPTOOLS_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <bitset>
+#include <map>
+#include "jkmplib_imexport.h"
+
+/** \brief maximum number of NFA states of a JKMP::regExpAutomaton (larger patterns, e.g. with large counted repetitions, are not compiled) */
+#ifndef JKMP_REGEXP_MAXSTATES
+#  define JKMP_REGEXP_MAXSTATES 4096
+#endif
+
+/** \brief maximum number of DFA states that a JKMP::regExpMatcher caches, before it starts again with an empty cache */
+#ifndef JKMP_REGEXP_MAXDFASTATES
+#  define JKMP_REGEXP_MAXDFASTATES 2048
+#endif
+
+namespace JKMP {
+
+    /** \brief a regular expression, compiled to a Thompson NFA, which is matched in linear time by a regExpMatcher
+     *
+     *  compile() accepts the subset of the ECMAScript syntax of std::regex that needs no backtracking:
+     *    - literals, \c . , escapes of special characters, \c \\t \c \\n \c \\r \c \\f \c \\v \c \\0 \c \\xHH
+     *    - the classes \c \\d \c \\D \c \\w \c \\W \c \\s \c \\S and bracket expressions like <code>[^a-z_\\d]</code>
+     *    - groups <code>(...)</code> and <code>(?:...)</code> , alternatives \c | , the quantifiers \c * \c + \c ? \c {n} \c {n,} \c {n,m} (also non-greedy)
+     *    - the anchors \c ^ and \c $
+     *
+     *  Patterns with other features (back references, lookahead, word boundaries, character class names, ...) or invalid patterns are
+     *  rejected, i.e. the caller has to fall back to std::regex. Like std::regex on \c char , the automaton works on bytes and
+     *  ignores the case of ASCII letters only.
+     */
+    class JKMPLIB_EXPORT regExpAutomaton {
+        public:
+            regExpAutomaton();
+            /** \brief compiles \a pattern, returns \c false (and isValid() is \c false ), if the pattern is invalid or not in the supported subset */
+            bool compile(const std::string& pattern, bool caseSensitive=true);
+            /** \brief indicates that the last compile() succeeded */
+            inline bool isValid() const { return valid; }
+            /** \brief number of states of the NFA */
+            inline size_t stateCount() const { return states.size(); }
+        protected:
+            friend class regExpMatcher;
+            friend class regExpParser;
+            /** \brief type of an NFA state */
+            enum StateType {
+                StateChar,   /*!< \brief consumes a byte of the set \c charSet and continues with \c out */
+                StateSplit,  /*!< \brief continues with \c out and \c out1 */
+                StateBegin,  /*!< \brief continues with \c out at the start of the text */
+                StateEnd,    /*!< \brief continues with \c out at the end of the text */
+                StateMatch   /*!< \brief the pattern matched */
+            };
+            struct State {
+                StateType type;
+                int out;
+                int out1;
+                int charSet;
+            };
+            /** \brief node of the syntax tree, see parse...() */
+            struct Node;
+            /** \brief the NFA */
+            std::vector<State> states;
+            /** \brief the byte sets of the StateChar states */
+            std::vector<std::bitset<256> > charSets;
+            /** \brief the initial state */
+            int start;
+            /** \brief bytes that are not distinguished by any of charSets have the same class */
+            uint8_t byteClass[256];
+            /** \brief a byte of every class */
+            std::vector<uint8_t> classRepresentative;
+            bool valid;
+
+            int addState(StateType type, int out=-1, int out1=-1, int charSet=-1);
+            /** \brief builds the NFA of \a node , which continues with \a next , returns the entry state or \c -1 , if there are too many states */
+            int build(const Node& node, int next);
+    };
+
+    /** \brief matches texts with a regExpAutomaton, using a lazily built DFA
+     *
+     *  The DFA states are built from the NFA on first use and cached (at most JKMP_REGEXP_MAXDFASTATES), so each byte of the text
+     *  usually costs one table lookup. A matcher is not thread-safe, but any number of matchers may share the same automaton.
+     */
+    class JKMPLIB_EXPORT regExpMatcher {
+        public:
+            /** \brief creates a matcher for \a automaton , which has to be valid and has to outlive the matcher */
+            explicit regExpMatcher(const regExpAutomaton& automaton);
+            /** \brief returns whether the whole \a text matches (like std::regex_match() ) */
+            bool match(const char* text, size_t length);
+            /** \brief returns whether a part of \a text matches (like std::regex_search() ) */
+            bool search(const char* text, size_t length);
+            /** \brief returns the position of the leftmost match in \a text (like \c position(0) after std::regex_search() ), or \c -1 */
+            int64_t searchPosition(const char* text, size_t length);
+
+            inline bool match(const std::string& text) { return match(text.data(), text.size()); }
+            inline bool search(const std::string& text) { return search(text.data(), text.size()); }
+            inline int64_t searchPosition(const std::string& text) { return searchPosition(text.data(), text.size()); }
+        protected:
+            /** \brief a lazily built DFA, either anchored (for match() ) or unanchored (for search() ) */
+            struct DFA {
+                DFA();
+                bool anchored;
+                /** \brief the initial state, \c -1 if not built yet */
+                int initial;
+                /** \brief number of times the cache was cleared, because it was full */
+                uint64_t flushes;
+                /** \brief the NFA states of each DFA state */
+                std::vector<std::vector<int> > sets;
+                /** \brief the DFA state of each set of NFA states (the initial state has the marker \c -1 in front) */
+                std::map<std::vector<int>, int> index;
+                /** \brief transitions, \c classCount per state, \c -1 if not built yet */
+                std::vector<int> next;
+                /** \brief indicates that a state contains the StateMatch */
+                std::vector<char> accepts;
+                /** \brief indicates that a state matches at the end of the text */
+                std::vector<char> acceptsAtEnd;
+            };
+            const regExpAutomaton& automaton;
+            size_t classCount;
+            DFA anchoredDFA;
+            DFA searchDFA;
+            /** \brief closure of the initial state at positions >0 , added in every step of searchDFA */
+            std::vector<int> searchRestart;
+            /** \brief scratch data of closure() and searchPosition() */
+            std::vector<uint64_t> mark;
+            uint64_t markGeneration;
+            std::vector<int> stack;
+            /** \brief threads (NFA state, start of the match) of searchPosition() */
+            std::vector<std::pair<int, int64_t> > threads;
+            std::vector<std::pair<int, int64_t> > nextThreads;
+
+            /** \brief adds the thread \a state that started at \a start (and the threads reachable from it without consuming a byte) to \a list ,
+             *         updates \a best , if a match is reached */
+            void addThread(std::vector<std::pair<int, int64_t> >& list, int state, int64_t start, bool atBegin, bool atEnd, int64_t& best);
+
+            /** \brief adds the states of \a set and all states reachable from them without consuming a byte to \a result */
+            void closure(std::vector<int>& result, const std::vector<int>& set, bool atBegin, bool atEnd);
+            /** \brief returns the initial state of \a dfa , builds it if necessary */
+            int initialState(DFA& dfa);
+            /** \brief returns the DFA state of the NFA states \a set , adds it if necessary */
+            int addDFAState(DFA& dfa, std::vector<int>& set, bool initial);
+            /** \brief returns the transition of DFA state \a state for the byte class \a cls , builds it if necessary */
+            int step(DFA& dfa, int state, int cls);
+            /** \brief runs \a dfa on \a text */
+            bool run(DFA& dfa, const char* text, size_t length);
+    };
+
+}
+
+#endif // JKMATHPARSERREGEXPTOOLS_H
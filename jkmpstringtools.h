@@ -299,5 +299,12 @@ inline std::ostream& operator <<(std::ostream& stream, const JKMP::stringVector&
     return stream;
 }
 
+namespace std {
+    /** \brief hash function of JKMP::string (the same as for std::string), e.g. for JKMP::uniqueIndex() */
+    template<>
+    struct hash<JKMP::string>: public hash<std::string> {
+    };
+}
+
 #endif // JKMATHPARSERSTRINGTOOLS_H
 
@@ -0,0 +1,172 @@
+/*
+    Copyright (c) 2008-2016 Jan W. Krieger (<jan@jkrieger.de>)
+
+
+    This software is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License (LGPL) as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License (LGPL) for more details.
+
+    You should have received a copy of the GNU Lesser General Public License (LGPL)
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "jkmpthreadtools.h"
+#include <algorithm>
+
+namespace {
+    /** \brief indicates that the current thread works on a chunk of a threadPool (nested parallelFor() calls run serially) */
+    thread_local bool jkmpThreadPool_inTask=false;
+}
+
+JKMP::threadPool::threadPool(int threads)
+{
+    jobGeneration=0;
+    activeWorkers=0;
+    stopping=false;
+    task=NULL;
+    count=0;
+    grainSize=1;
+    if (threads<=0) threads=idealThreadCount();
+    for (int i=0; i<threads; i++) {
+        queues.push_back(std::unique_ptr<ChunkQueue>(new ChunkQueue()));
+    }
+    for (int i=1; i<threads; i++) {
+        workers.push_back(std::thread(&threadPool::workerMain, this, i));
+    }
+}
+
+JKMP::threadPool::~threadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping=true;
+    }
+    wakeWorkers.notify_all();
+    for (size_t i=0; i<workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+int JKMP::threadPool::getThreadCount() const
+{
+    return int(queues.size());
+}
+
+int JKMP::threadPool::idealThreadCount()
+{
+    return std::max<int>(1, int(std::thread::hardware_concurrency()));
+}
+
+void JKMP::threadPool::parallelFor(int64_t count, int64_t grainSize, const std::function<void (int64_t, int64_t, int)> &task)
+{
+    if (count<=0) return;
+    if (grainSize<1) grainSize=1;
+    const int64_t chunks=(count+grainSize-1)/grainSize;
+    if (chunks<=1 || workers.empty() || jkmpThreadPool_inTask || !jobMutex.try_lock()) {
+        for (int64_t start=0; start<count; start+=grainSize) {
+            task(start, std::min(start+grainSize, count), 0);
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> jobLock(jobMutex, std::adopt_lock);
+
+    // distribute contiguous blocks of chunks over the queues
+    const int threads=getThreadCount();
+    for (int t=0; t<threads; t++) {
+        std::lock_guard<std::mutex> lock(queues[t]->mutex);
+        for (int64_t c=chunks*t/threads; c<chunks*(t+1)/threads; c++) {
+            queues[t]->chunks.push_back(c);
+        }
+    }
+    this->task=&task;
+    this->count=count;
+    this->grainSize=grainSize;
+    error=std::exception_ptr();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        jobGeneration++;
+        activeWorkers=int(workers.size());
+    }
+    wakeWorkers.notify_all();
+
+    jkmpThreadPool_inTask=true;
+    runChunks(0);
+    jkmpThreadPool_inTask=false;
+
+    // the job (and task) must stay alive, until all workers left runChunks()
+    {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        jobDone.wait(lock, [this]() { return activeWorkers==0; });
+    }
+    this->task=NULL;
+    if (error) std::rethrow_exception(error);
+}
+
+void JKMP::threadPool::workerMain(int thread)
+{
+    jkmpThreadPool_inTask=true;
+    uint64_t lastGeneration=0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wakeWorkers.wait(lock, [this, lastGeneration]() { return stopping || jobGeneration!=lastGeneration; });
+            if (stopping) return;
+            lastGeneration=jobGeneration;
+        }
+        runChunks(thread);
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            activeWorkers--;
+            if (activeWorkers==0) jobDone.notify_all();
+        }
+    }
+}
+
+void JKMP::threadPool::runChunks(int thread)
+{
+    int64_t chunk=0;
+    while (takeChunk(thread, chunk)) {
+        bool failed=false;
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            failed=(bool)error;
+        }
+        if (failed) continue;
+        const int64_t start=chunk*grainSize;
+        try {
+            (*task)(start, std::min(start+grainSize, count), thread);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error=std::current_exception();
+        }
+    }
+}
+
+bool JKMP::threadPool::takeChunk(int thread, int64_t &chunk)
+{
+    const int threads=getThreadCount();
+    {
+        std::lock_guard<std::mutex> lock(queues[thread]->mutex);
+        if (!queues[thread]->chunks.empty()) {
+            chunk=queues[thread]->chunks.front();
+            queues[thread]->chunks.pop_front();
+            return true;
+        }
+    }
+    for (int i=1; i<threads; i++) {
+        ChunkQueue& victim=*queues[(thread+i)%threads];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.chunks.empty()) {
+            chunk=victim.chunks.back();
+            victim.chunks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,101 @@
+/*
+    Copyright (c) 2008-2016 Jan W. Krieger (<jan@jkrieger.de>)
+
+
+    This software is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License (LGPL) as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License (LGPL) for more details.
+
+    You should have received a copy of the GNU Lesser General Public License (LGPL)
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file jkmpthreadtools.h
+ *  \ingroup jkmplib_mathtools_parser
+ */
+#ifndef JKMATHPARSERTHREADTOOLS_H
+#define JKMATHPARSERTHREADTOOLS_H
+
+#include <stdint.h>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include "jkmplib_imexport.h"
+
+namespace JKMP {
+
+    /** \brief a small work-stealing thread pool, used to evaluate independent iterations in parallel
+     *
+     *  parallelFor() splits the index range into chunks, which are distributed over one queue per thread. Each thread
+     *  takes chunks from the front of its own queue and, when that runs empty, steals chunks from the back of the queues
+     *  of the other threads. The calling thread takes part in the work.
+     *
+     *  Only one parallelFor() runs on a pool at a time. Calls from inside a running task, or from another thread while
+     *  the pool is busy, are executed serially on the calling thread.
+     */
+    class JKMPLIB_EXPORT threadPool {
+        public:
+            /** \brief creates a pool that works with \a threads threads (including the calling thread), \c threads<=0 uses idealThreadCount() */
+            explicit threadPool(int threads=0);
+            ~threadPool();
+
+            /** \brief number of threads that work on a parallelFor(), including the calling thread */
+            int getThreadCount() const;
+
+            /** \brief calls \a task(start, end, thread) for all chunks <code>[start,end)</code> of at most \a grainSize indices that cover <code>[0,count)</code> and waits until all of them are done
+             *
+             *  The chunks always start at multiples of \a grainSize, independent of the number of threads. \a thread is the index
+             *  (<code>0..getThreadCount()-1</code>) of the thread that runs the chunk, so it may be used to select per-thread scratch data.
+             *  The first exception thrown by \a task is rethrown in the calling thread (the remaining chunks are skipped).
+             */
+            void parallelFor(int64_t count, int64_t grainSize, const std::function<void(int64_t, int64_t, int)>& task);
+
+            /** \brief number of hardware threads (at least 1) */
+            static int idealThreadCount();
+        private:
+            /** \brief chunk queue of one thread */
+            struct ChunkQueue {
+                std::mutex mutex;
+                std::deque<int64_t> chunks;
+            };
+
+            void workerMain(int thread);
+            /** \brief works on the chunks of the current job, until all queues are empty */
+            void runChunks(int thread);
+            /** \brief takes a chunk from the own queue, or steals one from the other queues */
+            bool takeChunk(int thread, int64_t& chunk);
+
+            std::vector<std::thread> workers;
+            std::vector<std::unique_ptr<ChunkQueue> > queues;
+            /** \brief serializes the calls of parallelFor() */
+            std::mutex jobMutex;
+            /** \brief protects jobGeneration, activeWorkers and stopping */
+            std::mutex stateMutex;
+            std::condition_variable wakeWorkers;
+            std::condition_variable jobDone;
+            uint64_t jobGeneration;
+            int activeWorkers;
+            bool stopping;
+
+            /** \brief the current job */
+            const std::function<void(int64_t, int64_t, int)>* task;
+            int64_t count;
+            int64_t grainSize;
+            std::mutex errorMutex;
+            std::exception_ptr error;
+    };
+
+}
+
+#endif // JKMATHPARSERTHREADTOOLS_H
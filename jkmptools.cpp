@@ -18,6 +18,7 @@
 
 #include "jkmptools.h"
 #include "jkmathparser.h"
+#include "jkmpmathtools.h"
 #include <typeinfo>
 
 
@@ -88,6 +89,9 @@ jkmpResult &jkmpResult::operator=(const jkmpResult &value)
 
 void jkmpResult::set(const jkmpResult &value)
 {
+    if (&value==this) return;
+    // value may be an item of this list (e.g. res=res.listData[0]): keep the items alive until value is copied (this copy is cheap, as the items are shared)
+    const JKMP::sharedvector<jkmpResult> oldListData(listData);
     setInvalid();
     isValid=value.isValid;
     type=value.type;
@@ -418,6 +422,14 @@ void jkmpResult::setList(const std::vector<jkmpResult> &dat)
     listData=dat;
 }
 
+void jkmpResult::setList(const JKMP::sharedvector<jkmpResult> &dat)
+{
+    setInvalid();
+    isValid=true;
+    type=jkmpList;
+    listData=dat;
+}
+
 void jkmpResult::setBoolVec(const std::vector<bool> &val)
 {
     setInvalid();
@@ -476,7 +488,7 @@ std::vector<double> jkmpResult::asVector() const
     else if (type==jkmpList) {
         bool ok=true;
         std::vector<double> v;
-        for (std::vector<jkmpResult>::const_iterator it=listData.begin(); it!=listData.end(); it++) {
+        for (auto it=listData.begin(); it!=listData.end(); it++) {
             if (it->convertsToDouble()) {
                 v.push_back(it->asNumber());
             } else {
@@ -562,7 +574,7 @@ void jkmpResult::setStructItem(const JKMP::string &item, const jkmpResult &value
     }
 }
 
-void jkmpResult::setStruct(const JKMP::map<JKMP::string, jkmpResult> &data)
+void jkmpResult::setStruct(const JKMP::flatmap<JKMP::string,jkmpResult> &data)
 {
     setStruct();
     structData=data;
@@ -678,18 +690,22 @@ void jkmpResult::add(jkmpResult& re, const jkmpResult &l, const jkmpResult &r, J
         case (jkmpDoubleMatrix<<16)+jkmpDouble:
             {
             re=l;
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                re.numVec[i]=l.numVec[i]+r.num;
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.numVec[i]+r.num;
+                }
+            });
             break;
         }
         case (uint32_t(jkmpDouble)<<16)+jkmpDoubleVector:
         case (uint32_t(jkmpDouble)<<16)+jkmpDoubleMatrix:
             {
             re=r;
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                re.numVec[i]=l.num+r.numVec[i];
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.num+r.numVec[i];
+                }
+            });
             break;
         }
         case (uint32_t(jkmpDoubleVector<<16))+jkmpDoubleVector:
@@ -697,21 +713,23 @@ void jkmpResult::add(jkmpResult& re, const jkmpResult &l, const jkmpResult &r, J
             {
                 if (l.isMatrix()) {
                     if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                        if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         re.setInvalid();
                         return;
                     }
                 } else {
                     if (l.length()!=r.length()) {
-                        if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                         re.setInvalid();
                         return;
                     }
                 }
                 re=r;
-                for (size_t i=0; i<r.numVec.size(); i++) {
-                    re.numVec[i]=l.numVec[i]+r.numVec[i];
-                }
+                jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                    for (size_t i=start; i<end; i++) {
+                        re.numVec[i]=l.numVec[i]+r.numVec[i];
+                    }
+                });
                 break;
             }
         case (uint32_t(jkmpString)<<16)+jkmpString:
@@ -719,7 +737,7 @@ void jkmpResult::add(jkmpResult& re, const jkmpResult &l, const jkmpResult &r, J
             break;
         default:
 {
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be added").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be added").arg(l.typeName()).arg(r.typeName()));
                 re.setInvalid();
             }
             break;
@@ -743,18 +761,22 @@ void jkmpResult::sub(jkmpResult& re, const jkmpResult &l, const jkmpResult &r, J
         case (jkmpDoubleMatrix<<16)+jkmpDouble:
             {
             re=l;
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                re.numVec[i]=l.numVec[i]-r.num;
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.numVec[i]-r.num;
+                }
+            });
             break;
         }
         case (uint32_t(jkmpDouble)<<16)+jkmpDoubleVector:
         case (uint32_t(jkmpDouble)<<16)+jkmpDoubleMatrix:
             {
             re=r;
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                re.numVec[i]=l.num-r.numVec[i];
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.num-r.numVec[i];
+                }
+            });
             break;
         }
         case (uint32_t(jkmpDoubleVector<<16))+jkmpDoubleVector:
@@ -762,26 +784,28 @@ void jkmpResult::sub(jkmpResult& re, const jkmpResult &l, const jkmpResult &r, J
             {
                 if (l.isMatrix()) {
                     if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                        if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         re.setInvalid();
                         return;
                     }
                 } else {
                     if (l.length()!=r.length()) {
-                        if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                         re.setInvalid();
                         return;
                     }
                 }
                 re=r;
-                for (size_t i=0; i<r.numVec.size(); i++) {
-                    re.numVec[i]=l.numVec[i]-r.numVec[i];
-                }
+                jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                    for (size_t i=start; i<end; i++) {
+                        re.numVec[i]=l.numVec[i]-r.numVec[i];
+                    }
+                });
                 break;
             }
         default:
             {
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be subtracted").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be subtracted").arg(l.typeName()).arg(r.typeName()));
                 re.setInvalid();
             }
             break;
@@ -802,18 +826,22 @@ void jkmpResult::mul(jkmpResult& re, const jkmpResult &l, const jkmpResult &r, J
         case (jkmpDoubleMatrix<<16)+jkmpDouble:
             {
             re=l;
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                re.numVec[i]=l.numVec[i]*r.num;
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.numVec[i]*r.num;
+                }
+            });
             break;
         }
         case (uint32_t(jkmpDouble)<<16)+jkmpDoubleVector:
         case (uint32_t(jkmpDouble)<<16)+jkmpDoubleMatrix:
             {
             re=r;
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                re.numVec[i]=l.num*r.numVec[i];
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.num*r.numVec[i];
+                }
+            });
             break;
         }
         case (uint32_t(jkmpDoubleVector<<16))+jkmpDoubleVector:
@@ -821,26 +849,28 @@ void jkmpResult::mul(jkmpResult& re, const jkmpResult &l, const jkmpResult &r, J
             {
                 if (l.isMatrix()) {
                     if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                        if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         re.setInvalid();
                         return;
                     }
                 } else {
                     if (l.length()!=r.length()) {
-                        if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                         re.setInvalid();
                         return;
                     }
                 }
                 re=r;
-                for (size_t i=0; i<r.numVec.size(); i++) {
-                    re.numVec[i]=l.numVec[i]*r.numVec[i];
-                }
+                jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                    for (size_t i=start; i<end; i++) {
+                        re.numVec[i]=l.numVec[i]*r.numVec[i];
+                    }
+                });
                 break;
             }
         default:
             {
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be multiplied").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be multiplied").arg(l.typeName()).arg(r.typeName()));
                 re.setInvalid();
             }
             break;
@@ -861,18 +891,22 @@ void jkmpResult::div(jkmpResult& re, const jkmpResult &l, const jkmpResult &r, J
         case (jkmpDoubleMatrix<<16)+jkmpDouble:
             {
             re=l;
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                re.numVec[i]=l.numVec[i]/r.num;
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.numVec[i]/r.num;
+                }
+            });
             break;
         }
         case (uint32_t(jkmpDouble)<<16)+jkmpDoubleVector:
         case (uint32_t(jkmpDouble)<<16)+jkmpDoubleMatrix:
             {
             re=r;
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                re.numVec[i]=l.num/r.numVec[i];
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.num/r.numVec[i];
+                }
+            });
             break;
         }
         case (uint32_t(jkmpDoubleVector<<16))+jkmpDoubleVector:
@@ -880,27 +914,29 @@ void jkmpResult::div(jkmpResult& re, const jkmpResult &l, const jkmpResult &r, J
             {
                 if (l.isMatrix()) {
                     if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                        if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         re.setInvalid();
                         return;
                     }
                 } else {
                     if (l.length()!=r.length()) {
-                        if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                         re.setInvalid();
                         return;
                     }
                 }
                 re=r;
-                for (size_t i=0; i<r.numVec.size(); i++) {
-                    re.numVec[i]=l.numVec[i]/r.numVec[i];
-                }
+                jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                    for (size_t i=start; i<end; i++) {
+                        re.numVec[i]=l.numVec[i]/r.numVec[i];
+                    }
+                });
                 break;
             }
         default:
             {
                 re.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be divided").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be divided").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -920,18 +956,22 @@ void jkmpResult::mod(jkmpResult& re, const jkmpResult &l, const jkmpResult &r, J
         case (jkmpDoubleMatrix<<16)+jkmpDouble:
             {
             re=l;
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                re.numVec[i]=int32_t(l.numVec[i])%r.toInteger();
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=int32_t(l.numVec[i])%r.toInteger();
+                }
+            });
             break;
         }
         case (jkmpDouble<<16)+jkmpDoubleVector:
         case (jkmpDouble<<16)+jkmpDoubleMatrix:
             {
             re=r;
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                re.numVec[i]=l.toInteger()%int32_t(r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.toInteger()%int32_t(r.numVec[i]);
+                }
+            });
             break;
         }
         case (jkmpDoubleVector<<16)+jkmpDoubleVector:
@@ -939,26 +979,28 @@ void jkmpResult::mod(jkmpResult& re, const jkmpResult &l, const jkmpResult &r, J
             {
             if (l.isMatrix()) {
                 if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                    if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                    if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                     re.setInvalid();
                     return;
                 }
             } else {
                 if (l.length()!=r.length()) {
-                    if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                    if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                     re.setInvalid();
                     return;
                 }
             }
             re=l;
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                re.numVec[i]=int32_t(l.numVec[i])%int32_t(r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=int32_t(l.numVec[i])%int32_t(r.numVec[i]);
+                }
+            });
             break;
         }
         default:
             {
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be used in mod operation").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be used in mod operation").arg(l.typeName()).arg(r.typeName()));
                 re.setInvalid();
             }
             break;
@@ -979,18 +1021,22 @@ void jkmpResult::power(jkmpResult& re, const jkmpResult &l, const jkmpResult &r,
         case (jkmpDoubleMatrix<<16)+jkmpDouble:
             {
             re=l;
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                re.numVec[i]=pow(l.numVec[i],r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=pow(l.numVec[i],r.num);
+                }
+            });
             break;
         }
         case (jkmpDouble<<16)+jkmpDoubleVector:
         case (jkmpDouble<<16)+jkmpDoubleMatrix:
             {
             re=r;
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                re.numVec[i]=pow(l.num,r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=pow(l.num,r.numVec[i]);
+                }
+            });
             break;
         }
         case (jkmpDoubleVector<<16)+jkmpDoubleVector:
@@ -998,28 +1044,30 @@ void jkmpResult::power(jkmpResult& re, const jkmpResult &l, const jkmpResult &r,
             {
                 if (l.isMatrix()) {
                     if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                        if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         re.setInvalid();
                         return;
                     }
                 } else {
                     if (l.length()!=r.length()) {
-                        if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                         re.setInvalid();
                         return;
                     }
                 }
 
             re=r;
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                re.numVec[i]=pow(l.numVec[i],r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=pow(l.numVec[i],r.numVec[i]);
+                }
+            });
             break;
         }
         default:
             {
                 re.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be used in power operation").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be used in power operation").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -1039,18 +1087,22 @@ void jkmpResult::bitwiseand(jkmpResult& re, const jkmpResult &l, const jkmpResul
         case (jkmpDoubleMatrix<<16)+jkmpDouble:
             {
             re=l;
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                re.numVec[i]=int32_t(l.numVec[i])&r.toInteger();
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=int32_t(l.numVec[i])&r.toInteger();
+                }
+            });
             break;
         }
         case (jkmpDouble<<16)+jkmpDoubleVector:
         case (jkmpDouble<<16)+jkmpDoubleMatrix:
             {
             re=r;
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                re.numVec[i]=l.toInteger()&int32_t(r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.toInteger()&int32_t(r.numVec[i]);
+                }
+            });
             break;
         }
         case (jkmpDoubleVector<<16)+jkmpDoubleVector:
@@ -1058,26 +1110,28 @@ void jkmpResult::bitwiseand(jkmpResult& re, const jkmpResult &l, const jkmpResul
             {
                 if (l.isMatrix()) {
                     if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                        if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         re.setInvalid();
                         return;
                     }
                 } else {
                     if (l.length()!=r.length()) {
-                        if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                         re.setInvalid();
                         return;
                     }
                 }
             re=r;
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                re.numVec[i]=int32_t(l.numVec[i])&int32_t(r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=int32_t(l.numVec[i])&int32_t(r.numVec[i]);
+                }
+            });
             break;
         }
         default:
             {
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be used in bitwise and operation").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be used in bitwise and operation").arg(l.typeName()).arg(r.typeName()));
                 re.setInvalid();
             }
             break;
@@ -1098,18 +1152,22 @@ void jkmpResult::bitwiseor(jkmpResult& re, const jkmpResult &l, const jkmpResult
         case (jkmpDoubleMatrix<<16)+jkmpDouble:
             {
             re=r;
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                re.numVec[i]=int32_t(l.numVec[i])|r.toInteger();
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=int32_t(l.numVec[i])|r.toInteger();
+                }
+            });
             break;
         }
         case (jkmpDouble<<16)+jkmpDoubleVector:
         case (jkmpDouble<<16)+jkmpDoubleMatrix:
             {
             re=l;
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                re.numVec[i]=l.toInteger()|int32_t(r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.toInteger()|int32_t(r.numVec[i]);
+                }
+            });
             break;
         }
         case (jkmpDoubleVector<<16)+jkmpDoubleVector:
@@ -1117,28 +1175,30 @@ void jkmpResult::bitwiseor(jkmpResult& re, const jkmpResult &l, const jkmpResult
             {
             if (l.isMatrix()) {
                 if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                    if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                    if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                     re.setInvalid();
                     return;
                 }
             } else {
                 if (l.length()!=r.length()) {
-                    if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                    if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                     re.setInvalid();
                     return;
                 }
             }
 
             re=r;
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                re.numVec[i]=int32_t(l.numVec[i])|int32_t(r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=int32_t(l.numVec[i])|int32_t(r.numVec[i]);
+                }
+            });
             break;
         }
         default:
             {
                 re.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be used in bitwise or operation").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be used in bitwise or operation").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -1159,37 +1219,41 @@ void jkmpResult::logicand(jkmpResult& re, const jkmpResult &l, const jkmpResult
             {
                 if (l.isMatrix()) {
                     if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                        if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         re.setInvalid();
                         return;
                     }
                 } else {
                     if (l.length()!=r.length()) {
-                        if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                         re.setInvalid();
                         return;
                     }
                 }
             re=r;
-            for (size_t i=0; i<r.boolVec.size(); i++) {
-                re.boolVec[i]=l.boolVec[i]&&r.boolVec[i];
-            }
+            jkmpParallelVectorFor(p, r.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.boolVec[i]=l.boolVec[i]&&r.boolVec[i];
+                }
+            });
             break;
         }
         case (jkmpBoolVector<<16)+jkmpBool:
         case (jkmpBoolMatrix<<16)+jkmpBool:
             {
             re=l;
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                re.boolVec[i]=l.boolVec[i]&&r.boolean;
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.boolVec[i]=l.boolVec[i]&&r.boolean;
+                }
+            });
             break;
         }
 
         default:
             {
                 re.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be used in logic and operation").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be used in logic and operation").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -1210,36 +1274,40 @@ void jkmpResult::logicor(jkmpResult& re, const jkmpResult &l, const jkmpResult &
             {
                 if (l.isMatrix()) {
                     if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                        if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         re.setInvalid();
                         return;
                     }
                 } else {
                     if (l.length()!=r.length()) {
-                        if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                         re.setInvalid();
                         return;
                     }
                 }
             re=r;
-            for (size_t i=0; i<r.boolVec.size(); i++) {
-                re.boolVec[i]=l.boolVec[i]||r.boolVec[i];
-            }
+            jkmpParallelVectorFor(p, r.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.boolVec[i]=l.boolVec[i]||r.boolVec[i];
+                }
+            });
             break;
         }
         case (jkmpBoolVector<<16)+jkmpBool:
         case (jkmpBoolMatrix<<16)+jkmpBool:
             {
             re=l;
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                re.boolVec[i]=l.boolVec[i]||r.boolean;
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.boolVec[i]=l.boolVec[i]||r.boolean;
+                }
+            });
             break;
         }
         default:
             {
                 re.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be used in logic or operation").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be used in logic or operation").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -1253,15 +1321,17 @@ void jkmpResult::logicnot(jkmpResult& re, const jkmpResult &l, JKMathParser *p)
         case jkmpBoolMatrix:
             {
             re=l;
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                re.boolVec[i]=!l.boolVec[i];
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.boolVec[i]=!l.boolVec[i];
+                }
+            });
             break;
         }
         default:
             {
                 re.setInvalid();
-                if (p) p->jkmpError(JKMP::_("argument of type %1 may not be used in logic not operation").arg(l.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("argument of type %1 may not be used in logic not operation").arg(l.typeName()));
             }
             break;
 
@@ -1284,36 +1354,40 @@ void jkmpResult::logicnand(jkmpResult &re, const jkmpResult &l, const jkmpResult
             {
                 if (l.isMatrix()) {
                     if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                        if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         re.setInvalid();
                         return;
                     }
                 } else {
                     if (l.length()!=r.length()) {
-                        if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                         re.setInvalid();
                         return;
                     }
                 }
             re=r;
-            for (size_t i=0; i<r.boolVec.size(); i++) {
-                re.boolVec[i]=!(l.boolVec[i]&&r.boolVec[i]);
-            }
+            jkmpParallelVectorFor(p, r.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.boolVec[i]=!(l.boolVec[i]&&r.boolVec[i]);
+                }
+            });
             break;
         }
         case (jkmpBoolVector<<16)+jkmpBool:
         case (jkmpBoolMatrix<<16)+jkmpBool:
             {
             re=l;
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                re.boolVec[i]=!(l.boolVec[i]&&r.boolean);
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.boolVec[i]=!(l.boolVec[i]&&r.boolean);
+                }
+            });
             break;
         }
         default:
             {
                 re.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be used in logic nand operation").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be used in logic nand operation").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -1334,35 +1408,39 @@ void jkmpResult::logicnor(jkmpResult &re, const jkmpResult &l, const jkmpResult
             {
                 if (l.isMatrix()) {
                     if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                        if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         re.setInvalid();
                         return;
                     }
                 } else {
                     if (l.length()!=r.length()) {
-                        if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                         re.setInvalid();
                         return;
                     }
                 }
             re=r;
-            for (size_t i=0; i<r.boolVec.size(); i++) {
-                re.boolVec[i]=!(l.boolVec[i]||r.boolVec[i]);
-            }
+            jkmpParallelVectorFor(p, r.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.boolVec[i]=!(l.boolVec[i]||r.boolVec[i]);
+                }
+            });
             break;
         }
         case (jkmpBoolVector<<16)+jkmpBool:
         case (jkmpBoolMatrix<<16)+jkmpBool: {
             re=l;
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                re.boolVec[i]=!(l.boolVec[i]||r.boolean);
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.boolVec[i]=!(l.boolVec[i]||r.boolean);
+                }
+            });
             break;
         }
         default:
             {
                 re.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be used in logic nor operation").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be used in logic nor operation").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -1383,36 +1461,40 @@ void jkmpResult::logicxor(jkmpResult &re, const jkmpResult &l, const jkmpResult
             {
                 if (l.isMatrix()) {
                     if (l.length()!=r.length() || r.matrix_columns!=l.matrix_columns) {
-                        if (p) p->jkmpError(JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix arguments have to have the same size, but sizes were left=%1x%2, right=%3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         re.setInvalid();
                         return;
                     }
                 } else {
                     if (l.length()!=r.length()) {
-                        if (p) p->jkmpError(JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments have to have the same length, but lengthes were left=%1, right=%2").arg(l.length()).arg(r.length()));
                         re.setInvalid();
                         return;
                     }
                 }
             re=r;
-            for (size_t i=0; i<r.boolVec.size(); i++) {
-                re.boolVec[i]=(!l.boolVec[i]&&r.boolVec[i])||(l.boolVec[i]&&!r.boolVec[i]);
-            }
+            jkmpParallelVectorFor(p, r.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.boolVec[i]=(!l.boolVec[i]&&r.boolVec[i])||(l.boolVec[i]&&!r.boolVec[i]);
+                }
+            });
             break;
         }
         case (jkmpBoolVector<<16)+jkmpBool:
         case (jkmpBoolMatrix<<16)+jkmpBool:
             {
             re=l;
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                re.boolVec[i]=(!l.boolVec[i]&&r.boolean)||(l.boolVec[i]&&!r.boolean);
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.boolVec[i]=(!l.boolVec[i]&&r.boolean)||(l.boolVec[i]&&!r.boolean);
+                }
+            });
             break;
         }
         default:
             {
                 re.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be used in logic xor operation").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be used in logic xor operation").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -1426,15 +1508,17 @@ void jkmpResult::neg(jkmpResult& re, const jkmpResult &l, JKMathParser *p)
         case jkmpDoubleMatrix:
             {
             re=l;
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                re.numVec[i]=l.numVec[i];
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=l.numVec[i];
+                }
+            });
             break;
         }
         default:
             {
                 re.setInvalid();
-                if (p) p->jkmpError(JKMP::_("argument of type %1 may not be used in negation operation").arg(l.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("argument of type %1 may not be used in negation operation").arg(l.typeName()));
             }
             break;
 
@@ -1449,15 +1533,17 @@ void jkmpResult::bitwisenot(jkmpResult& re, const jkmpResult &l, JKMathParser *p
         case jkmpDoubleMatrix:
             {
             re=l;
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                re.numVec[i]=~int32_t(l.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    re.numVec[i]=~int32_t(l.numVec[i]);
+                }
+            });
             break;
         }
         default:
             {
                 re.setInvalid();
-                if (p) p->jkmpError(JKMP::_("argument of type %1 may not be used in bitwise not operation").arg(l.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("argument of type %1 may not be used in bitwise not operation").arg(l.typeName()));
             }
             break;
 
@@ -1477,46 +1563,56 @@ void jkmpResult::compareequal(jkmpResult& res, const jkmpResult &l, const jkmpRe
                 if (l.isMatrix()) {
                     if (l.numVec.size()!=r.numVec.size() || l.matrix_columns!=r.matrix_columns) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("matrix in comparison '==' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix in comparison '==' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         return;
                     }
                     res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
                 } else {
                     if (l.numVec.size()!=r.numVec.size()) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("vectors in comparison '==' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '==' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
                         return;
                     }
                     res.setBoolVec(l.numVec.size());
                 }
 
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]==r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]==r.numVec[i]);
+                }
+            });
             } break;
         case (jkmpDoubleVector<<16)+jkmpDouble: {
             res.setBoolVec(l.numVec.size());
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]==r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]==r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleVector: {
             res.setBoolVec(r.numVec.size());
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]==l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(r.numVec[i]==l.num);
+                }
+            });
             } break;
         case (jkmpDoubleMatrix<<16)+jkmpDouble: {
             res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]==r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]==r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleMatrix: {
             res.setBoolMatrix(r.numVec.size(), r.matrix_columns);
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]==l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(r.numVec[i]==l.num);
+                }
+            });
             } break;
 
         case (jkmpList<<16)+jkmpList:
@@ -1531,7 +1627,7 @@ void jkmpResult::compareequal(jkmpResult& res, const jkmpResult &l, const jkmpRe
         case (jkmpStringVector<<16)+jkmpStringVector: {
             if (l.strVec.size()!=r.strVec.size()) {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("vectors in comparison '==' have different length"));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '==' have different length"));
                 return;
             }
             res.setBoolVec(l.strVec.size());
@@ -1562,50 +1658,60 @@ void jkmpResult::compareequal(jkmpResult& res, const jkmpResult &l, const jkmpRe
                 if (l.isMatrix()) {
                     if (l.boolVec.size()!=r.boolVec.size() || l.matrix_columns!=r.matrix_columns) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("matrix in comparison '==' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix in comparison '==' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         return;
                     }
                     res.setBoolMatrix(l.boolVec.size(), l.matrix_columns);
                 } else {
                     if (l.boolVec.size()!=r.boolVec.size()) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("vectors in comparison '==' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '==' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
                         return;
                     }
                     res.setBoolVec(l.boolVec.size());
                 }
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                res.boolVec[i]=(l.boolVec[i]==r.boolVec[i]);
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.boolVec[i]==r.boolVec[i]);
+                }
+            });
             } break;
         case (jkmpBoolVector<<16)+jkmpBool: {
             res.setBoolVec(l.boolVec.size());
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                res.boolVec[i]=(l.boolVec[i]==r.boolean);
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.boolVec[i]==r.boolean);
+                }
+            });
             } break;
         case (jkmpBool<<16)+jkmpBoolVector: {
             res.setBoolVec(r.boolVec.size());
-            for (size_t i=0; i<r.boolVec.size(); i++) {
-                res.boolVec[i]=(r.boolVec[i]==l.boolean);
-            }
+            jkmpParallelVectorFor(p, r.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(r.boolVec[i]==l.boolean);
+                }
+            });
             } break;
         case (jkmpBoolMatrix<<16)+jkmpBool: {
             res.setBoolMatrix(l.boolVec.size(), l.matrix_columns);
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                res.boolVec[i]=(l.boolVec[i]==r.boolean);
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.boolVec[i]==r.boolean);
+                }
+            });
             } break;
         case (jkmpBool<<16)+jkmpBoolMatrix: {
             res.setBoolMatrix(r.boolVec.size(), r.matrix_columns);
-            for (size_t i=0; i<r.boolVec.size(); i++) {
-                res.boolVec[i]=(r.boolVec[i]==l.boolean);
-            }
+            jkmpParallelVectorFor(p, r.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(r.boolVec[i]==l.boolean);
+                }
+            });
             } break;
         default:
             {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be compared '=='").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be compared '=='").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -1623,46 +1729,56 @@ void jkmpResult::comparenotequal(jkmpResult& res, const jkmpResult &l, const jkm
                 if (l.isMatrix()) {
                     if (l.numVec.size()!=r.numVec.size() || l.matrix_columns!=r.matrix_columns) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("matrix in comparison '!=' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix in comparison '!=' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         return;
                     }
                     res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
                 } else {
                     if (l.numVec.size()!=r.numVec.size()) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("vectors in comparison '!=' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '!=' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
                         return;
                     }
                     res.setBoolVec(l.numVec.size());
                 }
 
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]!=r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]!=r.numVec[i]);
+                }
+            });
             } break;
         case (jkmpDoubleVector<<16)+jkmpDouble: {
             res.setBoolVec(l.numVec.size());
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]!=r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]!=r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleVector: {
             res.setBoolVec(r.numVec.size());
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]!=l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(r.numVec[i]!=l.num);
+                }
+            });
             } break;
         case (jkmpDoubleMatrix<<16)+jkmpDouble: {
             res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]!=r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]!=r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleMatrix: {
             res.setBoolMatrix(r.numVec.size(), r.matrix_columns);
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]!=l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(r.numVec[i]!=l.num);
+                }
+            });
             } break;
 
         case (jkmpList<<16)+jkmpList:
@@ -1677,7 +1793,7 @@ void jkmpResult::comparenotequal(jkmpResult& res, const jkmpResult &l, const jkm
         case (jkmpStringVector<<16)+jkmpStringVector: {
             if (l.strVec.size()!=r.strVec.size()) {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("vectors in comparison '!=' have different length"));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '!=' have different length"));
                 return;
             }
             res.setBoolVec(l.strVec.size());
@@ -1708,50 +1824,60 @@ void jkmpResult::comparenotequal(jkmpResult& res, const jkmpResult &l, const jkm
                 if (l.isMatrix()) {
                     if (l.boolVec.size()!=r.boolVec.size() || l.matrix_columns!=r.matrix_columns) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("matrix in comparison '!=' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix in comparison '!=' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         return;
                     }
                     res.setBoolMatrix(l.boolVec.size(), l.matrix_columns);
                 } else {
                     if (l.boolVec.size()!=r.boolVec.size()) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("vectors in comparison '!=' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '!=' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
                         return;
                     }
                     res.setBoolVec(l.boolVec.size());
                 }
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                res.boolVec[i]=(l.boolVec[i]!=r.boolVec[i]);
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.boolVec[i]!=r.boolVec[i]);
+                }
+            });
             } break;
         case (jkmpBoolVector<<16)+jkmpBool: {
             res.setBoolVec(l.boolVec.size());
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                res.boolVec[i]=(l.boolVec[i]!=r.boolean);
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.boolVec[i]!=r.boolean);
+                }
+            });
             } break;
         case (jkmpBool<<16)+jkmpBoolVector: {
             res.setBoolVec(r.boolVec.size());
-            for (size_t i=0; i<r.boolVec.size(); i++) {
-                res.boolVec[i]=(r.boolVec[i]!=l.boolean);
-            }
+            jkmpParallelVectorFor(p, r.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(r.boolVec[i]!=l.boolean);
+                }
+            });
             } break;
         case (jkmpBoolMatrix<<16)+jkmpBool: {
             res.setBoolMatrix(l.boolVec.size(), l.matrix_columns);
-            for (size_t i=0; i<l.boolVec.size(); i++) {
-                res.boolVec[i]=(l.boolVec[i]!=r.boolean);
-            }
+            jkmpParallelVectorFor(p, l.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.boolVec[i]!=r.boolean);
+                }
+            });
             } break;
         case (jkmpBool<<16)+jkmpBoolMatrix: {
             res.setBoolMatrix(r.boolVec.size(), r.matrix_columns);
-            for (size_t i=0; i<r.boolVec.size(); i++) {
-                res.boolVec[i]=(r.boolVec[i]!=l.boolean);
-            }
+            jkmpParallelVectorFor(p, r.boolVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(r.boolVec[i]!=l.boolean);
+                }
+            });
             } break;
         default:
             {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be compared '!='").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be compared '!='").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -1770,46 +1896,56 @@ void jkmpResult::comparegreater(jkmpResult& res, const jkmpResult &l, const jkmp
                 if (l.isMatrix()) {
                     if (l.numVec.size()!=r.numVec.size() || l.matrix_columns!=r.matrix_columns) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("matrix in comparison '>' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix in comparison '>' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         return;
                     }
                     res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
                 } else {
                     if (l.numVec.size()!=r.numVec.size()) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("vectors in comparison '>' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '>' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
                         return;
                     }
                     res.setBoolVec(l.numVec.size());
                 }
 
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]>r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]>r.numVec[i]);
+                }
+            });
             } break;
         case (jkmpDoubleVector<<16)+jkmpDouble: {
             res.setBoolVec(l.numVec.size());
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]>r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]>r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleVector: {
             res.setBoolVec(r.numVec.size());
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]>l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.num>r.numVec[i]);
+                }
+            });
             } break;
         case (jkmpDoubleMatrix<<16)+jkmpDouble: {
             res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]>r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]>r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleMatrix: {
             res.setBoolMatrix(r.numVec.size(), r.matrix_columns);
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]>l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.num>r.numVec[i]);
+                }
+            });
             } break;
 
 
@@ -1819,7 +1955,7 @@ void jkmpResult::comparegreater(jkmpResult& res, const jkmpResult &l, const jkmp
         case (jkmpStringVector<<16)+jkmpStringVector: {
             if (l.strVec.size()!=r.strVec.size()) {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("vectors in comparison '>' have different length"));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '>' have different length"));
                 return;
             }
             res.setBoolVec(l.strVec.size());
@@ -1847,7 +1983,7 @@ void jkmpResult::comparegreater(jkmpResult& res, const jkmpResult &l, const jkmp
         default:
             {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be compared '>'").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be compared '>'").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -1867,46 +2003,56 @@ void jkmpResult::comparegreaterequal(jkmpResult& res, const jkmpResult &l, const
                 if (l.isMatrix()) {
                     if (l.numVec.size()!=r.numVec.size() || l.matrix_columns!=r.matrix_columns) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("matrix in comparison '>=' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix in comparison '>=' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         return;
                     }
                     res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
                 } else {
                     if (l.numVec.size()!=r.numVec.size()) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("vectors in comparison '>=' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '>=' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
                         return;
                     }
                     res.setBoolVec(l.numVec.size());
                 }
 
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]>=r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]>=r.numVec[i]);
+                }
+            });
             } break;
         case (jkmpDoubleVector<<16)+jkmpDouble: {
             res.setBoolVec(l.numVec.size());
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]>=r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]>=r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleVector: {
             res.setBoolVec(r.numVec.size());
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]>=l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.num>=r.numVec[i]);
+                }
+            });
             } break;
         case (jkmpDoubleMatrix<<16)+jkmpDouble: {
             res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]>=r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]>=r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleMatrix: {
             res.setBoolMatrix(r.numVec.size(), r.matrix_columns);
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]>=l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.num>=r.numVec[i]);
+                }
+            });
             } break;
 
 
@@ -1916,7 +2062,7 @@ void jkmpResult::comparegreaterequal(jkmpResult& res, const jkmpResult &l, const
         case (jkmpStringVector<<16)+jkmpStringVector: {
             if (l.strVec.size()!=r.strVec.size()) {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("vectors in comparison '>=' have different length"));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '>=' have different length"));
                 return;
             }
             res.setBoolVec(l.strVec.size());
@@ -1941,7 +2087,7 @@ void jkmpResult::comparegreaterequal(jkmpResult& res, const jkmpResult &l, const
         default:
             {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be compared '>='").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be compared '>='").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -1963,46 +2109,56 @@ void jkmpResult::comparesmaller(jkmpResult& res, const jkmpResult &l, const jkmp
                 if (l.isMatrix()) {
                     if (l.numVec.size()!=r.numVec.size() || l.matrix_columns!=r.matrix_columns) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("matrix in comparison '<' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix in comparison '<' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         return;
                     }
                     res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
                 } else {
                     if (l.numVec.size()!=r.numVec.size()) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("vectors in comparison '<' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '<' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
                         return;
                     }
                     res.setBoolVec(l.numVec.size());
                 }
 
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]<r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]<r.numVec[i]);
+                }
+            });
             } break;
         case (jkmpDoubleVector<<16)+jkmpDouble: {
             res.setBoolVec(l.numVec.size());
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]<r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]<r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleVector: {
             res.setBoolVec(r.numVec.size());
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]<l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.num<r.numVec[i]);
+                }
+            });
             } break;
         case (jkmpDoubleMatrix<<16)+jkmpDouble: {
             res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]<r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]<r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleMatrix: {
             res.setBoolMatrix(r.numVec.size(), r.matrix_columns);
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]<l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.num<r.numVec[i]);
+                }
+            });
             } break;
 
 
@@ -2012,7 +2168,7 @@ void jkmpResult::comparesmaller(jkmpResult& res, const jkmpResult &l, const jkmp
         case (jkmpStringVector<<16)+jkmpStringVector: {
             if (l.strVec.size()!=r.strVec.size()) {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("vectors in comparison '<' have different length"));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '<' have different length"));
                 return;
             }
             res.setBoolVec(l.strVec.size());
@@ -2037,7 +2193,7 @@ void jkmpResult::comparesmaller(jkmpResult& res, const jkmpResult &l, const jkmp
         default:
             {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be compared '<'").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be compared '<'").arg(l.typeName()).arg(r.typeName()));
                 break;            }
 
     }
@@ -2056,46 +2212,56 @@ void jkmpResult::comparesmallerequal(jkmpResult& res, const jkmpResult &l, const
                 if (l.isMatrix()) {
                     if (l.numVec.size()!=r.numVec.size() || l.matrix_columns!=r.matrix_columns) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("matrix in comparison '<=' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("matrix in comparison '<=' have different sizes (%1x%2 and %3x%4").arg(l.rows()).arg(l.columns()).arg(r.rows()).arg(r.columns()));
                         return;
                     }
                     res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
                 } else {
                     if (l.numVec.size()!=r.numVec.size()) {
                         res.setInvalid();
-                        if (p) p->jkmpError(JKMP::_("vectors in comparison '<=' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
+                        if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '<=' have different length (%1 and %2)").arg(l.length()).arg(r.length()));
                         return;
                     }
                     res.setBoolVec(l.numVec.size());
                 }
 
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]<=r.numVec[i]);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]<=r.numVec[i]);
+                }
+            });
             } break;
         case (jkmpDoubleVector<<16)+jkmpDouble: {
             res.setBoolVec(l.numVec.size());
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]<=r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]<=r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleVector: {
             res.setBoolVec(r.numVec.size());
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]<=l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.num<=r.numVec[i]);
+                }
+            });
             } break;
         case (jkmpDoubleMatrix<<16)+jkmpDouble: {
             res.setBoolMatrix(l.numVec.size(), l.matrix_columns);
-            for (size_t i=0; i<l.numVec.size(); i++) {
-                res.boolVec[i]=(l.numVec[i]<=r.num);
-            }
+            jkmpParallelVectorFor(p, l.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.numVec[i]<=r.num);
+                }
+            });
             } break;
         case (jkmpDouble<<16)+jkmpDoubleMatrix: {
             res.setBoolMatrix(r.numVec.size(), r.matrix_columns);
-            for (size_t i=0; i<r.numVec.size(); i++) {
-                res.boolVec[i]=(r.numVec[i]<=l.num);
-            }
+            jkmpParallelVectorFor(p, r.numVec.size(), [&](size_t start, size_t end) {
+                for (size_t i=start; i<end; i++) {
+                    res.boolVec[i]=(l.num<=r.numVec[i]);
+                }
+            });
             } break;
 
 
@@ -2105,7 +2271,7 @@ void jkmpResult::comparesmallerequal(jkmpResult& res, const jkmpResult &l, const
         case (jkmpStringVector<<16)+jkmpStringVector: {
             if (l.strVec.size()!=r.strVec.size()) {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("vectors in comparison '<=' have different length"));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("vectors in comparison '<=' have different length"));
                 return;
             }
             res.setBoolVec(l.strVec.size());
@@ -2130,7 +2296,7 @@ void jkmpResult::comparesmallerequal(jkmpResult& res, const jkmpResult &l, const
         default:
             {
                 res.setInvalid();
-                if (p) p->jkmpError(JKMP::_("arguments of type %1 and %2 may not be compared '<='").arg(l.typeName()).arg(r.typeName()));
+                if (p) JKMATHPARSER_ERROR(p, JKMP::_("arguments of type %1 and %2 may not be compared '<='").arg(l.typeName()).arg(r.typeName()));
             }
             break;
     }
@@ -2194,3 +2360,96 @@ JKMP::string jkmpResultTypeToString(jkmpResultType type)
     }
     return JKMP::_("invalid");
 }
+
+// the chunks of jkmpParallelVectorFor() have to consist of whole blocks, so the partial results do not depend on the number of threads
+static_assert(JKMATHPARSER_PARALLELVECTOR_GRAIN%JKMP_REDUCE_BLOCK==0, "JKMATHPARSER_PARALLELVECTOR_GRAIN has to be a multiple of JKMP_REDUCE_BLOCK");
+
+double jkmpReduceSum(JKMathParser *p, const double *data, size_t n, bool squares, size_t *count)
+{
+    const bool kahan=(p && p->getSummationMode()==jkmpKahanSummation);
+    if (n<=JKMP_REDUCE_BLOCK) return JKMP::reduceSum(data, n, kahan, squares, count);
+    const size_t blocks=(n+JKMP_REDUCE_BLOCK-1)/JKMP_REDUCE_BLOCK;
+    JKMP::vector<double> sums(blocks, 0.0), compensations(blocks, 0.0);
+    std::vector<size_t> counts(blocks, 0);
+    jkmpParallelVectorFor(p, n, [&](size_t start, size_t end) {
+        for (size_t i=start; i<end; i+=JKMP_REDUCE_BLOCK) {
+            const size_t b=i/JKMP_REDUCE_BLOCK;
+            sums[b]=JKMP::reduceSumBlock(data+i, std::min<size_t>(JKMP_REDUCE_BLOCK, end-i), kahan, squares, &(compensations[b]), count?(&(counts[b])):NULL);
+        }
+    });
+    if (count) {
+        *count=0;
+        for (size_t b=0; b<blocks; b++) *count+=counts[b];
+    }
+    return JKMP::reduceSumPartials(sums.data(), compensations.data(), blocks, kahan);
+}
+
+/** \brief JKMP::reduceCentralSums() with the blocks computed on the thread pool of \a p */
+static JKMP::CentralSums jkmpReduceCentralSums(JKMathParser *p, const double *data, size_t n, int order)
+{
+    if (n<=JKMP_REDUCE_BLOCK) return JKMP::reduceCentralSums(data, n, order);
+    const size_t blocks=(n+JKMP_REDUCE_BLOCK-1)/JKMP_REDUCE_BLOCK;
+    std::vector<JKMP::CentralSums> partials(blocks);
+    jkmpParallelVectorFor(p, n, [&](size_t start, size_t end) {
+        for (size_t i=start; i<end; i+=JKMP_REDUCE_BLOCK) {
+            partials[i/JKMP_REDUCE_BLOCK]=JKMP::reduceCentralSumsBlock(data+i, std::min<size_t>(JKMP_REDUCE_BLOCK, end-i), order);
+        }
+    });
+    return JKMP::reduceCentralSumsPartials(partials.data(), blocks);
+}
+
+double jkmpStatisticsSum(JKMathParser *p, const double *data, size_t n)
+{
+    return jkmpReduceSum(p, data, n, false);
+}
+
+double jkmpStatisticsSum2(JKMathParser *p, const double *data, size_t n)
+{
+    return jkmpReduceSum(p, data, n, true);
+}
+
+double jkmpStatisticsAverage(JKMathParser *p, const double *data, size_t n)
+{
+    size_t cnt=0;
+    const double sum=jkmpReduceSum(p, data, n, false, &cnt);
+    if (cnt==0) return 0;
+    return sum/double(cnt);
+}
+
+double jkmpStatisticsVariance(JKMathParser *p, const double *data, size_t n)
+{
+    if (n<=1) return 0;
+    const JKMP::CentralSums s=jkmpReduceCentralSums(p, data, n, 2);
+    if (s.count()<=1) return 0;
+    return s.centralSum(2)/(s.count()-1.0);
+}
+
+double jkmpStatisticsStdDev(JKMathParser *p, const double *data, size_t n)
+{
+    return sqrt(jkmpStatisticsVariance(p, data, n));
+}
+
+double jkmpStatisticsSkewness(JKMathParser *p, const double *data, size_t n)
+{
+    const JKMP::CentralSums s=jkmpReduceCentralSums(p, data, n, 3);
+    if (s.count()<=1) return 0;
+    return s.centralMoment(3)/pow(s.centralMoment(2), 1.5);
+}
+
+double jkmpStatisticsCentralMoment(JKMathParser *p, const double *data, size_t n, int order)
+{
+    if (order>=0 && order<=JKMP_CENTRALSUMS_MAXORDER) {
+        const JKMP::CentralSums s=jkmpReduceCentralSums(p, data, n, order);
+        if (s.count()<=0) return 0;
+        return s.centralMoment(order);
+    }
+    // other orders: sum up the powers of the deviations from the mean in a second pass
+    const JKMP::CentralSums s=jkmpReduceCentralSums(p, data, n, 1);
+    if (s.count()<=0) return 0;
+    const double mean=s.mean();
+    JKMP::vector<double> dev(n, 0.0);
+    jkmpParallelVectorFor(p, n, [&](size_t start, size_t end) {
+        for (size_t i=start; i<end; i++) dev[i]=(JKMP_FloatIsOK(data[i])?pow(data[i]-mean, order):0.0);
+    });
+    return jkmpReduceSum(p, dev.data(), n, false)/s.count();
+}
@@ -33,6 +33,7 @@
 #include <stdint.h>
 #include "jkmpbase.h"
 #include "jkmpstringtools.h"
+#include "jkmpthreadtools.h"
 
 class JKMathParser; // forward
 
@@ -192,6 +193,7 @@ struct JKMPLIB_EXPORT jkmpResult {
         JKMPLIB_EXPORT void setStruct(const JKMP::stringVector& items=JKMP::stringVector());
         JKMPLIB_EXPORT void setList(int items=0);
         JKMPLIB_EXPORT void setList(const std::vector<jkmpResult>& dat);
+        JKMPLIB_EXPORT void setList(const JKMP::sharedvector<jkmpResult>& dat);
 
         JKMPLIB_EXPORT void setBoolVec(const std::vector<bool>& val);
         JKMPLIB_EXPORT void setBoolVec(int size=0, bool defaultVal=false);
@@ -291,7 +293,7 @@ struct JKMPLIB_EXPORT jkmpResult {
         /** \brief returns an entry from a struct */
         JKMPLIB_EXPORT void setStructItem(const JKMP::string& item, const jkmpResult& value);
         /** \brief returns an entry from a struct */
-        JKMPLIB_EXPORT void setStruct(const JKMP::map<JKMP::string,jkmpResult>& data);
+        JKMPLIB_EXPORT void setStruct(const JKMP::flatmap<JKMP::string,jkmpResult>& data);
 
         /** \brief returns an entry from a jkmptList */
         JKMPLIB_EXPORT jkmpResult getListItem(int item) const;
@@ -342,8 +344,8 @@ struct JKMPLIB_EXPORT jkmpResult {
         JKMP::vector<double> numVec; /*!< \brief contains result if \c type==jkmpDoubleVector */
         JKMP::stringVector strVec;
         JKMP::vector<bool> boolVec;
-        JKMP::map<JKMP::string,jkmpResult> structData;
-        JKMP::vector<jkmpResult> listData;
+        JKMP::flatmap<JKMP::string,jkmpResult> structData; /*!< \brief contains result if \c type==jkmpStruct (sorted by item name) */
+        JKMP::sharedvector<jkmpResult> listData; /*!< \brief contains result if \c type==jkmpList (copies share their items) */
         int matrix_columns;
 
 
@@ -351,6 +353,81 @@ struct JKMPLIB_EXPORT jkmpResult {
 };
 
 
+/** \brief number of vector items per chunk of a parallel element-wise operation, see jkmpParallelVectorFor()
+ *
+ *  This has to be a multiple of 64, so the chunks of a JKMP::vector<bool> never share a word.
+ */
+#ifndef JKMATHPARSER_PARALLELVECTOR_GRAIN
+#  define JKMATHPARSER_PARALLELVECTOR_GRAIN 16384
+#endif
+
+/** \brief default of JKMathParser::setParallelVectorThreshold() */
+#ifndef JKMATHPARSER_PARALLELVECTOR_THRESHOLD
+#  define JKMATHPARSER_PARALLELVECTOR_THRESHOLD 131072
+#endif
+
+/** \brief returns the thread pool of \a p, if an element-wise operation on \a count vector items should run in parallel
+ *         (see JKMathParser::setParallelVectorThreshold() ), otherwise \c NULL */
+JKMPLIB_EXPORT JKMP::threadPool* jkmpParallelVectorPool(JKMathParser* p, size_t count);
+
+/** \brief calls \a task(start, end) for chunks <code>[start,end)</code> that cover the items <code>[0,count)</code> of an element-wise vector operation
+ *
+ *  Vectors with less than JKMathParser::getParallelVectorThreshold() items (or \c p==NULL ) are processed by a single call
+ *  <code>task(0, count)</code> on the calling thread. Larger vectors are split into chunks of JKMATHPARSER_PARALLELVECTOR_GRAIN items,
+ *  which run on the thread pool of \a p. \a task may only write the items <code>[start,end)</code> of its output and has to be reentrant.
+ *  As every item is computed by the same code, the results do not depend on the number of threads.
+ *
+ *  The JKMATHPARSER_DEFINE_..._NUMERIC_FUNC macros call their C-function from this loop, so it must not modify global state: e.g.
+ *  use JKMP::logGamma() instead of \c ::lgamma() , which writes the global variable \c signgam .
+ */
+template <class F>
+inline void jkmpParallelVectorFor(JKMathParser* p, size_t count, const F& task) {
+    JKMP::threadPool* pool=(p && count>=2*JKMATHPARSER_PARALLELVECTOR_GRAIN)?jkmpParallelVectorPool(p, count):NULL;
+    if (pool) {
+        pool->parallelFor(int64_t(count), JKMATHPARSER_PARALLELVECTOR_GRAIN, [&task](int64_t start, int64_t end, int) { task(size_t(start), size_t(end)); });
+    } else {
+        task(size_t(0), count);
+    }
+}
+
+/** \brief summation algorithm of the reductions \c sum(...) , \c mean(...) , ... of a JKMathParser, see JKMathParser::setSummationMode() */
+enum jkmpSummationMode {
+    jkmpPairwiseSummation=0, /*!< \brief pairwise summation (default), the rounding error grows with \c log(n) */
+    jkmpKahanSummation=1     /*!< \brief compensated (Kahan) summation, the rounding error does not grow with \c n , but it takes about twice as long */
+};
+
+/** \brief returns the sum of the \a n items in \a data (or of their squares, if \a squares is \c true ), using the summation mode of \a p
+ *
+ *  This is JKMP::reduceSum(), but for large arrays the blocks of JKMP_REDUCE_BLOCK items are summed on the thread pool of \a p
+ *  (see jkmpParallelVectorFor() ). The result does not depend on the number of threads. \a p may be \c NULL (pairwise summation, single thread).
+ *  Non-finite items are skipped. If \a count is not \c NULL , the number of finite items is stored there.
+ */
+JKMPLIB_EXPORT double jkmpReduceSum(JKMathParser* p, const double* data, size_t n, bool squares=false, size_t* count=NULL);
+
+/** \name reductions of JKMathParser
+ *
+ *  These replace the StatisticsTools functions of the same name (without \c jkmp prefix) in the default library. They use jkmpReduceSum()
+ *  and the single-pass, numerically stable JKMP::reduceCentralSums(), with the blocks computed on the thread pool of \a p .
+ *  As in StatisticsTools, non-finite items (\c NAN , \c +/-INF ) are skipped and \c n is the number of the finite items.
+ */
+/**@{*/
+/** \brief sum of the items */
+JKMPLIB_EXPORT double jkmpStatisticsSum(JKMathParser* p, const double* data, size_t n);
+/** \brief sum of the squares of the items */
+JKMPLIB_EXPORT double jkmpStatisticsSum2(JKMathParser* p, const double* data, size_t n);
+/** \brief mean of the items (\c 0 for \c n==0 ) */
+JKMPLIB_EXPORT double jkmpStatisticsAverage(JKMathParser* p, const double* data, size_t n);
+/** \brief sample variance <code>sum((x-mean)^2)/(n-1)</code> of the items (\c 0 for \c n<=1 ) */
+JKMPLIB_EXPORT double jkmpStatisticsVariance(JKMathParser* p, const double* data, size_t n);
+/** \brief sample standard deviation <code>sqrt(jkmpStatisticsVariance())</code> of the items */
+JKMPLIB_EXPORT double jkmpStatisticsStdDev(JKMathParser* p, const double* data, size_t n);
+/** \brief skewness <code>m3/m2^1.5</code> of the items, where \c mk are the central moments (\c 0 for \c n<=1 ) */
+JKMPLIB_EXPORT double jkmpStatisticsSkewness(JKMathParser* p, const double* data, size_t n);
+/** \brief central moment <code>sum((x-mean)^order)/n</code> of the items (\c 0 for \c n==0 ) */
+JKMPLIB_EXPORT double jkmpStatisticsCentralMoment(JKMathParser* p, const double* data, size_t n, int order);
+/**@}*/
+
+
 
 
 
@@ -368,7 +445,8 @@ struct JKMPLIB_EXPORT jkmpResult {
     The resulting function will:
       - check the number of arguments
       - apply the C-function to any number parameter
-      - apply the C-function item-wise to any number vector parameter
+      - apply the C-function item-wise to any number vector parameter (large vectors in parallel, see jkmpParallelVectorFor(),
+        so the C-function has to be reentrant)
     .
 
     \param FName name of the function to declare
@@ -378,7 +456,7 @@ struct JKMPLIB_EXPORT jkmpResult {
 #define JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return ;\
     }\
@@ -386,11 +464,13 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
         r.setDouble(CFUNC(params[0].num));\
     } else if(params[0].type==jkmpDoubleVector) {\
         r.setDoubleVec(params[0].numVec.size());\
-        for (size_t i=0; i<params[0].numVec.size(); i++) {\
-            r.numVec[i]=CFUNC(params[0].numVec[i]);\
-        }\
+        jkmpParallelVectorFor(p, params[0].numVec.size(), [&](size_t start, size_t end) {\
+            for (size_t i=start; i<end; i++) {\
+                r.numVec[i]=CFUNC(params[0].numVec[i]);\
+            }\
+        });\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
 }
@@ -398,6 +478,36 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 /** \brief same as JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC(FName, NAME_IN_PARSER, CFUNC), but NAME_IN_PARSER==CFUNC */
 #define JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_SIMPLE(FName, CFUNC) JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC(FName, CFUNC, CFUNC)
 
+/*! \brief same as JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC(FName, NAME_IN_PARSER, CFUNC), but a vector of numbers is processed
+           by a single call of the vectorized function \c VECFUNC(double* out, const double* in, size_t n) , e.g. JKMP::vecSin()
+
+    Register \a VECFUNC with JKMathParser::setVectorFunction() as well, so the fused evaluation of vector expressions returns the same results.
+
+    \param FName name of the function to declare
+    \param NAME_IN_PARSER name the function should have in the parser (used for error messages only)
+    \param CFUNC name of the C function to call for a single number
+    \param VECFUNC name of the vectorized C function to call for a vector of numbers
+*/
+#define JKMATHPARSER_DEFINE_1PARAM_NUMERIC_FUNC_VEC(FName, NAME_IN_PARSER, CFUNC, VECFUNC) \
+static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
+    if (n!=1) {\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        r.setInvalid();\
+        return ;\
+    }\
+    if (params[0].type==jkmpDouble) {\
+        r.setDouble(CFUNC(params[0].num));\
+    } else if(params[0].type==jkmpDoubleVector) {\
+        r.setDoubleVec(params[0].numVec.size());\
+        jkmpParallelVectorFor(p, params[0].numVec.size(), [&](size_t start, size_t end) {\
+            VECFUNC(r.numVec.data()+start, params[0].numVec.data()+start, end-start);\
+        });\
+    } else {\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
+        r.setInvalid();\
+    }\
+}
+
 
 
 /*! \brief This macro allows to easily define functions for JKMathParser from a C-function that
@@ -415,14 +525,14 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_1PARAM_NUMERICVEC_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if(params[0].type==jkmpDoubleVector) {\
         r.setDoubleVec(CFUNC(params[0].numVec));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x) argument has to be vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -445,7 +555,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_1PARAM_VECTOR_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -456,7 +566,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     } else if(params[0].type==jkmpBoolVector) {\
         r.setBoolVec(CFUNC(params[0].boolVec));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x) argument has to be a vector of numbers/booleans/strings").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a vector of numbers/booleans/strings").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -480,7 +590,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_1PARAM_VECTORORSTRING_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -493,7 +603,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     } else if(params[0].type==jkmpString) {\
         r.setString(CFUNC(params[0].str));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x) argument has to be a vector of numbers/booleans/strings, or a string").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a vector of numbers/booleans/strings, or a string").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -514,14 +624,14 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_1PARAM_VECTONUM_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if(params[0].type==jkmpDoubleVector) {\
         r.setDouble(CFUNC(params[0].numVec));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x) argument has to be a vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -542,14 +652,14 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_1PARAM_VECTONUM_CFUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if(params[0].type==jkmpDoubleVector) {\
         r.setDouble(CFUNC(params[0].numVec.data(), params[0].numVec.size()));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x) argument has to be a vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -574,7 +684,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_1PARAM_VECORNUMTONUM_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -583,7 +693,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     } if(params[0].type==jkmpDouble) {\
         r.setDouble(CFUNC(JKMP::vector<double>::construct(params[0].num)));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x) argument has to be a vector of numbers or a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a vector of numbers or a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -607,7 +717,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_1PARAM_VECORNUMTONUM_CFUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -617,7 +727,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
         JKMP::vector<double> d(1, params[0].num); \
         r.setDouble(CFUNC(d.data(), d.size()));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x) argument has to be a vector of numbers or a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x) argument has to be a vector of numbers or a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -641,7 +751,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n<1) {\
-        p->jkmpError(JKMP::_("%1(x1, x2, ...) needs at least 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x1, x2, ...) needs at least 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -655,14 +765,14 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
             } else if (params[i].type==jkmpDoubleVector) {\
                 d<<params[i].numVec;     \
             } else {\
-                p->jkmpError(JKMP::_("%1(x1, x2, ...) argument %2 has to be a vector of numbers or a number").arg(#NAME_IN_PARSER).arg(i+1));\
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x1, x2, ...) argument %2 has to be a vector of numbers or a number").arg(#NAME_IN_PARSER).arg(i+1));\
                 r.setInvalid();\
                 return; \
             }\
         } \
         r.setDouble(CFUNC(d));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x1, x2, ...) argument 1 has to be a vector of numbers or a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x1, x2, ...) argument 1 has to be a vector of numbers or a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -686,13 +796,13 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n<1) {\
-        p->jkmpError(JKMP::_("%1(x1, x2, ...) needs at least 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x1, x2, ...) needs at least 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if(n==1 && params[0].type==jkmpDoubleVector) {\
         r.setDouble(CFUNC(params[0].numVec.data(), params[0].numVec.size()));\
-    } if( n>=1) {\
+    } else if( n>=1) {\
         JKMP::vector<double> d; \
         for (unsigned int i=0; i<n; i++) {\
             if (params[i].type==jkmpDouble) { \
@@ -700,14 +810,50 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
             } else if (params[i].type==jkmpDoubleVector) {\
                 d<<params[i].numVec;     \
             } else {\
-                p->jkmpError(JKMP::_("%1(x1, x2, ...) argument %2 has to be a vector of numbers or a number").arg(#NAME_IN_PARSER).arg(i+1));\
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x1, x2, ...) argument %2 has to be a vector of numbers or a number").arg(#NAME_IN_PARSER).arg(i+1));\
                 r.setInvalid();\
                 return; \
             }\
         } \
         r.setDouble(CFUNC(d.data(), d.size()));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x1, x2, ...) argument 1 has to be a vector of numbers or a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x1, x2, ...) argument 1 has to be a vector of numbers or a number").arg(#NAME_IN_PARSER));\
+        r.setInvalid();\
+    }\
+    return; \
+}
+
+/*! \brief like JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_CFUNC(), but the C-function gets the JKMathParser as first argument, e.g. jkmpStatisticsSum()
+
+    \param FName name of the function to declare
+    \param NAME_IN_PARSER name the function should have in the parser (used for error messages only)
+    \param CFUNC name of the C function to call
+*/
+#define JKMATHPARSER_DEFINE_1PARAM_VECORNUMSTONUM_PFUNC(FName, NAME_IN_PARSER, CFUNC) \
+static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
+    if (n<1) {\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x1, x2, ...) needs at least 1 argument").arg(#NAME_IN_PARSER));\
+        r.setInvalid();\
+        return; \
+    }\
+    if(n==1 && params[0].type==jkmpDoubleVector) {\
+        r.setDouble(CFUNC(p, params[0].numVec.data(), params[0].numVec.size()));\
+    } else if( n>=1) {\
+        JKMP::vector<double> d; \
+        for (unsigned int i=0; i<n; i++) {\
+            if (params[i].type==jkmpDouble) { \
+                d<<params[i].num;     \
+            } else if (params[i].type==jkmpDoubleVector) {\
+                d<<params[i].numVec;     \
+            } else {\
+                JKMATHPARSER_ERROR(p, JKMP::_("%1(x1, x2, ...) argument %2 has to be a vector of numbers or a number").arg(#NAME_IN_PARSER).arg(i+1));\
+                r.setInvalid();\
+                return; \
+            }\
+        } \
+        r.setDouble(CFUNC(p, d.data(), d.size()));\
+    } else {\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x1, x2, ...) argument 1 has to be a vector of numbers or a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -730,14 +876,14 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_2PARAM1VEC_VECTONUM_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if(params[0].type==jkmpDoubleVector && params[1].type==jkmpDouble) {\
         r.setDouble(CFUNC(params[0].numVec, params[1].num));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -760,14 +906,36 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_2PARAM1VEC_VECTONUM_CFUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if(params[0].type==jkmpDoubleVector && params[1].type==jkmpDouble) {\
         r.setDouble(CFUNC(params[0].numVec.data(), params[0].numVec.size(), params[1].num));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
+        r.setInvalid();\
+    }\
+    return; \
+}
+
+/*! \brief like JKMATHPARSER_DEFINE_2PARAM1VEC_VECTONUM_CFUNC(), but the C-function gets the JKMathParser as first argument, e.g. jkmpStatisticsCentralMoment()
+
+    \param FName name of the function to declare
+    \param NAME_IN_PARSER name the function should have in the parser (used for error messages only)
+    \param CFUNC name of the C function to call
+*/
+#define JKMATHPARSER_DEFINE_2PARAM1VEC_VECTONUM_PFUNC(FName, NAME_IN_PARSER, CFUNC) \
+static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
+    if (n!=2) {\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
+        r.setInvalid();\
+        return; \
+    }\
+    if(params[0].type==jkmpDoubleVector && params[1].type==jkmpDouble) {\
+        r.setDouble(CFUNC(p, params[0].numVec.data(), params[0].numVec.size(), params[1].num));\
+    } else {\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -789,7 +957,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_2PARAM1VEC2POSVEC_VECTONUM_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -802,7 +970,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
         }\
         r.setDoubleVec(res);\
     } else {\
-        p->jkmpError(JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -826,7 +994,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_2PARAM1VEC2POSVEC_VECTONUM_CFUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -839,7 +1007,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
         }\
     r.setDoubleVec(res);\
     } else {\
-        p->jkmpError(JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -862,7 +1030,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_2PARAM1NUM2VEC_VECTONUM_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -875,7 +1043,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
         }\
         r.setDoubleVec(res);\
     } else {\
-        p->jkmpError(JKMP::_("%1(x, p) argument x has to be a number or a vector of numbers and p a vector of number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) argument x has to be a number or a vector of numbers and p a vector of number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -899,7 +1067,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_2PARAM1NUM2VEC_VECTONUM_CFUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) needs exacptly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -912,7 +1080,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
         }\
         r.setDoubleVec(res);\
     } else {\
-        p->jkmpError(JKMP::_("%1(x, p) argument x has to be a number or a vector of numbers and p a vector of number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) argument x has to be a number or a vector of numbers and p a vector of number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -935,14 +1103,14 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_3PARAM1VEC_VECTONUM_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=3) {\
-        p->jkmpError(JKMP::_("%1(x, p1, p2) needs exacptly 3 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p1, p2) needs exacptly 3 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if(params[0].type==jkmpDoubleVector && params[1].type==jkmpDouble && params[2].type==jkmpDouble) {\
         r.setDouble(CFUNC(params[0].numVec, params[1].num, params[2].num));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -965,14 +1133,14 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_3PARAM1VEC_VECTONUM_CFUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=3) {\
-        p->jkmpError(JKMP::_("%1(x, p1, p2) needs exacptly 3 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p1, p2) needs exacptly 3 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if(params[0].type==jkmpDoubleVector && params[1].type==jkmpDouble && params[2].type==jkmpDouble) {\
         r.setDouble(CFUNC(params[0].numVec.data(), params[0].numVec.size(), params[1].num, params[2].num));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, p) argument x has to be a vector of numbers and p a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -993,14 +1161,14 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_2PARAM2VEC_VECTONUM_FUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(x, y) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, y) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if(params[0].type==jkmpDoubleVector && params[1].type==jkmpDoubleVector) {\
         r.setDouble(CFUNC(params[0].asVector(), params[1].asVector()));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x, y) arguments x and y have to be a vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, y) arguments x and y have to be a vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1021,7 +1189,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_2PARAM2VEC_VECTONUM_CFUNC(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(x, y) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, y) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1030,7 +1198,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
         JKMP::vector<double> p2=params[1].asVector(); \
         r.setDouble(CFUNC(p1.data(), p1.size(), p2.data(), p2.size()));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x, y) arguments x and y have to be a vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, y) arguments x and y have to be a vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1051,7 +1219,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 #define JKMATHPARSER_DEFINE_2PARAM2VEC_VECTONUM_CFUNC_1N(FName, NAME_IN_PARSER, CFUNC) \
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(x, y) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, y) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1060,7 +1228,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
         JKMP::vector<double> p2=params[1].asVector(); \
         r.setDouble(CFUNC(p1.data(), p2.data(), std::min(p1.size(),p2.size())));\
     } else {\
-        p->jkmpError(JKMP::_("%1(x, y) arguments x and y have to be a vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(x, y) arguments x and y have to be a vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1085,7 +1253,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.type=jkmpString;\
     r.isValid=true;\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1097,7 +1265,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
             r.strVec[i]=CFUNC(params[0].strVec[i]);\
         }\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) argument has to be a string or string-vector").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) argument has to be a string or string-vector").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1127,14 +1295,14 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.strVec.clear();\
     r.isValid=true;\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if (params[0].type==jkmpString) {\
         r.strVec=CFUNC(params[0].str);\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) argument has to be a string").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) argument has to be a string").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1148,7 +1316,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     The resulting function will:
       - check the number of arguments
       - apply the C-function to any string parameter
-      - apply the C-function item-wise to any string vector parameter item
+      - apply the C-function item-wise to any string vector parameter item (in parallel for large vectors, so the C-function has to be reentrant, see jkmpParallelVectorFor() )
       - result is also string
     .
 
@@ -1161,7 +1329,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.type=jkmpBool;\
     r.isValid=false;\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1169,11 +1337,13 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
         r.setBoolean(CFUNC(params[0].num));\
     } else if (params[0].type==jkmpDoubleVector) {\
         r.setBoolVec(params[0].numVec.size());\
-        for (size_t i=0; i<params[0].numVec.size(); i++) {\
-            r.boolVec[i]=CFUNC(params[0].numVec[i]);\
-        }\
+        jkmpParallelVectorFor(p, params[0].numVec.size(), [&](size_t start, size_t end) {\
+            for (size_t i=start; i<end; i++) {\
+                r.boolVec[i]=CFUNC(params[0].numVec[i]);\
+            }\
+        });\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) argument has to be a number or number-vector").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) argument has to be a number or number-vector").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1203,7 +1373,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.type=jkmpString;\
     r.isValid=true;\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1215,7 +1385,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
             r.strVec[i]=CFUNC(params[0].numVec[i]);\
         }\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) argument has to be a number or number-vector").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) argument has to be a number or number-vector").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1242,7 +1412,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
 static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int  n, JKMathParser* p){\
     r.setInvalid();\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1254,7 +1424,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
             r.numVec[i]=CFUNC(params[0].strVec[i]);\
         }\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) argument has to be a string or string-vector").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) argument has to be a string or string-vector").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1281,7 +1451,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.type=jkmpBool;\
     r.isValid=true;\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1293,7 +1463,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
             r.boolVec[i]=CFUNC(params[0].strVec[i]);\
         }\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) argument has to be a string or string-vector").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) argument has to be a string or string-vector").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1322,7 +1492,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.type=jkmpString;\
     r.isValid=true;\
     if (n!=1) {\
-        p->jkmpError(JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exacptly 1 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1334,7 +1504,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
             r.strVec[i]=CFUNC(params[0].boolVec[i]);\
         }\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) argument has to be a boolean or boolean-vector").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) argument has to be a boolean or boolean-vector").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1351,7 +1521,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     The resulting function will:
       - check the number of arguments
       - apply the C-function to any number parameter
-      - apply the C-function item-wise to any number vector parameter
+      - apply the C-function item-wise to any number vector parameter (in parallel for large vectors, so the C-function has to be reentrant, see jkmpParallelVectorFor() )
       - result is also a number or number vector
     .
     \param FName name of the function to declare
@@ -1363,7 +1533,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.type=jkmpDouble;\
     r.isValid=true;\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(...) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1371,7 +1541,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     if (params[0].type==jkmpDouble) {\
         pa=params[0].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) first argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) first argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1380,11 +1550,13 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     } else if(params[1].type==jkmpDoubleVector) {\
         r.type=jkmpDoubleVector;\
         r.numVec.resize(params[1].numVec.size());\
-        for (size_t i=0; i<params[1].numVec.size(); i++) {\
-            r.numVec[i]=CFUNC(pa, params[1].numVec[i]);\
-        }\
+        jkmpParallelVectorFor(p, params[1].numVec.size(), [&](size_t start, size_t end) {\
+            for (size_t i=start; i<end; i++) {\
+                r.numVec[i]=CFUNC(pa, params[1].numVec[i]);\
+            }\
+        });\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) second argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) second argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1397,7 +1569,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     The resulting function will:
       - check the number of arguments
       - apply the C-function to any number parameter
-      - apply the C-function item-wise to any number vector parameter
+      - apply the C-function item-wise to any number vector parameter (in parallel for large vectors, so the C-function has to be reentrant, see jkmpParallelVectorFor() )
       - result is also a number or number vector
     .
     \param FName name of the function to declare
@@ -1409,7 +1581,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.isValid=true;\
     r.type=jkmpDouble;\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(...) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1417,7 +1589,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     if (params[1].type==jkmpDouble) {\
         pa=params[1].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1426,11 +1598,13 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     } else if(params[0].type==jkmpDoubleVector) {\
         r.type=jkmpDoubleVector;\
         r.numVec.resize(params[0].numVec.size());\
-        for (size_t i=0; i<params[0].numVec.size(); i++) {\
-            r.numVec[i]=CFUNC(params[0].numVec[i], pa);\
-        }\
+        jkmpParallelVectorFor(p, params[0].numVec.size(), [&](size_t start, size_t end) {\
+            for (size_t i=start; i<end; i++) {\
+                r.numVec[i]=CFUNC(params[0].numVec[i], pa);\
+            }\
+        });\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1450,7 +1624,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     The resulting function will:
       - check the number of arguments
       - apply the C-function to any number parameter
-      - apply the C-function item-wise to any number vector parameter
+      - apply the C-function item-wise to any number vector parameter (in parallel for large vectors, so the C-function has to be reentrant, see jkmpParallelVectorFor() )
       - result is also a number or number vector
     .
     \param FName name of the function to declare
@@ -1462,7 +1636,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.isValid=true;\
     r.type=jkmpDouble;\
     if (n!=3) {\
-        p->jkmpError(JKMP::_("%1(...) needs exactly 3 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exactly 3 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1471,14 +1645,14 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     if (params[1].type==jkmpDouble) {\
         pa=params[1].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if (params[2].type==jkmpDouble) {\
         pb=params[2].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) third argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) third argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1487,11 +1661,13 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     } else if(params[0].type==jkmpDoubleVector) {\
         r.type=jkmpDoubleVector;\
         r.numVec.resize(params[0].numVec.size());\
-        for (size_t i=0; i<params[0].numVec.size(); i++) {\
-            r.numVec[i]=CFUNC(params[0].numVec[i], pa, pb);\
-        }\
+        jkmpParallelVectorFor(p, params[0].numVec.size(), [&](size_t start, size_t end) {\
+            for (size_t i=start; i<end; i++) {\
+                r.numVec[i]=CFUNC(params[0].numVec[i], pa, pb);\
+            }\
+        });\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1507,7 +1683,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     The resulting function will:
       - check the number of arguments
       - apply the C-function to any number parameter
-      - apply the C-function item-wise to any number vector parameter
+      - apply the C-function item-wise to any number vector parameter (in parallel for large vectors, so the C-function has to be reentrant, see jkmpParallelVectorFor() )
       - result is also a number or number vector
     .
     \param FName name of the function to declare
@@ -1519,7 +1695,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.isValid=true;\
     r.type=jkmpDouble;\
     if (n!=4) {\
-        p->jkmpError(JKMP::_("%1(...) needs exactly 4 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exactly 4 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1529,21 +1705,21 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     if (params[1].type==jkmpDouble) {\
         pa=params[1].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if (params[2].type==jkmpDouble) {\
         pb=params[2].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) third argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) third argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if (params[3].type==jkmpDouble) {\
         pc=params[3].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) fourth argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) fourth argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1552,11 +1728,13 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     } else if(params[0].type==jkmpDoubleVector) {\
         r.type=jkmpDoubleVector;\
         r.numVec.resize(params[0].numVec.size());\
-        for (size_t i=0; i<params[0].numVec.size(); i++) {\
-            r.numVec[i]=CFUNC(params[0].numVec[i], pa, pb, pc);\
-        }\
+        jkmpParallelVectorFor(p, params[0].numVec.size(), [&](size_t start, size_t end) {\
+            for (size_t i=start; i<end; i++) {\
+                r.numVec[i]=CFUNC(params[0].numVec[i], pa, pb, pc);\
+            }\
+        });\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1570,7 +1748,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     The resulting function will:
       - check the number of arguments
       - apply the C-function to any number parameter
-      - apply the C-function item-wise to any number vector parameter
+      - apply the C-function item-wise to any number vector parameter (in parallel for large vectors, so the C-function has to be reentrant, see jkmpParallelVectorFor() )
       - result is also a number or number vector
     .
     \param FName name of the function to declare
@@ -1582,7 +1760,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.isValid=true;\
     r.type=jkmpDouble;\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(...) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1590,7 +1768,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     if (params[1].type==jkmpDouble) {\
         pa=params[1].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1599,11 +1777,13 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     } else if(params[0].type==jkmpDoubleVector) {\
         r.type=jkmpDoubleVector;\
         r.numVec.resize(params[0].numVec.size());\
-        for (size_t i=0; i<params[0].numVec.size(); i++) {\
-            r.numVec[i]=CFUNC(params[0].numVec[i], pa);\
-        }\
+        jkmpParallelVectorFor(p, params[0].numVec.size(), [&](size_t start, size_t end) {\
+            for (size_t i=start; i<end; i++) {\
+                r.numVec[i]=CFUNC(params[0].numVec[i], pa);\
+            }\
+        });\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1617,7 +1797,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     The resulting function will:
       - check the number of arguments
       - apply the C-function to any number parameter
-      - apply the C-function item-wise to any number vector parameter
+      - apply the C-function item-wise to any number vector parameter (in parallel for large vectors, so the C-function has to be reentrant, see jkmpParallelVectorFor() )
       - result is also a number or number vector
     .
     \param FName name of the function to declare
@@ -1629,7 +1809,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.isValid=true;\
     r.type=jkmpDouble;\
     if (n!=3) {\
-        p->jkmpError(JKMP::_("%1(...) needs exactly 3 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exactly 3 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1638,14 +1818,14 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     if (params[1].type==jkmpDouble) {\
         pa=params[1].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if (params[2].type==jkmpDouble) {\
         pb=params[2].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) third argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) third argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1654,11 +1834,13 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     } else if(params[0].type==jkmpDoubleVector) {\
         r.type=jkmpDoubleVector;\
         r.numVec.resize(params[0].numVec.size());\
-        for (size_t i=0; i<params[0].numVec.size(); i++) {\
-            r.numVec[i]=CFUNC(params[0].numVec[i], pa, pb);\
-        }\
+        jkmpParallelVectorFor(p, params[0].numVec.size(), [&](size_t start, size_t end) {\
+            for (size_t i=start; i<end; i++) {\
+                r.numVec[i]=CFUNC(params[0].numVec[i], pa, pb);\
+            }\
+        });\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1675,7 +1857,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     The resulting function will:
       - check the number of arguments
       - apply the C-function to any number parameter
-      - apply the C-function item-wise to any number vector parameter
+      - apply the C-function item-wise to any number vector parameter (in parallel for large vectors, so the C-function has to be reentrant, see jkmpParallelVectorFor() )
       - result is also a number or number vector
     .
     \param FName name of the function to declare
@@ -1687,7 +1869,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.isValid=true;\
     r.type=jkmpDouble;\
     if (n!=4) {\
-        p->jkmpError(JKMP::_("%1(...) needs exactly 4 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exactly 4 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1697,21 +1879,21 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     if (params[1].type==jkmpDouble) {\
         pa=params[1].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) second argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if (params[2].type==jkmpDouble) {\
         pb=params[2].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) third argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) third argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
     if (params[3].type==jkmpDouble) {\
         pc=params[3].num;\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) fourth argument has to be a number").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) fourth argument has to be a number").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1720,11 +1902,13 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     } else if(params[0].type==jkmpDoubleVector) {\
         r.type=jkmpDoubleVector;\
         r.numVec.resize(params[0].numVec.size());\
-        for (size_t i=0; i<params[0].numVec.size(); i++) {\
-            r.numVec[i]=CFUNC(params[0].numVec[i], pa, pb, pc);\
-        }\
+        jkmpParallelVectorFor(p, params[0].numVec.size(), [&](size_t start, size_t end) {\
+            for (size_t i=start; i<end; i++) {\
+                r.numVec[i]=CFUNC(params[0].numVec[i], pa, pb, pc);\
+            }\
+        });\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
@@ -1738,7 +1922,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     The resulting function will:
       - check the number of arguments
       - apply the C-function to any number parameter
-      - apply the C-function item-wise to any number vector parameter, i.e. [ fmod(x1,y1), fmod(x2,y2), ... ]
+      - apply the C-function item-wise to any number vector parameter, i.e. [ fmod(x1,y1), fmod(x2,y2), ... ] (in parallel for large vectors, so the C-function has to be reentrant, see jkmpParallelVectorFor() )
       - result is also a number or number vector
     .
     \param FName name of the function to declare
@@ -1750,7 +1934,7 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.isValid=true;\
     r.type=jkmpDouble;\
     if (n!=2) {\
-        p->jkmpError(JKMP::_("%1(...) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) needs exactly 2 argument").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
         return; \
     }\
@@ -1758,17 +1942,19 @@ static inline void FName(jkmpResult& r, const jkmpResult* params, unsigned int
     r.num=CFUNC(params[0].num, params[1].num);\
     } else if(params[0].type==jkmpDoubleVector && params[1].type==jkmpDoubleVector) {\
         if (params[0].numVec.size()!=params[1].numVec.size()) {\
-            p->jkmpError(JKMP::_("%1(x,y) both arguments have to have same length").arg(#NAME_IN_PARSER));\
+            JKMATHPARSER_ERROR(p, JKMP::_("%1(x,y) both arguments have to have same length").arg(#NAME_IN_PARSER));\
             r.setInvalid();\
             return; \
         }\
         r.type=jkmpDoubleVector;\
         r.numVec.resize(params[0].numVec.size());\
-        for (size_t i=0; i<params[0].numVec.size(); i++) {\
-            r.numVec[i]=CFUNC(params[0].numVec[i], params[1].numVec[i]);\
-        }\
+        jkmpParallelVectorFor(p, params[0].numVec.size(), [&](size_t start, size_t end) {\
+            for (size_t i=start; i<end; i++) {\
+                r.numVec[i]=CFUNC(params[0].numVec[i], params[1].numVec[i]);\
+            }\
+        });\
     } else {\
-        p->jkmpError(JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
+        JKMATHPARSER_ERROR(p, JKMP::_("%1(...) first argument has to be a number or vector of numbers").arg(#NAME_IN_PARSER));\
         r.setInvalid();\
     }\
     return; \
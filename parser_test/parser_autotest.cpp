@@ -8,6 +8,8 @@
 #include <stdlib.h>
 #include <algorithm>
 #include <limits>
+#include <thread>
+#include <atomic>
 #include "ticktock.h"
 
 #ifdef _WINDOWS_
@@ -57,6 +59,164 @@ T foreach_apply(const T& input, F f) {
     return res;
 }
 
+/** \brief difference between \a x and the reference \a ref in ULP of \a ref */
+double ulp_distance(double x, double ref) {
+    return fabs(x-ref)/(nextafter(fabs(ref), INFINITY)-fabs(ref));
+}
+
+/** \brief maximum difference (in ULP of the libm result) between the vectorized kernel \a vec and the libm function \a libm for \a n arguments in [\a xmin, \a xmax] */
+double vecmath_max_ulp(void (*vec)(double*, const double*, size_t), double (*libm)(double), double xmin, double xmax, size_t n) {
+    std::vector<double> x(n), y(n);
+    for (size_t i=0; i<n; i++) x[i]=xmin+(xmax-xmin)*double(i)/double(n-1);
+    vec(y.data(), x.data(), n);
+    double maxULP=0;
+    for (size_t i=0; i<n; i++) {
+        maxULP=std::max(maxULP, ulp_distance(y[i], libm(x[i])));
+    }
+    return maxULP;
+}
+
+/** \brief evaluates \a expr with serial and with parallel (4 threads) element-wise vector operations and reductions and returns whether the results (with at least \a minLength items) are equal */
+bool parallel_vector_equal(JKMathParser& parser, const JKMP::string& expr, size_t minLength=100000) {
+    JKMathParser::jkmpNode* n=parser.parse(expr);
+    parser.setParallelVectorThreshold(0);
+    const jkmpResult serial=n->evaluate();
+    parser.setThreadCount(4);
+    parser.setParallelVectorThreshold(1);
+    const jkmpResult parallel=n->evaluate();
+    parser.setThreadCount(0);
+    parser.setParallelVectorThreshold(JKMATHPARSER_PARALLELVECTOR_THRESHOLD);
+    delete n;
+    return serial.isValid && serial.length()>=minLength && serial==parallel;
+}
+
+/** \brief evaluates \a expr with JKMP::regExpMatcher and with std::regex only (see JKMathParser::setFastRegExp() ) and compares the results */
+bool fast_regexp_equal(JKMathParser& parser, const JKMP::string& expr) {
+    JKMathParser::jkmpNode* n=parser.parse(expr);
+    parser.setFastRegExp(false);
+    const jkmpResult slow=n->evaluate();
+    parser.setFastRegExp(true);
+    const jkmpResult fast=n->evaluate();
+    delete n;
+    return slow.isValid && slow==fast;
+}
+
+/** \brief maximum difference between the FFT convolution of JKMP::convolve() and the direct sums for \a nx and \a ny items */
+double fft_convolve_max_error(size_t nx, size_t ny) {
+    std::vector<double> x(nx), y(ny), direct(nx+ny-1), fast(nx+ny-1);
+    for (size_t i=0; i<nx; i++) x[i]=sin(double(i*i));
+    for (size_t i=0; i<ny; i++) y[i]=cos(double(i));
+    const JKMP::fftPlan plan(JKMP::fftPlan::goodSize(nx+ny-1));
+    JKMP::convolve(x.data(), nx, y.data(), ny, direct.data(), NULL);
+    JKMP::convolve(x.data(), nx, y.data(), ny, fast.data(), &plan);
+    double maxErr=0;
+    for (size_t i=0; i<direct.size(); i++) maxErr=std::max(maxErr, fabs(direct[i]-fast[i]));
+    return maxErr;
+}
+
+/** \brief takes ownership of the parse tree \a n, so a test can evaluate it within a single expression without leaking it */
+std::unique_ptr<JKMathParser::jkmpNode> owned_tree(JKMathParser::jkmpNode* n) {
+    return std::unique_ptr<JKMathParser::jkmpNode>(n);
+}
+
+/** \brief interns \a n new identifiers on each of \a threads threads (i.e. over several chunks of the symbol table) and returns whether
+ *         symbolName() returned the names of all symbols, also while the other threads were adding names */
+bool intern_symbols_concurrently(size_t n, int threads) {
+    std::atomic<int> errors(0);
+    std::vector<std::thread> workers;
+    for (int t=0; t<threads; t++) {
+        workers.push_back(std::thread([n, t, &errors]() {
+            std::vector<JKMathParser::jkmpSymbol> symbols;
+            for (size_t i=0; i<n; i++) {
+                const JKMP::string name=JKMP::string("symbolTableTest_%1_%2").arg(t).arg(static_cast<int>(i));
+                symbols.push_back(JKMathParser::internSymbol(name));
+                if (JKMathParser::symbolName(symbols[i])!=name || JKMathParser::symbolName(symbols[i/2])!=JKMP::string("symbolTableTest_%1_%2").arg(t).arg(static_cast<int>(i/2))) errors++;
+            }
+        }));
+    }
+    for (size_t t=0; t<workers.size(); t++) workers[t].join();
+    return errors==0;
+}
+
+/** \brief number of destroyed counted_node objects */
+int counted_node_deletions=0;
+
+/** \brief constant node that counts its destructions, used to check that trees and function bodies are deleted */
+class counted_node: public JKMathParser::jkmpConstantNode {
+    public:
+        explicit counted_node(double value, JKMathParser* p): JKMathParser::jkmpConstantNode(jkmpResult(value), p, NULL) {}
+        virtual ~counted_node() { counted_node_deletions++; }
+        virtual JKMathParser::jkmpNode* copy(JKMathParser::jkmpNode* par=NULL) {
+            JKMathParser::jkmpNode* n=new counted_node(evaluate().num, getParser());
+            n->setParent(par);
+            return n;
+        }
+};
+
+/** \brief builds a chain of \a depth unary nodes around a counted_node and deletes it with jkmpNode::deleteTree(). The nodes are allocated
+ *         from the heap (\a mode==0), from one arena (\a mode==1) or alternately from the heap and from an own arena per node (\a mode==2).
+ *         Returns whether the counted_node was deleted. */
+bool delete_deep_tree(JKMathParser& parser, size_t depth, int mode) {
+    counted_node_deletions=0;
+    JKMathParser::jkmpNode* n=NULL;
+    if (mode==1) {
+        JKMathParser::jkmpNodeArenaScope arenaScope;
+        n=new counted_node(1, &parser);
+        for (size_t i=0; i<depth; i++) n=new JKMathParser::jkmpUnaryNode('-', n, &parser, NULL);
+    } else {
+        n=new counted_node(1, &parser);
+        for (size_t i=0; i<depth; i++) {
+            if (mode==2 && i%2==0) {
+                JKMathParser::jkmpNodeArenaScope arenaScope;
+                n=new JKMathParser::jkmpUnaryNode('-', n, &parser, NULL);
+            } else {
+                n=new JKMathParser::jkmpUnaryNode('-', n, &parser, NULL);
+            }
+        }
+    }
+    JKMathParser::jkmpNode::deleteTree(n);
+    return counted_node_deletions==1;
+}
+
+/** \brief number of calls of flat_count() */
+int flat_count_calls=0;
+
+/** \brief C-function that counts its calls and returns its first parameter */
+void flat_count(jkmpResult& r, const jkmpResult* params, unsigned int n, JKMathParser* /*p*/) {
+    flat_count_calls++;
+    if (n>0) r=params[0];
+    else r.setInvalid();
+}
+
+/** \brief function that works on its parameter nodes and returns the sum of their values */
+void flat_sum_nodes(jkmpResult& r, JKMathParser::jkmpNode** params, unsigned int n, JKMathParser* /*p*/) {
+    double sum=0;
+    for (unsigned int i=0; i<n; i++) sum+=params[i]->evaluate().num;
+    r.setDouble(sum);
+}
+
+/** \brief creates the flat program of \a expr, which calls the C-function \a name, then redefines \a name as flat_sum_nodes() and runs the
+ *         program. Returns the result, \a calls receives the number of calls of flat_count() */
+jkmpResult flat_eval_redefined(JKMathParser& parser, const JKMP::string& expr, const JKMP::string& name, int& calls) {
+    JKMathParser::FlatProgram program;
+    std::unique_ptr<JKMathParser::jkmpNode> n(parser.parse(expr));
+    n->createFlatProgram(program);
+    parser.addFunction(name, flat_sum_nodes);
+    flat_count_calls=0;
+    jkmpResult r;
+    parser.evaluateFlatProgram(r, program);
+    calls=flat_count_calls;
+    return r;
+}
+
+/** \brief evaluates \a expr with the summation mode \a mode (and resets the mode afterwards) */
+double eval_with_summation_mode(JKMathParser& parser, const JKMP::string& expr, jkmpSummationMode mode) {
+    parser.setSummationMode(mode);
+    const double r=parser.evaluate(expr).num;
+    parser.setSummationMode(jkmpPairwiseSummation);
+    return r;
+}
+
 template <class T, typename F>
 T sum(const T& start, const T& end, const T& step, F f) {
     T res;
@@ -299,6 +459,11 @@ int main(int /*argc*/, JKMP::charType */*argv*/[])
     s="1";
     TEST_CPP(s.split(","), JKMP::stringVector::construct("1"), cnt, cntPASS, cntFAIL);
 
+    TEST_CPP_TRUE(JKMathParser::internSymbol("symbolTest")==JKMathParser::internSymbol(JKMP::string("symbol")+"Test"), cnt, cntPASS, cntFAIL);
+    TEST_CPP_FALSE(JKMathParser::internSymbol("symbolTest")==JKMathParser::internSymbol("symboltest"), cnt, cntPASS, cntFAIL);
+    TEST_CPP(JKMathParser::symbolName(JKMathParser::internSymbol("symbolTest")), "symbolTest", cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(intern_symbols_concurrently(3000, 4), cnt, cntPASS, cntFAIL);
+
     qDebug()<<"\n\n========================================================================";
     qDebug()<<" LIBRARY-TEST";
     qDebug()<<" #TESTS    = "<<cnt;
@@ -434,6 +599,8 @@ int main(int /*argc*/, JKMP::charType */*argv*/[])
     TEST_CMPDBLVEC("ff(1:5)", JKMP::vector<double>(1,4,9,16,25),  cnt, cntPASS, cntFAIL);
     TEST_ERROR("ff(true)",  cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("ff(5+5)", 100,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("gg(x)=x+1; gg(1)+gg(2)", 5,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("gg(x)=x*10; gg(1)+gg(2)", 30,  cnt, cntPASS, cntFAIL);
     TEST_VOID("fib(x)=if(x<=1, 1, fib(x-1)+fib(x-2))",  cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("fib(8)", 34,  cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("fib(9)", 55,  cnt, cntPASS, cntFAIL);
@@ -445,6 +612,52 @@ int main(int /*argc*/, JKMP::charType */*argv*/[])
     TEST_CMPSTR("sf(\"cc\", \"bb\")", "cccccc",  cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("sf(1,2)", 4, cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("2*sf(9,1)", 54, cnt, cntPASS, cntFAIL);
+    TEST_CPP(parser.evaluateFlat(owned_tree(parser.parse("fib(12)")).get()).num, 233,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(parser.evaluateFlat(owned_tree(parser.parse("2*sf(9,1)+sf(1,2)")).get()).num, 58,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(parser.evaluateFlat(owned_tree(parser.parse("sf(\"cc\", \"bb\")")).get()).str, std::string("cccccc"),  cnt, cntPASS, cntFAIL);
+    TEST_CPP(parser.evaluateFlat(owned_tree(parser.parse("x=[1,2,3]; cases(x[1]>2, \"a\", x[2]>2, \"b\"+\"c\", \"d\")")).get()).str, std::string("bc"),  cnt, cntPASS, cntFAIL);
+    TEST_CPP(delete_deep_tree(parser, 1000000, 0), true,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(delete_deep_tree(parser, 1000000, 1), true,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(delete_deep_tree(parser, 2000, 2), true,  cnt, cntPASS, cntFAIL);
+    parser.addFunction("countedbody", JKMP::stringVector::construct("x"), new counted_node(3, &parser));
+    TEST_CMPDBL("countedbody(1)+countedbody(2)", 6,  cnt, cntPASS, cntFAIL);
+    counted_node_deletions=0;
+    TEST_CMPDBL("countedbody(x)=2*x; countedbody(2)", 4,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(counted_node_deletions, 1,  cnt, cntPASS, cntFAIL);
+    TEST_VOID("sumto(x)=if(x<=0, 0, x+sumto(x-1))",  cnt, cntPASS, cntFAIL);
+    TEST_CPP(parser.evaluateFlat(owned_tree(parser.parse("sumto(100000)")).get()).num, 5000050000.0,  cnt, cntPASS, cntFAIL);
+    parser.addFunction("flatcount", flat_count);
+    parser.addFunction("flatredef", flat_count);
+    {
+        int calls=0;
+        TEST_CPP(flat_eval_redefined(parser, "flatredef(flatcount(2), flatcount(3))", "flatredef", calls).num, 5,  cnt, cntPASS, cntFAIL);
+        TEST_CPP(calls, 2,  cnt, cntPASS, cntFAIL);
+    }
+    TEST_CPP(owned_tree(parser.parse("x*x+2*x")->specializeTypes())->evaluate().numVec[2], 15,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("x*x")->specializeTypes())->printTree().find("BinaryArithmeticNode[vector,vector]")!=std::string::npos, true,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("x*x"))->printTree().find("BinaryArithmeticNode[vector,vector]")!=std::string::npos, true,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("-x"))->getInferredType(), int(jkmpDoubleVector),  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("!(x>1)"))->getInferredType(), int(jkmpBoolVector),  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("!x"))->getInferredType(), 0,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("~x"))->getInferredType(), 0,  cnt, cntPASS, cntFAIL);
+    parser.setTypeSpecialization(false);
+    TEST_CPP(owned_tree(parser.parse("x*x"))->printTree().find("BinaryArithmeticNode[vector,vector]")==std::string::npos, true,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("x*x+2*x", JKMP::vector<double>::construct(3.0, 8.0, 15.0),  cnt, cntPASS, cntFAIL);
+    parser.setTypeSpecialization(true);
+    TEST_CPP(parser.evaluateFlat(owned_tree(parser.parse("2^3-x[2]/4")->specializeTypes()).get()).num, 7.25,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("x=[1,2]; [1,2,3]+x")->specializeTypes())->evaluate().isValid, false,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("x=[1,2,3]; x=5; x+1")->specializeTypes())->evaluate().num, 6,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("fa=[1,2,3,4]; fb=[4,3,2,1]; 1", 1,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("fa*fb+fa*fa-fb/2")->specializeTypes())->printTree().find("FusedVectorNode (5 operations, 6 operands)")!=std::string::npos, true,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("fa*fb+fa*fa-fb/2")->specializeTypes())->evaluate().numVec[3], 19.5,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("fa*fb+fa*fa-fb/2"))->printTree().find("FusedVectorNode (5 operations, 6 operands)")!=std::string::npos, true,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(parser.evaluate("fa*fb+fa*fa-fb/2").numVec, JKMP::vector<double>::construct(3.0, 8.5, 14.0, 19.5),  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("-sqrt(fa*fa)+1")->specializeTypes())->evaluate().numVec[2], -2,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(fabs(owned_tree(parser.parse("asinh(sinh(fb/4))")->specializeTypes())->evaluate().numVec[0]-1.0)<1e-12, true,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("sin(fa)*0>fa-3")->specializeTypes())->evaluate().boolVec, JKMP::vector<bool>(true,true,false,false),  cnt, cntPASS, cntFAIL);
+    TEST_CMPBOOLVEC("2>[1,2,3]", JKMP::vector<bool>(true,false,false), cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("fa*fb+[1,2]*2")->specializeTypes())->evaluate().isValid, false,  cnt, cntPASS, cntFAIL);
+    TEST_CPP(owned_tree(parser.parse("fa=5; fa*2+1")->specializeTypes())->evaluate().num, 11,  cnt, cntPASS, cntFAIL);
     TEST_ERROR("sf(\"9\",1)", cnt, cntPASS, cntFAIL);
     TEST_CMPSTR("if(pi==3, \"yes\", \"no\")", "no",  cnt, cntPASS, cntFAIL);
     TEST_CMPBOOL("if(pi>=3, true, \"no\")", true,  cnt, cntPASS, cntFAIL);
@@ -465,6 +678,21 @@ int main(int /*argc*/, JKMP::charType */*argv*/[])
     TEST_CMPDBLVEC("for(i,1:10,sin(i))", foreach_apply(JKMP::construct_vector_range<double>(1,10,1), sin),  cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("for(i,1,2,10,cos(i))", foreach_apply(JKMP::construct_vector_range<double>(1,10,2), cos),  cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("cos(1:2:10)", foreach_apply(JKMP::construct_vector_range<double>(1,10,2), cos),  cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(vecmath_max_ulp(JKMP::vecSin, sin, -1e6, 1e6, 100003)<=1.0, cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(vecmath_max_ulp(JKMP::vecCos, cos, -10, 10, 100003)<=1.0, cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(vecmath_max_ulp(JKMP::vecExp, exp, -708, 708, 100003)<=1.0, cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(vecmath_max_ulp(JKMP::vecLog, log, 1e-300, 1e300, 100003)<=1.0, cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(vecmath_max_ulp(JKMP::vecTanh, tanh, -25, 25, 100003)<=2.0, cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(vecmath_max_ulp(JKMP::vecSqrt, sqrt, 0, 1e10, 100003)==0.0, cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("exp([0, 1000, -1000, -inf])", JKMP::vector<double>::construct(1.0, INFINITY, 0.0, 0.0),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("log([1, 0, inf])", JKMP::vector<double>::construct(0.0, -INFINITY, INFINITY),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("sin([0, 1e300, 1e7])", JKMP::vector<double>::construct(0.0, sin(1e300), sin(1e7)),  cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parallel_vector_equal(parser, "x=(1:100000)/7; x*2+x/3-x^0.5+5"), cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parallel_vector_equal(parser, "x=(1:100000)/7; sin(x)+gauss(x,3)+atan2(x,x+1)"), cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parallel_vector_equal(parser, "x=(1:100000)/7; (x>100)&&(x<=5000)"), cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parallel_vector_equal(parser, "x=(1:300000)/7-20000; lgamma(x)"), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("lgamma([5, 0.5, -2.5])", JKMP::vector<double>::construct(lgamma(5.0), lgamma(0.5), lgamma(-2.5)),  cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(owned_tree(parser.parse("exp(-(0:0.01:30))*2+sin(0:0.01:30)")->specializeTypes())->evaluate().numVec==owned_tree(parser.parse("exp(-(0:0.01:30))*2+sin(0:0.01:30)"))->evaluate().numVec, cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("[]", JKMP::vector<double>(),  cnt, cntPASS, cntFAIL);
     TEST_ERROR("vec=1:5; for(vec)", cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("vec=1:5; sum(vec)", 1+2+3+4+5,  cnt, cntPASS, cntFAIL);
@@ -481,14 +709,100 @@ int main(int /*argc*/, JKMP::charType */*argv*/[])
     TEST_CMPDBL("prod(i,1:0.5:5,i)", 1.0*1.5*2.0*2.5*3.0*3.5*4.0*4.5*5.0,  cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("prod(i,1,0.5,5,i)", 1.0*1.5*2.0*2.5*3.0*3.5*4.0*4.5*5.0,  cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("prod(i,1,0.5,5,i^2)", JKMP::sqr(1.0)*JKMP::sqr(1.5)*JKMP::sqr(2.0)*JKMP::sqr(2.5)*JKMP::sqr(3.0)*JKMP::sqr(3.5)*JKMP::sqr(4.0)*JKMP::sqr(4.5)*JKMP::sqr(5.0),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum(i,1,200000,i)", 200000.0*200001.0/2.0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum(i,200000:(-1):1,[i,1])", 200000.0*200001.0/2.0+200000.0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum(i,5,1,i)", 0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("filterfor(i,1,2,10,i>5)", JKMP::vector<double>::construct(7,9),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("for(i,0:0.3:1,i*10)", foreach_apply(JKMP::construct_vector_range<double>(0,1,0.3), [](double f) { return f*10.0;}),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("2*(0:0.3:10)-1", foreach_apply(JKMP::construct_vector_range<double>(0,10,0.3), [](double f) { return 2.0*f-1.0;}),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("(1:4)*[4,3,2,1]+1", JKMP::vector<double>::construct(5,7,7,5),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum(2*(1:100000)-1)", 100000.0*100000.0,  cnt, cntPASS, cntFAIL);
+    TEST_ERROR("(1:3)*[1,2]+1", cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("0:(pi/5):(2*pi)", JKMP::construct_vector_range<double>(0,2.0*M_PI, M_PI/5.0),  cnt, cntPASS, cntFAIL);
     TEST_ERROR("0:pi/5:2*pi", cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum(i,1,1000,i^2)", 333833500.0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("for(i,1,5,if(i>2,i,-i))", JKMP::vector<double>::construct(-1,-2,3,4,5),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("x=2; sum(i,1,3,x*i)", 12,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum(i,1,3,i=i+1)", 9,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("savefor(i,1,4,i*i)", JKMP::vector<double>::construct(1,4,9,16),  cnt, cntPASS, cntFAIL);
+    parser.setParallelLoops(true);
+    parser.setThreadCount(4);
+    TEST_CMPDBL("sum(i,1,100000,i^2)", 333338333350000.0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("for(i,1,1000,2*i)", foreach_apply(JKMP::construct_vector_range<double>(1,1000), [](double f) { return f*2.0;}),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("f(a)=a^2+1; sum(i,1,10000,f(i))", 333383345000.0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("y=3; sum(i,1,1000,sum(j,1,10,y*i*j))", 3.0*55.0*500500.0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum(i,1,1000,i+sqrt(i-501)-sqrt(i-501))", 375250,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("prod(i,1,1000,sqrt(500-i)/sqrt(500-i))", 1,  cnt, cntPASS, cntFAIL);
+    parser.setParallelLoops(false);
+    TEST_CMPDBL("sum(i,1,1000,i+sqrt(i-501)-sqrt(i-501))", 375250,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum(i,[1,NaN,2],i)", 3,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("prod(i,[2,NaN,3],i)", 6,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum(i,[1,NaN,2],[i,1])", 6,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("x=[1,2,3]; sum(i,1,5,sum(x)*i)", 90,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("g(a)=a+i; sum(i,1,3,g(1))", 9,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("y=2; sum(i,1,3,sum(j,1,3,(y^3)*i*j))", 288,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("a=0; sum(i,1,3,a=a+1)", 6,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("q=3; for(i,1,3,[q*2,i])", JKMP::vector<double>::construct(6,1,6,2,6,3),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("g(x)=if(x<=0,[0],for(i,1,2,[x*2,g(x-1)])); g(2)", JKMP::vector<double>::construct(4,2,0,2,0,4,2,0,2,0),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("f(n)=if(n<=0,0,sum(i,1,2,n*10+f(n-1))); f(2)", 80,  cnt, cntPASS, cntFAIL);
+    TEST_ERROR("savefor(i,1,3,!i)", cnt, cntPASS, cntFAIL);
+    TEST_ERROR("sum(i,1,3,!i)", cnt, cntPASS, cntFAIL);
+    TEST_ERROR("savefor(i,1,3,if(i,i,0))", cnt, cntPASS, cntFAIL);
+    TEST_ERROR("savefor(i,0.5,1,2.5,~i)", cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("savefor(i,1,4,if(!(i>2),i,-i))", JKMP::vector<double>::construct(1,2,-3,-4),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("savefor(i,1,3,~i)", JKMP::vector<double>::construct(-2,-3,-4),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("savefor(i,1,3,sin(i)*2+1)", JKMP::vector<double>::construct(sin(1.0)*2.0+1.0,sin(2.0)*2.0+1.0,sin(3.0)*2.0+1.0),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("x=[0.5,1,3]; sum(i,x,2*i+1)", 12,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum(i,1,10000,i/2)", 25002500.0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("cumsum(i,1,4,i^2)", JKMP::vector<double>::construct(1,5,14,30),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("cumprod(i,1,4,i)", JKMP::vector<double>::construct(1,2,6,24),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("x=[1,2]; savefor(i,1,2,x*i)", JKMP::vector<double>::construct(1,2,2,4),  cnt, cntPASS, cntFAIL);
+    parser.setMemoizeFunctions(true);
+    TEST_CMPDBL("fib(n)=if(n<2, n, fib(n-1)+fib(n-2)); fib(40)", 102334155,  cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parser.getFunctionMemoStatistics("fib").hits>0, cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("c=2; mf(x)=c*x; a=mf(3); c=5; a+mf(3)", 21,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("mf(x)=x+1; a=mf(2); mf(x)=x+2; a+mf(2)", 7,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("mf(x)=x^2; sum(i,1,100,mf(i%10))", 2850,  cnt, cntPASS, cntFAIL);
+    parser.setMemoizeFunctions(false);
+    TEST_ERROR("undefinedVariable+1", cnt, cntPASS, cntFAIL);
+    TEST_CPP(parser.getFirstError(), "the variable 'undefinedVariable' does not exist", cnt, cntPASS, cntFAIL);
+    TEST_ERROR("undefinedFunction(1)", cnt, cntPASS, cntFAIL);
+    TEST_CPP(parser.getFirstError(), "the function 'undefinedFunction' does not exist", cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("cfg=struct(\"n\", 2, \"data\", 1:10); cfg.data[5]", 6,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("cfg=struct(\"in\", struct(\"v\", [7,8,9])); cfg.in.v[[0,2]]", JKMP::vector<double>::construct(7,9),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("cfg=struct(\"in\", struct(\"v\", [7,8,9])); cfg.in.v[1]+(struct(\"w\", 1)).w", 9,  cnt, cntPASS, cntFAIL);
+    TEST_ERROR("cfg=struct(\"n\", 2); cfg.data[0]", cnt, cntPASS, cntFAIL);
+    TEST_CMPSTRVEC("structkeys(struct(\"c\", 1, \"a\", 2, \"b\", 3))", JKMP::stringVector::construct("a", "b", "c"),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("l=list(); for(i,1,5000,length(l=listappend(l,i))); length(l)+l[4999]+l[1234]", 5000+5000+1235,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("l=list(1,2,3); l2=listappend(l,4); l[0]=10; length(l)*100+l2[0]*10+l2[3]", 3*100+1*10+4,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("l=list(); for(i,1,100,length(l=listappend(l,i))); l2=listinsert(l,50,0); l2[50]*1000+l2[100]*10+l[50]", 0*1000+100*10+51,  cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("0:pi+2*(0:pi)", foreach_apply(JKMP::construct_vector_range<double>(0,M_PI), [](double f) { return f*3.0;}),  cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("x=0:0.3:10; sum(x)", statisticsSumV(JKMP::construct_vector_range<double>(0,10,0.3)),  cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("x=0:0.3:10; prod(x)", statisticsProdV(JKMP::construct_vector_range<double>(0,10,0.3)),  cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("x=0:0.3:10; mean(x)", statisticsAverageV(JKMP::construct_vector_range<double>(0,10,0.3)),  cnt, cntPASS, cntFAIL);
-    TEST_CMPDBL("x=0:0.3:10; var(x)", statisticsVarianceV(JKMP::construct_vector_range<double>(0,10,0.3)),  cnt, cntPASS, cntFAIL);
-    TEST_CMPDBL("x=0:0.3:10; std(x)", sqrt(statisticsVarianceV(JKMP::construct_vector_range<double>(0,10,0.3))),  cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(ulp_distance(parser.evaluate("x=0:0.3:10; var(x)").num, statisticsVarianceV(JKMP::construct_vector_range<double>(0,10,0.3)))<=4.0,  cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(ulp_distance(parser.evaluate("x=0:0.3:10; std(x)").num, sqrt(statisticsVarianceV(JKMP::construct_vector_range<double>(0,10,0.3))))<=4.0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum([1,NaN])", 1,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sum2([1,NaN,2,inf])", 5,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("mean([1,NaN,3])", 2,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("mean([])", 0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("mean([NaN,-inf])", 0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("var([4,NaN,7,13,-inf,16])", 30,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("var([NaN,1])", 0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("std([])", 0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("moment([1,NaN,2,3,4],4)", 2.5625,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("moment([1,NaN,2,3,4],10)", (pow(1.5,10)+pow(0.5,10))/2.0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("moment([],4)", 0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("skewness([1,2,NaN,3,4])", 0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("x=1:300000; x[7]=NaN; x[200000]=inf; mean(x)", (300000.0*300001.0/2.0-8.0-200001.0)/299998.0,  cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parallel_vector_equal(parser, "x=1e3*sin(1:300000); x[7]=NaN; x[200000]=inf; [sum(x), sum2(x), mean(x), var(x), skewness(x), moment(x,4)]", 6), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("var(1e12+[4,7,13,16])", 30,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("moment([1,2,3,4],4)", 2.5625,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("moment([1,2,3,4],10)", (pow(1.5,10)+pow(0.5,10))/2.0,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("skewness([1,2,3,4])", 0,  cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(eval_with_summation_mode(parser, "sum([1e16,1,1,1,1,-1e16])", jkmpKahanSummation)==4.0, cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(eval_with_summation_mode(parser, "sum(0.1+0*(1:1000000))", jkmpKahanSummation)==double(1000000.0L*0.1), cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parallel_vector_equal(parser, "x=1e3*sin(1:300000); [sum(x), sum2(x), mean(x), var(x), skewness(x), moment(x,4)]", 6), cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("x=0:0.3:10; corrcoeff(x, 0:(-0.3):(-10))", statisticsCorrelationCoefficientV(JKMP::construct_vector_range<double>(0,10,0.3), JKMP::construct_vector_range<double>(0,-10,-0.3)),  cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("median([1])", 1,  cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("median([1,2])", 1.5,  cnt, cntPASS, cntFAIL);
@@ -497,6 +811,34 @@ int main(int /*argc*/, JKMP::charType */*argv*/[])
     TEST_CMPDBL("quantile(1:10,0.75)", 9,  cnt, cntPASS, cntFAIL);
     TEST_ERROR("quantile(0.75)", cnt, cntPASS, cntFAIL);
     TEST_ERROR("quantile([]],0.25)", cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("median([5,1,4,2,3,6])", 3.5,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("mad([1,1,2,2,4,6,9])", 1,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("quantiles(10:(-1):1, [0.75,0,0.25,1,0.25])", JKMP::vector<double>::construct(9,1,4,10,4),  cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parser.evaluate("x=sin(1:10001); quantiles(x, (0:20)/20)").numVec==parser.evaluate("x=sin(1:10001); for(q,(0:20)/20,sort(x)[min([ceil(q*10001),10000])])").numVec, cnt, cntPASS, cntFAIL);
+    TEST_ERROR("quantiles([1,2,3])", cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("median([5,NaN,1,3,2])", 2.5,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("median([5,1,3,2,NaN])", 2.5,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("median([NaN,5,1,inf,3,2])", 2.5,  cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(std::isnan(parser.evaluate("median([NaN,NaN])").num), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("mad([NaN,1,1,2,2,4,6,9])", 1,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("mad([1,1,2,NaN,2,4,6,9,-inf])", 1,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("nmad([1,1,2,2,4,6,9,NaN])", 1.4826,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("quantile([NaN,1,2,3,4,5,6,7,8,9,10],0.75)", 9,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("quantile([1,2,3,4,5,NaN,6,7,8,9,10],0.25)", 4,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("quantile25([1,2,3,4,5,6,7,8,9,10,NaN])", 4,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("quantile75([NaN,1,2,3,4,5,6,7,NaN,8,9,10])", 9,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("quantiles([10,NaN,9,8,7,6,5,4,3,2,1,NaN], [0.75,0,0.25,1])", JKMP::vector<double>::construct(9,1,4,10),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("unique([3,1,3,2,1,-0,0])", JKMP::vector<double>::construct(3,1,2,0),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("length(unique([nan,1,nan,1]))", 3,  cnt, cntPASS, cntFAIL);
+    TEST_CMPSTRVEC("unique([\"b\",\"a\",\"b\",\"c\",\"a\"])", JKMP::stringVector::construct("b","a","c"),  cnt, cntPASS, cntFAIL);
+    TEST_CMPBOOLVEC("unique([true,true,false,true])", JKMP::vector<bool>::construct(true,false),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("length(unique(floor((1:200000)/2)))", 100001,  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("uniquesorted([3,1,3,5,2,1])", JKMP::vector<double>::construct(1,2,3,5),  cnt, cntPASS, cntFAIL);
+    TEST_CMPSTRVEC("uniquesorted([\"b\",\"a\",\"b\",\"c\",\"a\"])", JKMP::stringVector::construct("a","b","c"),  cnt, cntPASS, cntFAIL);
+    TEST_CMPBOOLVEC("uniquesorted([true,false,true])", JKMP::vector<bool>::construct(false,true),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("uniquecounts([3,1,3,5,3,1])", JKMP::vector<double>::construct(3,2,1),  cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("uniqueindices([\"b\",\"a\",\"b\",\"c\",\"a\"])", JKMP::vector<double>::construct(0,1,0,2,1),  cnt, cntPASS, cntFAIL);
+    TEST_ERROR("uniquecounts()", cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("removeall([1,1,1,2,2,3,3,4,5,1], -1)", JKMP::vector<double>(1,1,1,2,2,3,3,4,5,1),  cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("removeall([1,1,1,2,2,3,3,4,5,1], 1)", JKMP::vector<double>(2,2,3,3,4,5),  cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("removeall([1,1,1,2,2,3,3,4,5,1], 3)", JKMP::vector<double>(1,1,1,2,2,4,5,1),  cnt, cntPASS, cntFAIL);
@@ -579,12 +921,69 @@ int main(int /*argc*/, JKMP::charType */*argv*/[])
     TEST_CMPDBLVEC("x=1:10; item(x,find(x%2,0))", JKMP::vector<double>::construct(2,4,6,8,10), cnt, cntPASS, cntFAIL);
     TEST_CMPSTR("num2str(123)", JKMP::string("123"), cnt, cntPASS, cntFAIL);
     TEST_CMPSTRVEC("num2str([123,456])", JKMP::stringVector::construct("123","456"), cnt, cntPASS, cntFAIL);
+    TEST_CMPBOOLVEC("regexpcontains(\"b+\", [\"abc\",\"xyz\",\"bb\"])", JKMP::vector<bool>::construct(true,false,true), cnt, cntPASS, cntFAIL);
+    TEST_CMPBOOL("regexpcontains(\"q\", \"abc\")", false, cnt, cntPASS, cntFAIL);
+    TEST_CMPBOOL("regexpcontains(\"B\", \"abc\")", true, cnt, cntPASS, cntFAIL);
+    TEST_CMPBOOL("regexpcontains_cs(\"B\", \"abc\")", false, cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("regexpindexin(\"c\", [\"abc\",\"xyz\",\"c\"])", JKMP::vector<double>::construct(2,-1,0), cnt, cntPASS, cntFAIL);
+    TEST_CMPSTRVEC("regexpcap(\"([a-z]+)=([0-9]+)\", [\"a=1\",\"bb=22\",\"c\"], 2, \"none\")", JKMP::stringVector::construct("1","22","none"), cnt, cntPASS, cntFAIL);
+    parser.clearRegExpCache();
+    TEST_CMPDBL("regexpindexin(\"c\", \"abc\")", 2, cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("regexpindexin(\"c\", \"xyzc\")", 3, cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parser.getRegExpCacheStatistics().misses==1 && parser.getRegExpCacheStatistics().hits==1, cnt, cntPASS, cntFAIL);
+    parser.setRegExpCacheSize(1);
+    TEST_CMPDBL("regexpindexin_cs(\"c\", \"abc\")", 2, cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parser.getRegExpCacheStatistics().entries==1 && parser.getRegExpCacheStatistics().evictions==1, cnt, cntPASS, cntFAIL);
+    parser.setRegExpCacheSize(JKMATHPARSER_REGEXPCACHE_SIZE);
+    TEST_CMPDBLVEC("regexpindexin(\"b+c\", [\"aabbc\",\"bc\",\"cb\"])", JKMP::vector<double>::construct(2,0,-1), cnt, cntPASS, cntFAIL);
+    TEST_CMPBOOLVEC("regexpcontains_cs(\"^[A-Z][a-z]*$\", [\"Hello\",\"hello\",\"Hello!\"])", JKMP::vector<bool>::construct(true,false,false), cnt, cntPASS, cntFAIL);
+    TEST_CMPBOOLVEC("regexpcontains(\"a(?=b)\", [\"cab\",\"ac\"])", JKMP::vector<bool>::construct(true,false), cnt, cntPASS, cntFAIL);
+    TEST_CMPSTRVEC("regexpcap(\"(a+)(b*)\", [\"aab\",\"xab\",\"a\"], 1, \"-\")", JKMP::stringVector::construct("aa","-","a"), cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(fast_regexp_equal(parser, "s=num2str(1:20000); regexpindexin(\"(1|7)+[2-5]?0{2,}$\", s)"), cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(fast_regexp_equal(parser, "s=num2str(1:20000); regexpcontains(\"^1.*9|^9[^1]3\", s)"), cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(fast_regexp_equal(parser, "s=num2str(1:20000); regexpcap(\"([1-3]+)(4|5)(.*)\", s, 3, \"none\")"), cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parallel_vector_equal(parser, "s=num2str(1:200000); regexpindexin(\"7+1\", s)"), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("mat2vec(matmul([1,2;3,4], [5,6;7,8]))", JKMP::vector<double>::construct(19,22,43,50), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("matmul([1,2,3;4,5,6], [1,0,-1])", JKMP::vector<double>::construct(-2,-2), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("matmul([1,2,3], [4,5,6])", 32, cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("mat2vec(transpose([1,2,3;4,5,6]))", JKMP::vector<double>::construct(1,4,2,5,3,6), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("sizecolumns(transpose([1,2,3;4,5,6]))", 2, cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("det([2,3,1;1,2,1;1,1,1])", 1, cnt, cntPASS, cntFAIL);
+    TEST_CMPDBL("det([1,2;2,4])", 0, cnt, cntPASS, cntFAIL);
+    TEST_TRUE("isnan(det([1,NaN;3,4]))", cnt, cntPASS, cntFAIL);
+    TEST_TRUE("isnan(det([0,1;NaN,0]))", cnt, cntPASS, cntFAIL);
+    TEST_TRUE("x=mat2vec(inv([1,NaN;3,4])); isnan(x[0]) && isnan(x[3])", cnt, cntPASS, cntFAIL);
+    TEST_TRUE("x=solve([1,NaN;3,4], [1,2]); isnan(x[0]) && isnan(x[1])", cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("solve([2,1;1,3], [3,5])", JKMP::vector<double>::construct(0.8,1.4), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("mat2vec(inv([2,3,1;1,2,1;1,1,1]))", JKMP::vector<double>::construct(1,-2,1,0,1,-1,-1,1,1), cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parallel_vector_equal(parser, "a=vec2mat(sin(1:360000), 600); mat2vec(matmul(a, transpose(a)))", 360000), cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parallel_vector_equal(parser, "a=vec2mat(sin((1:90000)^2), 300); mat2vec(matmul(a, inv(a)))", 90000), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("mat2vec(fft([1,2,3,4]))", JKMP::vector<double>::construct(10,0,-2,2,-2,0,-2,-2), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("mat2vec(ifft(fft([1,2,3,4])))", JKMP::vector<double>::construct(1,0,2,0,3,0,4,0), cnt, cntPASS, cntFAIL);
+    TEST_TRUE("max(abs(mat2vec(rfft([1,2,3,4]))-[10,0,-2,2,-2,0]))<1e-12", cnt, cntPASS, cntFAIL);
+    TEST_TRUE("x=sin(1:1000)+(1:1000)/100; max(abs(irfft(rfft(x), 1000)-x))<1e-12", cnt, cntPASS, cntFAIL);
+    TEST_TRUE("x=cos((1:997)^2); m=mat2vec(ifft(fft(x))); max(abs(m[0:2:1992]-x))<1e-12 && max(abs(m[1:2:1993]))<1e-12", cnt, cntPASS, cntFAIL);
+    TEST_TRUE("x=sin(1:210); X=mat2vec(fft(x)); R=mat2vec(rfft(x)); max(abs(X[0:211]-R))<1e-12", cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("fftconvolve([1,2,3], [0,1,0.5])", JKMP::vector<double>::construct(0,1,2.5,4,1.5), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("xcorr([1,2,3], [0,1,0.5])", JKMP::vector<double>::construct(0.5,2,3.5,3,0), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("autocorr([1,2,3])", JKMP::vector<double>::construct(14,8,3), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("autocorr([1,2,3], 1)", JKMP::vector<double>::construct(14,8), cnt, cntPASS, cntFAIL);
+    TEST_TRUE("x=sin((1:500)^2); y=cos(1:300); abs(sum(fftconvolve(x,y))-sum(x)*sum(y))<1e-9 && abs(autocorr(x)[0]-sum(x^2))<1e-9 && max(abs(xcorr(x,x)[499:998]-autocorr(x)))<1e-9", cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(fft_convolve_max_error(500, 300)<1e-10 && fft_convolve_max_error(1001, 37)<1e-10, cnt, cntPASS, cntFAIL);
+    parser.clearFFTPlanCache();
+    TEST_TRUE("x=rfft(1:64); y=rfft(65:128); sizerows(x)==sizerows(y)", cnt, cntPASS, cntFAIL);
+    TEST_CPP_TRUE(parser.getFFTPlanCacheStatistics().misses==1 && parser.getFFTPlanCacheStatistics().hits==1, cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; unique(x)", JKMP::vector<double>::construct(1,2,3,4,5,6,7,8,9), cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("y=[1,8,3.1,4,5,3,7,2,3.1]; unique(y)", JKMP::vector<double>::construct(1,8,3.1,4,5,3,7,2), cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedmean(x, idx)", JKMP::vector<double>::construct((1.0+4.0+7.0)/3.0, (2.0+5.0+8.0)/3.0, (3.0+6.0+9.0)/3.0), cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedsum(x, idx)", JKMP::vector<double>::construct(1.0+4.0+7.0, 2.0+5.0+8.0, 3.0+6.0+9.0), cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedsum2(x, idx)", JKMP::vector<double>::construct(1.0+16.0+49.0, 4.0+25.0+64.0, 9.0+36.0+81.0), cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedmin(x, idx)", JKMP::vector<double>::construct(1, 2, 3), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("indexedmean([1,2,3,4,NaN],[1,1,2,2,2])", JKMP::vector<double>::construct(1.5, 3.5), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("indexedsum([NaN,1,2,3,4,inf],[1,1,1,2,2,2])", JKMP::vector<double>::construct(3, 7), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("indexedcount([1,NaN,3,4,NaN],[1,1,2,2,2])", JKMP::vector<double>::construct(1, 2), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("indexedmin([NaN,2,3,-inf,4],[1,1,2,2,2])", JKMP::vector<double>::construct(2, 3), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("indexedvar([1,2,4,NaN,7,13,16],[1,1,2,2,2,2,2])", JKMP::vector<double>::construct(0.5, 30), cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedmax(x, idx)", JKMP::vector<double>::construct(7,8,9), cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[\"1\",\"2\",\"3\",\"1\",\"2\",\"3\",\"1\",\"2\",\"3\"]; indexedmean(x, idx)", JKMP::vector<double>::construct((1.0+4.0+7.0)/3.0, (2.0+5.0+8.0)/3.0, (3.0+6.0+9.0)/3.0), cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[\"1\",\"2\",\"3\",\"1\",\"2\",\"3\",\"1\",\"2\",\"3\"]; indexedsum(x, idx)", JKMP::vector<double>::construct(1.0+4.0+7.0, 2.0+5.0+8.0, 3.0+6.0+9.0), cnt, cntPASS, cntFAIL);
@@ -598,6 +997,15 @@ int main(int /*argc*/, JKMP::charType */*argv*/[])
     TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[true,false,true,true,false,true,true,false,true]; indexedmax(x, idx)", JKMP::vector<double>::construct(9,8), cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedcount(x, idx)", JKMP::vector<double>::construct(3,3,3), cnt, cntPASS, cntFAIL);
     TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; y=[1,2,9,4,5,6,7,8,3]; idx=[1,2,3,1,2,3,1,2,3]; indexedcorrcoeff(x, y, idx)", JKMP::vector<double>::construct(1,1,-1), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedvar(x, idx)", JKMP::vector<double>::construct(9,9,9), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedstd(x, idx)", JKMP::vector<double>::construct(3,3,3), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedmedian(x, idx)", JKMP::vector<double>::construct(4,5,6), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedquantile(x, idx, 0)", JKMP::vector<double>::construct(1,2,3), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedskewness(x, idx)", JKMP::vector<double>::construct(0,0,0), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[1,2,3,1,2,3,1,2,3]; indexedmoment(x, idx, 2)", JKMP::vector<double>::construct(6,6,6), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[\"a\",\"b\",\"c\",\"a\",\"b\",\"c\",\"a\",\"b\",\"c\"]; indexedvar(x, idx)", JKMP::vector<double>::construct(9,9,9), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[true,false,true,true,false,true,true,false,true]; indexedcount(x, idx)", JKMP::vector<double>::construct(6,3), cnt, cntPASS, cntFAIL);
+    TEST_CMPDBLVEC("x=[1,2,3,4,5,6,7,8,9]; idx=[7,7,-1,7,-1,2,2,2,2]; indexedprod(x, idx)", JKMP::vector<double>::construct(1.0*2.0*4.0, 3.0*5.0, 6.0*7.0*8.0*9.0), cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("x=[1,2,3,4,5,6,7,8,9]; last(x)", 9, cnt, cntPASS, cntFAIL);
     TEST_CMPDBL("x=[1,2,3,4,5,6,7,8,9]; first(x)", 1, cnt, cntPASS, cntFAIL);
     TEST_CMPSTR("x=[1,2,3,4,5,6,7,8,9]; last(num2str(x))", "9", cnt, cntPASS, cntFAIL);
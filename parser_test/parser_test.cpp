@@ -1,5 +1,6 @@
 #include "../jkmathparser.h"
 #include "../jkmptools.h"
+#include "../jkmpmathtools.h"
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -241,6 +242,510 @@ void speed_test(bool doBytecode, bool showBytecode) {
 #pragma GCC pop_options
 
 
+void fused_vector_speed_test() {
+    JKMathParser parser;
+    qDebug()<<"\n\n=========================================================";
+    qDebug()<<"== SPEED TEST: fused element-wise vector expressions\n=========================================================";
+    const JKMP::string expr="a*b+c*d-e/f";
+    const int operations=5;
+    const int operands=6;
+    const size_t sizes[]={1000, 100000, 1000000, 10000000};
+    for (size_t si=0; si<sizeof(sizes)/sizeof(sizes[0]); si++) {
+        const size_t N=sizes[si];
+        JKMP::vector<double> v(N);
+        for (size_t i=0; i<N; i++) v[i]=double(i+1)/double(N);
+        parser.addVariableDoubleVector("a", v);
+        parser.addVariableDoubleVector("b", v);
+        parser.addVariableDoubleVector("c", v);
+        parser.addVariableDoubleVector("d", v);
+        parser.addVariableDoubleVector("e", v);
+        parser.addVariableDoubleVector("f", v);
+        const int cnt=std::max<int>(2, static_cast<int>(20000000/N));
+
+        parser.setTypeSpecialization(false);
+        JKMathParser::jkmpNode* n=parser.parse(expr);
+        parser.setTypeSpecialization(true);
+        JKMathParser::jkmpNode* nf=parser.parse(expr);
+        PublicTicToc timer;
+        jkmpResult r, rf;
+        timer.tic();
+        for (int i=0; i<cnt; i++) {
+            n->evaluate(r);
+        }
+        double elGeneric=double(timer.toc())*1e3/double(cnt);
+        timer.tic();
+        for (int i=0; i<cnt; i++) {
+            nf->evaluate(rf);
+        }
+        double elFused=double(timer.toc())*1e3/double(cnt);
+        // every operand is copied out of its variable (read+write), every generic operation reads two vectors and writes a temporary,
+        // the fused evaluation only writes the result
+        const double mbGeneric=double((2*operands+3*operations)*N*sizeof(double))/1024.0/1024.0;
+        const double mbFused=double((2*operands+1)*N*sizeof(double))/1024.0/1024.0;
+        qDebug()<<"expression: "<<expr<<",   N="<<N<<",   evaluations: "<<cnt;
+        qDebug()<<"interpreted (no type specialization):"<<elGeneric<<" ms/eval\t   memory traffic ~"<<mbGeneric<<" MB,  "<<operations<<" temporary vectors";
+        qDebug()<<"interpreted (fused, default parse): "<<elFused<<" ms/eval\t   memory traffic ~"<<mbFused<<" MB,  0 temporary vectors";
+        qDebug()<<"fused/evaluate : "<<elFused/elGeneric;
+        if (r.numVec!=rf.numVec) {
+            qDebug()<<"   ERROR fused and interpreted results differ";
+        }
+        delete n;
+        delete nf;
+    }
+    qDebug()<<"\n";
+}
+
+void loop_speed_test() {
+    JKMathParser parser;
+    qDebug()<<"\n\n=========================================================";
+    qDebug()<<"== SPEED TEST: loops sum(i,1,N,i^2)\n=========================================================";
+    const int sizes[]={1000, 100000, 1000000, 10000000};
+    for (size_t si=0; si<sizeof(sizes)/sizeof(sizes[0]); si++) {
+        const int N=sizes[si];
+        const JKMP::string expr=JKMP::string("sum(i,1,%1,i^2)").arg(N);
+        const int cnt=std::max<int>(2, 10000000/N);
+
+        JKMathParser::jkmpNode* n=parser.parse(expr);
+        JKMathParser::ByteCodeProgram bprog;
+        JKMathParser::ByteCodeEnvironment bEnv(&parser);
+        bool bcOK=n->createByteCode(bprog, &bEnv);
+        PublicTicToc timer;
+        jkmpResult r;
+        timer.tic();
+        for (int k=0; k<cnt; k++) {
+            n->evaluate(r);
+        }
+        double elParser=double(timer.toc())*1e3/double(cnt);
+        parser.setParallelLoops(true);
+        jkmpResult rp;
+        timer.tic();
+        for (int k=0; k<cnt; k++) {
+            n->evaluate(rp);
+        }
+        double elParallel=double(timer.toc())*1e3/double(cnt);
+        parser.setParallelLoops(false);
+        double rb=0;
+        double elByteCode=0;
+        if (bcOK) {
+            timer.tic();
+            for (int k=0; k<cnt; k++) {
+                rb=parser.evaluateBytecode(bprog);
+            }
+            elByteCode=double(timer.toc())*1e3/double(cnt);
+        }
+        volatile double rn=0;
+        timer.tic();
+        for (int k=0; k<cnt; k++) {
+            double s=0;
+            for (int i=1; i<=N; i++) {
+                s+=double(i)*double(i);
+            }
+            rn=s;
+        }
+        double elNative=double(timer.toc())*1e3/double(cnt);
+        qDebug()<<"expression: "<<expr<<",   evaluations: "<<cnt;
+        qDebug()<<"evaluate (vectorized loop):          "<<elParser<<" ms/eval\t   "<<elParser*1e6/double(N)<<" ns/iteration";
+        qDebug()<<"parallel loops ("<<parser.getThreadCount()<<" threads):        "<<elParallel<<" ms/eval\t   "<<elParallel*1e6/double(N)<<" ns/iteration";
+        if (bcOK) qDebug()<<"bytecode (whole expression):         "<<elByteCode<<" ms/eval\t   "<<elByteCode*1e6/double(N)<<" ns/iteration";
+        qDebug()<<"native C++ loop:                     "<<elNative<<" ms/eval\t   "<<elNative*1e6/double(N)<<" ns/iteration";
+        qDebug()<<"evaluate/native : "<<elParser/elNative;
+        if (fabs(r.num-rn)>1e-10*fabs(rn) || fabs(rp.num-rn)>1e-10*fabs(rn) || (bcOK && fabs(rb-rn)>1e-10*fabs(rn))) {
+            qDebug()<<"   ERROR results differ: "<<r.num<<rp.num<<rb<<rn;
+        }
+        delete n;
+    }
+    qDebug()<<"\n";
+}
+
+void vecmath_speed_test() {
+    JKMathParser parser;
+    qDebug()<<"\n\n=========================================================";
+    qDebug()<<"== SPEED TEST: vectorized transcendental functions ("<<JKMP::vecMathISA()<<")\n=========================================================";
+    struct VecMathFunction {
+        const char* name;
+        double (*libm)(double);
+        void (*vec)(double*, const double*, size_t);
+        double xmin, xmax;
+    };
+    const VecMathFunction functions[]={
+        {"sin", sin, JKMP::vecSin, -100.0, 100.0},
+        {"cos", cos, JKMP::vecCos, -100.0, 100.0},
+        {"exp", exp, JKMP::vecExp, -100.0, 100.0},
+        {"log", log, JKMP::vecLog, 1e-3, 1e3},
+        {"sqrt", sqrt, JKMP::vecSqrt, 0.0, 1e3},
+        {"tanh", tanh, JKMP::vecTanh, -5.0, 5.0}
+    };
+    const size_t N=1000000;
+    const int cnt=20;
+    for (size_t fi=0; fi<sizeof(functions)/sizeof(functions[0]); fi++) {
+        const VecMathFunction& f=functions[fi];
+        JKMP::vector<double> x(N), ylibm(N), yvec(N);
+        for (size_t i=0; i<N; i++) x[i]=f.xmin+(f.xmax-f.xmin)*double(i)/double(N-1);
+        parser.addVariableDoubleVector("x", x);
+        JKMathParser::jkmpNode* n=parser.parse(JKMP::string(f.name)+"(x)");
+        PublicTicToc timer;
+        jkmpResult r;
+        timer.tic();
+        for (int k=0; k<cnt; k++) {
+            n->evaluate(r);
+        }
+        double elParser=double(timer.toc())*1e3/double(cnt);
+        timer.tic();
+        for (int k=0; k<cnt; k++) {
+            f.vec(yvec.data(), x.data(), N);
+        }
+        double elVec=double(timer.toc())*1e3/double(cnt);
+        timer.tic();
+        for (int k=0; k<cnt; k++) {
+            for (size_t i=0; i<N; i++) ylibm[i]=f.libm(x[i]);
+        }
+        double elLibm=double(timer.toc())*1e3/double(cnt);
+        double maxULP=0;
+        for (size_t i=0; i<N; i++) {
+            const double ulp=nextafter(fabs(ylibm[i]), INFINITY)-fabs(ylibm[i]);
+            maxULP=std::max(maxULP, fabs(yvec[i]-ylibm[i])/ulp);
+        }
+        qDebug()<<f.name<<"(x),   N="<<N<<",   x in ["<<f.xmin<<", "<<f.xmax<<"],   evaluations: "<<cnt;
+        qDebug()<<"evaluate:          "<<elParser<<" ms/eval\t   "<<elParser*1e6/double(N)<<" ns/item";
+        qDebug()<<"vectorized kernel: "<<elVec<<" ms/eval\t   "<<elVec*1e6/double(N)<<" ns/item";
+        qDebug()<<"libm loop:         "<<elLibm<<" ms/eval\t   "<<elLibm*1e6/double(N)<<" ns/item";
+        qDebug()<<"libm/vectorized : "<<elLibm/elVec<<",   max. difference to libm: "<<maxULP<<" ULP";
+        if (r.numVec!=yvec) {
+            qDebug()<<"   ERROR evaluate and vectorized kernel results differ";
+        }
+        delete n;
+    }
+    qDebug()<<"\n";
+}
+
+void reduction_speed_test() {
+    JKMathParser parser;
+    qDebug()<<"\n\n=========================================================";
+    qDebug()<<"== SPEED TEST: reductions sum/var/skewness\n=========================================================";
+    const size_t N=10000000;
+    const int cnt=10;
+    JKMP::vector<double> x(N);
+    for (size_t i=0; i<N; i++) x[i]=1e6+sin(double(i))*100.0+1.0/double(i+1);
+    parser.addVariableDoubleVector("x", x);
+    long double refSum=0;
+    for (size_t i=0; i<N; i++) refSum+=x[i];
+    const long double refMean=refSum/(long double)N;
+    long double refVar=0;
+    for (size_t i=0; i<N; i++) refVar+=(x[i]-refMean)*(x[i]-refMean);
+    refVar/=(long double)(N-1);
+    struct ReductionTest {
+        const char* name;
+        jkmpSummationMode mode;
+        int threads;
+    };
+    const ReductionTest tests[]={
+        {"pairwise, 1 thread", jkmpPairwiseSummation, 1},
+        {"Kahan,    1 thread", jkmpKahanSummation, 1},
+        {"pairwise, all threads", jkmpPairwiseSummation, 0},
+        {"Kahan,    all threads", jkmpKahanSummation, 0}
+    };
+    PublicTicToc timer;
+    timer.tic();
+    double naiveSum=0, naiveVar=0;
+    for (int k=0; k<cnt; k++) {
+        double s=0, s2=0;
+        for (size_t i=0; i<N; i++) {
+            s+=x[i];
+            s2+=x[i]*x[i];
+        }
+        naiveSum=s;
+        naiveVar=(s2-s*s/double(N))/double(N-1);
+    }
+    const double elNaive=double(timer.toc())*1e3/double(cnt);
+    qDebug()<<"N="<<N<<",   evaluations: "<<cnt;
+    qDebug()<<"naive loop (sum, sum of squares):   "<<elNaive<<" ms/eval\t   rel. error sum: "<<double(fabsl((naiveSum-refSum)/refSum))<<"   var: "<<double(fabsl((naiveVar-refVar)/refVar));
+    for (size_t ti=0; ti<sizeof(tests)/sizeof(tests[0]); ti++) {
+        const ReductionTest& t=tests[ti];
+        parser.setSummationMode(t.mode);
+        parser.setThreadCount(t.threads);
+        const char* exprs[]={"sum(x)", "var(x)", "skewness(x)"};
+        for (int ei=0; ei<3; ei++) {
+            JKMathParser::jkmpNode* n=parser.parse(exprs[ei]);
+            jkmpResult r;
+            timer.tic();
+            for (int k=0; k<cnt; k++) {
+                n->evaluate(r);
+            }
+            const double el=double(timer.toc())*1e3/double(cnt);
+            if (ei==0) qDebug()<<t.name<<"  "<<exprs[ei]<<":   "<<el<<" ms/eval\t   rel. error: "<<double(fabsl((r.num-refSum)/refSum));
+            else if (ei==1) qDebug()<<t.name<<"  "<<exprs[ei]<<":   "<<el<<" ms/eval\t   rel. error: "<<double(fabsl((r.num-refVar)/refVar));
+            else qDebug()<<t.name<<"  "<<exprs[ei]<<":   "<<el<<" ms/eval";
+            delete n;
+        }
+    }
+    qDebug()<<"\n";
+}
+
+
+
+
+void quantile_speed_test() {
+    JKMathParser parser;
+    qDebug()<<"\n\n=========================================================";
+    qDebug()<<"== SPEED TEST: selection-based median/quantiles\n=========================================================";
+    const size_t N=1000000;
+    const int cnt=10;
+    JKMP::vector<double> x(N);
+    for (size_t i=0; i<N; i++) x[i]=sin(double(i)*1.234)*1000.0+double(i%1000);
+    parser.addVariableDoubleVector("x", x);
+    PublicTicToc timer;
+    double q25=0, med=0, q75=0;
+    timer.tic();
+    for (int k=0; k<cnt; k++) {
+        // the sort-based implementation: each function sorts its own copy
+        std::vector<double> s;
+        s.assign(x.begin(), x.end()); std::sort(s.begin(), s.end()); q25=s[size_t(ceil(0.25*double(N)))];
+        s.assign(x.begin(), x.end()); std::sort(s.begin(), s.end()); med=(s[N/2-1]+s[N/2])/2.0;
+        s.assign(x.begin(), x.end()); std::sort(s.begin(), s.end()); q75=s[size_t(ceil(0.75*double(N)))];
+    }
+    const double elSort=double(timer.toc())*1e3/double(cnt);
+    const char* exprs[]={"median(x)", "[quantile25(x), median(x), quantile75(x)]", "quantiles(x, [0.25, 0.5, 0.75])", "quantiles(x, (0:100)/100)", "mad(x)"};
+    qDebug()<<"N="<<N<<",   evaluations: "<<cnt;
+    qDebug()<<"3x std::sort (quantile25, median, quantile75):   "<<elSort<<" ms/eval";
+    for (size_t ei=0; ei<sizeof(exprs)/sizeof(exprs[0]); ei++) {
+        JKMathParser::jkmpNode* n=parser.parse(exprs[ei]);
+        jkmpResult r;
+        timer.tic();
+        for (int k=0; k<cnt; k++) {
+            n->evaluate(r);
+        }
+        const double el=double(timer.toc())*1e3/double(cnt);
+        qDebug()<<exprs[ei]<<":   "<<el<<" ms/eval";
+        if (ei==1 && (r.numVec.size()!=3 || r.numVec[0]!=q25 || r.numVec[1]!=med || r.numVec[2]!=q75)) {
+            qDebug()<<"   ERROR selection and sort-based results differ";
+        }
+        delete n;
+    }
+    qDebug()<<"\n";
+}
+
+
+void unique_speed_test() {
+    JKMathParser parser;
+    qDebug()<<"\n\n=========================================================";
+    qDebug()<<"== SPEED TEST: hash-based unique\n=========================================================";
+    PublicTicToc timer;
+    for (size_t N=1000; N<=10000000; N*=10) {
+        // about N/4 distinct values in a scrambled order
+        JKMP::vector<double> x(N);
+        JKMP::stringVector s(std::min<size_t>(N, 1000000));
+        for (size_t i=0; i<N; i++) x[i]=double((i*7919)%(N/4+1));
+        for (size_t i=0; i<s.size(); i++) s[i]=JKMP::intToStr(int64_t((i*7919)%(s.size()/4+1)));
+        parser.addVariableDoubleVector("x", x);
+        parser.addVariableStringVector("s", s);
+        qDebug()<<"N="<<N<<":";
+        if (N<=100000) {
+            // the former implementation, which calls contains() for every item
+            timer.tic();
+            JKMP::vector<double> out;
+            for (size_t i=0; i<x.size(); i++) {
+                if (!out.contains(x[i])) out<<x[i];
+            }
+            qDebug()<<"   contains()-scan (numbers):   "<<double(timer.toc())*1e3<<" ms";
+        }
+        const char* exprs[]={"unique(x)", "uniquesorted(x)", "uniquecounts(x)", "uniqueindices(x)", "unique(s)"};
+        for (size_t ei=0; ei<sizeof(exprs)/sizeof(exprs[0]); ei++) {
+            JKMathParser::jkmpNode* n=parser.parse(exprs[ei]);
+            jkmpResult r;
+            timer.tic();
+            n->evaluate(r);
+            const double el=double(timer.toc())*1e3;
+            qDebug()<<"   "<<exprs[ei]<<(ei==4?" (N<=10^6)":"")<<":   "<<el<<" ms,   "<<r.length()<<" items";
+            delete n;
+        }
+    }
+    qDebug()<<"\n";
+}
+
+
+
+void indexed_speed_test() {
+    JKMathParser parser;
+    qDebug()<<"\n\n=========================================================";
+    qDebug()<<"== SPEED TEST: group-by engine of indexed*()\n=========================================================";
+    PublicTicToc timer;
+    for (size_t N=1000; N<=10000000; N*=10) {
+        // about N/100 groups (at most 10^5) in a scrambled order
+        const size_t G=std::max<size_t>(1, std::min<size_t>(N/100, 100000));
+        JKMP::vector<double> x(N), idx(N);
+        for (size_t i=0; i<N; i++) {
+            x[i]=double(i%1013)*0.25;
+            idx[i]=double((i*7919)%G);
+        }
+        parser.addVariableDoubleVector("x", x);
+        parser.addVariableDoubleVector("idx", idx);
+        qDebug()<<"N="<<N<<",  groups="<<G<<":";
+        if (N<=100000) {
+            // the former implementation: a JKMP::map of per-group vectors plus a contains()-scan for the group order
+            timer.tic();
+            JKMP::map<double, JKMP::vector<double> > data;
+            JKMP::vector<double> idxl, out;
+            for (size_t i=0; i<N; i++) {
+                if (!idxl.contains(idx[i])) idxl<<idx[i];
+                data[idx[i]].push_back(x[i]);
+            }
+            for (size_t i=0; i<idxl.size(); i++) {
+                const JKMP::vector<double>& d=data[idxl[i]];
+                double s=0;
+                for (size_t j=0; j<d.size(); j++) s+=d[j];
+                out<<s/double(d.size());
+            }
+            qDebug()<<"   map + contains() (mean):   "<<double(timer.toc())*1e3<<" ms";
+        }
+        const char* exprs[]={"indexedmean(x, idx)", "indexedvar(x, idx)", "indexedmax(x, idx)", "indexedmedian(x, idx)", "indexedquantile(x, idx, 0.9)"};
+        for (size_t ei=0; ei<sizeof(exprs)/sizeof(exprs[0]); ei++) {
+            JKMathParser::jkmpNode* n=parser.parse(exprs[ei]);
+            jkmpResult r;
+            timer.tic();
+            n->evaluate(r);
+            const double el=double(timer.toc())*1e3;
+            qDebug()<<"   "<<exprs[ei]<<":   "<<el<<" ms,   "<<r.length()<<" groups";
+            delete n;
+        }
+    }
+    qDebug()<<"\n";
+}
+
+
+
+void regexp_cache_speed_test() {
+    JKMathParser parser;
+    qDebug()<<"\n\n=========================================================";
+    qDebug()<<"== SPEED TEST: cache of compiled regular expressions\n=========================================================";
+    PublicTicToc timer;
+    // one call per loop iteration, i.e. the pattern is needed N times
+    const char* expr="sum(i,1,N,regexpindexin(\"([a-z]+)_([0-9]{2,})(x|y)?\", \"item_\"+num2str(i)))";
+    for (int N=100; N<=10000; N*=10) {
+        parser.addVariableDouble("N", N);
+        JKMathParser::jkmpNode* n=parser.parse(expr);
+        for (int cached=0; cached<=1; cached++) {
+            parser.clearRegExpCache();
+            parser.setRegExpCacheSize(cached?JKMATHPARSER_REGEXPCACHE_SIZE:0);
+            jkmpResult r;
+            timer.tic();
+            n->evaluate(r);
+            const double el=double(timer.toc())*1e3;
+            const JKMathParser::jkmpRegExpCacheStatistics st=parser.getRegExpCacheStatistics();
+            qDebug()<<"   N="<<N<<(cached?"  cached:     ":"  uncached:   ")<<el<<" ms,   "<<el*1e3/double(N)<<" us/call,   hits="<<st.hits<<",  misses="<<st.misses<<",   result="<<r.num;
+        }
+        delete n;
+    }
+    parser.setRegExpCacheSize(JKMATHPARSER_REGEXPCACHE_SIZE);
+    qDebug()<<"\n";
+}
+
+
+
+void regexp_automaton_speed_test() {
+    JKMathParser parser;
+    qDebug()<<"\n\n=========================================================";
+    qDebug()<<"== SPEED TEST: linear-time regular expressions on string vectors\n=========================================================";
+    PublicTicToc timer;
+    for (size_t N=10000; N<=1000000; N*=10) {
+        JKMP::stringVector s(N);
+        for (size_t i=0; i<N; i++) s[i]=JKMP::string("item_")+JKMP::intToStr(int64_t((i*7919)%1000003))+((i%3==0)?"_x":"_yz");
+        parser.addVariableStringVector("s", s);
+        qDebug()<<"N="<<N<<":";
+        const char* exprs[]={"regexpcontains(\"_[0-9]*77[0-9]*_(x|y)\", s)", "regexpindexin(\"[1-3]+9\", s)", "regexpcap(\"([a-z]+)_([0-9]{3,})_x\", s, 2)"};
+        for (size_t ei=0; ei<sizeof(exprs)/sizeof(exprs[0]); ei++) {
+            JKMathParser::jkmpNode* n=parser.parse(exprs[ei]);
+            for (int mode=0; mode<3; mode++) {
+                // std::regex, automaton and automaton on the thread pool
+                parser.setFastRegExp(mode>0);
+                parser.setParallelVectorThreshold((mode==2)?1:0);
+                jkmpResult r;
+                timer.tic();
+                n->evaluate(r);
+                const double el=double(timer.toc())*1e3;
+                qDebug()<<"   "<<exprs[ei]<<((mode==0)?"  std::regex:   ":((mode==1)?"  automaton:    ":"  parallel:     "))<<el<<" ms,   "<<el*1e6/double(N)<<" ns/string";
+            }
+            delete n;
+        }
+    }
+    parser.setFastRegExp(true);
+    parser.setParallelVectorThreshold(JKMATHPARSER_PARALLELVECTOR_THRESHOLD);
+    qDebug()<<"\n";
+}
+
+
+
+void matrix_speed_test() {
+    JKMathParser parser;
+    qDebug()<<"\n\n=========================================================";
+    qDebug()<<"== SPEED TEST: dense matrix kernels\n=========================================================";
+    PublicTicToc timer;
+    for (int N=50; N<=800; N*=2) {
+        parser.addVariableDouble("N", N);
+        parser.evaluate("a=vec2mat(sin((1:(N*N))^2), N); b=vec2mat(cos((1:(N*N))^2), N); y=sin(1:N)");
+        qDebug()<<"N="<<N<<":";
+        const char* exprs[]={"matmul(a, b)", "transpose(a)", "solve(a, y)", "inv(a)", "det(a)", "av=mat2vec(a); bv=mat2vec(b); c=for(i,0,N-1,for(j,0,N-1,sum(av[(i*N):(i*N+N-1)]*bv[j:N:(N*N-1)])))"};
+        for (size_t ei=0; ei<sizeof(exprs)/sizeof(exprs[0]); ei++) {
+            // the script loop is only run for small matrices
+            if (ei==5 && N>100) continue;
+            JKMathParser::jkmpNode* n=parser.parse(exprs[ei]);
+            jkmpResult r;
+            timer.tic();
+            n->evaluate(r);
+            const double el=double(timer.toc())*1e3;
+            qDebug()<<"   "<<exprs[ei]<<":   "<<el<<" ms";
+            delete n;
+        }
+    }
+    qDebug()<<"\n";
+}
+
+
+
+void fft_speed_test() {
+    JKMathParser parser;
+    qDebug()<<"\n\n=========================================================";
+    qDebug()<<"== SPEED TEST: FFT, convolution and correlation\n=========================================================";
+    PublicTicToc timer;
+    const int sizes[]={1024, 1000, 1009, 65536, 100000, 100003};
+    for (size_t si=0; si<sizeof(sizes)/sizeof(sizes[0]); si++) {
+        const int N=sizes[si];
+        parser.addVariableDouble("N", N);
+        parser.evaluate("x=sin((1:N)^2); y=cos(1:N)");
+        for (int cached=0; cached<2; cached++) {
+            // without the cache, every call sets up the plan (factorization, twiddle factors)
+            parser.setFFTPlanCacheSize(cached?JKMATHPARSER_FFTPLANCACHE_SIZE:0);
+            parser.clearFFTPlanCache();
+            const int repeats=(N>10000)?10:200;
+            JKMathParser::jkmpNode* n=parser.parse("rfft(x)");
+            jkmpResult r;
+            timer.tic();
+            for (int i=0; i<repeats; i++) n->evaluate(r);
+            const double el=double(timer.toc())*1e3/double(repeats);
+            qDebug()<<"   N="<<N<<(cached?"  rfft(x), cached plans:    ":"  rfft(x), uncached plans:  ")<<el<<" ms";
+            delete n;
+        }
+    }
+    parser.setFFTPlanCacheSize(JKMATHPARSER_FFTPLANCACHE_SIZE);
+    for (int N=1000; N<=100000; N*=10) {
+        parser.addVariableDouble("N", N);
+        parser.addVariableDouble("L", N/10);
+        parser.evaluate("x=sin((1:N)^2); y=cos(1:N)");
+        qDebug()<<"N="<<N<<":";
+        const char* exprs[]={"fftconvolve(x, y)", "xcorr(x, y)", "autocorr(x, L-1)", "for(k,0,L-1,sum(x[k:(N-1)]*x[0:(N-1-k)]))"};
+        for (size_t ei=0; ei<sizeof(exprs)/sizeof(exprs[0]); ei++) {
+            // the script loop is only run for small vectors
+            if (ei==3 && N>10000) continue;
+            JKMathParser::jkmpNode* n=parser.parse(exprs[ei]);
+            jkmpResult r;
+            timer.tic();
+            n->evaluate(r);
+            const double el=double(timer.toc())*1e3;
+            qDebug()<<"   "<<exprs[ei]<<":   "<<el<<" ms";
+            delete n;
+        }
+    }
+    qDebug()<<"\n";
+}
 
 
 
@@ -258,6 +763,17 @@ int main(int argc, JKMP::charType *argv[])
     double pi=M_PI;
     if (DO_SPEEDTEST) {
         speed_test(doByteCode, showBytecode);
+        fused_vector_speed_test();
+        loop_speed_test();
+        vecmath_speed_test();
+        reduction_speed_test();
+        quantile_speed_test();
+        unique_speed_test();
+        indexed_speed_test();
+        regexp_cache_speed_test();
+        regexp_automaton_speed_test();
+        matrix_speed_test();
+        fft_speed_test();
     }
 
     if (DO_BASICS) {
@@ -695,6 +1211,9 @@ int main(int argc, JKMP::charType *argv[])
         TEST("m!=m2");
         TEST("m=[1,2,3;4,5,6;6,7,8]");
         TEST("{size(m), sizerows(m), sizecolumns(m), dimensions(m),ismatrix(m),isvector(m)}");
+        TEST("matmul(m, transpose(m))");
+        TEST("m2=[2,3,1;1,2,1;1,1,1]");
+        TEST("{det(m2), inv(m2), solve(m2, [1,2,3])}");
         TEST("m=[1,2,3;4,5,6;6,7,8,9]");
         TEST("m=[1,2,3,4;4,5,6;6,7,8,9]");
         TEST("m=[1,2,3;4,5;6,7,8]");